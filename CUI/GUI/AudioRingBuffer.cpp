@@ -0,0 +1,207 @@
+#include "AudioRingBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+AudioRingBuffer::AudioRingBuffer(size_t capacityFrames, uint32_t frameBytes)
+{
+	Configure(capacityFrames, frameBytes);
+}
+
+void AudioRingBuffer::Configure(size_t capacityFrames, uint32_t frameBytes)
+{
+	_capacity = (frameBytes == 0) ? 0 : capacityFrames;
+	_frameBytes = frameBytes;
+	// 同尺寸重新配置（换片）不再分配
+	_data.resize(_capacity * (size_t)_frameBytes);
+	Reset();
+}
+
+void AudioRingBuffer::Reset()
+{
+	_writePos.store(0, std::memory_order_relaxed);
+	_readPos.store(0, std::memory_order_relaxed);
+	_flushPos.store(0, std::memory_order_relaxed);
+	_flushPending.store(false, std::memory_order_relaxed);
+	_flushes.store(0, std::memory_order_relaxed);
+	_framesFlushed.store(0, std::memory_order_relaxed);
+	_fullWrites.store(0, std::memory_order_relaxed);
+	_maxFill.store(0, std::memory_order_relaxed);
+}
+
+size_t AudioRingBuffer::WritableFrames() const
+{
+	const uint64_t w = _writePos.load(std::memory_order_relaxed);
+	const uint64_t r = _readPos.load(std::memory_order_acquire);
+	return _capacity - (size_t)(w - r);
+}
+
+size_t AudioRingBuffer::Write(const void* data, size_t frames)
+{
+	if (!data || frames == 0 || _capacity == 0) return 0;
+	const uint64_t w = _writePos.load(std::memory_order_relaxed);
+	const uint64_t r = _readPos.load(std::memory_order_acquire);
+	const size_t space = _capacity - (size_t)(w - r);
+	const size_t n = (std::min)(frames, space);
+	if (n < frames) _fullWrites.fetch_add(1, std::memory_order_relaxed);
+	if (n == 0) return 0;
+
+	// 环尾不够时分两段拷贝
+	const size_t at = (size_t)(w % _capacity);
+	const size_t first = (std::min)(n, _capacity - at);
+	const uint8_t* src = (const uint8_t*)data;
+	memcpy(_data.data() + at * _frameBytes, src, first * _frameBytes);
+	if (n > first)
+		memcpy(_data.data(), src + first * _frameBytes, (n - first) * _frameBytes);
+	_writePos.store(w + n, std::memory_order_release);
+
+	const size_t fill = (size_t)(w + n - r);
+	if (fill > _maxFill.load(std::memory_order_relaxed))
+		_maxFill.store(fill, std::memory_order_relaxed);
+	return n;
+}
+
+void AudioRingBuffer::RequestFlush()
+{
+	_flushPos.store(_writePos.load(std::memory_order_relaxed), std::memory_order_release);
+	_flushPending.store(true, std::memory_order_release);
+}
+
+size_t AudioRingBuffer::ReadableFrames() const
+{
+	const uint64_t w = _writePos.load(std::memory_order_acquire);
+	const uint64_t r = _readPos.load(std::memory_order_relaxed);
+	return (size_t)(w - r);
+}
+
+size_t AudioRingBuffer::Read(void* dst, size_t frames)
+{
+	if (!dst || frames == 0 || _capacity == 0) return 0;
+	const uint64_t w = _writePos.load(std::memory_order_acquire);
+	const uint64_t r = _readPos.load(std::memory_order_relaxed);
+	const size_t n = (std::min)(frames, (size_t)(w - r));
+	if (n == 0) return 0;
+
+	const size_t at = (size_t)(r % _capacity);
+	const size_t first = (std::min)(n, _capacity - at);
+	uint8_t* out = (uint8_t*)dst;
+	memcpy(out, _data.data() + at * _frameBytes, first * _frameBytes);
+	if (n > first)
+		memcpy(out + first * _frameBytes, _data.data(), (n - first) * _frameBytes);
+	_readPos.store(r + n, std::memory_order_release);
+	return n;
+}
+
+bool AudioRingBuffer::TakeFlush()
+{
+	if (!_flushPending.exchange(false, std::memory_order_acquire)) return false;
+	// _flushPos 不超过生产者请求时的写位置，此后写入的帧保留
+	const uint64_t to = _flushPos.load(std::memory_order_acquire);
+	const uint64_t r = _readPos.load(std::memory_order_relaxed);
+	_flushes.fetch_add(1, std::memory_order_relaxed);
+	if (to > r)
+	{
+		_framesFlushed.fetch_add(to - r, std::memory_order_relaxed);
+		_readPos.store(to, std::memory_order_release);
+	}
+	return true;
+}
+
+AudioRingBuffer::Stats AudioRingBuffer::GetStats() const
+{
+	Stats s;
+	s.FramesWritten = _writePos.load(std::memory_order_relaxed);
+	s.FramesRead = _readPos.load(std::memory_order_relaxed) - _framesFlushed.load(std::memory_order_relaxed);
+	s.Flushes = _flushes.load(std::memory_order_relaxed);
+	s.FramesFlushed = _framesFlushed.load(std::memory_order_relaxed);
+	s.FullWrites = _fullWrites.load(std::memory_order_relaxed);
+	s.MaxFill = _maxFill.load(std::memory_order_relaxed);
+	return s;
+}
+
+void AudioRenderPacer::Configure(uint32_t sampleRate, uint32_t bufferFrames, uint32_t periodFrames)
+{
+	_sampleRate = sampleRate;
+	_bufferFrames = bufferFrames;
+	// 取不到设备周期时按 10ms
+	if (periodFrames == 0) periodFrames = (std::max)(1u, sampleRate / 100);
+	_periodFrames = (bufferFrames > 0) ? (std::min)(periodFrames, bufferFrames) : periodFrames;
+	Reset();
+	ResetStats();
+}
+
+void AudioRenderPacer::Reset()
+{
+	_primed = false;
+	_deviceQueued.store(0, std::memory_order_relaxed);
+}
+
+void AudioRenderPacer::ResetStats()
+{
+	_periods.store(0, std::memory_order_relaxed);
+	_framesRendered.store(0, std::memory_order_relaxed);
+	_underruns.store(0, std::memory_order_relaxed);
+	_starvedFrames.store(0, std::memory_order_relaxed);
+	_queuedFramesSum.store(0, std::memory_order_relaxed);
+	_maxQueuedFrames.store(0, std::memory_order_relaxed);
+}
+
+void AudioRenderPacer::SetLatencyTargetMs(double ms)
+{
+	if (!(ms > 0.0)) ms = DefaultLatencyMs;
+	_latencyMs.store(std::clamp(ms, MinLatencyMs, MaxLatencyMs), std::memory_order_relaxed);
+}
+
+uint32_t AudioRenderPacer::DeviceTargetFrames() const
+{
+	const double frames = LatencyTargetMs() * (double)_sampleRate / 1000.0;
+	uint32_t target = (std::max)((uint32_t)(frames + 0.5), _periodFrames * 2);
+	if (_bufferFrames > 0) target = (std::min)(target, _bufferFrames);
+	return target;
+}
+
+uint32_t AudioRenderPacer::Render(uint32_t padding, size_t ringFrames)
+{
+	_periods.fetch_add(1, std::memory_order_relaxed);
+	if (_bufferFrames > 0) padding = (std::min)(padding, _bufferFrames);
+
+	const uint32_t target = DeviceTargetFrames();
+	const uint32_t want = (target > padding) ? target - padding : 0;
+	const uint32_t frames = (uint32_t)(std::min)((size_t)want, ringFrames);
+	const uint32_t queued = padding + frames;
+	_deviceQueued.store(queued, std::memory_order_relaxed);
+
+	if (!_primed)
+	{
+		// 启动/Flush 后第一次攒够一个周期才算开始出声
+		_primed = (queued >= _periodFrames);
+	}
+	else if (queued < _periodFrames)
+	{
+		_underruns.fetch_add(1, std::memory_order_relaxed);
+		_starvedFrames.fetch_add(_periodFrames - queued, std::memory_order_relaxed);
+	}
+
+	_framesRendered.fetch_add(frames, std::memory_order_relaxed);
+	const uint64_t total = (uint64_t)queued + (uint64_t)(ringFrames - frames);
+	_queuedFramesSum.fetch_add(total, std::memory_order_relaxed);
+	if (total > _maxQueuedFrames.load(std::memory_order_relaxed))
+		_maxQueuedFrames.store(total, std::memory_order_relaxed);
+	return frames;
+}
+
+AudioRenderPacer::Stats AudioRenderPacer::GetStats() const
+{
+	Stats s;
+	s.Periods = _periods.load(std::memory_order_relaxed);
+	s.FramesRendered = _framesRendered.load(std::memory_order_relaxed);
+	s.Underruns = _underruns.load(std::memory_order_relaxed);
+	s.StarvedFrames = _starvedFrames.load(std::memory_order_relaxed);
+	if (_sampleRate > 0)
+	{
+		const double msPerFrame = 1000.0 / (double)_sampleRate;
+		if (s.Periods > 0)
+			s.AverageQueuedMs = (double)_queuedFramesSum.load(std::memory_order_relaxed) / (double)s.Periods * msPerFrame;
+		s.MaxQueuedMs = (double)_maxQueuedFrames.load(std::memory_order_relaxed) * msPerFrame;
+	}
+	return s;
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file AudioRingBuffer.h
+ * @brief AudioRingBuffer：PCM 帧的无锁单生产者/单消费者环形缓冲；AudioRenderPacer：按设备周期决定每次送入设备的帧数。
+ *
+ * 不依赖 Win32/WASAPI，可单独编译测试（设备时钟可以模拟）。MediaPlayer 的 SourceReader 后端中：
+ * - 解码线程是唯一生产者：解码、变速后 Write 进环；Seek/倍速切换时 RequestFlush
+ * - 音频渲染线程是唯一消费者：每个设备周期醒来一次，先 TakeFlush，再按 AudioRenderPacer::Render
+ *   给出的帧数从环里 Read 到设备缓冲
+ *
+ * 读写位置是只增不减的帧计数（各自只由一端写），环内位置取模得到；稳态不分配、不加锁。
+ */
+
+class AudioRingBuffer
+{
+public:
+	struct Stats
+	{
+		/** @brief 写入 / 读出的总帧数。 */
+		uint64_t FramesWritten = 0;
+		uint64_t FramesRead = 0;
+		/** @brief Flush 次数与被丢弃的帧数。 */
+		uint64_t Flushes = 0;
+		uint64_t FramesFlushed = 0;
+		/** @brief Write 时环已满、没能写完的次数（生产者需要等待）。 */
+		uint64_t FullWrites = 0;
+		/** @brief 写入后的最大填充帧数。 */
+		size_t MaxFill = 0;
+	};
+
+	AudioRingBuffer() = default;
+	AudioRingBuffer(size_t capacityFrames, uint32_t frameBytes);
+	AudioRingBuffer(const AudioRingBuffer&) = delete;
+	AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+
+	/**
+	 * @brief 分配 capacityFrames 帧（每帧 frameBytes 字节）并清空。
+	 *
+	 * 只能在生产者与消费者都未运行时调用。
+	 */
+	void Configure(size_t capacityFrames, uint32_t frameBytes);
+	/** @brief 清空内容与统计（同样只能在两端都未运行时调用）。 */
+	void Reset();
+
+	size_t CapacityFrames() const { return _capacity; }
+	uint32_t FrameBytes() const { return _frameBytes; }
+
+	// ===== 生产者 =====
+	size_t WritableFrames() const;
+	/** @brief 写入最多 frames 帧，返回实际写入的帧数（环满时少于 frames）。 */
+	size_t Write(const void* data, size_t frames);
+	/**
+	 * @brief 作废此前写入、消费者尚未读出的帧（Seek/倍速切换）。
+	 *
+	 * 由生产者调用；之后写入的帧不受影响。消费者在下一次 TakeFlush 时真正丢弃。
+	 */
+	void RequestFlush();
+
+	// ===== 消费者 =====
+	size_t ReadableFrames() const;
+	/** @brief 读出最多 frames 帧到 dst，返回实际读出的帧数。 */
+	size_t Read(void* dst, size_t frames);
+	/** @brief 执行挂起的 Flush；有 Flush 时返回 true（调用方可据此清空设备缓冲）。 */
+	bool TakeFlush();
+
+	Stats GetStats() const;
+
+private:
+	std::vector<uint8_t> _data;
+	size_t _capacity = 0;
+	uint32_t _frameBytes = 0;
+	/** @brief 累计写入帧数（只由生产者写）。 */
+	std::atomic<uint64_t> _writePos{ 0 };
+	/** @brief 累计读出帧数（只由消费者写）。 */
+	std::atomic<uint64_t> _readPos{ 0 };
+	/** @brief 挂起的 Flush：消费者把读位置推进到 _flushPos。 */
+	std::atomic<uint64_t> _flushPos{ 0 };
+	std::atomic<bool> _flushPending{ false };
+
+	std::atomic<uint64_t> _flushes{ 0 };
+	std::atomic<uint64_t> _framesFlushed{ 0 };
+	std::atomic<uint64_t> _fullWrites{ 0 };
+	std::atomic<size_t> _maxFill{ 0 };
+};
+
+/**
+ * @brief 设备周期驱动的渲染节拍：每个周期根据设备已排队帧数（padding）与环内可读帧数决定送入多少帧。
+ *
+ * 延迟目标（毫秒）是设备中保持排队的音频量：每个周期把设备补到 max(目标, 2 个周期)（不超过设备缓冲）。
+ * 已开始出声后，若本周期补完仍不足一个周期（下一次唤醒前设备会播空），计一次欠载，
+ * 缺少的帧数计入 StarvedFrames（即设备实际补静音的帧数）。
+ *
+ * Configure/Reset/Render 只由渲染线程调用；SetLatencyTargetMs 与 GetStats 可在任意线程调用。
+ */
+class AudioRenderPacer
+{
+public:
+	struct Stats
+	{
+		/** @brief 设备周期（Render 调用）次数。 */
+		uint64_t Periods = 0;
+		/** @brief 送入设备的帧数。 */
+		uint64_t FramesRendered = 0;
+		/** @brief 欠载的周期数（该周期内设备会播空）与设备缺帧数。 */
+		uint64_t Underruns = 0;
+		uint64_t StarvedFrames = 0;
+		/** @brief 每周期送入后的排队时长（设备 + 环，毫秒）。 */
+		double AverageQueuedMs = 0.0;
+		double MaxQueuedMs = 0.0;
+	};
+
+	static constexpr double DefaultLatencyMs = 60.0;
+	static constexpr double MinLatencyMs = 10.0;
+	static constexpr double MaxLatencyMs = 500.0;
+
+	/**
+	 * @param bufferFrames 设备缓冲帧数。
+	 * @param periodFrames 设备周期帧数（唤醒间隔）。
+	 */
+	void Configure(uint32_t sampleRate, uint32_t bufferFrames, uint32_t periodFrames);
+	/** @brief 重新开始（启动、Flush 后）：尚未出声，不计欠载。统计保留。 */
+	void Reset();
+	void ResetStats();
+
+	/** @brief 延迟目标（毫秒，限制在 MinLatencyMs - MaxLatencyMs）。 */
+	void SetLatencyTargetMs(double ms);
+	double LatencyTargetMs() const { return _latencyMs.load(std::memory_order_relaxed); }
+	/** @brief 本周期要让设备排队到的帧数。 */
+	uint32_t DeviceTargetFrames() const;
+
+	uint32_t SampleRate() const { return _sampleRate; }
+	uint32_t BufferFrames() const { return _bufferFrames; }
+	uint32_t PeriodFrames() const { return _periodFrames; }
+
+	/**
+	 * @brief 一个设备周期：返回应从环里读出并写入设备的帧数。
+	 * @param padding 设备中尚未播放的帧数。
+	 * @param ringFrames 环内可读帧数。
+	 */
+	uint32_t Render(uint32_t padding, size_t ringFrames);
+	/** @brief 上一个周期送入后设备中排队的帧数（任意线程可读；Reset 后为 0）。 */
+	uint32_t DeviceQueuedFrames() const { return _deviceQueued.load(std::memory_order_relaxed); }
+
+	Stats GetStats() const;
+
+private:
+	uint32_t _sampleRate = 0;
+	uint32_t _bufferFrames = 0;
+	uint32_t _periodFrames = 0;
+	std::atomic<double> _latencyMs{ DefaultLatencyMs };
+	/** @brief 已有足量数据送入设备（之后缺帧才算欠载）。 */
+	bool _primed = false;
+	std::atomic<uint32_t> _deviceQueued{ 0 };
+
+	std::atomic<uint64_t> _periods{ 0 };
+	std::atomic<uint64_t> _framesRendered{ 0 };
+	std::atomic<uint64_t> _underruns{ 0 };
+	std::atomic<uint64_t> _starvedFrames{ 0 };
+	std::atomic<uint64_t> _queuedFramesSum{ 0 };
+	std::atomic<uint64_t> _maxQueuedFrames{ 0 };
+};
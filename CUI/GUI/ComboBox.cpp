@@ -371,7 +371,7 @@ bool ComboBox::ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int xo
 								this->ParentForm->ForegroundControl = NULL;
 						}
 
-					// 收起/展开时：强制立即重绘（UpdateWindow），避免 WM_PAINT 被延后导致“残影直到 Resize 才消失”
+					// 收起/展开时：整窗失效并请求一帧，避免 WM_PAINT 被延后导致“残影直到 Resize 才消失”
 					if (this->ParentForm)
 						this->ParentForm->Invalidate(true);
 						this->PostRender();
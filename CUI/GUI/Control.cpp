@@ -9,7 +9,6 @@
 Control::Control()
 	:
 	Enable(true),
-	Visible(true),
 	Checked(false),
 	ParentForm(nullptr),
 	Parent(nullptr),
@@ -47,6 +46,7 @@ void Control::Update() {}
 
 void Control::RequestLayout()
 {
+	this->InvalidateMeasure();
 	if (this->Parent)
 	{
 		auto* panelParent = dynamic_cast<Panel*>(this->Parent);
@@ -62,14 +62,44 @@ void Control::RequestLayout()
 		this->ParentForm->InvalidateLayout();
 	}
 }
+void Control::NotifyBoundsChanged()
+{
+	this->InvalidateDisplayList();
+	if (this->Parent)
+		this->Parent->Children.UpdateBounds(this);
+	else if (this->ParentForm)
+		this->ParentForm->Controls.UpdateBounds(this);
+}
+SpatialRect ControlBounds::Bounds(Control* c)
+{
+	POINT loc = c->Location;
+	SIZE sz = c->ActualSize();
+	return SpatialRect{ loc.x, loc.y, loc.x + sz.cx, loc.y + sz.cy };
+}
+void Control::ChildrenAtPoint(POINT local, std::vector<Control*>& out)
+{
+	this->Children.QueryPoint(SpatialPoint{ local.x, local.y }, out);
+}
+void Control::ChildrenInRect(const RECT& local, std::vector<Control*>& out, int inflatePx)
+{
+	this->Children.QueryRect(SpatialRect{ local.left, local.top, local.right, local.bottom }, inflatePx, out);
+}
 void Control::PostRender()
 {
+	this->InvalidateDisplayList();
 	if (!this->IsVisual || !this->ParentForm) return;
 	const float top = (this->ParentForm->VisibleHead ? (float)this->ParentForm->HeadHeight : 0.0f);
 	auto r = this->AbsRect;
 	r.top += top;
 	r.bottom += top;
 
+	// 非 UI 线程（MediaPlayer 解码线程等）只投递当前区域；上次区域只由 UI 线程读写
+	if (!this->ParentForm->IsUiThread())
+	{
+		this->ParentForm->Invalidate(r, false);
+		return;
+	}
+
 	if (_hasLastPostRenderClientRect)
 	{
 		D2D1_RECT_F u{};
@@ -88,6 +118,38 @@ void Control::PostRender()
 	_hasLastPostRenderClientRect = true;
 }
 
+void Control::InvalidateDisplayList()
+{
+	for (Control* c = this; c; c = c->Parent)
+		c->_displayListValid = false;
+}
+
+void Control::Draw()
+{
+	auto* render = this->ParentForm ? this->ParentForm->Render : nullptr;
+	if (!this->CacheDisplayList || !render)
+	{
+		this->Update();
+		return;
+	}
+	POINT abs = this->AbsLocation;
+	UINT64 generation = this->ParentForm->DisplayListGeneration();
+	if (_displayListValid && _displayListGeneration == generation &&
+		_displayListLocation.x == abs.x && _displayListLocation.y == abs.y)
+	{
+		render->Replay(_displayList);
+		return;
+	}
+	// 录制期间照常绘制；Update 中若调用 PostRender，缓存会重新置为失效
+	_displayList.Reset();
+	_displayListValid = true;
+	_displayListLocation = abs;
+	_displayListGeneration = generation;
+	render->BeginRecording(&_displayList);
+	this->Update();
+	render->EndRecording();
+}
+
 GET_CPP(Control, class Font*, Font)
 {
 	if (this->_font)
@@ -121,6 +183,9 @@ void Control::SetFontEx(class Font* value, bool takeOwnership)
 	}
 	this->_font = value;
 	this->_ownsFont = takeOwnership;
+	// 即使自身测量缓存已因 Arrange 失效，父容器的缓存仍可能有效，总是通知
+	this->RequestLayout();
+	this->NotifyBoundsChanged();
 	this->PostRender();
 }
 
@@ -178,6 +243,19 @@ GET_CPP(Control, D2D1_RECT_F, AbsRect)
 		(float)absMin.y + (float)asize.cy
 	};
 }
+GET_CPP(Control, bool, Visible)
+{
+	return _visible;
+}
+SET_CPP(Control, bool, Visible)
+{
+	if (value == _visible) return;
+	// 隐藏前登记当前区域（隐藏后 PostRender 不再登记），显示后登记新区域
+	if (!value) this->PostRender();
+	_visible = value;
+	if (value) this->PostRender();
+	this->RequestLayout();
+}
 GET_CPP(Control, bool, IsVisual)
 {
 	if (this->Visible == false) return false;
@@ -198,6 +276,7 @@ SET_CPP(Control, POINT, Location)
 	this->OnMoved(this);
 	_location = value;
 	this->UpdateLayoutBaseLocation(value);
+	this->NotifyBoundsChanged();
 	this->PostRender();
 }
 GET_CPP(Control, SIZE, Size)
@@ -210,6 +289,7 @@ SET_CPP(Control, SIZE, Size)
 	_size = value;
 	this->UpdateLayoutBaseSize(value);
 	this->RequestLayout();
+	this->NotifyBoundsChanged();
 	this->PostRender();
 }
 GET_CPP(Control, int, Left)
@@ -220,6 +300,7 @@ SET_CPP(Control, int, Left)
 {
 	this->_location = POINT{ value,this->_location.y };
 	this->UpdateLayoutBaseLocation(this->_location);
+	this->NotifyBoundsChanged();
 	this->PostRender();
 }
 GET_CPP(Control, int, Top)
@@ -230,6 +311,7 @@ SET_CPP(Control, int, Top)
 {
 	this->_location = POINT{ this->_location.x,value };
 	this->UpdateLayoutBaseLocation(this->_location);
+	this->NotifyBoundsChanged();
 	this->PostRender();
 }
 GET_CPP(Control, int, Width)
@@ -242,6 +324,7 @@ SET_CPP(Control, int, Width)
 	this->_size.cx = value;
 	this->UpdateLayoutBaseSize(this->_size);
 	this->RequestLayout();
+	this->NotifyBoundsChanged();
 	this->PostRender();
 }
 GET_CPP(Control, int, Height)
@@ -254,6 +337,7 @@ SET_CPP(Control, int, Height)
 	_size.cy = value;
 	this->UpdateLayoutBaseSize(this->_size);
 	this->RequestLayout();
+	this->NotifyBoundsChanged();
 	this->PostRender();
 }
 GET_CPP(Control, float, Right)
@@ -277,6 +361,9 @@ SET_CPP(Control, std::wstring, Text)
 		this->PostRender();
 	}
 	_text = value;
+	// 文本影响 Label/CheckBox 等的 ActualSize，总是通知父容器重新测量
+	this->RequestLayout();
+	this->NotifyBoundsChanged();
 }
 GET_CPP(Control, D2D1_COLOR_F, BolderColor)
 {
@@ -619,21 +706,14 @@ SET_CPP(Control, SIZE, MaxSize)
 }
 
 // 测量控件期望尺寸
-SIZE Control::MeasureCore(SIZE availableSize)
+LayoutSize Control::MeasureCore(LayoutSize availableSize)
 {
-	SIZE desired = this->_size;
-	if (this->ParentForm)
-	{
-		SIZE actualSize = this->ActualSize();
-		if (actualSize.cx != desired.cx || actualSize.cy != desired.cy)
-		{
-			desired = actualSize;
-		}
-	}
+	LayoutSize desired;
+	this->TryGetActualLayoutSize(desired);
 
 	// 应用 Padding
-	desired.cx += (LONG)(_padding.Left + _padding.Right);
-	desired.cy += (LONG)(_padding.Top + _padding.Bottom);
+	desired.cx += (int)(_padding.Left + _padding.Right);
+	desired.cy += (int)(_padding.Top + _padding.Bottom);
 
 	// 应用约束
 	if (desired.cx < _minSize.cx) desired.cx = _minSize.cx;
@@ -648,26 +728,39 @@ SIZE Control::MeasureCore(SIZE availableSize)
 	return desired;
 }
 
+bool Control::TryGetActualLayoutSize(LayoutSize& actual)
+{
+	actual = LayoutSize{ _size.cx, _size.cy };
+	if (!this->ParentForm) return false;
+	SIZE actualSize = this->ActualSize();
+	if (actualSize.cx == _size.cx && actualSize.cy == _size.cy) return false;
+	actual = LayoutSize{ actualSize.cx, actualSize.cy };
+	return true;
+}
+
 // 应用布局结果
-void Control::ApplyLayout(POINT location, SIZE size)
+void Control::ApplyLayout(LayoutPoint location, LayoutSize size)
 {
 	bool locationChanged = (_location.x != location.x || _location.y != location.y);
 	bool sizeChanged = (_size.cx != size.cx || _size.cy != size.cy);
 
 	if (locationChanged)
 	{
-		_location = location;
+		_location = POINT{ location.x, location.y };
 		this->OnMoved(this);
 	}
 
 	if (sizeChanged)
 	{
-		_size = size;
+		_size = SIZE{ size.cx, size.cy };
+		// 默认 MeasureCore 以当前尺寸为期望尺寸，只使自身缓存失效（父容器正在布局）
+		_measureValid = false;
 		this->OnSizeChanged(this);
 	}
 
 	if (locationChanged || sizeChanged)
 	{
+		this->NotifyBoundsChanged();
 		this->PostRender();
 	}
 }
\ No newline at end of file
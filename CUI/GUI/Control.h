@@ -14,12 +14,14 @@
 // (using external CppUtils)
 
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <cstdint>
 #include <memory>
 #include <wrl/client.h>
-#include "Layout/LayoutTypes.h"
+#include "Layout/LayoutElement.h"
+#include "SpatialIndex.h"
 
 struct ID2D1Bitmap;
 
@@ -33,6 +35,17 @@ struct ID2D1Bitmap;
  * - 布局相关属性（Margin/Padding/Anchor/Grid/Dock/MinSize/MaxSize）由布局引擎与容器协同使用。
  */
 
+class Control;
+
+/** @brief 子控件在父容器坐标系中的矩形（Location + ActualSize），空间索引使用。 */
+struct ControlBounds
+{
+	static SpatialRect Bounds(Control* c);
+};
+
+/** @brief 子控件列表：增删与重排都会使其空间索引失效（见 SpatialList）。 */
+typedef SpatialList<Control, ControlBounds, List<Control*>> ControlCollection;
+
 inline Font* GetDefaultFontObject()
 {
 	static Font defaultFont(L"Arial", 14.0f);
@@ -86,6 +99,7 @@ enum class UIClass : int
 	UI_WrapPanel,
 	UI_RelativePanel,
 	UI_DateTimePicker,
+	UI_VirtualizingStackPanel,
 	UI_CUSTOM
 };
 
@@ -143,13 +157,13 @@ typedef Event<void(class Control*)> SelectionChangedEvent;
  * 控件是轻量对象，主要职责：
  * - 保存几何（Location/Size）、颜色（Back/Fore/Border）、文本、资源指针（Font/Image）等属性
  * - 处理输入消息（ProcessMessage）并触发相应事件
- * - 参与布局：提供 MeasureCore/ApplyLayout，且通过 RequestLayout 通知父容器重排
+ * - 参与布局：实现 LayoutElement（MeasureCore/ApplyLayout 等），且通过 RequestLayout 通知父容器重排
  *
  * 所有权说明：
  * - Font：通过属性 Font 设置时默认由控件接管并在替换/析构时释放；可用 SetFontEx 指定不接管。
  * - Image：改为存储 BitmapSource（设备无关），渲染时按需创建 ID2D1Bitmap 缓存。
  */
-class Control
+class Control : public LayoutElement
 {
 protected:
 	POINT _location = { 0,0 };
@@ -165,6 +179,7 @@ protected:
 	bool _ownsFont = false;
 	D2D1_RECT_F _lastPostRenderClientRect{ 0,0,0,0 };
 	bool _hasLastPostRenderClientRect = false;
+	bool _visible = true;
 	
 	// 布局属性
 	Thickness _margin;
@@ -192,6 +207,13 @@ protected:
 	SIZE _layoutBaseSize = { 120,20 };
 	bool _layoutBaseInitialized = false;
 
+	// 显示列表缓存（CacheDisplayList 为 true 时由 Draw 录制/回放）
+	DisplayList _displayList;
+	// PostRender 可能来自非 UI 线程（InvalidateDisplayList 沿父链写入）
+	std::atomic<bool> _displayListValid{ false };
+	POINT _displayListLocation = { 0,0 };
+	UINT64 _displayListGeneration = 0;
+
 	void EnsureLayoutBase()
 	{
 		if (_layoutBaseInitialized) return;
@@ -212,8 +234,10 @@ protected:
 		_layoutBaseInitialized = true;
 	}
 
-	// 通知父容器（Panel 或 Form）需要重新布局
+	// 使自身及祖先的测量缓存失效，并通知父容器（Panel 或 Form）需要重新布局
 	void RequestLayout();
+	// 位置/尺寸（或影响 ActualSize 的属性）变化后，增量更新父容器（或 Form）的空间索引
+	void NotifyBoundsChanged();
 
 	friend class Panel;
 	friend class Form;
@@ -268,12 +292,15 @@ public:
 	/** @brief 文本是否发生变化（用于渲染或布局的脏标记）。 */
 	bool TextChanged = true;
 	bool Enable;
-	bool Visible;
+	/** @brief 是否显示；隐藏的控件不参与布局，修改会通知父容器重新布局。 */
+	PROPERTY(bool, Visible);
+	GET(bool, Visible);
+	SET(bool, Visible);
 	bool Checked;
 	/** @brief 用户自定义数据槽（不由框架解释）。 */
 	UINT64 Tag;
-	/** @brief 子控件集合。 */
-	List<Control*> Children;
+	/** @brief 子控件集合（持有子控件的空间索引）。 */
+	ControlCollection Children;
 	/** @brief 图片绘制模式。 */
 	ImageSizeMode SizeMode = ImageSizeMode::Zoom;
 	/** @brief 创建基础控件。 */
@@ -292,6 +319,22 @@ public:
 	 * @return true 表示 outRect 有效。
 	 */
 	virtual bool GetAnimatedInvalidRect(D2D1_RECT_F& outRect) { (void)outRect; return false; }
+	/**
+	 * @brief 是否缓存绘制命令：缓存有效时 Draw 直接回放上次录制的显示列表，不再执行 Update。
+	 *
+	 * 缓存在 PostRender、尺寸/位置变化、窗口整体失效时失效。只适用于外观完全由自身状态决定、
+	 * 状态变化时调用 PostRender 的控件；依赖时间的动画（GetAnimatedInvalidRect）、
+	 * 在 Update 中处理逻辑或直接使用设备上下文绘制的控件不应开启。
+	 */
+	bool CacheDisplayList = false;
+	/** @brief 绘制控件（父容器/窗口调用）：按 CacheDisplayList 执行 Update 或回放缓存。 */
+	void Draw();
+	/** @brief 使自身及祖先的显示列表缓存失效（祖先的列表包含子控件的命令）。 */
+	void InvalidateDisplayList();
+	/** @brief 是否持有可回放的显示列表。 */
+	bool IsDisplayListValid() const { return _displayListValid; }
+	/** @brief 最近一次录制的显示列表。 */
+	const DisplayList& GetDisplayList() const { return _displayList; }
 	PROPERTY(class Font*, Font);
 	GET(class Font*, Font);
 	SET(class Font*, Font);
@@ -324,6 +367,7 @@ public:
 	static void SetChildrenParentForm(Control* c, Form* form) {
 		if (!c) return;
 		c->ParentForm = form;
+		c->_measureValid = false;
 		for (int i = 0; i < c->Children.Count; i++) {
 			SetChildrenParentForm(c->Children[i], form);
 		}
@@ -333,6 +377,16 @@ public:
 	 * @param c 需要移除的控件。
 	 */
 	void RemoveControl(Control* c);
+	/**
+	 * @brief 查询包含点的子控件（本控件坐标系，含右/下边界），按绘制顺序输出。
+	 *
+	 * 子控件较多时走空间索引，否则线性扫描；结果不过滤 Visible/Enable。
+	 */
+	void ChildrenAtPoint(POINT local, std::vector<Control*>& out);
+	/** @brief 查询与矩形相交的子控件（本控件坐标系），按绘制顺序输出。 */
+	void ChildrenInRect(const RECT& local, std::vector<Control*>& out, int inflatePx = 0);
+	/** @brief 通过下标或迭代器直接改写 Children 元素后调用，下次查询时重建空间索引。 */
+	void InvalidateChildIndex() { Children.InvalidateIndex(); }
 	READONLY_PROPERTY(POINT, AbsLocation);
 	GET(POINT, AbsLocation);
 	READONLY_PROPERTY(D2D1_RECT_F, AbsRect);
@@ -362,8 +416,9 @@ public:
 	READONLY_PROPERTY(float, Bottom);
 	GET(float, Bottom);
 	PROPERTY(std::wstring, Text);
-	GET(std::wstring, Text);
-	SET(std::wstring, Text);
+	// 虚函数：文本存储不在 _text 中的控件（如 RichTextBox）可按需同步
+	virtual GET(std::wstring, Text);
+	virtual SET(std::wstring, Text);
 	PROPERTY(D2D1_COLOR_F, BolderColor);
 	GET(D2D1_COLOR_F, BolderColor);
 	SET(D2D1_COLOR_F, BolderColor);
@@ -420,14 +475,34 @@ public:
 	SET(SIZE, MaxSize);
 	
 	/**
-	 * @brief 测量阶段：返回控件期望尺寸。
+	 * @brief 测量阶段：返回控件期望尺寸（当前尺寸或 ActualSize 加 Padding，受 MinSize/MaxSize 约束）。
 	 * @param availableSize 可用空间（由父布局提供）。
+	 *
+	 * 带缓存的 Measure/InvalidateMeasure 见 LayoutElement；影响结果的属性变化时由 RequestLayout 使缓存失效。
 	 */
-	virtual SIZE MeasureCore(SIZE availableSize);
+	LayoutSize MeasureCore(LayoutSize availableSize) override;
 	/**
 	 * @brief 布局应用：由布局引擎/父容器设置最终位置与尺寸。
 	 */
-	void ApplyLayout(POINT location, SIZE size);
+	void ApplyLayout(LayoutPoint location, LayoutSize size) override;
+	void ApplyLayout(POINT location, SIZE size) { ApplyLayout(LayoutPoint{ location.x, location.y }, LayoutSize{ size.cx, size.cy }); }
+
+	// LayoutElement：布局引擎通过以下接口读取布局属性
+	LayoutElement* GetLayoutParent() override { return this->Parent; }
+	int GetLayoutChildCount() override { return this->Children.Count; }
+	LayoutElement* GetLayoutChild(int index) override { return this->Children[index]; }
+	bool IsLayoutVisible() override { return _visible; }
+	Thickness GetLayoutMargin() override { return _margin; }
+	Thickness GetLayoutPadding() override { return _padding; }
+	::HorizontalAlignment GetLayoutHAlign() override { return _horizontalAlignment; }
+	::VerticalAlignment GetLayoutVAlign() override { return _verticalAlignment; }
+	::Dock GetLayoutDock() override { return _dock; }
+	int GetLayoutGridRow() override { return _gridRow; }
+	int GetLayoutGridColumn() override { return _gridColumn; }
+	int GetLayoutGridRowSpan() override { return _gridRowSpan; }
+	int GetLayoutGridColumnSpan() override { return _gridColumnSpan; }
+	LayoutSize GetLayoutSize() override { return LayoutSize{ _size.cx, _size.cy }; }
+	bool TryGetActualLayoutSize(LayoutSize& actual) override;
 
 	CursorKind Cursor = CursorKind::Arrow;
 	/**
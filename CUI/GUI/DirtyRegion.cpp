@@ -0,0 +1,131 @@
+#include "DirtyRegion.h"
+#include <algorithm>
+#include <cstddef>
+
+DirtyRect DirtyRect::Union(const DirtyRect& r) const
+{
+	if (IsEmpty()) return r;
+	if (r.IsEmpty()) return *this;
+	return DirtyRect(
+		(std::min)(Left, r.Left),
+		(std::min)(Top, r.Top),
+		(std::max)(Right, r.Right),
+		(std::max)(Bottom, r.Bottom));
+}
+
+DirtyRect DirtyRect::Intersect(const DirtyRect& r) const
+{
+	DirtyRect out(
+		(std::max)(Left, r.Left),
+		(std::max)(Top, r.Top),
+		(std::min)(Right, r.Right),
+		(std::min)(Bottom, r.Bottom));
+	if (out.IsEmpty()) return DirtyRect();
+	return out;
+}
+
+DirtyRegion::DirtyRegion(int maxRects, long long mergeSlack)
+	: _maxRects(maxRects < 1 ? 1 : maxRects), _mergeSlack(mergeSlack < 0 ? 0 : mergeSlack)
+{
+}
+
+bool DirtyRegion::ShouldMerge(const DirtyRect& a, const DirtyRect& b) const
+{
+	// 分开绘制至少要画 a + b - 重叠 个像素；并集多出的部分不超过单矩形开销时合并
+	long long separate = a.Area() + b.Area() - a.Intersect(b).Area();
+	return a.Union(b).Area() <= separate + _mergeSlack;
+}
+
+void DirtyRegion::Add(const DirtyRect& input)
+{
+	if (input.IsEmpty()) return;
+	DirtyRect r = input;
+	for (auto& e : _rects)
+	{
+		if (e.Contains(r)) return;
+	}
+
+	// 反复与现有矩形合并：合并后的矩形可能又与其他矩形满足合并条件
+	bool merged = true;
+	while (merged)
+	{
+		merged = false;
+		for (size_t i = 0; i < _rects.size(); i++)
+		{
+			if (r.Contains(_rects[i]) || ShouldMerge(_rects[i], r))
+			{
+				r = r.Union(_rects[i]);
+				_rects[i] = _rects.back();
+				_rects.pop_back();
+				merged = true;
+				break;
+			}
+		}
+	}
+	_rects.push_back(r);
+
+	while ((int)_rects.size() > _maxRects)
+		MergeCheapestPair();
+}
+
+void DirtyRegion::Add(const DirtyRegion& other)
+{
+	for (auto& r : other._rects)
+		Add(r);
+}
+
+void DirtyRegion::MergeCheapestPair()
+{
+	size_t bestA = 0;
+	size_t bestB = 1;
+	long long bestCost = -1;
+	for (size_t i = 0; i < _rects.size(); i++)
+	{
+		for (size_t j = i + 1; j < _rects.size(); j++)
+		{
+			const DirtyRect& a = _rects[i];
+			const DirtyRect& b = _rects[j];
+			long long cost = a.Union(b).Area() - (a.Area() + b.Area() - a.Intersect(b).Area());
+			if (bestCost < 0 || cost < bestCost)
+			{
+				bestCost = cost;
+				bestA = i;
+				bestB = j;
+			}
+		}
+	}
+	DirtyRect u = _rects[bestA].Union(_rects[bestB]);
+	_rects.erase(_rects.begin() + (std::ptrdiff_t)bestB);
+	_rects.erase(_rects.begin() + (std::ptrdiff_t)bestA);
+	// 合并结果可能包含其他矩形，走一遍 Add 的包含/合并逻辑
+	Add(u);
+}
+
+void DirtyRegion::ClipTo(const DirtyRect& bounds)
+{
+	std::vector<DirtyRect> clipped;
+	clipped.reserve(_rects.size());
+	for (auto& r : _rects)
+	{
+		DirtyRect c = r.Intersect(bounds);
+		if (!c.IsEmpty())
+			clipped.push_back(c);
+	}
+	_rects.swap(clipped);
+}
+
+DirtyRect DirtyRegion::Bounds() const
+{
+	DirtyRect b;
+	for (auto& r : _rects)
+		b = b.Union(r);
+	return b;
+}
+
+long long DirtyRegion::PaintedPixels() const
+{
+	long long total = 0;
+	for (auto& r : _rects)
+		total += r.Area();
+	return total;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <vector>
+
+/**
+ * @file DirtyRegion.h
+ * @brief DirtyRegion：由少量矩形组成的脏区域（重绘合并用）。
+ *
+ * 不依赖 Win32/D2D，可单独编译测试。Form 把 Invalidate 的矩形与系统更新区域累积到这里，
+ * 渲染时对每个矩形单独裁剪绘制，而不是重绘它们的外接矩形。
+ *
+ * 合并策略：
+ * - 被已有矩形包含的矩形直接丢弃；新矩形包含的旧矩形被移除
+ * - 两个矩形的并集面积不超过“各自面积 - 重叠 + MergeSlack”时合并（并集更省）
+ * - 超过 MaxRects 时，合并新增面积最小的一对
+ */
+
+/** @brief 像素矩形（左上闭、右下开）。 */
+struct DirtyRect
+{
+	int Left = 0;
+	int Top = 0;
+	int Right = 0;
+	int Bottom = 0;
+
+	DirtyRect() = default;
+	DirtyRect(int left, int top, int right, int bottom)
+		: Left(left), Top(top), Right(right), Bottom(bottom) {}
+
+	int Width() const { return Right - Left; }
+	int Height() const { return Bottom - Top; }
+	bool IsEmpty() const { return Right <= Left || Bottom <= Top; }
+	long long Area() const { return IsEmpty() ? 0 : (long long)Width() * (long long)Height(); }
+	bool Contains(const DirtyRect& r) const
+	{
+		return r.Left >= Left && r.Top >= Top && r.Right <= Right && r.Bottom <= Bottom;
+	}
+	bool Intersects(const DirtyRect& r) const
+	{
+		return r.Left < Right && Left < r.Right && r.Top < Bottom && Top < r.Bottom;
+	}
+	DirtyRect Union(const DirtyRect& r) const;
+	DirtyRect Intersect(const DirtyRect& r) const;
+};
+
+class DirtyRegion
+{
+public:
+	/** @brief 默认最多保留的矩形数量。 */
+	static const int DefaultMaxRects = 8;
+	/**
+	 * @brief 默认合并阈值（像素）：每个矩形单独绘制的固定开销，约一个 64x64 块。
+	 * 并集多出的面积不超过该值时，合并比分开绘制更便宜。
+	 */
+	static const long long DefaultMergeSlack = 64 * 64;
+
+	explicit DirtyRegion(int maxRects = DefaultMaxRects, long long mergeSlack = DefaultMergeSlack);
+
+	void Add(const DirtyRect& r);
+	void Add(const DirtyRegion& other);
+	void Clear() { _rects.clear(); }
+	/** @brief 裁剪到 bounds（通常为客户区），丢弃落在外面的矩形。 */
+	void ClipTo(const DirtyRect& bounds);
+
+	bool IsEmpty() const { return _rects.empty(); }
+	int Count() const { return (int)_rects.size(); }
+	const std::vector<DirtyRect>& Rects() const { return _rects; }
+	/** @brief 所有矩形的外接矩形（旧的单矩形重绘范围）。 */
+	DirtyRect Bounds() const;
+	/** @brief 逐矩形重绘的像素数（各矩形面积之和）。 */
+	long long PaintedPixels() const;
+
+	int MaxRects() const { return _maxRects; }
+	long long MergeSlack() const { return _mergeSlack; }
+
+private:
+	std::vector<DirtyRect> _rects;
+	int _maxRects;
+	long long _mergeSlack;
+
+	bool ShouldMerge(const DirtyRect& a, const DirtyRect& b) const;
+	void MergeCheapestPair();
+};
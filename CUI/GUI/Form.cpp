@@ -46,29 +46,33 @@ void Form::ApplyCursor(CursorKind kind)
 	::SetCursor(desired);
 }
 
-static Control* HitTestDeepestChild(Control* root, POINT contentMouse)
+// rootAbs 为 root 的绝对位置：沿递归累加，避免对每个子控件沿父链计算 AbsLocation
+static Control* HitTestDeepestChild(Control* root, POINT rootAbs, POINT contentMouse)
 {
 	if (!root) return NULL;
 	if (!root->Visible || !root->Enable) return NULL;
 	if (!root->HitTestChildren())
 		return root;
 
-	for (int i = root->Count - 1; i >= 0; i--)
+	std::vector<Control*> hits;
+	root->ChildrenAtPoint(POINT{ contentMouse.x - rootAbs.x, contentMouse.y - rootAbs.y }, hits);
+	for (auto it = hits.rbegin(); it != hits.rend(); ++it)
 	{
-		auto c = root->operator[](i);
-		if (!c || !c->Visible || !c->Enable) continue;
-		auto abs = c->AbsLocation;
-		auto sz = c->ActualSize();
-		if (contentMouse.x >= abs.x && contentMouse.y >= abs.y &&
-			contentMouse.x <= abs.x + sz.cx && contentMouse.y <= abs.y + sz.cy)
-		{
-			auto deeper = HitTestDeepestChild(c, contentMouse);
-			return deeper ? deeper : c;
-		}
+		auto c = *it;
+		if (!c->Visible || !c->Enable) continue;
+		auto loc = c->Location;
+		auto deeper = HitTestDeepestChild(c, POINT{ rootAbs.x + loc.x, rootAbs.y + loc.y }, contentMouse);
+		return deeper ? deeper : c;
 	}
 	return root;
 }
 
+static Control* HitTestDeepestChild(Control* root, POINT contentMouse)
+{
+	if (!root) return NULL;
+	return HitTestDeepestChild(root, root->AbsLocation, contentMouse);
+}
+
 static bool PointInControlRect(Control* c, POINT contentMouse)
 {
 	if (!c) return false;
@@ -111,16 +115,17 @@ Control* Form::HitTestControlAt(POINT contentMouse)
 		}
 	}
 
-	// 4) 普通控件：按绘制顺序倒序命中（后绘制者优先）
-	for (int i = this->Controls.Count - 1; i >= 0; i--)
+	// 4) 普通控件：按绘制顺序倒序命中（后绘制者优先）；候选由空间索引给出，均已包含该点
+	std::vector<Control*> hits;
+	this->ControlsAtPoint(contentMouse, hits);
+	for (auto it = hits.rbegin(); it != hits.rend(); ++it)
 	{
-		auto c = this->Controls[i];
-		if (!c || !c->Visible || !c->Enable) continue;
+		auto c = *it;
+		if (!c->Visible || !c->Enable) continue;
 		if (c == this->ForegroundControl) continue;
 		if (c == this->MainMenu) continue;
 		if (this->MainStatusBar && this->MainStatusBar->TopMost && c == this->MainStatusBar) continue;
-		if (!PointInControlRect(c, contentMouse)) continue;
-		return HitTestDeepestChild(c, contentMouse);
+		return HitTestDeepestChild(c, c->Location, contentMouse);
 	}
 	return NULL;
 }
@@ -367,14 +372,15 @@ static Control* HitTestRootControlAt(Form* f, POINT contentMouse)
 	}
 
 	// 4) 普通控件按绘制顺序倒序命中
-	for (int i = f->Controls.Count - 1; i >= 0; i--)
+	std::vector<Control*> hits;
+	f->ControlsAtPoint(contentMouse, hits);
+	for (auto it = hits.rbegin(); it != hits.rend(); ++it)
 	{
-		auto c = f->Controls[i];
-		if (!c || !c->Visible || !c->Enable) continue;
+		auto c = *it;
+		if (!c->Visible || !c->Enable) continue;
 		if (c == f->ForegroundControl) continue;
 		if (c == f->MainMenu) continue;
 		if (f->MainStatusBar && f->MainStatusBar->TopMost && c == f->MainStatusBar) continue;
-		if (!PointInControlRect(c, contentMouse)) continue;
 		return c;
 	}
 	return NULL;
@@ -624,20 +630,43 @@ void Form::Invalidate(bool immediate)
 {
 	if (!this->Handle) return;
 	this->ControlChanged = true;
+	this->_displayListGeneration++;
+	RECT client{};
+	::GetClientRect(this->Handle, &client);
+	this->AddPendingDirty(client);
 	::InvalidateRect(this->Handle, NULL, FALSE);
-	// When the window is disabled/hidden (e.g. during a modal dialog), forcing
-	// UpdateWindow can create excessive WM_PAINT churn. Let the system schedule paint.
-	if (immediate && ::IsWindowVisible(this->Handle) && ::IsWindowEnabled(this->Handle))
-		::UpdateWindow(this->Handle);
+	// 其他线程（解码线程、MF 回调）只投递，帧节拍与绘制只在 UI 线程上进行
+	if (immediate && this->IsUiThread())
+		this->RequestFrame();
 }
 
 void Form::Invalidate(const RECT& rc, bool immediate)
 {
 	if (!this->Handle) return;
 	this->ControlChanged = true;
+	this->AddPendingDirty(rc);
 	::InvalidateRect(this->Handle, &rc, FALSE);
-	if (immediate && ::IsWindowVisible(this->Handle) && ::IsWindowEnabled(this->Handle))
-		::UpdateWindow(this->Handle);
+	if (immediate && this->IsUiThread())
+		this->RequestFrame();
+}
+
+bool Form::IsUiThread() const
+{
+	return this->Handle && ::GetWindowThreadProcessId(this->Handle, NULL) == ::GetCurrentThreadId();
+}
+
+void Form::AddPendingDirty(const RECT& rc)
+{
+	std::lock_guard<std::mutex> lock(this->_pendingDirtyLock);
+	this->_pendingDirty.Add(DirtyRect(rc.left, rc.top, rc.right, rc.bottom));
+}
+
+DirtyRegion Form::TakePendingDirty()
+{
+	std::lock_guard<std::mutex> lock(this->_pendingDirtyLock);
+	DirtyRegion dirty = this->_pendingDirty;
+	this->_pendingDirty.Clear();
+	return dirty;
 }
 
 void Form::Invalidate(D2D1_RECT_F rc, bool immediate)
@@ -666,6 +695,7 @@ void Form::InvalidateControl(Control* c, int inflatePx, bool immediate)
 {
 	if (!c || !this->Handle) return;
 	if (!c->IsVisual) return;
+	c->InvalidateDisplayList();
 	RECT rc = ToRECT(c->AbsRect, inflatePx);
 	OffsetRect(&rc, 0, ClientTop());
 	Invalidate(rc, immediate);
@@ -686,7 +716,105 @@ void Form::InvalidateAnimatedControls(bool immediate)
 	if (this->ForegroundControl) consider(this->ForegroundControl);
 	if (this->MainMenu) consider((Control*)this->MainMenu);
 	if (immediate)
-		::UpdateWindow(this->Handle);
+		this->RequestFrame();
+}
+
+void Form::RequestFrame()
+{
+	// 窗口禁用/隐藏时（例如模态对话框期间）不主动绘制，交给系统安排 WM_PAINT
+	if (!this->Handle || !::IsWindowVisible(this->Handle) || !::IsWindowEnabled(this->Handle))
+		return;
+	double delay = 0.0;
+	FrameScheduler::Action action = this->_frameScheduler.Request(&delay);
+	HandleFrameAction(action, delay);
+}
+
+void Form::HandleFrameAction(FrameScheduler::Action action, double delayMs)
+{
+	switch (action)
+	{
+	case FrameScheduler::Action::RenderNow:
+		// 直接绘制（不经 WM_PAINT）：先把系统更新区域并入累积区域并验证，避免随后再收到一次 WM_PAINT
+		this->CollectUpdateRegion();
+		::ValidateRect(this->Handle, NULL);
+		this->PaintFrame();
+		break;
+	case FrameScheduler::Action::ArmTimer:
+		// SetTimer 的精度约为 10~16ms：到期稍晚时 OnTimer 会直接绘制，不会再次等待
+		::SetTimer(this->Handle, this->_frameTimerId, (UINT)(std::max)(1.0, std::ceil(delayMs)), NULL);
+		break;
+	default:
+		// Idle：没有待绘帧或已合并；WaitForPaint：区域已失效，WM_PAINT 会在输入处理完后到来
+		break;
+	}
+}
+
+void Form::PaintFrame()
+{
+	if (!this->Render || !::IsWindowEnabled(this->Handle))
+	{
+		this->_frameScheduler.CancelFrame();
+		return;
+	}
+	bool hasVisibleWebBrowser = false;
+	std::function<void(Control*)> checkWebBrowser;
+	checkWebBrowser = [&](Control* c) {
+		if (!c || !c->Visible) return;
+		if (c->Type() == UIClass::UI_WebBrowser) {
+			hasVisibleWebBrowser = true;
+			return;
+		}
+		for (int i = 0; i < c->Count && !hasVisibleWebBrowser; i++)
+			checkWebBrowser(c->operator[](i));
+	};
+
+	for (auto c : this->Controls)
+		if (!hasVisibleWebBrowser)
+			checkWebBrowser(c);
+	if (!hasVisibleWebBrowser && this->MainMenu)
+		checkWebBrowser((Control*)this->MainMenu);
+	if (!hasVisibleWebBrowser && this->ForegroundControl)
+		checkWebBrowser(this->ForegroundControl);
+
+	if (hasVisibleWebBrowser || this->ControlChanged || !this->_hasRenderedOnce)
+	{
+		DirtyRegion dirty = this->TakePendingDirty();
+		this->_frameScheduler.BeginFrame();
+		this->UpdateDirtyRegion(dirty, hasVisibleWebBrowser || !this->_hasRenderedOnce);
+		double delay = 0.0;
+		FrameScheduler::Action next = this->_frameScheduler.EndFrame(&delay);
+		// 绘制期间又有请求：只安排定时器，不在这里递归绘制
+		if (next == FrameScheduler::Action::ArmTimer)
+			HandleFrameAction(next, delay);
+	}
+	else
+	{
+		this->TakePendingDirty();
+		this->_frameScheduler.CancelFrame();
+	}
+}
+
+void Form::UpdateRefreshInterval()
+{
+	// DWM 合成刷新率；取不到时用窗口所在显示器的刷新率，再不行保持 60Hz
+	DWM_TIMING_INFO timing{};
+	timing.cbSize = sizeof(timing);
+	if (SUCCEEDED(::DwmGetCompositionTimingInfo(NULL, &timing)) &&
+		timing.rateRefresh.uiNumerator > 0 && timing.rateRefresh.uiDenominator > 0)
+	{
+		this->_frameScheduler.SetRefreshInterval(1000.0 * timing.rateRefresh.uiDenominator / timing.rateRefresh.uiNumerator);
+		return;
+	}
+	HMONITOR monitor = ::MonitorFromWindow(this->Handle, MONITOR_DEFAULTTONEAREST);
+	MONITORINFOEXW mi{};
+	mi.cbSize = sizeof(mi);
+	DEVMODEW dm{};
+	dm.dmSize = sizeof(dm);
+	if (monitor && ::GetMonitorInfoW(monitor, &mi) &&
+		::EnumDisplaySettingsW(mi.szDevice, ENUM_CURRENT_SETTINGS, &dm) && dm.dmDisplayFrequency > 1)
+	{
+		this->_frameScheduler.SetRefreshInterval(1000.0 / dm.dmDisplayFrequency);
+	}
 }
 GET_CPP(Form, POINT, Location)
 {
@@ -950,6 +1078,7 @@ Form::Form(std::wstring text, POINT _location, SIZE _size)
 	}
 	ResetImageCache();
 	ClearCaptionStates();
+	UpdateRefreshInterval();
 	// 注意：不要在构造阶段仅缩放字体/标题栏，否则会导致“画面变大但窗口/命中区域不一致”。
 	// 初始 DPI 缩放统一放到 Show()/ShowDialog() 之前执行（见 EnsureInitialDpiApplied）。
 }
@@ -1106,9 +1235,12 @@ void Form::ScaleControlTreeForDpi(UINT fromDpi, UINT toDpi)
 			{
 				c->_font->FontSize = Application::ScaleFloat(c->_font->FontSize, fromDpi, toDpi);
 			}
+			c->_measureValid = false;
+			c->Children.InvalidateIndex();
 			for (int i = 0; i < c->Count; i++)
 				scale(c->operator[](i));
 		};
+	this->Controls.InvalidateIndex();
 
 	for (auto c : this->Controls)
 	{
@@ -1459,10 +1591,11 @@ void Form::PerformLayout()
 		// 使用布局引擎
 		if (_needsLayout || _layoutEngine->NeedsLayout())
 		{
+			LayoutStats::Current().EngineLayouts++;
 			SIZE clientSize = this->ClientSize;
-			_layoutEngine->Measure(nullptr, clientSize);
+			_layoutEngine->Measure(nullptr, LayoutSize{ clientSize.cx, clientSize.cy });
 			
-			D2D1_RECT_F finalRect = { 
+			LayoutRect finalRect = { 
 				0, 0, 
 				(float)clientSize.cx, 
 				(float)clientSize.cy 
@@ -1592,39 +1725,196 @@ bool Form::Update(bool force)
 
 	if (!force && !ControlChanged) return false;
 
-	RECT dirty{};
-	if (!GetUpdateRect(this->Handle, &dirty, FALSE))
+	CollectUpdateRegion();
+	DirtyRegion dirty = this->TakePendingDirty();
+	if (dirty.IsEmpty() && !force)
 		return false;
-	return UpdateDirtyRect(dirty, force);
+	::ValidateRect(this->Handle, NULL);
+	this->_frameScheduler.BeginFrame();
+	bool result = UpdateDirtyRegion(dirty, force);
+	double delay = 0.0;
+	FrameScheduler::Action next = this->_frameScheduler.EndFrame(&delay);
+	if (next == FrameScheduler::Action::ArmTimer)
+		HandleFrameAction(next, delay);
+	return result;
+}
+
+void Form::CollectUpdateRegion()
+{
+	// 系统更新区域（遮挡恢复、InvalidateRect 等）按矩形并入累积区域；需在 BeginPaint 之前调用。
+	// 后台线程（日志追加、异步加载）只投递 InvalidateRect，区域非空即视为有变更
+	HRGN rgn = ::CreateRectRgn(0, 0, 0, 0);
+	if (!rgn) return;
+	int kind = ::GetUpdateRgn(this->Handle, rgn, FALSE);
+	if (kind == SIMPLEREGION || kind == COMPLEXREGION)
+	{
+		DWORD bytes = ::GetRegionData(rgn, 0, NULL);
+		if (bytes > 0)
+		{
+			std::vector<BYTE> buffer(bytes);
+			RGNDATA* data = (RGNDATA*)buffer.data();
+			if (::GetRegionData(rgn, bytes, data) == bytes)
+			{
+				const RECT* rects = (const RECT*)data->Buffer;
+				for (DWORD i = 0; i < data->rdh.nCount; i++)
+					this->AddPendingDirty(rects[i]);
+				if (data->rdh.nCount > 0)
+					this->ControlChanged = true;
+			}
+		}
+	}
+	::DeleteObject(rgn);
 }
 
 bool Form::UpdateDirtyRect(const RECT& dirty, bool force)
 {
-	if (!IsWindow(this->Handle) || !this->Render) return false;
+	DirtyRegion region;
+	region.Add(DirtyRect(dirty.left, dirty.top, dirty.right, dirty.bottom));
+	return UpdateDirtyRegion(region, force);
+}
 
-	if (dirty.right <= dirty.left || dirty.bottom <= dirty.top)
-		return false;
+bool Form::UpdateDirtyRegion(const DirtyRegion& dirty, bool force)
+{
+	if (!IsWindow(this->Handle) || !this->Render) return false;
 
 	RECT clientRc{};
 	::GetClientRect(this->Handle, &clientRc);
+	const DirtyRect clientBounds(clientRc.left, clientRc.top, clientRc.right, clientRc.bottom);
+
+	DirtyRegion frame = dirty;
+	frame.ClipTo(clientBounds);
+	if (frame.IsEmpty() && !force)
+		return false;
 
 	// 在渲染前执行一次布局：否则直接挂在 Form 上的控件不会应用 Margin/Anchor 等布局属性
 	if (_needsLayout || (_layoutEngine && _layoutEngine->NeedsLayout()))
 	{
 		PerformLayout();
 	}
-	RECT drawRc = dirty;
+
+	// 后台缓冲区保存的是 age 帧之前的画面：除本帧脏区域外，还要补画其间 age-1 帧的脏区域
+	const UINT age = this->Render->GetBackBufferAge();
+	const bool full = force || !this->_hasRenderedOnce || age == 0 || this->_dirtyHistory.size() + 1 < age;
+	DirtyRegion paint(frame.MaxRects(), frame.MergeSlack());
+	if (full)
+	{
+		paint.Add(clientBounds);
+	}
+	else
+	{
+		paint.Add(frame);
+		for (UINT k = 1; k < age; k++)
+			paint.Add(this->_dirtyHistory[this->_dirtyHistory.size() - k]);
+		paint.ClipTo(clientBounds);
+	}
+	// OnPaint 每帧只调用一次，只能裁剪到一个矩形：有订阅者时把多个脏矩形合并为外接矩形，
+	// 否则外接矩形内、脏矩形外保留的旧内容上会再叠画一次
+	if (this->OnPaint.Count() > 0 && paint.Count() > 1)
+	{
+		const DirtyRect bounds = paint.Bounds();
+		paint.Clear();
+		paint.Add(bounds);
+	}
+
+	// 历史记录的是内容变化；首次/强制绘制视为整窗变化
 	if (force || !this->_hasRenderedOnce)
 	{
-		drawRc = clientRc;
+		DirtyRegion all;
+		all.Add(clientBounds);
+		this->_dirtyHistory.push_back(all);
+	}
+	else
+	{
+		this->_dirtyHistory.push_back(frame);
 	}
+	const size_t maxHistory = 4;
+	if (this->_dirtyHistory.size() > maxHistory)
+		this->_dirtyHistory.erase(this->_dirtyHistory.begin(), this->_dirtyHistory.end() - maxHistory);
+
+	this->_lastPaintStats.Rects = paint.Count();
+	this->_lastPaintStats.PaintedPixels = paint.PaintedPixels();
+	this->_lastPaintStats.BoundsPixels = paint.Bounds().Area();
+	this->_lastPaintStats.BufferAge = age;
+	this->_lastPaintStats.Full = full;
 
 	this->Render->BeginRender();
+	this->Render->ClearTransform();
+	for (auto& r : paint.Rects())
+	{
+		RECT drawRc{ r.Left, r.Top, r.Right, r.Bottom };
+		RenderDirtyRect(drawRc, clientRc);
+	}
+	const DirtyRect paintBounds = paint.Bounds();
+	this->RaisePaint(RECT{ paintBounds.Left, paintBounds.Top, paintBounds.Right, paintBounds.Bottom });
+	this->Render->EndRender();
+	RecoverRenderIfNeeded();
+
+	this->CommitComposition();
+
+	if (this->OverlayRender)
+	{
+		auto* oldRender = this->Render;
+		RECT fullClient{};
+		::GetClientRect(this->Handle, &fullClient);
+		RECT overlayRc = fullClient;
+
+		this->OverlayRender->BeginRender();
+		this->OverlayRender->ClearTransform();
+		this->OverlayRender->Clear(D2D1_COLOR_F{ 0.0f,0.0f,0.0f,0.0f });
+		this->OverlayRender->PushDrawRect((float)overlayRc.left, (float)overlayRc.top, (float)(overlayRc.right - overlayRc.left), (float)(overlayRc.bottom - overlayRc.top));
+
+		RECT overlayContent = fullClient;
+		const int top = ClientTop();
+		overlayContent.top -= top;
+		overlayContent.bottom -= top;
+		if (overlayContent.top < 0) overlayContent.top = 0;
+		if (overlayContent.left < 0) overlayContent.left = 0;
+		if (overlayContent.right > this->Size.cx) overlayContent.right = this->Size.cx;
+		if (overlayContent.bottom > (this->Size.cy - top)) overlayContent.bottom = (this->Size.cy - top);
+
+		if (overlayContent.right > overlayContent.left && overlayContent.bottom > overlayContent.top)
+		{
+			this->OverlayRender->SetTransform(D2D1::Matrix3x2F::Translation(0.0f, (float)top));
+			this->OverlayRender->PushDrawRect((float)overlayContent.left, (float)overlayContent.top, (float)(overlayContent.right - overlayContent.left), (float)(overlayContent.bottom - overlayContent.top));
+
+			this->Render = this->OverlayRender;
+			if (this->MainStatusBar && this->MainStatusBar->TopMost && this->MainStatusBar->Visible)
+			{
+				this->MainStatusBar->Update();
+			}
+			if (this->MainMenu && this->MainMenu->Visible)
+			{
+				this->MainMenu->Update();
+			}
+			if (this->ForegroundControl && this->ForegroundControl->Visible && this->ForegroundControl != (Control*)this->MainMenu)
+			{
+				this->ForegroundControl->Update();
+			}
+			this->Render = oldRender;
+
+			this->OverlayRender->PopDrawRect();
+			this->OverlayRender->ClearTransform();
+		}
+
+		this->OverlayRender->PopDrawRect();
+		this->OverlayRender->EndRender();
+		RecoverRenderIfNeeded();
+
+		this->CommitComposition();
+	}
+
+	this->ControlChanged = false;
+	this->_hasRenderedOnce = true;
+	return true;
+}
+
+void Form::RenderDirtyRect(const RECT& drawRc, const RECT& clientRc)
+{
 	this->Render->ClearTransform();
 	this->Render->PushDrawRect((float)drawRc.left, (float)drawRc.top, (float)(drawRc.right - drawRc.left), (float)(drawRc.bottom - drawRc.top));
 	this->Render->FillRect((float)drawRc.left, (float)drawRc.top, (float)(drawRc.right - drawRc.left), (float)(drawRc.bottom - drawRc.top), this->BackColor);
-	this->Render->DrawRect((float)drawRc.left, (float)drawRc.top, (float)(drawRc.right - drawRc.left), (float)(drawRc.bottom - drawRc.top), Colors::White, 2.0f);
-	this->Render->DrawRect((float)drawRc.left, (float)drawRc.top, (float)(drawRc.right - drawRc.left), (float)(drawRc.bottom - drawRc.top), Colors::Black, 1.0f);
+	this->Render->DrawRect((float)clientRc.left, (float)clientRc.top, (float)(clientRc.right - clientRc.left), (float)(clientRc.bottom - clientRc.top), Colors::White, 2.0f);
+	this->Render->DrawRect((float)clientRc.left, (float)clientRc.top, (float)(clientRc.right - clientRc.left), (float)(clientRc.bottom - clientRc.top), Colors::Black, 1.0f);
 
 	if (this->Image)
 	{
@@ -1750,9 +2040,12 @@ bool Form::UpdateDirtyRect(const RECT& dirty, bool force)
 		this->Render->SetTransform(D2D1::Matrix3x2F::Translation(0.0f, (float)top));
 		this->Render->PushDrawRect((float)contentDirty.left, (float)contentDirty.top, (float)(contentDirty.right - contentDirty.left), (float)(contentDirty.bottom - contentDirty.top));
 
-		for (int i = 0; i < this->Controls.Count; i++)
+		// 只遍历与脏矩形相交的顶层控件（空间索引按绘制顺序返回）
+		std::vector<Control*> dirtyControls;
+		this->Controls.QueryRect(SpatialRect{ contentDirty.left, contentDirty.top, contentDirty.right, contentDirty.bottom }, 2, dirtyControls);
+		for (auto c : dirtyControls)
 		{
-			auto c = this->Controls[i]; if (!c->Visible)continue;
+			if (!c->Visible)continue;
 			// 主菜单/置顶控件在有 Overlay 时由 Overlay 层单独绘制，避免重复
 			if (this->OverlayRender)
 			{
@@ -1763,15 +2056,22 @@ bool Form::UpdateDirtyRect(const RECT& dirty, bool force)
 			// 状态栏（TopMost=true）单独绘制，避免被普通控件覆盖
 			if (this->MainStatusBar && this->MainStatusBar->TopMost && c == this->MainStatusBar)
 				continue;
-			RECT crc = ToRECT(c->AbsRect, 2);
-			if (!RectIntersects(contentDirty, crc)) continue;
 			if (c->ParentForm->Render == NULL)
 				c->ParentForm->Render = this->Render;
-			c->Update();
+			c->Draw();
 		}
 
+		// 置顶层只在与当前矩形相交时绘制（下拉展开时 ActualSize 已包含弹出部分）
+		auto touchesDirty = [&](Control* c)
+			{
+				POINT loc = c->Location;
+				SIZE sz = c->ActualSize();
+				RECT bounds{ loc.x - 2, loc.y - 2, loc.x + sz.cx + 2, loc.y + sz.cy + 2 };
+				return RectIntersects(bounds, contentDirty);
+			};
+
 		// 状态栏：在普通控件之后绘制（TopMost=true）
-		if (this->MainStatusBar && this->MainStatusBar->TopMost && this->MainStatusBar->Visible)
+		if (this->MainStatusBar && this->MainStatusBar->TopMost && this->MainStatusBar->Visible && touchesDirty(this->MainStatusBar))
 		{
 			this->MainStatusBar->Update();
 		}
@@ -1779,13 +2079,14 @@ bool Form::UpdateDirtyRect(const RECT& dirty, bool force)
 		// 如果主菜单展开/前景控件可见，它们应覆盖在状态栏之上
 		if (!this->OverlayRender)
 		{
-			if (this->MainMenu && this->MainMenu->Visible)
+			if (this->MainMenu && this->MainMenu->Visible && touchesDirty(this->MainMenu))
 			{
 				auto ms = this->MainMenu->ActualSize();
 				if (ms.cy > this->MainMenu->BarHeight)
 					this->MainMenu->Update();
 			}
-			if (this->ForegroundControl && this->ForegroundControl->Visible && this->ForegroundControl != (Control*)this->MainMenu)
+			if (this->ForegroundControl && this->ForegroundControl->Visible && this->ForegroundControl != (Control*)this->MainMenu
+				&& touchesDirty(this->ForegroundControl))
 			{
 				this->ForegroundControl->Update();
 			}
@@ -1794,69 +2095,26 @@ bool Form::UpdateDirtyRect(const RECT& dirty, bool force)
 		this->Render->ClearTransform();
 	}
 
+	this->Render->PopDrawRect();
+}
+void Form::RaisePaint(const RECT& clipRc)
+{
+	this->Render->ClearTransform();
+	this->Render->PushDrawRect((float)clipRc.left, (float)clipRc.top, (float)(clipRc.right - clipRc.left), (float)(clipRc.bottom - clipRc.top));
 	this->OnPaint(this);
-
 	this->Render->PopDrawRect();
-	this->Render->EndRender();
-	RecoverRenderIfNeeded();
-
-	this->CommitComposition();
-
-	if (this->OverlayRender)
-	{
-		auto* oldRender = this->Render;
-		RECT fullClient{};
-		::GetClientRect(this->Handle, &fullClient);
-		RECT overlayRc = fullClient;
-
-		this->OverlayRender->BeginRender();
-		this->OverlayRender->ClearTransform();
-		this->OverlayRender->Clear(D2D1_COLOR_F{ 0.0f,0.0f,0.0f,0.0f });
-		this->OverlayRender->PushDrawRect((float)overlayRc.left, (float)overlayRc.top, (float)(overlayRc.right - overlayRc.left), (float)(overlayRc.bottom - overlayRc.top));
-
-		RECT overlayContent = fullClient;
-		const int top = ClientTop();
-		overlayContent.top -= top;
-		overlayContent.bottom -= top;
-		if (overlayContent.top < 0) overlayContent.top = 0;
-		if (overlayContent.left < 0) overlayContent.left = 0;
-		if (overlayContent.right > this->Size.cx) overlayContent.right = this->Size.cx;
-		if (overlayContent.bottom > (this->Size.cy - top)) overlayContent.bottom = (this->Size.cy - top);
-
-		if (overlayContent.right > overlayContent.left && overlayContent.bottom > overlayContent.top)
-		{
-			this->OverlayRender->SetTransform(D2D1::Matrix3x2F::Translation(0.0f, (float)top));
-			this->OverlayRender->PushDrawRect((float)overlayContent.left, (float)overlayContent.top, (float)(overlayContent.right - overlayContent.left), (float)(overlayContent.bottom - overlayContent.top));
-
-			this->Render = this->OverlayRender;
-			if (this->MainStatusBar && this->MainStatusBar->TopMost && this->MainStatusBar->Visible)
-			{
-				this->MainStatusBar->Update();
-			}
-			if (this->MainMenu && this->MainMenu->Visible)
-			{
-				this->MainMenu->Update();
-			}
-			if (this->ForegroundControl && this->ForegroundControl->Visible && this->ForegroundControl != (Control*)this->MainMenu)
-			{
-				this->ForegroundControl->Update();
-			}
-			this->Render = oldRender;
-
-			this->OverlayRender->PopDrawRect();
-			this->OverlayRender->ClearTransform();
-		}
-
-		this->OverlayRender->PopDrawRect();
-		this->OverlayRender->EndRender();
-		RecoverRenderIfNeeded();
-
-		this->CommitComposition();
-	}
-
-	this->ControlChanged = false;
-	this->_hasRenderedOnce = true;
-	return true;
+}
+void Form::RecordFrame(DisplayList& out)
+{
+	RecordingGraphics recorder;
+	auto* render = this->Render;
+	// 控件经 ParentForm->Render 绘制：录制期间整体换成录制目标
+	this->Render = &recorder;
+	const RECT client{ 0, 0, this->Size.cx, this->Size.cy };
+	this->RenderDirtyRect(client, client);
+	this->RaisePaint(client);
+	this->Render = render;
+	out = recorder.List();
 }
 bool Form::ForceUpdate()
 {
@@ -1864,6 +2122,10 @@ bool Form::ForceUpdate()
 	return true;
 }
 
+void Form::ControlsAtPoint(POINT contentMouse, std::vector<Control*>& out)
+{
+	this->Controls.QueryPoint(SpatialPoint{ contentMouse.x, contentMouse.y }, out);
+}
 bool Form::RemoveControl(Control* c)
 {
 	if (this->Controls.Contains(c))
@@ -2410,6 +2672,7 @@ LRESULT CALLBACK Form::WINMSG_PROCESS(HWND hWnd, UINT message, WPARAM wParam, LP
 			}
 			// 尺寸/DPI 变化后，强制同步渲染目标尺寸并安排一次重绘，避免出现新区域未刷新。
 			form->SyncRenderSizeToClient();
+			form->UpdateRefreshInterval();
 			form->_hasRenderedOnce = false;
 			form->Invalidate(form->_dcompHost != nullptr);
 			// 若窗口尚未首次显示，控件树可能还未构造完成：此时只记录 DPI，真正缩放留到 Show 前。
@@ -2439,38 +2702,26 @@ LRESULT CALLBACK Form::WINMSG_PROCESS(HWND hWnd, UINT message, WPARAM wParam, LP
 			return 1;
 		case WM_PAINT:
 		{
+			// BeginPaint 会清空更新区域，先把系统给出的脏矩形并入累积区域
+			form->CollectUpdateRegion();
 			PAINTSTRUCT ps{};
 			BeginPaint(hWnd, &ps);
-			if (form->Render)
+			if (form->Render && ::IsWindowEnabled(hWnd))
 			{
-				if (!::IsWindowEnabled(hWnd))
+				if (!form->_hasRenderedOnce)
 				{
-					EndPaint(hWnd, &ps);
-					return 0;
+					form->PaintFrame();
+				}
+				else
+				{
+					// 本刷新周期已绘制过时推迟：脏区域留在 _pendingDirty，由帧定时器在下一周期补画
+					double delay = 0.0;
+					FrameScheduler::Action action = form->_frameScheduler.OnPaint(&delay);
+					if (action == FrameScheduler::Action::RenderNow)
+						form->PaintFrame();
+					else
+						form->HandleFrameAction(action, delay);
 				}
-
-				bool hasVisibleWebBrowser = false;
-				std::function<void(Control*)> checkWebBrowser;
-				checkWebBrowser = [&](Control* c) {
-					if (!c || !c->Visible) return;
-					if (c->Type() == UIClass::UI_WebBrowser) {
-						hasVisibleWebBrowser = true;
-						return;
-					}
-					for (int i = 0; i < c->Count && !hasVisibleWebBrowser; i++)
-						checkWebBrowser(c->operator[](i));
-				};
-				
-				for (auto c : form->Controls)
-					if (!hasVisibleWebBrowser)
-						checkWebBrowser(c);
-				if (!hasVisibleWebBrowser && form->MainMenu)
-					checkWebBrowser((Control*)form->MainMenu);
-				if (!hasVisibleWebBrowser && form->ForegroundControl)
-					checkWebBrowser(form->ForegroundControl);
-				
-				if (hasVisibleWebBrowser || form->ControlChanged || !form->_hasRenderedOnce)
-					form->UpdateDirtyRect(ps.rcPaint, true);
 			}
 			EndPaint(hWnd, &ps);
 			return 0;
@@ -2482,8 +2733,19 @@ LRESULT CALLBACK Form::WINMSG_PROCESS(HWND hWnd, UINT message, WPARAM wParam, LP
 				form->InvalidateAnimatedControls(true);
 				return 0;
 			}
+			if (wParam == form->_frameTimerId)
+			{
+				::KillTimer(hWnd, form->_frameTimerId);
+				double delay = 0.0;
+				FrameScheduler::Action action = form->_frameScheduler.OnTimer(&delay);
+				form->HandleFrameAction(action, delay);
+				return 0;
+			}
 		}
 		break;
+		case WM_DISPLAYCHANGE:
+			form->UpdateRefreshInterval();
+			break;
 		case WM_ACTIVATE:
 		{
 			constexpr MARGINS margins{ 1, 1, 1, 1 };
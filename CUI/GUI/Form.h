@@ -1,5 +1,7 @@
 #pragma once
 #include "Control.h"
+#include "DirtyRegion.h"
+#include "FrameScheduler.h"
 #include "Application.h"
 #include "Button.h"
 #include "CheckBox.h"
@@ -27,6 +29,8 @@
 #include "NotifyIcon.h"
 #include "WebBrowser.h"
 #include "MediaPlayer.h"
+#include <atomic>
+#include <mutex>
 
 #if defined(_MSC_VER)
 #pragma comment(lib, "Dwmapi.lib")
@@ -69,6 +73,7 @@ class Form
 {
 private:
 	friend class FormDropTarget;
+	friend class Control;
 	POINT _Location_INIT;
 	SIZE _Size_INTI;
 	std::wstring _text;
@@ -104,6 +109,7 @@ private:
 	bool _showInTaskBar = true;
 	UINT_PTR _animTimerId = 0xC001;
 	UINT _animIntervalMs = 0;
+	UINT_PTR _frameTimerId = 0xC002;
 	bool _hasRenderedOnce = false;
 	void InvalidateControl(class Control* c, int inflatePx = 2, bool immediate = false);
 	void InvalidateAnimatedControls(bool immediate = false);
@@ -147,6 +153,24 @@ private:
 	void CleanupResources();
 	ID2D1Bitmap* EnsureImageCache();
 	void ResetImageCache();
+	// 自上次绘制以来累积的脏区域（客户区坐标），Invalidate 与 WM_PAINT 的系统更新区域写入。
+	// 解码线程等也会调用 Invalidate，读写都经 _pendingDirtyLock
+	DirtyRegion _pendingDirty;
+	std::mutex _pendingDirtyLock;
+	void AddPendingDirty(const RECT& rc);
+	DirtyRegion TakePendingDirty();
+	// 最近几帧的内容脏区域（最新在后），后台缓冲区保留旧帧时用于补画
+	std::vector<DirtyRegion> _dirtyHistory;
+	void CollectUpdateRegion();
+	void RenderDirtyRect(const RECT& drawRc, const RECT& clientRc);
+	// 在 clipRc（本帧重绘区域）的裁剪下触发一次 OnPaint
+	void RaisePaint(const RECT& clipRc);
+	// 帧节拍：立即失效、动画节拍与 WM_PAINT 合并为每个刷新周期至多一帧
+	FrameScheduler _frameScheduler;
+	void RequestFrame();
+	void HandleFrameAction(FrameScheduler::Action action, double delayMs);
+	void PaintFrame();
+	void UpdateRefreshInterval();
 
 public:
 	/** @brief 鼠标滚轮事件（窗口级）。 */
@@ -165,7 +189,11 @@ public:
 	FormKeyUpEvent OnKeyUp = FormKeyUpEvent();
 	/** @brief 键盘按下事件（窗口级）。 */
 	FormKeyDownEvent OnKeyDown = FormKeyDownEvent();
-	/** @brief 绘制事件（窗口级）。 */
+	/**
+	 * @brief 绘制事件（窗口级）。
+	 *
+	 * 每帧调用一次，裁剪到本帧的重绘区域；有订阅者时多矩形脏区域合并为外接矩形绘制。
+	 */
 	FormPaintEvent OnPaint = FormPaintEvent();
 	CloseEvent OnClose = CloseEvent();
 	FormMovedEvent OnMoved = FormMovedEvent();
@@ -194,12 +222,13 @@ public:
 	bool CloseBox = true;
 	bool VisibleHead = true;
 	bool CenterTitle = true;
-	bool ControlChanged = false;
+	/** @brief 有待绘制的变更（任意线程的 Invalidate 置位，绘制后清除）。 */
+	std::atomic<bool> ControlChanged{ false };
 	/** @brief 当前具有键盘焦点的控件。 */
 	class Control* Selected = NULL;
 	class Control* UnderMouse = NULL;
 	/** @brief 顶层控件集合（通常包含布局容器与各控件）。 */
-	List<class Control*> Controls = List<class Control*>();
+	ControlCollection Controls;
 	// 置顶控件：最多只允许一个（用于 ComboBox 下拉、临时浮层等）
 	class Control* ForegroundControl = NULL;
 	// 主菜单：单独管理（菜单栏/下拉菜单）
@@ -324,13 +353,64 @@ public:
 	 * @return true 表示成功移除。
 	 */
 	bool RemoveControl(Control* c);
+	/**
+	 * @brief 查询包含点的顶层控件（内容区坐标），按绘制顺序输出。
+	 *
+	 * 顶层控件较多时走空间索引；结果不过滤 Visible/Enable。
+	 */
+	void ControlsAtPoint(POINT contentMouse, std::vector<class Control*>& out);
 	virtual bool ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int xof, int yof);
 	virtual bool Update(bool force = false);
 	virtual bool UpdateDirtyRect(const RECT& dirty, bool force = false);
+	/**
+	 * @brief 按脏区域重绘：每个矩形单独裁剪绘制，而不是重绘外接矩形。
+	 *
+	 * 后台缓冲区保留 N 帧前内容（FLIP_SEQUENTIAL）时，同时补画之前 N-1 帧的脏区域；
+	 * 缓冲区内容未定义、首次绘制或 force=true 时整窗重绘。
+	 */
+	virtual bool UpdateDirtyRegion(const DirtyRegion& dirty, bool force = false);
+	/** @brief 最近一帧的重绘统计（UpdateDirtyRegion 写入）。 */
+	struct PaintStats
+	{
+		int Rects = 0;
+		long long PaintedPixels = 0;
+		long long BoundsPixels = 0;
+		UINT BufferAge = 0;
+		bool Full = false;
+	};
+	const PaintStats& LastPaintStats() const { return _lastPaintStats; }
+	/** @brief 显示列表代数：整窗失效时递增，控件缓存的显示列表随之失效。 */
+	UINT64 DisplayListGeneration() const { return _displayListGeneration.load(std::memory_order_relaxed); }
+	/**
+	 * @brief 把整个窗口录制为显示列表：临时换用 RecordingGraphics 绘制一帧，不经过设备，也不 Present。
+	 *
+	 * 结果交给 SoftwareRasterizer 即可得到像素，用于截图与逐像素比较。位图、文本布局等设备资源
+	 * 在录制目标上无法创建，光栅化时计为跳过；窗口本身仍需创建（控件依赖 Win32 与 DirectWrite）。
+	 */
+	void RecordFrame(DisplayList& out);
+	/** @brief 帧节拍统计（绘制耗时、请求合并、输入到绘制的延迟，单位毫秒）。 */
+	FrameScheduler::Stats FrameStats() const { return _frameScheduler.GetStats(); }
+	void ResetFrameStats() { _frameScheduler.ResetStats(); }
+	/** @brief 显示器刷新周期（毫秒）。 */
+	double RefreshInterval() const { return _frameScheduler.RefreshInterval(); }
+	/**
+	 * @brief 低延迟模式：立即失效在本刷新周期尚未绘制时同步绘制，而不是等待 WM_PAINT。
+	 *
+	 * 默认关闭；无论是否开启，每个刷新周期至多绘制一帧。
+	 */
+	void SetLowLatencyRendering(bool value) { _frameScheduler.SetLowLatency(value); }
+	bool LowLatencyRendering() const { return _frameScheduler.LowLatency(); }
+private:
+	PaintStats _lastPaintStats;
+	std::atomic<UINT64> _displayListGeneration{ 0 };
+public:
 	virtual bool ForceUpdate();
 	/**
 	 * @brief 使整个窗口区域失效（触发重绘）。
-	 * @param immediate true 表示尽快立即刷新。
+	 * @param immediate true 表示尽快刷新：请求一帧，由帧节拍在本刷新周期内（或下一周期）绘制。
+	 *
+	 * 可在任意线程调用：非 UI 线程只记录脏区域并 InvalidateRect（投递），不请求帧、不绘制，
+	 * 由 UI 线程的 WM_PAINT 安排绘制。
 	 */
 	void Invalidate(bool immediate = false);
 	/**
@@ -339,6 +419,8 @@ public:
 	 */
 	void Invalidate(const RECT& rc, bool immediate = false);
 	void Invalidate(D2D1_RECT_F rc, bool immediate = false);
+	/** @brief 当前线程是否为窗口所属的 UI 线程。 */
+	bool IsUiThread() const;
 	virtual void RenderImage();
 	D2D1_RECT_F ChildRect();
 	Control* LastChild();
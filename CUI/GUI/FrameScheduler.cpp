@@ -0,0 +1,176 @@
+#include "FrameScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+const size_t FrameScheduler::HistorySize;
+
+FrameScheduler::FrameScheduler(Clock clock, double refreshInterval)
+	: _clock(std::move(clock)), _interval(refreshInterval > 0.0 ? refreshInterval : 1000.0 / 60.0)
+{
+	if (!_clock)
+	{
+		_clock = []()
+			{
+				using namespace std::chrono;
+				return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+			};
+	}
+	_frameTimes.reserve(HistorySize);
+}
+
+void FrameScheduler::SetRefreshInterval(double ms)
+{
+	if (ms > 0.0) _interval = ms;
+}
+
+double FrameScheduler::Wait(double now) const
+{
+	if (!_hasFrame) return 0.0;
+	// 定时器可能略早触发：差距在容差内视为已到期，避免再等一整个定时器粒度
+	const double slack = (std::min)(1.0, _interval * 0.1);
+	const double wait = _lastBegin + _interval - now;
+	return wait <= slack ? 0.0 : wait;
+}
+
+double FrameScheduler::TimeUntilNextFrame() const
+{
+	return Wait(_clock());
+}
+
+void FrameScheduler::MarkPending(double now)
+{
+	_requests++;
+	if (_pending)
+	{
+		_coalesced++;
+		return;
+	}
+	_pending = true;
+	_requestTime = now;
+}
+
+FrameScheduler::Action FrameScheduler::Defer(double wait, double* delay)
+{
+	if (_timerArmed) return Action::Idle;
+	_timerArmed = true;
+	if (delay) *delay = wait;
+	return Action::ArmTimer;
+}
+
+FrameScheduler::Action FrameScheduler::Request(double* delay)
+{
+	const double now = _clock();
+	MarkPending(now);
+	// 已安排帧定时器或正在绘制：本次请求由那一帧（或它之后的下一帧）带上
+	if (_timerArmed || _inFrame) return Action::Idle;
+	const double wait = Wait(now);
+	if (wait > 0.0) return Defer(wait, delay);
+	return _lowLatency ? Action::RenderNow : Action::WaitForPaint;
+}
+
+FrameScheduler::Action FrameScheduler::OnPaint(double* delay)
+{
+	const double now = _clock();
+	const double wait = Wait(now);
+	if (wait <= 0.0) return Action::RenderNow;
+	MarkPending(now);
+	_deferred++;
+	return Defer(wait, delay);
+}
+
+FrameScheduler::Action FrameScheduler::OnTimer(double* delay)
+{
+	_timerArmed = false;
+	if (!_pending) return Action::Idle;
+	const double wait = Wait(_clock());
+	if (wait > 0.0) return Defer(wait, delay);
+	return Action::RenderNow;
+}
+
+void FrameScheduler::BeginFrame()
+{
+	const double now = _clock();
+	if (_pending)
+	{
+		const double latency = (std::max)(0.0, now - _requestTime);
+		_latencySum += latency;
+		_latencyCount++;
+		_maxLatency = (std::max)(_maxLatency, latency);
+		// 只统计连续需求下的帧间隔（请求在上一帧所在周期内到达），空闲间隙不计入
+		if (_hasFrame && _requestTime - _lastBegin < _interval)
+		{
+			_intervalSum += now - _lastBegin;
+			_intervalCount++;
+		}
+	}
+	_pending = false;
+	_inFrame = true;
+	_hasFrame = true;
+	_lastBegin = now;
+}
+
+FrameScheduler::Action FrameScheduler::EndFrame(double* delay)
+{
+	if (!_inFrame) return Action::Idle;
+	_inFrame = false;
+	const double now = _clock();
+	const double t = (std::max)(0.0, now - _lastBegin);
+	_frames++;
+	_lastFrameTime = t;
+	_maxFrameTime = (std::max)(_maxFrameTime, t);
+	if (_frameTimes.size() < HistorySize)
+		_frameTimes.push_back(t);
+	else
+		_frameTimes[_frameTimeNext] = t;
+	_frameTimeNext = (_frameTimeNext + 1) % HistorySize;
+	// 绘制期间到达的请求：安排到下一周期
+	if (!_pending) return Action::Idle;
+	const double wait = Wait(now);
+	if (wait > 0.0) return Defer(wait, delay);
+	return Action::RenderNow;
+}
+
+FrameScheduler::Stats FrameScheduler::GetStats() const
+{
+	Stats s;
+	s.Requests = _requests;
+	s.Coalesced = _coalesced;
+	s.Deferred = _deferred;
+	s.Frames = _frames;
+	s.RefreshInterval = _interval;
+	s.LastFrameTime = _lastFrameTime;
+	s.MaxFrameTime = _maxFrameTime;
+	if (!_frameTimes.empty())
+	{
+		double sum = 0.0;
+		for (double t : _frameTimes) sum += t;
+		s.AverageFrameTime = sum / (double)_frameTimes.size();
+		std::vector<double> sorted = _frameTimes;
+		size_t k = (sorted.size() * 95 + 99) / 100;
+		k = k ? k - 1 : 0;
+		std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+		s.P95FrameTime = sorted[k];
+	}
+	if (_intervalCount) s.AverageInterval = _intervalSum / (double)_intervalCount;
+	if (_latencyCount) s.AverageLatency = _latencySum / (double)_latencyCount;
+	s.MaxLatency = _maxLatency;
+	return s;
+}
+
+void FrameScheduler::ResetStats()
+{
+	_requests = 0;
+	_coalesced = 0;
+	_deferred = 0;
+	_frames = 0;
+	_frameTimes.clear();
+	_frameTimeNext = 0;
+	_lastFrameTime = 0.0;
+	_maxFrameTime = 0.0;
+	_intervalSum = 0.0;
+	_intervalCount = 0;
+	_latencySum = 0.0;
+	_latencyCount = 0;
+	_maxLatency = 0.0;
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/**
+ * @file FrameScheduler.h
+ * @brief FrameScheduler：把失效请求与动画节拍合并成“每个刷新周期至多一帧”。
+ *
+ * 不依赖 Win32/D2D，时钟可注入（测试时用假时钟）。Form 只负责执行它给出的动作：
+ * - Request：Invalidate(immediate) / 动画节拍请求一帧
+ * - OnPaint：系统绘制消息到达，本周期已绘制过时推迟到下一周期
+ * - OnTimer：帧定时器到期
+ *
+ * 默认（节拍）模式下，立即失效不再同步绘制，而是等消息队列清空后的 WM_PAINT：
+ * 快速拖动产生的大量鼠标消息只合并成一帧。低延迟模式下，若本周期尚未绘制，
+ * 请求会立即同步绘制（输入到画面的延迟最短），但同样不超过每周期一帧。
+ *
+ * 所有时间单位为毫秒。
+ */
+class FrameScheduler
+{
+public:
+	/** @brief 返回当前时间（毫秒，单调递增）。 */
+	typedef std::function<double()> Clock;
+
+	/** @brief 调用方应执行的动作。 */
+	enum class Action
+	{
+		/** @brief 无需动作（没有待绘帧，或已合并进已安排的帧）。 */
+		Idle,
+		/** @brief 立即绘制。 */
+		RenderNow,
+		/** @brief 等待系统绘制消息（区域已失效，WM_PAINT 会在输入处理完后到来）。 */
+		WaitForPaint,
+		/** @brief 启动帧定时器，延迟见输出参数。 */
+		ArmTimer,
+	};
+
+	struct Stats
+	{
+		/** @brief 帧请求次数（Request + 被推迟的 OnPaint）。 */
+		size_t Requests = 0;
+		/** @brief 合并进已有待绘帧的请求。 */
+		size_t Coalesced = 0;
+		/** @brief 因本周期已绘制而推迟的系统绘制。 */
+		size_t Deferred = 0;
+		size_t Frames = 0;
+		double RefreshInterval = 0.0;
+		/** @brief 绘制耗时（BeginFrame 到 EndFrame），统计最近 HistorySize 帧。 */
+		double LastFrameTime = 0.0;
+		double AverageFrameTime = 0.0;
+		double P95FrameTime = 0.0;
+		double MaxFrameTime = 0.0;
+		/** @brief 相邻两帧开始时间的平均间隔。 */
+		double AverageInterval = 0.0;
+		/** @brief 从首个请求到开始绘制的延迟。 */
+		double AverageLatency = 0.0;
+		double MaxLatency = 0.0;
+	};
+
+	static const size_t HistorySize = 240;
+
+	/**
+	 * @param clock 为空时使用 std::chrono::steady_clock。
+	 * @param refreshInterval 刷新周期（毫秒），默认 60Hz。
+	 */
+	explicit FrameScheduler(Clock clock = Clock(), double refreshInterval = 1000.0 / 60.0);
+
+	void SetRefreshInterval(double ms);
+	double RefreshInterval() const { return _interval; }
+	void SetLowLatency(bool value) { _lowLatency = value; }
+	bool LowLatency() const { return _lowLatency; }
+
+	/** @brief 请求一帧；ArmTimer 时 *delay 为需等待的毫秒数。 */
+	Action Request(double* delay = nullptr);
+	/** @brief 系统绘制消息到达；返回 RenderNow，或推迟（ArmTimer / Idle）。 */
+	Action OnPaint(double* delay = nullptr);
+	/** @brief 帧定时器到期（调用方应先停止定时器）。 */
+	Action OnTimer(double* delay = nullptr);
+
+	/** @brief 开始实际绘制（清除待绘帧），用于限速与统计。 */
+	void BeginFrame();
+	/** @brief 结束绘制；绘制期间又有请求时返回下一帧的安排（通常为 ArmTimer）。 */
+	Action EndFrame(double* delay = nullptr);
+	/** @brief 待绘帧无内容可画（没有变化），直接清除。 */
+	void CancelFrame() { _pending = false; }
+
+	bool HasPendingFrame() const { return _pending; }
+	bool TimerArmed() const { return _timerArmed; }
+	/** @brief 距离本周期结束还需等待的毫秒数；0 表示现在即可绘制。 */
+	double TimeUntilNextFrame() const;
+
+	Stats GetStats() const;
+	void ResetStats();
+
+private:
+	Clock _clock;
+	double _interval;
+	bool _lowLatency = false;
+
+	bool _pending = false;
+	double _requestTime = 0.0;
+	bool _timerArmed = false;
+	bool _hasFrame = false;
+	bool _inFrame = false;
+	double _lastBegin = 0.0;
+
+	size_t _requests = 0;
+	size_t _coalesced = 0;
+	size_t _deferred = 0;
+	size_t _frames = 0;
+	std::vector<double> _frameTimes;
+	size_t _frameTimeNext = 0;
+	double _lastFrameTime = 0.0;
+	double _maxFrameTime = 0.0;
+	double _intervalSum = 0.0;
+	size_t _intervalCount = 0;
+	double _latencySum = 0.0;
+	size_t _latencyCount = 0;
+	double _maxLatency = 0.0;
+
+	double Wait(double now) const;
+	void MarkPending(double now);
+	Action Defer(double wait, double* delay);
+};
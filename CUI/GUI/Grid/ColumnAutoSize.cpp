@@ -0,0 +1,60 @@
+#include "ColumnAutoSize.h"
+#include <algorithm>
+
+void ColumnAutoSize::PickRows(const std::vector<uint32_t>& lengths, const GridAutoSizeOptions& options, std::vector<int>& rows)
+{
+	rows.clear();
+	const size_t n = lengths.size();
+	const size_t budget = options.SampleRows > 0 ? (size_t)options.SampleRows : n;
+	if (budget >= n)
+	{
+		rows.resize(n);
+		for (size_t i = 0; i < n; i++) rows[i] = (int)i;
+		return;
+	}
+
+	size_t uniform = budget;
+	if (options.Percentile >= 1.0f)
+	{
+		// 一半名额给字符数最多的行
+		const size_t longest = budget / 2;
+		uniform = budget - longest;
+		std::vector<int> order(n);
+		for (size_t i = 0; i < n; i++) order[i] = (int)i;
+		std::nth_element(order.begin(), order.begin() + longest, order.end(), [&](int a, int b)
+			{
+				return lengths[(size_t)a] > lengths[(size_t)b];
+			});
+		rows.assign(order.begin(), order.begin() + longest);
+	}
+	if (uniform > 0)
+	{
+		const double step = (double)n / (double)uniform;
+		for (size_t i = 0; i < uniform; i++)
+			rows.push_back((int)(i * step));
+	}
+	std::sort(rows.begin(), rows.end());
+	rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+}
+
+float ColumnAutoSize::Reduce(std::vector<float>& widths, const GridAutoSizeOptions& options)
+{
+	float width = 0.0f;
+	if (!widths.empty())
+	{
+		if (options.Percentile >= 1.0f)
+		{
+			width = *std::max_element(widths.begin(), widths.end());
+		}
+		else
+		{
+			const float p = options.Percentile < 0.0f ? 0.0f : options.Percentile;
+			const size_t k = (size_t)(p * (float)(widths.size() - 1));
+			std::nth_element(widths.begin(), widths.begin() + k, widths.end());
+			width = widths[k];
+		}
+	}
+	if (width < options.MinWidth) width = options.MinWidth;
+	if (options.MaxWidth > 0.0f && width > options.MaxWidth) width = options.MaxWidth;
+	return width;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file ColumnAutoSize.h
+ * @brief ColumnAutoSize：列自适应宽度的抽样与汇总（不依赖 Windows）。
+ *
+ * 大列不必逐行测量：
+ * - 取最大值时，宽度几乎随字符数单调增长，先按字符数挑出最长的一批行，
+ *   再均匀抽取一批行覆盖全角/窄字符等例外
+ * - 取分位数时（忽略少量超长异常值），均匀抽样即可
+ */
+struct GridAutoSizeOptions
+{
+	/** @brief 每列最多测量的行数（0 表示全部行）。 */
+	int SampleRows = 0;
+	/** @brief 取测量宽度的分位数（1 为最大值，0.95 表示忽略最宽的 5%）。 */
+	float Percentile = 1.0f;
+	float MinWidth = 10.0f;
+	/** @brief 最大宽度（0 表示不限制）。 */
+	float MaxWidth = 0.0f;
+};
+
+class ColumnAutoSize
+{
+public:
+	/**
+	 * @brief 按各行文本长度选出需要测量的行。
+	 * @param lengths 每行文本的字符数。
+	 * @param rows 输出行号（升序、无重复）。
+	 */
+	static void PickRows(const std::vector<uint32_t>& lengths, const GridAutoSizeOptions& options, std::vector<int>& rows);
+	/** @brief 汇总测量结果（分位数 + 最小/最大宽度限制）；会重排 widths。 */
+	static float Reduce(std::vector<float>& widths, const GridAutoSizeOptions& options);
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file GridRowCache.h
+ * @brief GridRowCache：虚拟模式表格的 LRU 行缓存（不依赖 Windows）。
+ *
+ * 表格只在显示/编辑某行时才向数据源拉取；连续缺失的行合并为一次 GetRows 调用。
+ * 超出容量时淘汰最久未使用的行。容量取 SetSource 指定的值与两屏可见行数中的较大者，
+ * 保证一帧内取得的行引用不被同一帧的拉取淘汰。
+ *
+ * Source 需提供 int GetRowCount() 与 void GetRows(int firstRow, int count, Row* rows)
+ * （即 GridViewDataSource 的形式）；所有方法都在 UI 线程调用。
+ */
+template<class Row, class Source>
+class GridRowCache
+{
+public:
+	/** @brief 返回 true 的行不会被淘汰（如正在编辑、未提交的行）。 */
+	std::function<bool(int row)> Pinned;
+
+	/**
+	 * @brief 设置数据源（NULL 表示不使用）与容量；之后应调用 Invalidate。
+	 * @param capacity LRU 容量（至少为 1）。
+	 */
+	void SetSource(Source* source, size_t capacity)
+	{
+		_source = source;
+		_capacity = (std::max)(capacity, (size_t)1);
+		_minCapacity = 0;
+	}
+	Source* GetSource() const { return _source; }
+
+	/** @brief 重新读取行数并清空缓存。 */
+	void Invalidate()
+	{
+		Clear();
+		_rowCount = _source ? (std::max)(0, _source->GetRowCount()) : 0;
+	}
+	/** @brief 清空缓存（行数不变）。 */
+	void Clear()
+	{
+		_rows.clear();
+		_map.clear();
+	}
+	/** @brief 丢弃单行缓存，返回该行是否在缓存中。 */
+	bool InvalidateRow(int row)
+	{
+		auto it = _map.find(row);
+		if (it == _map.end()) return false;
+		_rows.erase(it->second);
+		_map.erase(it);
+		return true;
+	}
+
+	/** @brief 最近一次 Invalidate 读取的行数。 */
+	int RowCount() const { return _rowCount; }
+	/** @brief 已缓存的行数。 */
+	size_t Count() const { return _rows.size(); }
+	/** @brief 当前生效的容量。 */
+	size_t Capacity() const { return (std::max)(_capacity, _minCapacity); }
+	bool Contains(int row) const { return _map.find(row) != _map.end(); }
+
+	/**
+	 * @brief 取得一屏 [firstRow, firstRow + visibleRows)，并把容量下限设为两屏。
+	 *
+	 * 滚动后只拉取新露出的行，仍在缓存中的行只更新最近使用顺序。
+	 */
+	void PrefetchScreen(int firstRow, int visibleRows)
+	{
+		_minCapacity = (size_t)(std::max)(visibleRows, 0) * 2;
+		Prefetch(firstRow, visibleRows);
+	}
+	/** @brief 确保 [firstRow, firstRow + count) 已缓存（越界部分忽略）。 */
+	void Prefetch(int firstRow, int count)
+	{
+		if (!_source) return;
+		if (firstRow < 0) firstRow = 0;
+		const int endRow = (int)(std::min)((long long)_rowCount, (long long)firstRow + count);
+		int r = firstRow;
+		while (r < endRow)
+		{
+			auto it = _map.find(r);
+			if (it != _map.end())
+			{
+				_rows.splice(_rows.begin(), _rows, it->second);
+				r++;
+				continue;
+			}
+			// 连续缺失的行合并为一次数据源调用
+			int runEnd = r + 1;
+			while (runEnd < endRow && _map.find(runEnd) == _map.end())
+				runEnd++;
+			std::vector<Row> fetched((size_t)(runEnd - r));
+			_source->GetRows(r, runEnd - r, fetched.data());
+			for (int i = 0; i < runEnd - r; i++)
+			{
+				Entry entry;
+				entry.Index = r + i;
+				entry.Value = std::move(fetched[(size_t)i]);
+				_rows.push_front(std::move(entry));
+				_map[r + i] = _rows.begin();
+			}
+			r = runEnd;
+		}
+		Trim();
+	}
+
+	/** @brief 取得第 row 行（缺失时拉取），越界返回 NULL；指针在该行被淘汰前有效。 */
+	Row* Get(int row)
+	{
+		auto it = _map.find(row);
+		if (it == _map.end())
+		{
+			Prefetch(row, 1);
+			it = _map.find(row);
+			if (it == _map.end()) return nullptr;
+		}
+		else
+		{
+			_rows.splice(_rows.begin(), _rows, it->second);
+		}
+		return &it->second->Value;
+	}
+	/** @brief 只查缓存：不拉取、不改变最近使用顺序。 */
+	Row* Peek(int row)
+	{
+		auto it = _map.find(row);
+		return it != _map.end() ? &it->second->Value : nullptr;
+	}
+
+private:
+	struct Entry
+	{
+		int Index = -1;
+		Row Value;
+	};
+
+	Source* _source = nullptr;
+	int _rowCount = 0;
+	size_t _capacity = 256;
+	size_t _minCapacity = 0;
+	// 最近使用的在前
+	std::list<Entry> _rows;
+	std::unordered_map<int, typename std::list<Entry>::iterator> _map;
+
+	void Trim()
+	{
+		const size_t capacity = Capacity();
+		size_t guard = _rows.size();
+		while (_rows.size() > capacity && guard-- > 0)
+		{
+			auto last = std::prev(_rows.end());
+			if (Pinned && Pinned(last->Index))
+			{
+				_rows.splice(_rows.begin(), _rows, last);
+				continue;
+			}
+			_map.erase(last->Index);
+			_rows.erase(last);
+		}
+	}
+};
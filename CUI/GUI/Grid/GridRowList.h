@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+
+/**
+ * @file GridRowList.h
+ * @brief GridRowList：记录结构修改的表格行集合（不依赖 Windows）。
+ *
+ * 在 Base（List<Row> 形式）之上覆盖增删、交换、替换等方法，每次修改递增版本号，
+ * 表格据此判断排序状态、筛选结果与文本索引是否过期：
+ * - Version：任何结构修改都递增
+ * - ReorderVersion：已有行被移动、替换或删除时递增（只在末尾追加不计入）
+ *
+ * 绕过这些方法的修改（operator[] 整行赋值、直接调用 std::vector 的方法）不会被记录，
+ * 之后应调用 MarkChanged；行数变化另由使用方比较 Count 发现。
+ * 只改写单元格内容不属于结构修改。
+ */
+template<class Base>
+class GridRowList : public Base
+{
+public:
+	using Base::Base;
+
+	uint64_t Version() const { return _version; }
+	uint64_t ReorderVersion() const { return _reorderVersion; }
+	/** @brief 绕过集合方法改写了行之后调用。 */
+	void MarkChanged()
+	{
+		_version++;
+		_reorderVersion++;
+	}
+
+	template<class Value>
+	void Add(Value&& value)
+	{
+		Base::Add(std::forward<Value>(value));
+		_version++;
+	}
+	template<class... Args>
+	void AddRange(Args&&... args)
+	{
+		Base::AddRange(std::forward<Args>(args)...);
+		_version++;
+	}
+	template<class Value>
+	void Insert(int index, Value&& value)
+	{
+		Base::Insert(index, std::forward<Value>(value));
+		MarkChanged();
+	}
+	template<class... Args>
+	void RemoveAt(int index, Args... num)
+	{
+		Base::RemoveAt(index, num...);
+		MarkChanged();
+	}
+	template<class Value>
+	int Remove(Value&& value)
+	{
+		int n = Base::Remove(std::forward<Value>(value));
+		MarkChanged();
+		return n;
+	}
+	void Swap(int from, int to)
+	{
+		Base::Swap(from, to);
+		MarkChanged();
+	}
+	void Reverse()
+	{
+		Base::Reverse();
+		MarkChanged();
+	}
+	void Clear()
+	{
+		Base::Clear();
+		MarkChanged();
+	}
+	template<class Value>
+	void set(int i, Value&& value)
+	{
+		Base::set(i, std::forward<Value>(value));
+		MarkChanged();
+	}
+
+private:
+	uint64_t _version = 0;
+	uint64_t _reorderVersion = 0;
+};
@@ -0,0 +1,224 @@
+#include "GridSort.h"
+#include <charconv>
+#include <cwchar>
+
+namespace
+{
+	bool IsSpace(wchar_t ch)
+	{
+		return ch == L' ' || ch == L'\t' || ch == 0x3000 || ch == 0x00A0;
+	}
+	bool IsDigit(wchar_t ch)
+	{
+		return ch >= L'0' && ch <= L'9';
+	}
+	void Trim(const wchar_t*& p, const wchar_t*& e)
+	{
+		while (p < e && IsSpace(*p)) p++;
+		while (e > p && IsSpace(e[-1])) e--;
+	}
+	// 读取 1~maxDigits 位十进制数
+	bool ReadInt(const wchar_t*& p, const wchar_t* e, int maxDigits, int& out)
+	{
+		int v = 0;
+		int n = 0;
+		while (p < e && IsDigit(*p) && n < maxDigits)
+		{
+			v = v * 10 + (*p - L'0');
+			p++;
+			n++;
+		}
+		if (n == 0) return false;
+		out = v;
+		return true;
+	}
+	// 公历日期到 1970-01-01 的天数
+	int64_t DaysFromCivil(int y, int m, int d)
+	{
+		y -= m <= 2 ? 1 : 0;
+		const int64_t era = (y >= 0 ? y : y - 399) / 400;
+		const int64_t yoe = y - era * 400;
+		const int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+		const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+		return era * 146097 + doe - 719468;
+	}
+}
+
+unsigned GridSort::WorkerCount(size_t items)
+{
+	if (items < ParallelThreshold) return 1;
+	unsigned hw = std::thread::hardware_concurrency();
+	if (hw == 0) hw = 1;
+	const size_t byWork = items / (ParallelThreshold / 4);
+	unsigned workers = (unsigned)(std::min)((size_t)hw, byWork);
+	if (workers > 16) workers = 16;
+	return workers < 1 ? 1 : workers;
+}
+
+bool GridSort::ParseNumber(const wchar_t* text, size_t len, double& out)
+{
+	const wchar_t* p = text;
+	const wchar_t* e = text + len;
+	Trim(p, e);
+	if (p < e && e[-1] == L'%') e--;
+	if (p == e) return false;
+
+	// 转成 ASCII 后交给 from_chars（与区域设置无关）
+	char buf[64];
+	size_t n = 0;
+	if (*p == L'+' || *p == L'-')
+	{
+		if (*p == L'-') buf[n++] = '-';
+		p++;
+	}
+	int digits = 0;
+	int groupDigits = -1; // 千分位逗号之后已读取的位数
+	while (p < e && (IsDigit(*p) || *p == L','))
+	{
+		if (*p == L',')
+		{
+			if (digits == 0 || (groupDigits >= 0 && groupDigits != 3)) return false;
+			groupDigits = 0;
+		}
+		else
+		{
+			if (n >= sizeof(buf) - 1) return false;
+			buf[n++] = (char)*p;
+			digits++;
+			if (groupDigits >= 0) groupDigits++;
+		}
+		p++;
+	}
+	if (groupDigits >= 0 && groupDigits != 3) return false;
+	if (p < e && *p == L'.')
+	{
+		if (n >= sizeof(buf) - 1) return false;
+		buf[n++] = '.';
+		p++;
+		while (p < e && IsDigit(*p))
+		{
+			if (n >= sizeof(buf) - 1) return false;
+			buf[n++] = (char)*p;
+			digits++;
+			p++;
+		}
+	}
+	if (digits == 0) return false;
+	if (p < e && (*p == L'e' || *p == L'E'))
+	{
+		if (n >= sizeof(buf) - 4) return false;
+		buf[n++] = 'e';
+		p++;
+		if (p < e && (*p == L'+' || *p == L'-')) buf[n++] = (char)*p++;
+		int expDigits = 0;
+		while (p < e && IsDigit(*p) && n < sizeof(buf) - 1)
+		{
+			buf[n++] = (char)*p++;
+			expDigits++;
+		}
+		if (expDigits == 0) return false;
+	}
+	if (p != e) return false;
+
+	double v = 0.0;
+	auto r = std::from_chars(buf, buf + n, v);
+	if (r.ec != std::errc() || r.ptr != buf + n) return false;
+	out = v;
+	return true;
+}
+
+bool GridSort::ParseDate(const wchar_t* text, size_t len, double& out)
+{
+	const wchar_t* p = text;
+	const wchar_t* e = text + len;
+	Trim(p, e);
+
+	int y = 0, m = 0, d = 0;
+	const wchar_t* start = p;
+	if (!ReadInt(p, e, 4, y) || p - start != 4) return false;
+	if (p == e || (*p != L'-' && *p != L'/')) return false;
+	const wchar_t sep = *p++;
+	if (!ReadInt(p, e, 2, m)) return false;
+	if (p == e || *p != sep) return false;
+	p++;
+	if (!ReadInt(p, e, 2, d)) return false;
+	if (m < 1 || m > 12 || d < 1 || d > 31) return false;
+
+	int hh = 0, mm = 0, ss = 0;
+	double frac = 0.0;
+	if (p < e && (*p == L' ' || *p == L'T'))
+	{
+		p++;
+		if (!ReadInt(p, e, 2, hh)) return false;
+		if (p == e || *p != L':') return false;
+		p++;
+		if (!ReadInt(p, e, 2, mm)) return false;
+		if (p < e && *p == L':')
+		{
+			p++;
+			if (!ReadInt(p, e, 2, ss)) return false;
+			if (p < e && *p == L'.')
+			{
+				p++;
+				double scale = 0.1;
+				if (p == e || !IsDigit(*p)) return false;
+				while (p < e && IsDigit(*p))
+				{
+					frac += (*p - L'0') * scale;
+					scale *= 0.1;
+					p++;
+				}
+			}
+		}
+		if (hh > 23 || mm > 59 || ss > 60) return false;
+	}
+	if (p != e) return false;
+
+	out = (double)DaysFromCivil(y, m, d) * 86400.0 + hh * 3600.0 + mm * 60.0 + ss + frac;
+	return true;
+}
+
+GridSortKey GridSort::MakeKey(const wchar_t* text, size_t len)
+{
+	GridSortKey k;
+	if (!text || len == 0) return k;
+	double v = 0.0;
+	if (ParseNumber(text, len, v) || ParseDate(text, len, v))
+	{
+		k.Kind = GridSortKey::Number;
+		k.Value = v;
+		return k;
+	}
+	k.Kind = GridSortKey::Text;
+	k.Chars = text;
+	k.Length = (uint32_t)len;
+	return k;
+}
+
+GridSortKey GridSort::MakeNumberKey(double value)
+{
+	GridSortKey k;
+	k.Kind = GridSortKey::Number;
+	k.Value = value;
+	return k;
+}
+
+int GridSort::Compare(const GridSortKey& a, const GridSortKey& b)
+{
+	if (a.Kind != b.Kind) return a.Kind < b.Kind ? -1 : 1;
+	switch (a.Kind)
+	{
+	case GridSortKey::Number:
+		if (a.Value == b.Value) return 0;
+		return a.Value < b.Value ? -1 : 1;
+	case GridSortKey::Text:
+	{
+		const int cmp = std::wmemcmp(a.Chars, b.Chars, (std::min)(a.Length, b.Length));
+		if (cmp != 0) return cmp;
+		if (a.Length == b.Length) return 0;
+		return a.Length < b.Length ? -1 : 1;
+	}
+	default:
+		return 0;
+	}
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @file GridSort.h
+ * @brief GridSort：表格排序用的排序键提取与并行稳定排序（不依赖 Windows）。
+ *
+ * 排序前对每行只解析一次单元格文本，得到紧凑的排序键：
+ * - 数值（含千分位、百分号）与日期（YYYY-MM-DD / YYYY/MM/DD [HH:MM[:SS]]）解析为 double
+ * - 其余按原文本（指针 + 长度，不拷贝）做序数比较
+ * - 空值排在最前，其次数值，最后文本
+ *
+ * 排序对象是行索引排列，而不是行本身；排好后可用 ApplyOrder 一次性移动行。
+ */
+struct GridSortKey
+{
+	enum : uint8_t
+	{
+		Empty = 0,
+		Number = 1,
+		Text = 2,
+	};
+	uint8_t Kind = Empty;
+	double Value = 0.0;
+	// 指向源文本，排序期间源数据不得修改
+	const wchar_t* Chars = nullptr;
+	uint32_t Length = 0;
+};
+
+class GridSort
+{
+public:
+	/** @brief 行数低于该值时不开线程。 */
+	static constexpr size_t ParallelThreshold = 16 * 1024;
+
+	/** @brief 由单元格文本生成排序键（文本指针须在排序期间有效）。 */
+	static GridSortKey MakeKey(const wchar_t* text, size_t len);
+	/** @brief 由整数值（勾选/下拉等无文本的单元格）生成排序键。 */
+	static GridSortKey MakeNumberKey(double value);
+	/** @brief 比较两个排序键：<0 a<b，0 相等，>0 a>b。 */
+	static int Compare(const GridSortKey& a, const GridSortKey& b);
+
+	/** @brief 解析数值（允许首尾空白、正负号、千分位逗号、小数、指数与末尾 %）。 */
+	static bool ParseNumber(const wchar_t* text, size_t len, double& out);
+	/** @brief 解析日期/时间为自 1970-01-01 起的秒数。 */
+	static bool ParseDate(const wchar_t* text, size_t len, double& out);
+
+	/** @brief 建议的工作线程数（至少 1）。 */
+	static unsigned WorkerCount(size_t items);
+
+	/**
+	 * @brief 把 [0, count) 均分给多个线程执行 fn(begin, end)；数量较少时在当前线程执行。
+	 * @param workers 线程数，0 表示按 WorkerCount 决定。
+	 */
+	template <class Fn>
+	static void ParallelFor(size_t count, Fn fn, unsigned workers = 0)
+	{
+		if (workers == 0) workers = WorkerCount(count);
+		if (workers <= 1)
+		{
+			fn((size_t)0, count);
+			return;
+		}
+		std::vector<std::thread> threads;
+		threads.reserve(workers - 1);
+		for (unsigned i = 1; i < workers; i++)
+		{
+			const size_t b = count * i / workers;
+			const size_t e = count * (i + 1) / workers;
+			threads.emplace_back([&fn, b, e]() { fn(b, e); });
+		}
+		fn((size_t)0, count / workers);
+		for (auto& t : threads) t.join();
+	}
+
+	/**
+	 * @brief 并行稳定排序：各线程先排序一段，再逐轮两两归并。
+	 *
+	 * less 必须是严格弱序且可被多个线程同时调用（只读）。
+	 * @param workers 线程数，0 表示按 WorkerCount 决定。
+	 */
+	template <class T, class Less>
+	static void ParallelStableSort(std::vector<T>& items, Less less, unsigned workers = 0)
+	{
+		const size_t n = items.size();
+		if (workers == 0) workers = WorkerCount(n);
+		if (workers <= 1)
+		{
+			std::stable_sort(items.begin(), items.end(), less);
+			return;
+		}
+
+		std::vector<size_t> bounds;
+		for (unsigned i = 0; i <= workers; i++)
+			bounds.push_back(n * i / workers);
+		ParallelRuns(bounds.size() - 1, [&](size_t i)
+			{
+				std::stable_sort(items.begin() + bounds[i], items.begin() + bounds[i + 1], less);
+			});
+
+		std::vector<T> buffer(n);
+		while (bounds.size() > 2)
+		{
+			std::vector<size_t> next;
+			const size_t runs = bounds.size() - 1;
+			for (size_t i = 0; i < runs; i += 2)
+				next.push_back(bounds[i]);
+			next.push_back(n);
+			ParallelRuns((runs + 1) / 2, [&](size_t pair)
+				{
+					const size_t i = pair * 2;
+					const size_t b = bounds[i];
+					const size_t m = bounds[i + 1];
+					const size_t e = (i + 2 < bounds.size()) ? bounds[i + 2] : m;
+					// 归并时左段优先，保持稳定
+					std::merge(items.begin() + b, items.begin() + m,
+						items.begin() + m, items.begin() + e,
+						buffer.begin() + b, less);
+				});
+			items.swap(buffer);
+			bounds.swap(next);
+		}
+	}
+
+	/**
+	 * @brief 按排列重排元素：之后 items[i] 为原来的 items[order[i]]（只移动，不拷贝）。
+	 *
+	 * order 须是 [0, items.size()) 的一个排列。
+	 */
+	template <class T, class Alloc>
+	static void ApplyOrder(std::vector<T, Alloc>& items, const std::vector<int>& order)
+	{
+		std::vector<T, Alloc> sorted;
+		sorted.reserve(order.size());
+		for (int i : order)
+			sorted.push_back(std::move(items[(size_t)i]));
+		items.swap(sorted);
+	}
+
+private:
+	template <class Fn>
+	static void ParallelRuns(size_t runs, Fn fn)
+	{
+		std::vector<std::thread> threads;
+		threads.reserve(runs > 0 ? runs - 1 : 0);
+		for (size_t i = 1; i < runs; i++)
+			threads.emplace_back([&fn, i]() { fn(i); });
+		if (runs > 0) fn(0);
+		for (auto& t : threads) t.join();
+	}
+};
@@ -0,0 +1,210 @@
+#include "GridTextIndex.h"
+#include <algorithm>
+#include <iterator>
+
+wchar_t GridTextIndex::Fold(wchar_t ch)
+{
+	if (ch < 0x80)
+		return (ch >= L'A' && ch <= L'Z') ? (wchar_t)(ch + 32) : ch;
+	// Latin-1 大写（跳过 ×）
+	if (ch >= 0xC0 && ch <= 0xDE && ch != 0xD7)
+		return (wchar_t)(ch + 32);
+	// 希腊字母
+	if (ch >= 0x391 && ch <= 0x3A9 && ch != 0x3A2)
+		return (wchar_t)(ch + 32);
+	// 西里尔字母
+	if (ch >= 0x410 && ch <= 0x42F)
+		return (wchar_t)(ch + 32);
+	if (ch >= 0x400 && ch <= 0x40F)
+		return (wchar_t)(ch + 80);
+	// 全角 Ａ-Ｚ
+	if (ch >= 0xFF21 && ch <= 0xFF3A)
+		return (wchar_t)(ch + 32);
+	return ch;
+}
+
+std::wstring GridTextIndex::Fold(const std::wstring& text)
+{
+	std::wstring s = text;
+	for (auto& ch : s)
+		ch = Fold(ch);
+	return s;
+}
+
+bool GridTextIndex::ContainsFolded(const wchar_t* text, size_t len, const std::wstring& foldedNeedle)
+{
+	if (foldedNeedle.empty()) return true;
+	if (!text || len < foldedNeedle.size()) return false;
+	const wchar_t first = foldedNeedle[0];
+	const size_t last = len - foldedNeedle.size();
+	for (size_t i = 0; i <= last; i++)
+	{
+		if (Fold(text[i]) != first) continue;
+		size_t j = 1;
+		while (j < foldedNeedle.size() && Fold(text[i + j]) == foldedNeedle[j])
+			j++;
+		if (j == foldedNeedle.size()) return true;
+	}
+	return false;
+}
+
+uint64_t GridTextIndex::Pack(const wchar_t* folded)
+{
+	// 每个字符取 21 位（覆盖全部 Unicode 码位）
+	uint64_t key = 0;
+	for (size_t i = 0; i < GramLength; i++)
+		key = (key << 21) | ((uint64_t)(uint32_t)folded[i] & 0x1FFFFF);
+	return key;
+}
+
+void GridTextIndex::CollectGrams(const wchar_t* text, size_t len, std::vector<uint64_t>& out)
+{
+	out.clear();
+	if (!text || len < GramLength) return;
+	wchar_t window[GramLength];
+	for (size_t i = 0; i + 1 < GramLength; i++)
+		window[i + 1] = Fold(text[i]);
+	for (size_t i = GramLength - 1; i < len; i++)
+	{
+		for (size_t k = 0; k + 1 < GramLength; k++)
+			window[k] = window[k + 1];
+		window[GramLength - 1] = Fold(text[i]);
+		out.push_back(Pack(window));
+	}
+	// 每行每个片段只记一次
+	std::sort(out.begin(), out.end());
+	out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void GridTextIndex::Build(int rows, const TextReader& read)
+{
+	Clear();
+	if (rows < 0) rows = 0;
+	std::vector<uint64_t> grams;
+	std::vector<uint32_t> counts;
+
+	// 第一遍：统计每个片段出现的行数
+	for (int r = 0; r < rows; r++)
+	{
+		const wchar_t* text = nullptr;
+		size_t len = 0;
+		read(r, text, len);
+		CollectGrams(text, len, grams);
+		for (uint64_t g : grams)
+		{
+			auto it = _grams.find(g);
+			if (it == _grams.end())
+			{
+				_grams.emplace(g, (uint32_t)counts.size());
+				counts.push_back(1);
+			}
+			else
+			{
+				counts[it->second]++;
+			}
+		}
+	}
+
+	_offsets.resize(counts.size() + 1);
+	_offsets[0] = 0;
+	for (size_t i = 0; i < counts.size(); i++)
+		_offsets[i + 1] = _offsets[i] + counts[i];
+	_postings.resize(_offsets.back());
+
+	// 第二遍：按行号升序写入
+	std::vector<uint32_t> cursor(_offsets.begin(), _offsets.end() - 1);
+	for (int r = 0; r < rows; r++)
+	{
+		const wchar_t* text = nullptr;
+		size_t len = 0;
+		read(r, text, len);
+		CollectGrams(text, len, grams);
+		for (uint64_t g : grams)
+		{
+			auto it = _grams.find(g);
+			// 两次读取的文本不一致时忽略新出现的片段
+			if (it == _grams.end()) continue;
+			uint32_t& pos = cursor[it->second];
+			if (pos < _offsets[it->second + 1])
+				_postings[pos++] = (uint32_t)r;
+		}
+	}
+	_rows = rows;
+	_built = true;
+}
+
+void GridTextIndex::Clear()
+{
+	_built = false;
+	_rows = 0;
+	_grams.clear();
+	_offsets.clear();
+	_offsets.shrink_to_fit();
+	_postings.clear();
+	_postings.shrink_to_fit();
+	_touched.clear();
+}
+
+void GridTextIndex::Touch(int row)
+{
+	if (!_built || row < 0) return;
+	auto it = std::lower_bound(_touched.begin(), _touched.end(), (uint32_t)row);
+	if (it == _touched.end() || *it != (uint32_t)row)
+		_touched.insert(it, (uint32_t)row);
+}
+
+size_t GridTextIndex::MemoryUsage() const
+{
+	return _grams.size() * (sizeof(uint64_t) + sizeof(uint32_t) + 2 * sizeof(void*))
+		+ _offsets.capacity() * sizeof(uint32_t)
+		+ _postings.capacity() * sizeof(uint32_t)
+		+ _touched.capacity() * sizeof(uint32_t);
+}
+
+bool GridTextIndex::Candidates(const std::wstring& foldedQuery, std::vector<int>& rows) const
+{
+	rows.clear();
+	if (!_built || foldedQuery.size() < GramLength) return false;
+
+	std::vector<uint64_t> grams;
+	CollectGrams(foldedQuery.c_str(), foldedQuery.size(), grams);
+	struct Range
+	{
+		const uint32_t* Begin;
+		const uint32_t* End;
+	};
+	std::vector<Range> lists;
+	lists.reserve(grams.size());
+	for (uint64_t g : grams)
+	{
+		auto it = _grams.find(g);
+		if (it == _grams.end())
+		{
+			rows.assign(_touched.begin(), _touched.end());
+			return true;
+		}
+		lists.push_back({ _postings.data() + _offsets[it->second], _postings.data() + _offsets[it->second + 1] });
+	}
+	// 从最短的行号表开始求交集
+	std::sort(lists.begin(), lists.end(), [](const Range& a, const Range& b)
+		{
+			return (a.End - a.Begin) < (b.End - b.Begin);
+		});
+
+	std::vector<uint32_t> current(lists[0].Begin, lists[0].End);
+	std::vector<uint32_t> next;
+	for (size_t i = 1; i < lists.size() && !current.empty(); i++)
+	{
+		next.clear();
+		std::set_intersection(current.begin(), current.end(), lists[i].Begin, lists[i].End, std::back_inserter(next));
+		current.swap(next);
+	}
+	if (!_touched.empty())
+	{
+		next.clear();
+		std::set_union(current.begin(), current.end(), _touched.begin(), _touched.end(), std::back_inserter(next));
+		current.swap(next);
+	}
+	rows.assign(current.begin(), current.end());
+	return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file GridTextIndex.h
+ * @brief GridTextIndex：表格文本列的 n-gram（三元组）倒排索引，用于子串筛选（不依赖 Windows）。
+ *
+ * 每行文本按不区分大小写折叠后切成连续 3 字符片段，记录包含该片段的行号。
+ * 查询时取查询串各片段的行号表求交集，得到候选行（超集）；调用方仍需逐行确认子串匹配。
+ * 查询串短于 3 个字符时索引无法缩小范围，由调用方全量扫描。
+ *
+ * 存储为紧凑的 CSR 结构（片段 -> [起始, 结束) 区间 + 连续行号数组），构建后只读；
+ * 少量行被修改时用 Touch 标记，这些行总是作为候选返回，大量修改后应重新 Build。
+ */
+class GridTextIndex
+{
+public:
+	static constexpr size_t GramLength = 3;
+	/** @brief 读取某行文本（指针在本次回调返回前有效）。 */
+	using TextReader = std::function<void(int row, const wchar_t*& text, size_t& len)>;
+
+	/** @brief 为 [0, rows) 建立索引（回调每行调用两次）。 */
+	void Build(int rows, const TextReader& read);
+	void Clear();
+	/** @brief 标记某行文本已修改（索引内容不再可信，查询时总作为候选）。 */
+	void Touch(int row);
+	bool IsBuilt() const { return _built; }
+	int RowCount() const { return _rows; }
+	size_t GramCount() const { return _grams.size(); }
+	/** @brief 估算占用的字节数。 */
+	size_t MemoryUsage() const;
+
+	/**
+	 * @brief 查询候选行（升序）。
+	 * @param foldedQuery 已用 Fold 折叠的查询串。
+	 * @return false 表示查询串过短、索引无法使用；true 时 rows 为候选行（可能为空）。
+	 */
+	bool Candidates(const std::wstring& foldedQuery, std::vector<int>& rows) const;
+
+	/** @brief 大小写折叠（ASCII、Latin-1、希腊与西里尔字母、全角字母）。 */
+	static wchar_t Fold(wchar_t ch);
+	static std::wstring Fold(const std::wstring& text);
+	/** @brief text 中是否包含（已折叠的）needle，比较时折叠 text。 */
+	static bool ContainsFolded(const wchar_t* text, size_t len, const std::wstring& foldedNeedle);
+
+private:
+	bool _built = false;
+	int _rows = 0;
+	// 片段 -> 槽位；槽位 i 的行号为 _postings[_offsets[i], _offsets[i + 1])
+	std::unordered_map<uint64_t, uint32_t> _grams;
+	std::vector<uint32_t> _offsets;
+	std::vector<uint32_t> _postings;
+	// Build 之后被修改的行（升序、无重复）
+	std::vector<uint32_t> _touched;
+
+	static uint64_t Pack(const wchar_t* folded);
+	static void CollectGrams(const wchar_t* text, size_t len, std::vector<uint64_t>& out);
+};
@@ -0,0 +1,106 @@
+#include "TextWidthCache.h"
+
+TextWidthCache::TextWidthCache(size_t capacity)
+	: _capacity(capacity < 2 ? 2 : capacity)
+{
+}
+
+uint64_t TextWidthCache::Hash(const wchar_t* text, size_t len)
+{
+	// FNV-1a（按 UTF-16/32 码元），末尾混入长度
+	uint64_t h = 14695981039346656037ull;
+	for (size_t i = 0; i < len; i++)
+	{
+		h ^= (uint64_t)(uint32_t)text[i];
+		h *= 1099511628211ull;
+	}
+	h ^= (uint64_t)len;
+	h *= 1099511628211ull;
+	return h;
+}
+
+bool TextWidthCache::TryGet(uint64_t hash, float& width)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	auto it = _current.find(hash);
+	if (it != _current.end())
+	{
+		width = it->second;
+		_hits++;
+		return true;
+	}
+	it = _previous.find(hash);
+	if (it != _previous.end())
+	{
+		width = it->second;
+		_previous.erase(it);
+		PutLocked(hash, width);
+		_hits++;
+		return true;
+	}
+	_misses++;
+	return false;
+}
+
+void TextWidthCache::Put(uint64_t hash, float width)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	PutLocked(hash, width);
+}
+
+void TextWidthCache::PutLocked(uint64_t hash, float width)
+{
+	if (_current.size() >= _capacity / 2)
+	{
+		_previous.swap(_current);
+		_current.clear();
+	}
+	_current[hash] = width;
+}
+
+float TextWidthCache::Get(const wchar_t* text, size_t len, const Measure& measure)
+{
+	const uint64_t hash = Hash(text, len);
+	float width = 0.0f;
+	if (TryGet(hash, width)) return width;
+	width = measure(text, len);
+	Put(hash, width);
+	return width;
+}
+
+void TextWidthCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	_current.clear();
+	_previous.clear();
+	_hits = _misses = 0;
+}
+
+size_t TextWidthCache::Count()
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	return _current.size() + _previous.size();
+}
+
+uint64_t TextWidthCache::Hits()
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	return _hits;
+}
+
+uint64_t TextWidthCache::Misses()
+{
+	std::lock_guard<std::mutex> lock(_lock);
+	return _misses;
+}
+
+std::shared_ptr<TextWidthCache> TextWidthCache::ForFont(const std::wstring& fontName, float fontSize)
+{
+	static std::mutex registryLock;
+	static std::unordered_map<std::wstring, std::shared_ptr<TextWidthCache>> registry;
+	const std::wstring key = fontName + L"|" + std::to_wstring(fontSize);
+	std::lock_guard<std::mutex> lock(registryLock);
+	auto& cache = registry[key];
+	if (!cache) cache = std::make_shared<TextWidthCache>();
+	return cache;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @file TextWidthCache.h
+ * @brief TextWidthCache：按字体缓存文本测量宽度（键为字符串哈希，不依赖 Windows）。
+ *
+ * 表格列自适应宽度时同一字符串常出现成千上万次，每次都创建文本布局代价很高。
+ * 缓存只保存 64 位哈希 -> 宽度，不保存字符串本身；容量满时整代淘汰：
+ * 新条目写入当前代，当前代写满后成为旧代，旧代中命中的条目会被提升回当前代。
+ *
+ * 所有方法线程安全；测量回调在锁外执行。
+ */
+class TextWidthCache
+{
+public:
+	static constexpr size_t DefaultCapacity = 64 * 1024;
+	/** @brief 实际测量文本宽度（DIP）。 */
+	using Measure = std::function<float(const wchar_t* text, size_t len)>;
+
+	explicit TextWidthCache(size_t capacity = DefaultCapacity);
+
+	static uint64_t Hash(const wchar_t* text, size_t len);
+
+	bool TryGet(uint64_t hash, float& width);
+	void Put(uint64_t hash, float width);
+	/** @brief 命中则返回缓存宽度，否则调用 measure 并写入缓存。 */
+	float Get(const wchar_t* text, size_t len, const Measure& measure);
+	void Clear();
+	size_t Count();
+	uint64_t Hits();
+	uint64_t Misses();
+
+	/** @brief 获取某个字体（字体名 + 字号）共享的缓存。 */
+	static std::shared_ptr<TextWidthCache> ForFont(const std::wstring& fontName, float fontSize);
+
+private:
+	std::mutex _lock;
+	size_t _capacity;
+	std::unordered_map<uint64_t, float> _current;
+	std::unordered_map<uint64_t, float> _previous;
+	uint64_t _hits = 0;
+	uint64_t _misses = 0;
+
+	void PutLocked(uint64_t hash, float width);
+};
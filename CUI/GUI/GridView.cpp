@@ -2,8 +2,11 @@
 #include "GridView.h"
 #include "Form.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cwchar>
+#include <thread>
+#include "Grid/GridSort.h"
 #pragma comment(lib, "Imm32.lib")
 
 CellValue::CellValue() : Text(L""), Image(nullptr), Tag(NULL)
@@ -71,10 +74,13 @@ GridView::GridView(int x, int y, int width, int height)
 {
 	this->Location = POINT{ x,y };
 	this->Size = SIZE{ width,height };
+	// 未提交的编辑文本只存在于缓存行中
+	this->_rowCache.Pinned = [this](int row) { return this->Editing && row == this->EditingRowIndex; };
 }
 
 GridView::~GridView()
 {
+	CancelAutoSize();
 	CloseComboBoxEditor();
 	if (this->_cellComboBox)
 	{
@@ -125,8 +131,8 @@ GridView::ScrollLayout GridView::CalcScrollLayout()
 		if (visibleRows < 0) visibleRows = 0;
 		
 		// 计算新行区域高度（如果有的话）
-		float newRowAreaHeight = (this->AllowUserToAddRows && this->Columns.Count > 0) ? l.RowHeight : 0.0f;
-		float totalRowsH = (l.RowHeight > 0.0f) ? (l.RowHeight * (float)this->Rows.Count) : 0.0f;
+		float newRowAreaHeight = (this->NewRowEnabled() && this->Columns.Count > 0) ? l.RowHeight : 0.0f;
+		float totalRowsH = (l.RowHeight > 0.0f) ? (l.RowHeight * (float)this->RowCount()) : 0.0f;
 		totalRowsH += newRowAreaHeight;  // 加上新行区域高度
 
 		bool newNeedV = (totalRowsH > contentH);
@@ -142,7 +148,7 @@ GridView::ScrollLayout GridView::CalcScrollLayout()
 			l.TotalRowsHeight = totalRowsH;
 			l.MaxScrollY = std::max(0.0f, totalRowsH - contentH);
 			l.VisibleRows = visibleRows;
-			l.MaxScrollRow = std::max(0, this->Rows.Count - visibleRows);
+			l.MaxScrollRow = std::max(0, this->RowCount() - visibleRows);
 			l.MaxScrollX = std::max(0.0f, l.TotalColumnsWidth - renderW);
 			return l;
 		}
@@ -159,13 +165,13 @@ GridView::ScrollLayout GridView::CalcScrollLayout()
 	l.ContentHeight = contentH;
 	
 	// 计算新行区域高度
-	float newRowAreaHeight = (this->AllowUserToAddRows && this->Columns.Count > 0) ? l.RowHeight : 0.0f;
-	l.TotalRowsHeight = (l.RowHeight > 0.0f) ? (l.RowHeight * (float)this->Rows.Count) : 0.0f;
+	float newRowAreaHeight = (this->NewRowEnabled() && this->Columns.Count > 0) ? l.RowHeight : 0.0f;
+	l.TotalRowsHeight = (l.RowHeight > 0.0f) ? (l.RowHeight * (float)this->RowCount()) : 0.0f;
 	l.TotalRowsHeight += newRowAreaHeight;  // 加上新行区域高度
 	l.MaxScrollY = std::max(0.0f, l.TotalRowsHeight - contentH);
 	l.VisibleRows = (l.RowHeight > 0.0f && contentH > 0.0f) ? ((int)std::ceil(contentH / l.RowHeight) + 1) : 0;
 	if (l.VisibleRows < 0) l.VisibleRows = 0;
-	l.MaxScrollRow = std::max(0, this->Rows.Count - l.VisibleRows);
+	l.MaxScrollRow = std::max(0, this->RowCount() - l.VisibleRows);
 	l.MaxScrollX = std::max(0.0f, l.TotalColumnsWidth - l.RenderWidth);
 	return l;
 }
@@ -191,7 +197,7 @@ CursorKind GridView::QueryCursor(int xof, int yof)
 	{
 		POINT undermouseIndex = GetGridViewUnderMouseItem(xof, yof, this);
 		if (undermouseIndex.y >= 0 && undermouseIndex.x >= 0 &&
-			undermouseIndex.y < this->Rows.Count && undermouseIndex.x < this->Columns.Count)
+			undermouseIndex.y < this->RowCount() && undermouseIndex.x < this->Columns.Count)
 		{
 			if (this->Columns[undermouseIndex.x].Type == ColumnType::Button)
 				return CursorKind::Hand;
@@ -212,7 +218,7 @@ CursorKind GridView::QueryCursor(int xof, int yof)
 	}
 
 	// 检查是否在新行区域
-	if (this->AllowUserToAddRows)
+	if (this->NewRowEnabled())
 	{
 		int newRowCol = -1;
 		if (HitTestNewRow(xof, yof, newRowCol) >= 0 && newRowCol >= 0)
@@ -225,91 +231,481 @@ CursorKind GridView::QueryCursor(int xof, int yof)
 }
 GridViewRow& GridView::operator[](int idx)
 {
-	return Rows[idx];
+	if (this->IsVirtualMode()) return this->GetRow(idx);
+	return this->Rows[idx];
+}
+GET_CPP(GridView, int, SelectedRowIndex)
+{
+	if (this->_selectedViewRow < 0 || this->_selectedViewRow >= this->RowCount()) return -1;
+	return GetModelRowIndex(this->_selectedViewRow);
+}
+SET_CPP(GridView, int, SelectedRowIndex)
+{
+	const int viewRow = GetViewRowIndex(value);
+	if (viewRow == this->_selectedViewRow) return;
+	this->_selectedViewRow = viewRow;
+	this->PostRender();
 }
 GridViewRow& GridView::SelectedRow()
 {
 	static GridViewRow default_;
-	if (this->SelectedRowIndex >= 0 && this->SelectedRowIndex < this->Rows.Count)
+	if (this->_selectedViewRow >= 0 && this->_selectedViewRow < this->RowCount())
 	{
-		return this->Rows[this->SelectedRowIndex];
+		return this->GetRow(this->_selectedViewRow);
 	}
 	return default_;
 }
 std::wstring& GridView::SelectedValue()
 {
 	static std::wstring default_;
-	if (this->SelectedRowIndex >= 0 && this->SelectedRowIndex < this->Rows.Count)
+	if (this->_selectedViewRow >= 0 && this->_selectedViewRow < this->RowCount())
 	{
-		return this->Rows[this->SelectedRowIndex].Cells[SelectedColumnIndex].Text;
+		return this->GetRow(this->_selectedViewRow).Cells[SelectedColumnIndex].Text;
 	}
 	return default_;
 }
 void GridView::Clear()
 {
+	CancelAutoSize();
 	this->Rows.Clear();
+	this->_sortKeys.clear();
+	this->SortedColumnIndex = -1;
+	this->_filters.clear();
+	this->_filterIndexes.clear();
+	this->_filterActive = false;
+	this->_filterMask.clear();
+	this->_visibleRows.clear();
+	MarkRowsSynced();
+	this->_rowCache.Clear();
 	this->ScrollYOffset = 0.0f;
 	this->ScrollRowPosition = 0;
 }
 
-static int CompareWStringDefault(const std::wstring& a, const std::wstring& b)
+static GridSortKey MakeCellSortKey(const GridViewRow& row, int col)
 {
-	if (a == b) return 0;
-	return (a < b) ? -1 : 1;
+	if ((size_t)col >= row.Cells.size()) return GridSortKey();
+	const CellValue& v = row.Cells.data()[col];
+	if (!v.Text.empty()) return GridSort::MakeKey(v.Text.c_str(), v.Text.size());
+	// Check/ComboBox 等无文本的单元格按 Tag 排序
+	return GridSort::MakeNumberKey((double)v.Tag);
 }
 
-static std::wstring CellToStringDefault(const CellValue* v)
+void GridView::SortByColumn(int col, bool ascending)
 {
-	if (!v) return L"";
-	if (!v->Text.empty()) return v->Text;
-	return std::to_wstring((__int64)v->Tag);
+	GridViewSortKey key;
+	key.Column = col;
+	key.Ascending = ascending;
+	SortByColumns({ key });
 }
 
-void GridView::SortByColumn(int col, bool ascending)
+void GridView::SortByColumns(const std::vector<GridViewSortKey>& keys)
 {
-	if (col < 0 || col >= this->Columns.Count) return;
-	if (this->Rows.Count <= 1) return;
+	std::vector<GridViewSortKey> valid;
+	for (const auto& k : keys)
+	{
+		if (k.Column >= 0 && k.Column < this->Columns.Count)
+			valid.push_back(k);
+	}
+	if (valid.empty()) return;
+	if (this->RowCount() <= 1) return;
 
-	if (this->Editing)
+	StopEditingForViewChange();
+	// 排序前后保持选中同一行（按 Rows 索引）
+	const int selectedModel = this->SelectedRowIndex;
+
+	if (this->IsVirtualMode())
 	{
-		SaveCurrentEditingCell(true);
-		this->Editing = false;
-		this->EditingColumnIndex = -1;
-		this->EditingRowIndex = -1;
-		this->EditingText.clear();
-		this->EditingOriginalText.clear();
-		this->EditSelectionStart = this->EditSelectionEnd = 0;
-		this->EditOffsetX = 0.0f;
+		if (!this->_dataSource->SortByColumns(valid)) return;
+		this->InvalidateRows();
 	}
+	else
+	{
+		const int n = this->Rows.Count;
+		// Rows 已按上一次排序的顺序排列，相等的行保持原先后
+		std::vector<int> order((size_t)n);
+		for (int i = 0; i < n; i++) order[(size_t)i] = i;
 
-	const auto sortFunc = this->Columns[col].SortFunc;
-	std::stable_sort(this->Rows.begin(), this->Rows.end(),
-		[&](const GridViewRow& a, const GridViewRow& b) -> bool
+		// 每列只提取一次排序键（文本指针指向 Rows 中的字符串，排序期间不修改 Rows）
+		bool hasSortFunc = false;
+		std::vector<std::vector<GridSortKey>> columnKeys(valid.size());
+		for (size_t k = 0; k < valid.size(); k++)
 		{
-			const int aCount = (int)a.Cells.size();
-			const int bCount = (int)b.Cells.size();
-			const CellValue* av = (aCount > col) ? (a.Cells.data() + col) : nullptr;
-			const CellValue* bv = (bCount > col) ? (b.Cells.data() + col) : nullptr;
+			const int col = valid[k].Column;
+			if (this->Columns[col].SortFunc)
+			{
+				hasSortFunc = true;
+				continue;
+			}
+			auto& out = columnKeys[k];
+			out.resize((size_t)n);
+			GridSort::ParallelFor((size_t)n, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+						out[i] = MakeCellSortKey(this->Rows[(int)i], col);
+				});
+		}
 
-			int cmp = 0;
-			if (sortFunc)
+		auto less = [&](int a, int b) -> bool
 			{
-				static CellValue empty;
-				cmp = sortFunc(av ? *av : empty, bv ? *bv : empty);
+				for (size_t k = 0; k < valid.size(); k++)
+				{
+					const int col = valid[k].Column;
+					int cmp = 0;
+					const auto& sortFunc = this->Columns[col].SortFunc;
+					if (sortFunc)
+					{
+						static CellValue empty;
+						const GridViewRow& ra = this->Rows[a];
+						const GridViewRow& rb = this->Rows[b];
+						cmp = sortFunc((size_t)col < ra.Cells.size() ? ra.Cells.data()[col] : empty,
+							(size_t)col < rb.Cells.size() ? rb.Cells.data()[col] : empty);
+					}
+					else
+					{
+						cmp = GridSort::Compare(columnKeys[k][(size_t)a], columnKeys[k][(size_t)b]);
+					}
+					if (cmp != 0)
+						return valid[k].Ascending ? cmp < 0 : cmp > 0;
+				}
+				return false;
+			};
+		// SortFunc 不保证线程安全，只在当前线程调用
+		if (hasSortFunc)
+			std::stable_sort(order.begin(), order.end(), less);
+		else
+			GridSort::ParallelStableSort(order, less);
+
+		// 一次性按排列移动 Rows（不经 GridRowList 的方法，不计为结构修改），筛选结果随行移动
+		GridSort::ApplyOrder(this->Rows, order);
+		if (this->_filterActive && this->_filterMask.size() == (size_t)n)
+		{
+			std::vector<uint8_t> mask((size_t)n);
+			for (int i = 0; i < n; i++)
+				mask[(size_t)i] = this->_filterMask[(size_t)order[(size_t)i]];
+			this->_filterMask.swap(mask);
+		}
+		RebuildFilterIndexes();
+		RebuildVisibleRows();
+		int selectedRow = -1;
+		if (selectedModel >= 0)
+		{
+			auto it = std::find(order.begin(), order.end(), selectedModel);
+			if (it != order.end()) selectedRow = (int)(it - order.begin());
+		}
+		this->_selectedViewRow = GetViewRowIndex(selectedRow);
+	}
+
+	this->_sortKeys = valid;
+	this->SortedColumnIndex = valid[0].Column;
+	this->SortAscending = valid[0].Ascending;
+	this->PostRender();
+}
+
+void GridView::ClearSort()
+{
+	ClearSortState();
+	this->PostRender();
+}
+
+void GridView::ClearSortState()
+{
+	this->_sortKeys.clear();
+	this->SortedColumnIndex = -1;
+}
+
+const std::vector<GridViewSortKey>& GridView::GetSortKeys()
+{
+	if (!this->IsVirtualMode()) SyncViewRows();
+	return this->_sortKeys;
+}
+
+void GridView::NotifyCellChanged(int row, int col)
+{
+	if (this->IsVirtualMode() || row < 0 || row >= this->Rows.Count) return;
+	SyncViewRows();
+	// 排序列的值改变后该行可能不在正确位置
+	for (const auto& key : this->_sortKeys)
+	{
+		if (key.Column == col)
+		{
+			ClearSortState();
+			break;
+		}
+	}
+	auto index = this->_filterIndexes.find(col);
+	if (index != this->_filterIndexes.end())
+		index->second.Touch(row);
+	this->PostRender();
+}
+
+void GridView::StopEditingForViewChange()
+{
+	// 排序/筛选后显示行索引改变，先提交正在编辑的单元格
+	if (!this->Editing) return;
+	SaveCurrentEditingCell(true);
+	this->Editing = false;
+	this->EditingColumnIndex = -1;
+	this->EditingRowIndex = -1;
+	this->EditingText.clear();
+	this->EditingOriginalText.clear();
+	this->EditSelectionStart = this->EditSelectionEnd = 0;
+	this->EditOffsetX = 0.0f;
+}
+
+void GridView::MarkRowsSynced()
+{
+	this->_syncedRowsVersion = this->Rows.Version();
+	this->_syncedReorderVersion = this->Rows.ReorderVersion();
+	this->_syncedRowCount = this->Rows.Count;
+}
+
+void GridView::SyncViewRows()
+{
+	const int n = this->Rows.Count;
+	if (this->Rows.Version() == this->_syncedRowsVersion && n == this->_syncedRowCount) return;
+	// 只在末尾追加了行：已有行的位置不变
+	const bool appended = this->Rows.ReorderVersion() == this->_syncedReorderVersion && n >= this->_syncedRowCount;
+	MarkRowsSynced();
+	// 增删或移动行之后 Rows 不再保证有序（追加的行也不在排序位置上）
+	ClearSortState();
+	if (appended && (!this->_filterActive || this->_filterMask.size() <= (size_t)n))
+	{
+		// 文本索引不含新行，ApplyFilter 会把它们当作候选；筛选结果只需补上新行
+		if (!this->_filterActive) return;
+		for (int r = (int)this->_filterMask.size(); r < n; r++)
+		{
+			const bool pass = RowPassesFilter(r);
+			this->_filterMask.push_back(pass ? 1 : 0);
+			if (pass) this->_visibleRows.push_back(r);
+		}
+		return;
+	}
+	// 已有行被移动、替换或删除：文本索引与筛选结果按行号记录，全部重建
+	RebuildFilterIndexes();
+	if (this->_filterActive)
+	{
+		this->_filterActive = false;
+		this->_filterMask.clear();
+		this->_visibleRows.clear();
+		ApplyFilter(false);
+	}
+}
+
+int GridView::GetModelRowIndex(int viewRow)
+{
+	if (this->IsVirtualMode()) return viewRow;
+	SyncViewRows();
+	if (!this->_filterActive || viewRow < 0 || (size_t)viewRow >= this->_visibleRows.size()) return viewRow;
+	return this->_visibleRows[(size_t)viewRow];
+}
+
+int GridView::GetViewRowIndex(int modelRow)
+{
+	if (modelRow < 0) return -1;
+	if (this->IsVirtualMode()) return modelRow < this->RowCount() ? modelRow : -1;
+	SyncViewRows();
+	if (modelRow >= this->Rows.Count) return -1;
+	if (!this->_filterActive) return modelRow;
+	if (!this->_filterMask[(size_t)modelRow]) return -1;
+	// 可见行映射只存正向；选中行的换算不在热路径上，线性查找即可
+	auto it = std::find(this->_visibleRows.begin(), this->_visibleRows.end(), modelRow);
+	return (int)(it - this->_visibleRows.begin());
+}
+
+bool GridView::RowPassesFilter(int modelRow)
+{
+	static CellValue empty;
+	GridViewRow& row = this->Rows[modelRow];
+	for (const auto& f : this->_filters)
+	{
+		const int col = f.first;
+		const CellValue& cell = (size_t)col < row.Cells.size() ? row.Cells[col] : empty;
+		if (f.second.Predicate && !f.second.Predicate(cell)) return false;
+		if (!f.second.Text.empty() && !GridTextIndex::ContainsFolded(cell.Text.c_str(), cell.Text.size(), f.second.Text))
+			return false;
+	}
+	return true;
+}
+
+void GridView::RebuildVisibleRows()
+{
+	this->_visibleRows.clear();
+	if (!this->_filterActive) return;
+	const int n = (int)this->_filterMask.size();
+	for (int r = 0; r < n; r++)
+		if (this->_filterMask[(size_t)r]) this->_visibleRows.push_back(r);
+}
+
+void GridView::ApplyFilter(bool narrows)
+{
+	if (this->IsVirtualMode()) return;
+	SyncViewRows();
+	StopEditingForViewChange();
+
+	// 筛选前后保持选中同一行（按 Rows 索引）
+	const int selectedModel = this->SelectedRowIndex;
+
+	const int n = this->Rows.Count;
+	if (this->_filters.empty())
+	{
+		this->_filterActive = false;
+		this->_filterMask.clear();
+		this->_visibleRows.clear();
+	}
+	else
+	{
+		// 候选行：继续输入时为当前结果，有索引时为索引命中；取较小者
+		std::vector<int> candidates;
+		bool useCandidates = false;
+		if (narrows && this->_filterActive && this->_filterMask.size() == (size_t)n)
+		{
+			for (int r = 0; r < n; r++)
+				if (this->_filterMask[(size_t)r]) candidates.push_back(r);
+			useCandidates = true;
+		}
+		std::vector<int> hits;
+		for (const auto& f : this->_filters)
+		{
+			auto it = this->_filterIndexes.find(f.first);
+			if (it == this->_filterIndexes.end() || it->second.RowCount() > n) continue;
+			if (!it->second.Candidates(f.second.Text, hits)) continue;
+			// 建立索引之后追加的行不在索引中
+			for (int r = it->second.RowCount(); r < n; r++)
+				hits.push_back(r);
+			if (!useCandidates || hits.size() < candidates.size())
+			{
+				candidates.swap(hits);
+				useCandidates = true;
 			}
+		}
+
+		std::vector<uint8_t> mask((size_t)n, 0);
+		const size_t count = useCandidates ? candidates.size() : (size_t)n;
+		auto test = [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					const int r = useCandidates ? candidates[i] : (int)i;
+					mask[(size_t)r] = RowPassesFilter(r) ? 1 : 0;
+				}
+			};
+		// 自定义谓词不保证线程安全，只在当前线程调用
+		bool hasPredicate = false;
+		for (const auto& f : this->_filters)
+			hasPredicate |= (bool)f.second.Predicate;
+		if (hasPredicate)
+			test(0, count);
+		else
+			GridSort::ParallelFor(count, test);
+
+		this->_filterMask.swap(mask);
+		this->_filterActive = true;
+		RebuildVisibleRows();
+	}
+
+	this->_selectedViewRow = GetViewRowIndex(selectedModel);
+	this->UnderMouseRowIndex = -1;
+	this->PostRender();
+}
+
+void GridView::SetColumnFilterText(int col, const std::wstring& text)
+{
+	if (col < 0 || col >= this->Columns.Count || this->IsVirtualMode()) return;
+	const std::wstring folded = GridTextIndex::Fold(text);
+	auto it = this->_filters.find(col);
+	const std::wstring previous = it != this->_filters.end() ? it->second.Text : std::wstring();
+	if (folded == previous && (this->_filterActive || folded.empty())) return;
+
+	// 新文本包含旧文本时，结果只会更少
+	const bool narrows = !previous.empty() && folded.find(previous) != std::wstring::npos;
+	if (folded.empty())
+	{
+		if (it != this->_filters.end())
+		{
+			if (it->second.Predicate)
+				it->second.Text.clear();
 			else
+				this->_filters.erase(it);
+		}
+	}
+	else
+	{
+		this->_filters[col].Text = folded;
+	}
+	ApplyFilter(narrows);
+}
+
+void GridView::SetColumnFilter(int col, std::function<bool(const CellValue&)> predicate, bool narrows)
+{
+	if (col < 0 || col >= this->Columns.Count || this->IsVirtualMode()) return;
+	if (predicate)
+	{
+		this->_filters[col].Predicate = std::move(predicate);
+	}
+	else
+	{
+		auto it = this->_filters.find(col);
+		if (it == this->_filters.end()) return;
+		if (it->second.Text.empty())
+			this->_filters.erase(it);
+		else
+			it->second.Predicate = nullptr;
+		narrows = false;
+	}
+	ApplyFilter(narrows);
+}
+
+void GridView::ClearFilters()
+{
+	if (this->_filters.empty() && !this->_filterActive) return;
+	this->_filters.clear();
+	ApplyFilter(false);
+}
+
+void GridView::RefreshFilter()
+{
+	if (!this->_filterActive) return;
+	ApplyFilter(false);
+}
+
+void GridView::BuildFilterIndex(int col)
+{
+	if (col < 0 || col >= this->Columns.Count || this->IsVirtualMode()) return;
+	SyncViewRows();
+	this->_filterIndexes[col].Build(this->Rows.Count, [&](int r, const wchar_t*& text, size_t& len)
+		{
+			GridViewRow& row = this->Rows[r];
+			if ((size_t)col < row.Cells.size())
 			{
-				cmp = CompareWStringDefault(CellToStringDefault(av), CellToStringDefault(bv));
+				text = row.Cells[col].Text.c_str();
+				len = row.Cells[col].Text.size();
+			}
+			else
+			{
+				text = nullptr;
+				len = 0;
 			}
-
-			if (ascending)
-				return cmp < 0;
-			return cmp > 0;
 		});
+}
 
-	this->SortedColumnIndex = col;
-	this->SortAscending = ascending;
-	this->PostRender();
+void GridView::DropFilterIndex(int col)
+{
+	this->_filterIndexes.erase(col);
+}
+
+void GridView::RebuildFilterIndexes()
+{
+	// 索引按行号记录，行移动后按新位置重建
+	std::vector<int> cols;
+	for (const auto& index : this->_filterIndexes)
+		cols.push_back(index.first);
+	for (int col : cols)
+	{
+		if (col < this->Columns.Count)
+			BuildFilterIndex(col);
+		else
+			this->_filterIndexes.erase(col);
+	}
 }
 #pragma region _GridView_
 POINT GridView::GetGridViewUnderMouseItem(int x, int y, GridView* ct)
@@ -355,7 +751,7 @@ POINT GridView::GetGridViewUnderMouseItem(int x, int y, GridView* ct)
 	if (virtualY >= 0.0f && row_height > 0.0f)
 	{
 		const int idx = (int)(virtualY / row_height);
-		if (idx >= 0 && idx < ct->Rows.Count) yindex = idx;
+		if (idx >= 0 && idx < ct->RowCount()) yindex = idx;
 	}
 	return { xindex,yindex };
 }
@@ -420,7 +816,7 @@ D2D1_RECT_F GridView::GetGridViewScrollBlockRect(GridView* ct)
 	float head_font_height = head_font->FontHeight;
 	float head_height = ct->HeadHeight == 0.0f ? head_font_height : ct->HeadHeight;
 	const float contentH = std::max(0.0f, _render_height - head_height);
-	const float totalH = (row_height > 0.0f) ? (row_height * (float)ct->Rows.Count) : 0.0f;
+	const float totalH = (row_height > 0.0f) ? (row_height * (float)ct->RowCount()) : 0.0f;
 	if (totalH > contentH && contentH > 0.0f)
 	{
 		float thumbH = _render_height * (contentH / totalH);
@@ -452,14 +848,14 @@ void GridView::DrawScroll()
 
 	auto l = this->CalcScrollLayout();
 
-	if (l.NeedV && this->Rows.Count > 0)
+	if (l.NeedV && this->RowCount() > 0)
 	{
 		float _render_width = l.RenderWidth;
 		float _render_height = l.RenderHeight;
 		const float row_height = this->GetRowHeightPx();
 		const float head_height = this->GetHeadHeightPx();
 		const float contentH = std::max(0.0f, _render_height - head_height);
-		const float totalH = (row_height > 0.0f) ? (row_height * (float)this->Rows.Count) : 0.0f;
+		const float totalH = (row_height > 0.0f) ? (row_height * (float)this->RowCount()) : 0.0f;
 		if (totalH > contentH && contentH > 0.0f)
 		{
 			float thumbH = _render_height * (contentH / totalH);
@@ -531,7 +927,7 @@ void GridView::SetScrollByPos(float yof)
 	const auto font = this->Font;
 	const auto size = this->ActualSize();
 
-	const int rowCount = this->Rows.Count;
+	const int rowCount = this->RowCount();
 	if (rowCount == 0) return;
 
 	auto l = this->CalcScrollLayout();
@@ -594,6 +990,9 @@ void GridView::SetHScrollByPos(float xof)
 
 void GridView::Update()
 {
+	// 后台自适应列宽完成后在 UI 线程应用，本帧即按新列宽绘制
+	if (this->_autoSizeJob && this->_autoSizeJob->Done)
+		ApplyAutoSizeResult();
 	if (this->IsVisual == false)return;
 	bool isUnderMouse = this->ParentForm->UnderMouse == this;
 	bool isSelected = this->ParentForm->Selected == this;
@@ -623,7 +1022,7 @@ void GridView::Update()
 			}
 			float text_top = (row_height - font_height) * 0.5f;
 			if (text_top < 0) text_top = 0;
-			if (this->Rows.Count <= 0)
+			if (this->RowCount() <= 0)
 			{
 				this->ScrollYOffset = 0.0f;
 				this->ScrollRowPosition = 0;
@@ -634,7 +1033,7 @@ void GridView::Update()
 				if (this->ScrollYOffset > l.MaxScrollY) this->ScrollYOffset = l.MaxScrollY;
 				this->ScrollRowPosition = (row_height > 0.0f) ? (int)std::floor(this->ScrollYOffset / row_height) : 0;
 				if (this->ScrollRowPosition < 0) this->ScrollRowPosition = 0;
-				if (this->ScrollRowPosition >= this->Rows.Count) this->ScrollRowPosition = this->Rows.Count - 1;
+				if (this->ScrollRowPosition >= this->RowCount()) this->ScrollRowPosition = this->RowCount() - 1;
 			}
 			if (this->ScrollXOffset < 0.0f) this->ScrollXOffset = 0.0f;
 			if (this->ScrollXOffset > l.MaxScrollX) this->ScrollXOffset = l.MaxScrollX;
@@ -681,10 +1080,15 @@ void GridView::Update()
 			}
 
 			const int maxRows = l.VisibleRows;
+			if (this->IsVirtualMode())
+			{
+				// 一次拉取整屏缺失的行；缓存至少容纳两屏，保证本帧取得的行引用不被淘汰
+				this->_rowCache.PrefetchScreen(s_y, maxRows);
+			}
 			i = 0;
-			for (int r = s_y; r < this->Rows.Count && i < maxRows; r++, i++)
+			for (int r = s_y; r < this->RowCount() && i < maxRows; r++, i++)
 			{
-				GridViewRow& row = this->Rows[r];
+				GridViewRow& row = this->GetRow(r);
 				float clipY = yf;
 				float clipH = row_height;
 				if (clipY < head_height)
@@ -723,7 +1127,7 @@ void GridView::Update()
 						{
 						case ColumnType::Text:
 						{
-							if (c == this->SelectedColumnIndex && r == this->SelectedRowIndex)
+							if (c == this->SelectedColumnIndex && r == this->_selectedViewRow)
 							{
 								if (this->Editing && this->EditingColumnIndex == c && this->EditingRowIndex == r && this->ParentForm->Selected == this)
 								{
@@ -878,7 +1282,7 @@ void GridView::Update()
 							D2D1_COLOR_F fore = this->ForeColor;
 							bool fill = false;
 
-							if (c == this->SelectedColumnIndex && r == this->SelectedRowIndex)
+							if (c == this->SelectedColumnIndex && r == this->_selectedViewRow)
 							{
 								back = this->SelectedItemBackColor;
 								border = this->SelectedItemForeColor;
@@ -1023,7 +1427,7 @@ void GridView::Update()
 			}
 			
 			// 渲染新行区域（如果启用）
-			if (this->AllowUserToAddRows && this->Columns.Count > 0)
+			if (this->NewRowEnabled() && this->Columns.Count > 0)
 			{
 				float newRowY = yf;
 				if (newRowY < head_height) newRowY = head_height;
@@ -1120,7 +1524,7 @@ void GridView::Update()
 
 bool GridView::IsNewRowArea(int x, int y)
 {
-	if (!this->AllowUserToAddRows) return false;
+	if (!this->NewRowEnabled()) return false;
 	if (this->Columns.Count <= 0) return false;
 
 	auto l = this->CalcScrollLayout();
@@ -1137,7 +1541,7 @@ bool GridView::IsNewRowArea(int x, int y)
 
 	// 计算新行区域的位置
 	const float rowHeight = this->GetRowHeightPx();
-	const float totalRowsHeight = rowHeight * (float)this->Rows.Count;
+	const float totalRowsHeight = rowHeight * (float)this->RowCount();
 	const float newRowY = headHeight + totalRowsHeight;
 
 	// 检查鼠标是否在新行区域内
@@ -1152,7 +1556,7 @@ bool GridView::IsNewRowArea(int x, int y)
 
 int GridView::HitTestNewRow(int x, int y, int& outColumnIndex)
 {
-	if (!this->AllowUserToAddRows) return -1;
+	if (!this->NewRowEnabled()) return -1;
 	if (this->Columns.Count <= 0) return -1;
 
 	auto l = this->CalcScrollLayout();
@@ -1163,7 +1567,7 @@ int GridView::HitTestNewRow(int x, int y, int& outColumnIndex)
 	if (y <= (int)headHeight) return -1;
 
 	const float rowHeight = this->GetRowHeightPx();
-	const float totalRowsHeight = rowHeight * (float)this->Rows.Count;
+	const float totalRowsHeight = rowHeight * (float)this->RowCount();
 	const float virtualY = ((float)y - headHeight) + this->ScrollYOffset;
 
 	// 检查是否在新行区域内
@@ -1178,7 +1582,7 @@ int GridView::HitTestNewRow(int x, int y, int& outColumnIndex)
 		if (virtualX >= acc && virtualX < acc + this->Columns[i].Width)
 		{
 			outColumnIndex = i;
-			return this->Rows.Count;  // 返回Rows.Count作为新行的索引
+			return this->RowCount();  // 返回Rows.Count作为新行的索引
 		}
 		acc += this->Columns[i].Width;
 	}
@@ -1188,7 +1592,7 @@ int GridView::HitTestNewRow(int x, int y, int& outColumnIndex)
 
 void GridView::AddNewRow()
 {
-	if (!this->AllowUserToAddRows) return;
+	if (!this->NewRowEnabled()) return;
 
 	// 创建新行
 	GridViewRow newRow;
@@ -1199,17 +1603,17 @@ void GridView::AddNewRow()
 	}
 	
 	// 添加到Rows列表
-	int newRowIndex = this->Rows.Count;
+	int newRowIndex = this->RowCount();
 	this->Rows.Add(newRow);
 
-	// 触发新行添加事件
+	// 触发新行添加事件（新行追加在 Rows 末尾且未筛选，显示索引与 Rows 索引相同）
 	this->OnUserAddedRow(this, newRowIndex);
 
 	// 自动选中新行的第一列并开始编辑
 	if (this->Columns.Count > 0)
 	{
 		this->SelectedColumnIndex = 0;
-		this->SelectedRowIndex = newRowIndex;
+		this->_selectedViewRow = newRowIndex;
 		this->SelectionChanged(this);
 		StartEditingCell(0, newRowIndex);
 	}
@@ -1217,73 +1621,297 @@ void GridView::AddNewRow()
 	this->PostRender();
 }
 
+void GridView::SetDataSource(GridViewDataSource* source, int cacheRows)
+{
+	CloseComboBoxEditor();
+	this->Editing = false;
+	this->EditingColumnIndex = -1;
+	this->EditingRowIndex = -1;
+	this->EditingText.clear();
+	this->EditingOriginalText.clear();
+	this->EditSelectionStart = this->EditSelectionEnd = 0;
+	this->EditOffsetX = 0.0f;
+
+	this->_dataSource = source;
+	this->_rowCache.SetSource(source, (size_t)std::max(cacheRows, 1));
+	this->_selectedViewRow = -1;
+	this->UnderMouseRowIndex = -1;
+	this->SortedColumnIndex = -1;
+	this->_sortKeys.clear();
+	this->_filters.clear();
+	this->_filterIndexes.clear();
+	this->_filterActive = false;
+	this->_filterMask.clear();
+	this->_visibleRows.clear();
+	MarkRowsSynced();
+	this->ScrollYOffset = 0.0f;
+	this->ScrollRowPosition = 0;
+	this->InvalidateRows();
+}
+void GridView::InvalidateRows()
+{
+	this->_rowCache.Invalidate();
+	if (this->_selectedViewRow >= this->RowCount())
+		this->_selectedViewRow = -1;
+	this->PostRender();
+}
+void GridView::InvalidateRow(int row)
+{
+	if (this->_rowCache.InvalidateRow(row))
+		this->PostRender();
+}
+int GridView::RowCount()
+{
+	if (this->IsVirtualMode()) return this->_rowCache.RowCount();
+	SyncViewRows();
+	return this->_filterActive ? (int)this->_visibleRows.size() : this->Rows.Count;
+}
+GridViewRow& GridView::GetRow(int idx)
+{
+	if (!this->IsVirtualMode())
+		return this->Rows[GetModelRowIndex(idx)];
+
+	GridViewRow* row = this->_rowCache.Get(idx);
+	if (!row)
+	{
+		static GridViewRow empty;
+		empty.Cells.clear();
+		return empty;
+	}
+	return *row;
+}
+void GridView::CommitCell(int col, int row)
+{
+	if (!this->IsVirtualMode())
+	{
+		NotifyCellChanged(GetModelRowIndex(row), col);
+		return;
+	}
+	GridViewRow* cached = this->_rowCache.Peek(row);
+	if (!cached) return;
+	auto& cells = cached->Cells;
+	if (col < 0 || col >= cells.Count) return;
+	if (!this->_dataSource->SetCellValue(row, col, cells[col]))
+		this->InvalidateRow(row);
+}
 void GridView::ReSizeRows(int count)
 {
 	if (count < 0) count = 0;
 	this->Rows.resize((size_t)count);
 }
-void GridView::AutoSizeColumn(int col)
+struct GridView::AutoSizeJob
 {
-	if (this->Columns.Count > col)
+	struct Column
 	{
-		auto font = this->Font;
-		float font_height = font->FontHeight;
-		float row_height = font_height + 2.0f;
+		int Index = -1;
+		std::vector<std::wstring> Texts;
+		// 已命中缓存的宽度，测量结果追加在后面
+		std::vector<float> Widths;
+		float Width = 0.0f;
+		bool Fixed = false;
+	};
+	GridAutoSizeOptions Options;
+	IDWriteTextFormat* Format = NULL;
+	std::shared_ptr<TextWidthCache> Cache;
+	HWND Notify = NULL;
+	std::vector<Column> Columns;
+	std::atomic<bool> Cancel{ false };
+	std::atomic<bool> Done{ false };
+	~AutoSizeJob()
+	{
+		if (this->Format) this->Format->Release();
+	}
+};
+
+static float MeasureTextWidth(IDWriteTextFormat* format, const wchar_t* text, size_t len)
+{
+	if (!format || len == 0) return 0.0f;
+	IDWriteTextLayout* layout = NULL;
+	HRESULT hr = _DWriteFactory->CreateTextLayout(text, (UINT32)len, format, FLT_MAX, FLT_MAX, &layout);
+	if (FAILED(hr) || !layout) return 0.0f;
+	DWRITE_TEXT_METRICS metrics{};
+	hr = layout->GetMetrics(&metrics);
+	layout->Release();
+	return SUCCEEDED(hr) ? (float)std::ceil(metrics.widthIncludingTrailingWhitespace) : 0.0f;
+}
+
+// 测量 texts 并追加到 widths（共享工厂下 DirectWrite 可多线程使用）
+static void MeasureTexts(IDWriteTextFormat* format, TextWidthCache& cache, const std::vector<std::wstring>& texts,
+	std::vector<float>& widths, const std::atomic<bool>* cancel)
+{
+	const size_t base = widths.size();
+	widths.resize(base + texts.size(), 0.0f);
+	auto measure = [format](const wchar_t* text, size_t len) { return MeasureTextWidth(format, text, len); };
+	GridSort::ParallelFor(texts.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				if (cancel && cancel->load(std::memory_order_relaxed)) return;
+				widths[base + i] = cache.Get(texts[i].c_str(), texts[i].size(), measure);
+			}
+		});
+}
+
+bool GridView::CollectAutoSizeTexts(int col, const GridAutoSizeOptions& options, TextWidthCache& cache,
+	std::vector<std::wstring>& texts, std::vector<float>& widths, float& fixedWidth)
+{
+	texts.clear();
+	widths.clear();
+	auto& column = this->Columns[col];
+	int firstRow = 0;
+	int endRow = this->RowCount();
+	if (this->IsVirtualMode())
+	{
+		// 虚拟模式下逐行拉取全部数据代价过高，只按当前可见窗口计算
+		firstRow = this->ScrollRowPosition;
+		endRow = std::min(endRow, firstRow + this->CalcScrollLayout().VisibleRows);
+	}
+	if (endRow <= firstRow)
+	{
+		fixedWidth = options.MinWidth;
+		return false;
+	}
+	if (column.Type != ColumnType::Text &&
+		column.Type != ColumnType::Button &&
+		column.Type != ColumnType::ComboBox)
+	{
+		float row_height = this->Font->FontHeight + 2.0f;
 		if (RowHeight != 0.0f)
 		{
 			row_height = RowHeight;
 		}
-		auto& column = this->Columns[col];
-		column.Width = 10.0f;
-		for (int i = 0; i < this->Rows.Count; i++)
+		fixedWidth = row_height;
+		return false;
+	}
+	// Button列使用列的ButtonText来计算宽度
+	if (column.Type == ColumnType::Button && !column.ButtonText.empty())
+	{
+		texts.push_back(column.ButtonText);
+		return true;
+	}
+
+	std::vector<uint32_t> lengths((size_t)(endRow - firstRow), 0);
+	for (int i = firstRow; i < endRow; i++)
+	{
+		auto& r = this->GetRow(i);
+		if (r.Cells.Count > col)
+			lengths[(size_t)(i - firstRow)] = (uint32_t)r.Cells[col].Text.size();
+	}
+	std::vector<int> picked;
+	ColumnAutoSize::PickRows(lengths, options, picked);
+	for (int i : picked)
+	{
+		auto& r = this->GetRow(firstRow + i);
+		if (r.Cells.Count <= col) continue;
+		const std::wstring& text = r.Cells[col].Text;
+		float width = 0.0f;
+		if (cache.TryGet(TextWidthCache::Hash(text.c_str(), text.size()), width))
+			widths.push_back(width);
+		else
+			texts.push_back(text);
+	}
+	return true;
+}
+
+void GridView::AutoSizeColumn(int col)
+{
+	AutoSizeColumn(col, GridAutoSizeOptions());
+}
+
+void GridView::AutoSizeColumn(int col, const GridAutoSizeOptions& options)
+{
+	if (col < 0 || col >= this->Columns.Count) return;
+	auto font = this->Font;
+	auto cache = TextWidthCache::ForFont(font->FontName, font->FontSize);
+	std::vector<std::wstring> texts;
+	std::vector<float> widths;
+	float fixedWidth = 0.0f;
+	if (!CollectAutoSizeTexts(col, options, *cache, texts, widths, fixedWidth))
+	{
+		this->Columns[col].Width = fixedWidth;
+		return;
+	}
+	MeasureTexts(font->FontObject, *cache, texts, widths, NULL);
+	this->Columns[col].Width = ColumnAutoSize::Reduce(widths, options);
+}
+
+void GridView::AutoSizeColumnsAsync(const GridAutoSizeOptions& options)
+{
+	CancelAutoSize();
+	auto font = this->Font;
+	if (!font || !font->FontObject) return;
+
+	auto job = std::make_shared<AutoSizeJob>();
+	job->Options = options;
+	job->Format = font->FontObject;
+	job->Format->AddRef();
+	job->Cache = TextWidthCache::ForFont(font->FontName, font->FontSize);
+	job->Notify = this->ParentForm ? this->ParentForm->Handle : NULL;
+	// 在 UI 线程复制待测文本，后台线程不访问 Rows
+	for (int col = 0; col < this->Columns.Count; col++)
+	{
+		AutoSizeJob::Column c;
+		c.Index = col;
+		c.Fixed = !CollectAutoSizeTexts(col, options, *job->Cache, c.Texts, c.Widths, c.Width);
+		job->Columns.push_back(std::move(c));
+	}
+	this->_autoSizeJob = job;
+
+	// 任务对象由后台线程共同持有，取消时 GridView 只放弃引用
+	std::thread([job]()
 		{
-			auto& r = this->Rows[i];
-			if (r.Cells.Count > col)
+			for (auto& c : job->Columns)
 			{
-				if (this->Columns[col].Type == ColumnType::Text ||
-					this->Columns[col].Type == ColumnType::Button ||
-					this->Columns[col].Type == ColumnType::ComboBox)
-				{
-					// Button列使用列的ButtonText来计算宽度
-					std::wstring textToMeasure;
-					if (this->Columns[col].Type == ColumnType::Button && !this->Columns[col].ButtonText.empty())
-					{
-						textToMeasure = this->Columns[col].ButtonText;
-					}
-					else
-					{
-						textToMeasure = r.Cells[col].Text;
-					}
-					auto width = font->GetTextSize(textToMeasure.c_str()).width;
-					if (column.Width < width)
-					{
-						column.Width = width;
-					}
-				}
-				else
-				{
-					column.Width = row_height;
-				}
+				if (job->Cancel) return;
+				if (c.Fixed) continue;
+				MeasureTexts(job->Format, *job->Cache, c.Texts, c.Widths, &job->Cancel);
+				c.Width = ColumnAutoSize::Reduce(c.Widths, job->Options);
+				c.Texts.clear();
+				c.Texts.shrink_to_fit();
 			}
-		}
+			if (job->Cancel) return;
+			job->Done = true;
+			if (job->Notify)
+				::InvalidateRect(job->Notify, NULL, FALSE);
+		}).detach();
+}
+
+void GridView::CancelAutoSize()
+{
+	if (!this->_autoSizeJob) return;
+	this->_autoSizeJob->Cancel = true;
+	this->_autoSizeJob.reset();
+}
+
+void GridView::ApplyAutoSizeResult()
+{
+	auto job = std::move(this->_autoSizeJob);
+	for (const auto& c : job->Columns)
+	{
+		if (c.Index < this->Columns.Count)
+			this->Columns[c.Index].Width = c.Width;
 	}
+	this->OnAutoSizeCompleted(this);
 }
+
 void GridView::ToggleCheckState(int col, int row)
 {
-	auto& cell = this->Rows[row].Cells[col];
+	auto& cell = this->GetRow(row).Cells[col];
 	cell.Tag = __int64(!cell.Tag);
-	this->OnGridViewCheckStateChanged(this, col, row, cell.Tag != 0);
+	const bool checked = cell.Tag != 0;
+	CommitCell(col, row);
+	this->OnGridViewCheckStateChanged(this, col, GetModelRowIndex(row), checked);
 }
 
 void GridView::EnsureComboBoxCellDefaultSelection(int col, int row)
 {
 	if (col < 0 || row < 0) return;
-	if (col >= this->Columns.Count || row >= this->Rows.Count) return;
+	if (col >= this->Columns.Count || row >= this->RowCount()) return;
 	if (this->Columns[col].Type != ColumnType::ComboBox) return;
 
 	auto& column = this->Columns[col];
 	if (column.ComboBoxItems.Count <= 0) return;
-	auto& rowObj = this->Rows[row];
+	auto& rowObj = this->GetRow(row);
 	if (rowObj.Cells.Count <= col)
 		rowObj.Cells.resize((size_t)col + 1);
 	auto& cell = rowObj.Cells[col];
@@ -1318,7 +1946,7 @@ void GridView::CloseComboBoxEditor()
 void GridView::ToggleComboBoxEditor(int col, int row)
 {
 	if (col < 0 || row < 0) return;
-	if (col >= this->Columns.Count || row >= this->Rows.Count) return;
+	if (col >= this->Columns.Count || row >= this->RowCount()) return;
 	if (!this->ParentForm) return;
 	if (this->Columns[col].Type != ColumnType::ComboBox) return;
 
@@ -1351,7 +1979,7 @@ void GridView::ToggleComboBoxEditor(int col, int row)
 	}
 
 	this->SelectedColumnIndex = col;
-	this->SelectedRowIndex = row;
+	this->_selectedViewRow = row;
 	this->SelectionChanged(this);
 
 	if (!this->_cellComboBox)
@@ -1369,7 +1997,7 @@ void GridView::ToggleComboBoxEditor(int col, int row)
 	const int h = (int)std::round(cellLocal.bottom - cellLocal.top);
 
 	auto& column = this->Columns[col];
-	auto& rowObj = this->Rows[row];
+	auto& rowObj = this->GetRow(row);
 	if (rowObj.Cells.Count <= col)
 		rowObj.Cells.resize((size_t)col + 1);
 	auto& cell = rowObj.Cells[col];
@@ -1396,7 +2024,7 @@ void GridView::ToggleComboBoxEditor(int col, int row)
 	{
 		(void)sender;
 		if (col < 0 || row < 0) return;
-		if (col >= this->Columns.Count || row >= this->Rows.Count) return;
+		if (col >= this->Columns.Count || row >= this->RowCount()) return;
 		if (this->Columns[col].Type != ColumnType::ComboBox) return;
 		auto& column2 = this->Columns[col];
 		if (!this->_cellComboBox) return;
@@ -1404,10 +2032,11 @@ void GridView::ToggleComboBoxEditor(int col, int row)
 		int idx = this->_cellComboBox->SelectedIndex;
 		if (idx < 0) idx = 0;
 		if (idx >= column2.ComboBoxItems.Count) idx = column2.ComboBoxItems.Count - 1;
-		auto& cell2 = this->Rows[row].Cells[col];
+		auto& cell2 = this->GetRow(row).Cells[col];
 		cell2.Tag = (__int64)idx;
 		cell2.Text = column2.ComboBoxItems[idx];
-		this->OnGridViewComboBoxSelectionChanged(this, col, row, idx, cell2.Text);
+		CommitCell(col, row);
+		this->OnGridViewComboBoxSelectionChanged(this, col, GetModelRowIndex(row), idx, column2.ComboBoxItems[idx]);
 		this->PostRender();
 	};
 
@@ -1421,7 +2050,7 @@ void GridView::ToggleComboBoxEditor(int col, int row)
 void GridView::StartEditingCell(int col, int row)
 {
 	if (col < 0 || row < 0) return;
-	if (col >= this->Columns.Count || row >= this->Rows.Count) return;
+	if (col >= this->Columns.Count || row >= this->RowCount()) return;
 
 	if (this->Editing && (this->EditingColumnIndex != col || this->EditingRowIndex != row))
 	{
@@ -1429,7 +2058,7 @@ void GridView::StartEditingCell(int col, int row)
 	}
 
 	this->SelectedColumnIndex = col;
-	this->SelectedRowIndex = row;
+	this->_selectedViewRow = row;
 	this->SelectionChanged(this);
 
 	if (IsEditableTextCell(col, row))
@@ -1437,7 +2066,7 @@ void GridView::StartEditingCell(int col, int row)
 		this->Editing = true;
 		this->EditingColumnIndex = col;
 		this->EditingRowIndex = row;
-		this->EditingText = this->Rows[row].Cells[col].Text;
+		this->EditingText = this->GetRow(row).Cells[col].Text;
 		this->EditingOriginalText = this->EditingText;
 		this->EditSelectionStart = 0;
 		this->EditSelectionEnd = (int)this->EditingText.size();
@@ -1457,9 +2086,9 @@ void GridView::CancelEditing(bool revert)
 	if (this->Editing)
 	{
 		if (revert && this->EditingRowIndex >= 0 && this->EditingColumnIndex >= 0 &&
-			this->EditingRowIndex < this->Rows.Count && this->EditingColumnIndex < this->Columns.Count)
+			this->EditingRowIndex < this->RowCount() && this->EditingColumnIndex < this->Columns.Count)
 		{
-			this->Rows[this->EditingRowIndex].Cells[this->EditingColumnIndex].Text = this->EditingOriginalText;
+			this->GetRow(this->EditingRowIndex).Cells[this->EditingColumnIndex].Text = this->EditingOriginalText;
 		}
 		else
 		{
@@ -1475,16 +2104,17 @@ void GridView::CancelEditing(bool revert)
 	this->EditOffsetX = 0.0f;
 	this->ParentForm->Selected = this;
 	this->SelectedColumnIndex = -1;
-	this->SelectedRowIndex = -1;
+	this->_selectedViewRow = -1;
 }
 void GridView::SaveCurrentEditingCell(bool commit)
 {
 	if (!this->Editing) return;
 	if (!commit) return;
 	if (this->EditingColumnIndex < 0 || this->EditingRowIndex < 0) return;
-	if (this->EditingRowIndex >= this->Rows.Count) return;
+	if (this->EditingRowIndex >= this->RowCount()) return;
 	if (this->EditingColumnIndex >= this->Columns.Count) return;
-	this->Rows[this->EditingRowIndex].Cells[this->EditingColumnIndex].Text = this->EditingText;
+	this->GetRow(this->EditingRowIndex).Cells[this->EditingColumnIndex].Text = this->EditingText;
+	CommitCell(this->EditingColumnIndex, this->EditingRowIndex);
 }
 void GridView::AdjustScrollPosition()
 {
@@ -1492,13 +2122,13 @@ void GridView::AdjustScrollPosition()
 	const float rowH = this->GetRowHeightPx();
 	const float headH = this->GetHeadHeightPx();
 	const float contentH = std::max(0.0f, l.RenderHeight - headH);
-	const float totalH = (rowH > 0.0f) ? (rowH * (float)this->Rows.Count) : 0.0f;
+	const float totalH = (rowH > 0.0f) ? (rowH * (float)this->RowCount()) : 0.0f;
 	const float maxScrollY = std::max(0.0f, totalH - contentH);
 
-	if (this->SelectedRowIndex < 0 || this->SelectedRowIndex >= this->Rows.Count) return;
+	if (this->_selectedViewRow < 0 || this->_selectedViewRow >= this->RowCount()) return;
 	if (rowH <= 0.0f) return;
 
-	const float rowTop = rowH * (float)this->SelectedRowIndex;
+	const float rowTop = rowH * (float)this->_selectedViewRow;
 	const float rowBottom = rowTop + rowH;
 	const float viewTop = this->ScrollYOffset;
 	const float viewBottom = this->ScrollYOffset + contentH;
@@ -1665,7 +2295,7 @@ void GridView::HandleMouseMove(int xof, int yof)
 		this->UnderMouseRowIndex = undermouseIndex.y;
 
 		// 检查是否在新行区域
-		if (this->AllowUserToAddRows)
+		if (this->NewRowEnabled())
 		{
 			int newRowCol = -1;
 			int hitResult = HitTestNewRow(xof, yof, newRowCol);
@@ -1737,7 +2367,7 @@ void GridView::HandleLeftButtonDown(int xof, int yof)
 	{
 		CancelEditing(true);
 		this->InScroll = true;
-		if (this->Rows.Count > 0 && l.MaxScrollY > 0.0f && l.RenderHeight > 0.0f && l.ContentHeight > 0.0f)
+		if (this->RowCount() > 0 && l.MaxScrollY > 0.0f && l.RenderHeight > 0.0f && l.ContentHeight > 0.0f)
 		{
 			const float renderingHeight = l.RenderHeight;
 			const float totalHeight = l.TotalRowsHeight;
@@ -1784,10 +2414,31 @@ void GridView::HandleLeftButtonDown(int xof, int yof)
 		if (headCol >= 0)
 		{
 			CancelEditing(true);
-			bool ascending = true;
-			if (this->SortedColumnIndex == headCol)
-				ascending = !this->SortAscending;
-			SortByColumn(headCol, ascending);
+			if ((GetAsyncKeyState(VK_SHIFT) & 0x8000) && !this->GetSortKeys().empty())
+			{
+				// Shift+点击：追加次级排序列，已在排序键中则切换方向
+				auto keys = this->_sortKeys;
+				auto it = std::find_if(keys.begin(), keys.end(),
+					[&](const GridViewSortKey& k) { return k.Column == headCol; });
+				if (it != keys.end())
+				{
+					it->Ascending = !it->Ascending;
+				}
+				else
+				{
+					GridViewSortKey key;
+					key.Column = headCol;
+					keys.push_back(key);
+				}
+				SortByColumns(keys);
+			}
+			else
+			{
+				bool ascending = true;
+				if (this->SortedColumnIndex == headCol)
+					ascending = !this->SortAscending;
+				SortByColumn(headCol, ascending);
+			}
 
 			MouseEventArgs event_obj(MouseButtons::Left, 0, xof, yof, 0);
 			this->OnMouseDown(this, event_obj);
@@ -1796,7 +2447,7 @@ void GridView::HandleLeftButtonDown(int xof, int yof)
 
 		POINT undermouseIndex = GetGridViewUnderMouseItem(xof, yof, this);
 		if (undermouseIndex.y >= 0 && undermouseIndex.x >= 0 &&
-			undermouseIndex.y < this->Rows.Count && undermouseIndex.x < this->Columns.Count)
+			undermouseIndex.y < this->RowCount() && undermouseIndex.x < this->Columns.Count)
 		{
 			// Keep hover index in sync even if we didn't get a prior WM_MOUSEMOVE.
 			this->UnderMouseColumnIndex = undermouseIndex.x;
@@ -1809,7 +2460,7 @@ void GridView::HandleLeftButtonDown(int xof, int yof)
 				CloseComboBoxEditor();
 
 				this->SelectedColumnIndex = undermouseIndex.x;
-				this->SelectedRowIndex = undermouseIndex.y;
+				this->_selectedViewRow = undermouseIndex.y;
 				this->SelectionChanged(this);
 
 				this->_buttonMouseDown = true;
@@ -1848,7 +2499,7 @@ void GridView::HandleLeftButtonDown(int xof, int yof)
 		}
 
 		// 处理新行点击
-		if (this->AllowUserToAddRows && undermouseIndex.y < 0 && undermouseIndex.x >= 0)
+		if (this->NewRowEnabled() && undermouseIndex.y < 0 && undermouseIndex.x >= 0)
 		{
 			int newRowCol = -1;
 			int hitResult = HitTestNewRow(xof, yof, newRowCol);
@@ -1883,7 +2534,7 @@ void GridView::HandleLeftButtonUp(int xof, int yof)
 		POINT undermouseIndex = GetGridViewUnderMouseItem(xof, yof, this);
 		const bool hitSameCell = (undermouseIndex.x == this->_buttonDownColumnIndex && undermouseIndex.y == this->_buttonDownRowIndex);
 		const bool validCell = (undermouseIndex.x >= 0 && undermouseIndex.y >= 0 &&
-			undermouseIndex.x < this->Columns.Count && undermouseIndex.y < this->Rows.Count);
+			undermouseIndex.x < this->Columns.Count && undermouseIndex.y < this->RowCount());
 		const bool isButtonCell = validCell && (this->Columns[undermouseIndex.x].Type == ColumnType::Button);
 
 		this->_buttonMouseDown = false;
@@ -1898,7 +2549,7 @@ void GridView::HandleLeftButtonUp(int xof, int yof)
 
 		if (hitSameCell && isButtonCell)
 		{
-			this->OnGridViewButtonClick(this, undermouseIndex.x, undermouseIndex.y);
+			this->OnGridViewButtonClick(this, undermouseIndex.x, GetModelRowIndex(undermouseIndex.y));
 		}
 		this->PostRender();
 		return;
@@ -1927,9 +2578,9 @@ void GridView::HandleKeyDown(WPARAM wParam)
 		if (wParam == VK_RETURN)
 		{
 			SaveCurrentEditingCell(true);
-			if (this->SelectedRowIndex < this->Rows.Count - 1)
+			if (this->_selectedViewRow < this->RowCount() - 1)
 			{
-				int nextRow = this->SelectedRowIndex + 1;
+				int nextRow = this->_selectedViewRow + 1;
 				StartEditingCell(this->SelectedColumnIndex, nextRow);
 				this->EditSelectionStart = 0;
 				this->EditSelectionEnd = (int)this->EditingText.size();
@@ -2005,10 +2656,10 @@ void GridView::HandleKeyDown(WPARAM wParam)
 		if (SelectedColumnIndex > 0) SelectedColumnIndex--;
 		break;
 	case VK_DOWN:
-		if (SelectedRowIndex < this->Rows.Count - 1) SelectedRowIndex++;
+		if (_selectedViewRow < this->RowCount() - 1) _selectedViewRow++;
 		break;
 	case VK_UP:
-		if (SelectedRowIndex > 0) SelectedRowIndex--;
+		if (_selectedViewRow > 0) _selectedViewRow--;
 		break;
 	default:
 		break;
@@ -2031,11 +2682,11 @@ void GridView::HandleCharInput(WPARAM wParam)
 
 	if (!this->Editing)
 	{
-		if (ch >= 32 && ch <= 126 && this->SelectedColumnIndex >= 0 && this->SelectedRowIndex >= 0)
+		if (ch >= 32 && ch <= 126 && this->SelectedColumnIndex >= 0 && this->_selectedViewRow >= 0)
 		{
-			if (IsEditableTextCell(this->SelectedColumnIndex, this->SelectedRowIndex))
+			if (IsEditableTextCell(this->SelectedColumnIndex, this->_selectedViewRow))
 			{
-				StartEditingCell(this->SelectedColumnIndex, this->SelectedRowIndex);
+				StartEditingCell(this->SelectedColumnIndex, this->_selectedViewRow);
 				this->EditSelectionStart = this->EditSelectionEnd = 0;
 			}
 		}
@@ -2145,7 +2796,7 @@ void GridView::HandleCellClick(int col, int row)
 		if (this->Editing)
 			SaveCurrentEditingCell(true);
 		this->SelectedColumnIndex = col;
-		this->SelectedRowIndex = row;
+		this->_selectedViewRow = row;
 		this->SelectionChanged(this);
 	}
 	else if (this->Columns[col].Type == ColumnType::ComboBox)
@@ -2221,7 +2872,7 @@ float GridView::GetHeadHeightPx()
 bool GridView::TryGetCellRectLocal(int col, int row, D2D1_RECT_F& outRect)
 {
 	if (col < 0 || row < 0) return false;
-	if (col >= this->Columns.Count || row >= this->Rows.Count) return false;
+	if (col >= this->Columns.Count || row >= this->RowCount()) return false;
 
 	auto l = this->CalcScrollLayout();
 	float renderWidth = l.RenderWidth;
@@ -2253,7 +2904,7 @@ bool GridView::TryGetCellRectLocal(int col, int row, D2D1_RECT_F& outRect)
 bool GridView::IsEditableTextCell(int col, int row)
 {
 	if (col < 0 || row < 0) return false;
-	if (col >= this->Columns.Count || row >= this->Rows.Count) return false;
+	if (col >= this->Columns.Count || row >= this->RowCount()) return false;
 	return this->Columns[col].Type == ColumnType::Text && this->Columns[col].CanEdit;
 }
 void GridView::EditEnsureSelectionInRange()
@@ -2287,9 +2938,9 @@ void GridView::EditInputText(const std::wstring& input)
 	}
 
 	if (this->EditingRowIndex >= 0 && this->EditingColumnIndex >= 0 &&
-		this->EditingRowIndex < this->Rows.Count && this->EditingColumnIndex < this->Columns.Count)
+		this->EditingRowIndex < this->RowCount() && this->EditingColumnIndex < this->Columns.Count)
 	{
-		this->Rows[this->EditingRowIndex].Cells[this->EditingColumnIndex].Text = this->EditingText;
+		this->GetRow(this->EditingRowIndex).Cells[this->EditingColumnIndex].Text = this->EditingText;
 	}
 }
 void GridView::EditInputBack()
@@ -2312,9 +2963,9 @@ void GridView::EditInputBack()
 	}
 
 	if (this->EditingRowIndex >= 0 && this->EditingColumnIndex >= 0 &&
-		this->EditingRowIndex < this->Rows.Count && this->EditingColumnIndex < this->Columns.Count)
+		this->EditingRowIndex < this->RowCount() && this->EditingColumnIndex < this->Columns.Count)
 	{
-		this->Rows[this->EditingRowIndex].Cells[this->EditingColumnIndex].Text = this->EditingText;
+		this->GetRow(this->EditingRowIndex).Cells[this->EditingColumnIndex].Text = this->EditingText;
 	}
 }
 void GridView::EditInputDelete()
@@ -2337,9 +2988,9 @@ void GridView::EditInputDelete()
 	}
 
 	if (this->EditingRowIndex >= 0 && this->EditingColumnIndex >= 0 &&
-		this->EditingRowIndex < this->Rows.Count && this->EditingColumnIndex < this->Columns.Count)
+		this->EditingRowIndex < this->RowCount() && this->EditingColumnIndex < this->Columns.Count)
 	{
-		this->Rows[this->EditingRowIndex].Cells[this->EditingColumnIndex].Text = this->EditingText;
+		this->GetRow(this->EditingRowIndex).Cells[this->EditingColumnIndex].Text = this->EditingText;
 	}
 }
 void GridView::EditUpdateScroll(float cellWidth)
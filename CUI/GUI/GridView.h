@@ -1,11 +1,20 @@
 #pragma once
 #include "Control.h"
+#include "Grid/ColumnAutoSize.h"
+#include "Grid/GridRowCache.h"
+#include "Grid/GridRowList.h"
+#include "Grid/GridTextIndex.h"
+#include "Grid/TextWidthCache.h"
 #include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 #pragma comment(lib, "Imm32.lib")
 typedef Event<void(class GridView*, int c, int r, bool v) > OnGridViewCheckStateChangedEvent;
 typedef Event<void(class GridView*, int c, int r)> OnGridViewButtonClickEvent;
 typedef Event<void(class GridView*, int c, int r, int selectedIndex, std::wstring selectedText)> OnGridViewComboBoxSelectionChangedEvent;
 typedef Event<void(class GridView*, int newRowIndex)> OnGridViewUserAddedRowEvent;
+typedef Event<void(class GridView*)> OnGridViewAutoSizeCompletedEvent;
 enum class ColumnType
 {
 	Text,
@@ -22,8 +31,24 @@ enum class ColumnType
  * 特性概览：
  * - 多列类型：Text/Image/Check/Button/ComboBox
  * - 支持单元格编辑（文本/组合框）与按钮点击事件
- * - 支持列头点击排序（可为列配置 SortFunc）
+ * - 支持列头点击排序（可为列配置 SortFunc），Shift+点击追加次级排序列；
+ *   排序先对行索引排序，再一次性按结果移动 Rows，排序后按下标遍历 Rows 即为排序顺序
+ * - 支持按列筛选（文本子串/自定义谓词），只维护可见行映射，不改动 Rows；
+ *   文本列可建立 n-gram 索引加速子串筛选；Rows 发生结构修改后自动补筛追加的行，
+ *   其余修改（插入、删除、交换等）重建索引并重新筛选
+ *
+ * 行索引约定：
+ * - SelectedRowIndex、operator[] 与 OnGridViewCheckStateChanged/OnGridViewButtonClick/
+ *   OnGridViewComboBoxSelectionChanged/OnUserAddedRow 的行参数都是 Rows 索引，
+ *   排序/筛选后 grid->Rows[grid->SelectedRowIndex] 仍是选中的行
+ * - GetRow、RowCount、ScrollRowPosition、UnderMouseRowIndex 按显示顺序；
+ *   两者用 GetModelRowIndex / GetViewRowIndex 换算，未筛选时两种索引相同
+ * - 排序状态（GetSortKeys、SortedColumnIndex）在 Rows 发生结构修改或排序列的值被修改后清除
+ *   （Rows 不再保证有序）；代码直接改写单元格后应调用 NotifyCellChanged
+ * - 虚拟模式下排序由数据源完成，两种索引相同
  * - 支持平滑滚动（ScrollYOffset）与行级滚动（ScrollRowPosition）
+ * - 虚拟模式（SetDataSource）：行数与单元格由 GridViewDataSource 按需提供，
+ *   只拉取可见窗口内的行并保留一个小的 LRU 行缓存，适用于百万行级数据
  */
 
 class CellValue;
@@ -80,6 +105,55 @@ public:
 	List<CellValue> Cells = List<CellValue>();
 	CellValue& operator[](int idx);
 };
+/** @brief GridView 的行集合：增删、交换等结构修改会被记录（见 GridRowList）。 */
+typedef GridRowList<List<GridViewRow>> GridViewRowCollection;
+/** @brief 多列排序中的一个排序键。 */
+struct GridViewSortKey
+{
+	int Column = -1;
+	bool Ascending = true;
+};
+/**
+ * @brief GridView 虚拟模式的数据源。
+ *
+ * 表格只在需要显示/编辑某行时才拉取该行；所有方法都在 UI 线程调用。
+ * 数据发生变化（行数或内容）后应调用 GridView::InvalidateRows / InvalidateRow。
+ */
+class GridViewDataSource
+{
+public:
+	virtual ~GridViewDataSource() {}
+	/** @brief 总行数。 */
+	virtual int GetRowCount() = 0;
+	/**
+	 * @brief 填充 [firstRow, firstRow + count) 的行。
+	 * @param rows 长度为 count 的输出数组（每行 Cells 为空），按列顺序写入单元格。
+	 */
+	virtual void GetRows(int firstRow, int count, GridViewRow* rows) = 0;
+	/**
+	 * @brief 用户修改单元格（文本编辑、勾选、下拉选择）后回写。
+	 * @return false 表示不接受修改，该行缓存会被丢弃并重新拉取。
+	 */
+	virtual bool SetCellValue(int row, int col, const CellValue& value) { (void)row; (void)col; (void)value; return false; }
+	/**
+	 * @brief 列头点击排序时调用（排序由数据源完成）。
+	 * @return false 表示不支持排序。
+	 */
+	virtual bool Sort(int col, bool ascending) { (void)col; (void)ascending; return false; }
+	/**
+	 * @brief 多列排序（keys[0] 为主键）。
+	 *
+	 * 默认实现从最次要的键到主键依次调用 Sort，要求 Sort 是稳定排序。
+	 */
+	virtual bool SortByColumns(const std::vector<GridViewSortKey>& keys)
+	{
+		for (auto it = keys.rbegin(); it != keys.rend(); ++it)
+		{
+			if (!Sort(it->Column, it->Ascending)) return false;
+		}
+		return !keys.empty();
+	}
+};
 class GridView : public Control
 {
 public:
@@ -93,7 +167,8 @@ public:
 	bool InHScroll = false;
 	ScrollChangedEvent ScrollChanged;
 	List<GridViewColumn> Columns = List<GridViewColumn>();
-	List<GridViewRow> Rows = List<GridViewRow>();
+	GridViewRowCollection Rows;
+	/** @brief 按 Rows 索引取行（虚拟模式下为数据源行号），与 Rows[idx] 相同；按显示顺序取行用 GetRow。 */
 	GridViewRow& operator[](int idx);
 	float HeadHeight = 0.0f;
 	float RowHeight = 0.0f;
@@ -104,7 +179,10 @@ public:
 	float ScrollYOffset = 0.0f;
 	int ScrollRowPosition = 0;
 	int SelectedColumnIndex = -1;
-	int SelectedRowIndex = -1;
+	/** @brief 选中行在 Rows 中的索引（-1 表示未选中或选中行被筛选隐藏）；排序/筛选后仍指向同一行。 */
+	PROPERTY(int, SelectedRowIndex);
+	GET(int, SelectedRowIndex);
+	SET(int, SelectedRowIndex);
 	int SortedColumnIndex = -1;
 	bool SortAscending = true;
 	int UnderMouseColumnIndex = -1;
@@ -139,6 +217,8 @@ public:
 	OnGridViewButtonClickEvent OnGridViewButtonClick;
 	OnGridViewComboBoxSelectionChangedEvent OnGridViewComboBoxSelectionChanged;
 	OnGridViewUserAddedRowEvent OnUserAddedRow;
+	/** @brief AutoSizeColumnsAsync 完成并已应用列宽（在 UI 线程触发）。 */
+	OnGridViewAutoSizeCompletedEvent OnAutoSizeCompleted;
 	SelectionChangedEvent SelectionChanged;
 	float ScrollXOffset = 0.0f;
 	GridViewRow& SelectedRow();
@@ -151,7 +231,110 @@ public:
 	void ReSizeRows(int count);
 	/** @brief 按指定列排序。 */
 	void SortByColumn(int col, bool ascending = true);
+	/**
+	 * @brief 按多列排序（keys[0] 为主键，其余依次打破平局）。
+	 *
+	 * 每个单元格只解析一次排序键（数值/日期按数值比较），行数较多时多线程排序行索引；
+	 * 列配置了 SortFunc 时在当前线程调用 SortFunc 比较。
+	 */
+	void SortByColumns(const std::vector<GridViewSortKey>& keys);
+	/** @brief 当前排序键（未排序或排序已失效时为空）。 */
+	const std::vector<GridViewSortKey>& GetSortKeys();
+	/** @brief 清除排序标记与排序键（Rows 保持当前顺序）。 */
+	void ClearSort();
+	/**
+	 * @brief 代码直接改写 Rows[row].Cells[col] 后调用（表格内的编辑会自动调用）。
+	 *
+	 * 排序列的值改变时清除排序状态，并标记该列的筛选索引。
+	 */
+	void NotifyCellChanged(int row, int col);
+	/** @brief 显示行索引 -> Rows 中的索引（筛选后跳过隐藏的行）。 */
+	int GetModelRowIndex(int viewRow);
+	/** @brief Rows 中的索引 -> 显示行索引（被筛选隐藏或越界时为 -1；O(n)，不宜逐行调用）。 */
+	int GetViewRowIndex(int modelRow);
+	/**
+	 * @brief 设置列的文本筛选（不区分大小写的子串匹配，空串取消该列的文本筛选）。
+	 *
+	 * 新文本包含上一次的文本时（继续输入），只在当前结果中继续筛选。
+	 * 虚拟模式下无效（由数据源自行筛选）。
+	 */
+	void SetColumnFilterText(int col, const std::wstring& text);
+	/**
+	 * @brief 设置列的筛选谓词（NULL 取消）。
+	 * @param narrows 为 true 表示新谓词只会进一步缩小结果，只复查当前可见行。
+	 */
+	void SetColumnFilter(int col, std::function<bool(const CellValue&)> predicate, bool narrows = false);
+	/** @brief 取消全部筛选。 */
+	void ClearFilters();
+	/** @brief 是否处于筛选状态（此时 RowCount 为通过筛选的行数）。 */
+	bool IsFiltered() const { return this->_filterActive; }
+	/** @brief 按当前条件重新筛选（修改单元格内容后调用；Rows 的结构修改会自动处理）。 */
+	void RefreshFilter();
+	/**
+	 * @brief 为文本列建立 n-gram 索引，加速该列的 SetColumnFilterText。
+	 *
+	 * 通过表格编辑的单元格会自动标记，Rows 结构修改后自动重建；代码批量修改该列后应重新调用。
+	 */
+	void BuildFilterIndex(int col);
+	void DropFilterIndex(int col);
+	/**
+	 * @brief 设置虚拟模式数据源（传 NULL 退出虚拟模式，回到 Rows）。
+	 *
+	 * 虚拟模式下 Rows 不参与显示；不支持用户新增行（AllowUserToAddRows 无效）。
+	 * 切换数据源会清除排序与筛选状态。
+	 * 数据源的生命周期由调用方管理，须长于 GridView 或在销毁前置空。
+	 * @param cacheRows LRU 行缓存容量（实际容量至少为可见行数的两倍）。
+	 */
+	void SetDataSource(GridViewDataSource* source, int cacheRows = 256);
+	GridViewDataSource* GetDataSource() const { return this->_dataSource; }
+	bool IsVirtualMode() const { return this->_dataSource != NULL; }
+	/** @brief 数据源行数或内容整体变化后调用：重新读取行数并清空行缓存。 */
+	void InvalidateRows();
+	/** @brief 丢弃单行缓存（下次显示时重新拉取）。 */
+	void InvalidateRow(int row);
+	/** @brief 当前行数（虚拟模式下为数据源行数）。 */
+	int RowCount();
+	/** @brief 按显示顺序获取行（虚拟模式下按需从数据源拉取；引用在该行被淘汰前有效）。 */
+	GridViewRow& GetRow(int idx);
 private:
+	// 选中行的显示索引（对外的 SelectedRowIndex 是 Rows 索引）
+	int _selectedViewRow = -1;
+	GridViewDataSource* _dataSource = NULL;
+	// 虚拟模式的 LRU 行缓存（正在编辑的行不淘汰）
+	GridRowCache<GridViewRow, GridViewDataSource> _rowCache;
+	std::vector<GridViewSortKey> _sortKeys;
+	// 上一次 SyncViewRows 时 Rows 的版本与行数
+	uint64_t _syncedRowsVersion = 0;
+	uint64_t _syncedReorderVersion = 0;
+	int _syncedRowCount = 0;
+	struct ColumnFilter
+	{
+		// 已折叠大小写
+		std::wstring Text;
+		std::function<bool(const CellValue&)> Predicate;
+	};
+	std::unordered_map<int, ColumnFilter> _filters;
+	std::unordered_map<int, GridTextIndex> _filterIndexes;
+	bool _filterActive = false;
+	// Rows 索引 -> 是否通过筛选
+	std::vector<uint8_t> _filterMask;
+	// 显示行 -> Rows 索引（筛选后）
+	std::vector<int> _visibleRows;
+	void StopEditingForViewChange();
+	struct AutoSizeJob;
+	std::shared_ptr<AutoSizeJob> _autoSizeJob;
+	bool CollectAutoSizeTexts(int col, const GridAutoSizeOptions& options, TextWidthCache& cache,
+		std::vector<std::wstring>& texts, std::vector<float>& widths, float& fixedWidth);
+	void ApplyAutoSizeResult();
+	void SyncViewRows();
+	void MarkRowsSynced();
+	void ClearSortState();
+	void RebuildFilterIndexes();
+	void ApplyFilter(bool narrows);
+	bool RowPassesFilter(int modelRow);
+	void RebuildVisibleRows();
+	void CommitCell(int col, int row);
+	bool NewRowEnabled() { return this->AllowUserToAddRows && !this->IsVirtualMode() && !this->_filterActive; }
 	float _vScrollThumbGrabOffsetY = 0.0f;
 	float _hScrollThumbGrabOffsetX = 0.0f;
 	struct ScrollLayout
@@ -251,5 +434,21 @@ public:
 	void Update() override;
 	/** @brief 根据内容自动调整某列宽度。 */
 	void AutoSizeColumn(int col);
+	/**
+	 * @brief 按选项自动调整某列宽度（可抽样/取分位数）。
+	 *
+	 * 测量结果按字体缓存（TextWidthCache），重复的字符串只测量一次。
+	 * 虚拟模式下只测量当前可见窗口。
+	 */
+	void AutoSizeColumn(int col, const GridAutoSizeOptions& options);
+	/**
+	 * @brief 在后台线程测量全部列，完成后于下一次绘制时应用列宽并触发 OnAutoSizeCompleted。
+	 *
+	 * 待测文本在调用时复制，之后修改 Rows 不影响本次结果；再次调用会取消上一次任务。
+	 */
+	void AutoSizeColumnsAsync(const GridAutoSizeOptions& options = GridAutoSizeOptions());
+	/** @brief 取消进行中的后台自适应列宽。 */
+	void CancelAutoSize();
+	bool IsAutoSizing() const { return this->_autoSizeJob != nullptr; }
 	bool ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int xof, int yof) override;
 };
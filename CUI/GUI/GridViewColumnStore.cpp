@@ -0,0 +1,447 @@
+#include "GridViewColumnStore.h"
+#include "Grid/GridSort.h"
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+	// 文本池废弃字符至少达到该值且超过有效字符时整理
+	constexpr size_t CompactMinGarbage = 64 * 1024;
+
+	bool HasTextStorage(ColumnType type)
+	{
+		return type == ColumnType::Text;
+	}
+}
+
+GridViewColumnStore::GridViewColumnStore()
+{
+}
+
+void GridViewColumnStore::Reset(const List<GridViewColumn>& columns)
+{
+	_columns.clear();
+	_order.clear();
+	_physicalRows = 0;
+	for (const auto& col : columns)
+		AddColumn(col.Type);
+}
+
+void GridViewColumnStore::AddColumn(ColumnType type)
+{
+	Column c;
+	c.Type = type;
+	GrowColumn(c, _physicalRows);
+	_columns.push_back(std::move(c));
+}
+
+void GridViewColumnStore::GrowColumn(Column& c, uint32_t rows)
+{
+	switch (c.Type)
+	{
+	case ColumnType::Text:
+		c.Offsets.resize(rows, 0);
+		c.Lengths.resize(rows, 0);
+		break;
+	case ColumnType::Check:
+		c.Bits.resize(((size_t)rows + 63) / 64, 0);
+		break;
+	case ColumnType::ComboBox:
+		c.Indices.resize(rows, 0);
+		break;
+	default:
+		break;
+	}
+}
+
+void GridViewColumnStore::Reserve(int rows)
+{
+	if (rows <= 0) return;
+	_order.reserve((size_t)rows);
+	for (auto& c : _columns)
+	{
+		switch (c.Type)
+		{
+		case ColumnType::Text:
+			c.Offsets.reserve((size_t)rows);
+			c.Lengths.reserve((size_t)rows);
+			break;
+		case ColumnType::Check:
+			c.Bits.reserve(((size_t)rows + 63) / 64);
+			break;
+		case ColumnType::ComboBox:
+			c.Indices.reserve((size_t)rows);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+int GridViewColumnStore::AddRow()
+{
+	const uint32_t phys = _physicalRows++;
+	for (auto& c : _columns)
+		GrowColumn(c, _physicalRows);
+	_order.push_back(phys);
+	return (int)_order.size() - 1;
+}
+
+void GridViewColumnStore::Resize(int rows)
+{
+	if (rows < 0) rows = 0;
+	const uint32_t n = (uint32_t)rows;
+	if (n >= _order.size())
+	{
+		const uint32_t add = n - (uint32_t)_order.size();
+		for (uint32_t i = 0; i < add; i++)
+			_order.push_back(_physicalRows + i);
+		_physicalRows += add;
+		for (auto& c : _columns)
+			GrowColumn(c, _physicalRows);
+		return;
+	}
+
+	// 缩减：按显示顺序重排保留的物理行并截断，存储始终与行数成正比
+	std::vector<int64_t> remap(_physicalRows, -1);
+	for (uint32_t i = 0; i < n; i++)
+		remap[_order[i]] = i;
+	for (auto& c : _columns)
+	{
+		Column g;
+		g.Type = c.Type;
+		GrowColumn(g, n);
+		for (uint32_t i = 0; i < n; i++)
+		{
+			const uint32_t phys = _order[i];
+			switch (c.Type)
+			{
+			case ColumnType::Text:
+				g.Offsets[i] = (uint32_t)g.Chars.size();
+				g.Lengths[i] = c.Lengths[phys];
+				g.Chars.append(c.Chars, c.Offsets[phys], c.Lengths[phys]);
+				break;
+			case ColumnType::Check:
+				if ((c.Bits[phys >> 6] >> (phys & 63)) & 1)
+					g.Bits[i >> 6] |= (uint64_t)1 << (i & 63);
+				break;
+			case ColumnType::ComboBox:
+				g.Indices[i] = c.Indices[phys];
+				break;
+			default:
+				break;
+			}
+		}
+		for (auto& kv : c.Images)
+			if (remap[kv.first] >= 0) g.Images[(uint32_t)remap[kv.first]] = std::move(kv.second);
+		for (auto& kv : c.Tags)
+			if (remap[kv.first] >= 0) g.Tags[(uint32_t)remap[kv.first]] = kv.second;
+		c = std::move(g);
+	}
+	_order.resize(n);
+	std::iota(_order.begin(), _order.end(), 0u);
+	_physicalRows = n;
+}
+
+void GridViewColumnStore::Clear()
+{
+	std::vector<ColumnType> types;
+	for (const auto& c : _columns) types.push_back(c.Type);
+	_columns.clear();
+	_order.clear();
+	_order.shrink_to_fit();
+	_physicalRows = 0;
+	for (auto t : types) AddColumn(t);
+}
+
+bool GridViewColumnStore::InRange(int row, int col) const
+{
+	return row >= 0 && col >= 0 && row < (int)_order.size() && col < (int)_columns.size();
+}
+
+const wchar_t* GridViewColumnStore::TextPtr(const Column& c, uint32_t phys, uint32_t& len) const
+{
+	len = c.Lengths[phys];
+	return c.Chars.data() + c.Offsets[phys];
+}
+
+void GridViewColumnStore::CompactText(Column& c)
+{
+	const size_t live = c.Chars.size() - c.GarbageChars;
+	if (c.GarbageChars < CompactMinGarbage || c.GarbageChars <= live) return;
+	std::wstring chars;
+	chars.reserve(live);
+	for (uint32_t phys = 0; phys < _physicalRows; phys++)
+	{
+		const uint32_t offset = (uint32_t)chars.size();
+		chars.append(c.Chars, c.Offsets[phys], c.Lengths[phys]);
+		c.Offsets[phys] = offset;
+	}
+	c.Chars.swap(chars);
+	c.GarbageChars = 0;
+}
+
+void GridViewColumnStore::SetText(int row, int col, const std::wstring& text)
+{
+	if (!InRange(row, col)) return;
+	Column& c = _columns[(size_t)col];
+	if (!HasTextStorage(c.Type)) return;
+	const uint32_t phys = Physical(row);
+	const uint32_t oldLen = c.Lengths[phys];
+	if (text.size() <= oldLen)
+	{
+		// 原位覆盖，不产生废弃字符
+		std::copy(text.begin(), text.end(), c.Chars.begin() + c.Offsets[phys]);
+		c.GarbageChars += oldLen - text.size();
+	}
+	else
+	{
+		c.GarbageChars += oldLen;
+		c.Offsets[phys] = (uint32_t)c.Chars.size();
+		c.Chars.append(text);
+	}
+	c.Lengths[phys] = (uint32_t)text.size();
+	CompactText(c);
+}
+
+std::wstring GridViewColumnStore::GetText(int row, int col) const
+{
+	if (!InRange(row, col)) return L"";
+	const Column& c = _columns[(size_t)col];
+	if (!HasTextStorage(c.Type)) return L"";
+	uint32_t len = 0;
+	const wchar_t* p = TextPtr(c, Physical(row), len);
+	return std::wstring(p, len);
+}
+
+void GridViewColumnStore::SetChecked(int row, int col, bool checked)
+{
+	if (!InRange(row, col)) return;
+	Column& c = _columns[(size_t)col];
+	if (c.Type != ColumnType::Check) return;
+	const uint32_t phys = Physical(row);
+	const uint64_t mask = (uint64_t)1 << (phys & 63);
+	if (checked) c.Bits[phys >> 6] |= mask;
+	else c.Bits[phys >> 6] &= ~mask;
+}
+
+bool GridViewColumnStore::GetChecked(int row, int col) const
+{
+	if (!InRange(row, col)) return false;
+	const Column& c = _columns[(size_t)col];
+	if (c.Type != ColumnType::Check) return false;
+	const uint32_t phys = Physical(row);
+	return ((c.Bits[phys >> 6] >> (phys & 63)) & 1) != 0;
+}
+
+void GridViewColumnStore::SetComboIndex(int row, int col, int index)
+{
+	if (!InRange(row, col)) return;
+	Column& c = _columns[(size_t)col];
+	if (c.Type != ColumnType::ComboBox) return;
+	c.Indices[Physical(row)] = index;
+}
+
+int GridViewColumnStore::GetComboIndex(int row, int col) const
+{
+	if (!InRange(row, col)) return 0;
+	const Column& c = _columns[(size_t)col];
+	if (c.Type != ColumnType::ComboBox) return 0;
+	return c.Indices[Physical(row)];
+}
+
+void GridViewColumnStore::SetImage(int row, int col, std::shared_ptr<BitmapSource> image)
+{
+	if (!InRange(row, col)) return;
+	Column& c = _columns[(size_t)col];
+	const uint32_t phys = Physical(row);
+	if (image) c.Images[phys] = std::move(image);
+	else c.Images.erase(phys);
+}
+
+std::shared_ptr<BitmapSource> GridViewColumnStore::GetImage(int row, int col) const
+{
+	if (!InRange(row, col)) return nullptr;
+	const Column& c = _columns[(size_t)col];
+	auto it = c.Images.find(Physical(row));
+	return it != c.Images.end() ? it->second : nullptr;
+}
+
+void GridViewColumnStore::SetTag(int row, int col, __int64 tag)
+{
+	if (!InRange(row, col)) return;
+	Column& c = _columns[(size_t)col];
+	const uint32_t phys = Physical(row);
+	if (tag != 0) c.Tags[phys] = tag;
+	else c.Tags.erase(phys);
+}
+
+__int64 GridViewColumnStore::GetTag(int row, int col) const
+{
+	if (!InRange(row, col)) return 0;
+	const Column& c = _columns[(size_t)col];
+	auto it = c.Tags.find(Physical(row));
+	return it != c.Tags.end() ? it->second : 0;
+}
+
+void GridViewColumnStore::SetCell(int row, int col, const CellValue& value)
+{
+	if (!InRange(row, col)) return;
+	switch (_columns[(size_t)col].Type)
+	{
+	case ColumnType::Check:
+		SetChecked(row, col, value.Tag != 0);
+		return;
+	case ColumnType::ComboBox:
+		SetComboIndex(row, col, (int)value.Tag);
+		return;
+	case ColumnType::Image:
+		SetImage(row, col, value.Image);
+		break;
+	case ColumnType::Text:
+		SetText(row, col, value.Text);
+		break;
+	default:
+		break;
+	}
+	SetTag(row, col, value.Tag);
+}
+
+CellValue GridViewColumnStore::GetCell(int row, int col) const
+{
+	CellValue v;
+	if (!InRange(row, col)) return v;
+	const Column& c = _columns[(size_t)col];
+	const uint32_t phys = Physical(row);
+	switch (c.Type)
+	{
+	case ColumnType::Text:
+	{
+		uint32_t len = 0;
+		const wchar_t* p = TextPtr(c, phys, len);
+		v.Text.assign(p, len);
+		v.Tag = GetTag(row, col);
+		break;
+	}
+	case ColumnType::Check:
+		v.Tag = ((c.Bits[phys >> 6] >> (phys & 63)) & 1) ? 1 : 0;
+		break;
+	case ColumnType::ComboBox:
+		// Text 由 GridView 按列的 ComboBoxItems 同步
+		v.Tag = c.Indices[phys];
+		break;
+	case ColumnType::Image:
+		v.Image = GetImage(row, col);
+		v.Tag = GetTag(row, col);
+		break;
+	default:
+		v.Tag = GetTag(row, col);
+		break;
+	}
+	return v;
+}
+
+size_t GridViewColumnStore::MemoryUsage() const
+{
+	size_t bytes = _order.capacity() * sizeof(uint32_t);
+	for (const auto& c : _columns)
+	{
+		bytes += c.Chars.capacity() * sizeof(wchar_t);
+		bytes += (c.Offsets.capacity() + c.Lengths.capacity()) * sizeof(uint32_t);
+		bytes += c.Bits.capacity() * sizeof(uint64_t);
+		bytes += c.Indices.capacity() * sizeof(int32_t);
+		// 稀疏表按节点粗略估算
+		bytes += c.Images.size() * (sizeof(uint32_t) + sizeof(std::shared_ptr<BitmapSource>) + 2 * sizeof(void*));
+		bytes += c.Tags.size() * (sizeof(uint32_t) + sizeof(__int64) + 2 * sizeof(void*));
+	}
+	return bytes;
+}
+
+int GridViewColumnStore::GetRowCount()
+{
+	return RowCount();
+}
+
+void GridViewColumnStore::GetRows(int firstRow, int count, GridViewRow* rows)
+{
+	for (int i = 0; i < count; i++)
+	{
+		auto& cells = rows[i].Cells;
+		cells.clear();
+		cells.reserve(_columns.size());
+		for (int c = 0; c < (int)_columns.size(); c++)
+			cells.push_back(GetCell(firstRow + i, c));
+	}
+}
+
+bool GridViewColumnStore::SetCellValue(int row, int col, const CellValue& value)
+{
+	if (!InRange(row, col)) return false;
+	SetCell(row, col, value);
+	return true;
+}
+
+bool GridViewColumnStore::Sort(int col, bool ascending)
+{
+	GridViewSortKey key;
+	key.Column = col;
+	key.Ascending = ascending;
+	return SortByColumns({ key });
+}
+
+bool GridViewColumnStore::SortByColumns(const std::vector<GridViewSortKey>& keys)
+{
+	if (keys.empty()) return false;
+	for (const auto& k : keys)
+	{
+		if (k.Column < 0 || k.Column >= (int)_columns.size()) return false;
+	}
+
+	// 按物理行提取排序键；只重排显示顺序，列数据不移动
+	std::vector<std::vector<GridSortKey>> columnKeys(keys.size());
+	for (size_t k = 0; k < keys.size(); k++)
+	{
+		const Column& c = _columns[(size_t)keys[k].Column];
+		auto& out = columnKeys[k];
+		out.resize(_physicalRows);
+		GridSort::ParallelFor(_physicalRows, [&](size_t begin, size_t end)
+			{
+				for (size_t phys = begin; phys < end; phys++)
+					out[phys] = SortKey(c, (uint32_t)phys);
+			});
+	}
+	GridSort::ParallelStableSort(_order, [&](uint32_t a, uint32_t b)
+		{
+			for (size_t k = 0; k < keys.size(); k++)
+			{
+				const int cmp = GridSort::Compare(columnKeys[k][a], columnKeys[k][b]);
+				if (cmp != 0)
+					return keys[k].Ascending ? cmp < 0 : cmp > 0;
+			}
+			return false;
+		});
+	return true;
+}
+
+GridSortKey GridViewColumnStore::SortKey(const Column& c, uint32_t phys) const
+{
+	switch (c.Type)
+	{
+	case ColumnType::Text:
+	{
+		uint32_t len = 0;
+		const wchar_t* p = TextPtr(c, phys, len);
+		if (len > 0) return GridSort::MakeKey(p, len);
+		break;
+	}
+	case ColumnType::Check:
+		return GridSort::MakeNumberKey((double)((c.Bits[phys >> 6] >> (phys & 63)) & 1));
+	case ColumnType::ComboBox:
+		return GridSort::MakeNumberKey((double)c.Indices[phys]);
+	default:
+		break;
+	}
+	// 与 GridView 一致：无文本的单元格按 Tag 排序
+	auto it = c.Tags.find(phys);
+	return GridSort::MakeNumberKey(it != c.Tags.end() ? (double)it->second : 0.0);
+}
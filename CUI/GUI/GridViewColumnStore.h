@@ -0,0 +1,108 @@
+#pragma once
+#include "GridView.h"
+#include "Grid/GridSort.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file GridViewColumnStore.h
+ * @brief GridViewColumnStore：GridView 的按列存储（作为虚拟模式数据源使用）。
+ *
+ * 每个 CellValue 自带 wstring、shared_ptr、ComPtr 等成员，大表格的每格开销远超其内容。
+ * 本类按列类型紧凑保存数据，只在 GridView 需要显示某行时才生成 CellValue（视图）：
+ * - Text 列：每列一个连续字符池 + (偏移, 长度) 索引（Button 列的文字来自 GridViewColumn::ButtonText，不按格保存）
+ * - Check 列：位图
+ * - ComboBox 列：int32 选中项索引
+ * - Image 列与非零 Tag：稀疏表（只记录有值的格）
+ *
+ * 用法：
+ * @code
+ * GridViewColumnStore store;
+ * store.Reset(grid->Columns);
+ * store.Resize(100000);
+ * store.SetText(0, 0, L"...");
+ * grid->SetDataSource(&store);
+ * @endcode
+ *
+ * 行索引均为显示顺序（排序后的顺序）；修改数据后调用 GridView::InvalidateRows / InvalidateRow 刷新。
+ */
+class GridViewColumnStore : public GridViewDataSource
+{
+public:
+	GridViewColumnStore();
+
+	/** @brief 按 GridView 的列定义重建列（清空全部数据）。 */
+	void Reset(const List<GridViewColumn>& columns);
+	/** @brief 追加一列。 */
+	void AddColumn(ColumnType type);
+	int ColumnCount() const { return (int)_columns.size(); }
+	ColumnType GetColumnType(int col) const { return _columns[(size_t)col].Type; }
+
+	int RowCount() const { return (int)_order.size(); }
+	/** @brief 预分配行容量。 */
+	void Reserve(int rows);
+	/** @brief 调整行数（新增行为空值，缩减时删除末尾的显示行）。 */
+	void Resize(int rows);
+	/** @brief 追加一个空行，返回其行索引。 */
+	int AddRow();
+	/** @brief 清空全部行（保留列定义）。 */
+	void Clear();
+
+	void SetText(int row, int col, const std::wstring& text);
+	std::wstring GetText(int row, int col) const;
+	void SetChecked(int row, int col, bool checked);
+	bool GetChecked(int row, int col) const;
+	void SetComboIndex(int row, int col, int index);
+	int GetComboIndex(int row, int col) const;
+	void SetImage(int row, int col, std::shared_ptr<BitmapSource> image);
+	std::shared_ptr<BitmapSource> GetImage(int row, int col) const;
+	void SetTag(int row, int col, __int64 tag);
+	__int64 GetTag(int row, int col) const;
+
+	/** @brief 按列类型写入一个 CellValue（Check 取 Tag!=0，ComboBox 取 Tag 为索引）。 */
+	void SetCell(int row, int col, const CellValue& value);
+	/** @brief 生成单元格视图。 */
+	CellValue GetCell(int row, int col) const;
+
+	/** @brief 估算占用的字节数（用于诊断）。 */
+	size_t MemoryUsage() const;
+
+	int GetRowCount() override;
+	void GetRows(int firstRow, int count, GridViewRow* rows) override;
+	bool SetCellValue(int row, int col, const CellValue& value) override;
+	bool Sort(int col, bool ascending) override;
+	bool SortByColumns(const std::vector<GridViewSortKey>& keys) override;
+
+private:
+	struct Column
+	{
+		ColumnType Type = ColumnType::Text;
+		// Text：字符池与每行的 (偏移, 长度)
+		std::wstring Chars;
+		std::vector<uint32_t> Offsets;
+		std::vector<uint32_t> Lengths;
+		size_t GarbageChars = 0;
+		// Check：每行 1 bit
+		std::vector<uint64_t> Bits;
+		// ComboBox：每行选中项索引
+		std::vector<int32_t> Indices;
+		// Image 与 Tag：仅保存有值的格（键为物理行）
+		std::unordered_map<uint32_t, std::shared_ptr<BitmapSource>> Images;
+		std::unordered_map<uint32_t, __int64> Tags;
+	};
+
+	std::vector<Column> _columns;
+	// 显示行 -> 物理行
+	std::vector<uint32_t> _order;
+	uint32_t _physicalRows = 0;
+
+	uint32_t Physical(int row) const { return _order[(size_t)row]; }
+	bool InRange(int row, int col) const;
+	void GrowColumn(Column& c, uint32_t rows);
+	const wchar_t* TextPtr(const Column& c, uint32_t phys, uint32_t& len) const;
+	void CompactText(Column& c);
+	GridSortKey SortKey(const Column& c, uint32_t phys) const;
+};
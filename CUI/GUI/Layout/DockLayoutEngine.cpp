@@ -0,0 +1,210 @@
+#include "DockLayoutEngine.h"
+#include <algorithm>
+
+// DockLayoutEngine 实现
+
+LayoutSize DockLayoutEngine::Measure(LayoutElement* container, LayoutSize availableSize)
+{
+	if (!container) return {0, 0};
+	
+	LayoutSize desiredSize = {0, 0};
+	LayoutSize remainingSize = availableSize;
+	
+	// 遍历所有子控件，按停靠位置累计尺寸
+	for (int i = 0; i < container->GetLayoutChildCount(); i++)
+	{
+		auto child = container->GetLayoutChild(i);
+		if (!child || !child->IsLayoutVisible()) continue;
+		
+		LayoutSize childSize = child->Measure(remainingSize);
+		Thickness margin = child->GetLayoutMargin();
+		Dock dock = child->GetLayoutDock();
+		
+		int childWidth = childSize.cx + (int)(margin.Left + margin.Right);
+		int childHeight = childSize.cy + (int)(margin.Top + margin.Bottom);
+		
+		switch (dock)
+		{
+		case Dock::Left:
+		case Dock::Right:
+			desiredSize.cx += childWidth;
+			if (childHeight > desiredSize.cy)
+				desiredSize.cy = childHeight;
+			remainingSize.cx -= childWidth;
+			if (remainingSize.cx < 0) remainingSize.cx = 0;
+			break;
+			
+		case Dock::Top:
+		case Dock::Bottom:
+			if (childWidth > desiredSize.cx)
+				desiredSize.cx = childWidth;
+			desiredSize.cy += childHeight;
+			remainingSize.cy -= childHeight;
+			if (remainingSize.cy < 0) remainingSize.cy = 0;
+			break;
+			
+		case Dock::Fill:
+			if (childWidth > desiredSize.cx)
+				desiredSize.cx = childWidth;
+			if (childHeight > desiredSize.cy)
+				desiredSize.cy = childHeight;
+			break;
+		}
+	}
+	
+	_needsLayout = false;
+	return desiredSize;
+}
+
+void DockLayoutEngine::Arrange(LayoutElement* container, LayoutRect finalRect)
+{
+	if (!container) return;
+	
+	// 维护剩余可用空间
+	LayoutRect remaining = finalRect;
+	
+	int childCount = container->GetLayoutChildCount();
+	int lastIndex = childCount - 1;
+	
+	// 遍历子控件并排列
+	for (int i = 0; i < childCount; i++)
+	{
+		auto child = container->GetLayoutChild(i);
+		if (!child || !child->IsLayoutVisible()) continue;
+		
+		Dock dock = child->GetLayoutDock();
+		Thickness margin = child->GetLayoutMargin();
+		LayoutSize childSize = child->GetLayoutSize();
+		LayoutSize actualSize = childSize;
+		bool useActualSize = child->TryGetActualLayoutSize(actualSize);
+		
+		// 最后一个子控件如果启用 LastChildFill，则填充剩余空间
+		bool isLastAndFill = (i == lastIndex && _lastChildFill);
+		if (isLastAndFill)
+		{
+			dock = Dock::Fill;
+		}
+		
+		float x = 0, y = 0, width = 0, height = 0;
+		
+		switch (dock)
+		{
+		case Dock::Left:
+		{
+			float availableH = remaining.bottom - remaining.top - margin.Top - margin.Bottom;
+			if (availableH < 0) availableH = 0;
+			width = (float)(useActualSize ? actualSize.cx : childSize.cx);
+			height = useActualSize ? (float)actualSize.cy : availableH;
+			if (height > availableH) height = availableH;
+
+			x = remaining.left + margin.Left;
+			y = remaining.top + margin.Top;
+			if (useActualSize && height < availableH)
+			{
+				y += (availableH - height) / 2.0f;
+			}
+
+			// 更新剩余空间
+			remaining.left += width + margin.Left + margin.Right;
+		}
+			break;
+			
+		case Dock::Top:
+		{
+			float availableW = remaining.right - remaining.left - margin.Left - margin.Right;
+			if (availableW < 0) availableW = 0;
+			width = useActualSize ? (float)actualSize.cx : availableW;
+			if (width > availableW) width = availableW;
+			height = (float)(useActualSize ? actualSize.cy : childSize.cy);
+
+			x = remaining.left + margin.Left;
+			y = remaining.top + margin.Top;
+			if (useActualSize && width < availableW)
+			{
+				x += (availableW - width) / 2.0f;
+			}
+
+			// 更新剩余空间
+			remaining.top += height + margin.Top + margin.Bottom;
+		}
+			break;
+			
+		case Dock::Right:
+		{
+			float availableH = remaining.bottom - remaining.top - margin.Top - margin.Bottom;
+			if (availableH < 0) availableH = 0;
+			width = (float)(useActualSize ? actualSize.cx : childSize.cx);
+			height = useActualSize ? (float)actualSize.cy : availableH;
+			if (height > availableH) height = availableH;
+
+			x = remaining.right - width - margin.Right;
+			y = remaining.top + margin.Top;
+			if (useActualSize && height < availableH)
+			{
+				y += (availableH - height) / 2.0f;
+			}
+			
+			// 更新剩余空间
+			remaining.right -= width + margin.Left + margin.Right;
+		}
+			break;
+			
+		case Dock::Bottom:
+		{
+			float availableW = remaining.right - remaining.left - margin.Left - margin.Right;
+			if (availableW < 0) availableW = 0;
+			width = useActualSize ? (float)actualSize.cx : availableW;
+			if (width > availableW) width = availableW;
+			height = (float)(useActualSize ? actualSize.cy : childSize.cy);
+
+			x = remaining.left + margin.Left;
+			y = remaining.bottom - height - margin.Bottom;
+			if (useActualSize && width < availableW)
+			{
+				x += (availableW - width) / 2.0f;
+			}
+			
+			// 更新剩余空间
+			remaining.bottom -= height + margin.Top + margin.Bottom;
+		}
+			break;
+			
+		case Dock::Fill:
+		{
+			float availableW = remaining.right - remaining.left - margin.Left - margin.Right;
+			float availableH = remaining.bottom - remaining.top - margin.Top - margin.Bottom;
+			if (availableW < 0) availableW = 0;
+			if (availableH < 0) availableH = 0;
+
+			if (useActualSize)
+			{
+				width = (float)actualSize.cx;
+				height = (float)actualSize.cy;
+				if (width > availableW) width = availableW;
+				if (height > availableH) height = availableH;
+				x = remaining.left + margin.Left + (availableW - width) / 2.0f;
+				y = remaining.top + margin.Top + (availableH - height) / 2.0f;
+			}
+			else
+			{
+				x = remaining.left + margin.Left;
+				y = remaining.top + margin.Top;
+				width = availableW;
+				height = availableH;
+			}
+		}
+			break;
+		}
+		
+		// 确保尺寸非负
+		if (width < 0) width = 0;
+		if (height < 0) height = 0;
+		
+		// 应用布局
+		LayoutPoint loc = { (int)x, (int)y };
+		LayoutSize size = { (int)width, (int)height };
+		child->ApplyLayout(loc, size);
+	}
+	
+	_needsLayout = false;
+}
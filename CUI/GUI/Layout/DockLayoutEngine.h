@@ -0,0 +1,33 @@
+#pragma once
+#include "LayoutEngine.h"
+#include "LayoutTypes.h"
+
+/**
+ * @file DockLayoutEngine.h
+ * @brief DockLayoutEngine：按 Dock 方向停靠子项的布局引擎（不依赖 Win32）。
+ */
+
+/**
+ * @brief DockPanel 布局引擎。
+ *
+ * 子项通过 GetLayoutDock（Control::DockPosition）指定停靠方向。
+ * LastChildFill=true 时，最后一个子控件会占用剩余空间。
+ */
+class DockLayoutEngine : public LayoutEngine {
+private:
+    bool _lastChildFill = true;
+    
+public:
+    /** @brief 设置最后一个子控件是否填充剩余空间。 */
+    void SetLastChildFill(bool value) { 
+        _lastChildFill = value; 
+        Invalidate(); 
+    }
+    
+    bool GetLastChildFill() const { 
+        return _lastChildFill; 
+    }
+    
+    LayoutSize Measure(LayoutElement* container, LayoutSize availableSize) override;
+    void Arrange(LayoutElement* container, LayoutRect finalRect) override;
+};
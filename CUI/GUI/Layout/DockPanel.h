@@ -1,6 +1,6 @@
 #pragma once
 #include "../Panel.h"
-#include "LayoutEngine.h"
+#include "DockLayoutEngine.h"
 #include "LayoutTypes.h"
 
 /**
@@ -8,31 +8,6 @@
  * @brief DockPanel：按 Dock 方向停靠子控件的容器。
  */
 
-/**
- * @brief DockPanel 布局引擎。
- *
- * 子控件通过 Control::DockPosition 指定停靠方向。
- * LastChildFill=true 时，最后一个子控件会占用剩余空间。
- */
-class DockLayoutEngine : public LayoutEngine {
-private:
-    bool _lastChildFill = true;
-    
-public:
-    /** @brief 设置最后一个子控件是否填充剩余空间。 */
-    void SetLastChildFill(bool value) { 
-        _lastChildFill = value; 
-        Invalidate(); 
-    }
-    
-    bool GetLastChildFill() const { 
-        return _lastChildFill; 
-    }
-    
-    SIZE Measure(Control* container, SIZE availableSize) override;
-    void Arrange(Control* container, D2D1_RECT_F finalRect) override;
-};
-
 /**
  * @brief DockPanel 控件类。
  */
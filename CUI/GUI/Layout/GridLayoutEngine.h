@@ -0,0 +1,71 @@
+#pragma once
+#include "LayoutEngine.h"
+#include "LayoutTypes.h"
+#include <vector>
+#include <algorithm>
+
+/**
+ * @file GridLayoutEngine.h
+ * @brief GridLayoutEngine：按行/列定义摆放子项的布局引擎（不依赖 Win32）。
+ */
+
+/**
+ * @brief GridPanel 布局引擎。
+ *
+ * 支持 Row/Column 的 Pixel/Auto/Star 等策略，并缓存计算后的行高/列宽与起始位置。
+ * 子项通过 GetLayoutGridRow/GetLayoutGridColumn 等（Control::GridRow/GridColumn/GridRowSpan/GridColumnSpan）指定单元格位置。
+ */
+class GridLayoutEngine : public LayoutEngine {
+private:
+    std::vector<RowDefinition> _rowDefinitions;
+    std::vector<ColumnDefinition> _columnDefinitions;
+    
+    // 缓存计算结果
+    std::vector<float> _rowHeights;
+    std::vector<float> _columnWidths;
+    std::vector<float> _rowPositions;
+    std::vector<float> _columnPositions;
+    
+    void CalculateRowHeights(LayoutElement* container, float availableHeight);
+    void CalculateColumnWidths(LayoutElement* container, float availableWidth);
+    
+public:
+    const std::vector<RowDefinition>& GetRows() const { return _rowDefinitions; }
+    const std::vector<ColumnDefinition>& GetColumns() const { return _columnDefinitions; }
+
+    void AddRow(const RowDefinition& row) { 
+        _rowDefinitions.push_back(row); 
+        Invalidate(); 
+    }
+    
+    void AddColumn(const ColumnDefinition& col) { 
+        _columnDefinitions.push_back(col); 
+        Invalidate(); 
+    }
+    
+    void ClearRows() {
+        _rowDefinitions.clear();
+        Invalidate();
+    }
+    
+    void ClearColumns() {
+        _columnDefinitions.clear();
+        Invalidate();
+    }
+
+	// 根据当前容器尺寸与行列定义，将点映射到单元格索引。
+	// x/y 为容器本地坐标（0,0 在 GridPanel 左上角）。
+    /**
+     * @brief 将容器本地坐标映射为 Grid 单元格索引。
+     * @param container GridPanel 容器。
+     * @param x 容器本地 X（像素）。
+     * @param y 容器本地 Y（像素）。
+     * @param outRow 输出行索引。
+     * @param outCol 输出列索引。
+     * @return true 表示命中有效单元格。
+     */
+	bool TryGetCellAtPoint(LayoutElement* container, float x, float y, int& outRow, int& outCol);
+    
+    LayoutSize Measure(LayoutElement* container, LayoutSize availableSize) override;
+    void Arrange(LayoutElement* container, LayoutRect finalRect) override;
+};
@@ -5,14 +5,26 @@
  * @brief 布局系统聚合头文件。
  *
  * 直接包含该文件可获得所有布局相关类型与容器控件：
- * - LayoutTypes / LayoutEngine
+ * - LayoutTypes / LayoutElement / LayoutEngine
+ * - 各布局引擎（Stack/Grid/Dock/Wrap/Relative/Virtualizing，不依赖 Win32）
  * - StackPanel / GridPanel / DockPanel / WrapPanel / RelativePanel
+ * - VirtualizingStackPanel（只实例化可见项的虚拟化列表；区间计算与容器复用见 VirtualizingExtent / VirtualContainerPool）
  */
 
 #include "LayoutTypes.h"
+#include "LayoutElement.h"
 #include "LayoutEngine.h"
+#include "StackLayoutEngine.h"
+#include "GridLayoutEngine.h"
+#include "DockLayoutEngine.h"
+#include "WrapLayoutEngine.h"
+#include "RelativeLayoutEngine.h"
+#include "VirtualizingExtent.h"
+#include "VirtualContainerPool.h"
+#include "VirtualizingLayoutEngine.h"
 #include "StackPanel.h"
 #include "GridPanel.h"
 #include "DockPanel.h"
 #include "WrapPanel.h"
 #include "RelativePanel.h"
+#include "VirtualizingStackPanel.h"
@@ -0,0 +1,21 @@
+#include "LayoutElement.h"
+
+LayoutSize LayoutElement::Measure(LayoutSize availableSize)
+{
+	auto& stats = LayoutStats::Current();
+	stats.MeasureCalls++;
+	if (_measureValid && _measureAvailable.cx == availableSize.cx && _measureAvailable.cy == availableSize.cy)
+		return _desiredSize;
+	stats.MeasureCoreCalls++;
+	_desiredSize = this->MeasureCore(availableSize);
+	_measureAvailable = availableSize;
+	_measureValid = true;
+	return _desiredSize;
+}
+
+void LayoutElement::InvalidateMeasure()
+{
+	// 容器的期望尺寸可能依赖子元素，父链上的缓存一并失效（深度通常很小）
+	for (LayoutElement* e = this; e; e = e->GetLayoutParent())
+		e->_measureValid = false;
+}
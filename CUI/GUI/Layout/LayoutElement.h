@@ -0,0 +1,75 @@
+#pragma once
+#include "LayoutTypes.h"
+
+/**
+ * @file LayoutElement.h
+ * @brief LayoutElement：布局引擎访问容器与子项的接口（不依赖 Win32）。
+ *
+ * 布局引擎只通过该接口读取子项的布局属性、测量子项并写回排列结果：
+ * Control 实现它参与窗口布局，CUICheck 用不创建窗口的桩元素实现它来校验布局逻辑。
+ */
+
+/**
+ * @brief 参与布局的元素。
+ *
+ * 测量缓存也在这里：Measure 在可用尺寸与上次相同且未失效时直接返回上次 MeasureCore 的结果。
+ * 影响 MeasureCore 结果的状态（内容、字体、可见性等）变化时必须调用 InvalidateMeasure，
+ * 即使自身缓存已经失效（例如刚被 Arrange 改过尺寸）：祖先的缓存仍可能有效。
+ */
+class LayoutElement {
+public:
+    virtual ~LayoutElement() = default;
+
+    /** @brief 父元素（没有时为 NULL）。 */
+    virtual LayoutElement* GetLayoutParent() = 0;
+    /** @brief 子元素数量。 */
+    virtual int GetLayoutChildCount() = 0;
+    /** @brief 第 index 个子元素（按绘制顺序）。 */
+    virtual LayoutElement* GetLayoutChild(int index) = 0;
+
+    /** @brief 是否参与布局（隐藏的元素不占空间）。 */
+    virtual bool IsLayoutVisible() = 0;
+    virtual Thickness GetLayoutMargin() = 0;
+    virtual Thickness GetLayoutPadding() = 0;
+    virtual HorizontalAlignment GetLayoutHAlign() = 0;
+    virtual VerticalAlignment GetLayoutVAlign() = 0;
+    virtual Dock GetLayoutDock() = 0;
+    virtual int GetLayoutGridRow() = 0;
+    virtual int GetLayoutGridColumn() = 0;
+    virtual int GetLayoutGridRowSpan() = 0;
+    virtual int GetLayoutGridColumnSpan() = 0;
+
+    /** @brief 当前尺寸（像素）。 */
+    virtual LayoutSize GetLayoutSize() = 0;
+    /**
+     * @brief 由内容决定的实际尺寸（如自动尺寸的 Label）。
+     * @param actual 输出实际尺寸；没有时为当前尺寸。
+     * @return 实际尺寸与当前尺寸不同时返回 true，排列阶段改用实际尺寸。
+     */
+    virtual bool TryGetActualLayoutSize(LayoutSize& actual) = 0;
+    /**
+     * @brief 写回排列结果。
+     * @param location 父元素坐标系中的位置。
+     * @param size 最终尺寸。
+     */
+    virtual void ApplyLayout(LayoutPoint location, LayoutSize size) = 0;
+
+    /**
+     * @brief 测量阶段：返回期望尺寸（不含 Margin）。
+     * @param availableSize 可用空间（由父布局提供）。
+     */
+    virtual LayoutSize MeasureCore(LayoutSize availableSize) = 0;
+    /** @brief 带缓存的测量，布局引擎应调用此函数而不是直接调用 MeasureCore。 */
+    LayoutSize Measure(LayoutSize availableSize);
+    /** @brief 最近一次 Measure 的结果。 */
+    LayoutSize GetDesiredSize() const { return _desiredSize; }
+    /** @brief 测量缓存是否有效。 */
+    bool IsMeasureValid() const { return _measureValid; }
+    /** @brief 使自身及父链上所有祖先的测量缓存失效。 */
+    void InvalidateMeasure();
+
+protected:
+    LayoutSize _measureAvailable = { 0, 0 };
+    LayoutSize _desiredSize = { 0, 0 };
+    bool _measureValid = false;
+};
@@ -0,0 +1,20 @@
+#include "LayoutEngine.h"
+#include <algorithm>
+
+void LayoutEngine::Layout(LayoutElement* container, LayoutSize size, Thickness padding)
+{
+	LayoutStats::Current().EngineLayouts++;
+	LayoutSize availableSize = {
+		(int)(std::max)(0.0f, (float)size.cx - padding.Left - padding.Right),
+		(int)(std::max)(0.0f, (float)size.cy - padding.Top - padding.Bottom)
+	};
+	this->Measure(container, availableSize);
+
+	LayoutRect finalRect = {
+		padding.Left,
+		padding.Top,
+		padding.Left + (float)availableSize.cx,
+		padding.Top + (float)availableSize.cy
+	};
+	this->Arrange(container, finalRect);
+}
@@ -1,5 +1,5 @@
 #pragma once
-#include "../Control.h"
+#include "LayoutElement.h"
 #include "LayoutTypes.h"
 #include <vector>
 
@@ -16,6 +16,8 @@
  * @brief 布局引擎基类。
  *
  * LayoutEngine 是纯逻辑组件，通常由容器（如 Panel/Form）持有并在需要时触发。
+ * 容器与子控件只通过 LayoutElement 访问，不依赖 Win32。
+ * 实现中测量子控件应调用 LayoutElement::Measure：未变化的子控件直接返回缓存的期望尺寸。
  */
 class LayoutEngine {
 public:
@@ -27,14 +29,20 @@ public:
      * @param availableSize 可用空间大小（单位：像素）。
      * @return 容器期望的尺寸（单位：像素）。
      */
-    virtual SIZE Measure(class Control* container, SIZE availableSize) = 0;
+    virtual LayoutSize Measure(LayoutElement* container, LayoutSize availableSize) = 0;
     
     /**
      * @brief 排列阶段：为子控件计算并应用最终位置/尺寸。
      * @param container 包含子控件的容器。
      * @param finalRect 容器最终矩形区域（容器本地坐标系）。
      */
-    virtual void Arrange(class Control* container, D2D1_RECT_F finalRect) = 0;
+    virtual void Arrange(LayoutElement* container, LayoutRect finalRect) = 0;
+
+    /**
+     * @brief 在 size 大小的容器内执行一次 Measure + Arrange（Panel::PerformLayout 使用）。
+     * @param padding 容器内边距，扣除后为子控件的可用区域。
+     */
+    void Layout(LayoutElement* container, LayoutSize size, Thickness padding);
     
     /** @brief 标记布局失效，需要重新布局。 */
     virtual void Invalidate() { 
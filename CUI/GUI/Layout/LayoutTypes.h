@@ -10,6 +10,44 @@
  * 坐标/尺寸单位通常为像素；部分类型支持 Auto/Star/Percent 等策略（见 SizeUnit）。
  */
 
+/** @brief 布局使用的尺寸（像素，字段与 SIZE 相同，不依赖 Win32）。 */
+struct LayoutSize {
+    int cx;
+    int cy;
+};
+
+/** @brief 布局使用的位置（像素，父容器坐标系）。 */
+struct LayoutPoint {
+    int x;
+    int y;
+};
+
+/** @brief 布局使用的矩形（字段与 D2D1_RECT_F 相同）。 */
+struct LayoutRect {
+    float left;
+    float top;
+    float right;
+    float bottom;
+};
+
+/**
+ * @brief 布局统计计数（用于基准测试与性能诊断，只在 UI 线程累加）。
+ */
+struct LayoutStats {
+    /** @brief LayoutElement::Measure 调用次数。 */
+    uint64_t MeasureCalls = 0;
+    /** @brief 其中缓存未命中、实际调用 MeasureCore 的次数。 */
+    uint64_t MeasureCoreCalls = 0;
+    /** @brief 容器通过 LayoutEngine 执行 Measure + Arrange 的次数。 */
+    uint64_t EngineLayouts = 0;
+
+    void Reset() { *this = LayoutStats(); }
+    static LayoutStats& Current() {
+        static LayoutStats stats;
+        return stats;
+    }
+};
+
 /** @brief 布局方向（主轴方向）。 */
 enum class Orientation : uint8_t {
     Horizontal,
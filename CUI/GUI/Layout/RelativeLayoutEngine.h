@@ -0,0 +1,69 @@
+#pragma once
+#include "LayoutEngine.h"
+#include "LayoutTypes.h"
+#include <map>
+#include <vector>
+
+/**
+ * @file RelativeLayoutEngine.h
+ * @brief RelativeLayoutEngine：按相对约束定位子项的布局引擎（不依赖 Win32）。
+ */
+
+/**
+ * @brief 相对定位约束。
+ *
+ * 该结构描述 child 与其它兄弟控件/面板边界之间的关系。
+ * 注意：若约束存在循环依赖，布局引擎会尝试检测并避免无穷递归（实现中采用拓扑排序）。
+ */
+struct RelativeConstraints {
+    LayoutElement* AlignLeftWith = nullptr;
+    LayoutElement* AlignRightWith = nullptr;
+    LayoutElement* AlignTopWith = nullptr;
+    LayoutElement* AlignBottomWith = nullptr;
+    LayoutElement* LeftOf = nullptr;
+    LayoutElement* RightOf = nullptr;
+    LayoutElement* Above = nullptr;
+    LayoutElement* Below = nullptr;
+    bool AlignLeftWithPanel = false;
+    bool AlignRightWithPanel = false;
+    bool AlignTopWithPanel = false;
+    bool AlignBottomWithPanel = false;
+    bool CenterHorizontal = false;
+    bool CenterVertical = false;
+};
+
+/**
+ * @brief RelativePanel 布局引擎。
+ *
+ * - 约束以 child 为 key 进行存储
+ * - 排列阶段会根据依赖关系进行拓扑排序
+ */
+class RelativeLayoutEngine : public LayoutEngine {
+private:
+    std::map<LayoutElement*, RelativeConstraints> _constraints;
+    
+    // 拓扑排序以解决依赖关系
+    std::vector<LayoutElement*> TopologicalSort(LayoutElement* container);
+    bool HasCycle(LayoutElement* start, LayoutElement* current, std::map<LayoutElement*, int>& visited);
+    
+public:
+    /** @brief 设置某个子控件的相对约束。 */
+    void SetConstraints(LayoutElement* child, const RelativeConstraints& constraints) {
+        _constraints[child] = constraints;
+        Invalidate();
+    }
+    
+    /**
+     * @brief 获取某个子控件的相对约束。
+     * @return 不存在时返回 nullptr。
+     */
+    RelativeConstraints* GetConstraints(LayoutElement* child) {
+        auto it = _constraints.find(child);
+        if (it != _constraints.end())
+            return &(it->second);
+        return nullptr;
+    }
+    
+    LayoutSize Measure(LayoutElement* container, LayoutSize availableSize) override;
+    void Arrange(LayoutElement* container, LayoutRect finalRect) override;
+};
@@ -0,0 +1,172 @@
+#include "StackLayoutEngine.h"
+#include <algorithm>
+
+// StackLayoutEngine 实现
+
+LayoutSize StackLayoutEngine::Measure(LayoutElement* container, LayoutSize availableSize)
+{
+	if (!container) return {0, 0};
+	
+	LayoutSize desiredSize = {0, 0};
+	int visibleCount = 0;
+	
+	if (_orientation == Orientation::Vertical)
+	{
+		// 垂直堆叠：高度累加，宽度取最大
+		for (int i = 0; i < container->GetLayoutChildCount(); i++)
+		{
+			auto child = container->GetLayoutChild(i);
+			if (!child || !child->IsLayoutVisible()) continue;
+			
+			LayoutSize childSize = child->Measure(availableSize);
+			Thickness margin = child->GetLayoutMargin();
+			
+			// 计算包含边距的尺寸
+			int childWidth = childSize.cx + (int)(margin.Left + margin.Right);
+			int childHeight = childSize.cy + (int)(margin.Top + margin.Bottom);
+			
+			if (childWidth > desiredSize.cx)
+				desiredSize.cx = childWidth;
+			
+			desiredSize.cy += childHeight;
+			visibleCount++;
+		}
+		
+		// 添加间距
+		if (visibleCount > 1)
+		{
+			desiredSize.cy += (int)(_spacing * (visibleCount - 1));
+		}
+	}
+	else // Horizontal
+	{
+		// 水平堆叠：宽度累加，高度取最大
+		for (int i = 0; i < container->GetLayoutChildCount(); i++)
+		{
+			auto child = container->GetLayoutChild(i);
+			if (!child || !child->IsLayoutVisible()) continue;
+			
+			LayoutSize childSize = child->Measure(availableSize);
+			Thickness margin = child->GetLayoutMargin();
+			
+			// 计算包含边距的尺寸
+			int childWidth = childSize.cx + (int)(margin.Left + margin.Right);
+			int childHeight = childSize.cy + (int)(margin.Top + margin.Bottom);
+			
+			desiredSize.cx += childWidth;
+			
+			if (childHeight > desiredSize.cy)
+				desiredSize.cy = childHeight;
+			
+			visibleCount++;
+		}
+		
+		// 添加间距
+		if (visibleCount > 1)
+		{
+			desiredSize.cx += (int)(_spacing * (visibleCount - 1));
+		}
+	}
+	
+	_needsLayout = false;
+	return desiredSize;
+}
+
+void StackLayoutEngine::Arrange(LayoutElement* container, LayoutRect finalRect)
+{
+	if (!container) return;
+	
+	const float originX = finalRect.left;
+	const float originY = finalRect.top;
+	float currentX = originX;
+	float currentY = originY;
+	float containerWidth = finalRect.right - finalRect.left;
+	float containerHeight = finalRect.bottom - finalRect.top;
+	
+	if (_orientation == Orientation::Vertical)
+	{
+		// 垂直排列
+		for (int i = 0; i < container->GetLayoutChildCount(); i++)
+		{
+			auto child = container->GetLayoutChild(i);
+			if (!child || !child->IsLayoutVisible()) continue;
+			
+			LayoutSize childSize = child->GetLayoutSize();
+			LayoutSize actualSize = childSize;
+			bool useActualSize = child->TryGetActualLayoutSize(actualSize);
+			Thickness margin = child->GetLayoutMargin();
+			HorizontalAlignment hAlign = child->GetLayoutHAlign();
+			
+			// 计算实际宽度（考虑对齐方式）
+			float childWidth = (float)(useActualSize ? actualSize.cx : childSize.cx);
+			if (hAlign == HorizontalAlignment::Stretch)
+			{
+				childWidth = containerWidth - margin.Left - margin.Right;
+			}
+			
+			// 计算 X 位置（根据水平对齐）
+			float childX = margin.Left;
+			if (hAlign == HorizontalAlignment::Center)
+			{
+				childX = (containerWidth - childWidth) / 2.0f;
+			}
+			else if (hAlign == HorizontalAlignment::Right)
+			{
+				childX = containerWidth - childWidth - margin.Right;
+			}
+			
+			// 设置位置和尺寸
+			LayoutPoint loc = { (int)(originX + childX), (int)(currentY + margin.Top) };
+			float childHeight = (float)(useActualSize ? actualSize.cy : childSize.cy);
+			LayoutSize size = { (int)childWidth, (int)childHeight };
+			child->ApplyLayout(loc, size);
+			
+			// 移动到下一个位置
+			currentY += childHeight + margin.Top + margin.Bottom + _spacing;
+		}
+	}
+	else // Horizontal
+	{
+		// 水平排列
+		for (int i = 0; i < container->GetLayoutChildCount(); i++)
+		{
+			auto child = container->GetLayoutChild(i);
+			if (!child || !child->IsLayoutVisible()) continue;
+			
+			LayoutSize childSize = child->GetLayoutSize();
+			LayoutSize actualSize = childSize;
+			bool useActualSize = child->TryGetActualLayoutSize(actualSize);
+			Thickness margin = child->GetLayoutMargin();
+			VerticalAlignment vAlign = child->GetLayoutVAlign();
+			
+			// 计算实际高度（考虑对齐方式）
+			float childHeight = (float)(useActualSize ? actualSize.cy : childSize.cy);
+			if (vAlign == VerticalAlignment::Stretch)
+			{
+				childHeight = containerHeight - margin.Top - margin.Bottom;
+			}
+			
+			// 计算 Y 位置（根据垂直对齐）
+			float childY = margin.Top;
+			if (vAlign == VerticalAlignment::Center)
+			{
+				childY = (containerHeight - childHeight) / 2.0f;
+			}
+			else if (vAlign == VerticalAlignment::Bottom)
+			{
+				childY = containerHeight - childHeight - margin.Bottom;
+			}
+			
+			// 设置位置和尺寸
+			LayoutPoint loc = { (int)(currentX + margin.Left), (int)(originY + childY) };
+			float childWidth = (float)(useActualSize ? actualSize.cx : childSize.cx);
+			LayoutSize size = { (int)childWidth, (int)childHeight };
+			child->ApplyLayout(loc, size);
+			
+			// 移动到下一个位置
+			currentX += childWidth + margin.Left + margin.Right + _spacing;
+		}
+	}
+	
+	_needsLayout = false;
+}
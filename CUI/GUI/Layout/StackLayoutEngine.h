@@ -0,0 +1,57 @@
+#pragma once
+#include "LayoutEngine.h"
+#include "LayoutTypes.h"
+#include <algorithm>
+
+/**
+ * @file StackLayoutEngine.h
+ * @brief StackLayoutEngine：按主轴方向依次堆叠子项的布局引擎（不依赖 Win32）。
+ */
+
+/**
+ * @brief StackPanel 布局引擎。
+ *
+ * - Orientation 决定主轴方向（Horizontal/Vertical）
+ * - Spacing 控制相邻子控件之间的间距
+ */
+class StackLayoutEngine : public LayoutEngine {
+private:
+    Orientation _orientation = Orientation::Vertical;
+    float _spacing = 0.0f;
+    HorizontalAlignment _horizontalContentAlignment = HorizontalAlignment::Stretch;
+    VerticalAlignment _verticalContentAlignment = VerticalAlignment::Stretch;
+    
+public:
+    /** @brief 设置主轴方向。 */
+    void SetOrientation(Orientation value) { 
+        _orientation = value; 
+        Invalidate(); 
+    }
+    
+    Orientation GetOrientation() const { 
+        return _orientation; 
+    }
+    
+    /** @brief 设置子项间距（像素）。 */
+    void SetSpacing(float value) { 
+        _spacing = value; 
+        Invalidate(); 
+    }
+    
+    float GetSpacing() const { 
+        return _spacing; 
+    }
+    
+    void SetHorizontalContentAlignment(HorizontalAlignment value) {
+        _horizontalContentAlignment = value;
+        Invalidate();
+    }
+    
+    void SetVerticalContentAlignment(VerticalAlignment value) {
+        _verticalContentAlignment = value;
+        Invalidate();
+    }
+    
+    LayoutSize Measure(LayoutElement* container, LayoutSize availableSize) override;
+    void Arrange(LayoutElement* container, LayoutRect finalRect) override;
+};
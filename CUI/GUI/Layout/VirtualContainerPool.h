@@ -0,0 +1,134 @@
+#pragma once
+#include "LayoutElement.h"
+#include <functional>
+#include <map>
+#include <vector>
+
+/**
+ * @file VirtualContainerPool.h
+ * @brief VirtualContainerPool：虚拟化列表的容器实例化与回收（不依赖 Win32）。
+ *
+ * 记录“索引 -> 已实例化容器”；滚出区间的容器回收到池中，再次需要时重新绑定到新的索引。
+ * 容器的创建、绑定以及加入/移出宿主子项集合由宿主通过回调提供。
+ */
+
+/**
+ * @brief 容器池。
+ *
+ * T 须派生自 LayoutElement（Realized 直接交给 VirtualizingLayoutEngine 读取）。
+ * 已实例化的容器由宿主的子项集合持有；池中的容器由宿主通过 Clear/ReleasePooled 释放。
+ */
+template<class T>
+class VirtualContainerPool
+{
+public:
+    /** @brief 池为空时创建新容器（返回 nullptr 表示无法创建）。 */
+    std::function<T*()> Create;
+    /** @brief 把容器绑定到数据项索引（新建或复用时调用，可为空）。 */
+    std::function<void(T*, int)> Bind;
+    /** @brief 把容器加入宿主的子项集合。 */
+    std::function<void(T*)> Attach;
+    /** @brief 把容器移出宿主的子项集合（回收前调用）。 */
+    std::function<void(T*)> Detach;
+
+    /** @brief 回收 [first,last) 之外的容器，并为区间内缺失的索引实例化容器。 */
+    void RealizeRange(int first, int last)
+    {
+        for (auto it = _realized.begin(); it != _realized.end();)
+        {
+            if (it->first < first || it->first >= last)
+            {
+                T* c = static_cast<T*>(it->second);
+                if (Detach) Detach(c);
+                _pool.push_back(c);
+                it = _realized.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        for (int i = first; i < last; i++)
+        {
+            if (_realized.find(i) != _realized.end()) continue;
+            T* c = Acquire();
+            if (!c) break;
+            if (Bind) Bind(c, i);
+            _realized[i] = c;
+        }
+    }
+
+    /** @brief 指定索引的容器；未实例化时返回 nullptr。 */
+    T* Find(int index) const
+    {
+        auto it = _realized.find(index);
+        return it == _realized.end() ? nullptr : static_cast<T*>(it->second);
+    }
+
+    /** @brief 容器当前绑定的索引；不是已实例化容器时返回 -1。 */
+    int IndexOf(const T* c) const
+    {
+        for (auto& it : _realized)
+        {
+            if (it.second == c)
+                return it.first;
+        }
+        return -1;
+    }
+
+    /** @brief 重新绑定索引小于 count 的已实例化容器（超出的在下次 RealizeRange 时回收）。 */
+    void Rebind(int count)
+    {
+        if (!Bind) return;
+        for (auto& it : _realized)
+        {
+            if (it.first < count)
+                Bind(static_cast<T*>(it.second), it.first);
+        }
+    }
+
+    /** @brief 移出并释放全部容器（模板变化、旧容器不能复用时调用）。 */
+    void Clear(const std::function<void(T*)>& destroy)
+    {
+        for (auto& it : _realized)
+        {
+            T* c = static_cast<T*>(it.second);
+            if (Detach) Detach(c);
+            destroy(c);
+        }
+        _realized.clear();
+        ReleasePooled(destroy);
+    }
+
+    /** @brief 释放池中空闲的容器。 */
+    void ReleasePooled(const std::function<void(T*)>& destroy)
+    {
+        for (auto c : _pool)
+            destroy(c);
+        _pool.clear();
+    }
+
+    const std::map<int, LayoutElement*>& Realized() const { return _realized; }
+    int RealizedCount() const { return (int)_realized.size(); }
+    int PooledCount() const { return (int)_pool.size(); }
+
+private:
+    std::map<int, LayoutElement*> _realized;
+    std::vector<T*> _pool;
+
+    T* Acquire()
+    {
+        T* c = nullptr;
+        if (!_pool.empty())
+        {
+            c = _pool.back();
+            _pool.pop_back();
+        }
+        else if (Create)
+        {
+            c = Create();
+        }
+        if (c && Attach) Attach(c);
+        return c;
+    }
+};
@@ -0,0 +1,72 @@
+#include "VirtualizingExtent.h"
+#include <algorithm>
+
+void VirtualizingExtent::Update(int count, float itemMain, float itemCross, float spacing, bool wrap,
+	float viewportMain, float viewportCross)
+{
+	ItemMain = itemMain < 1.0f ? 1.0f : itemMain;
+	ItemCross = itemCross < 0.0f ? 0.0f : itemCross;
+	Spacing = spacing;
+	LineExtent = ItemMain + spacing;
+	CrossExtent = ItemCross + spacing;
+	ItemsPerLine = 1;
+	if (wrap && CrossExtent > 0.0f)
+		ItemsPerLine = (std::max)(1, (int)((viewportCross + spacing) / CrossExtent));
+	ItemCount = count < 0 ? 0 : count;
+	const int lines = LineCount();
+	TotalExtent = lines > 0 ? (float)lines * LineExtent - spacing : 0.0f;
+	ViewportExtent = viewportMain;
+}
+
+int VirtualizingExtent::LineCount() const
+{
+	return (ItemCount + ItemsPerLine - 1) / ItemsPerLine;
+}
+
+float VirtualizingExtent::MaxScrollOffset() const
+{
+	return (std::max)(0.0f, TotalExtent - ViewportExtent);
+}
+
+float VirtualizingExtent::ClampScrollOffset(float offset) const
+{
+	const float maxOffset = MaxScrollOffset();
+	if (offset > maxOffset) offset = maxOffset;
+	if (offset < 0.0f) offset = 0.0f;
+	return offset;
+}
+
+void VirtualizingExtent::RealizedRange(float offset, int overscan, int& first, int& last) const
+{
+	first = 0;
+	last = 0;
+	const int lines = LineCount();
+	if (lines <= 0 || !IsValid()) return;
+	int firstLine = (int)(offset / LineExtent) - overscan;
+	int lastLine = (int)((offset + ViewportExtent) / LineExtent) + overscan;
+	if (firstLine < 0) firstLine = 0;
+	if (lastLine > lines - 1) lastLine = lines - 1;
+	if (lastLine < firstLine) return;
+	first = firstLine * ItemsPerLine;
+	last = (std::min)(ItemCount, (lastLine + 1) * ItemsPerLine);
+}
+
+float VirtualizingExtent::MainOffsetOf(int index) const
+{
+	return (float)(index / ItemsPerLine) * LineExtent;
+}
+
+float VirtualizingExtent::CrossOffsetOf(int index) const
+{
+	return (float)(index % ItemsPerLine) * CrossExtent;
+}
+
+float VirtualizingExtent::ScrollIntoView(int index, float offset) const
+{
+	if (index < 0 || index >= ItemCount) return offset;
+	const float top = MainOffsetOf(index);
+	const float bottom = top + ItemMain;
+	if (top < offset) return top;
+	if (bottom > offset + ViewportExtent) return bottom - ViewportExtent;
+	return offset;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+/**
+ * @file VirtualizingExtent.h
+ * @brief VirtualizingExtent：虚拟化列表的长度、可见区间与滚动位置计算（不依赖 Win32）。
+ *
+ * 子项在主轴方向尺寸固定，按“行”（换行模式下一行含多项）计算，
+ * 结果只与视口长度有关，与数据项数量无关。
+ */
+
+/** @brief 虚拟化列表的行参数（由 Update 计算）与区间计算。 */
+struct VirtualizingExtent
+{
+    /** @brief 子项在主轴/交叉轴方向的尺寸（含 Margin）。 */
+    float ItemMain = 0.0f;
+    float ItemCross = 0.0f;
+    /** @brief 每行(列)占用的主轴长度、每项占用的交叉轴长度（均含间距）。 */
+    float LineExtent = 0.0f;
+    float CrossExtent = 0.0f;
+    float Spacing = 0.0f;
+    int ItemsPerLine = 1;
+    int ItemCount = 0;
+    /** @brief 主轴方向的内容总长度与视口长度。 */
+    float TotalExtent = 0.0f;
+    float ViewportExtent = 0.0f;
+
+    /**
+     * @brief 根据子项尺寸与视口重新计算。
+     * @param wrap 是否在交叉轴方向换行；否则每行一项。
+     */
+    void Update(int count, float itemMain, float itemCross, float spacing, bool wrap,
+        float viewportMain, float viewportCross);
+    /** @brief 是否已经计算过（尚未布局时不知道内容长度）。 */
+    bool IsValid() const { return LineExtent > 0.0f; }
+    int LineCount() const;
+    /** @brief 最大滚动偏移（内容不足一屏时为 0）。 */
+    float MaxScrollOffset() const;
+    /** @brief 把滚动偏移限制到 [0, MaxScrollOffset]。 */
+    float ClampScrollOffset(float offset) const;
+    /**
+     * @brief 滚动偏移为 offset 时需要实例化的索引区间 [first,last)：视口内的行加前后各 overscan 行。
+     * 没有数据项时 first == last == 0。
+     */
+    void RealizedRange(float offset, int overscan, int& first, int& last) const;
+    /** @brief 索引所在位置的主轴起点（未减滚动偏移）与交叉轴起点。 */
+    float MainOffsetOf(int index) const;
+    float CrossOffsetOf(int index) const;
+    /** @brief 使 index 完整可见所需的滚动偏移；已完整可见时返回 offset。 */
+    float ScrollIntoView(int index, float offset) const;
+};
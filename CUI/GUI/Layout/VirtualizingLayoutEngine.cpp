@@ -0,0 +1,119 @@
+#include "VirtualizingLayoutEngine.h"
+#include <algorithm>
+
+// VirtualizingLayoutEngine 实现
+
+void VirtualizingLayoutEngine::ResolveItemSize(VirtualizingLayoutHost* host, LayoutSize availableSize, float& itemMain, float& itemCross)
+{
+	const bool vertical = _orientation == Orientation::Vertical;
+	float width = _itemWidth;
+	float height = _itemHeight;
+	if ((width <= 0.0f || height <= 0.0f) && host->GetItemCount() > 0)
+	{
+		// 未指定固定尺寸：以首个已实例化容器(没有则实例化索引 0)的测量尺寸为准
+		if (host->GetRealized().empty())
+			host->RealizeRange(0, 1);
+		if (!host->GetRealized().empty())
+		{
+			LayoutElement* probe = host->GetRealized().begin()->second;
+			LayoutSize s = probe->Measure(availableSize);
+			Thickness margin = probe->GetLayoutMargin();
+			if (width <= 0.0f) width = (float)s.cx + margin.Left + margin.Right;
+			if (height <= 0.0f) height = (float)s.cy + margin.Top + margin.Bottom;
+		}
+	}
+
+	itemMain = vertical ? height : width;
+	itemCross = vertical ? width : height;
+	// 非换行模式下交叉轴拉伸到面板宽(高)
+	if (!_wrap)
+		itemCross = (float)(vertical ? availableSize.cx : availableSize.cy);
+}
+
+LayoutSize VirtualizingLayoutEngine::Measure(LayoutElement* container, LayoutSize availableSize)
+{
+	auto host = dynamic_cast<VirtualizingLayoutHost*>(container);
+	if (!host)
+	{
+		_needsLayout = false;
+		return { 0, 0 };
+	}
+
+	const bool vertical = _orientation == Orientation::Vertical;
+	const float availMain = (float)(vertical ? availableSize.cy : availableSize.cx);
+	const float availCross = (float)(vertical ? availableSize.cx : availableSize.cy);
+
+	float itemMain = 0.0f;
+	float itemCross = 0.0f;
+	ResolveItemSize(host, availableSize, itemMain, itemCross);
+	_extent.Update(host->GetItemCount(), itemMain, itemCross, _spacing, _wrap, availMain, availCross);
+
+	const float scrollOffset = _extent.ClampScrollOffset(host->GetScrollOffset());
+	if (scrollOffset != host->GetScrollOffset()) host->CoerceScrollOffset(scrollOffset);
+
+	// 可见行区间 + Overscan，只与视口长度有关
+	int first = 0;
+	int last = 0;
+	_extent.RealizedRange(scrollOffset, _overscan, first, last);
+	host->RealizeRange(first, last);
+
+	for (auto& it : host->GetRealized())
+	{
+		LayoutElement* child = it.second;
+		if (!child->IsLayoutVisible()) continue;
+		Thickness margin = child->GetLayoutMargin();
+		float slotW = vertical ? _extent.ItemCross : _extent.ItemMain;
+		float slotH = vertical ? _extent.ItemMain : _extent.ItemCross;
+		LayoutSize slot = {
+			(int)(std::max)(0.0f, slotW - margin.Left - margin.Right),
+			(int)(std::max)(0.0f, slotH - margin.Top - margin.Bottom)
+		};
+		child->Measure(slot);
+	}
+
+	float desiredCross = _wrap ? (float)_extent.ItemsPerLine * _extent.CrossExtent - _spacing : _extent.ItemCross;
+	if (desiredCross < 0.0f) desiredCross = 0.0f;
+	_needsLayout = false;
+	return vertical
+		? LayoutSize{ (int)desiredCross, (int)_extent.TotalExtent }
+		: LayoutSize{ (int)_extent.TotalExtent, (int)desiredCross };
+}
+
+void VirtualizingLayoutEngine::Arrange(LayoutElement* container, LayoutRect finalRect)
+{
+	auto host = dynamic_cast<VirtualizingLayoutHost*>(container);
+	if (!host)
+	{
+		_needsLayout = false;
+		return;
+	}
+
+	const bool vertical = _orientation == Orientation::Vertical;
+	const float originX = finalRect.left;
+	const float originY = finalRect.top;
+	const float offset = host->GetScrollOffset();
+
+	for (auto& it : host->GetRealized())
+	{
+		LayoutElement* child = it.second;
+		if (!child->IsLayoutVisible()) continue;
+
+		const int index = it.first;
+		float main = _extent.MainOffsetOf(index) - offset;
+		float cross = _extent.CrossOffsetOf(index);
+
+		Thickness margin = child->GetLayoutMargin();
+		float x = originX + (vertical ? cross : main) + margin.Left;
+		float y = originY + (vertical ? main : cross) + margin.Top;
+		float w = (vertical ? _extent.ItemCross : _extent.ItemMain) - margin.Left - margin.Right;
+		float h = (vertical ? _extent.ItemMain : _extent.ItemCross) - margin.Top - margin.Bottom;
+		if (w < 0) w = 0;
+		if (h < 0) h = 0;
+
+		LayoutPoint loc = { (int)x, (int)y };
+		LayoutSize size = { (int)w, (int)h };
+		child->ApplyLayout(loc, size);
+	}
+
+	_needsLayout = false;
+}
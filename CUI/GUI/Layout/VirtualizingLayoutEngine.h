@@ -0,0 +1,122 @@
+#pragma once
+#include "LayoutEngine.h"
+#include "LayoutTypes.h"
+#include "VirtualizingExtent.h"
+#include <map>
+
+/**
+ * @file VirtualizingLayoutEngine.h
+ * @brief VirtualizingLayoutEngine：只测量与排列可见数据项的虚拟化布局引擎（不依赖 Win32）。
+ */
+
+/**
+ * @brief 虚拟化布局的宿主（VirtualizingStackPanel 实现）。
+ *
+ * 提供数据项数量与滚动偏移，并按索引区间实例化/回收子项容器。
+ */
+class VirtualizingLayoutHost {
+public:
+    virtual ~VirtualizingLayoutHost() = default;
+
+    /** @brief 数据项数量。 */
+    virtual int GetItemCount() const = 0;
+    /** @brief 主轴方向滚动偏移（像素）。 */
+    virtual float GetScrollOffset() const = 0;
+    /** @brief 布局期间把滚动偏移限制到内容范围内（不触发滚动事件）。 */
+    virtual void CoerceScrollOffset(float value) = 0;
+    /** @brief 回收 [first,last) 之外的容器，并为区间内缺失的索引实例化容器。 */
+    virtual void RealizeRange(int first, int last) = 0;
+    /** @brief 已实例化的容器（索引 -> 容器）。 */
+    virtual const std::map<int, LayoutElement*>& GetRealized() const = 0;
+};
+
+/**
+ * @brief VirtualizingStackPanel 布局引擎。
+ *
+ * 容器须实现 VirtualizingLayoutHost。
+ * Measure 阶段根据滚动偏移计算可见区间并让宿主实例化/回收容器，
+ * 只测量已实例化的容器；Arrange 阶段按索引直接计算位置。
+ * Wrap=true 时按 WrapPanel 的方式在交叉轴方向排布多个子项。
+ */
+class VirtualizingLayoutEngine : public LayoutEngine {
+private:
+    Orientation _orientation = Orientation::Vertical;
+    float _spacing = 0.0f;
+    float _itemWidth = 0.0f;   // 0表示使用首个容器的测量宽度
+    float _itemHeight = 0.0f;  // 0表示使用首个容器的测量高度
+    bool _wrap = false;
+    int _overscan = 2;
+
+    // 最近一次 Measure 的结果，供 Arrange 与滚动计算使用
+    VirtualizingExtent _extent;
+
+    // 子项在主轴/交叉轴方向的尺寸（含 Margin）
+    void ResolveItemSize(VirtualizingLayoutHost* host, LayoutSize availableSize, float& itemMain, float& itemCross);
+
+public:
+    /** @brief 设置主轴（滚动）方向。 */
+    void SetOrientation(Orientation value) {
+        _orientation = value;
+        Invalidate();
+    }
+
+    Orientation GetOrientation() const {
+        return _orientation;
+    }
+
+    /** @brief 设置子项间距（像素，主轴与交叉轴相同）。 */
+    void SetSpacing(float value) {
+        _spacing = value;
+        Invalidate();
+    }
+
+    float GetSpacing() const {
+        return _spacing;
+    }
+
+    /**
+     * @brief 设置固定子项尺寸（像素）。
+     * 0 表示使用首个容器的测量尺寸；非换行模式下交叉轴尺寸会拉伸到面板宽(高)。
+     */
+    void SetItemSize(float width, float height) {
+        _itemWidth = width;
+        _itemHeight = height;
+        Invalidate();
+    }
+
+    float GetItemWidth() const {
+        return _itemWidth;
+    }
+
+    float GetItemHeight() const {
+        return _itemHeight;
+    }
+
+    /** @brief 设置是否在交叉轴方向换行（WrapPanel 行为）。 */
+    void SetWrap(bool value) {
+        _wrap = value;
+        Invalidate();
+    }
+
+    bool GetWrap() const {
+        return _wrap;
+    }
+
+    /** @brief 设置视口前后额外实例化的行(列)数。 */
+    void SetOverscan(int lines) {
+        _overscan = lines < 0 ? 0 : lines;
+        Invalidate();
+    }
+
+    int GetOverscan() const {
+        return _overscan;
+    }
+
+    /** @brief 最近一次 Measure 算出的行参数（总长度、视口长度、滚动范围等）。 */
+    const VirtualizingExtent& GetExtent() const {
+        return _extent;
+    }
+
+    LayoutSize Measure(LayoutElement* container, LayoutSize availableSize) override;
+    void Arrange(LayoutElement* container, LayoutRect finalRect) override;
+};
@@ -0,0 +1,156 @@
+#include "VirtualizingStackPanel.h"
+#include "../Form.h"
+
+// VirtualizingStackPanel 实现
+
+VirtualizingStackPanel::VirtualizingStackPanel()
+{
+	Initialize();
+}
+
+VirtualizingStackPanel::VirtualizingStackPanel(int x, int y, int width, int height)
+	: Panel(x, y, width, height)
+{
+	Initialize();
+}
+
+VirtualizingStackPanel::~VirtualizingStackPanel()
+{
+	// 已实例化的容器在 Children 中，由 Control 的析构函数释放；池中的容器由面板释放
+	_containers.ReleasePooled([](Control* c) { delete c; });
+}
+
+void VirtualizingStackPanel::Initialize()
+{
+	_virtualEngine = new VirtualizingLayoutEngine();
+	SetLayoutEngine(_virtualEngine);
+	// 直接走 Control::AddControl：布局进行中，不需要再次 InvalidateLayout
+	_containers.Attach = [this](Control* c) { Control::AddControl(c); };
+	_containers.Detach = [this](Control* c)
+		{
+			if (this->ParentForm && this->ParentForm->Selected == c)
+				this->ParentForm->Selected = NULL;
+			this->RemoveControl(c);
+		};
+}
+
+void VirtualizingStackPanel::SetItemTemplate(VirtualItemFactory factory, VirtualItemBinder binder)
+{
+	// 旧模板创建的容器不能复用
+	_containers.Clear([](Control* c) { delete c; });
+	_containers.Create = factory;
+	_containers.Bind = binder;
+	InvalidateLayout();
+	PostRender();
+}
+
+void VirtualizingStackPanel::SetItemCount(int count)
+{
+	if (count < 0) count = 0;
+	_itemCount = count;
+	// 超出新数量的容器在下次布局时回收，其余按新数据重新绑定
+	_containers.Rebind(count);
+	InvalidateLayout();
+	PostRender();
+}
+
+void VirtualizingStackPanel::SetScrollOffset(float value)
+{
+	const auto& extent = _virtualEngine->GetExtent();
+	if (value < 0.0f) value = 0.0f;
+	// 尚未布局时不知道内容长度，留给 Measure 限制
+	if (extent.IsValid() && value > extent.MaxScrollOffset())
+		value = extent.MaxScrollOffset();
+	if (value == _scrollOffset) return;
+	_scrollOffset = value;
+	InvalidateLayout();
+	this->OnScrollChanged(this);
+	PostRender();
+}
+
+void VirtualizingStackPanel::ScrollIntoView(int index)
+{
+	if (index < 0 || index >= _itemCount) return;
+	if (!_virtualEngine->GetExtent().IsValid())
+	{
+		InvalidateLayout();
+		PerformLayout();
+	}
+	SetScrollOffset(_virtualEngine->GetExtent().ScrollIntoView(index, _scrollOffset));
+}
+
+Control* VirtualizingStackPanel::ContainerFromIndex(int index)
+{
+	return _containers.Find(index);
+}
+
+int VirtualizingStackPanel::IndexFromContainer(Control* c)
+{
+	return _containers.IndexOf(c);
+}
+
+void VirtualizingStackPanel::RefreshItem(int index)
+{
+	Control* c = ContainerFromIndex(index);
+	if (!c || !_containers.Bind) return;
+	_containers.Bind(c, index);
+	PostRender();
+}
+
+void VirtualizingStackPanel::RefreshItems()
+{
+	if (!_containers.Bind) return;
+	_containers.Rebind(_itemCount);
+	PostRender();
+}
+
+void VirtualizingStackPanel::DrawScroll()
+{
+	const auto& extent = _virtualEngine->GetExtent();
+	if (extent.TotalExtent <= extent.ViewportExtent || extent.TotalExtent <= 0.0f) return;
+	auto d2d = this->ParentForm->Render;
+	auto abslocation = this->AbsLocation;
+	auto size = this->ActualSize();
+	const bool vertical = _virtualEngine->GetOrientation() == Orientation::Vertical;
+	const float track = (float)(vertical ? size.cy : size.cx);
+	float block = (extent.ViewportExtent / extent.TotalExtent) * track;
+	if (block < track * 0.1f) block = track * 0.1f;
+	float maxOffset = extent.MaxScrollOffset();
+	float per = maxOffset > 0.0f ? _scrollOffset / maxOffset : 0.0f;
+	float blockStart = per * (track - block);
+	if (vertical)
+	{
+		float x = abslocation.x + size.cx - 8.0f;
+		d2d->FillRoundRect(x, abslocation.y, 8.0f, track, this->ScrollBackColor, 4.0f);
+		d2d->FillRoundRect(x, abslocation.y + blockStart, 8.0f, block, this->ScrollForeColor, 4.0f);
+	}
+	else
+	{
+		float y = abslocation.y + size.cy - 8.0f;
+		d2d->FillRoundRect(abslocation.x, y, track, 8.0f, this->ScrollBackColor, 4.0f);
+		d2d->FillRoundRect(abslocation.x + blockStart, y, block, 8.0f, this->ScrollForeColor, 4.0f);
+	}
+}
+
+void VirtualizingStackPanel::Update()
+{
+	if (this->IsVisual == false) return;
+	Panel::Update();
+	auto absRect = this->AbsRect;
+	auto d2d = this->ParentForm->Render;
+	d2d->PushDrawRect(absRect.left, absRect.top, absRect.right - absRect.left, absRect.bottom - absRect.top);
+	this->DrawScroll();
+	d2d->PopDrawRect();
+}
+
+bool VirtualizingStackPanel::ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int xof, int yof)
+{
+	if (!this->Enable || !this->Visible) return true;
+	if (message == WM_MOUSEWHEEL)
+	{
+		float step = this->WheelStep > 0.0f ? this->WheelStep : _virtualEngine->GetExtent().LineExtent * 3.0f;
+		float ticks = (float)GET_WHEEL_DELTA_WPARAM(wParam) / (float)WHEEL_DELTA;
+		SetScrollOffset(_scrollOffset - ticks * step);
+	}
+	return Panel::ProcessMessage(message, wParam, lParam, xof, yof);
+}
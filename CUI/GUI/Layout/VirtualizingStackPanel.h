@@ -0,0 +1,108 @@
+#pragma once
+#include "../Panel.h"
+#include "VirtualizingLayoutEngine.h"
+#include "VirtualContainerPool.h"
+#include "LayoutTypes.h"
+#include <functional>
+#include <map>
+
+/**
+ * @file VirtualizingStackPanel.h
+ * @brief VirtualizingStackPanel：只实例化可见子项的虚拟化堆叠/换行容器。
+ *
+ * 与 StackPanel/WrapPanel 不同，子项不是预先 AddControl 进来的控件，而是由
+ * ItemCount + 模板回调描述的“数据项”：
+ * - 只有视口内（加上少量 Overscan）的数据项会拥有容器控件并参与 Measure/Arrange
+ * - 滚出视口的容器回收到池中，下次需要时重新绑定到新的索引
+ * - 子项在主轴方向上的尺寸固定（ItemWidth/ItemHeight，未设置时以首个容器的测量结果为准），
+ *   因此无需遍历全部数据项即可算出总长度和可见区间
+ *
+ * 布局与内存开销只与可见项数量有关，与 ItemCount 无关。
+ */
+
+class VirtualizingStackPanel;
+
+/** @brief 创建一个新的子项容器（池为空时调用）。 */
+typedef std::function<Control*()> VirtualItemFactory;
+/** @brief 将容器绑定到指定索引的数据项（新建或复用容器时调用）。 */
+typedef std::function<void(Control* container, int index)> VirtualItemBinder;
+
+/**
+ * @brief VirtualizingStackPanel 控件类。
+ *
+ * 用法：SetItemTemplate 提供创建/绑定回调，再 SetItemCount。
+ * Children 只包含当前已实例化的容器，由面板自行管理，不要手动 AddControl/RemoveControl。
+ * 池中的容器由面板持有并在析构时释放。
+ */
+class VirtualizingStackPanel : public Panel, public VirtualizingLayoutHost {
+private:
+    VirtualizingLayoutEngine* _virtualEngine;
+    VirtualContainerPool<Control> _containers;
+    int _itemCount = 0;
+    float _scrollOffset = 0.0f;
+
+    void Initialize();
+    void RealizeRange(int first, int last) override { _containers.RealizeRange(first, last); }
+    void CoerceScrollOffset(float value) override { _scrollOffset = value; }
+    const std::map<int, LayoutElement*>& GetRealized() const override { return _containers.Realized(); }
+    void DrawScroll();
+
+public:
+    VirtualizingStackPanel();
+    VirtualizingStackPanel(int x, int y, int width, int height);
+    virtual ~VirtualizingStackPanel();
+
+    UIClass Type() override { return UIClass::UI_VirtualizingStackPanel; }
+
+    D2D1_COLOR_F ScrollBackColor = Colors::LightGray;
+    D2D1_COLOR_F ScrollForeColor = Colors::DimGrey;
+    /** @brief 每个滚轮刻度滚动的像素，0 表示三行。 */
+    float WheelStep = 0.0f;
+
+    /** @brief 设置子项模板：factory 创建容器，binder 把容器绑定到数据项索引。 */
+    void SetItemTemplate(VirtualItemFactory factory, VirtualItemBinder binder);
+    /** @brief 设置数据项数量；已实例化的容器会按新数据重新绑定。 */
+    void SetItemCount(int count);
+    int GetItemCount() const override { return _itemCount; }
+
+    /** @brief 设置/获取主轴方向。 */
+    void SetOrientation(Orientation value) { _virtualEngine->SetOrientation(value); }
+    Orientation GetOrientation() const { return _virtualEngine->GetOrientation(); }
+
+    /** @brief 设置/获取子项间距（像素）。 */
+    void SetSpacing(float value) { _virtualEngine->SetSpacing(value); }
+    float GetSpacing() const { return _virtualEngine->GetSpacing(); }
+
+    /** @brief 设置固定子项尺寸（像素），见 VirtualizingLayoutEngine::SetItemSize。 */
+    void SetItemSize(float width, float height) { _virtualEngine->SetItemSize(width, height); }
+
+    /** @brief 设置/获取是否换行排列。 */
+    void SetWrap(bool value) { _virtualEngine->SetWrap(value); }
+    bool GetWrap() const { return _virtualEngine->GetWrap(); }
+
+    /** @brief 设置/获取视口外额外实例化的行(列)数。 */
+    void SetOverscan(int lines) { _virtualEngine->SetOverscan(lines); }
+    int GetOverscan() const { return _virtualEngine->GetOverscan(); }
+
+    /** @brief 主轴方向滚动偏移（像素），设置时会被限制在内容范围内。 */
+    float GetScrollOffset() const override { return _scrollOffset; }
+    void SetScrollOffset(float value);
+    /** @brief 滚动使指定索引完整可见。 */
+    void ScrollIntoView(int index);
+
+    /** @brief 获取指定索引的容器；未实例化时返回 NULL。 */
+    Control* ContainerFromIndex(int index);
+    /** @brief 获取容器当前绑定的索引；不是已实例化容器时返回 -1。 */
+    int IndexFromContainer(Control* c);
+    /** @brief 重新绑定指定索引（数据变化后调用；未实例化时忽略）。 */
+    void RefreshItem(int index);
+    /** @brief 重新绑定所有已实例化的容器。 */
+    void RefreshItems();
+
+    /** @brief 当前已实例化 / 池中空闲的容器数量。 */
+    int RealizedCount() const { return _containers.RealizedCount(); }
+    int PooledCount() const { return _containers.PooledCount(); }
+
+    void Update() override;
+    bool ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int xof, int yof) override;
+};
@@ -0,0 +1,203 @@
+#include "WrapLayoutEngine.h"
+#include <algorithm>
+#include <vector>
+
+// WrapLayoutEngine 实现
+
+LayoutSize WrapLayoutEngine::Measure(LayoutElement* container, LayoutSize availableSize)
+{
+	if (!container) return {0, 0};
+	
+	LayoutSize desiredSize = {0, 0};
+	
+	if (_orientation == Orientation::Horizontal)
+	{
+		// 水平方向：从左到右排列，超出换行
+		float lineWidth = 0.0f;
+		float lineHeight = 0.0f;
+		float totalHeight = 0.0f;
+		float maxLineWidth = 0.0f;
+		
+		for (int i = 0; i < container->GetLayoutChildCount(); i++)
+		{
+			auto child = container->GetLayoutChild(i);
+			if (!child || !child->IsLayoutVisible()) continue;
+			
+			LayoutSize childSize = child->Measure(availableSize);
+			Thickness margin = child->GetLayoutMargin();
+			
+			float itemWidth = _itemWidth > 0 ? _itemWidth : (float)childSize.cx;
+			float itemHeight = _itemHeight > 0 ? _itemHeight : (float)childSize.cy;
+			float totalItemWidth = itemWidth + margin.Left + margin.Right;
+			float totalItemHeight = itemHeight + margin.Top + margin.Bottom;
+			
+			// 检查是否需要换行
+			if (lineWidth + totalItemWidth > availableSize.cx && lineWidth > 0)
+			{
+				// 换行
+				if (lineWidth > maxLineWidth)
+					maxLineWidth = lineWidth;
+				totalHeight += lineHeight;
+				lineWidth = totalItemWidth;
+				lineHeight = totalItemHeight;
+			}
+			else
+			{
+				lineWidth += totalItemWidth;
+				if (totalItemHeight > lineHeight)
+					lineHeight = totalItemHeight;
+			}
+		}
+		
+		// 最后一行
+		if (lineWidth > maxLineWidth)
+			maxLineWidth = lineWidth;
+		totalHeight += lineHeight;
+		
+		desiredSize.cx = (int)maxLineWidth;
+		desiredSize.cy = (int)totalHeight;
+	}
+	else // Vertical
+	{
+		// 垂直方向：从上到下排列，超出换列
+		float columnHeight = 0.0f;
+		float columnWidth = 0.0f;
+		float totalWidth = 0.0f;
+		float maxColumnHeight = 0.0f;
+		
+		for (int i = 0; i < container->GetLayoutChildCount(); i++)
+		{
+			auto child = container->GetLayoutChild(i);
+			if (!child || !child->IsLayoutVisible()) continue;
+			
+			LayoutSize childSize = child->Measure(availableSize);
+			Thickness margin = child->GetLayoutMargin();
+			
+			float itemWidth = _itemWidth > 0 ? _itemWidth : (float)childSize.cx;
+			float itemHeight = _itemHeight > 0 ? _itemHeight : (float)childSize.cy;
+			float totalItemWidth = itemWidth + margin.Left + margin.Right;
+			float totalItemHeight = itemHeight + margin.Top + margin.Bottom;
+			
+			// 检查是否需要换列
+			if (columnHeight + totalItemHeight > availableSize.cy && columnHeight > 0)
+			{
+				// 换列
+				if (columnHeight > maxColumnHeight)
+					maxColumnHeight = columnHeight;
+				totalWidth += columnWidth;
+				columnHeight = totalItemHeight;
+				columnWidth = totalItemWidth;
+			}
+			else
+			{
+				columnHeight += totalItemHeight;
+				if (totalItemWidth > columnWidth)
+					columnWidth = totalItemWidth;
+			}
+		}
+		
+		// 最后一列
+		if (columnHeight > maxColumnHeight)
+			maxColumnHeight = columnHeight;
+		totalWidth += columnWidth;
+		
+		desiredSize.cx = (int)totalWidth;
+		desiredSize.cy = (int)maxColumnHeight;
+	}
+	
+	_needsLayout = false;
+	return desiredSize;
+}
+
+void WrapLayoutEngine::Arrange(LayoutElement* container, LayoutRect finalRect)
+{
+	if (!container) return;
+	
+	const float originX = finalRect.left;
+	const float originY = finalRect.top;
+	float containerWidth = finalRect.right - finalRect.left;
+	float containerHeight = finalRect.bottom - finalRect.top;
+	
+	if (_orientation == Orientation::Horizontal)
+	{
+		// 水平布局：从左到右，自动换行
+		float x = 0.0f;
+		float y = 0.0f;
+		float lineHeight = 0.0f;
+		
+		for (int i = 0; i < container->GetLayoutChildCount(); i++)
+		{
+			auto child = container->GetLayoutChild(i);
+			if (!child || !child->IsLayoutVisible()) continue;
+			
+			LayoutSize childSize = child->GetLayoutSize();
+			LayoutSize actualSize = childSize;
+			bool useActualSize = child->TryGetActualLayoutSize(actualSize);
+			Thickness margin = child->GetLayoutMargin();
+			
+			float itemWidth = _itemWidth > 0 ? _itemWidth : (float)(useActualSize ? actualSize.cx : childSize.cx);
+			float itemHeight = _itemHeight > 0 ? _itemHeight : (float)(useActualSize ? actualSize.cy : childSize.cy);
+			float totalItemWidth = itemWidth + margin.Left + margin.Right;
+			float totalItemHeight = itemHeight + margin.Top + margin.Bottom;
+			
+			// 检查是否需要换行
+			if (x + totalItemWidth > containerWidth && x > 0)
+			{
+				x = 0.0f;
+				y += lineHeight;
+				lineHeight = 0.0f;
+			}
+			
+			// 设置子控件位置
+			LayoutPoint loc = { (int)(originX + x + margin.Left), (int)(originY + y + margin.Top) };
+			LayoutSize size = { (int)itemWidth, (int)itemHeight };
+			child->ApplyLayout(loc, size);
+			
+			x += totalItemWidth;
+			if (totalItemHeight > lineHeight)
+				lineHeight = totalItemHeight;
+		}
+	}
+	else // Vertical
+	{
+		// 垂直布局：从上到下，自动换列
+		float x = 0.0f;
+		float y = 0.0f;
+		float columnWidth = 0.0f;
+		
+		for (int i = 0; i < container->GetLayoutChildCount(); i++)
+		{
+			auto child = container->GetLayoutChild(i);
+			if (!child || !child->IsLayoutVisible()) continue;
+			
+			LayoutSize childSize = child->GetLayoutSize();
+			LayoutSize actualSize = childSize;
+			bool useActualSize = child->TryGetActualLayoutSize(actualSize);
+			Thickness margin = child->GetLayoutMargin();
+			
+			float itemWidth = _itemWidth > 0 ? _itemWidth : (float)(useActualSize ? actualSize.cx : childSize.cx);
+			float itemHeight = _itemHeight > 0 ? _itemHeight : (float)(useActualSize ? actualSize.cy : childSize.cy);
+			float totalItemWidth = itemWidth + margin.Left + margin.Right;
+			float totalItemHeight = itemHeight + margin.Top + margin.Bottom;
+			
+			// 检查是否需要换列
+			if (y + totalItemHeight > containerHeight && y > 0)
+			{
+				y = 0.0f;
+				x += columnWidth;
+				columnWidth = 0.0f;
+			}
+			
+			// 设置子控件位置
+			LayoutPoint loc = { (int)(originX + x + margin.Left), (int)(originY + y + margin.Top) };
+			LayoutSize size = { (int)itemWidth, (int)itemHeight };
+			child->ApplyLayout(loc, size);
+			
+			y += totalItemHeight;
+			if (totalItemWidth > columnWidth)
+				columnWidth = totalItemWidth;
+		}
+	}
+	
+	_needsLayout = false;
+}
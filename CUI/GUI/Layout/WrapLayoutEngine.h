@@ -0,0 +1,62 @@
+#pragma once
+#include "LayoutEngine.h"
+#include "LayoutTypes.h"
+
+/**
+ * @file WrapLayoutEngine.h
+ * @brief WrapLayoutEngine：按行/列自动换行排列子项的布局引擎（不依赖 Win32）。
+ */
+
+/**
+ * @brief WrapPanel 布局引擎。
+ *
+ * Orientation=Horizontal：按行从左到右排列，空间不足则换到下一行。
+ * Orientation=Vertical：按列从上到下排列，空间不足则换到下一列。
+ * ItemWidth/ItemHeight 为 0 时使用子控件自身测量尺寸。
+ */
+class WrapLayoutEngine : public LayoutEngine {
+private:
+    Orientation _orientation = Orientation::Horizontal;
+    float _itemWidth = 0.0f;   // 0表示使用控件自身宽度
+    float _itemHeight = 0.0f;  // 0表示使用控件自身高度
+    
+public:
+    /** @brief 设置换行方向（主轴）。 */
+    void SetOrientation(Orientation value) {
+        _orientation = value;
+        Invalidate();
+    }
+    
+    Orientation GetOrientation() const {
+        return _orientation;
+    }
+    
+    /**
+     * @brief 设置统一子项宽度（像素）。
+     * 0 表示使用子控件自身宽度。
+     */
+    void SetItemWidth(float value) {
+        _itemWidth = value;
+        Invalidate();
+    }
+    
+    float GetItemWidth() const {
+        return _itemWidth;
+    }
+    
+    /**
+     * @brief 设置统一子项高度（像素）。
+     * 0 表示使用子控件自身高度。
+     */
+    void SetItemHeight(float value) {
+        _itemHeight = value;
+        Invalidate();
+    }
+    
+    float GetItemHeight() const {
+        return _itemHeight;
+    }
+    
+    LayoutSize Measure(LayoutElement* container, LayoutSize availableSize) override;
+    void Arrange(LayoutElement* container, LayoutRect finalRect) override;
+};
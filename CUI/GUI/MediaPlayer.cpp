@@ -2,6 +2,7 @@
 
 #include "MediaPlayer.h"
 #include "Form.h"
+#include "WsolaTimeStretch.h"
 #include <d3d11_1.h>
 #include <d2d1helper.h>
 #include <algorithm>
@@ -28,6 +29,7 @@
 
 // 常量定义
 static constexpr double HNS_PER_SEC = 10000000.0;  // 100-nanosecond 单位与秒的转换
+static constexpr double VIDEO_DECODE_LEAD_SEC = 0.03; // 视频帧提前解码入队的时间（秒）
 
 static float ClampRate(float rate)
 {
@@ -67,16 +69,28 @@ static double QpcTicksToMs(UINT64 ticks)
 	return (double)ticks * 1000.0 / (double)f.QuadPart;
 }
 
-static inline uint8_t Clip8(int v)
+static UINT64 QpcTicksToMicros(LONGLONG ticks)
 {
-	return (uint8_t)((v < 0) ? 0 : (v > 255 ? 255 : v));
+	const auto f = QpcFreq();
+	if (f.QuadPart <= 0 || ticks <= 0) return 0;
+	return (UINT64)((double)ticks * 1000000.0 / (double)f.QuadPart);
 }
 
-// NV12 (Y + interleaved UV) -> BGRA
+// 视频帧时间戳使用的时钟（秒）：与播放线程的 startQpc 时间线一致
+static double QpcSeconds()
+{
+	const auto f = QpcFreq();
+	if (f.QuadPart <= 0) return 0.0;
+	return (double)QpcNow().QuadPart / (double)f.QuadPart;
+}
+
+// NV12 / P010 (Y + interleaved UV) -> BGRA
 // 说明：这是 CPU 后备/分析路径，目标是把 MF 的 video processing 从 ReadSample 里挪出来，便于定位瓶颈。
-void MediaPlayer::ConvertNV12ToBGRA(
-	const uint8_t* nv12,
-	size_t nv12Bytes,
+// 行转换由 YuvToBgraConverter 完成（SSE2/AVX2 运行时选择）；4K60 单线程即可跟上，只有标量后备才按行并行。
+bool MediaPlayer::ConvertYuvToBGRA(
+	const YuvToBgraConverter& converter,
+	const uint8_t* src,
+	size_t srcBytes,
 	UINT32 yStride,
 	UINT32 width,
 	UINT32 height,
@@ -84,83 +98,41 @@ void MediaPlayer::ConvertNV12ToBGRA(
 	UINT32 cropY,
 	UINT32 visibleW,
 	UINT32 visibleH,
-	std::vector<uint8_t>& outBgra)
+	uint8_t* outBgra,
+	UINT32 outStride)
 {
-	if (!nv12 || yStride == 0 || width == 0 || height == 0 || visibleW == 0 || visibleH == 0) return;
-	// 需要保证 UV 对齐：NV12 的 UV 采样为 2x2
+	if (!src || !outBgra || yStride == 0 || width == 0 || height == 0 || visibleW == 0 || visibleH == 0) return false;
+	if (outStride < visibleW * 4) return false;
+	// 色度按 2x2 采样：水平起点需要落在 UV 对上；奇数宽度的最后一列复用前一对色度
 	const UINT32 cx = cropX & ~1u;
-	const UINT32 cy = cropY & ~1u;
-	UINT32 w = (visibleW & ~1u);
-	UINT32 h = (visibleH & ~1u);
-	if (cx >= width || cy >= height) return;
-	if (cy + h > height) h = (height - cy) & ~1u;
-	if (cx + w > width) w = (width - cx) & ~1u;
-	if (w == 0 || h == 0) return;
-
-	// stride 需要能覆盖可视宽度，否则会越界
-	if (yStride <= cx) return;
-	UINT32 maxWByStride = (yStride - cx) & ~1u;
-	if (w > maxWByStride) w = maxWByStride;
-	if (w == 0) return;
+	const UINT32 cy = cropY;
+	const UINT32 w = visibleW;
+	const UINT32 h = visibleH;
+	if ((size_t)cx + w > width || (size_t)cy + h > height) return false;
 
-	const UINT32 uvStride = yStride;
-	if (uvStride <= cx) return;
-	UINT32 maxWByUvStride = (uvStride - cx) & ~1u;
-	if (w > maxWByUvStride) w = maxWByUvStride;
-	if (w == 0) return;
+	// stride 需要能覆盖可视宽度（含色度对补齐），否则会越界
+	const size_t sampleBytes = (converter.Format() == YuvFormat::P010) ? 2 : 1;
+	if (((size_t)cx + (((size_t)w + 1) & ~(size_t)1)) * sampleBytes > yStride) return false;
 
-	// 检查 buffer 大小：Y plane + UV plane
+	// 检查 buffer 大小：Y plane + UV plane（UV 与 Y 同 stride）
+	const UINT32 uvStride = yStride;
 	const UINT32 uvRows = (height + 1) / 2;
 	const size_t yBytes = (size_t)yStride * (size_t)height;
 	const size_t uvBytes = (size_t)uvStride * (size_t)uvRows;
-	if (yBytes > nv12Bytes) return;
-	if (uvBytes > (nv12Bytes - yBytes)) return;
-
-	const uint8_t* yPlane = nv12;
-	const uint8_t* uvPlane = nv12 + yBytes;
+	if (yBytes > srcBytes) return false;
+	if (uvBytes > (srcBytes - yBytes)) return false;
 
-	outBgra.resize((size_t)w * (size_t)h * 4);
+	const uint8_t* yPlane = src + (size_t)cx * sampleBytes;
+	const uint8_t* uvPlane = src + yBytes + (size_t)cx * sampleBytes;
 
 	auto convertRow = [&](UINT32 row)
 	{
-		const uint8_t* yRow = yPlane + (size_t)(cy + row) * (size_t)yStride + cx;
-		const uint8_t* uvRow = uvPlane + (size_t)((cy + row) / 2) * (size_t)uvStride + cx;
-		uint8_t* dst = outBgra.data() + (size_t)row * (size_t)w * 4;
-
-		for (UINT32 col = 0; col < w; col += 2)
-		{
-			const int U = (int)uvRow[col + 0] - 128;
-			const int V = (int)uvRow[col + 1] - 128;
-			const int c0 = (int)yRow[col + 0] - 16;
-			const int c1 = (int)yRow[col + 1] - 16;
-			const int C0 = (c0 < 0) ? 0 : c0;
-			const int C1 = (c1 < 0) ? 0 : c1;
-
-			// BT.601-ish integer approximation.
-			const int rAdd = 409 * V;
-			const int gAdd = -100 * U - 208 * V;
-			const int bAdd = 516 * U;
-
-			int r = (298 * C0 + rAdd + 128) >> 8;
-			int g = (298 * C0 + gAdd + 128) >> 8;
-			int b = (298 * C0 + bAdd + 128) >> 8;
-			dst[(size_t)col * 4 + 0] = Clip8(b);
-			dst[(size_t)col * 4 + 1] = Clip8(g);
-			dst[(size_t)col * 4 + 2] = Clip8(r);
-			dst[(size_t)col * 4 + 3] = 0xFF;
-
-			r = (298 * C1 + rAdd + 128) >> 8;
-			g = (298 * C1 + gAdd + 128) >> 8;
-			b = (298 * C1 + bAdd + 128) >> 8;
-			dst[(size_t)(col + 1) * 4 + 0] = Clip8(b);
-			dst[(size_t)(col + 1) * 4 + 1] = Clip8(g);
-			dst[(size_t)(col + 1) * 4 + 2] = Clip8(r);
-			dst[(size_t)(col + 1) * 4 + 3] = 0xFF;
-		}
+		const uint8_t* yRow = yPlane + (size_t)(cy + row) * (size_t)yStride;
+		const uint8_t* uvRow = uvPlane + (size_t)((cy + row) / 2) * (size_t)uvStride;
+		converter.ConvertRow(yRow, uvRow, outBgra + (size_t)row * (size_t)outStride, w);
 	};
 
-	// 4K 帧行数大，按行并行可明显降低 VConv；小帧保持串行减少调度开销。
-	if (h >= 256)
+	if (converter.Kernel() == YuvKernel::Scalar && h >= 256)
 	{
 		Concurrency::parallel_for(0, (int)h, [&](int r) { convertRow((UINT32)r); });
 	}
@@ -168,6 +140,15 @@ void MediaPlayer::ConvertNV12ToBGRA(
 	{
 		for (UINT32 row = 0; row < h; row++) convertRow(row);
 	}
+	return true;
+}
+
+// 零拷贝挂接到 VideoFrame 的 IMFMediaBuffer（已 Lock + AddRef）：帧回收时解锁并释放
+static void ReleaseLockedMediaBuffer(void* owner)
+{
+	auto* buffer = (IMFMediaBuffer*)owner;
+	buffer->Unlock();
+	buffer->Release();
 }
 
 #pragma comment(lib, "d3d11.lib")
@@ -188,357 +169,6 @@ static bool IsFloatMixFormat(const WAVEFORMATEX* wf)
 	return false;
 }
 
-class WsolaTimeStretch
-{
-public:
-	WsolaTimeStretch(UINT32 sampleRate, UINT32 channels, bool isFloat, UINT32 bitsPerSample)
-		: _sampleRate(sampleRate), _channels(channels), _isFloat(isFloat), _bitsPerSample(bitsPerSample)
-	{
-		Configure(sampleRate, channels);
-	}
-
-	void Configure(UINT32 sampleRate, UINT32 channels)
-	{
-		_sampleRate = sampleRate;
-		_channels = channels;
-		// 典型 WSOLA 参数：20ms 窗，10ms overlap，10ms search
-		_windowFrames = (UINT32)std::clamp((int)std::lround((double)sampleRate * 0.020), 256, 4096);
-		_overlapFrames = (UINT32)std::clamp((int)std::lround((double)sampleRate * 0.010), 128, (int)_windowFrames / 2);
-		_searchFrames = (UINT32)std::clamp((int)std::lround((double)sampleRate * 0.010), 64, (int)_windowFrames);
-		_hopOutFrames = _windowFrames - _overlapFrames;
-		Reset();
-	}
-
-	void Reset()
-	{
-		_in.clear();
-		_baseFrame = 0;
-		_nextPredFrame = 0;
-		_hasTail = false;
-		_tail.clear();
-		_out.clear();
-	}
-
-	void SetTempo(float tempo)
-	{
-		_tempo = ClampRate(tempo);
-		_hopInFrames = (UINT32)std::clamp((int)std::lround((double)_hopOutFrames * (double)_tempo), 1, (int)(_windowFrames * 4));
-	}
-
-	// 输入一段 PCM（mix format），输出尽可能多的已合成 PCM（同格式）。
-	bool ProcessChunk(const void* inData, size_t inBytes, float tempo, float volume, std::vector<uint8_t>& outBytes)
-	{
-		outBytes.clear();
-		if (!inData || inBytes == 0 || _channels == 0) return true;
-		SetTempo(tempo);
-
-		// bytes -> float frames
-		_tmpInFloat.clear();
-		if (!BytesToFloat(inData, inBytes, _channels, _bitsPerSample, _isFloat, _tmpInFloat))
-			return false;
-		const size_t inFrames = _tmpInFloat.size() / _channels;
-		if (inFrames == 0) return true;
-		AppendInput(_tmpInFloat.data(), inFrames);
-
-		// 生成输出（float）
-		Generate();
-		if (_out.empty()) return true;
-
-		// 音量（float域）
-		if (volume < 0.999f)
-		{
-			volume = (float)std::clamp(volume, 0.0f, 1.0f);
-			for (float& v : _out)
-				v *= volume;
-		}
-
-		// float -> bytes
-		_tmpOutBytes.clear();
-		FloatToBytes(_out.data(), _out.size() / _channels, _channels, _bitsPerSample, _isFloat, _tmpOutBytes);
-		_out.clear();
-		outBytes = std::move(_tmpOutBytes);
-		return true;
-	}
-
-private:
-	UINT32 _sampleRate = 0;
-	UINT32 _channels = 0;
-	bool _isFloat = false;
-	UINT32 _bitsPerSample = 0;
-
-	float _tempo = 1.0f;
-	UINT32 _windowFrames = 0;
-	UINT32 _overlapFrames = 0;
-	UINT32 _searchFrames = 0;
-	UINT32 _hopOutFrames = 0;
-	UINT32 _hopInFrames = 0;
-
-	std::vector<float> _in;            // interleaved
-	size_t _baseFrame = 0;             // absolute frame index for _in[0]
-	size_t _nextPredFrame = 0;         // absolute predicted start for next segment
-
-	bool _hasTail = false;
-	std::vector<float> _tail;          // overlapFrames * channels (tail of last segment)
-	std::vector<float> _out;           // synthesized output frames, interleaved
-
-	std::vector<float> _tmpInFloat;
-	std::vector<uint8_t> _tmpOutBytes;
-
-	static bool BytesToFloat(const void* data, size_t bytes, UINT32 channels, UINT32 bits, bool isFloat, std::vector<float>& out)
-	{
-		const size_t bps = bits / 8;
-		if (bps == 0) return false;
-		const size_t frameBytes = bps * (size_t)channels;
-		if (frameBytes == 0) return false;
-		const size_t frames = bytes / frameBytes;
-		if (frames == 0) return true;
-		out.resize(frames * (size_t)channels);
-
-		const uint8_t* p = (const uint8_t*)data;
-		if (bits == 32 && isFloat)
-		{
-			memcpy(out.data(), p, frames * (size_t)channels * sizeof(float));
-			return true;
-		}
-		if (bits == 16)
-		{
-			const int16_t* s = (const int16_t*)p;
-			for (size_t i = 0; i < frames * (size_t)channels; i++)
-				out[i] = (float)s[i] / 32768.0f;
-			return true;
-		}
-		if (bits == 32 && !isFloat)
-		{
-			const int32_t* s = (const int32_t*)p;
-			for (size_t i = 0; i < frames * (size_t)channels; i++)
-				out[i] = (float)((double)s[i] / 2147483648.0);
-			return true;
-		}
-		return false;
-	}
-
-	static void FloatToBytes(const float* in, size_t frames, UINT32 channels, UINT32 bits, bool isFloat, std::vector<uint8_t>& out)
-	{
-		const size_t total = frames * (size_t)channels;
-		if (bits == 32 && isFloat)
-		{
-			out.resize(total * sizeof(float));
-			memcpy(out.data(), in, out.size());
-			return;
-		}
-		if (bits == 16)
-		{
-			out.resize(total * sizeof(int16_t));
-			auto* d = (int16_t*)out.data();
-			for (size_t i = 0; i < total; i++)
-			{
-				float v = std::clamp(in[i], -1.0f, 1.0f);
-				int iv = (int)std::lround(v * 32767.0f);
-				d[i] = (int16_t)std::clamp(iv, -32768, 32767);
-			}
-			return;
-		}
-		// fallback：直接静音输出
-		out.assign(total * (bits / 8), 0);
-	}
-
-	void AppendInput(const float* frames, size_t frameCount)
-	{
-		const size_t old = _in.size();
-		_in.resize(old + frameCount * (size_t)_channels);
-		memcpy(_in.data() + old, frames, frameCount * (size_t)_channels * sizeof(float));
-	}
-
-	size_t AvailableFrames() const
-	{
-		return _in.size() / (size_t)_channels;
-	}
-
-	const float* FramePtrAbs(size_t absFrame) const
-	{
-		const size_t rel = absFrame - _baseFrame;
-		return _in.data() + rel * (size_t)_channels;
-	}
-
-	// 搜索与 tail 最匹配的候选起点
-	size_t FindBestStart(size_t predStartAbs)
-	{
-		if (!_hasTail || _overlapFrames == 0) return predStartAbs;
-		const size_t availAbsEnd = _baseFrame + AvailableFrames();
-		if (availAbsEnd <= _baseFrame + _windowFrames) return predStartAbs;
-		const size_t maxStart = availAbsEnd - _windowFrames;
-
-		size_t startMin = (predStartAbs > _searchFrames) ? (predStartAbs - _searchFrames) : _baseFrame;
-		if (startMin < _baseFrame) startMin = _baseFrame;
-		size_t startMax = predStartAbs + _searchFrames;
-		if (startMax > maxStart) startMax = maxStart;
-		if (startMin > startMax) startMin = startMax;
-
-		// 归一化相关（NCC）比简单点积更稳，能显著降低撕裂感；并用 coarse-to-fine 降低 CPU。
-		const UINT32 overlap = _overlapFrames;
-		const UINT32 chs = _channels;
-		const size_t strideSamples = (size_t)chs;
-
-		// 采样步长：overlap 越大越稀疏（降低运算量），但保留足够判别力。
-		const UINT32 iStep = (overlap >= 1024) ? 4u : (overlap >= 512 ? 2u : 1u);
-		const size_t sCoarseStep = (overlap >= 512) ? 2u : 1u;
-
-		auto nccScore = [&](size_t startAbs, UINT32 localIStep) -> double
-		{
-			double dot = 0.0;
-			double ea = 0.0;
-			double eb = 0.0;
-			for (UINT32 i = 0; i < overlap; i += localIStep)
-			{
-				const float* a = _tail.data() + (size_t)i * strideSamples;
-				const float* b = FramePtrAbs(startAbs + i);
-				for (UINT32 c = 0; c < chs; c++)
-				{
-					double av = (double)a[c];
-					double bv = (double)b[c];
-					dot += av * bv;
-					ea += av * av;
-					eb += bv * bv;
-				}
-			}
-			const double denom = std::sqrt(ea * eb) + 1e-12;
-			return dot / denom;
-		};
-
-		double bestScore = -1e300;
-		size_t best = startMin;
-		for (size_t s = startMin; s <= startMax; s += sCoarseStep)
-		{
-			double score = nccScore(s, iStep);
-			if (score > bestScore)
-			{
-				bestScore = score;
-				best = s;
-			}
-			if (s >= startMax - sCoarseStep) break; // size_t 防溢出
-		}
-
-		// 精细搜索：在 coarse 最优点附近用更密集采样再对齐一次。
-		{
-			const size_t refineRadius = (size_t)std::min<UINT32>(8u, overlap / 8u + 1u);
-			size_t r0 = (best > refineRadius) ? (best - refineRadius) : startMin;
-			size_t r1 = best + refineRadius;
-			if (r0 < startMin) r0 = startMin;
-			if (r1 > startMax) r1 = startMax;
-
-			bestScore = -1e300;
-			for (size_t s = r0; s <= r1; s++)
-			{
-				double score = nccScore(s, 1u);
-				if (score > bestScore)
-				{
-					bestScore = score;
-					best = s;
-				}
-				if (s == r1) break;
-			}
-		}
-
-		return best;
-	}
-
-	void EmitFirst(const float* seg)
-	{
-		// 输出 window-overlap，尾部 overlap 先缓存，等待下次与新段融合后再输出
-		const size_t emitFrames = _windowFrames - _overlapFrames;
-		_out.insert(_out.end(), seg, seg + emitFrames * (size_t)_channels);
-		_tail.assign(seg + emitFrames * (size_t)_channels, seg + (size_t)_windowFrames * (size_t)_channels);
-		_hasTail = true;
-	}
-
-	void EmitNext(const float* seg)
-	{
-		// 先输出融合后的 overlap
-		if (_overlapFrames > 0)
-		{
-			for (UINT32 i = 0; i < _overlapFrames; i++)
-			{
-				// Raised-cosine crossfade（比线性更不容易产生撕裂/毛刺）
-				float w = 1.0f;
-				if (_overlapFrames > 1)
-				{
-					const float x = (float)i / (float)(_overlapFrames - 1);
-					w = 0.5f - 0.5f * std::cos(3.14159265358979323846f * x);
-				}
-				for (UINT32 ch = 0; ch < _channels; ch++)
-				{
-					float a = _tail[(size_t)i * (size_t)_channels + ch];
-					float b = seg[(size_t)i * (size_t)_channels + ch];
-					_out.push_back(a * (1.0f - w) + b * w);
-				}
-			}
-		}
-
-		// 输出中间部分（window - 2*overlap），尾部 overlap 缓存
-		const UINT32 midStart = _overlapFrames;
-		const UINT32 midEnd = (_windowFrames > _overlapFrames) ? (_windowFrames - _overlapFrames) : _overlapFrames;
-		if (midEnd > midStart)
-		{
-			const float* p0 = seg + (size_t)midStart * (size_t)_channels;
-			const float* p1 = seg + (size_t)midEnd * (size_t)_channels;
-			_out.insert(_out.end(), p0, p1);
-		}
-		_tail.assign(seg + (size_t)(_windowFrames - _overlapFrames) * (size_t)_channels, seg + (size_t)_windowFrames * (size_t)_channels);
-		_hasTail = true;
-	}
-
-	void MaybeDropOldInput()
-	{
-		// 保留 search 窗口之前的一点余量即可
-		if (_nextPredFrame <= _baseFrame) return;
-		size_t keepFrom = (_nextPredFrame > _searchFrames) ? (_nextPredFrame - _searchFrames) : _baseFrame;
-		if (keepFrom <= _baseFrame) return;
-		size_t dropFrames = keepFrom - _baseFrame;
-		// 不要频繁 erase；累计到一定规模再 compact
-		if (dropFrames < 4096) return;
-		const size_t dropSamples = dropFrames * (size_t)_channels;
-		if (dropSamples >= _in.size())
-		{
-			_in.clear();
-			_baseFrame = keepFrom;
-			return;
-		}
-		_in.erase(_in.begin(), _in.begin() + (ptrdiff_t)dropSamples);
-		_baseFrame = keepFrom;
-	}
-
-	void Generate()
-	{
-		if (_windowFrames == 0 || _hopOutFrames == 0) return;
-		const size_t availAbsEnd = _baseFrame + AvailableFrames();
-
-		if (!_hasTail)
-		{
-			if (availAbsEnd < _baseFrame + _windowFrames) return;
-			const float* seg = FramePtrAbs(_baseFrame);
-			EmitFirst(seg);
-			_nextPredFrame = _baseFrame + _hopInFrames;
-			MaybeDropOldInput();
-		}
-
-		for (;;)
-		{
-			// 需要保证候选段可用
-			if (availAbsEnd < _nextPredFrame + _windowFrames) break;
-			size_t bestStart = FindBestStart(_nextPredFrame);
-			// 关键：保证起点单调前进。
-			// 在慢速(tempo<1)时，相关性搜索可能回跳到更早的位置，导致 _nextPredFrame 不前进，
-			// 从而在同一段输入上无限生成输出，最终表现为“进度卡住/音频异常”。
-			if (bestStart < _nextPredFrame) bestStart = _nextPredFrame;
-			if (availAbsEnd < bestStart + _windowFrames) break;
-			const float* seg = FramePtrAbs(bestStart);
-			EmitNext(seg);
-			_nextPredFrame = bestStart + _hopInFrames;
-			MaybeDropOldInput();
-		}
-	}
-};
-
 static void ApplyVolume(void* data, size_t bytes, UINT32 bitsPerSample, float volume, bool isFloat)
 {
 	if (!data || bytes == 0) return;
@@ -1002,14 +632,27 @@ bool MediaPlayer::InitWasapi()
 	hr = _audioClient->GetMixFormat(&_audioMixFormat);
 	if (FAILED(hr) || !_audioMixFormat) { DebugOutputHr(L"WASAPI: GetMixFormat", hr); return false; }
 
-	// Use shared mode, event-driven not required.
+	// 共享模式 + 事件驱动：设备每个周期触发一次 _audioEvent，渲染线程据此补充缓冲。
 	REFERENCE_TIME bufferDuration = 1000000; // 100ms
-	hr = _audioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, 0, bufferDuration, 0, _audioMixFormat, nullptr);
+	hr = _audioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, AUDCLNT_STREAMFLAGS_EVENTCALLBACK, bufferDuration, 0, _audioMixFormat, nullptr);
 	if (FAILED(hr)) { DebugOutputHr(L"WASAPI: Initialize", hr); return false; }
 
 	hr = _audioClient->GetBufferSize(&_audioBufferFrameCount);
 	if (FAILED(hr)) { DebugOutputHr(L"WASAPI: GetBufferSize", hr); return false; }
 
+	// 事件不可用时渲染线程按设备周期轮询
+	_audioEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+	if (_audioEvent && FAILED(hr = _audioClient->SetEventHandle(_audioEvent)))
+	{
+		DebugOutputHr(L"WASAPI: SetEventHandle", hr);
+		CloseHandle(_audioEvent);
+		_audioEvent = nullptr;
+	}
+
+	REFERENCE_TIME devicePeriod = 0;
+	if (FAILED(_audioClient->GetDevicePeriod(&devicePeriod, nullptr)))
+		devicePeriod = 0;
+
 	hr = _audioClient->GetService(IID_PPV_ARGS(&_audioRenderClient));
 	if (FAILED(hr)) { DebugOutputHr(L"WASAPI: GetService IAudioRenderClient", hr); return false; }
 
@@ -1018,6 +661,10 @@ bool MediaPlayer::InitWasapi()
 	_audioBitsPerSample = _audioMixFormat->wBitsPerSample;
 	_audioBlockAlign = _audioMixFormat->nBlockAlign;
 	_audioBytesPerSec = _audioMixFormat->nAvgBytesPerSec;
+	_audioPeriodFrames = (UINT32)((double)devicePeriod * (double)_audioSamplesPerSec / HNS_PER_SEC + 0.5);
+	_audioRing.Configure((size_t)_audioSamplesPerSec, _audioBlockAlign);
+	_audioPacer.Configure(_audioSamplesPerSec, _audioBufferFrameCount, _audioPeriodFrames);
+	_audioPeriodFrames = _audioPacer.PeriodFrames();
 	_timeStretch.reset();
 
 	return true;
@@ -1038,6 +685,13 @@ void MediaPlayer::ShutdownWasapi()
 		_audioMixFormat = nullptr;
 	}
 	_audioBufferFrameCount = 0;
+	_audioPeriodFrames = 0;
+	_audioRing.Configure(0, 0);
+	if (_audioEvent)
+	{
+		CloseHandle(_audioEvent);
+		_audioEvent = nullptr;
+	}
 }
 
 bool MediaPlayer::ConfigureSourceReaderVideoType()
@@ -1048,6 +702,7 @@ bool MediaPlayer::ConfigureSourceReaderVideoType()
 	// RGB32 (BGRA) 是最兼容的格式，Direct2D 原生支持
 	GUID formats[] = {
 		MFVideoFormat_NV12,
+		MFVideoFormat_P010, // 10 位源（HEVC Main10 等）不接受 NV12 时
 		MFVideoFormat_RGB32,
 		MFVideoFormat_ARGB32,
 		MFVideoFormat_RGB24,
@@ -1055,7 +710,8 @@ bool MediaPlayer::ConfigureSourceReaderVideoType()
 
 	for (int i = 0; i < (int)(sizeof(formats) / sizeof(formats[0])); i++)
 	{
-		if (!_preferNv12VideoOutput && formats[i] == MFVideoFormat_NV12)
+		const bool yuv = (formats[i] == MFVideoFormat_NV12 || formats[i] == MFVideoFormat_P010);
+		if (!_preferNv12VideoOutput && yuv)
 			continue;
 		ComPtr<IMFMediaType> mt;
 		if (FAILED(MFCreateMediaType(&mt)) || !mt) continue;
@@ -1068,7 +724,7 @@ bool MediaPlayer::ConfigureSourceReaderVideoType()
 		HRESULT hr = _sourceReader->SetCurrentMediaType(_srVideoStream, nullptr, mt.Get());
 		if (SUCCEEDED(hr))
 		{
-			_usingNv12VideoOutput = (formats[i] == MFVideoFormat_NV12);
+			_usingNv12VideoOutput = yuv;
 			// 刷新当前视频格式信息（尺寸/stride/像素格式/aperture）
 			UpdateVideoFormatFromSourceReader();
 			return true;
@@ -1165,6 +821,13 @@ void MediaPlayer::UpdateVideoFormatFromSourceReader()
 				bytesPerPixel = 1;
 				if (stride == 0 || stride < w) stride = w;
 			}
+			else if (subtype == MFVideoFormat_P010)
+			{
+				// P010: 同 NV12 布局，每个样本 16 位（有效位在高 10 位）。stride 以字节计。
+				bottomUp = false;
+				bytesPerPixel = 2;
+				if (stride == 0 || stride < w * 2) stride = w * 2;
+			}
 			else if (subtype == MFVideoFormat_RGB24)
 			{
 				// RGB24: 每像素3字节，但需要对齐到4字节边界
@@ -1178,9 +841,34 @@ void MediaPlayer::UpdateVideoFormatFromSourceReader()
 				if (stride == 0) stride = w * 4;
 			}
 
+			YuvToBgraConverter yuvConverter;
+			if (subtype == MFVideoFormat_NV12 || subtype == MFVideoFormat_P010)
+			{
+				// 矩阵/范围缺省时按惯例：高清（>= 720 行）BT.709，标清 BT.601；有限范围
+				YuvMatrix matrix = (h >= 720) ? YuvMatrix::Bt709 : YuvMatrix::Bt601;
+				switch (MFGetAttributeUINT32(mt.Get(), MF_MT_YUV_MATRIX, MFVideoTransferMatrix_Unknown))
+				{
+				case MFVideoTransferMatrix_BT601:
+					matrix = YuvMatrix::Bt601;
+					break;
+				case MFVideoTransferMatrix_BT709:
+					matrix = YuvMatrix::Bt709;
+					break;
+				case MFVideoTransferMatrix_BT2020_10:
+				case MFVideoTransferMatrix_BT2020_12:
+					matrix = YuvMatrix::Bt2020;
+					break;
+				default:
+					break;
+				}
+				const bool fullRange = MFGetAttributeUINT32(mt.Get(), MF_MT_VIDEO_NOMINAL_RANGE, MFNominalRange_Unknown) == MFNominalRange_0_255;
+				yuvConverter = YuvToBgraConverter(subtype == MFVideoFormat_P010 ? YuvFormat::P010 : YuvFormat::Nv12, matrix, fullRange);
+			}
+
 			{
 				std::scoped_lock lock(_videoFrameMutex);
 				_videoSubtype = subtype;
+				_videoYuvConverter = yuvConverter;
 				_videoBytesPerPixel = bytesPerPixel;
 				_videoBottomUp = bottomUp;
 			}
@@ -1473,64 +1161,124 @@ void MediaPlayer::StopSourceReaderPlayback(bool shutdown)
 	}
 }
 
-bool MediaPlayer::WriteAudioToWasapi(const BYTE* data, UINT32 bytes)
+bool MediaPlayer::WriteAudioToRing(const BYTE* data, UINT32 bytes, double pts)
 {
-	if (!_audioClient || !_audioRenderClient || !_audioMixFormat) return false;
+	const UINT32 frameBytes = _audioRing.FrameBytes();
+	if (frameBytes == 0 || !_audioRenderThread.joinable() || _audioRenderFailed) return false;
 	if (!data || bytes == 0) return true;
 
+	// 估计这块音频的出声时刻：排在它前面的是环内未读帧与设备中排队的帧（后者为上一个周期的值）。
+	// 倍速时 WSOLA 内部还缓存少量输入，估计值会偏早几毫秒。
+	if (_audioSamplesPerSec > 0 && _threadPlaying.load())
+	{
+		const double queuedFrames = (double)_audioRing.ReadableFrames() + (double)_audioPacer.DeviceQueuedFrames();
+		_telemetry.RecordAudioLateness(QpcSeconds() + queuedFrames / (double)_audioSamplesPerSec - pts);
+	}
+
 	_statAudioWriteCalls.fetch_add(1, std::memory_order_relaxed);
 	_statAudioWriteBytes.fetch_add(bytes, std::memory_order_relaxed);
 	const LARGE_INTEGER t0 = QpcNow();
 
-	// 防止卡死：若音频引擎未推进（padding 永远满）或外部已请求停止，避免在此无限等待。
+	// 环满说明已提前了足够多的音频：等渲染线程按设备周期取走。
+	// 防止卡死：若渲染线程不再推进或外部已请求停止/Seek，避免在此无限等待。
 	const ULONGLONG startTick = GetTickCount64();
 
-	UINT32 offset = 0;
-	while (offset < bytes)
+	const size_t frames = bytes / frameBytes;
+	size_t done = 0;
+	while (done < frames)
 	{
-		if (_threadExit || !_threadPlaying.load())
+		done += _audioRing.Write(data + done * frameBytes, frames - done);
+		if (done == frames) break;
+
+		if (_threadExit || !_threadPlaying.load() || _needSyncReset || _audioRenderFailed)
+			return false;
+		if (GetTickCount64() - startTick > 2000)
+		{
+			DebugOutputHr(L"Audio ring: write timeout (render thread never drains)", E_FAIL);
 			return false;
+		}
+		Sleep(1);
+	}
+	const LARGE_INTEGER t1 = QpcNow();
+	_statAudioWriteQpcTicks.fetch_add((UINT64)(t1.QuadPart - t0.QuadPart), std::memory_order_relaxed);
+	return true;
+}
 
-		UINT32 padding = 0;
-		HRESULT hr = _audioClient->GetCurrentPadding(&padding);
-		if (FAILED(hr)) { DebugOutputHr(L"WASAPI: GetCurrentPadding", hr); return false; }
-		UINT32 availableFrames = _audioBufferFrameCount - padding;
-		if (availableFrames == 0)
+void MediaPlayer::AudioRenderThreadMain()
+{
+	HRESULT hrCo = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+	// MMCSS：设备周期的唤醒不被普通优先级的线程（解码/UI）拖延
+	DWORD mmcssTask = 0;
+	HANDLE mmcss = AvSetMmThreadCharacteristicsW(L"Pro Audio", &mmcssTask);
+
+	const UINT32 sampleRate = (std::max)(1u, _audioSamplesPerSec);
+	const DWORD periodMs = (std::max)(1u, (UINT32)((UINT64)_audioPeriodFrames * 1000 / sampleRate));
+	bool started = false;
+
+	// 设备缓冲里可能残留上一次播放的音频
+	(void)_audioClient->Stop();
+	(void)_audioClient->Reset();
+	_audioPacer.Reset();
+
+	while (!_audioRenderExit)
+	{
+		// 事件模式下设备每个周期触发一次；设备停止（暂停）后不再触发，按两个周期的超时轮询状态
+		if (_audioEvent)
+			WaitForSingleObject(_audioEvent, periodMs * 2);
+		else
+			Sleep(periodMs);
+		if (_audioRenderExit) break;
+
+		if (_audioRing.TakeFlush())
 		{
-			if (GetTickCount64() - startTick > 2000)
-			{
-				DebugOutputHr(L"WASAPI: write timeout (buffer never drains)", E_FAIL);
-				return false;
-			}
-			Sleep(1);
-			continue;
+			// Seek/倍速切换：设备缓冲里按旧时间线（旧倍速）合成的音频一并清空，
+			// 避免回到 1.0x 后仍听到“被拉长的片段”。
+			(void)_audioClient->Stop();
+			(void)_audioClient->Reset();
+			started = false;
+			_audioPacer.Reset();
 		}
-		UINT32 bytesPerFrame = _audioMixFormat->nBlockAlign;
-		if (bytesPerFrame == 0) return false;
-		UINT32 availableBytes = availableFrames * bytesPerFrame;
-		UINT32 toWrite = (std::min)(availableBytes, bytes - offset);
-		UINT32 framesToWrite = toWrite / bytesPerFrame;
-		if (framesToWrite == 0)
+
+		if (!_threadPlaying.load())
 		{
-			if (GetTickCount64() - startTick > 2000)
+			if (started)
 			{
-				DebugOutputHr(L"WASAPI: write timeout (framesToWrite==0)", E_FAIL);
-				return false;
+				(void)_audioClient->Stop();
+				started = false;
+				_audioPacer.Reset();
 			}
-			Sleep(1);
 			continue;
 		}
-		BYTE* pData = nullptr;
-		hr = _audioRenderClient->GetBuffer(framesToWrite, &pData);
-		if (FAILED(hr)) { DebugOutputHr(L"WASAPI: GetBuffer", hr); return false; }
-		memcpy(pData, data + offset, framesToWrite * bytesPerFrame);
-		hr = _audioRenderClient->ReleaseBuffer(framesToWrite, 0);
-		if (FAILED(hr)) { DebugOutputHr(L"WASAPI: ReleaseBuffer", hr); return false; }
-		offset += framesToWrite * bytesPerFrame;
+
+		UINT32 padding = 0;
+		HRESULT hr = _audioClient->GetCurrentPadding(&padding);
+		if (FAILED(hr)) { DebugOutputHr(L"WASAPI: GetCurrentPadding", hr); break; }
+
+		const UINT32 frames = _audioPacer.Render(padding, _audioRing.ReadableFrames());
+		if (frames > 0)
+		{
+			BYTE* dst = nullptr;
+			hr = _audioRenderClient->GetBuffer(frames, &dst);
+			if (FAILED(hr)) { DebugOutputHr(L"WASAPI: GetBuffer", hr); break; }
+			// 唯一消费者：可读帧数只会增加，Read 一定读满 frames
+			const size_t got = _audioRing.Read(dst, frames);
+			hr = _audioRenderClient->ReleaseBuffer((UINT32)got, 0);
+			if (FAILED(hr)) { DebugOutputHr(L"WASAPI: ReleaseBuffer", hr); break; }
+		}
+
+		if (!started)
+		{
+			(void)_audioClient->Start();
+			started = true;
+		}
 	}
-	const LARGE_INTEGER t1 = QpcNow();
-	_statAudioWriteQpcTicks.fetch_add((UINT64)(t1.QuadPart - t0.QuadPart), std::memory_order_relaxed);
-	return true;
+
+	if (!_audioRenderExit)
+		_audioRenderFailed = true; // 设备失效等：解码线程不再等待写入
+	(void)_audioClient->Stop();
+	if (mmcss) AvRevertMmThreadCharacteristics(mmcss);
+	if (SUCCEEDED(hrCo))
+		CoUninitialize();
 }
 
 void MediaPlayer::PlaybackThreadMain()
@@ -1543,6 +1291,15 @@ void MediaPlayer::PlaybackThreadMain()
 	LARGE_INTEGER startQpc{};
 	QueryPerformanceCounter(&startQpc);
 
+	// 音频：本线程只负责解码/变速并写入 _audioRing；由渲染线程按设备周期送入 WASAPI，
+	// 解码或视频转换的耗时不再直接造成音频断续。
+	if (_audioClient && _audioRenderClient && _audioRing.FrameBytes() > 0)
+	{
+		_audioRenderExit = false;
+		_audioRenderFailed = false;
+		_audioRenderThread = std::thread([this] { AudioRenderThreadMain(); });
+	}
+
 	while (!_threadExit)
 	{
 		// Wait until playing.
@@ -1554,24 +1311,16 @@ void MediaPlayer::PlaybackThreadMain()
 
 		firstTs = -1;
 
-		// SourceReader 后端：始终保持音频输出开启；倍速由我们对 PCM 做时间缩放（允许变调但不断音）。
-		if (_audioClient && _hasAudio)
-			(void)_audioClient->Start();
-
 		while (_threadPlaying && !_threadExit)
 		{
 		if (_needSyncReset)
 		{
 			firstTs = -1;
 			if (_timeStretch) _timeStretch->Reset();
-			// 倍速/Seek 切换时，WASAPI 缓冲里可能还残留上一次 time-stretch 的音频。
-			// 这里通过 Stop+Reset 清空缓冲，避免回到 1.0x 后仍听到“被拉长的片段”。
-			if (_audioClient && _hasAudio)
-			{
-				(void)_audioClient->Stop();
-				(void)_audioClient->Reset();
-				(void)_audioClient->Start();
-			}
+			// 倍速/Seek 切换：环里与设备缓冲里的旧音频作废（渲染线程在下一个周期清空设备缓冲）
+			_audioRing.RequestFlush();
+			// 时间线重新开始：队列里按旧时间线排好的帧作废
+			_videoFrames.Flush();
 			_needSyncReset = false;
 		}
 
@@ -1585,6 +1334,7 @@ void MediaPlayer::PlaybackThreadMain()
 		const LARGE_INTEGER tRead1 = QpcNow();
 		const UINT64 readTicks = (UINT64)(tRead1.QuadPart - tRead0.QuadPart);
 		_statReadSampleQpcTicks.fetch_add(readTicks, std::memory_order_relaxed);
+		_telemetry.Read.Record(QpcTicksToMicros((LONGLONG)readTicks));
 		if (FAILED(hr))
 		{
 			_lastMfError = hr;
@@ -1622,6 +1372,19 @@ void MediaPlayer::PlaybackThreadMain()
 		}
 
 		if (!sample) continue;
+
+		// 关键修复：不要仅依赖 _actualVideoStreamIndex/_actualAudioStreamIndex。
+		// 对某些文件/解码器，streamIndex 的映射或类型会变化；若误把音频当视频会出现严重花屏。
+		GUID majorType{};
+		if (_sourceReader)
+		{
+			ComPtr<IMFMediaType> mt;
+			if (SUCCEEDED(_sourceReader->GetCurrentMediaType(streamIndex, &mt)) && mt)
+				(void)mt->GetGUID(MF_MT_MAJOR_TYPE, &majorType);
+		}
+		const bool isVideo = (majorType == MFMediaType_Video);
+		const bool isAudio = (majorType == MFMediaType_Audio);
+
 		if (firstTs < 0)
 		{
 			firstTs = ts;
@@ -1629,6 +1392,8 @@ void MediaPlayer::PlaybackThreadMain()
 		}
 
 		// Pace based on sample timestamp with playback rate
+		// 音频按延迟目标提前写入环，设备中排队的这段音频正好在其时间戳播放
+		const double audioLeadSec = _audioRenderThread.joinable() ? _audioPacer.LatencyTargetMs() / 1000.0 : 0.005;
 		float rate = _playbackRate.load();
 		if (rate < 0.01f) rate = 1.0f; // 防止除零
 		
@@ -1644,7 +1409,8 @@ void MediaPlayer::PlaybackThreadMain()
 			QueryPerformanceCounter(&now);
 			double elapsedSec = (double)(now.QuadPart - startQpc.QuadPart) / (double)freq.QuadPart;
 			double delta = targetElapsedSec - elapsedSec;
-			if (delta <= 0.005) break;
+			// 视频帧提前解码并带时间戳入队，由渲染端在到期的刷新周期取用
+			if (delta <= (isVideo ? VIDEO_DECODE_LEAD_SEC : audioLeadSec)) break;
 
 			// 以小步 sleep，避免一次 Sleep 很久导致停止/换片不响应
 			DWORD ms = (DWORD)std::clamp(delta * 1000.0, 1.0, 50.0);
@@ -1655,6 +1421,7 @@ void MediaPlayer::PlaybackThreadMain()
 			targetElapsedSec = relSec / rate;
 		}
 
+		const double framePts = (double)startQpc.QuadPart / (double)freq.QuadPart + targetElapsedSec;
 		_position = (double)ts / HNS_PER_SEC;
 		OnPositionChanged(this, _position);
 
@@ -1669,18 +1436,9 @@ void MediaPlayer::PlaybackThreadMain()
 		DWORD maxLen = 0, curLen = 0;
 		hr = buf->Lock(&p, &maxLen, &curLen);
 		if (FAILED(hr) || !p || curLen == 0) continue;
+		// 零拷贝交给渲染端的缓冲由帧回收时解锁
+		bool bufferHandedOver = false;
 
-		// 关键修复：不要仅依赖 _actualVideoStreamIndex/_actualAudioStreamIndex。
-		// 对某些文件/解码器，streamIndex 的映射或类型会变化；若误把音频当视频会出现严重花屏。
-		GUID majorType{};
-		if (_sourceReader)
-		{
-			ComPtr<IMFMediaType> mt;
-			if (SUCCEEDED(_sourceReader->GetCurrentMediaType(streamIndex, &mt)) && mt)
-				(void)mt->GetGUID(MF_MT_MAJOR_TYPE, &majorType);
-		}
-		const bool isVideo = (majorType == MFMediaType_Video);
-		const bool isAudio = (majorType == MFMediaType_Audio);
 		if (isVideo)
 		{
 			_statReadSampleVideoCalls.fetch_add(1, std::memory_order_relaxed);
@@ -1722,98 +1480,89 @@ void MediaPlayer::PlaybackThreadMain()
 				UINT32 srcStride = 0;
 				UINT32 bpp = 4;
 				bool bottomUp = false;
+				YuvToBgraConverter converter;
 				{
 					std::scoped_lock lock(_videoFrameMutex);
 					subtype = _videoSubtype;
+					converter = _videoYuvConverter;
 					srcStride = _videoStride;
 					bpp = (_videoBytesPerPixel == 0) ? 4 : _videoBytesPerPixel;
 					bottomUp = _videoBottomUp;
 				}
 
-				if (subtype == MFVideoFormat_NV12)
+				// 帧池满（渲染端跟不上）时丢弃本帧，不阻塞解码线程（音频照常输出）
+				VideoFrame* frame = _videoFrames.BeginWrite();
+				bool filled = false;
+				if (frame && (subtype == MFVideoFormat_NV12 || subtype == MFVideoFormat_P010))
 				{
-					// NV12: p points to NV12 contiguous buffer.
-					if (srcStride == 0) srcStride = (UINT32)frameW;
-					std::vector<uint8_t> converted;
-					ConvertNV12ToBGRA(p, (size_t)curLen, srcStride, (UINT32)frameW, (UINT32)frameH, cropX, cropY, (UINT32)w, (UINT32)h, converted);
-					if (!converted.empty())
-					{
-						{
-							std::scoped_lock lock(_videoFrameMutex);
-							_videoFrame = std::move(converted);
-							_videoFrameStride = (UINT32)w * 4;
-							_videoFrameReady = true;
-						}
-						const LARGE_INTEGER tVid1 = QpcNow();
-						_statVideoConvertQpcTicks.fetch_add((UINT64)(tVid1.QuadPart - tVid0.QuadPart), std::memory_order_relaxed);
-						_statVideoConvertBytes.fetch_add((UINT64)w * (UINT64)h * 4ULL, std::memory_order_relaxed);
-						this->PostRender();
-					}
-					else
-					{
-						const LARGE_INTEGER tVid1 = QpcNow();
-						_statVideoConvertQpcTicks.fetch_add((UINT64)(tVid1.QuadPart - tVid0.QuadPart), std::memory_order_relaxed);
-					}
-					continue;
+					// NV12/P010: p points to a contiguous Y + UV buffer.
+					if (srcStride == 0) srcStride = (UINT32)frameW * bpp;
+					uint8_t* dst = frame->Allocate((UINT32)w, (UINT32)h, (UINT32)w * 4);
+					filled = ConvertYuvToBGRA(converter, p, (size_t)curLen, srcStride, (UINT32)frameW, (UINT32)frameH, cropX, cropY, (UINT32)w, (UINT32)h, dst, (UINT32)w * 4);
 				}
-
-
-				const UINT32 minStride = (UINT32)frameW * bpp;
-				if (srcStride == 0) srcStride = minStride;
-				if (srcStride < minStride) srcStride = minStride;
-				const UINT32 needed = srcStride * (UINT32)frameH;
-				if (curLen >= needed)
+				else if (frame)
 				{
-					std::vector<uint8_t> converted;
-					converted.resize((size_t)w * (size_t)h * 4);
-					const UINT32 cropWBytes = (UINT32)w * 4;
-					for (LONG row = 0; row < h; row++)
+					const UINT32 minStride = (UINT32)frameW * bpp;
+					if (srcStride == 0) srcStride = minStride;
+					if (srcStride < minStride) srcStride = minStride;
+					const UINT32 needed = srcStride * (UINT32)frameH;
+					if (curLen >= needed && (LONG)cropX + w <= frameW && (LONG)cropY + h <= frameH)
 					{
-						LONG rawRow = (LONG)cropY + row;
-						if (rawRow < 0 || rawRow >= frameH) break;
-						LONG srcRow = bottomUp ? (frameH - 1 - rawRow) : rawRow;
-						const BYTE* srcRowPtr = p + (size_t)srcRow * (size_t)srcStride + (size_t)cropX * (size_t)bpp;
-						uint8_t* dstRowPtr = converted.data() + (size_t)row * (size_t)w * 4;
-
-						if (bpp == 4)
+						if (bpp == 4 && !bottomUp)
 						{
-							memcpy(dstRowPtr, srcRowPtr, (size_t)cropWBytes);
+							// 自上而下的 32bpp：直接把解码缓冲交给渲染端（按源 stride 上传，零拷贝），
+							// 帧回收时再解锁并释放
+							buf->AddRef();
+							frame->Attach(p + (size_t)cropY * (size_t)srcStride + (size_t)cropX * 4, (UINT32)w, (UINT32)h, srcStride, buf.Get(), &ReleaseLockedMediaBuffer);
+							bufferHandedOver = true;
 						}
-						else if (bpp == 3)
+						else
 						{
-							// MFVideoFormat_RGB24 在 Windows 上通常为 BGR24
-							for (LONG x = 0; x < w; x++)
+							uint8_t* dstBase = frame->Allocate((UINT32)w, (UINT32)h, (UINT32)w * 4);
+							const UINT32 cropWBytes = (UINT32)w * 4;
+							for (LONG row = 0; row < h; row++)
 							{
-								const BYTE* s = srcRowPtr + (size_t)x * 3;
-								uint8_t* d = dstRowPtr + (size_t)x * 4;
-								d[0] = s[0];
-								d[1] = s[1];
-								d[2] = s[2];
-								d[3] = 0xFF;
+								LONG rawRow = (LONG)cropY + row;
+								LONG srcRow = bottomUp ? (frameH - 1 - rawRow) : rawRow;
+								const BYTE* srcRowPtr = p + (size_t)srcRow * (size_t)srcStride + (size_t)cropX * (size_t)bpp;
+								uint8_t* dstRowPtr = dstBase + (size_t)row * (size_t)cropWBytes;
+
+								if (bpp == 3)
+								{
+									// MFVideoFormat_RGB24 在 Windows 上通常为 BGR24
+									for (LONG x = 0; x < w; x++)
+									{
+										const BYTE* s = srcRowPtr + (size_t)x * 3;
+										uint8_t* d = dstRowPtr + (size_t)x * 4;
+										d[0] = s[0];
+										d[1] = s[1];
+										d[2] = s[2];
+										d[3] = 0xFF;
+									}
+								}
+								else
+								{
+									// 32bpp（bottom-up）；未知格式 best effort 按 32bpp 处理。
+									memcpy(dstRowPtr, srcRowPtr, (size_t)cropWBytes);
+								}
 							}
 						}
-						else
-						{
-							// Unknown: best effort treat as 32bpp.
-							memcpy(dstRowPtr, srcRowPtr, (size_t)cropWBytes);
-						}
+						filled = true;
 					}
+				}
 
-					{
-						std::scoped_lock lock(_videoFrameMutex);
-						_videoFrame = std::move(converted);
-						_videoFrameStride = (UINT32)w * 4;
-						_videoFrameReady = true;
-					}
-					const LARGE_INTEGER tVid1 = QpcNow();
-					_statVideoConvertQpcTicks.fetch_add((UINT64)(tVid1.QuadPart - tVid0.QuadPart), std::memory_order_relaxed);
+				const LARGE_INTEGER tVid1 = QpcNow();
+				_statVideoConvertQpcTicks.fetch_add((UINT64)(tVid1.QuadPart - tVid0.QuadPart), std::memory_order_relaxed);
+				_telemetry.Convert.Record(QpcTicksToMicros(tVid1.QuadPart - tVid0.QuadPart));
+				if (filled)
+				{
+					_videoFrames.CommitWrite(frame, framePts);
 					_statVideoConvertBytes.fetch_add((UINT64)w * (UINT64)h * 4ULL, std::memory_order_relaxed);
 					this->PostRender();
 				}
 				else
 				{
-					const LARGE_INTEGER tVid1 = QpcNow();
-					_statVideoConvertQpcTicks.fetch_add((UINT64)(tVid1.QuadPart - tVid0.QuadPart), std::memory_order_relaxed);
+					_videoFrames.CancelWrite(frame);
 				}
 			}
 		}
@@ -1833,13 +1582,14 @@ void MediaPlayer::PlaybackThreadMain()
 			if (std::fabs(rate - 1.0f) < 0.0005f)
 			{
 				ApplyVolume(p, (size_t)curLen, _audioBitsPerSample, vol, isFloat);
-				(void)WriteAudioToWasapi(p, curLen);
+				(void)WriteAudioToRing(p, curLen, framePts);
 			}
 			else
 			{
 
-				// WSOLA: 需要采样率/通道数；若格式不支持则回退到旧实现
-				std::vector<uint8_t> stretched;
+				// WSOLA: 需要采样率/通道数；若格式不支持则回退到旧实现。
+				// 输出写入复用的 _audioStretchBytes（容量只增不减），稳态每块不再分配。
+				std::vector<uint8_t>& stretched = _audioStretchBytes;
 				bool wsolaOk = false;
 				if (sampleRate != 0 && channels != 0 && (bits == 16 || bits == 32))
 				{
@@ -1850,31 +1600,35 @@ void MediaPlayer::PlaybackThreadMain()
 
 				if (wsolaOk && !stretched.empty())
 				{
-					(void)WriteAudioToWasapi(stretched.data(), (UINT32)stretched.size());
+					(void)WriteAudioToRing(stretched.data(), (UINT32)stretched.size(), framePts);
 				}
-				else
+				else if (!wsolaOk)
 				{
 					// fallback：旧的时间缩放（会变调），或最后原样输出
-					std::vector<uint8_t> scaled;
+					std::vector<uint8_t>& scaled = _audioStretchBytes;
 					if (TimeScaleInterleavedPcm(p, (size_t)curLen, _audioChannels, _audioBitsPerSample, isFloat, rate, scaled) && !scaled.empty())
 					{
 						ApplyVolume(scaled.data(), scaled.size(), _audioBitsPerSample, vol, isFloat);
-						(void)WriteAudioToWasapi(scaled.data(), (UINT32)scaled.size());
+						(void)WriteAudioToRing(scaled.data(), (UINT32)scaled.size(), framePts);
 					}
 					else
 					{
 						ApplyVolume(p, (size_t)curLen, _audioBitsPerSample, vol, isFloat);
-						(void)WriteAudioToWasapi(p, curLen);
+						(void)WriteAudioToRing(p, curLen, framePts);
 					}
 				}
 			}
 		}
 
-		buf->Unlock();
+		if (!bufferHandedOver) buf->Unlock();
 		}
+	}
 
-		if (_audioClient && _hasAudio)
-			(void)_audioClient->Stop();
+	if (_audioRenderThread.joinable())
+	{
+		_audioRenderExit = true;
+		if (_audioEvent) SetEvent(_audioEvent);
+		_audioRenderThread.join();
 	}
 
 	if (SUCCEEDED(hrCo))
@@ -2183,7 +1937,6 @@ void MediaPlayer::OnVideoFrame(const BYTE* data, DWORD size)
 	const UINT32 cropX = _videoCropX;
 	const UINT32 cropY = _videoCropY;
 	const UINT32 expectedStride = w * 4;
-	const UINT32 expectedSize = expectedStride * h;
 	if (w == 0 || h == 0 || frameH == 0 || frameW == 0) return;
 
 	UINT32 srcStride = frameW * 4;
@@ -2197,24 +1950,19 @@ void MediaPlayer::OnVideoFrame(const BYTE* data, DWORD size)
 	if (size < needed)
 		return;
 
-	std::vector<uint8_t> normalized;
-	normalized.resize(expectedSize);
-	for (UINT32 row = 0; row < h; row++)
-	{
-		const UINT32 rawRow = cropY + row;
-		if (rawRow >= frameH) break;
-		if (cropX + w > frameW) break;
-		const BYTE* src = data + (size_t)rawRow * (size_t)srcStride + (size_t)cropX * 4;
-		uint8_t* dst = normalized.data() + (size_t)row * (size_t)expectedStride;
-		memcpy(dst, src, expectedStride);
-	}
+	if (cropX + w > frameW || cropY + h > frameH)
+		return;
 
+	// data 只在回调期间有效：拷贝进池内缓冲（稳态不再分配）。SampleGrabber 已按呈现时钟送帧，时间戳取当前时刻。
+	VideoFrame* frame = _videoFrames.BeginWrite();
+	if (!frame) return;
+	uint8_t* dstBase = frame->Allocate(w, h, expectedStride);
+	for (UINT32 row = 0; row < h; row++)
 	{
-		std::scoped_lock lock(_videoFrameMutex);
-		_videoFrameStride = expectedStride;
-		_videoFrame = std::move(normalized);
-		_videoFrameReady = true;
+		const BYTE* src = data + (size_t)(cropY + row) * (size_t)srcStride + (size_t)cropX * 4;
+		memcpy(dstBase + (size_t)row * (size_t)expectedStride, src, expectedStride);
 	}
+	_videoFrames.CommitWrite(frame, QpcSeconds());
 	// CUI 是完全自渲染框架：需要主动 Invalidate 才会刷新画面。
 	this->PostRender();
 }
@@ -2288,9 +2036,6 @@ bool MediaPlayer::Load(const std::wstring& mediaFile)
 		_videoSize = SIZE{ 0,0 };
 		{
 			std::scoped_lock lock(_videoFrameMutex);
-			_videoFrame.clear();
-			_videoFrameReady = false;
-			_videoFrameStride = 0;
 			_videoStride = 0;
 			_videoSubtype = GUID_NULL;
 			_videoBytesPerPixel = 4;
@@ -2299,6 +2044,11 @@ bool MediaPlayer::Load(const std::wstring& mediaFile)
 			_videoCropX = 0;
 			_videoCropY = 0;
 		}
+		// 播放线程已停止：回收全部帧（释放仍挂接的解码缓冲）
+		_videoFrames.Reset();
+		_videoFrames.ResetStats();
+		_audioPacer.ResetStats();
+		_telemetry.Reset();
 		_memoryByteStream.Reset();
 		_memoryStream.Reset();
 		if (_videoBitmap && _ownsVideoBitmap)
@@ -2347,11 +2097,9 @@ bool MediaPlayer::Load(const std::wstring& mediaFile)
 	_ownsVideoBitmap = false;
 	{
 		std::scoped_lock lock(_videoFrameMutex);
-		_videoFrame.clear();
-		_videoFrameStride = 0;
 		_videoStride = 0;
-		_videoFrameReady = false;
 	}
+	_videoFrames.Flush();
 	_hasVideo = false;
 	_hasAudio = false;
 	_position = 0.0;
@@ -2437,9 +2185,6 @@ bool MediaPlayer::Load(const void* data, size_t size, const std::wstring& nameHi
 	_videoSize = SIZE{ 0,0 };
 	{
 		std::scoped_lock lock(_videoFrameMutex);
-		_videoFrame.clear();
-		_videoFrameReady = false;
-		_videoFrameStride = 0;
 		_videoStride = 0;
 		_videoSubtype = GUID_NULL;
 		_videoBytesPerPixel = 4;
@@ -2448,6 +2193,11 @@ bool MediaPlayer::Load(const void* data, size_t size, const std::wstring& nameHi
 		_videoCropX = 0;
 		_videoCropY = 0;
 	}
+	// 播放线程已停止：回收全部帧（释放仍挂接的解码缓冲）
+	_videoFrames.Reset();
+	_videoFrames.ResetStats();
+	_audioPacer.ResetStats();
+	_telemetry.Reset();
 	if (_videoBitmap && _ownsVideoBitmap)
 		_videoBitmap->Release();
 	_videoBitmap = nullptr;
@@ -2765,11 +2515,9 @@ void MediaPlayer::ReleaseResources()
 	_videoDisplayControl.Reset();
 	{
 		std::scoped_lock lock(_videoFrameMutex);
-		_videoFrame.clear();
-		_videoFrameStride = 0;
 		_videoStride = 0;
-		_videoFrameReady = false;
 	}
+	_videoFrames.Flush();
 	_mediaLoaded = false;
 	_hasVideo = false;
 	_hasAudio = false;
@@ -2813,28 +2561,21 @@ void MediaPlayer::Update()
 	// 有视频：尝试更新并绘制最新帧
 	if (_hasVideo && _mediaLoaded)
 	{
-		std::vector<uint8_t> frame;
-		UINT32 stride = 0;
-		bool hasNewFrame = false;
-		{
-			std::scoped_lock lock(_videoFrameMutex);
-			if (_videoFrameReady)
-			{
-				frame.swap(_videoFrame);
-				stride = _videoFrameStride;
-				_videoFrameReady = false;
-				hasNewFrame = true;
-			}
-		}
+		// 取出在本次刷新（容差半个周期）前到期的最新一帧；更早的到期帧按迟到丢弃
+		const double refreshSec = (this->ParentForm ? this->ParentForm->RefreshInterval() : 1000.0 / 60.0) / 1000.0;
+		const double now = QpcSeconds();
+		const VideoFrame* frame = _videoFrames.AcquireDue(now, refreshSec * 0.5);
+		if (frame)
+			_telemetry.RecordVideoLateness(now - frame->Pts);
 
 		// 只有在有新帧时才上传；否则继续绘制上一帧，避免闪烁（背景黑屏）。
-		if (hasNewFrame && !frame.empty() && _videoSize.cx > 0 && _videoSize.cy > 0 && stride > 0)
+		if (frame && frame->Data && frame->Width > 0 && frame->Height > 0 && frame->Stride >= frame->Width * 4)
 		{
 			// 如果视频尺寸发生变化，必须重建 bitmap，否则右侧/下侧可能残留旧像素（常见表现为绿色条）。
 			if (_videoBitmap)
 			{
 				auto ps = _videoBitmap->GetPixelSize();
-				if (ps.width != (UINT32)_videoSize.cx || ps.height != (UINT32)_videoSize.cy)
+				if (ps.width != frame->Width || ps.height != frame->Height)
 				{
 					if (_videoBitmap && _ownsVideoBitmap)
 						_videoBitmap->Release();
@@ -2852,46 +2593,27 @@ void MediaPlayer::Update()
 					props.pixelFormat = D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_IGNORE);
 					props.dpiX = 96.0f;
 					props.dpiY = 96.0f;
-					rt->CreateBitmap(D2D1::SizeU((UINT32)_videoSize.cx, (UINT32)_videoSize.cy), nullptr, 0, &props, &_videoBitmap);
+					rt->CreateBitmap(D2D1::SizeU(frame->Width, frame->Height), nullptr, 0, &props, &_videoBitmap);
 					_ownsVideoBitmap = true;
 				}
 			}
 
 			if (_videoBitmap)
 			{
+				// 按帧自身的 stride 上传：带 padding 的零拷贝帧无需先规范化
 				_statVideoUploadCalls.fetch_add(1, std::memory_order_relaxed);
-				_statVideoUploadBytes.fetch_add((UINT64)frame.size(), std::memory_order_relaxed);
+				_statVideoUploadBytes.fetch_add((UINT64)frame->Width * (UINT64)frame->Height * 4ULL, std::memory_order_relaxed);
 				const LARGE_INTEGER tUp0 = QpcNow();
-				const UINT32 w = (UINT32)_videoSize.cx;
-				const UINT32 h = (UINT32)_videoSize.cy;
-				const UINT32 expectedStride = w * 4;
-				const size_t expectedSize = (size_t)expectedStride * (size_t)h;
-
-				if (frame.size() >= expectedSize && stride == expectedStride)
-				{
-					_videoBitmap->CopyFromMemory(nullptr, frame.data(), expectedStride);
-				}
-				else if (stride >= expectedStride && frame.size() >= (size_t)stride * (size_t)h)
-				{
-					std::vector<uint8_t> normalized;
-					normalized.resize(expectedSize);
-					for (UINT32 row = 0; row < h; row++)
-					{
-						const uint8_t* src = frame.data() + (size_t)row * (size_t)stride;
-						uint8_t* dst = normalized.data() + (size_t)row * (size_t)expectedStride;
-						memcpy(dst, src, expectedStride);
-					}
-					_videoBitmap->CopyFromMemory(nullptr, normalized.data(), expectedStride);
-				}
-				else if (frame.size() >= expectedSize)
-				{
-					// stride 元数据不可信但数据是连续的：按 expectedStride 写入
-					_videoBitmap->CopyFromMemory(nullptr, frame.data(), expectedStride);
-				}
+				_videoBitmap->CopyFromMemory(nullptr, frame->Data, frame->Stride);
 				const LARGE_INTEGER tUp1 = QpcNow();
 				_statVideoUploadQpcTicks.fetch_add((UINT64)(tUp1.QuadPart - tUp0.QuadPart), std::memory_order_relaxed);
+				_telemetry.Upload.Record(QpcTicksToMicros(tUp1.QuadPart - tUp0.QuadPart));
 			}
 		}
+		_videoFrames.Release(frame);
+		// 还有未到期的帧：下一刷新周期再检查
+		if (_videoFrames.HasPending())
+			this->PostRender();
 
 		// 没有新帧也要继续绘制上一帧，避免闪烁
 		if (_videoBitmap && _videoSize.cx > 0 && _videoSize.cy > 0)
@@ -2974,6 +2696,7 @@ void MediaPlayer::Update()
 			d2d->DrawBitmap(_videoBitmap, destX, destY, destWidth, destHeight);
 			const LARGE_INTEGER tDraw1 = QpcNow();
 			_statDrawBitmapQpcTicks.fetch_add((UINT64)(tDraw1.QuadPart - tDraw0.QuadPart), std::memory_order_relaxed);
+			_telemetry.Present.Record(QpcTicksToMicros(tDraw1.QuadPart - tDraw0.QuadPart));
 			ReportPerfStatsIfDue();
 			return;
 		}
@@ -3032,10 +2755,14 @@ void MediaPlayer::ReportPerfStatsIfDue()
 	const double upMBs = (intervalSec > 0.0) ? ((double)uBytes / (1024.0 * 1024.0)) / intervalSec : 0.0;
 	const double aMBs = (intervalSec > 0.0) ? ((double)aBytes / (1024.0 * 1024.0)) / intervalSec : 0.0;
 
-	wchar_t buf[512] = {};
+	const auto frames = _videoFrames.GetStats();
+	const auto audio = _audioPacer.GetStats();
+	const auto ring = _audioRing.GetStats();
+
+	wchar_t buf[1024] = {};
 	swprintf_s(
 		buf,
-		L"[MediaPlayer][%.2fs] mode=%s nv12=%s upd=%llu fps=%.1f | ReadSample %llux %.3fms (V:%llux %.3fms A:%llux %.3fms) | Contig %llux %.3fms | VConv %llux %.3fms %.1fMB/s | Upload %llux %.3fms %.1fMB/s | Draw %llux %.3fms | Audio %llux %.3fms %.1fMB/s\n",
+		L"[MediaPlayer][%.2fs] mode=%s nv12=%s upd=%llu fps=%.1f | ReadSample %llux %.3fms (V:%llux %.3fms A:%llux %.3fms) | Contig %llux %.3fms | VConv %llux %.3fms %.1fMB/s | Upload %llux %.3fms %.1fMB/s | Draw %llux %.3fms | Audio %llux %.3fms %.1fMB/s | Frames shown %llu late %llu full %llu zc %llu alloc %llu jitter %.2f/%.2fms | AudioRender periods %llu underrun %llu (%llu frames) queued %.1f/%.1fms full %llu\n",
 		intervalSec,
 		(_usingHardwareDecode ? L"HW" : L"SW"),
 		(_usingNv12VideoOutput ? L"Y" : L"N"),
@@ -3059,10 +2786,50 @@ void MediaPlayer::ReportPerfStatsIfDue()
 		drawAvgMs,
 		(unsigned long long)aCalls,
 		aAvgMs,
-		aMBs);
+		aMBs,
+		(unsigned long long)frames.Presented,
+		(unsigned long long)frames.Dropped,
+		(unsigned long long)frames.Overruns,
+		(unsigned long long)frames.ZeroCopy,
+		(unsigned long long)frames.Allocations,
+		frames.AverageJitter,
+		frames.MaxJitter,
+		(unsigned long long)audio.Periods,
+		(unsigned long long)audio.Underruns,
+		(unsigned long long)audio.StarvedFrames,
+		audio.AverageQueuedMs,
+		audio.MaxQueuedMs,
+		(unsigned long long)ring.FullWrites);
 	OutputDebugStringW(buf);
 }
 
+PlaybackStats MediaPlayer::GetPlaybackStats() const
+{
+	PlaybackStats stats;
+	_telemetry.Fill(stats);
+
+	const auto frames = _videoFrames.GetStats();
+	stats.FramesQueued = frames.Committed;
+	stats.FramesPresented = frames.Presented;
+	stats.FramesLate = frames.Dropped;
+	stats.FramesDropped = frames.Overruns;
+
+	const auto audio = _audioPacer.GetStats();
+	stats.AudioPeriods = audio.Periods;
+	stats.AudioUnderruns = audio.Underruns;
+	const UINT32 sampleRate = _audioPacer.SampleRate();
+	stats.AudioStarvedMs = sampleRate ? (double)audio.StarvedFrames * 1000.0 / (double)sampleRate : 0.0;
+	stats.AudioQueuedMs = audio.AverageQueuedMs;
+	return stats;
+}
+
+void MediaPlayer::ResetPlaybackStats()
+{
+	_telemetry.Reset();
+	_videoFrames.ResetStats();
+	_audioPacer.ResetStats();
+}
+
 bool MediaPlayer::ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int xof, int yof)
 {
 	if (!this->Enable || !this->Visible) return true;
@@ -3212,6 +2979,17 @@ SET_CPP(MediaPlayer, bool, Loop)
 	_loop = value;
 }
 
+GET_CPP(MediaPlayer, double, AudioLatencyMs)
+{
+	return _audioPacer.LatencyTargetMs();
+}
+
+SET_CPP(MediaPlayer, double, AudioLatencyMs)
+{
+	// 渲染线程下一个设备周期起生效；音频提前解码量随之调整
+	_audioPacer.SetLatencyTargetMs(value);
+}
+
 GET_CPP(MediaPlayer, bool, EnableHardwareDecode)
 {
 	return _enableHardwareDecode;
@@ -1,5 +1,9 @@
 #pragma once
 #include "Control.h"
+#include "YuvConvert.h"
+#include "VideoFrameQueue.h"
+#include "AudioRingBuffer.h"
+#include "PlaybackTelemetry.h"
 #include <wrl/client.h>
 #include <mfapi.h>
 #include <mfplay.h>
@@ -163,7 +167,7 @@ private:
 	bool _enableHardwareDecode = true; // 是否尝试启用硬件解码/硬件变换（SourceReader/DXVA；失败自动回退）
 	bool _usingHardwareDecode = false; // 本次 InitSourceReader 是否以“允许DXVA+硬件变换(best-effort)”模式创建成功
 	bool _preferNv12VideoOutput = true; // 是否优先让 SourceReader 输出 NV12（关闭 MF video processing，降低 ReadSample 负担；失败回退 RGB）
-	bool _usingNv12VideoOutput = false; // 当前视频输出是否为 NV12
+	bool _usingNv12VideoOutput = false; // 当前视频输出是否为 NV12/P010（CPU 颜色转换）
 	double _position = 0.0;           // 当前播放位置（秒）
 	double _duration = 0.0;           // 媒体总时长（秒）
 	std::atomic<double> _volume{ 1.0 }; // 音量 (0.0-1.0)
@@ -183,17 +187,16 @@ private:
 	ComPtr<IDXGISwapChain1> _swapChain;               // DXGI交换链
 	ComPtr<IMFVideoDisplayControl> _videoDisplayControl;  // 视频显示控制
 	ComPtr<VideoSampleGrabberCallback> _videoSampleCallback;  // 视频帧回调
-	std::vector<uint8_t> _videoFrame;                 // 视频帧数据缓冲
-	UINT32 _videoFrameStride = 0;                     // 当前 _videoFrame 的步长（用于 UI 上传；通常为 width*4）
-	UINT32 _videoStride = 0;                          // 解码输出 stride（来自 MF_MT_DEFAULT_STRIDE；NV12 时为 Y plane stride）
+	VideoFrameQueue _videoFrames;                     // 解码帧池 + SPSC 队列（解码线程/SampleGrabber 写入，UI 线程按时取用）
+	UINT32 _videoStride = 0;                          // 解码输出 stride（来自 MF_MT_DEFAULT_STRIDE；NV12/P010 时为 Y plane stride，字节）
 	GUID _videoSubtype = GUID_NULL;                   // SourceReader 实际视频子类型
+	YuvToBgraConverter _videoYuvConverter;            // NV12/P010 输出时的颜色转换（矩阵/范围来自媒体类型）
 	UINT32 _videoBytesPerPixel = 4;                   // 视频像素字节数（3=RGB24, 4=RGB32/ARGB32）
 	bool _videoBottomUp = false;                      // 是否为倒置图像（stride<0）
 	SIZE _videoFrameSize = { 0, 0 };                  // 解码输出帧尺寸（可能包含对齐padding）
 	UINT32 _videoCropX = 0;                           // 可视区域X偏移（像素）
 	UINT32 _videoCropY = 0;                           // 可视区域Y偏移（像素）
-	std::mutex _videoFrameMutex;                      // 视频帧互斥锁
-	bool _videoFrameReady = false;                    // 视频帧就绪标志
+	std::mutex _videoFrameMutex;                      // 视频格式互斥锁（subtype/stride/颜色转换）
 	
 	// ========== 媒体信息 ==========
 	bool _hasVideo = false;           // 是否包含视频
@@ -235,6 +238,14 @@ private:
 	UINT32 _audioSamplesPerSec = 0;                   // 音频采样率
 	UINT32 _audioBitsPerSample = 0;                   // 音频每样本位数
 	UINT32 _audioBufferFrameCount = 0;                // 音频缓冲帧数
+	UINT32 _audioPeriodFrames = 0;                    // 设备周期帧数（渲染线程唤醒间隔）
+	HANDLE _audioEvent = nullptr;                     // 设备周期事件（AUDCLNT_STREAMFLAGS_EVENTCALLBACK）
+	AudioRingBuffer _audioRing;                       // 解码线程 → 渲染线程的 PCM 环（设备格式，1 秒）
+	AudioRenderPacer _audioPacer;                     // 渲染节拍（延迟目标、欠载统计）
+	std::thread _audioRenderThread;                   // 音频渲染线程（由播放线程启动与回收）
+	std::atomic<bool> _audioRenderExit{ false };      // 渲染线程退出标志
+	std::atomic<bool> _audioRenderFailed{ false };    // 设备出错（写入不再等待渲染线程）
+	std::vector<uint8_t> _audioStretchBytes;          // 变速输出缓冲（复用，稳态不分配）
 
 	// Pitch-preserving time-stretch (WSOLA)
 	std::unique_ptr<WsolaTimeStretch> _timeStretch;
@@ -245,11 +256,12 @@ private:
 	void ShutdownSourceReader();                      // 关闭SourceReader
 	bool InitWasapi();                                // 初始化WASAPI音频输出
 	void ShutdownWasapi();                            // 关闭WASAPI
-	void PlaybackThreadMain();                        // 播放线程主函数
+	void PlaybackThreadMain();                        // 播放线程主函数（解码/变速，音频写入 _audioRing）
+	void AudioRenderThreadMain();                     // 音频渲染线程主函数（按设备周期从 _audioRing 送入 WASAPI）
 	bool ConfigureSourceReaderVideoType();            // 配置SourceReader视频类型
 	bool ConfigureSourceReaderAudioTypeFromMixFormat(); // 配置SourceReader音频类型
 	void UpdateVideoFormatFromSourceReader();         // 从sourceReader更新视频格式
-	bool WriteAudioToWasapi(const BYTE* data, UINT32 bytes);  // 将音频数据写入WASAPI
+	bool WriteAudioToRing(const BYTE* data, UINT32 bytes, double pts);  // 将音频数据写入 _audioRing（环满时等待渲染线程取走；pts 用于估计音频延后）
 	void StopSourceReaderPlayback(bool shutdown);     // 停止SourceReader播放（可选关闭WASAPI/Reader）
 
 	// ========== 视频渲染 ==========
@@ -302,7 +314,7 @@ public:
 	/** @brief 播放位置变化时触发（秒）。 */
 	MediaPositionChangedEvent OnPositionChanged;
 
-	static void ConvertNV12ToBGRA(const uint8_t* nv12, size_t nv12Bytes, UINT32 nv12Stride, UINT32 srcW, UINT32 srcH, UINT32 cropX, UINT32 cropY, UINT32 w, UINT32 h, std::vector<uint8_t>& outBGRA);
+	static bool ConvertYuvToBGRA(const YuvToBgraConverter& converter, const uint8_t* src, size_t srcBytes, UINT32 yStride, UINT32 srcW, UINT32 srcH, UINT32 cropX, UINT32 cropY, UINT32 w, UINT32 h, uint8_t* outBGRA, UINT32 outStride);
 	virtual UIClass Type() override;
 	void Update() override;
 	bool ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int xof, int yof) override;
@@ -403,12 +415,12 @@ public:
 	READONLY_PROPERTY(bool, UsingHardwareDecode);
 	GET(bool, UsingHardwareDecode);
 
-	// 是否优先使用 NV12 视频输出（可读写，best-effort；失败会回退 RGB）
+	// 是否优先使用 NV12/P010 视频输出（可读写，best-effort；失败会回退 RGB）
 	PROPERTY(bool, PreferNv12VideoOutput);
 	GET(bool, PreferNv12VideoOutput);
 	SET(bool, PreferNv12VideoOutput);
 
-	// 当前是否正在使用 NV12 视频输出（只读）
+	// 当前是否正在使用 NV12/P010 视频输出（只读）
 	READONLY_PROPERTY(bool, UsingNv12VideoOutput);
 	GET(bool, UsingNv12VideoOutput);
 
@@ -433,7 +445,30 @@ public:
 	GET(VideoRenderMode, RenderMode);
 	SET(VideoRenderMode, RenderMode);
 
+	// 音频延迟目标（毫秒，10-500，默认 60）：设备中保持排队的音频量，也是音频提前解码的时间。可读写
+	PROPERTY(double, AudioLatencyMs);
+	GET(double, AudioLatencyMs);
+	SET(double, AudioLatencyMs);
+
+	/** @brief 音频渲染统计（自加载以来：设备周期、欠载次数与缺帧、排队时长）。任意线程可读。 */
+	AudioRenderPacer::Stats AudioRenderStats() const { return _audioPacer.GetStats(); }
+	/** @brief 音频环统计（写入/读出/Flush 帧数、环满等待次数、最大填充）。任意线程可读。 */
+	AudioRingBuffer::Stats AudioRingStats() const { return _audioRing.GetStats(); }
+	/** @brief 视频帧队列统计（自加载以来：呈现、迟到丢弃、池满丢弃、零拷贝、缓冲分配、抖动）。在 UI 线程读取。 */
+	VideoFrameQueue::Stats VideoFrameStats() const { return _videoFrames.GetStats(); }
+	/**
+	 * @brief 播放统计快照：各阶段耗时直方图（读取/转换/上传/呈现）、迟到与丢弃帧、音画偏差、音频欠载。
+	 *
+	 * 在 UI 线程读取；只读原子计数，不加锁，不影响播放线程与音频渲染线程。
+	 */
+	PlaybackStats GetPlaybackStats() const;
+	/** @brief 清零播放统计（同时清零视频帧队列与音频渲染统计）。在 UI 线程调用。 */
+	void ResetPlaybackStats();
+
 private:
+	// ========== 播放遥测（常开，GetPlaybackStats 读取） ==========
+	PlaybackTelemetry _telemetry;
+
 	// ========== 诊断：性能统计（每秒输出一次） ==========
 	std::atomic<UINT64> _statReadSampleCalls{ 0 };
 	std::atomic<UINT64> _statReadSampleQpcTicks{ 0 };
@@ -186,19 +186,7 @@ void Panel::PerformLayout()
 		// 使用布局引擎
 		if (_needsLayout || _layoutEngine->NeedsLayout())
 		{
-			SIZE availableSize = this->Size;
-			Thickness padding = this->Padding;
-			availableSize.cx = (LONG)((std::max)(0.0f, (float)availableSize.cx - padding.Left - padding.Right));
-			availableSize.cy = (LONG)((std::max)(0.0f, (float)availableSize.cy - padding.Top - padding.Bottom));
-			_layoutEngine->Measure(this, availableSize);
-			
-			D2D1_RECT_F finalRect = { 
-				padding.Left,
-				padding.Top,
-				padding.Left + (float)availableSize.cx,
-				padding.Top + (float)availableSize.cy
-			};
-			_layoutEngine->Arrange(this, finalRect);
+			_layoutEngine->Layout(this, this->GetLayoutSize(), this->Padding);
 		}
 	}
 	
@@ -231,7 +219,7 @@ void Panel::Update()
 		for (int i = 0; i < this->Count; i++)
 		{
 			auto c = this->operator[](i);
-			c->Update();
+			c->Draw();
 		}
 		d2d->DrawRect(abslocation.x, abslocation.y, size.cx, size.cy, this->BolderColor, this->Boder);
 	}
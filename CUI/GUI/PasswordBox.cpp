@@ -14,6 +14,16 @@ void PasswordBox::InputText(std::wstring input)
 {
 	int sels = SelectionStart <= SelectionEnd ? SelectionStart : SelectionEnd;
 	int sele = SelectionEnd >= SelectionStart ? SelectionEnd : SelectionStart;
+	const int selStartBefore = this->SelectionStart;
+	const int selEndBefore = this->SelectionEnd;
+	const int recSels = std::clamp(sels, 0, (int)this->Text.size());
+	const int recSele = std::clamp(sele, 0, (int)this->Text.size());
+	std::wstring removed = (recSele > recSels) ? this->Text.substr((size_t)recSels, (size_t)(recSele - recSels)) : L"";
+	std::wstring inserted = input;
+	for (auto& ch : inserted)
+	{
+		if (ch == L'\r' || ch == L'\n') ch = L' ';
+	}
 	if (sele >= this->Text.size() && sels >= this->Text.size())
 	{
 		this->Text += input;
@@ -65,62 +75,73 @@ void PasswordBox::InputText(std::wstring input)
 		}
 	}
 	this->Text = std::wstring(tmp.data());
+	this->undoHistory.Record((size_t)recSels, removed, inserted, selStartBefore, selEndBefore, this->SelectionStart, this->SelectionEnd);
 }
 void PasswordBox::InputBack()
 {
+	std::wstring text = this->Text;
 	int sels = SelectionStart <= SelectionEnd ? SelectionStart : SelectionEnd;
 	int sele = SelectionEnd >= SelectionStart ? SelectionEnd : SelectionStart;
+	sels = std::clamp(sels, 0, (int)text.size());
+	sele = std::clamp(sele, 0, (int)text.size());
 	int selLen = sele - sels;
-	if (selLen > 0)
-	{
-		List<wchar_t> tmp = List<wchar_t>((wchar_t*)this->Text.c_str(), this->Text.size());
-		for (int i = 0; i < selLen; i++)
-		{
-			tmp.RemoveAt(sels);
-		}
-		tmp.Add(L'\0');
-		this->SelectionStart = this->SelectionEnd = sels;
-		this->Text = tmp.data();
-	}
-	else
-	{
-		if (sels > 0)
-		{
-			List<wchar_t> tmp = List<wchar_t>((wchar_t*)this->Text.c_str(), this->Text.size());
-			tmp.RemoveAt(sels - 1);
-			tmp.Add(L'\0');
-			this->SelectionStart = this->SelectionEnd = sels - 1;
-			this->Text = tmp.data();
-		}
-	}
+	if (selLen == 0 && sels == 0) return;
+
+	const int selStartBefore = this->SelectionStart;
+	const int selEndBefore = this->SelectionEnd;
+	const int pos = selLen > 0 ? sels : sels - 1;
+	const int count = selLen > 0 ? selLen : 1;
+	std::wstring removed = text.substr((size_t)pos, (size_t)count);
+	text.erase((size_t)pos, (size_t)count);
+	this->SelectionStart = this->SelectionEnd = pos;
+	this->Text = text;
+	this->undoHistory.Record((size_t)pos, removed, std::wstring(), selStartBefore, selEndBefore, this->SelectionStart, this->SelectionEnd);
 }
 void PasswordBox::InputDelete()
 {
+	std::wstring text = this->Text;
 	int sels = SelectionStart <= SelectionEnd ? SelectionStart : SelectionEnd;
 	int sele = SelectionEnd >= SelectionStart ? SelectionEnd : SelectionStart;
+	sels = std::clamp(sels, 0, (int)text.size());
+	sele = std::clamp(sele, 0, (int)text.size());
 	int selLen = sele - sels;
-	if (selLen > 0)
-	{
-		List<wchar_t> tmp = List<wchar_t>((wchar_t*)this->Text.c_str(), this->Text.size());
-		for (int i = 0; i < selLen; i++)
-		{
-			tmp.RemoveAt(sels);
-		}
-		tmp.Add(L'\0');
-		this->SelectionStart = this->SelectionEnd = sels;
-		this->Text = tmp.data();
-	}
-	else
-	{
-		if (sels < this->Text.size())
-		{
-			List<wchar_t> tmp = List<wchar_t>((wchar_t*)this->Text.c_str(), this->Text.size());
-			tmp.RemoveAt(sels);
-			tmp.Add(L'\0');
-			this->SelectionStart = this->SelectionEnd = sels;
-			this->Text = tmp.data();
-		}
-	}
+	if (selLen == 0 && sels >= (int)text.size()) return;
+
+	const int selStartBefore = this->SelectionStart;
+	const int selEndBefore = this->SelectionEnd;
+	const int count = selLen > 0 ? selLen : 1;
+	std::wstring removed = text.substr((size_t)sels, (size_t)count);
+	text.erase((size_t)sels, (size_t)count);
+	this->SelectionStart = this->SelectionEnd = sels;
+	this->Text = text;
+	this->undoHistory.Record((size_t)sels, removed, std::wstring(), selStartBefore, selEndBefore, this->SelectionStart, this->SelectionEnd);
+}
+void PasswordBox::ApplyUndoChange(const UndoEngine::Change& change)
+{
+	std::wstring text = this->Text;
+	const size_t pos = std::min(change.Pos, text.size());
+	const size_t removeLen = std::min(change.RemoveLen, text.size() - pos);
+	text.erase(pos, removeLen);
+	text.insert(pos, change.InsertText);
+	this->SelectionStart = std::clamp(change.SelStart, 0, (int)text.size());
+	this->SelectionEnd = std::clamp(change.SelEnd, 0, (int)text.size());
+	this->Text = text;
+}
+void PasswordBox::Undo()
+{
+	UndoEngine::Change change;
+	std::wstring text = this->Text;
+	if (!this->undoHistory.Undo([&text](size_t pos, size_t len) { return pos < text.size() ? text.substr(pos, len) : std::wstring(); }, change))
+		return;
+	ApplyUndoChange(change);
+}
+void PasswordBox::Redo()
+{
+	UndoEngine::Change change;
+	std::wstring text = this->Text;
+	if (!this->undoHistory.Redo([&text](size_t pos, size_t len) { return pos < text.size() ? text.substr(pos, len) : std::wstring(); }, change))
+		return;
+	ApplyUndoChange(change);
 }
 void PasswordBox::UpdateScroll(bool arrival)
 {
@@ -350,6 +371,23 @@ bool PasswordBox::ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int
 	break;
 	case WM_KEYDOWN:
 	{
+		if (GetAsyncKeyState(VK_CONTROL) & 0x8000)
+		{
+			if (wParam == 'Z')
+			{
+				this->Undo();
+				UpdateScroll();
+				this->PostRender();
+				return true;
+			}
+			if (wParam == 'Y')
+			{
+				this->Redo();
+				UpdateScroll();
+				this->PostRender();
+				return true;
+			}
+		}
 		auto pos = this->AbsLocation;
 		HIMC hImc = ImmGetContext(this->ParentForm->Handle);
 		COMPOSITIONFORM form;
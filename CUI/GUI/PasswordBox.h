@@ -1,5 +1,6 @@
 #pragma once
 #include "Control.h"
+#include "Text/UndoEngine.h"
 #pragma comment(lib, "Imm32.lib")
 
 /**
@@ -9,6 +10,7 @@
  * 行为概览：
  * - 负责处理输入、选择、光标与水平滚动
  * - 显示层面通常会对文本进行掩码渲染（实现见 cpp）
+ * - Ctrl+Z/Ctrl+Y：撤销/重做（与 TextBox 共用 UndoEngine；ClearUndoHistory 会先抹零历史中的文本）
  */
 class PasswordBox : public Control
 {
@@ -47,11 +49,19 @@ public:
 	/** @brief 创建密码输入框。 */
 	PasswordBox(std::wstring text, int x, int y, int width = 120, int height = 24);
 private:
+	UndoEngine undoHistory;
 	void InputText(std::wstring input);
 	void InputBack();
 	void InputDelete();
 	void UpdateScroll(bool arrival = false);
+	void ApplyUndoChange(const UndoEngine::Change& change);
+	void Undo();
+	void Redo();
 public:
+	/** @brief 设置撤销历史的内存预算（字节，0 表示不限制）。 */
+	void SetUndoBudget(size_t bytes) { this->undoHistory.SetBudget(bytes); }
+	/** @brief 清空撤销/重做历史。 */
+	void ClearUndoHistory() { this->undoHistory.Clear(); }
 	/** @brief 获取当前选择文本。 */
 	std::wstring GetSelectedString();
 	void Update() override;
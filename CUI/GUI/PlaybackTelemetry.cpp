@@ -0,0 +1,172 @@
+#include "PlaybackTelemetry.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// v > 0
+inline unsigned FloorLog2(uint64_t v)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+	unsigned long index = 0;
+	_BitScanReverse64(&index, v);
+	return (unsigned)index;
+#elif defined(_MSC_VER)
+	unsigned long index = 0;
+	if (_BitScanReverse(&index, (unsigned long)(v >> 32)))
+		return (unsigned)index + 32;
+	_BitScanReverse(&index, (unsigned long)v);
+	return (unsigned)index;
+#else
+	return 63u - (unsigned)__builtin_clzll(v);
+#endif
+}
+
+// 线性区之后第一个区间的指数（2^4 = 16us）
+const unsigned FirstExponent = 4;
+const unsigned SubBits = 3; // 每个区间 8 桶
+
+} // namespace
+
+size_t LatencyHistogram::BucketIndex(uint64_t micros)
+{
+	if (micros < LinearBuckets) return (size_t)micros;
+	const unsigned e = FloorLog2(micros);
+	const size_t index = LinearBuckets + (size_t)(e - FirstExponent) * SubBuckets
+		+ (size_t)((micros >> (e - SubBits)) & (SubBuckets - 1));
+	return (std::min)(index, BucketCount - 1);
+}
+
+uint64_t LatencyHistogram::BucketLower(size_t index)
+{
+	if (index < LinearBuckets) return index;
+	const size_t e = FirstExponent + (index - LinearBuckets) / SubBuckets;
+	const size_t sub = (index - LinearBuckets) % SubBuckets;
+	return (uint64_t)(SubBuckets + sub) << (e - SubBits);
+}
+
+uint64_t LatencyHistogram::BucketUpper(size_t index)
+{
+	if (index < LinearBuckets) return index + 1;
+	const size_t e = FirstExponent + (index - LinearBuckets) / SubBuckets;
+	const size_t sub = (index - LinearBuckets) % SubBuckets;
+	return (uint64_t)(SubBuckets + sub + 1) << (e - SubBits);
+}
+
+void LatencyHistogram::Record(uint64_t micros)
+{
+	_buckets[BucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add(micros, std::memory_order_relaxed);
+	// 最大值极少更新：先读再 CAS，常见路径只有一次 load
+	uint64_t prev = _max.load(std::memory_order_relaxed);
+	while (micros > prev && !_max.compare_exchange_weak(prev, micros, std::memory_order_relaxed))
+	{
+	}
+}
+
+void LatencyHistogram::RecordSeconds(double seconds)
+{
+	if (!(seconds > 0.0))
+	{
+		Record(0);
+		return;
+	}
+	Record((uint64_t)(std::min)(seconds * 1e6 + 0.5, 1e15));
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const
+{
+	Snapshot s;
+	for (size_t i = 0; i < BucketCount; i++)
+		s.Buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+	s.Count = _count.load(std::memory_order_relaxed);
+	s.SumMicros = _sum.load(std::memory_order_relaxed);
+	s.MaxMicros = _max.load(std::memory_order_relaxed);
+	return s;
+}
+
+void LatencyHistogram::Reset()
+{
+	for (auto& b : _buckets)
+		b.store(0, std::memory_order_relaxed);
+	_count.store(0, std::memory_order_relaxed);
+	_sum.store(0, std::memory_order_relaxed);
+	_max.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::Snapshot::PercentileMs(double p) const
+{
+	// 以桶计数之和为准（与 Count 可能因并发记录相差几次）
+	uint64_t total = 0;
+	for (uint64_t b : Buckets) total += b;
+	if (total == 0) return 0.0;
+	p = std::clamp(p, 0.0, 100.0);
+	const uint64_t rank = (std::max)((uint64_t)1, (uint64_t)std::ceil(p / 100.0 * (double)total));
+	uint64_t seen = 0;
+	for (size_t i = 0; i < BucketCount; i++)
+	{
+		seen += Buckets[i];
+		if (seen < rank) continue;
+		const double lower = (double)BucketLower(i);
+		const double upper = (double)BucketUpper(i);
+		// 线性区每桶就是一个整数值
+		double micros = (i < LinearBuckets) ? lower : (lower + upper) * 0.5;
+		if (MaxMicros > 0) micros = (std::min)(micros, (double)MaxMicros);
+		return micros / 1000.0;
+	}
+	return MaxMs();
+}
+
+void PlaybackTelemetry::RecordAudioLateness(double seconds)
+{
+	const bool had = _hasAudio.load(std::memory_order_relaxed);
+	const double prev = _audioLateness.load(std::memory_order_relaxed);
+	_audioLateness.store(had ? prev + (seconds - prev) * Smoothing : seconds, std::memory_order_relaxed);
+	_hasAudio.store(true, std::memory_order_relaxed);
+}
+
+void PlaybackTelemetry::RecordVideoLateness(double seconds)
+{
+	const bool had = _hasVideo.load(std::memory_order_relaxed);
+	const double prev = _videoLateness.load(std::memory_order_relaxed);
+	_videoLateness.store(had ? prev + (seconds - prev) * Smoothing : seconds, std::memory_order_relaxed);
+	_hasVideo.store(true, std::memory_order_relaxed);
+	if (_hasAudio.load(std::memory_order_relaxed))
+		AvDrift.RecordSeconds(std::fabs(_audioLateness.load(std::memory_order_relaxed) - seconds));
+}
+
+double PlaybackTelemetry::AvDriftMs() const
+{
+	if (!_hasAudio.load(std::memory_order_relaxed) || !_hasVideo.load(std::memory_order_relaxed)) return 0.0;
+	return AudioLatenessMs() - VideoLatenessMs();
+}
+
+void PlaybackTelemetry::Fill(PlaybackStats& stats) const
+{
+	stats.Read = Read.GetSnapshot();
+	stats.Convert = Convert.GetSnapshot();
+	stats.Upload = Upload.GetSnapshot();
+	stats.Present = Present.GetSnapshot();
+	stats.AvDrift = AvDrift.GetSnapshot();
+	stats.VideoLatenessMs = VideoLatenessMs();
+	stats.AudioLatenessMs = AudioLatenessMs();
+	stats.AvDriftMs = AvDriftMs();
+}
+
+void PlaybackTelemetry::Reset()
+{
+	Read.Reset();
+	Convert.Reset();
+	Upload.Reset();
+	Present.Reset();
+	AvDrift.Reset();
+	_audioLateness.store(0.0, std::memory_order_relaxed);
+	_videoLateness.store(0.0, std::memory_order_relaxed);
+	_hasAudio.store(false, std::memory_order_relaxed);
+	_hasVideo.store(false, std::memory_order_relaxed);
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file PlaybackTelemetry.h
+ * @brief 播放性能遥测：无锁延迟直方图（LatencyHistogram）与 MediaPlayer 的统计快照（PlaybackStats）。
+ *
+ * 不依赖 Win32/Media Foundation，可单独编译测试。设计为可以在发布版本中常开：
+ * - Record 只做一次分桶（位运算）和几次 relaxed 原子加，不加锁、不分配；任意线程可同时记录
+ * - 快照逐项读取原子计数：不会阻塞记录端，但不同桶之间不是同一时刻的值（相差至多正在进行的几次记录）
+ *
+ * 直方图按微秒记录：0 - 15us 每 1us 一桶；之后每个 2 的幂区间 8 桶（相对误差 < 12.5%），上限约 134 秒。
+ */
+
+class LatencyHistogram
+{
+public:
+	static const size_t LinearBuckets = 16;
+	static const size_t SubBuckets = 8;
+	static const size_t BucketCount = 200;
+
+	/** @brief 某一时刻的计数副本（普通数据，可随意拷贝、比较前后两次求增量）。 */
+	struct Snapshot
+	{
+		uint64_t Count = 0;
+		/** @brief 记录值之和与最大值（微秒）。 */
+		uint64_t SumMicros = 0;
+		uint64_t MaxMicros = 0;
+		std::array<uint64_t, BucketCount> Buckets{};
+
+		double MeanMs() const { return Count ? (double)SumMicros / (double)Count / 1000.0 : 0.0; }
+		double MaxMs() const { return (double)MaxMicros / 1000.0; }
+		/**
+		 * @brief 百分位（p 取 0 - 100，毫秒）。
+		 *
+		 * 取所在桶的中点（不超过最大值），误差不超过桶宽的一半。
+		 */
+		double PercentileMs(double p) const;
+	};
+
+	LatencyHistogram() = default;
+	LatencyHistogram(const LatencyHistogram&) = delete;
+	LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+	void Record(uint64_t micros);
+	/** @brief 按秒记录（负数记为 0）。 */
+	void RecordSeconds(double seconds);
+	Snapshot GetSnapshot() const;
+	/** @brief 清零（与记录并发时，正在进行的记录可能部分保留）。 */
+	void Reset();
+
+	static size_t BucketIndex(uint64_t micros);
+	/** @brief 桶覆盖的区间 [Lower, Upper)（微秒）。 */
+	static uint64_t BucketLower(size_t index);
+	static uint64_t BucketUpper(size_t index);
+
+private:
+	std::atomic<uint64_t> _count{ 0 };
+	std::atomic<uint64_t> _sum{ 0 };
+	std::atomic<uint64_t> _max{ 0 };
+	std::array<std::atomic<uint64_t>, BucketCount> _buckets{};
+};
+
+/** @brief MediaPlayer 的播放统计快照（自加载或上次 ResetPlaybackStats 以来的累计值）。 */
+struct PlaybackStats
+{
+	/** @brief 各阶段耗时：ReadSample、视频颜色转换/拷贝、位图上传、DrawBitmap。 */
+	LatencyHistogram::Snapshot Read;
+	LatencyHistogram::Snapshot Convert;
+	LatencyHistogram::Snapshot Upload;
+	LatencyHistogram::Snapshot Present;
+	/** @brief 每次呈现视频帧时的音画偏差绝对值。 */
+	LatencyHistogram::Snapshot AvDrift;
+
+	/** @brief 视频帧：入队、呈现、迟到丢弃、帧池满丢弃。 */
+	uint64_t FramesQueued = 0;
+	uint64_t FramesPresented = 0;
+	uint64_t FramesLate = 0;
+	uint64_t FramesDropped = 0;
+
+	/**
+	 * @brief 相对呈现时间的延后（毫秒，指数平均；负数表示提前）。
+	 *
+	 * 视频为取出帧的时刻减去其 Pts；音频为写入时按排队量估计的出声时刻减去其 Pts（精度约一个设备周期）。
+	 * AvDriftMs = AudioLatenessMs - VideoLatenessMs，正数表示声音落后于画面。
+	 */
+	double VideoLatenessMs = 0.0;
+	double AudioLatenessMs = 0.0;
+	double AvDriftMs = 0.0;
+
+	/** @brief 音频：设备周期数、欠载周期数、缺帧时长与平均排队时长（毫秒）。 */
+	uint64_t AudioPeriods = 0;
+	uint64_t AudioUnderruns = 0;
+	double AudioStarvedMs = 0.0;
+	double AudioQueuedMs = 0.0;
+};
+
+/**
+ * @brief 播放遥测的记录端：各阶段直方图 + 音视频延后的指数平均。
+ *
+ * 音频延后只由音频写入线程记录、视频延后只由呈现线程记录（各自单写者，无需 RMW）；读取任意线程。
+ */
+class PlaybackTelemetry
+{
+public:
+	LatencyHistogram Read;
+	LatencyHistogram Convert;
+	LatencyHistogram Upload;
+	LatencyHistogram Present;
+	LatencyHistogram AvDrift;
+
+	/** @brief 一块音频的估计出声时刻与其 Pts 之差（秒）。 */
+	void RecordAudioLateness(double seconds);
+	/** @brief 一帧视频的取出时刻与其 Pts 之差（秒）；已有音频数据时同时记录音画偏差。 */
+	void RecordVideoLateness(double seconds);
+
+	double AudioLatenessMs() const { return _audioLateness.load(std::memory_order_relaxed) * 1000.0; }
+	double VideoLatenessMs() const { return _videoLateness.load(std::memory_order_relaxed) * 1000.0; }
+	/** @brief 音画偏差（毫秒）；音频或视频尚无数据时为 0。 */
+	double AvDriftMs() const;
+
+	/** @brief 填充快照中的直方图与延后字段（其余字段由调用方填写）。 */
+	void Fill(PlaybackStats& stats) const;
+	void Reset();
+
+	/** @brief 指数平均的权重（新样本）。 */
+	static constexpr double Smoothing = 0.1;
+
+private:
+	std::atomic<double> _audioLateness{ 0.0 };
+	std::atomic<double> _videoLateness{ 0.0 };
+	std::atomic<bool> _hasAudio{ false };
+	std::atomic<bool> _hasVideo{ false };
+};
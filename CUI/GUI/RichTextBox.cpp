@@ -19,9 +19,8 @@ CursorKind RichTextBox::QueryCursor(int xof, int yof)
 }
 RichTextBox::RichTextBox(std::wstring text, int x, int y, int width, int height)
 {
-	this->Text = text;
-	this->buffer = text;
-	this->bufferSyncedFromControl = true;
+	this->_text = text;
+	this->buffer.Assign(text);
 	this->Location = POINT{ x,y };
 	this->Size = SIZE{ width,height };
 	this->BackColor = Colors::LightGray;
@@ -29,36 +28,131 @@ RichTextBox::RichTextBox(std::wstring text, int x, int y, int width, int height)
 	UpdateLayout();
 }
 
-void RichTextBox::SyncBufferFromControlIfNeeded()
+GET_CPP(RichTextBox, std::wstring, Text)
 {
-	if (!this->bufferSyncedFromControl || this->TextChanged)
+	if (this->textStale)
 	{
-		this->buffer = this->Text;
-		this->bufferSyncedFromControl = true;
+		this->_text = this->buffer.ToString();
+		this->textStale = false;
 	}
+	return this->_text;
+}
+SET_CPP(RichTextBox, std::wstring, Text)
+{
+	// 读取 Text 同时把落后的 _text 与 buffer 对齐，基类据此比较与触发事件
+	std::wstring oldText = this->Text;
+	if (value == oldText) return;
+	this->buffer.Assign(value);
+	this->textStale = false;
+	this->blocksDirty = true;
+	this->selRangeDirty = true;
+	this->_caretRectCacheValid = false;
+	const int len = (int)this->buffer.Length();
+	this->SelectionStart = std::clamp(this->SelectionStart, 0, len);
+	this->SelectionEnd = std::clamp(this->SelectionEnd, 0, len);
+	// 事件、重绘、布局请求与空间索引更新沿用基类
+	Control::SetText(value);
+}
+
+std::wstring RichTextBox::SnapshotTextForEvent()
+{
+	// 只有存在订阅者时才需要完整的旧文本
+	if (this->OnTextChanged.Count() == 0)
+		return std::wstring();
+	return this->Text;
 }
 
 void RichTextBox::SyncControlTextFromBuffer(const std::wstring& oldText)
 {
-	this->setTextPrivate(this->buffer);
+	this->textStale = true;
 	this->TextChanged = true;
-	this->OnTextChanged(this, oldText, this->buffer);
+	if (this->OnTextChanged.Count() > 0)
+		this->OnTextChanged(this, oldText, this->Text);
+}
+
+bool RichTextBox::TrimToMaxLength()
+{
+	if (this->MaxTextLength == 0) return false;
+	const size_t len = this->buffer.Length();
+	if (len <= this->MaxTextLength) return false;
+
+	const size_t removeCount = len - this->MaxTextLength;
+	this->buffer.Erase(0, removeCount);
+	OnBufferEdited(0, removeCount, 0);
+
+	const int newLen = (int)this->buffer.Length();
+	this->SelectionStart = std::clamp(this->SelectionStart - (int)removeCount, 0, newLen);
+	this->SelectionEnd = std::clamp(this->SelectionEnd - (int)removeCount, 0, newLen);
+	return true;
+}
+
+int RichTextBox::FindBlockIndex(size_t pos) const
+{
+	// 最后一个 start <= pos 的块
+	auto it = std::upper_bound(this->blocks.begin(), this->blocks.end(), pos,
+		[](size_t p, const TextBlock& b) { return p < b.start; });
+	if (it == this->blocks.begin()) return 0;
+	return (int)(it - this->blocks.begin()) - 1;
 }
 
-void RichTextBox::TrimToMaxLength()
+void RichTextBox::OnBufferEdited(size_t pos, size_t removedLen, size_t insertedLen)
 {
-	if (this->MaxTextLength == 0) return;
-	if (this->buffer.size() <= this->MaxTextLength) return;
+	this->selRangeDirty = true;
+	this->_caretRectCacheValid = false;
+	if (!this->virtualMode || this->blocksDirty || this->blocks.empty())
+	{
+		this->blocksDirty = true;
+		return;
+	}
+
+	// 受影响的块：包含 pos 的块到包含最后一个被删字符的块
+	const int first = FindBlockIndex(pos);
+	const int last = removedLen > 0 ? FindBlockIndex(pos + removedLen - 1) : first;
+	const size_t mergedStart = this->blocks[first].start;
+	const size_t mergedEnd = this->blocks[last].start + this->blocks[last].len;
+	const size_t newLen = (mergedEnd - mergedStart) + insertedLen - removedLen;
 
-	const size_t removeCount = this->buffer.size() - this->MaxTextLength;
-	if (removeCount == 0) return;
+	for (int i = first; i <= last; i++)
+	{
+		if (this->blocks[i].layout)
+		{
+			this->blocks[i].layout->Release();
+			this->blocks[i].layout = NULL;
+		}
+	}
+	if (last > first)
+		this->blocks.erase(this->blocks.begin() + first + 1, this->blocks.begin() + last + 1);
 
-	this->buffer = this->buffer.substr(removeCount);
+	for (size_t i = (size_t)first + 1; i < this->blocks.size(); i++)
+	{
+		this->blocks[i].start = this->blocks[i].start + insertedLen - removedLen;
+	}
+
+	const size_t blockSize = std::max((size_t)256, this->BlockCharCount);
+	if (newLen == 0)
+	{
+		this->blocks.erase(this->blocks.begin() + first);
+	}
+	else if (newLen > blockSize * 2)
+	{
+		std::vector<TextBlock> parts;
+		AppendBlocks(mergedStart, newLen, parts);
+		this->blocks.erase(this->blocks.begin() + first);
+		this->blocks.insert(this->blocks.begin() + first, parts.begin(), parts.end());
+	}
+	else
+	{
+		this->blocks[first].len = newLen;
+		this->blocks[first].height = -1.0f;
+	}
 
-	this->SelectionStart = std::max(0, this->SelectionStart - (int)removeCount);
-	this->SelectionEnd = std::max(0, this->SelectionEnd - (int)removeCount);
-	if (this->SelectionStart > (int)this->buffer.size()) this->SelectionStart = (int)this->buffer.size();
-	if (this->SelectionEnd > (int)this->buffer.size()) this->SelectionEnd = (int)this->buffer.size();
+	if (this->blocks.empty())
+	{
+		this->blocksDirty = true;
+		return;
+	}
+	this->blockTopsDirtyFrom = this->blockTopsDirty ? std::min(this->blockTopsDirtyFrom, first) : first;
+	this->blockTopsDirty = true;
 }
 
 void RichTextBox::UpdateSelRange()
@@ -97,9 +191,8 @@ void RichTextBox::UpdateLayout()
 
 	if (!this->ParentForm)
 		return;
-	SyncBufferFromControlIfNeeded();
 
-	this->virtualMode = (this->EnableVirtualization && this->AllowMultiLine && this->buffer.size() >= this->VirtualizeThreshold);
+	this->virtualMode = (this->EnableVirtualization && this->AllowMultiLine && this->buffer.Length() >= this->VirtualizeThreshold);
 	if (this->virtualMode)
 	{
 		if (this->layOutCache)
@@ -111,12 +204,13 @@ void RichTextBox::UpdateLayout()
 		float renderWidth = this->Width - (TextMargin * 2.0f);
 		float renderHeight = this->Height - (TextMargin * 2.0f);
 
-		if (this->TextChanged || this->lastLayoutSize.cx != this->Width || this->lastLayoutSize.cy != this->Height || this->blocksDirty)
+		// 编辑已通过 OnBufferEdited 增量修补块，这里只在整体失效或尺寸变化时重建
+		if (this->lastLayoutSize.cx != this->Width || this->lastLayoutSize.cy != this->Height || this->blocksDirty)
 		{
 			RebuildBlocks();
 			this->lastLayoutSize = SIZE{ this->Width, this->Height };
-			this->TextChanged = false;
 		}
+		this->TextChanged = false;
 
 		EnsureAllBlockMetrics(renderWidth, renderHeight);
 		this->textSize.height = this->virtualTotalHeight;
@@ -137,12 +231,13 @@ void RichTextBox::UpdateLayout()
 			float render_width = this->Width - (TextMargin * 2.0f);
 			float render_height = this->Height - (TextMargin * 2.0f);
 
-			this->layOutCache = d2d->CreateStringLayout(this->buffer, render_width, render_height, font);
+			const std::wstring text = this->buffer.ToString();
+			this->layOutCache = d2d->CreateStringLayout(text, render_width, render_height, font);
 			textSize = font->GetTextSize(layOutCache);
 			if (textSize.height > render_height)
 			{
 				if (this->layOutCache) this->layOutCache->Release();
-				this->layOutCache = d2d->CreateStringLayout(this->buffer, render_width - 8.0f, render_height, font);
+				this->layOutCache = d2d->CreateStringLayout(text, render_width - 8.0f, render_height, font);
 				textSize = font->GetTextSize(layOutCache);
 			}
 			if (this->layOutCache)
@@ -169,44 +264,50 @@ void RichTextBox::ReleaseBlocks()
 	this->blockTops.clear();
 	this->blocksDirty = true;
 	this->blockMetricsDirty = true;
+	this->blockTopsDirty = false;
 	this->virtualTotalHeight = 0.0f;
 	this->layoutWidthHasScrollBar = false;
 	this->cachedRenderWidth = 0.0f;
 }
 
-void RichTextBox::RebuildBlocks()
+void RichTextBox::AppendBlocks(size_t start, size_t len, std::vector<TextBlock>& out) const
 {
-	ReleaseBlocks();
-	this->blocksDirty = false;
-	this->blockMetricsDirty = true;
-
-	const size_t n = this->buffer.size();
-	if (n == 0) return;
-
 	const size_t blockSize = std::max((size_t)256, this->BlockCharCount);
-	size_t i = 0;
-	while (i < n)
+	const size_t end = start + len;
+	size_t i = start;
+	while (i < end)
 	{
-		size_t len = std::min(blockSize, n - i);
-		if (i + len < n)
+		size_t n = std::min(blockSize, end - i);
+		if (i + n < end)
 		{
-			wchar_t last = this->buffer[i + len - 1];
-			wchar_t next = this->buffer[i + len];
+			wchar_t last = this->buffer[i + n - 1];
+			wchar_t next = this->buffer[i + n];
 			bool lastHigh = (last >= 0xD800 && last <= 0xDBFF);
 			bool nextLow = (next >= 0xDC00 && next <= 0xDFFF);
 			if (lastHigh && nextLow)
 			{
-				len += 1;
+				n += 1;
 			}
 		}
 		TextBlock b;
 		b.start = i;
-		b.len = len;
-		this->blocks.push_back(b);
-		i += len;
+		b.len = n;
+		out.push_back(b);
+		i += n;
 	}
 }
 
+void RichTextBox::RebuildBlocks()
+{
+	ReleaseBlocks();
+	this->blocksDirty = false;
+	this->blockMetricsDirty = true;
+
+	const size_t n = this->buffer.Length();
+	if (n == 0) return;
+	AppendBlocks(0, n, this->blocks);
+}
+
 void RichTextBox::EnsureBlockLayout(int idx, float renderWidth, float renderHeight)
 {
 	if (idx < 0 || idx >= (int)this->blocks.size()) return;
@@ -216,7 +317,7 @@ void RichTextBox::EnsureBlockLayout(int idx, float renderWidth, float renderHeig
 	auto d2d = this->ParentForm->Render;
 	auto font = this->Font;
 
-	std::wstring s = this->buffer.substr(b.start, b.len);
+	std::wstring s = this->buffer.Substr(b.start, b.len);
 	b.layout = d2d->CreateStringLayout(s, renderWidth, FLT_MAX, font);
 	auto sz = font->GetTextSize(b.layout);
 	b.height = sz.height;
@@ -226,7 +327,11 @@ void RichTextBox::EnsureBlockLayout(int idx, float renderWidth, float renderHeig
 void RichTextBox::EnsureAllBlockMetrics(float renderWidth, float renderHeight)
 {
 	if (!this->blockMetricsDirty && this->cachedRenderWidth == renderWidth)
+	{
+		if (this->blockTopsDirty)
+			UpdateBlockTops(renderHeight);
 		return;
+	}
 
 	this->cachedRenderWidth = renderWidth;
 	this->virtualTotalHeight = 0.0f;
@@ -265,6 +370,42 @@ void RichTextBox::EnsureAllBlockMetrics(float renderWidth, float renderHeight)
 	}
 	this->virtualTotalHeight = total;
 	this->blockMetricsDirty = false;
+	this->blockTopsDirty = false;
+}
+
+void RichTextBox::UpdateBlockTops(float renderHeight)
+{
+	// 增量路径：被编辑块之前的 top 不变，从第一个被编辑的块起平移；
+	// 只为被编辑失效（height < 0）的块重新创建布局，其余块复用缓存高度
+	float w = this->cachedRenderWidth;
+	if (this->layoutWidthHasScrollBar) w = std::max(0.0f, w - 8.0f);
+	const int count = (int)this->blocks.size();
+	this->blockTops.resize(count);
+	const int from = std::clamp(this->blockTopsDirtyFrom, 0, count);
+	float y = from > 0 ? this->blockTops[from - 1] + this->blocks[from - 1].height : 0.0f;
+	for (int i = from; i < count; i++)
+	{
+		this->blockTops[i] = y;
+		EnsureBlockLayout(i, w, renderHeight);
+		y += this->blocks[i].height;
+	}
+	this->blockTopsDirty = false;
+	if ((y > renderHeight) != this->layoutWidthHasScrollBar)
+	{
+		// 滚动条出现/消失会改变可用宽度，需要全部重排
+		this->blockMetricsDirty = true;
+		EnsureAllBlockMetrics(this->cachedRenderWidth, renderHeight);
+		return;
+	}
+	this->virtualTotalHeight = y;
+}
+
+int RichTextBox::FindBlockAtY(float contentY) const
+{
+	// 最后一个 top <= contentY 的块（blockTops 单调不减）
+	auto it = std::upper_bound(this->blockTops.begin(), this->blockTops.end(), contentY);
+	if (it == this->blockTops.begin()) return 0;
+	return (int)(it - this->blockTops.begin()) - 1;
 }
 
 int RichTextBox::HitTestGlobalIndex(float x, float y)
@@ -277,14 +418,7 @@ int RichTextBox::HitTestGlobalIndex(float x, float y)
 	float contentY = (y + this->OffsetY) - this->TextMargin;
 	if (contentY < 0) contentY = 0;
 
-	int idx = 0;
-	for (int i = 0; i < (int)this->blockTops.size(); i++)
-	{
-		if (contentY >= this->blockTops[i])
-			idx = i;
-		else
-			break;
-	}
+	const int idx = FindBlockAtY(contentY);
 	EnsureBlockLayout(idx, renderWidth, renderHeight);
 	float yInBlock = contentY - this->blockTops[idx];
 	float xInBlock = x - this->TextMargin;
@@ -292,7 +426,7 @@ int RichTextBox::HitTestGlobalIndex(float x, float y)
 
 	int local = this->Font->HitTestTextPosition(this->blocks[idx].layout, xInBlock, yInBlock);
 	int global = (int)this->blocks[idx].start + local;
-	global = std::clamp(global, 0, (int)this->buffer.size());
+	global = std::clamp(global, 0, (int)this->buffer.Length());
 	return global;
 }
 
@@ -305,7 +439,7 @@ bool RichTextBox::GetCaretMetrics(int caretIndex, float& outX, float& outY, floa
 	float renderWidth = this->Width - (TextMargin * 2.0f);
 	if (this->layoutWidthHasScrollBar) renderWidth -= 8.0f;
 
-	caretIndex = std::clamp(caretIndex, 0, (int)this->buffer.size());
+	caretIndex = std::clamp(caretIndex, 0, (int)this->buffer.Length());
 	int blockIdx = 0;
 	for (int i = 0; i < (int)this->blocks.size(); i++)
 	{
@@ -360,7 +494,7 @@ void RichTextBox::ScrollToEnd()
 	int max_scroll = textSize.height - _render_height;
 	this->OffsetY = max_scroll;
 	if (this->OffsetY < 0)this->OffsetY = 0;
-	this->SelectionEnd = this->SelectionStart = (int)this->buffer.size();
+	this->SelectionEnd = this->SelectionStart = (int)this->buffer.Length();
 	this->PostRender();
 }
 void RichTextBox::UpdateScrollDrag(float posY) {
@@ -421,42 +555,12 @@ void RichTextBox::SetScrollByPos(float yof)
 }
 void RichTextBox::InputText(std::wstring input)
 {
-	SyncBufferFromControlIfNeeded();
-	TrimToMaxLength();
-	int sels = SelectionStart <= SelectionEnd ? SelectionStart : SelectionEnd;
-	int sele = SelectionEnd >= SelectionStart ? SelectionEnd : SelectionStart;
-
-	std::wstring oldText = this->buffer;
-	UndoRecord rec;
-	bool shouldRecord = false;
-	sels = std::clamp(sels, 0, (int)this->buffer.size());
-	sele = std::clamp(sele, 0, (int)this->buffer.size());
-
-	if (!this->isApplyingUndoRedo && (!input.empty() || sele > sels))
-	{
-		rec.pos = sels;
-		rec.removedText = (sele > sels) ? this->buffer.substr((size_t)sels, (size_t)(sele - sels)) : L"";
-		rec.insertedText = input;
-		rec.selStartBefore = this->SelectionStart;
-		rec.selEndBefore = this->SelectionEnd;
-		shouldRecord = true;
-	}
-	if (sels == sele && sels == (int)this->buffer.size())
-	{
-		this->buffer.append(input);
-		SelectionEnd = SelectionStart = (int)this->buffer.size();
-	}
-	else
-	{
-		if (sele > sels)
-			this->buffer.erase((size_t)sels, (size_t)(sele - sels));
-		this->buffer.insert((size_t)sels, input);
-		SelectionEnd = SelectionStart = sels + (int)input.size();
-	}
-
+	// 超出 MaxTextLength 时从头部截断会平移所有位置，已有历史随之失效
+	if (TrimToMaxLength())
+		this->undoHistory.Clear();
 	if (!this->AllowMultiLine)
 	{
-		for (auto& ch : this->buffer)
+		for (auto& ch : input)
 		{
 			if (ch == L'\r' || ch == L'\n')
 			{
@@ -464,180 +568,114 @@ void RichTextBox::InputText(std::wstring input)
 			}
 		}
 	}
-	TrimToMaxLength();
-	this->selRangeDirty = true;
-	this->blocksDirty = true;
-	if (shouldRecord)
+	const int len = (int)this->buffer.Length();
+	int sels = SelectionStart <= SelectionEnd ? SelectionStart : SelectionEnd;
+	int sele = SelectionEnd >= SelectionStart ? SelectionEnd : SelectionStart;
+	sels = std::clamp(sels, 0, len);
+	sele = std::clamp(sele, 0, len);
+
+	std::wstring oldText = SnapshotTextForEvent();
+	const int selStartBefore = this->SelectionStart;
+	const int selEndBefore = this->SelectionEnd;
+	std::wstring removed;
+	if (sele > sels)
 	{
-		rec.selStartAfter = this->SelectionStart;
-		rec.selEndAfter = this->SelectionEnd;
-		this->undoStack.push_back(rec);
-		this->redoStack.clear();
+		removed = this->buffer.Substr((size_t)sels, (size_t)(sele - sels));
+		this->buffer.Erase((size_t)sels, (size_t)(sele - sels));
 	}
+	this->buffer.Insert((size_t)sels, input);
+	OnBufferEdited((size_t)sels, (size_t)(sele - sels), input.size());
+	SelectionEnd = SelectionStart = sels + (int)input.size();
+
+	if (TrimToMaxLength())
+		this->undoHistory.Clear();
+	else
+		this->undoHistory.Record((size_t)sels, removed, input, selStartBefore, selEndBefore, this->SelectionStart, this->SelectionEnd);
 	SyncControlTextFromBuffer(oldText);
 }
 void RichTextBox::InputBack()
 {
-	SyncBufferFromControlIfNeeded();
+	const int len = (int)this->buffer.Length();
 	int sels = SelectionStart <= SelectionEnd ? SelectionStart : SelectionEnd;
 	int sele = SelectionEnd >= SelectionStart ? SelectionEnd : SelectionStart;
+	sels = std::clamp(sels, 0, len);
+	sele = std::clamp(sele, 0, len);
 	int selLen = sele - sels;
-	std::wstring oldText = this->buffer;
-	UndoRecord rec;
-	bool shouldRecord = false;
-	sels = std::clamp(sels, 0, (int)this->buffer.size());
-	sele = std::clamp(sele, 0, (int)this->buffer.size());
-	selLen = sele - sels;
-
-	if (selLen > 0)
-	{
-		if (!this->isApplyingUndoRedo)
-		{
-			rec.pos = sels;
-			rec.removedText = this->buffer.substr((size_t)sels, (size_t)selLen);
-			rec.insertedText = L"";
-			rec.selStartBefore = this->SelectionStart;
-			rec.selEndBefore = this->SelectionEnd;
-			shouldRecord = true;
-		}
-		this->SelectionStart = this->SelectionEnd = sels;
-		this->buffer.erase((size_t)sels, (size_t)selLen);
-	}
-	else if (sels > 0)
-	{
-		if (!this->isApplyingUndoRedo)
-		{
-			rec.pos = sels - 1;
-			rec.removedText = this->buffer.substr((size_t)sels - 1, 1);
-			rec.insertedText = L"";
-			rec.selStartBefore = this->SelectionStart;
-			rec.selEndBefore = this->SelectionEnd;
-			shouldRecord = true;
-		}
-		this->buffer.erase((size_t)sels - 1, 1);
-		this->SelectionStart = this->SelectionEnd = sels - 1;
-	}
-	this->selRangeDirty = true;
-	this->blocksDirty = true;
-	if (shouldRecord)
-	{
-		rec.selStartAfter = this->SelectionStart;
-		rec.selEndAfter = this->SelectionEnd;
-		this->undoStack.push_back(rec);
-		this->redoStack.clear();
-	}
+	if (selLen == 0 && sels == 0) return;
+
+	std::wstring oldText = SnapshotTextForEvent();
+	const int selStartBefore = this->SelectionStart;
+	const int selEndBefore = this->SelectionEnd;
+	const int pos = selLen > 0 ? sels : sels - 1;
+	const int count = selLen > 0 ? selLen : 1;
+	std::wstring removed = this->buffer.Substr((size_t)pos, (size_t)count);
+	this->buffer.Erase((size_t)pos, (size_t)count);
+	OnBufferEdited((size_t)pos, (size_t)count, 0);
+	this->SelectionStart = this->SelectionEnd = pos;
+
+	this->undoHistory.Record((size_t)pos, removed, std::wstring(), selStartBefore, selEndBefore, this->SelectionStart, this->SelectionEnd);
 	SyncControlTextFromBuffer(oldText);
 }
 void RichTextBox::InputDelete()
 {
-	SyncBufferFromControlIfNeeded();
+	const int len = (int)this->buffer.Length();
 	int sels = SelectionStart <= SelectionEnd ? SelectionStart : SelectionEnd;
 	int sele = SelectionEnd >= SelectionStart ? SelectionEnd : SelectionStart;
+	sels = std::clamp(sels, 0, len);
+	sele = std::clamp(sele, 0, len);
 	int selLen = sele - sels;
-	std::wstring oldText = this->buffer;
-	UndoRecord rec;
-	bool shouldRecord = false;
-	sels = std::clamp(sels, 0, (int)this->buffer.size());
-	sele = std::clamp(sele, 0, (int)this->buffer.size());
-	selLen = sele - sels;
-
-	if (selLen > 0)
-	{
-		if (!this->isApplyingUndoRedo)
-		{
-			rec.pos = sels;
-			rec.removedText = this->buffer.substr((size_t)sels, (size_t)selLen);
-			rec.insertedText = L"";
-			rec.selStartBefore = this->SelectionStart;
-			rec.selEndBefore = this->SelectionEnd;
-			shouldRecord = true;
-		}
-		this->SelectionStart = this->SelectionEnd = sels;
-		this->buffer.erase((size_t)sels, (size_t)selLen);
-	}
-	else if (sels < (int)this->buffer.size())
-	{
-		if (!this->isApplyingUndoRedo)
-		{
-			rec.pos = sels;
-			rec.removedText = this->buffer.substr((size_t)sels, 1);
-			rec.insertedText = L"";
-			rec.selStartBefore = this->SelectionStart;
-			rec.selEndBefore = this->SelectionEnd;
-			shouldRecord = true;
-		}
-		this->buffer.erase((size_t)sels, 1);
-		this->SelectionStart = this->SelectionEnd = sels;
-	}
-	this->selRangeDirty = true;
-	this->blocksDirty = true;
-	if (shouldRecord)
-	{
-		rec.selStartAfter = this->SelectionStart;
-		rec.selEndAfter = this->SelectionEnd;
-		this->undoStack.push_back(rec);
-		this->redoStack.clear();
-	}
+	if (selLen == 0 && sels >= len) return;
+
+	std::wstring oldText = SnapshotTextForEvent();
+	const int selStartBefore = this->SelectionStart;
+	const int selEndBefore = this->SelectionEnd;
+	const int count = selLen > 0 ? selLen : 1;
+	std::wstring removed = this->buffer.Substr((size_t)sels, (size_t)count);
+	this->buffer.Erase((size_t)sels, (size_t)count);
+	OnBufferEdited((size_t)sels, (size_t)count, 0);
+	this->SelectionStart = this->SelectionEnd = sels;
+
+	this->undoHistory.Record((size_t)sels, removed, std::wstring(), selStartBefore, selEndBefore, this->SelectionStart, this->SelectionEnd);
 	SyncControlTextFromBuffer(oldText);
 }
-void RichTextBox::ApplyUndoRecord(const UndoRecord& rec, bool isUndo)
+void RichTextBox::ApplyUndoChange(const UndoEngine::Change& change)
 {
-	SyncBufferFromControlIfNeeded();
-	std::wstring oldText = this->buffer;
-	this->isApplyingUndoRedo = true;
-
-	int pos = std::clamp(rec.pos, 0, (int)this->buffer.size());
-	const std::wstring& removeText = isUndo ? rec.insertedText : rec.removedText;
-	const std::wstring& insertText = isUndo ? rec.removedText : rec.insertedText;
-
-	if (!removeText.empty() && pos <= (int)this->buffer.size())
-	{
-		size_t removeLen = std::min(removeText.size(), this->buffer.size() - (size_t)pos);
-		this->buffer.erase((size_t)pos, removeLen);
-	}
-	if (!insertText.empty())
-	{
-		this->buffer.insert((size_t)pos, insertText);
-	}
-
-	if (isUndo)
-	{
-		this->SelectionStart = rec.selStartBefore;
-		this->SelectionEnd = rec.selEndBefore;
-	}
-	else
-	{
-		this->SelectionStart = rec.selStartAfter;
-		this->SelectionEnd = rec.selEndAfter;
-	}
-	TrimToMaxLength();
-	this->SelectionStart = std::clamp(this->SelectionStart, 0, (int)this->buffer.size());
-	this->SelectionEnd = std::clamp(this->SelectionEnd, 0, (int)this->buffer.size());
-	this->selRangeDirty = true;
-	this->blocksDirty = true;
+	std::wstring oldText = SnapshotTextForEvent();
+
+	const size_t pos = std::min(change.Pos, this->buffer.Length());
+	const size_t removeLen = std::min(change.RemoveLen, this->buffer.Length() - pos);
+	if (removeLen > 0)
+		this->buffer.Erase(pos, removeLen);
+	if (!change.InsertText.empty())
+		this->buffer.Insert(pos, change.InsertText);
+	OnBufferEdited(pos, removeLen, change.InsertText.size());
+
+	this->SelectionStart = change.SelStart;
+	this->SelectionEnd = change.SelEnd;
+	if (TrimToMaxLength())
+		this->undoHistory.Clear();
+	this->SelectionStart = std::clamp(this->SelectionStart, 0, (int)this->buffer.Length());
+	this->SelectionEnd = std::clamp(this->SelectionEnd, 0, (int)this->buffer.Length());
 
-	this->isApplyingUndoRedo = false;
 	SyncControlTextFromBuffer(oldText);
 }
 void RichTextBox::Undo()
 {
-	if (this->undoStack.empty()) return;
-	UndoRecord rec = this->undoStack.back();
-	this->undoStack.pop_back();
-	ApplyUndoRecord(rec, true);
-	this->redoStack.push_back(rec);
+	UndoEngine::Change change;
+	if (!this->undoHistory.Undo([this](size_t pos, size_t len) { return this->buffer.Substr(pos, len); }, change))
+		return;
+	ApplyUndoChange(change);
 }
 void RichTextBox::Redo()
 {
-	if (this->redoStack.empty()) return;
-	UndoRecord rec = this->redoStack.back();
-	this->redoStack.pop_back();
-	ApplyUndoRecord(rec, false);
-	this->undoStack.push_back(rec);
+	UndoEngine::Change change;
+	if (!this->undoHistory.Redo([this](size_t pos, size_t len) { return this->buffer.Substr(pos, len); }, change))
+		return;
+	ApplyUndoChange(change);
 }
 void RichTextBox::UpdateScroll(bool arrival)
 {
-	if (this->TextChanged || (this->virtualMode && (this->blocksDirty || this->blockMetricsDirty)) || (!this->virtualMode && this->layOutCache == NULL))
+	if (this->TextChanged || (this->virtualMode && (this->blocksDirty || this->blockMetricsDirty || this->blockTopsDirty)) || (!this->virtualMode && this->layOutCache == NULL))
 	{
 		this->UpdateLayout();
 	}
@@ -650,7 +688,7 @@ void RichTextBox::UpdateScroll(bool arrival)
 			float render_height = this->Height - (TextMargin * 2.0f);
 			float caretTopContent = (cy - this->TextMargin) + this->OffsetY;
 			float caretBottomContent = caretTopContent + ch;
-			if (arrival && this->SelectionEnd >= (int)this->buffer.size())
+			if (arrival && this->SelectionEnd >= (int)this->buffer.Length())
 			{
 				const float maxScroll = std::max(0.0f, this->textSize.height - render_height);
 				this->OffsetY = maxScroll;
@@ -674,7 +712,7 @@ void RichTextBox::UpdateScroll(bool arrival)
 	if (selected.size() > 0)
 	{
 		auto lastSelect = selected[0];
-		if (arrival && this->SelectionEnd >= (int)this->buffer.size())
+		if (arrival && this->SelectionEnd >= (int)this->buffer.Length())
 		{
 			const float maxScroll = std::max(0.0f, this->textSize.height - render_height);
 			OffsetY = maxScroll;
@@ -691,34 +729,107 @@ void RichTextBox::UpdateScroll(bool arrival)
 }
 void RichTextBox::AppendText(std::wstring str)
 {
-	SyncBufferFromControlIfNeeded();
-	this->SelectionStart = this->SelectionEnd = (int)this->buffer.size();
+	this->SelectionStart = this->SelectionEnd = (int)this->buffer.Length();
 	this->InputText(str);
-	this->selRangeDirty = true;
 }
 void RichTextBox::AppendLine(std::wstring str)
 {
-	SyncBufferFromControlIfNeeded();
-	this->SelectionStart = this->SelectionEnd = (int)this->buffer.size();
+	if (this->IsLogMode())
+	{
+		// 每批只在第一行时投递一次重绘，其余行在同一帧中合并。
+		// 生产线程只使缓存失效（原子标志）并投递 InvalidateRect，PostRender 留给 UI 线程的 FlushLog
+		if (this->logLines.Post(std::move(str)))
+		{
+			this->InvalidateDisplayList();
+			auto* form = this->ParentForm;
+			if (form && form->Handle)
+				::InvalidateRect(form->Handle, NULL, FALSE);
+		}
+		return;
+	}
+	this->SelectionStart = this->SelectionEnd = (int)this->buffer.Length();
 	this->InputText(str + L"\r");
-	this->selRangeDirty = true;
+}
+void RichTextBox::SetLogMode(bool enable, size_t maxLines, size_t maxChars)
+{
+	this->logLines.SetLimits(maxLines, maxChars);
+	if (enable)
+	{
+		this->logLines.Reset(this->buffer.Length());
+		this->undoHistory.Clear();
+		this->logMode.store(true, std::memory_order_release);
+	}
+	else
+	{
+		this->FlushLog();
+		this->logMode.store(false, std::memory_order_release);
+	}
+}
+void RichTextBox::FlushLog()
+{
+	if (this->ApplyLogBatch())
+		this->PostRender();
+}
+bool RichTextBox::ApplyLogBatch()
+{
+	// 用户编辑或 Text 被重设后，记账与实际文本不一致，按当前文本重新对齐
+	if (this->logLines.CharCount() != this->buffer.Length())
+		this->logLines.Reset(this->buffer.Length());
+
+	LogLineBuffer::Batch batch;
+	if (!this->logLines.TakeBatch(batch)) return false;
+
+	const size_t oldLen = this->buffer.Length();
+	const bool followTail = (this->SelectionStart == this->SelectionEnd && this->SelectionEnd >= (int)oldLen);
+	std::wstring oldText = SnapshotTextForEvent();
+
+	const size_t evict = std::min(batch.EvictChars, oldLen);
+	if (evict > 0)
+	{
+		this->buffer.Erase(0, evict);
+		OnBufferEdited(0, evict, 0);
+		// 淘汰会平移所有位置，旧的撤销记录不再有效
+		this->undoHistory.Clear();
+		const int newLen = (int)this->buffer.Length();
+		this->SelectionStart = std::clamp(this->SelectionStart - (int)evict, 0, newLen);
+		this->SelectionEnd = std::clamp(this->SelectionEnd - (int)evict, 0, newLen);
+	}
+	if (!batch.Text.empty())
+	{
+		const size_t pos = this->buffer.Length();
+		this->buffer.Insert(pos, batch.Text);
+		OnBufferEdited(pos, 0, batch.Text.size());
+	}
+	if (followTail)
+		this->SelectionStart = this->SelectionEnd = (int)this->buffer.Length();
+	SyncControlTextFromBuffer(oldText);
+
+	if (followTail)
+	{
+		this->UpdateLayout();
+		const float renderHeight = this->Height - (TextMargin * 2.0f);
+		this->OffsetY = std::max(0.0f, this->textSize.height - renderHeight);
+	}
+	return true;
 }
 std::wstring RichTextBox::GetSelectedString()
 {
-	SyncBufferFromControlIfNeeded();
 	int sels = SelectionStart <= SelectionEnd ? SelectionStart : SelectionEnd;
 	int sele = SelectionEnd >= SelectionStart ? SelectionEnd : SelectionStart;
 	if (sele > sels)
 	{
-		sels = std::clamp(sels, 0, (int)this->buffer.size());
-		sele = std::clamp(sele, 0, (int)this->buffer.size());
-		return this->buffer.substr((size_t)sels, (size_t)(sele - sels));
+		sels = std::clamp(sels, 0, (int)this->buffer.Length());
+		sele = std::clamp(sele, 0, (int)this->buffer.Length());
+		return this->buffer.Substr((size_t)sels, (size_t)(sele - sels));
 	}
 	return L"";
 }
 void RichTextBox::Update()
 {
 	if (this->IsVisual == false)return;
+	// 正在绘制本控件：直接合并写入，不再请求下一帧
+	if (this->IsLogMode() && this->logLines.HasPending())
+		this->ApplyLogBatch();
 	this->UpdateLayout();
 	bool isUnderMouse = this->ParentForm->UnderMouse == this;
 	auto d2d = this->ParentForm->Render;
@@ -736,7 +847,7 @@ void RichTextBox::Update()
 		{
 			this->RenderImage();
 		}
-		if (this->buffer.size() > 0)
+		if (this->buffer.Length() > 0)
 		{
 			auto font = this->Font;
 			if (this->virtualMode)
@@ -769,15 +880,9 @@ void RichTextBox::Update()
 				float viewTop = this->OffsetY;
 				float viewBottom = this->OffsetY + renderHeight;
 
-				int first = 0;
-				for (int i = 0; i < (int)this->blockTops.size(); i++)
-				{
-					if (this->blockTops[i] + this->blocks[i].height >= viewTop)
-					{
-						first = i;
-						break;
-					}
-				}
+				int first = FindBlockAtY(viewTop);
+				if (first < (int)this->blocks.size() && this->blockTops[first] + this->blocks[first].height < viewTop)
+					first++;
 
 				for (int i = first; i < (int)this->blocks.size(); i++)
 				{
@@ -1102,16 +1207,16 @@ bool RichTextBox::ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int
 		}
 		else if (wParam == VK_RIGHT)
 		{
-			if (this->SelectionEnd < this->Text.size())
+			if (this->SelectionEnd < this->buffer.Length())
 			{
 				this->SelectionEnd = this->SelectionEnd + 1;
 				if ((GetAsyncKeyState(VK_SHIFT) & 0x8000) == false)
 				{
 					this->SelectionStart = this->SelectionEnd;
 				}
-				if (this->SelectionEnd > this->Text.size())
+				if (this->SelectionEnd > this->buffer.Length())
 				{
-					this->SelectionEnd = this->Text.size();
+					this->SelectionEnd = this->buffer.Length();
 				}
 				this->selRangeDirty = true;
 				UpdateScroll();
@@ -1177,9 +1282,9 @@ bool RichTextBox::ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int
 			{
 				this->SelectionStart = this->SelectionEnd;
 			}
-			if (this->SelectionEnd > this->Text.size())
+			if (this->SelectionEnd > this->buffer.Length())
 			{
-				this->SelectionEnd = this->Text.size();
+				this->SelectionEnd = this->buffer.Length();
 			}
 			this->selRangeDirty = true;
 			UpdateScroll();
@@ -1200,10 +1305,10 @@ bool RichTextBox::ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int
 		}
 		else if (wParam == VK_END)
 		{
-			this->SelectionEnd = this->Text.size();
-			if (this->SelectionEnd > this->Text.size())
+			this->SelectionEnd = this->buffer.Length();
+			if (this->SelectionEnd > this->buffer.Length())
 			{
-				this->SelectionEnd = this->Text.size();
+				this->SelectionEnd = this->buffer.Length();
 			}
 			if ((GetAsyncKeyState(VK_SHIFT) & 0x8000) == false)
 			{
@@ -1255,9 +1360,9 @@ bool RichTextBox::ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int
 			{
 				this->SelectionStart = this->SelectionEnd;
 			}
-			if (this->SelectionEnd > this->Text.size())
+			if (this->SelectionEnd > this->buffer.Length())
 			{
-				this->SelectionEnd = this->Text.size();
+				this->SelectionEnd = this->buffer.Length();
 			}
 			this->selRangeDirty = true;
 			UpdateScroll(true);
@@ -1274,7 +1379,7 @@ bool RichTextBox::ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int
 		{
 			const wchar_t c[] = { ch,L'\0' };
 			this->InputText(c);
-			UpdateScroll(this->SelectionEnd >= (int)this->buffer.size());
+			UpdateScroll(this->SelectionEnd >= (int)this->buffer.Length());
 		}
 		else if (ch == 13 && this->AllowMultiLine)
 		{
@@ -1285,13 +1390,13 @@ bool RichTextBox::ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int
 		else if (ch == 1)
 		{
 			this->SelectionStart = 0;
-			this->SelectionEnd = (int)this->buffer.size();
+			this->SelectionEnd = (int)this->buffer.Length();
 			UpdateScroll();
 			this->selRangeDirty = true;
 		}
 		else if (ch == 8)
 		{
-			if (this->buffer.size() > 0)
+			if (this->buffer.Length() > 0)
 			{
 				this->InputBack();
 				UpdateScroll();
@@ -1,5 +1,9 @@
 #pragma once
 #include "Control.h"
+#include "Text/PieceTable.h"
+#include "Text/LogLineBuffer.h"
+#include "Text/UndoEngine.h"
+#include <atomic>
 #pragma comment(lib, "Imm32.lib")
 
 /**
@@ -7,29 +11,25 @@
  * @brief RichTextBox：富文本/大文本输入控件（支持虚拟化渲染）。
  *
  * 设计要点：
- * - 内部维护 buffer，与 Control::Text 在需要时同步
+ * - 内部以 PieceTable 维护 buffer，编辑为 O(log n)；Control::Text 仅在读取时按需同步
  * - 支持多行、选择区间、滚动条与光标命中测试
  * - 可启用虚拟化：按块（BlockCharCount）构建多个 DWrite TextLayout，以降低超长文本开销
+ * - 虚拟化模式下编辑只失效受影响的块，其余块的 TextLayout 与高度保持缓存
+ * - OnTextChanged 的旧/新文本参数需要完整拷贝，仅在有订阅者时才生成
+ * - 撤销历史由 UndoEngine 管理：连续键入合并为一步，按字节预算（SetUndoBudget）淘汰最旧记录
+ * - 日志模式（SetLogMode）：AppendLine 可跨线程调用，按帧合并追加并按上限淘汰最旧行
  */
 class RichTextBox : public Control
 {
 private:
-	std::wstring buffer;
-	bool bufferSyncedFromControl = false;
+	PieceTable buffer;
+	// Control::_text 落后于 buffer（读取 Text 时再同步）
+	bool textStale = false;
 	::Font* _lastLayoutFont = NULL;
-	struct UndoRecord
-	{
-		int pos = 0;
-		std::wstring removedText;
-		std::wstring insertedText;
-		int selStartBefore = 0;
-		int selEndBefore = 0;
-		int selStartAfter = 0;
-		int selEndAfter = 0;
-	};
-	std::vector<UndoRecord> undoStack;
-	std::vector<UndoRecord> redoStack;
-	bool isApplyingUndoRedo = false;
+	UndoEngine undoHistory;
+
+	LogLineBuffer logLines;
+	std::atomic<bool> logMode{ false };
 
 	POINT selectedPos = { 0,0 };
 	bool isDraggingScroll = false;
@@ -49,12 +49,17 @@ private:
 	std::vector<TextBlock> blocks;
 	std::vector<float> blockTops; 	bool blocksDirty = true;
 	bool blockMetricsDirty = true;
+	bool blockTopsDirty = false;
+	// blockTopsDirty 时第一个需要重算 top 的块（之前的块未被编辑，top 不变）
+	int blockTopsDirtyFrom = 0;
 	bool virtualMode = false;
 	bool layoutWidthHasScrollBar = false;
 	float virtualTotalHeight = 0.0f;
 	float cachedRenderWidth = 0.0f;
 public:
 	virtual UIClass Type();
+	GET(std::wstring, Text) override;
+	SET(std::wstring, Text) override;
 	CursorKind QueryCursor(int xof, int yof) override;
 	bool GetAnimatedInvalidRect(D2D1_RECT_F& outRect) override;
 	/** @brief 当前文本测量尺寸缓存（供渲染/布局使用）。 */
@@ -99,13 +104,18 @@ private:
 	D2D1_RECT_F _caretRectCache = { 0,0,0,0 };
 	bool _caretRectCacheValid = false;
 private:
-	void SyncBufferFromControlIfNeeded();
+	std::wstring SnapshotTextForEvent();
 	void SyncControlTextFromBuffer(const std::wstring& oldText);
-	void TrimToMaxLength();
+	bool TrimToMaxLength();
+	void OnBufferEdited(size_t pos, size_t removedLen, size_t insertedLen);
+	int FindBlockIndex(size_t pos) const;
+	void AppendBlocks(size_t start, size_t len, std::vector<TextBlock>& out) const;
 	void RebuildBlocks();
 	void ReleaseBlocks();
 	void EnsureBlockLayout(int idx, float renderWidth, float renderHeight);
 	void EnsureAllBlockMetrics(float renderWidth, float renderHeight);
+	void UpdateBlockTops(float renderHeight);
+	int FindBlockAtY(float contentY) const;
 	int HitTestGlobalIndex(float x, float y);
 	bool GetCaretMetrics(int caretIndex, float& outX, float& outY, float& outH);
 	void DrawScroll();
@@ -114,17 +124,41 @@ private:
 	void InputText(std::wstring input);
 	void InputBack();
 	void InputDelete();
-	void ApplyUndoRecord(const UndoRecord& rec, bool isUndo);
+	void ApplyUndoChange(const UndoEngine::Change& change);
 	void Undo();
 	void Redo();
 	void UpdateScroll(bool arrival = false);
 	void UpdateLayout();
 	void UpdateSelRange();
+	bool ApplyLogBatch();
 public:
 	/** @brief 追加文本（不自动换行）。 */
 	void AppendText(std::wstring str);
-	/** @brief 追加一行文本（通常会追加换行）。 */
+	/**
+	 * @brief 追加一行文本（通常会追加换行）。
+	 *
+	 * 日志模式下可从任意线程调用：行先进入队列，生产线程只向窗口投递重绘（InvalidateRect），
+	 * 在 UI 线程的下一帧绘制前合并写入。
+	 */
 	void AppendLine(std::wstring str);
+	/**
+	 * @brief 启用/关闭日志模式。
+	 *
+	 * 日志模式下追加不进入撤销栈，超过上限时从头部整行淘汰，内存随上限而非运行时长增长。
+	 * @param enable 是否启用。
+	 * @param maxLines 最多保留的行数（0 表示不限制）。
+	 * @param maxChars 最多保留的字符数（0 表示不限制）。
+	 */
+	void SetLogMode(bool enable, size_t maxLines = 10000, size_t maxChars = 0);
+	bool IsLogMode() const { return this->logMode.load(std::memory_order_acquire); }
+	/** @brief 立即把日志队列写入文本并请求重绘（UI 线程调用；Update 会自动合并写入）。 */
+	void FlushLog();
+	/** @brief 日志模式统计（投递/丢弃/淘汰行数）。 */
+	LogLineBuffer::Stats GetLogStats() const { return this->logLines.GetStats(); }
+	/** @brief 设置撤销历史的内存预算（字节，0 表示不限制）。 */
+	void SetUndoBudget(size_t bytes) { this->undoHistory.SetBudget(bytes); }
+	/** @brief 清空撤销/重做历史。 */
+	void ClearUndoHistory() { this->undoHistory.Clear(); }
 	/** @brief 获取当前选择文本。 */
 	std::wstring GetSelectedString();
 	void Update() override;
@@ -0,0 +1,394 @@
+#pragma once
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @file SpatialIndex.h
+ * @brief SpatialIndex：容器子控件的均匀网格空间索引（命中测试与重绘裁剪使用，不依赖 Win32）。
+ *
+ * 每个容器的子项列表（Control 的 Children、Form 的顶层 Controls，均为 SpatialList）持有一个索引，
+ * 记录子项在容器坐标系中的矩形（由 Policy 提供，控件为 Location + ActualSize）。
+ * 子项较少时直接线性扫描；达到 MinItems 后首次查询时建立网格，之后：
+ * - 子项位置/尺寸变化：Control::NotifyBoundsChanged 经 SpatialList::UpdateBounds 增量更新所在网格
+ * - 增删、交换、重排子项：SpatialList 的修改函数标记失效，下次查询时重建
+ *
+ * 查询结果按子项在列表中的顺序（即绘制顺序）返回，并按当前几何做精确判定，
+ * 与逐个判断矩形的结果一致。
+ * 展开时 ActualSize 变大的下拉类控件（ComboBox/DateTimePicker/Menu）不通知索引，
+ * 它们展开期间由 Form 的 ForegroundControl/MainMenu 路径单独命中与绘制。
+ */
+
+/** @brief 子项矩形（像素，容器坐标系）。 */
+struct SpatialRect
+{
+	int Left = 0;
+	int Top = 0;
+	int Right = 0;
+	int Bottom = 0;
+
+	/** @brief 包含点（含右/下边界，与 HitTestDeepestChild 原有判定一致）。 */
+	bool Contains(int x, int y) const
+	{
+		return x >= Left && y >= Top && x <= Right && y <= Bottom;
+	}
+	/** @brief 向外扩展 inflatePx 后与 r 的交集非空（与 Form::RectIntersects 一致）。 */
+	bool Intersects(const SpatialRect& r, int inflatePx) const
+	{
+		int l = Left - inflatePx, t = Top - inflatePx, rt = Right + inflatePx, b = Bottom + inflatePx;
+		return l < r.Right && r.Left < rt && t < r.Bottom && r.Top < b && l < rt && t < b;
+	}
+};
+
+/** @brief 查询点（像素，容器坐标系）。 */
+struct SpatialPoint
+{
+	int X = 0;
+	int Y = 0;
+};
+
+/**
+ * @brief 均匀网格空间索引。
+ *
+ * Policy 提供 static SpatialRect Bounds(Item*)：子项当前矩形。
+ * 索引不观察子项列表本身，列表的任何修改都必须调用 Invalidate（SpatialList 负责）；
+ * 查询时子项数量与建立时不同也会重建，作为遗漏 Invalidate 时的兜底。
+ */
+template<class Item, class Policy>
+class SpatialIndex
+{
+public:
+	/** @brief 子项数量不少于该值时才建立网格。 */
+	static const int MinItems = 32;
+	/** @brief 覆盖超过该网格数的大子项不进网格，每次查询都参与判定。 */
+	static const int MaxCellsPerEntry = 64;
+
+	/** @brief 标记索引失效（子项列表变化），下次查询时重建。 */
+	void Invalidate() { _dirty = true; }
+	/** @brief 是否已建立网格且有效（子项少于 MinItems 时为 false）。 */
+	bool IsBuilt() const { return _built && !_dirty; }
+
+	/** @brief 子项几何变化后增量更新；索引未建立或失效时忽略。 */
+	void Update(Item* item)
+	{
+		if (!_built || _dirty || !item) return;
+		// 不在索引中的子项（如未加入 Form.Controls 的无父控件）不影响查询
+		auto it = _lookup.find(item);
+		if (it == _lookup.end()) return;
+		Remove(it->second);
+		Insert(it->second);
+	}
+
+	/**
+	 * @brief 查询包含点 p 的子项。
+	 * @param items 容器的子项列表。
+	 * @param out 输出，按列表顺序（先绘制者在前）。
+	 */
+	void QueryPoint(const std::vector<Item*>& items, SpatialPoint p, std::vector<Item*>& out)
+	{
+		out.clear();
+		if (!EnsureBuilt(items))
+		{
+			for (auto item : items)
+			{
+				if (item && Policy::Bounds(item).Contains(p.X, p.Y))
+					out.push_back(item);
+			}
+			return;
+		}
+		int cx = CellOf(p.X);
+		int cy = CellOf(p.Y);
+		Collect(cx, cy, cx, cy, _hits);
+		for (int index : _hits)
+		{
+			Item* item = _entries[(size_t)index].Ptr;
+			if (Policy::Bounds(item).Contains(p.X, p.Y))
+				out.push_back(item);
+		}
+	}
+	/**
+	 * @brief 查询与矩形 r 相交的子项。
+	 * @param inflatePx 子项矩形向外扩展的像素（与 Form::ToRECT 的 inflate 一致）。
+	 */
+	void QueryRect(const std::vector<Item*>& items, const SpatialRect& r, int inflatePx, std::vector<Item*>& out)
+	{
+		out.clear();
+		if (!EnsureBuilt(items))
+		{
+			for (auto item : items)
+			{
+				if (item && Policy::Bounds(item).Intersects(r, inflatePx))
+					out.push_back(item);
+			}
+			return;
+		}
+		Collect(CellOf(r.Left - inflatePx), CellOf(r.Top - inflatePx),
+			CellOf(r.Right + inflatePx), CellOf(r.Bottom + inflatePx), _hits);
+		for (int index : _hits)
+		{
+			Item* item = _entries[(size_t)index].Ptr;
+			if (Policy::Bounds(item).Intersects(r, inflatePx))
+				out.push_back(item);
+		}
+	}
+
+private:
+	struct Entry
+	{
+		Item* Ptr = nullptr;
+		SpatialRect Bounds;
+		// 覆盖的网格范围；Big=true 时不进网格而放在 _big 中
+		int X0 = 0, Y0 = 0, X1 = -1, Y1 = -1;
+		bool Big = false;
+	};
+
+	bool _dirty = true;
+	bool _built = false;
+	size_t _builtCount = 0;
+	int _cellSize = 64;
+	std::vector<Entry> _entries;
+	std::unordered_map<Item*, int> _lookup;
+	std::unordered_map<unsigned long long, std::vector<int>> _cells;
+	std::vector<int> _big;
+	std::vector<int> _hits;
+	// 查询去重：同一子项可能跨多个网格
+	std::vector<unsigned> _stamp;
+	unsigned _queryStamp = 0;
+
+	static unsigned long long CellKey(int x, int y) { return ((unsigned long long)(unsigned int)x << 32) | (unsigned int)y; }
+	int CellOf(int v) const
+	{
+		return v >= 0 ? v / _cellSize : -(int)((-(long long)v + _cellSize - 1) / _cellSize);
+	}
+
+	void Reset()
+	{
+		_entries.clear();
+		_lookup.clear();
+		_cells.clear();
+		_big.clear();
+	}
+
+	bool EnsureBuilt(const std::vector<Item*>& items)
+	{
+		if ((int)items.size() < MinItems)
+		{
+			if (_built)
+			{
+				Reset();
+				_built = false;
+			}
+			_dirty = true;
+			return false;
+		}
+		if (_dirty || !_built || items.size() != _builtCount)
+			Rebuild(items);
+		return true;
+	}
+
+	void Rebuild(const std::vector<Item*>& items)
+	{
+		Reset();
+
+		// 网格边长取子项平均边长的两倍：多数子项只落在 1~4 个网格中
+		double sum = 0.0;
+		int counted = 0;
+		for (auto item : items)
+		{
+			if (!item) continue;
+			SpatialRect b = Policy::Bounds(item);
+			sum += (double)(std::max)(b.Right - b.Left, b.Bottom - b.Top);
+			counted++;
+		}
+		int cell = counted > 0 ? (int)(sum / counted * 2.0) : 64;
+		_cellSize = (std::min)((std::max)(cell, 16), 1024);
+
+		_entries.reserve(items.size());
+		for (size_t i = 0; i < items.size(); i++)
+		{
+			if (!items[i]) continue;
+			Entry e;
+			e.Ptr = items[i];
+			_lookup[e.Ptr] = (int)_entries.size();
+			_entries.push_back(e);
+			Insert((int)_entries.size() - 1);
+		}
+		_stamp.assign(_entries.size(), 0);
+		_queryStamp = 0;
+		_builtCount = items.size();
+		_built = true;
+		_dirty = false;
+	}
+
+	void Insert(int entryIndex)
+	{
+		Entry& e = _entries[(size_t)entryIndex];
+		e.Bounds = Policy::Bounds(e.Ptr);
+		e.X0 = CellOf(e.Bounds.Left);
+		e.Y0 = CellOf(e.Bounds.Top);
+		e.X1 = CellOf((std::max)(e.Bounds.Left, e.Bounds.Right));
+		e.Y1 = CellOf((std::max)(e.Bounds.Top, e.Bounds.Bottom));
+		long long cells = (long long)(e.X1 - e.X0 + 1) * (long long)(e.Y1 - e.Y0 + 1);
+		e.Big = cells > MaxCellsPerEntry;
+		if (e.Big)
+		{
+			_big.push_back(entryIndex);
+			return;
+		}
+		for (int y = e.Y0; y <= e.Y1; y++)
+			for (int x = e.X0; x <= e.X1; x++)
+				_cells[CellKey(x, y)].push_back(entryIndex);
+	}
+
+	void Remove(int entryIndex)
+	{
+		const Entry& e = _entries[(size_t)entryIndex];
+		auto erase = [entryIndex](std::vector<int>& v)
+			{
+				auto it = std::find(v.begin(), v.end(), entryIndex);
+				if (it == v.end()) return;
+				*it = v.back();
+				v.pop_back();
+			};
+		if (e.Big)
+		{
+			erase(_big);
+			return;
+		}
+		for (int y = e.Y0; y <= e.Y1; y++)
+		{
+			for (int x = e.X0; x <= e.X1; x++)
+			{
+				auto it = _cells.find(CellKey(x, y));
+				if (it == _cells.end()) continue;
+				erase(it->second);
+				if (it->second.empty())
+					_cells.erase(it);
+			}
+		}
+	}
+
+	void Collect(int x0, int y0, int x1, int y1, std::vector<int>& hits)
+	{
+		hits.clear();
+		if (++_queryStamp == 0)
+		{
+			std::fill(_stamp.begin(), _stamp.end(), 0u);
+			_queryStamp = 1;
+		}
+		auto add = [&](int index)
+			{
+				if (_stamp[(size_t)index] == _queryStamp) return;
+				_stamp[(size_t)index] = _queryStamp;
+				hits.push_back(index);
+			};
+
+		long long cells = (long long)(x1 - x0 + 1) * (long long)(y1 - y0 + 1);
+		if (cells > (long long)_cells.size())
+		{
+			// 查询范围比已占用的网格还多：直接遍历已占用的网格
+			for (auto& kv : _cells)
+			{
+				int cx = (int)(unsigned int)(kv.first >> 32);
+				int cy = (int)(unsigned int)(kv.first & 0xFFFFFFFFull);
+				if (cx < x0 || cx > x1 || cy < y0 || cy > y1) continue;
+				for (int index : kv.second) add(index);
+			}
+		}
+		else
+		{
+			for (int y = y0; y <= y1; y++)
+			{
+				for (int x = x0; x <= x1; x++)
+				{
+					auto it = _cells.find(CellKey(x, y));
+					if (it == _cells.end()) continue;
+					for (int index : it->second) add(index);
+				}
+			}
+		}
+		for (int index : _big) add(index);
+		// 条目按列表顺序建立，索引即绘制顺序
+		std::sort(hits.begin(), hits.end());
+	}
+};
+
+/**
+ * @brief 持有空间索引的子项列表。
+ *
+ * Base 为列表类型（控件使用 List<Control*>，需派生自 std::vector<Item*>）。
+ * 这里覆盖 Base 的全部修改函数（Add/AddRange/Insert/RemoveAt/Remove/Swap/Reverse/Clear/set），
+ * 修改后立即使索引失效，交换、反转等不改变数量的重排也不会让查询返回过期的绘制顺序。
+ * 通过 operator[]、迭代器或 std::vector 的成员直接改写元素时，需自行调用 InvalidateIndex。
+ */
+template<class Item, class Policy, class Base>
+class SpatialList : public Base
+{
+public:
+	using Base::Base;
+
+	void Add(Item* value)
+	{
+		Base::Add(value);
+		_index.Invalidate();
+	}
+	template<class... Args>
+	void AddRange(Args&&... args)
+	{
+		Base::AddRange(std::forward<Args>(args)...);
+		_index.Invalidate();
+	}
+	template<class Value>
+	void Insert(int index, Value&& value)
+	{
+		Base::Insert(index, std::forward<Value>(value));
+		_index.Invalidate();
+	}
+	template<class... Args>
+	void RemoveAt(int index, Args... num)
+	{
+		Base::RemoveAt(index, num...);
+		_index.Invalidate();
+	}
+	int Remove(Item* value)
+	{
+		int n = Base::Remove(value);
+		_index.Invalidate();
+		return n;
+	}
+	void Swap(int from, int to)
+	{
+		Base::Swap(from, to);
+		_index.Invalidate();
+	}
+	void Reverse()
+	{
+		Base::Reverse();
+		_index.Invalidate();
+	}
+	void Clear()
+	{
+		Base::Clear();
+		_index.Invalidate();
+	}
+	void set(int i, Item* value)
+	{
+		Base::set(i, value);
+		_index.Invalidate();
+	}
+
+	/** @brief 查询包含点的子项（含右/下边界），按绘制顺序输出。 */
+	void QueryPoint(SpatialPoint p, std::vector<Item*>& out) { _index.QueryPoint(*this, p, out); }
+	/** @brief 查询与矩形相交的子项，按绘制顺序输出。 */
+	void QueryRect(const SpatialRect& r, int inflatePx, std::vector<Item*>& out) { _index.QueryRect(*this, r, inflatePx, out); }
+	/** @brief 子项位置/尺寸变化后调用，增量更新索引。 */
+	void UpdateBounds(Item* item) { _index.Update(item); }
+	/** @brief 直接改写元素或全部子项几何一起变化（如 DPI 缩放）后调用，下次查询时重建。 */
+	void InvalidateIndex() { _index.Invalidate(); }
+	/** @brief 索引当前是否已建立且有效。 */
+	bool IsIndexBuilt() const { return _index.IsBuilt(); }
+
+private:
+	SpatialIndex<Item, Policy> _index;
+};
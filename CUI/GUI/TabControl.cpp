@@ -67,7 +67,7 @@ GET_CPP(TabControl, int, PageCount)
 {
 	return this->Count;
 }
-GET_CPP(TabControl, List<Control*>&, Pages)
+GET_CPP(TabControl, ControlCollection&, Pages)
 {
 	return this->Children;
 }
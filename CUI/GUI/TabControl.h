@@ -41,8 +41,8 @@ public:
 	float Boder = 1.5f;
 	READONLY_PROPERTY(int, PageCount);
 	GET(int, PageCount);
-	READONLY_PROPERTY(List<Control*>&, Pages);
-	GET(List<Control*>&, Pages);
+	READONLY_PROPERTY(ControlCollection&, Pages);
+	GET(ControlCollection&, Pages);
 	/**
 	 * @brief 创建 TabControl。
 	 */
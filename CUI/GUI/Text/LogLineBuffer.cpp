@@ -0,0 +1,126 @@
+#include "LogLineBuffer.h"
+#include <algorithm>
+
+bool LogLineBuffer::OverLimit(size_t lines, size_t chars, size_t maxLines, size_t maxChars)
+{
+	if (maxLines > 0 && lines > maxLines) return true;
+	// 字符上限至少保留一行，避免超长单行被无限淘汰
+	if (maxChars > 0 && chars > maxChars && lines > 1) return true;
+	return false;
+}
+
+void LogLineBuffer::SetLimits(size_t maxLines, size_t maxChars)
+{
+	_maxLines.store(maxLines, std::memory_order_relaxed);
+	_maxChars.store(maxChars, std::memory_order_relaxed);
+}
+
+void LogLineBuffer::TrimPendingLocked()
+{
+	// UI 线程来不及消费（窗口最小化/被遮挡）时，积压的旧行反正会被淘汰，直接丢弃
+	const size_t maxLines = MaxLines();
+	const size_t maxChars = MaxChars();
+	while (OverLimit(_pending.size(), _pendingChars, maxLines, maxChars))
+	{
+		_pendingChars -= _pending.front().size() + 1;
+		_pending.pop_front();
+		_stats.DroppedLines++;
+		_pendingTrimmed = true;
+	}
+}
+
+bool LogLineBuffer::Post(std::wstring line)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	const bool first = _pending.empty();
+	_pendingChars += line.size() + 1;
+	_pending.push_back(std::move(line));
+	_stats.PostedLines++;
+	TrimPendingLocked();
+	_hasPending.store(true, std::memory_order_release);
+	return first;
+}
+
+bool LogLineBuffer::TakeBatch(Batch& out)
+{
+	out.Text.clear();
+	out.EvictChars = 0;
+	out.Lines = 0;
+
+	std::deque<std::wstring> lines;
+	bool trimmed = false;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		lines.swap(_pending);
+		_pendingChars = 0;
+		trimmed = _pendingTrimmed;
+		_pendingTrimmed = false;
+		_hasPending.store(false, std::memory_order_release);
+		if (!lines.empty()) _stats.Batches++;
+	}
+	if (lines.empty()) return false;
+
+	const size_t existingLines = _lineLens.size();
+	const size_t existingChars = _chars;
+	for (const auto& line : lines)
+	{
+		_lineLens.push_back(line.size() + 1);
+		_chars += line.size() + 1;
+	}
+
+	const size_t maxLines = MaxLines();
+	const size_t maxChars = MaxChars();
+	size_t evictLines = 0;
+	size_t evictChars = 0;
+	// 积压中丢弃的行比已显示的行都新：已显示的行须一并淘汰，否则尾部会缺一段
+	while (trimmed && evictLines < existingLines)
+	{
+		evictChars += _lineLens.front();
+		_chars -= _lineLens.front();
+		_lineLens.pop_front();
+		evictLines++;
+	}
+	while (OverLimit(_lineLens.size(), _chars, maxLines, maxChars))
+	{
+		evictChars += _lineLens.front();
+		_chars -= _lineLens.front();
+		_lineLens.pop_front();
+		evictLines++;
+	}
+
+	// 同一批内就被淘汰的新行不必写入控件，头部只需删除原有内容
+	const size_t skipNew = evictLines > existingLines ? evictLines - existingLines : 0;
+	out.EvictChars = skipNew > 0 ? existingChars : evictChars;
+
+	size_t textLen = 0;
+	for (size_t i = skipNew; i < lines.size(); i++) textLen += lines[i].size() + 1;
+	out.Text.reserve(textLen);
+	for (size_t i = skipNew; i < lines.size(); i++)
+	{
+		out.Text.append(lines[i]);
+		out.Text.push_back(LineSeparator);
+	}
+	out.Lines = lines.size() - skipNew;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_stats.EvictedLines += (std::min)(evictLines, existingLines);
+	_stats.DroppedLines += skipNew;
+	return true;
+}
+
+void LogLineBuffer::Reset(size_t existingChars)
+{
+	_lineLens.clear();
+	_chars = 0;
+	if (existingChars > 0)
+	{
+		_lineLens.push_back(existingChars);
+		_chars = existingChars;
+	}
+}
+
+LogLineBuffer::Stats LogLineBuffer::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _stats;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+/**
+ * @file LogLineBuffer.h
+ * @brief LogLineBuffer：日志尾随显示的行缓冲与淘汰核心（不依赖 Windows）。
+ *
+ * 生产者（任意线程）通过 Post 投递整行；UI 线程每帧调用一次 TakeBatch，
+ * 把期间积累的行合并为一次追加，并按行数/字符数上限算出需要从头部淘汰的字符数。
+ * 这里只记录每行长度，不持有已提交的文本本身（文本由控件的存储负责），
+ * 因此内存只与上限成正比。
+ */
+class LogLineBuffer
+{
+public:
+	/** @brief 行尾分隔符（与 RichTextBox::AppendLine 一致）。 */
+	static constexpr wchar_t LineSeparator = L'\r';
+
+	/** @brief 一帧合并后的结果。 */
+	struct Batch
+	{
+		/** @brief 需要追加到末尾的文本（已含分隔符）。 */
+		std::wstring Text;
+		/** @brief 需要先从头部删除的字符数。 */
+		size_t EvictChars = 0;
+		/** @brief Text 中包含的行数。 */
+		size_t Lines = 0;
+	};
+
+	/** @brief 累计统计（用于诊断与吞吐测量）。 */
+	struct Stats
+	{
+		uint64_t PostedLines = 0;
+		/** @brief 尚未显示就因积压超过上限而被丢弃的行。 */
+		uint64_t DroppedLines = 0;
+		/** @brief 已显示后被淘汰的行。 */
+		uint64_t EvictedLines = 0;
+		uint64_t Batches = 0;
+	};
+
+	/**
+	 * @brief 设置上限（0 表示不限制）。
+	 * @param maxLines 最多保留的行数。
+	 * @param maxChars 最多保留的字符数（至少保留最新一行）。
+	 */
+	void SetLimits(size_t maxLines, size_t maxChars);
+	size_t MaxLines() const { return _maxLines.load(std::memory_order_relaxed); }
+	size_t MaxChars() const { return _maxChars.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief 投递一行（线程安全）。
+	 * @return true 表示这是本批的第一行，调用方应安排一次刷新。
+	 */
+	bool Post(std::wstring line);
+	/** @brief 是否有待处理的行（线程安全，无锁）。 */
+	bool HasPending() const { return _hasPending.load(std::memory_order_acquire); }
+
+	/**
+	 * @brief 取出待处理的行并合并为一次追加（应在 UI 线程调用）。
+	 * @return false 表示没有待处理的行。
+	 */
+	bool TakeBatch(Batch& out);
+
+	/**
+	 * @brief 重置已提交内容的记账。
+	 * @param existingChars 当前已存在的文本长度（作为一个整体参与淘汰）。
+	 */
+	void Reset(size_t existingChars = 0);
+	/** @brief 已提交（显示中）的行数与字符数。 */
+	size_t LineCount() const { return _lineLens.size(); }
+	size_t CharCount() const { return _chars; }
+
+	Stats GetStats() const;
+
+private:
+	mutable std::mutex _mutex;
+	std::deque<std::wstring> _pending;
+	size_t _pendingChars = 0;
+	// 本批投递期间是否因积压丢弃过行
+	bool _pendingTrimmed = false;
+	std::atomic<bool> _hasPending{ false };
+	std::atomic<size_t> _maxLines{ 0 };
+	std::atomic<size_t> _maxChars{ 0 };
+
+	// 以下仅由 UI 线程访问
+	std::deque<size_t> _lineLens;
+	size_t _chars = 0;
+
+	Stats _stats;
+
+	void TrimPendingLocked();
+	static bool OverLimit(size_t lines, size_t chars, size_t maxLines, size_t maxChars);
+};
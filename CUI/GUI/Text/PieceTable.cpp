@@ -0,0 +1,298 @@
+#include "PieceTable.h"
+#include <algorithm>
+
+namespace
+{
+	// 废弃字符至少达到该值才考虑整理，避免小文本频繁重建
+	constexpr size_t CompactMinStorage = 64 * 1024;
+	// 片段平均长度低于该值时整理（逐字符随机编辑会产生大量碎片）
+	constexpr size_t CompactMinAvgPiece = 8;
+	constexpr size_t CompactMinPieces = 1024;
+}
+
+PieceTable::PieceTable()
+{
+}
+
+PieceTable::PieceTable(const std::wstring& text)
+{
+	Assign(text);
+}
+
+size_t PieceTable::Length() const
+{
+	return Total(_root);
+}
+
+void PieceTable::Assign(const std::wstring& text)
+{
+	_original = text;
+	_added.clear();
+	if (_added.capacity() > CompactMinStorage)
+		_added.shrink_to_fit();
+	_nodes.clear();
+	_free.clear();
+	_root = -1;
+	_liveNodes = 0;
+	if (!_original.empty())
+		_root = NewNode(0, 0, _original.size());
+}
+
+void PieceTable::Clear()
+{
+	Assign(std::wstring());
+}
+
+uint32_t PieceTable::NextPriority()
+{
+	// xorshift32：只用于 Treap 平衡，无需高质量随机数
+	uint32_t x = _seed;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	_seed = x;
+	return x;
+}
+
+int32_t PieceTable::NewNode(uint8_t source, size_t start, size_t len)
+{
+	int32_t idx;
+	if (!_free.empty())
+	{
+		idx = _free.back();
+		_free.pop_back();
+		_nodes[(size_t)idx] = Node();
+	}
+	else
+	{
+		idx = (int32_t)_nodes.size();
+		_nodes.emplace_back();
+	}
+	Node& n = _nodes[(size_t)idx];
+	n.priority = NextPriority();
+	n.source = source;
+	n.start = start;
+	n.len = len;
+	n.total = len;
+	_liveNodes++;
+	return idx;
+}
+
+void PieceTable::FreeTree(int32_t t)
+{
+	if (t < 0) return;
+	FreeTree(_nodes[(size_t)t].left);
+	FreeTree(_nodes[(size_t)t].right);
+	_free.push_back(t);
+	_liveNodes--;
+}
+
+void PieceTable::Pull(int32_t t)
+{
+	Node& n = _nodes[(size_t)t];
+	n.total = Total(n.left) + n.len + Total(n.right);
+}
+
+const wchar_t* PieceTable::PieceData(const Node& n) const
+{
+	return (n.source == 0 ? _original.data() : _added.data()) + n.start;
+}
+
+void PieceTable::Split(int32_t t, size_t k, int32_t& l, int32_t& r)
+{
+	if (t < 0)
+	{
+		l = r = -1;
+		return;
+	}
+	const size_t leftTotal = Total(_nodes[(size_t)t].left);
+	const size_t pieceLen = _nodes[(size_t)t].len;
+	if (k <= leftTotal)
+	{
+		int32_t a, b;
+		Split(_nodes[(size_t)t].left, k, a, b);
+		_nodes[(size_t)t].left = b;
+		Pull(t);
+		l = a;
+		r = t;
+	}
+	else if (k >= leftTotal + pieceLen)
+	{
+		int32_t a, b;
+		Split(_nodes[(size_t)t].right, k - leftTotal - pieceLen, a, b);
+		_nodes[(size_t)t].right = a;
+		Pull(t);
+		l = t;
+		r = b;
+	}
+	else
+	{
+		// 切点落在片段内部：拆成两个片段，右半部分成为右子树的最左节点
+		const size_t off = k - leftTotal;
+		const Node src = _nodes[(size_t)t];
+		int32_t m = NewNode(src.source, src.start + off, src.len - off);
+		Node& n = _nodes[(size_t)t];
+		n.len = off;
+		int32_t rightSub = n.right;
+		n.right = -1;
+		Pull(t);
+		l = t;
+		r = Merge(m, rightSub);
+	}
+}
+
+int32_t PieceTable::Merge(int32_t l, int32_t r)
+{
+	if (l < 0) return r;
+	if (r < 0) return l;
+	if (_nodes[(size_t)l].priority > _nodes[(size_t)r].priority)
+	{
+		int32_t merged = Merge(_nodes[(size_t)l].right, r);
+		_nodes[(size_t)l].right = merged;
+		Pull(l);
+		return l;
+	}
+	int32_t merged = Merge(l, _nodes[(size_t)r].left);
+	_nodes[(size_t)r].left = merged;
+	Pull(r);
+	return r;
+}
+
+bool PieceTable::TryExtendRightmost(int32_t t, size_t addedStart, size_t len)
+{
+	if (t < 0) return false;
+	const int32_t right = _nodes[(size_t)t].right;
+	if (right >= 0)
+	{
+		if (!TryExtendRightmost(right, addedStart, len))
+			return false;
+		_nodes[(size_t)t].total += len;
+		return true;
+	}
+	Node& n = _nodes[(size_t)t];
+	if (n.source != 1 || n.start + n.len != addedStart)
+		return false;
+	n.len += len;
+	n.total += len;
+	return true;
+}
+
+void PieceTable::Insert(size_t pos, const wchar_t* text, size_t len)
+{
+	if (!text || len == 0) return;
+	pos = (std::min)(pos, Length());
+
+	const size_t addedStart = _added.size();
+	_added.append(text, len);
+
+	int32_t l, r;
+	Split(_root, pos, l, r);
+	// 连续键入：上一片段恰好以追加缓冲区末尾结束时直接延长
+	if (!TryExtendRightmost(l, addedStart, len))
+		l = Merge(l, NewNode(1, addedStart, len));
+	_root = Merge(l, r);
+	MaybeCompact();
+}
+
+void PieceTable::Erase(size_t pos, size_t len)
+{
+	const size_t total = Length();
+	if (pos >= total || len == 0) return;
+	len = (std::min)(len, total - pos);
+
+	int32_t a, b, c, d;
+	Split(_root, pos, a, b);
+	Split(b, len, c, d);
+	FreeTree(c);
+	_root = Merge(a, d);
+	MaybeCompact();
+}
+
+wchar_t PieceTable::CharAt(size_t pos) const
+{
+	int32_t t = _root;
+	while (t >= 0)
+	{
+		const Node& n = _nodes[(size_t)t];
+		const size_t lt = Total(n.left);
+		if (pos < lt)
+		{
+			t = n.left;
+		}
+		else if (pos < lt + n.len)
+		{
+			return PieceData(n)[pos - lt];
+		}
+		else
+		{
+			pos -= lt + n.len;
+			t = n.right;
+		}
+	}
+	return 0;
+}
+
+void PieceTable::CopyRange(int32_t t, size_t pos, size_t len, std::wstring& out) const
+{
+	if (t < 0 || len == 0) return;
+	const Node& n = _nodes[(size_t)t];
+	const size_t lt = Total(n.left);
+	if (pos < lt)
+	{
+		const size_t take = (std::min)(len, lt - pos);
+		CopyRange(n.left, pos, take, out);
+		len -= take;
+		pos = lt;
+		if (len == 0) return;
+	}
+	const size_t off = pos - lt;
+	if (off < n.len)
+	{
+		const size_t take = (std::min)(len, n.len - off);
+		out.append(PieceData(n) + off, take);
+		len -= take;
+		pos += take;
+		if (len == 0) return;
+	}
+	CopyRange(n.right, pos - lt - n.len, len, out);
+}
+
+void PieceTable::CopyTo(size_t pos, size_t len, std::wstring& out) const
+{
+	const size_t total = Length();
+	if (pos >= total) return;
+	len = (std::min)(len, total - pos);
+	out.reserve(out.size() + len);
+	CopyRange(_root, pos, len, out);
+}
+
+std::wstring PieceTable::Substr(size_t pos, size_t len) const
+{
+	std::wstring out;
+	CopyTo(pos, len, out);
+	return out;
+}
+
+std::wstring PieceTable::ToString() const
+{
+	return Substr(0, Length());
+}
+
+void PieceTable::Compact()
+{
+	std::wstring text = ToString();
+	Assign(text);
+}
+
+void PieceTable::MaybeCompact()
+{
+	const size_t live = Length();
+	const size_t storage = StorageLength();
+	if (storage >= CompactMinStorage && storage - live > live)
+	{
+		Compact();
+		return;
+	}
+	if (_liveNodes >= CompactMinPieces && _liveNodes * CompactMinAvgPiece > live)
+		Compact();
+}
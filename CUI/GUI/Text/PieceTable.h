@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file PieceTable.h
+ * @brief PieceTable：大文本编辑用的分片存储（不依赖 Windows，可独立编译）。
+ *
+ * 设计要点：
+ * - 原始文本与追加文本分别保存在两个只追加的缓冲区中，文本内容由“片段”序列描述
+ * - 片段按文本顺序组织为 Treap（隐式键 = 子树字符数），Insert/Erase/CharAt 均为期望 O(log n)
+ * - 连续在同一位置键入时扩展上一片段，避免逐字符产生新片段
+ * - 追加缓冲区中废弃内容过多时自动整理（Compact），内存与当前文本长度成正比
+ *
+ * 位置与长度均以 wchar_t 为单位（与 RichTextBox 的选区索引一致）。
+ */
+class PieceTable
+{
+public:
+	PieceTable();
+	explicit PieceTable(const std::wstring& text);
+
+	/** @brief 当前文本长度（wchar_t 个数）。 */
+	size_t Length() const;
+	bool Empty() const { return Length() == 0; }
+
+	/** @brief 用 text 替换全部内容（清空两个缓冲区）。 */
+	void Assign(const std::wstring& text);
+	void Clear();
+
+	/** @brief 在 pos 处插入 text（pos 超出末尾时按末尾处理）。 */
+	void Insert(size_t pos, const wchar_t* text, size_t len);
+	void Insert(size_t pos, const std::wstring& text) { Insert(pos, text.data(), text.size()); }
+	/** @brief 末尾追加。 */
+	void Append(const std::wstring& text) { Insert(Length(), text); }
+	/** @brief 删除 [pos, pos+len)，越界部分被裁剪。 */
+	void Erase(size_t pos, size_t len);
+
+	/** @brief 读取单个字符（越界返回 0）。 */
+	wchar_t CharAt(size_t pos) const;
+	wchar_t operator[](size_t pos) const { return CharAt(pos); }
+	/** @brief 读取 [pos, pos+len) 子串，复杂度 O(log n + len)。 */
+	std::wstring Substr(size_t pos, size_t len) const;
+	/** @brief 将 [pos, pos+len) 追加写入 out（不清空 out）。 */
+	void CopyTo(size_t pos, size_t len, std::wstring& out) const;
+	/** @brief 导出全部文本。 */
+	std::wstring ToString() const;
+
+	/** @brief 当前片段数量（用于诊断）。 */
+	size_t PieceCount() const { return _liveNodes; }
+	/** @brief 两个缓冲区占用的字符数（用于诊断/内存统计）。 */
+	size_t StorageLength() const { return _original.size() + _added.size(); }
+
+	/**
+	 * @brief 整理存储：把当前文本写入新的原始缓冲区并重建为单一片段。
+	 *
+	 * 通常无需手动调用，Insert/Erase 在废弃内容超过阈值时会自动触发。
+	 */
+	void Compact();
+
+private:
+	struct Node
+	{
+		int32_t left = -1;
+		int32_t right = -1;
+		uint32_t priority = 0;
+		uint8_t source = 0; // 0 = _original, 1 = _added
+		size_t start = 0;
+		size_t len = 0;
+		size_t total = 0;   // 子树字符数
+	};
+
+	std::wstring _original;
+	std::wstring _added;
+	std::vector<Node> _nodes;
+	std::vector<int32_t> _free;
+	int32_t _root = -1;
+	size_t _liveNodes = 0;
+	uint32_t _seed = 0x9E3779B9u;
+
+	int32_t NewNode(uint8_t source, size_t start, size_t len);
+	void FreeTree(int32_t t);
+	size_t Total(int32_t t) const { return t < 0 ? 0 : _nodes[(size_t)t].total; }
+	void Pull(int32_t t);
+	uint32_t NextPriority();
+	const wchar_t* PieceData(const Node& n) const;
+
+	void Split(int32_t t, size_t k, int32_t& l, int32_t& r);
+	int32_t Merge(int32_t l, int32_t r);
+	bool TryExtendRightmost(int32_t t, size_t addedStart, size_t len);
+	void CopyRange(int32_t t, size_t pos, size_t len, std::wstring& out) const;
+	void MaybeCompact();
+};
@@ -0,0 +1,249 @@
+#include "UndoEngine.h"
+#include <algorithm>
+
+namespace
+{
+	// 字符池至少达到该值且废弃超过一半时才整理
+	constexpr size_t CompactMinPool = 16 * 1024;
+
+	bool IsSpace(wchar_t ch)
+	{
+		return ch == L' ' || ch == L'\t' || ch == 0x3000;
+	}
+	bool HasLineBreak(const std::wstring& s)
+	{
+		return s.find_first_of(L"\r\n") != std::wstring::npos;
+	}
+}
+
+UndoEngine::UndoEngine()
+{
+}
+
+void UndoEngine::SetBudget(size_t bytes)
+{
+	_budget = bytes;
+	EnforceBudget();
+	MaybeCompact();
+}
+
+size_t UndoEngine::MemoryUsage() const
+{
+	return _liveChars * sizeof(wchar_t) + (_undo.size() + _redo.size()) * sizeof(Entry);
+}
+
+size_t UndoEngine::Store(const std::wstring& text, bool reversed)
+{
+	const size_t offset = _pool.size();
+	if (reversed)
+		_pool.append(text.rbegin(), text.rend());
+	else
+		_pool.append(text);
+	_liveChars += text.size();
+	return offset;
+}
+
+std::wstring UndoEngine::Load(const Entry& r) const
+{
+	std::wstring s = _pool.substr(r.textOffset, r.textLen);
+	if (r.reversed)
+		std::reverse(s.begin(), s.end());
+	return s;
+}
+
+UndoEngine::Kind UndoEngine::Classify(size_t pos, size_t removedLen, const std::wstring& inserted, int selStartBefore, int selEndBefore)
+{
+	// 单次按键最多产生一个代理对
+	if (!inserted.empty())
+	{
+		if (inserted.size() <= 2 && !HasLineBreak(inserted))
+			return Kind::Typing;
+		return Kind::Other;
+	}
+	if (removedLen == 0 || removedLen > 2 || selStartBefore != selEndBefore)
+		return Kind::Other;
+	if ((size_t)selEndBefore == pos + removedLen)
+		return Kind::Backspace;
+	if ((size_t)selEndBefore == pos)
+		return Kind::Delete;
+	return Kind::Other;
+}
+
+bool UndoEngine::TryMerge(size_t pos, const std::wstring& removed, const std::wstring& inserted,
+	int selStartBefore, int selEndBefore, int selStartAfter, int selEndAfter,
+	std::chrono::steady_clock::time_point now)
+{
+	if (_sealed || _undo.empty()) return false;
+	if (now - _lastTime > std::chrono::milliseconds(MergeIntervalMs)) return false;
+
+	Entry& last = _undo.back();
+	// 光标在两次编辑之间移动过，视为新的操作
+	if (selStartBefore != selEndBefore || selStartBefore != last.selStartAfter || selEndBefore != last.selEndAfter)
+		return false;
+	const Kind kind = Classify(pos, removed.size(), inserted, selStartBefore, selEndBefore);
+	if (kind == Kind::Other || kind != last.kind) return false;
+
+	const bool atTail = last.textOffset + last.textLen == _pool.size();
+	switch (kind)
+	{
+	case Kind::Typing:
+		if (!removed.empty() || pos != last.pos + last.insertedLen) return false;
+		// 空白之后开始新单词时断开，撤销粒度与常见编辑器一致
+		if (IsSpace(_lastTyped) && !IsSpace(inserted.front())) return false;
+		last.insertedLen += inserted.size();
+		_lastTyped = inserted.back();
+		break;
+	case Kind::Backspace:
+		if (!atTail || !last.reversed || pos + removed.size() != last.pos) return false;
+		Store(removed, true);
+		last.pos = pos;
+		last.removedLen += removed.size();
+		last.textLen += removed.size();
+		break;
+	case Kind::Delete:
+		if (!atTail || last.reversed || pos != last.pos) return false;
+		Store(removed, false);
+		last.removedLen += removed.size();
+		last.textLen += removed.size();
+		break;
+	default:
+		return false;
+	}
+	last.selStartAfter = selStartAfter;
+	last.selEndAfter = selEndAfter;
+	_lastTime = now;
+	return true;
+}
+
+void UndoEngine::Record(size_t pos, const std::wstring& removed, const std::wstring& inserted,
+	int selStartBefore, int selEndBefore, int selStartAfter, int selEndAfter)
+{
+	if (removed.empty() && inserted.empty()) return;
+	const auto now = std::chrono::steady_clock::now();
+	ClearRedo();
+
+	if (!TryMerge(pos, removed, inserted, selStartBefore, selEndBefore, selStartAfter, selEndAfter, now))
+	{
+		Entry r;
+		r.kind = Classify(pos, removed.size(), inserted, selStartBefore, selEndBefore);
+		r.pos = pos;
+		r.removedLen = removed.size();
+		r.insertedLen = inserted.size();
+		r.reversed = r.kind == Kind::Backspace;
+		r.textOffset = Store(removed, r.reversed);
+		r.textLen = removed.size();
+		r.selStartBefore = selStartBefore;
+		r.selEndBefore = selEndBefore;
+		r.selStartAfter = selStartAfter;
+		r.selEndAfter = selEndAfter;
+		_undo.push_back(r);
+		_lastTyped = r.kind == Kind::Typing ? inserted.back() : 0;
+		_lastTime = now;
+		_sealed = false;
+	}
+	EnforceBudget();
+	MaybeCompact();
+}
+
+bool UndoEngine::Undo(const TextReader& read, Change& out)
+{
+	if (_undo.empty()) return false;
+	Entry r = _undo.back();
+	_undo.pop_back();
+
+	out.Pos = r.pos;
+	out.RemoveLen = r.insertedLen;
+	out.InsertText = Load(r);
+	out.SelStart = r.selStartBefore;
+	out.SelEnd = r.selEndBefore;
+	Release(r);
+
+	// 插入的文本此刻仍在文档中，撤销后才需要由历史保存
+	std::wstring inserted = (r.insertedLen > 0 && read) ? read(r.pos, r.insertedLen) : std::wstring();
+	r.insertedLen = inserted.size();
+	r.reversed = false;
+	r.textOffset = Store(inserted, false);
+	r.textLen = inserted.size();
+	_redo.push_back(r);
+
+	_sealed = true;
+	EnforceBudget();
+	MaybeCompact();
+	return true;
+}
+
+bool UndoEngine::Redo(const TextReader& read, Change& out)
+{
+	if (_redo.empty()) return false;
+	Entry r = _redo.back();
+	_redo.pop_back();
+
+	out.Pos = r.pos;
+	out.RemoveLen = r.removedLen;
+	out.InsertText = Load(r);
+	out.SelStart = r.selStartAfter;
+	out.SelEnd = r.selEndAfter;
+	Release(r);
+
+	std::wstring removed = (r.removedLen > 0 && read) ? read(r.pos, r.removedLen) : std::wstring();
+	r.removedLen = removed.size();
+	r.reversed = false;
+	r.textOffset = Store(removed, false);
+	r.textLen = removed.size();
+	_undo.push_back(r);
+
+	_sealed = true;
+	EnforceBudget();
+	MaybeCompact();
+	return true;
+}
+
+void UndoEngine::ClearRedo()
+{
+	for (const auto& r : _redo)
+		Release(r);
+	_redo.clear();
+}
+
+void UndoEngine::Clear()
+{
+	// 历史中可能包含密码等敏感文本，释放前先抹掉
+	std::fill(_pool.begin(), _pool.end(), L'\0');
+	_pool.clear();
+	_pool.shrink_to_fit();
+	_undo.clear();
+	_redo.clear();
+	_liveChars = 0;
+	_sealed = true;
+	_lastTyped = 0;
+}
+
+void UndoEngine::EnforceBudget()
+{
+	if (_budget == 0) return;
+	// 重做栈是刚撤销的内容，只从撤销栈最旧的一端淘汰；至少保留最近一步
+	while (MemoryUsage() > _budget && !_undo.empty() && _undo.size() + _redo.size() > 1)
+	{
+		Release(_undo.front());
+		_undo.pop_front();
+	}
+}
+
+void UndoEngine::MaybeCompact()
+{
+	if (_pool.size() < CompactMinPool || _pool.size() <= _liveChars * 2) return;
+
+	std::wstring pool;
+	pool.reserve(_liveChars);
+	auto move = [&](Entry& r)
+	{
+		const size_t offset = pool.size();
+		pool.append(_pool, r.textOffset, r.textLen);
+		r.textOffset = offset;
+	};
+	// 重做栈在前、撤销栈在后，栈顶记录仍位于池末尾，后续退格/删除可以继续合并
+	for (auto& r : _redo) move(r);
+	for (auto& r : _undo) move(r);
+	std::fill(_pool.begin(), _pool.end(), L'\0');
+	_pool.swap(pool);
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @file UndoEngine.h
+ * @brief UndoEngine：文本控件共用的撤销/重做历史（不依赖 Windows）。
+ *
+ * 设计要点：
+ * - 每条记录只保存“当前不在文档中的那一侧”文本：撤销栈保存被删除的文本，
+ *   重做栈保存被撤销掉的插入文本；另一侧仍在文档里，按 (位置, 长度) 引用，
+ *   撤销/重做时再通过 TextReader 从控件存储中读取
+ * - 文本统一存放在引擎内部的只追加字符池中，记录只持有 (偏移, 长度)；废弃过多时整理
+ * - 连续键入、连续退格、连续向前删除自动合并为一条记录（光标移动、超时、新单词开头时断开）
+ * - 按字节预算淘汰最旧的记录，至少保留最近一步
+ *
+ * 位置与长度均以 wchar_t 为单位。
+ */
+class UndoEngine
+{
+public:
+	/** @brief 默认内存预算（字节）。 */
+	static constexpr size_t DefaultBudgetBytes = 1024 * 1024;
+	/** @brief 两次键入间隔超过该值（毫秒）时不再合并。 */
+	static constexpr int64_t MergeIntervalMs = 1500;
+
+	/** @brief 从控件当前文本读取 [pos, pos+len)。 */
+	using TextReader = std::function<std::wstring(size_t pos, size_t len)>;
+
+	/** @brief 撤销/重做需要对文档执行的修改：删除 [Pos, Pos+RemoveLen) 后在 Pos 插入 InsertText。 */
+	struct Change
+	{
+		size_t Pos = 0;
+		size_t RemoveLen = 0;
+		std::wstring InsertText;
+		/** @brief 修改完成后应恢复的选区。 */
+		int SelStart = 0;
+		int SelEnd = 0;
+	};
+
+	UndoEngine();
+
+	/** @brief 设置内存预算（字节，0 表示不限制）。超出时立即淘汰旧记录。 */
+	void SetBudget(size_t bytes);
+	size_t Budget() const { return _budget; }
+
+	/**
+	 * @brief 记录一次已经完成的编辑，并清空重做栈。
+	 * @param pos 编辑位置。
+	 * @param removed 被删除的文本（编辑前位于 pos）。
+	 * @param inserted 插入的文本（编辑后位于 pos，仅用于判断合并，不会被保存）。
+	 */
+	void Record(size_t pos, const std::wstring& removed, const std::wstring& inserted,
+		int selStartBefore, int selEndBefore, int selStartAfter, int selEndAfter);
+	/** @brief 结束当前合并，下一次编辑一定产生新记录。 */
+	void Seal() { _sealed = true; }
+
+	bool CanUndo() const { return !_undo.empty(); }
+	bool CanRedo() const { return !_redo.empty(); }
+	size_t UndoCount() const { return _undo.size(); }
+	size_t RedoCount() const { return _redo.size(); }
+
+	/**
+	 * @brief 取出一步撤销。调用方须在修改文档之前调用（read 读取的是修改前的文本），
+	 *        随后按 out 修改文档。
+	 * @return false 表示没有可撤销的记录。
+	 */
+	bool Undo(const TextReader& read, Change& out);
+	/** @brief 取出一步重做，约定同 Undo。 */
+	bool Redo(const TextReader& read, Change& out);
+
+	/** @brief 清空全部历史（字符池会先被抹零）。 */
+	void Clear();
+
+	/** @brief 当前历史占用的字节数（记录 + 有效文本，用于预算与诊断）。 */
+	size_t MemoryUsage() const;
+	/** @brief 字符池实际大小（含废弃部分，用于诊断）。 */
+	size_t StorageLength() const { return _pool.size(); }
+
+private:
+	enum class Kind : uint8_t
+	{
+		Other,
+		Typing,
+		Backspace,
+		Delete,
+	};
+
+	struct Entry
+	{
+		size_t pos = 0;
+		size_t removedLen = 0;
+		size_t insertedLen = 0;
+		// 不在文档中的那一侧文本在 _pool 中的位置
+		size_t textOffset = 0;
+		size_t textLen = 0;
+		// 连续退格时按输入顺序追加，文本在池中是倒序的
+		bool reversed = false;
+		Kind kind = Kind::Other;
+		int selStartBefore = 0;
+		int selEndBefore = 0;
+		int selStartAfter = 0;
+		int selEndAfter = 0;
+	};
+
+	std::deque<Entry> _undo;
+	std::vector<Entry> _redo;
+	std::wstring _pool;
+	size_t _liveChars = 0;
+	size_t _budget = DefaultBudgetBytes;
+	bool _sealed = true;
+	wchar_t _lastTyped = 0;
+	std::chrono::steady_clock::time_point _lastTime;
+
+	size_t Store(const std::wstring& text, bool reversed);
+	std::wstring Load(const Entry& r) const;
+	void Release(const Entry& r) { _liveChars -= r.textLen; }
+	bool TryMerge(size_t pos, const std::wstring& removed, const std::wstring& inserted,
+		int selStartBefore, int selEndBefore, int selStartAfter, int selEndAfter,
+		std::chrono::steady_clock::time_point now);
+	void ClearRedo();
+	void EnforceBudget();
+	void MaybeCompact();
+	static Kind Classify(size_t pos, size_t removedLen, const std::wstring& inserted, int selStartBefore, int selEndBefore);
+};
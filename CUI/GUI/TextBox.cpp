@@ -15,22 +15,15 @@ void TextBox::InputText(std::wstring input)
 	std::wstring oldStr = this->Text;
 	int sels = SelectionStart <= SelectionEnd ? SelectionStart : SelectionEnd;
 	int sele = SelectionEnd >= SelectionStart ? SelectionEnd : SelectionStart;
-	UndoRecord rec;
-	bool shouldRecord = false;
-	int recSels = std::clamp(sels, 0, (int)this->Text.size());
-	int recSele = std::clamp(sele, 0, (int)this->Text.size());
-	if (!this->isApplyingUndoRedo && (!input.empty() || recSele > recSels))
+	const int selStartBefore = this->SelectionStart;
+	const int selEndBefore = this->SelectionEnd;
+	const int recSels = std::clamp(sels, 0, (int)this->Text.size());
+	const int recSele = std::clamp(sele, 0, (int)this->Text.size());
+	std::wstring removed = (recSele > recSels) ? this->Text.substr((size_t)recSels, (size_t)(recSele - recSels)) : L"";
+	std::wstring inserted = input;
+	for (auto& ch : inserted)
 	{
-		rec.pos = recSels;
-		rec.removedText = (recSele > recSels) ? this->Text.substr((size_t)recSels, (size_t)(recSele - recSels)) : L"";
-		rec.insertedText = input;
-		for (auto& ch : rec.insertedText)
-		{
-			if (ch == L'\r' || ch == L'\n') ch = L' ';
-		}
-		rec.selStartBefore = this->SelectionStart;
-		rec.selEndBefore = this->SelectionEnd;
-		shouldRecord = true;
+		if (ch == L'\r' || ch == L'\n') ch = L' ';
 	}
 	if (sele >= this->Text.size() && sels >= this->Text.size())
 	{
@@ -83,13 +76,7 @@ void TextBox::InputText(std::wstring input)
 		}
 	}
 	this->Text = std::wstring(tmp.data());
-	if (shouldRecord)
-	{
-		rec.selStartAfter = this->SelectionStart;
-		rec.selEndAfter = this->SelectionEnd;
-		this->undoStack.push_back(rec);
-		this->redoStack.clear();
-	}
+	this->undoHistory.Record((size_t)recSels, removed, inserted, selStartBefore, selEndBefore, this->SelectionStart, this->SelectionEnd);
 	this->OnTextChanged(this, oldStr, this->Text);
 }
 void TextBox::InputBack()
@@ -97,59 +84,21 @@ void TextBox::InputBack()
 	std::wstring oldStr = this->Text;
 	int sels = SelectionStart <= SelectionEnd ? SelectionStart : SelectionEnd;
 	int sele = SelectionEnd >= SelectionStart ? SelectionEnd : SelectionStart;
+	sels = std::clamp(sels, 0, (int)oldStr.size());
+	sele = std::clamp(sele, 0, (int)oldStr.size());
 	int selLen = sele - sels;
-	UndoRecord rec;
-	bool shouldRecord = false;
-	if (selLen > 0)
-	{
-		if (!this->isApplyingUndoRedo)
-		{
-			int recSels = std::clamp(sels, 0, (int)this->Text.size());
-			int recSele = std::clamp(sele, 0, (int)this->Text.size());
-			rec.pos = recSels;
-			rec.removedText = (recSele > recSels) ? this->Text.substr((size_t)recSels, (size_t)(recSele - recSels)) : L"";
-			rec.insertedText = L"";
-			rec.selStartBefore = this->SelectionStart;
-			rec.selEndBefore = this->SelectionEnd;
-			shouldRecord = true;
-		}
-		List<wchar_t> tmp = List<wchar_t>((wchar_t*)this->Text.c_str(), this->Text.size());
-		for (int i = 0; i < selLen; i++)
-		{
-			tmp.RemoveAt(sels);
-		}
-		tmp.Add(L'\0');
-		this->SelectionStart = this->SelectionEnd = sels;
-		this->Text = tmp.data();
-	}
-	else
-	{
-		if (sels > 0)
-		{
-			if (!this->isApplyingUndoRedo)
-			{
-				int recPos = std::clamp(sels - 1, 0, (int)this->Text.size());
-				rec.pos = recPos;
-				rec.removedText = this->Text.substr((size_t)recPos, (size_t)1);
-				rec.insertedText = L"";
-				rec.selStartBefore = this->SelectionStart;
-				rec.selEndBefore = this->SelectionEnd;
-				shouldRecord = true;
-			}
-			List<wchar_t> tmp = List<wchar_t>((wchar_t*)this->Text.c_str(), this->Text.size());
-			tmp.RemoveAt(sels - 1);
-			tmp.Add(L'\0');
-			this->SelectionStart = this->SelectionEnd = sels - 1;
-			this->Text = tmp.data();
-		}
-	}
-	if (shouldRecord)
-	{
-		rec.selStartAfter = this->SelectionStart;
-		rec.selEndAfter = this->SelectionEnd;
-		this->undoStack.push_back(rec);
-		this->redoStack.clear();
-	}
+	if (selLen == 0 && sels == 0) return;
+
+	const int selStartBefore = this->SelectionStart;
+	const int selEndBefore = this->SelectionEnd;
+	const int pos = selLen > 0 ? sels : sels - 1;
+	const int count = selLen > 0 ? selLen : 1;
+	std::wstring removed = oldStr.substr((size_t)pos, (size_t)count);
+	std::wstring newText = oldStr;
+	newText.erase((size_t)pos, (size_t)count);
+	this->SelectionStart = this->SelectionEnd = pos;
+	this->Text = newText;
+	this->undoHistory.Record((size_t)pos, removed, std::wstring(), selStartBefore, selEndBefore, this->SelectionStart, this->SelectionEnd);
 	this->OnTextChanged(this, oldStr, this->Text);
 }
 void TextBox::InputDelete()
@@ -157,116 +106,56 @@ void TextBox::InputDelete()
 	std::wstring oldStr = this->Text;
 	int sels = SelectionStart <= SelectionEnd ? SelectionStart : SelectionEnd;
 	int sele = SelectionEnd >= SelectionStart ? SelectionEnd : SelectionStart;
+	sels = std::clamp(sels, 0, (int)oldStr.size());
+	sele = std::clamp(sele, 0, (int)oldStr.size());
 	int selLen = sele - sels;
-	UndoRecord rec;
-	bool shouldRecord = false;
-	if (selLen > 0)
-	{
-		if (!this->isApplyingUndoRedo)
-		{
-			int recSels = std::clamp(sels, 0, (int)this->Text.size());
-			int recSele = std::clamp(sele, 0, (int)this->Text.size());
-			rec.pos = recSels;
-			rec.removedText = (recSele > recSels) ? this->Text.substr((size_t)recSels, (size_t)(recSele - recSels)) : L"";
-			rec.insertedText = L"";
-			rec.selStartBefore = this->SelectionStart;
-			rec.selEndBefore = this->SelectionEnd;
-			shouldRecord = true;
-		}
-		List<wchar_t> tmp = List<wchar_t>((wchar_t*)this->Text.c_str(), this->Text.size());
-		for (int i = 0; i < selLen; i++)
-		{
-			tmp.RemoveAt(sels);
-		}
-		tmp.Add(L'\0');
-		this->SelectionStart = this->SelectionEnd = sels;
-		this->Text = tmp.data();
-	}
-	else
-	{
-		if (sels < this->Text.size())
-		{
-			if (!this->isApplyingUndoRedo)
-			{
-				int recPos = std::clamp(sels, 0, (int)this->Text.size());
-				rec.pos = recPos;
-				rec.removedText = this->Text.substr((size_t)recPos, (size_t)1);
-				rec.insertedText = L"";
-				rec.selStartBefore = this->SelectionStart;
-				rec.selEndBefore = this->SelectionEnd;
-				shouldRecord = true;
-			}
-			List<wchar_t> tmp = List<wchar_t>((wchar_t*)this->Text.c_str(), this->Text.size());
-			tmp.RemoveAt(sels);
-			tmp.Add(L'\0');
-			this->SelectionStart = this->SelectionEnd = sels;
-			this->Text = tmp.data();
-		}
-	}
-	if (shouldRecord)
-	{
-		rec.selStartAfter = this->SelectionStart;
-		rec.selEndAfter = this->SelectionEnd;
-		this->undoStack.push_back(rec);
-		this->redoStack.clear();
-	}
+	if (selLen == 0 && sels >= (int)oldStr.size()) return;
+
+	const int selStartBefore = this->SelectionStart;
+	const int selEndBefore = this->SelectionEnd;
+	const int count = selLen > 0 ? selLen : 1;
+	std::wstring removed = oldStr.substr((size_t)sels, (size_t)count);
+	std::wstring newText = oldStr;
+	newText.erase((size_t)sels, (size_t)count);
+	this->SelectionStart = this->SelectionEnd = sels;
+	this->Text = newText;
+	this->undoHistory.Record((size_t)sels, removed, std::wstring(), selStartBefore, selEndBefore, this->SelectionStart, this->SelectionEnd);
 	this->OnTextChanged(this, oldStr, this->Text);
 }
-void TextBox::ApplyUndoRecord(const UndoRecord& rec, bool isUndo)
+void TextBox::ApplyUndoChange(const UndoEngine::Change& change)
 {
 	std::wstring oldStr = this->Text;
-	std::wstring newText = this->Text;
-	this->isApplyingUndoRedo = true;
-
-	int pos = std::clamp(rec.pos, 0, (int)newText.size());
-	const std::wstring& removeText = isUndo ? rec.insertedText : rec.removedText;
-	const std::wstring& insertText = isUndo ? rec.removedText : rec.insertedText;
+	std::wstring newText = oldStr;
 
-	if (!removeText.empty() && pos <= (int)newText.size())
-	{
-		size_t removeLen = std::min(removeText.size(), newText.size() - (size_t)pos);
-		newText.erase((size_t)pos, removeLen);
-	}
-	if (!insertText.empty())
-	{
-		newText.insert((size_t)pos, insertText);
-	}
+	const size_t pos = std::min(change.Pos, newText.size());
+	const size_t removeLen = std::min(change.RemoveLen, newText.size() - pos);
+	newText.erase(pos, removeLen);
+	newText.insert(pos, change.InsertText);
 	for (auto& ch : newText)
 	{
 		if (ch == L'\r' || ch == L'\n') ch = L' ';
 	}
-	if (isUndo)
-	{
-		this->SelectionStart = rec.selStartBefore;
-		this->SelectionEnd = rec.selEndBefore;
-	}
-	else
-	{
-		this->SelectionStart = rec.selStartAfter;
-		this->SelectionEnd = rec.selEndAfter;
-	}
-	this->SelectionStart = std::clamp(this->SelectionStart, 0, (int)newText.size());
-	this->SelectionEnd = std::clamp(this->SelectionEnd, 0, (int)newText.size());
+	this->SelectionStart = std::clamp(change.SelStart, 0, (int)newText.size());
+	this->SelectionEnd = std::clamp(change.SelEnd, 0, (int)newText.size());
 
-	this->isApplyingUndoRedo = false;
 	this->Text = newText;
 	this->OnTextChanged(this, oldStr, this->Text);
 }
 void TextBox::Undo()
 {
-	if (this->undoStack.empty()) return;
-	UndoRecord rec = this->undoStack.back();
-	this->undoStack.pop_back();
-	ApplyUndoRecord(rec, true);
-	this->redoStack.push_back(rec);
+	UndoEngine::Change change;
+	std::wstring text = this->Text;
+	if (!this->undoHistory.Undo([&text](size_t pos, size_t len) { return pos < text.size() ? text.substr(pos, len) : std::wstring(); }, change))
+		return;
+	ApplyUndoChange(change);
 }
 void TextBox::Redo()
 {
-	if (this->redoStack.empty()) return;
-	UndoRecord rec = this->redoStack.back();
-	this->redoStack.pop_back();
-	ApplyUndoRecord(rec, false);
-	this->undoStack.push_back(rec);
+	UndoEngine::Change change;
+	std::wstring text = this->Text;
+	if (!this->undoHistory.Redo([&text](size_t pos, size_t len) { return pos < text.size() ? text.substr(pos, len) : std::wstring(); }, change))
+		return;
+	ApplyUndoChange(change);
 }
 void TextBox::UpdateScroll(bool arrival)
 {
@@ -1,5 +1,6 @@
 #pragma once
 #include "Control.h"
+#include "Text/UndoEngine.h"
 #pragma comment(lib, "Imm32.lib")
 
 /**
@@ -10,6 +11,7 @@
  * - SelectionStart/SelectionEnd：选择区间（基于字符索引）
  * - OffsetX：水平滚动偏移（像素），用于长文本显示
  * - GetAnimatedInvalidRect：用于光标闪烁等动画区域增量刷新
+ * - Ctrl+Z/Ctrl+Y：撤销/重做，历史由 UndoEngine 合并连续键入并按字节预算淘汰
  */
 class TextBox : public Control
 {
@@ -40,27 +42,19 @@ protected:
 	D2D1_RECT_F _caretRectCache = { 0,0,0,0 };
 	bool _caretRectCacheValid = false;
 private:
-	struct UndoRecord
-	{
-		int pos = 0;
-		std::wstring removedText;
-		std::wstring insertedText;
-		int selStartBefore = 0;
-		int selEndBefore = 0;
-		int selStartAfter = 0;
-		int selEndAfter = 0;
-	};
-	std::vector<UndoRecord> undoStack;
-	std::vector<UndoRecord> redoStack;
-	bool isApplyingUndoRedo = false;
+	UndoEngine undoHistory;
 	void InputText(std::wstring input);
 	void InputBack();
 	void InputDelete();
 	void UpdateScroll(bool arrival = false);
-	void ApplyUndoRecord(const UndoRecord& rec, bool isUndo);
+	void ApplyUndoChange(const UndoEngine::Change& change);
 	void Undo();
 	void Redo();
 public:
+	/** @brief 设置撤销历史的内存预算（字节，0 表示不限制）。 */
+	void SetUndoBudget(size_t bytes) { this->undoHistory.SetBudget(bytes); }
+	/** @brief 清空撤销/重做历史。 */
+	void ClearUndoHistory() { this->undoHistory.Clear(); }
 	/** @brief 返回当前选中的文本片段。 */
 	std::wstring GetSelectedString();
 	void Update() override;
@@ -0,0 +1,84 @@
+#include "TreeRowIndex.h"
+
+void TreeChildRows::Assign(const std::vector<int>& spans)
+{
+	const size_t n = spans.size();
+	_spans = spans;
+	_tree.assign(n + 1, 0);
+	_total = 0;
+	// 线性建树：每个结点把自己的和累加到父结点
+	for (size_t i = 1; i <= n; i++)
+	{
+		_tree[i] += spans[i - 1];
+		_total += spans[i - 1];
+		const size_t parent = i + (i & (~i + 1));
+		if (parent <= n) _tree[parent] += _tree[i];
+	}
+}
+
+void TreeChildRows::Clear()
+{
+	_tree.clear();
+	_spans.clear();
+	_total = 0;
+}
+
+int TreeChildRows::Count() const
+{
+	return (int)_spans.size();
+}
+
+int TreeChildRows::Span(int index) const
+{
+	if (index < 0 || index >= (int)_spans.size()) return 0;
+	return _spans[(size_t)index];
+}
+
+void TreeChildRows::Set(int index, int span)
+{
+	if (index < 0 || index >= (int)_spans.size()) return;
+	const int delta = span - _spans[(size_t)index];
+	if (delta == 0) return;
+	_spans[(size_t)index] = span;
+	_total += delta;
+	for (size_t i = (size_t)index + 1; i < _tree.size(); i += i & (~i + 1))
+		_tree[i] += delta;
+}
+
+int TreeChildRows::Prefix(int index) const
+{
+	if (index <= 0) return 0;
+	if (index > (int)_spans.size()) index = (int)_spans.size();
+	int sum = 0;
+	for (size_t i = (size_t)index; i > 0; i -= i & (~i + 1))
+		sum += _tree[i];
+	return sum;
+}
+
+int TreeChildRows::Total() const
+{
+	return _total;
+}
+
+int TreeChildRows::Find(int row, int& offset) const
+{
+	offset = 0;
+	if (row < 0 || row >= _total) return -1;
+	const size_t n = _spans.size();
+	size_t step = 1;
+	while (step * 2 <= n) step *= 2;
+	// 找出前缀和不超过 row 的最长前缀，下一个子节点即包含该行
+	size_t pos = 0;
+	int rest = row;
+	for (; step > 0; step /= 2)
+	{
+		if (pos + step <= n && _tree[pos + step] <= rest)
+		{
+			pos += step;
+			rest -= _tree[pos];
+		}
+	}
+	if (pos >= n) return -1;
+	offset = rest;
+	return (int)pos;
+}
@@ -0,0 +1,261 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @file TreeRowIndex.h
+ * @brief TreeRowIndex：树形控件的可见行索引（按子树行数做顺序统计，不依赖 Windows）。
+ *
+ * 每个节点记录展开后其后代占用的行数，并用树状数组保存各子节点占用的行数（自身 1 行 + 展开的后代），
+ * “第 n 行是哪个节点”与“节点在第几行”只需沿根到节点的路径查找，每层 O(log 子节点数)。
+ *
+ * 修改（展开/收起、增删子节点）由 MarkDirty 记录在节点自身，并沿父链登记到父节点的待更新列表，
+ * 遇到已登记的祖先即停止；Sync 只沿登记的路径重新计算，没有全局计数，各棵树互不影响。
+ */
+
+/** @brief 子节点占用行数的树状数组。 */
+class TreeChildRows
+{
+public:
+	/** @brief 重新设置全部子节点的行数（O(k)）。 */
+	void Assign(const std::vector<int>& spans);
+	void Clear();
+	int Count() const;
+	int Span(int index) const;
+	/** @brief 修改第 index 个子节点的行数（O(log k)）。 */
+	void Set(int index, int span);
+	/** @brief 前 index 个子节点的行数之和（O(log k)）。 */
+	int Prefix(int index) const;
+	int Total() const;
+	/**
+	 * @brief 第 row 行（0 起）落在哪个子节点（O(log k)）。
+	 * @param offset 该行相对子节点首行的偏移（0 即子节点自身）。
+	 * @return 子节点下标，越界返回 -1。
+	 */
+	int Find(int row, int& offset) const;
+
+private:
+	// 1 起的树状数组
+	std::vector<int> _tree;
+	std::vector<int> _spans;
+	int _total = 0;
+};
+
+/** @brief 节点上的索引状态（由 TreeRowIndex 维护）。 */
+template<class Node>
+struct TreeRowState
+{
+	TreeChildRows Children;
+	/** @brief 展开后后代占用的行数（收起为 0，加载占位为 1）。 */
+	int Rows = 0;
+	/** @brief 在父节点 Children 中的位置。 */
+	int ChildIndex = -1;
+	bool Indexed = false;
+	bool Dirty = false;
+	/** @brief 已登记到父节点的 Pending。 */
+	bool Queued = false;
+	// 建立索引时的快照，用于发现未经 MarkDirty 的修改
+	bool Expanded = false;
+	bool Loading = false;
+	int ChildCount = 0;
+	/** @brief 有修改的子节点及其登记时的下标（子节点可能已被移除，按下标核对指针后才访问）。 */
+	std::vector<std::pair<Node*, int>> Pending;
+};
+
+/**
+ * @brief 可见行索引。
+ *
+ * Node 需要 Parent 指针与按下标访问的 Children；Policy 提供：
+ * - static TreeRowState<Node>& State(Node*)
+ * - bool Expanded(Node*)：节点的子节点是否显示（根节点通常总是展开）
+ * - bool Loading(Node*)：展开但子节点尚在加载，显示一个占位行
+ * - void Prepare(Node*)：展开的节点建立索引前调用（可在此同步加载子节点）
+ *
+ * 第 0 行是根节点的第一个子节点，根节点自身不占行。
+ */
+template<class Node, class Policy>
+class TreeRowIndex
+{
+public:
+	explicit TreeRowIndex(Policy policy) : _policy(policy) {}
+
+	/** @brief 记录节点的展开状态或子节点已修改（O(深度)）。 */
+	static void MarkDirty(Node* node)
+	{
+		Policy::State(node).Dirty = true;
+		for (Node* c = node; c->Parent; c = c->Parent)
+		{
+			auto& cs = Policy::State(c);
+			if (cs.Queued) break;
+			cs.Queued = true;
+			Policy::State(c->Parent).Pending.push_back({ c, cs.ChildIndex });
+		}
+	}
+
+	/** @brief 节点的展开状态或子节点数与索引不一致（修改未经 MarkDirty）。 */
+	bool Changed(Node* node)
+	{
+		const auto& s = Policy::State(node);
+		return !s.Indexed || s.Expanded != _policy.Expanded(node) ||
+			s.ChildCount != (int)node->Children.size() || s.Loading != IsLoading(node);
+	}
+
+	/** @brief 处理登记的修改。 */
+	void Sync(Node* root)
+	{
+		// 同步加载子节点时会再次登记，再处理一轮即可
+		while (NeedsSync(root))
+			Refresh(root);
+	}
+
+	/** @brief 丢弃整棵树（含收起的子树）的索引并重建（O(节点总数)）。 */
+	void Reset(Node* root)
+	{
+		Forget(root);
+		Sync(root);
+	}
+
+	/** @brief 可见行数（调用前先 Sync）。 */
+	int RowCount(Node* root) const
+	{
+		return Policy::State(root).Rows;
+	}
+
+	/**
+	 * @brief 第 row 个可见行（调用前先 Sync）。
+	 * @param level 行的缩进层级（根节点的子节点为 0）。
+	 * @param placeholder 该行是返回节点的“加载中”占位行。
+	 * @return 越界返回 NULL。
+	 */
+	Node* NodeAtRow(Node* root, int row, int& level, bool& placeholder) const
+	{
+		level = 0;
+		placeholder = false;
+		if (row < 0 || row >= Policy::State(root).Rows) return NULL;
+		Node* node = root;
+		for (;;)
+		{
+			const auto& s = Policy::State(node);
+			if (s.Loading)
+			{
+				placeholder = true;
+				return node;
+			}
+			int offset = 0;
+			const int i = s.Children.Find(row, offset);
+			if (i < 0 || i >= (int)node->Children.size()) return NULL;
+			Node* c = node->Children[i];
+			if (offset == 0) return c;
+			row = offset - 1;
+			node = c;
+			level++;
+		}
+	}
+
+	/** @brief 节点所在的可见行（调用前先 Sync；不在树中或被收起时返回 -1）。 */
+	int RowOfNode(Node* root, Node* node) const
+	{
+		if (!node || node == root) return -1;
+		int row = 0;
+		for (Node* c = node; c != root;)
+		{
+			Node* p = c->Parent;
+			if (!p) return -1;
+			const auto& ps = Policy::State(p);
+			const int i = Policy::State(c).ChildIndex;
+			if (!ps.Indexed || !ps.Expanded || ps.Loading || i < 0 || i >= ps.Children.Count() ||
+				i >= (int)p->Children.size() || p->Children[i] != c)
+				return -1;
+			row += ps.Children.Prefix(i);
+			if (p != root) row += 1;
+			c = p;
+		}
+		return row;
+	}
+
+private:
+	Policy _policy;
+
+	bool IsLoading(Node* node)
+	{
+		return _policy.Expanded(node) && _policy.Loading(node);
+	}
+
+	bool NeedsSync(Node* root)
+	{
+		const auto& s = Policy::State(root);
+		return s.Dirty || !s.Pending.empty() || Changed(root);
+	}
+
+	static void Forget(Node* node)
+	{
+		auto& s = Policy::State(node);
+		s.Indexed = false;
+		s.Dirty = false;
+		s.Queued = false;
+		s.Pending.clear();
+		for (int i = 0; i < (int)node->Children.size(); i++)
+			Forget(node->Children[i]);
+	}
+
+	void Refresh(Node* node)
+	{
+		auto& s = Policy::State(node);
+		if (s.Dirty || Changed(node))
+		{
+			Rebuild(node);
+			return;
+		}
+		if (s.Pending.empty()) return;
+		std::vector<std::pair<Node*, int>> pending;
+		pending.swap(s.Pending);
+		const bool expanded = s.Expanded && !s.Loading;
+		for (const auto& p : pending)
+		{
+			const int i = p.second;
+			if (i < 0 || i >= (int)node->Children.size() || node->Children[i] != p.first) continue;
+			Node* c = p.first;
+			auto& cs = Policy::State(c);
+			if (!cs.Queued) continue;
+			cs.Queued = false;
+			// 收起的节点不维护子节点行数，再次展开时整体重建
+			if (!expanded) continue;
+			Refresh(c);
+			s.Children.Set(i, 1 + cs.Rows);
+		}
+		if (expanded) s.Rows = s.Children.Total();
+	}
+
+	void Rebuild(Node* node)
+	{
+		auto& s = Policy::State(node);
+		if (_policy.Expanded(node)) _policy.Prepare(node);
+		const int count = (int)node->Children.size();
+		s.Expanded = _policy.Expanded(node);
+		s.Loading = IsLoading(node);
+		s.ChildCount = count;
+		s.Indexed = true;
+		s.Dirty = false;
+		s.Pending.clear();
+		if (!s.Expanded || s.Loading)
+		{
+			s.Children.Clear();
+			s.Rows = s.Loading ? 1 : 0;
+			return;
+		}
+		std::vector<int> spans((size_t)count);
+		for (int i = 0; i < count; i++)
+		{
+			Node* c = node->Children[i];
+			c->Parent = node;
+			auto& cs = Policy::State(c);
+			cs.ChildIndex = i;
+			cs.Queued = false;
+			Refresh(c);
+			spans[(size_t)i] = 1 + cs.Rows;
+		}
+		s.Children.Assign(spans);
+		s.Rows = s.Children.Total();
+	}
+};
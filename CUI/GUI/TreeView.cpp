@@ -1,112 +1,185 @@
 #include "TreeView.h"
 #include "Form.h"
-static void renderNodes(TreeView* tree, D2DGraphics* d2d, float x, float y, float w, float h, float itemHeight, int scrollIndex, int& currindex, int sunLevel, List<TreeNode*>& Children)
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+// 后台加载任务：由 TreeView 与工作线程共同持有
+struct TreeNodeLoadJob
 {
-	float baseLeft = sunLevel * itemHeight + 3.5f + x;
-	for (auto c : Children)
+	std::mutex Lock;
+	// 节点析构时置 NULL，之后的加载结果直接丢弃（可能在工作线程释放；这些节点未挂到树上，不触及任何树的行索引）
+	TreeNode* Node = NULL;
+	ULONG64 Tag = NULL;
+	std::wstring Text;
+	TreeNodeChildrenLoader Loader;
+	HWND Notify = NULL;
+	List<TreeNode*> Children;
+	bool Done = false;
+	~TreeNodeLoadJob()
 	{
-		int renderIndex = currindex - scrollIndex;
-		float renderTop = itemHeight * renderIndex;
-
-		if (renderTop >= 0.0f && renderTop < h)
-		{
-			float renderLeft = baseLeft;
-			float exTop = renderTop + (itemHeight * 0.2f) + y;
-			auto foreColor = (c == tree->SelectedNode) ? tree->SelectedForeColor : tree->ForeColor;
-			if (c == tree->SelectedNode)
-			{
-				d2d->FillRect(x, renderTop + y, w, itemHeight, tree->SelectedBackColor);
-			}
-			else if (c == tree->HoveredNode)
-			{
-				d2d->FillRect(x, renderTop + y, w, itemHeight, tree->UnderMouseItemBackColor);
-			}
-			if (c->Children.Count > 0)
-			{
-				float triSize = itemHeight * 0.5f;
-				float triCenterX = renderLeft + triSize * 0.5f;
-				float triCenterY = exTop + triSize * 0.5f;
-				D2D1_TRIANGLE tri{};
-
-				if (c->Expand)
-				{
-					tri.point1 = D2D1::Point2F(triCenterX - triSize * 0.5f, triCenterY - triSize * 0.4f);
-					tri.point2 = D2D1::Point2F(triCenterX + triSize * 0.5f, triCenterY - triSize * 0.4f);
-					tri.point3 = D2D1::Point2F(triCenterX, triCenterY + triSize * 0.4f);
-				}
-				else
-				{
-					tri.point1 = D2D1::Point2F(triCenterX - triSize * 0.4f, triCenterY - triSize * 0.5f);
-					tri.point2 = D2D1::Point2F(triCenterX - triSize * 0.4f, triCenterY + triSize * 0.5f);
-					tri.point3 = D2D1::Point2F(triCenterX + triSize * 0.4f, triCenterY);
-				}
+		for (auto c : this->Children)
+			delete c;
+	}
+};
 
-				d2d->FillTriangle(tri, foreColor);
+static bool hasExpander(TreeNode* c)
+{
+	return c->Children.Count > 0 || c->HasChildren;
+}
+static void renderPlaceholder(TreeView* tree, D2DGraphics* d2d, int sunLevel, float x, float y, float itemHeight, float renderTop)
+{
+	auto color = tree->ForeColor;
+	color.a *= 0.6f;
+	d2d->DrawString(tree->LoadingText, sunLevel * itemHeight + 3.5f + x + (itemHeight * 0.8f), renderTop + y, color, tree->Font);
+}
+static void renderNode(TreeView* tree, D2DGraphics* d2d, TreeNode* c, int sunLevel, float x, float y, float w, float itemHeight, float renderTop)
+{
+	float renderLeft = sunLevel * itemHeight + 3.5f + x;
+	float exTop = renderTop + (itemHeight * 0.2f) + y;
+	auto foreColor = (c == tree->SelectedNode) ? tree->SelectedForeColor : tree->ForeColor;
+	if (c == tree->SelectedNode)
+	{
+		d2d->FillRect(x, renderTop + y, w, itemHeight, tree->SelectedBackColor);
+	}
+	else if (c == tree->HoveredNode)
+	{
+		d2d->FillRect(x, renderTop + y, w, itemHeight, tree->UnderMouseItemBackColor);
+	}
+	if (hasExpander(c))
+	{
+		float triSize = itemHeight * 0.5f;
+		float triCenterX = renderLeft + triSize * 0.5f;
+		float triCenterY = exTop + triSize * 0.5f;
+		D2D1_TRIANGLE tri{};
 
-				if (auto* bmp = c->GetImageBitmap(d2d))
-				{
-					d2d->DrawBitmap(bmp, renderLeft + (itemHeight * 0.8f), renderTop + y, itemHeight, itemHeight);
-					renderLeft += itemHeight;
-				}
-				d2d->DrawString(c->Text, renderLeft + (itemHeight * 0.8f), renderTop + y, foreColor, tree->Font);
-			}
-			else
-			{
-				if (auto* bmp = c->GetImageBitmap(d2d))
-				{
-					d2d->DrawBitmap(bmp, renderLeft, renderTop + y, itemHeight, itemHeight);
-					renderLeft += itemHeight;
-				}
-				d2d->DrawString(c->Text, renderLeft, renderTop + y, foreColor, tree->Font);
-			}
+		if (c->Expand)
+		{
+			tri.point1 = D2D1::Point2F(triCenterX - triSize * 0.5f, triCenterY - triSize * 0.4f);
+			tri.point2 = D2D1::Point2F(triCenterX + triSize * 0.5f, triCenterY - triSize * 0.4f);
+			tri.point3 = D2D1::Point2F(triCenterX, triCenterY + triSize * 0.4f);
+		}
+		else
+		{
+			tri.point1 = D2D1::Point2F(triCenterX - triSize * 0.4f, triCenterY - triSize * 0.5f);
+			tri.point2 = D2D1::Point2F(triCenterX - triSize * 0.4f, triCenterY + triSize * 0.5f);
+			tri.point3 = D2D1::Point2F(triCenterX + triSize * 0.4f, triCenterY);
 		}
 
-		currindex += 1;
+		d2d->FillTriangle(tri, foreColor);
 
-		if (c->Expand)
+		if (auto* bmp = c->GetImageBitmap(d2d))
+		{
+			d2d->DrawBitmap(bmp, renderLeft + (itemHeight * 0.8f), renderTop + y, itemHeight, itemHeight);
+			renderLeft += itemHeight;
+		}
+		d2d->DrawString(c->Text, renderLeft + (itemHeight * 0.8f), renderTop + y, foreColor, tree->Font);
+	}
+	else
+	{
+		if (auto* bmp = c->GetImageBitmap(d2d))
 		{
-			renderNodes(tree, d2d, x, y, w, h, itemHeight, scrollIndex, currindex, sunLevel + 1, c->Children);
+			d2d->DrawBitmap(bmp, renderLeft, renderTop + y, itemHeight, itemHeight);
+			renderLeft += itemHeight;
 		}
+		d2d->DrawString(c->Text, renderLeft, renderTop + y, foreColor, tree->Font);
 	}
 }
 
-static TreeNode* findNode(float posX, float posY, float w, float h, float itemHeight, int scrollIndex, int& currindex, int sunLevel, List<TreeNode*>& Children, bool& isHitEx)
+// 行索引的访问策略：根节点总是展开，展开时按需加载子节点
+struct TreeViewRows
 {
-	for (auto c : Children)
+	TreeView* Tree;
+	static TreeRowState<TreeNode>& State(TreeNode* node)
 	{
-		int renderIndex = currindex - scrollIndex;
-		float currTop = itemHeight * renderIndex;
-		float currBottom = currTop + itemHeight;
-		if (currTop >= 0.0f && currTop < h)
-		{
-			if (posY >= currTop && posY <= currBottom)
-			{
-				float exLeft = (sunLevel * itemHeight) + 3.5f;
-				if (posX >= exLeft && posX <= (exLeft + (itemHeight * 0.6f)) && c->Children.Count > 0)
-					isHitEx = true;
-				else
-					isHitEx = false;
-				return c;
-			}
-		}
-		currindex += 1;
-		if (c->Expand)
+		return node->_rows;
+	}
+	bool Expanded(TreeNode* node) const
+	{
+		return node == Tree->Root || node->_expand;
+	}
+	bool Loading(TreeNode* node) const
+	{
+		return node->_loadJob && node->Children.Count == 0;
+	}
+	void Prepare(TreeNode* node) const
+	{
+		if (Tree->NeedsLoad(node))
+			Tree->LoadChildren(node);
+	}
+};
+typedef TreeRowIndex<TreeNode, TreeViewRows> TreeViewRowIndex;
+
+void TreeNodeList::Attach(TreeNode* node, int index)
+{
+	if (!node) return;
+	node->Parent = this->_owner;
+	node->_rows.ChildIndex = index;
+	node->_rows.Queued = false;
+}
+void TreeNodeList::Add(TreeNode* node)
+{
+	List<TreeNode*>::Add(node);
+	Attach(node, this->Count - 1);
+	TreeViewRowIndex::MarkDirty(this->_owner);
+}
+void TreeNodeList::push_back(TreeNode* node)
+{
+	Add(node);
+}
+void TreeNodeList::Insert(int index, TreeNode* node)
+{
+	if (index < 0) return;
+	List<TreeNode*>::Insert(index, node);
+	Attach(node, std::min(index, this->Count - 1));
+	TreeViewRowIndex::MarkDirty(this->_owner);
+}
+void TreeNodeList::RemoveAt(int index)
+{
+	if (index < 0 || index >= this->Count) return;
+	List<TreeNode*>::RemoveAt(index);
+	TreeViewRowIndex::MarkDirty(this->_owner);
+}
+int TreeNodeList::Remove(TreeNode* node)
+{
+	int removed = 0;
+	for (int i = this->Count - 1; i >= 0; i--)
+	{
+		if ((*this)[i] == node)
 		{
-			auto result = findNode(posX, posY, w, h, itemHeight, scrollIndex, currindex, sunLevel + 1, c->Children, isHitEx);
-			if (result)
-				return result;
+			RemoveAt(i);
+			removed++;
 		}
 	}
-
-	return NULL;
+	return removed;
+}
+void TreeNodeList::Clear()
+{
+	List<TreeNode*>::Clear();
+	TreeViewRowIndex::MarkDirty(this->_owner);
+}
+void TreeNodeList::Swap(int from, int to)
+{
+	List<TreeNode*>::Swap(from, to);
+	TreeViewRowIndex::MarkDirty(this->_owner);
 }
 
 TreeNode::TreeNode(std::wstring text, std::shared_ptr<BitmapSource> image)
 {
 	this->Text = text;
 	this->Image = std::move(image);
-	this->Expand = false;
-	this->Children = List<TreeNode*>();
+	this->Children._owner = this;
+}
+
+GET_CPP(TreeNode, bool, Expand)
+{
+	return this->_expand;
+}
+SET_CPP(TreeNode, bool, Expand)
+{
+	if (this->_expand == value) return;
+	this->_expand = value;
+	TreeViewRowIndex::MarkDirty(this);
 }
 
 ID2D1Bitmap* TreeNode::GetImageBitmap(D2DGraphics* render)
@@ -129,9 +202,18 @@ ID2D1Bitmap* TreeNode::GetImageBitmap(D2DGraphics* render)
 }
 TreeNode::~TreeNode()
 {
+	if (this->_loadJob)
+	{
+		std::lock_guard<std::mutex> lock(this->_loadJob->Lock);
+		this->_loadJob->Node = NULL;
+	}
+	// 整棵子树一起释放，不必登记修改
 	for (auto& c : this->Children)
+	{
+		c->Parent = NULL;
 		delete c;
-	this->Children.Clear();
+	}
+	this->Children.clear();
 }
 int TreeNode::UnfoldedCount()
 {
@@ -145,6 +227,242 @@ int TreeNode::UnfoldedCount()
 }
 UIClass TreeView::Type() { return UIClass::UI_TreeView; }
 
+void TreeView::SyncRows(int firstRow, int rowCount)
+{
+	if (!this->Root) return;
+	TreeViewRowIndex rows(TreeViewRows{ this });
+	if (this->_rowsReset)
+	{
+		this->_rowsReset = false;
+		rows.Reset(this->Root);
+	}
+	rows.Sync(this->Root);
+
+	// 可见范围内（及首行的祖先）未经通知的修改就地修补
+	bool changed = false;
+	int level = 0;
+	bool placeholder = false;
+	TreeNode* first = rows.NodeAtRow(this->Root, firstRow < 0 ? 0 : firstRow, level, placeholder);
+	for (TreeNode* p = first ? (placeholder ? first : first->Parent) : NULL; p && p != this->Root; p = p->Parent)
+	{
+		if (rows.Changed(p))
+		{
+			TreeViewRowIndex::MarkDirty(p);
+			changed = true;
+		}
+	}
+	for (int r = firstRow < 0 ? 0 : firstRow; r < firstRow + rowCount; r++)
+	{
+		TreeNode* n = rows.NodeAtRow(this->Root, r, level, placeholder);
+		if (!n) break;
+		if (!placeholder && rows.Changed(n))
+		{
+			TreeViewRowIndex::MarkDirty(n);
+			changed = true;
+		}
+	}
+	if (changed)
+		rows.Sync(this->Root);
+}
+
+TreeNode* TreeView::RowAt(int row, int& level, bool& placeholder)
+{
+	level = 0;
+	placeholder = false;
+	if (!this->Root) return NULL;
+	return TreeViewRowIndex(TreeViewRows{ this }).NodeAtRow(this->Root, row, level, placeholder);
+}
+
+void TreeView::SetExpanded(TreeNode* node, bool expand)
+{
+	if (!node) return;
+	node->Expand = expand;
+	this->PostRender();
+}
+
+void TreeView::RefreshNode(TreeNode* node)
+{
+	if (!node) return;
+	TreeViewRowIndex::MarkDirty(node);
+	this->PostRender();
+}
+
+void TreeView::InvalidateNodes()
+{
+	this->_rowsReset = true;
+	this->PostRender();
+}
+
+int TreeView::VisibleNodeCount()
+{
+	SyncRows(this->ScrollIndex, 0);
+	return this->Root ? this->Root->_rows.Rows : 0;
+}
+
+TreeNode* TreeView::NodeAtRow(int row)
+{
+	SyncRows(this->ScrollIndex, 0);
+	int level = 0;
+	bool placeholder = false;
+	TreeNode* node = RowAt(row, level, placeholder);
+	return placeholder ? NULL : node;
+}
+
+int TreeView::RowOfNode(TreeNode* node)
+{
+	if (!node || !this->Root) return -1;
+	SyncRows(this->ScrollIndex, 0);
+	return TreeViewRowIndex(TreeViewRows{ this }).RowOfNode(this->Root, node);
+}
+
+TreeNode* TreeView::HitTestNode(int xof, int yof, bool& isHitEx)
+{
+	isHitEx = false;
+	const float itemHeight = this->Font->FontHeight;
+	if (itemHeight <= 0.0f || yof < 0 || yof > this->Height) return NULL;
+	const int renderCount = (int)(this->Height / itemHeight) + 1;
+	SyncRows(this->ScrollIndex, renderCount);
+	const int row = this->ScrollIndex + (int)((float)yof / itemHeight);
+	int level = 0;
+	bool placeholder = false;
+	TreeNode* node = RowAt(row, level, placeholder);
+	if (!node || placeholder) return NULL;
+	float exLeft = (level * itemHeight) + 3.5f;
+	isHitEx = xof >= exLeft && xof <= (exLeft + (itemHeight * 0.6f)) && hasExpander(node);
+	return node;
+}
+
+bool TreeView::NeedsLoad(TreeNode* node)
+{
+	return this->ChildrenLoader && node->HasChildren && node->Children.Count == 0 && !node->_loadJob;
+}
+
+void TreeView::LoadChildren(TreeNode* node)
+{
+	if (!this->LoadChildrenInBackground)
+	{
+		List<TreeNode*> children;
+		this->ChildrenLoader(node->Tag, node->Text, children);
+		for (auto c : children)
+			node->Children.Add(c);
+		node->_lazyLoaded = true;
+		if (node->Children.Count == 0) node->HasChildren = false;
+		this->ChildrenLoaded(this, node);
+		return;
+	}
+
+	auto job = std::make_shared<TreeNodeLoadJob>();
+	job->Node = node;
+	job->Tag = node->Tag;
+	job->Text = node->Text;
+	job->Loader = this->ChildrenLoader;
+	job->Notify = this->ParentForm ? this->ParentForm->Handle : NULL;
+	node->_loadJob = job;
+	this->_loadJobs.push_back(job);
+
+	// 结果留在任务中，由 UI 线程在 Update 时挂到树上
+	std::thread([job]()
+		{
+			List<TreeNode*> children;
+			job->Loader(job->Tag, job->Text, children);
+			bool alive = false;
+			{
+				std::lock_guard<std::mutex> lock(job->Lock);
+				job->Children.swap(children);
+				job->Done = true;
+				alive = job->Node != NULL;
+			}
+			if (alive && job->Notify)
+				::InvalidateRect(job->Notify, NULL, FALSE);
+		}).detach();
+}
+
+void TreeView::ApplyLoadedChildren()
+{
+	for (size_t i = 0; i < this->_loadJobs.size();)
+	{
+		auto job = this->_loadJobs[i];
+		TreeNode* node = NULL;
+		{
+			std::lock_guard<std::mutex> lock(job->Lock);
+			if (!job->Done)
+			{
+				i++;
+				continue;
+			}
+			node = job->Node;
+			if (node)
+			{
+				for (auto c : job->Children)
+					node->Children.Add(c);
+				job->Children.clear();
+				node->_loadJob.reset();
+			}
+		}
+		this->_loadJobs.erase(this->_loadJobs.begin() + i);
+		if (!node) continue;
+		node->_lazyLoaded = true;
+		if (node->Children.Count == 0) node->HasChildren = false;
+		RefreshNode(node);
+		this->ChildrenLoaded(this, node);
+	}
+}
+
+bool TreeView::IsLoading(TreeNode* node)
+{
+	return node && node->_loadJob;
+}
+
+void TreeView::UnloadSubtree(TreeNode* node, int& released)
+{
+	if (this->SelectedNode == node)
+	{
+		this->SelectedNode = NULL;
+		this->SelectionChanged(this);
+	}
+	if (this->HoveredNode == node) this->HoveredNode = NULL;
+	released++;
+	for (auto c : node->Children)
+		UnloadSubtree(c, released);
+}
+
+int TreeView::UnloadChildren(TreeNode* node)
+{
+	if (!node || node->Expand || !node->_lazyLoaded) return 0;
+	int released = 0;
+	for (auto c : node->Children)
+		UnloadSubtree(c, released);
+	for (auto c : node->Children)
+		delete c;
+	node->Children.Clear();
+	node->HasChildren = released > 0;
+	node->_lazyLoaded = false;
+	if (released > 0) this->PostRender();
+	return released;
+}
+
+static int unloadCollapsed(TreeView* tree, TreeNode* node)
+{
+	if (!node->Expand)
+	{
+		const int released = tree->UnloadChildren(node);
+		if (released > 0) return released;
+	}
+	int released = 0;
+	for (auto c : node->Children)
+		released += unloadCollapsed(tree, c);
+	return released;
+}
+
+int TreeView::UnloadCollapsedChildren()
+{
+	if (!this->Root) return 0;
+	int released = 0;
+	for (auto c : this->Root->Children)
+		released += unloadCollapsed(this, c);
+	return released;
+}
+
 CursorKind TreeView::QueryCursor(int xof, int yof)
 {
 	(void)yof;
@@ -238,6 +556,9 @@ void TreeView::DrawScroll() {
 }
 void TreeView::Update()
 {
+	// 后台加载的子节点在 UI 线程挂到树上
+	if (!this->_loadJobs.empty())
+		ApplyLoadedChildren();
 	if (this->IsVisual == false)return;
 	bool isUnderMouse = this->ParentForm->UnderMouse == this;
 	auto d2d = this->ParentForm->Render;
@@ -255,9 +576,25 @@ void TreeView::Update()
 		}
 
 		{
-			int curr = 0;
-			renderNodes(this, d2d, abslocation.x, abslocation.y, size.cx, size.cy, font->FontHeight, ScrollIndex, curr, 0, this->Root->Children);
-			this->MaxRenderItems = curr;
+			const float itemHeight = font->FontHeight;
+			const int renderCount = (int)(size.cy / itemHeight) + 1;
+			SyncRows(this->ScrollIndex, renderCount);
+			const int total = this->Root ? this->Root->_rows.Rows : 0;
+			for (int i = 0; i < renderCount && this->ScrollIndex + i < total; i++)
+			{
+				if (this->ScrollIndex + i < 0) continue;
+				int level = 0;
+				bool placeholder = false;
+				TreeNode* node = RowAt(this->ScrollIndex + i, level, placeholder);
+				if (!node) break;
+				if (placeholder)
+				{
+					renderPlaceholder(this, d2d, level, abslocation.x, abslocation.y, itemHeight, itemHeight * i);
+					continue;
+				}
+				renderNode(this, d2d, node, level, abslocation.x, abslocation.y, size.cx, itemHeight, itemHeight * i);
+			}
+			this->MaxRenderItems = total;
 			int maxScroll = this->MaxRenderItems - (this->Height / (this->Font->FontHeight)) + 1;
 			if (maxScroll < 0)maxScroll = 0;
 			if (this->ScrollIndex > maxScroll) this->ScrollIndex = maxScroll;
@@ -349,11 +686,8 @@ bool TreeView::ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int xo
 			}
 			else
 			{
-				auto font = this->Font;
-				auto size = this->ActualSize();
-				int curr = 0;
 				bool isHit = false;
-				auto newHoveredNode = findNode(xof, yof, size.cx, size.cy, font->FontHeight, ScrollIndex, curr, 0, this->Root->Children, isHit);
+				auto newHoveredNode = HitTestNode(xof, yof, isHit);
 				bool needUpdate = this->HoveredNode == newHoveredNode;
 				this->HoveredNode = newHoveredNode;
 				if (needUpdate) this->PostRender();
@@ -409,17 +743,13 @@ bool TreeView::ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int xo
 			}
 			else
 			{
-				auto font = this->Font;
-				auto abslocation = this->AbsLocation;
-				auto size = this->ActualSize();
-				int curr = 0;
 				bool isHit = false;
-				auto node = findNode(xof, yof, size.cx, size.cy, font->FontHeight, ScrollIndex, curr, 0, this->Root->Children, isHit);
+				auto node = HitTestNode(xof, yof, isHit);
 				if (node)
 				{
 					if (isHit)
 					{
-						node->Expand = !node->Expand;
+						SetExpanded(node, !node->Expand);
 					}
 					else
 					{
@@ -458,16 +788,12 @@ bool TreeView::ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam, int xo
 	case WM_LBUTTONDBLCLK:
 	{
 		this->ParentForm->Selected = this;
-		auto font = this->Font;
-		auto abslocation = this->AbsLocation;
-		auto size = this->ActualSize();
-		int curr = 0;
 		bool isHit = false;
-		auto node = findNode(xof, yof, size.cx, size.cy, font->FontHeight, ScrollIndex, curr, 0, this->Root->Children, isHit);
+		auto node = HitTestNode(xof, yof, isHit);
 		if (node)
 		{
-			if (node->Children.Count > 0)
-				node->Expand = !node->Expand;
+			if (hasExpander(node))
+				SetExpanded(node, !node->Expand);
 			if (!isHit)
 			{
 				bool isChanged = this->SelectedNode != node;
@@ -1,15 +1,51 @@
 #pragma once
 #include "Control.h"
+#include "Tree/TreeRowIndex.h"
+#include <functional>
+#include <vector>
 
 /**
  * @file TreeView.h
  * @brief TreeView：树形控件（节点展开/收起、选择、滚动）。
  */
 
+class TreeNode;
+struct TreeNodeLoadJob;
+struct TreeViewRows;
+
+/**
+ * @brief 子节点列表：通过 Add/Insert/RemoveAt/Remove/Clear/Swap/push_back 修改时自动通知所属的 TreeView。
+ *
+ * 通过 List<TreeNode*> 引用、std::vector 接口或下标赋值修改时不会通知，
+ * 可见范围内的节点会在下一次绘制时自动修补，其余位置请调用 TreeView::RefreshNode。
+ */
+class TreeNodeList : public List<TreeNode*>
+{
+public:
+	void Add(TreeNode* node);
+	void push_back(TreeNode* node);
+	void Insert(int index, TreeNode* node);
+	void RemoveAt(int index);
+	int Remove(TreeNode* node);
+	void Clear();
+	void Swap(int from, int to);
+private:
+	friend class TreeNode;
+	TreeNode* _owner = NULL;
+	void Attach(TreeNode* node, int index);
+};
+
 /**
  * @brief 树节点。
  *
  * 所有权：Children 由该节点拥有；~TreeNode 会释放所有子节点。
+ *
+ * TreeView 在节点上记录展开后占用的行数（按子树行数的顺序统计），修改 Expand 或通过
+ * TreeNodeList 的方法增删子节点时只更新该节点及其祖先；见 TreeNodeList 中需要 RefreshNode 的情况。
+ * 节点在两个父节点之间移动时，请先从原父节点移除再加入新父节点。
+ *
+ * 懒加载：HasChildren 为 true 且 Children 为空的节点显示展开箭头，
+ * 首次展开时由 TreeView::ChildrenLoader 填充 Children。
  */
 class TreeNode
 {
@@ -20,15 +56,43 @@ public:
 	ID2D1RenderTarget* ImageCacheTarget = nullptr;
 	const BitmapSource* ImageCacheSource = nullptr;
 	std::wstring Text = L"";
-	List<TreeNode*> Children;
-	bool Expand = false; 
+	TreeNodeList Children;
+	PROPERTY(bool, Expand);
+	GET(bool, Expand);
+	SET(bool, Expand);
+	/** @brief 声明节点有（尚未加载的）子节点；加载结果为空时自动清除。 */
+	bool HasChildren = false;
 	TreeNode(std::wstring text, std::shared_ptr<BitmapSource> image = nullptr);
 	ID2D1Bitmap* GetImageBitmap(D2DGraphics* render);
 	~TreeNode();
 	/** @brief 展开状态下可渲染的总节点数量（含子树）。 */
 	int UnfoldedCount();
+	/**
+	 * @brief 父节点（加入 Children 或建立行索引时维护）。
+	 *
+	 * 从 Children 移除时不会清除（移除前节点可能已被释放）；移除后继续使用的节点请将 Parent 置为 NULL。
+	 */
+	TreeNode* Parent = NULL;
+private:
+	friend class TreeView;
+	friend class TreeNodeList;
+	friend struct TreeViewRows;
+	bool _expand = false;
+	TreeRowState<TreeNode> _rows;
+	// Children 由 ChildrenLoader 加载（可被 UnloadChildren 释放）
+	bool _lazyLoaded = false;
+	// 正在后台加载
+	std::shared_ptr<TreeNodeLoadJob> _loadJob;
 };
 
+/**
+ * @brief 懒加载回调：根据节点的 Tag/Text 创建子节点并追加到 children。
+ *
+ * 后台加载时在工作线程调用，不能访问控件或树中的其他节点。
+ */
+typedef std::function<void(ULONG64 tag, const std::wstring& text, List<TreeNode*>& children)> TreeNodeChildrenLoader;
+typedef Event<void(class TreeView*, TreeNode*)> TreeNodeChildrenLoadedEvent;
+
 /**
  * @brief TreeView 控件。
  *
@@ -43,6 +107,20 @@ private:
 	float _scrollThumbGrabOffsetY = 0.0f;
 	void UpdateScrollDrag(float posY);
 	void DrawScroll();
+
+	// 下一次同步时丢弃整棵树的行索引
+	bool _rowsReset = true;
+	friend struct TreeViewRows;
+	/** @brief 处理登记的修改，并修补 [firstRow, firstRow + rowCount) 中未经通知的直接修改。 */
+	void SyncRows(int firstRow, int rowCount);
+	TreeNode* RowAt(int row, int& level, bool& placeholder);
+	TreeNode* HitTestNode(int xof, int yof, bool& isHitEx);
+
+	std::vector<std::shared_ptr<TreeNodeLoadJob>> _loadJobs;
+	bool NeedsLoad(TreeNode* node);
+	void LoadChildren(TreeNode* node);
+	void ApplyLoadedChildren();
+	void UnloadSubtree(TreeNode* node, int& released);
 public:
 	virtual UIClass Type();
 	CursorKind QueryCursor(int xof, int yof) override;
@@ -61,6 +139,36 @@ public:
 	D2D1_COLOR_F SelectedForeColor = Colors::White;
 	ScrollChangedEvent ScrollChanged;
 	SelectionChangedEvent SelectionChanged;
+	/** @brief 为 HasChildren 的节点在首次展开时加载子节点。 */
+	TreeNodeChildrenLoader ChildrenLoader;
+	/** @brief 在后台线程调用 ChildrenLoader，加载完成前显示 LoadingText 占位行。 */
+	bool LoadChildrenInBackground = false;
+	std::wstring LoadingText = L"加载中...";
+	/** @brief 节点的子节点加载完成并已挂到树上（在 UI 线程触发；同步加载时在建立行索引的过程中触发，处理函数中不要再修改树结构）。 */
+	TreeNodeChildrenLoadedEvent ChildrenLoaded;
+	/** @brief 展开/收起节点（等同于修改 Expand）。 */
+	void SetExpanded(TreeNode* node, bool expand);
+	/** @brief 未经 TreeNodeList 的方法修改了某个节点的 Children 后调用。 */
+	void RefreshNode(TreeNode* node);
+	/** @brief 大范围修改树结构后调用，下一次绘制时重建整棵树的行索引。 */
+	void InvalidateNodes();
+	/** @brief 可见（展开后）的行数。 */
+	int VisibleNodeCount();
+	/** @brief 第 row 个可见行的节点（越界返回 NULL）。 */
+	TreeNode* NodeAtRow(int row);
+	/** @brief 节点所在的可见行（未展平或被收起时返回 -1）。 */
+	int RowOfNode(TreeNode* node);
+	/** @brief 节点是否正在后台加载子节点。 */
+	bool IsLoading(TreeNode* node);
+	/**
+	 * @brief 释放已收起节点中由 ChildrenLoader 加载的子节点，再次展开时重新加载。
+	 *
+	 * 收起的节点不占后代行，只登记该节点及其父链，不会让本树或其他树整体重建。
+	 * @return 释放的节点数量。
+	 */
+	int UnloadChildren(TreeNode* node);
+	/** @brief 内存紧张时调用：释放整棵树中所有已收起的懒加载子树。 */
+	int UnloadCollapsedChildren();
 	TreeView(int x, int y, int width = 120, int height = 24);
 	~TreeView();
 	void Update() override;
@@ -0,0 +1,234 @@
+#include "VideoFrameQueue.h"
+#include <algorithm>
+#include <cmath>
+
+uint8_t* VideoFrame::Allocate(uint32_t width, uint32_t height, uint32_t stride)
+{
+	ReleaseExternal();
+	const size_t bytes = (size_t)stride * (size_t)height;
+	if (_pixels.capacity() < bytes) _grows++;
+	// resize 不会缩小容量：同尺寸的后续帧不再分配
+	if (_pixels.size() < bytes) _pixels.resize(bytes);
+	Data = _pixels.data();
+	Width = width;
+	Height = height;
+	Stride = stride;
+	return _pixels.data();
+}
+
+void VideoFrame::Attach(const uint8_t* data, uint32_t width, uint32_t height, uint32_t stride, void* owner, ReleaseProc release)
+{
+	ReleaseExternal();
+	Data = data;
+	Width = width;
+	Height = height;
+	Stride = stride;
+	_owner = owner;
+	_release = release;
+}
+
+void VideoFrame::ReleaseExternal()
+{
+	if (_owner && _release) _release(_owner);
+	_owner = nullptr;
+	_release = nullptr;
+	Data = nullptr;
+}
+
+bool VideoFrameQueue::IndexRing::Push(uint32_t index)
+{
+	const size_t tail = Tail.load(std::memory_order_relaxed);
+	if (tail - Head.load(std::memory_order_acquire) >= Items.size()) return false;
+	Items[tail % Items.size()] = index;
+	Tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+bool VideoFrameQueue::IndexRing::Pop(uint32_t& index)
+{
+	const size_t head = Head.load(std::memory_order_relaxed);
+	if (head == Tail.load(std::memory_order_acquire)) return false;
+	index = Items[head % Items.size()];
+	Head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+bool VideoFrameQueue::IndexRing::Peek(uint32_t& index) const
+{
+	const size_t head = Head.load(std::memory_order_relaxed);
+	if (head == Tail.load(std::memory_order_acquire)) return false;
+	index = Items[head % Items.size()];
+	return true;
+}
+
+VideoFrameQueue::VideoFrameQueue(size_t capacity)
+	: _capacity((std::max)(capacity, (size_t)2))
+{
+	_frames.resize(_capacity);
+	_free.Items.resize(_capacity);
+	_ready.Items.resize(_capacity);
+	for (size_t i = 0; i < _capacity; i++)
+		_free.Push((uint32_t)i);
+}
+
+VideoFrameQueue::~VideoFrameQueue()
+{
+	for (auto& frame : _frames)
+		frame.ReleaseExternal();
+}
+
+VideoFrame* VideoFrameQueue::BeginWrite()
+{
+	VideoFrame* frame = _spare;
+	_spare = nullptr;
+	if (!frame)
+	{
+		uint32_t index = 0;
+		if (!_free.Pop(index))
+		{
+			_overruns.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		frame = &_frames[index];
+	}
+	// 记下取帧时的代数：写入期间发生 Flush 的帧提交后也会被当作旧帧
+	frame->_epoch = _epoch.load(std::memory_order_acquire);
+	return frame;
+}
+
+void VideoFrameQueue::CommitWrite(VideoFrame* frame, double pts)
+{
+	if (!frame) return;
+	frame->Pts = pts;
+	frame->Sequence = ++_sequence;
+	if (frame->_grows)
+	{
+		_allocations.fetch_add(frame->_grows, std::memory_order_relaxed);
+		frame->_grows = 0;
+	}
+	if (frame->IsExternal()) _zeroCopy.fetch_add(1, std::memory_order_relaxed);
+	_committed.fetch_add(1, std::memory_order_relaxed);
+	// 就绪环与帧池同容量，不会满
+	_ready.Push((uint32_t)(frame - _frames.data()));
+}
+
+void VideoFrameQueue::CancelWrite(VideoFrame* frame)
+{
+	if (!frame) return;
+	frame->ReleaseExternal();
+	_spare = frame;
+}
+
+void VideoFrameQueue::Flush()
+{
+	_epoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void VideoFrameQueue::Recycle(VideoFrame* frame)
+{
+	frame->ReleaseExternal();
+	_free.Push((uint32_t)(frame - _frames.data()));
+}
+
+const VideoFrame* VideoFrameQueue::AcquireDue(double now, double tolerance)
+{
+	const uint32_t epoch = _epoch.load(std::memory_order_acquire);
+	VideoFrame* chosen = nullptr;
+	uint32_t index = 0;
+	while (_ready.Peek(index))
+	{
+		VideoFrame* frame = &_frames[index];
+		if (frame->_epoch != epoch)
+		{
+			_ready.Pop(index);
+			Recycle(frame);
+			_flushed++;
+			_hasLast = false;
+			continue;
+		}
+		if (frame->Pts > now + tolerance) break;
+		_ready.Pop(index);
+		if (chosen)
+		{
+			Recycle(chosen);
+			_dropped++;
+		}
+		chosen = frame;
+	}
+	if (!chosen) return nullptr;
+
+	_presented++;
+	const double lateness = (now - chosen->Pts) * 1000.0;
+	_latenessSum += lateness;
+	_maxLateness = (_presented == 1) ? lateness : (std::max)(_maxLateness, lateness);
+	if (_hasLast && chosen->Pts > _lastPts)
+	{
+		const double jitter = std::fabs((now - _lastNow) - (chosen->Pts - _lastPts)) * 1000.0;
+		_jitterSum += jitter;
+		_jitterCount++;
+		_maxJitter = (std::max)(_maxJitter, jitter);
+	}
+	_hasLast = true;
+	_lastNow = now;
+	_lastPts = chosen->Pts;
+	return chosen;
+}
+
+void VideoFrameQueue::Release(const VideoFrame* frame)
+{
+	if (!frame) return;
+	Recycle(const_cast<VideoFrame*>(frame));
+}
+
+bool VideoFrameQueue::HasPending() const
+{
+	return !_ready.Empty();
+}
+
+void VideoFrameQueue::Reset()
+{
+	for (auto& frame : _frames)
+		frame.ReleaseExternal();
+	_spare = nullptr;
+	_free.Head.store(0, std::memory_order_relaxed);
+	_free.Tail.store(0, std::memory_order_relaxed);
+	_ready.Head.store(0, std::memory_order_relaxed);
+	_ready.Tail.store(0, std::memory_order_relaxed);
+	for (size_t i = 0; i < _capacity; i++)
+		_free.Push((uint32_t)i);
+	_hasLast = false;
+}
+
+VideoFrameQueue::Stats VideoFrameQueue::GetStats() const
+{
+	Stats s;
+	s.Committed = _committed.load(std::memory_order_relaxed);
+	s.Presented = _presented;
+	s.Dropped = _dropped;
+	s.Overruns = _overruns.load(std::memory_order_relaxed);
+	s.Flushed = _flushed;
+	s.ZeroCopy = _zeroCopy.load(std::memory_order_relaxed);
+	s.Allocations = _allocations.load(std::memory_order_relaxed);
+	s.AverageLateness = _presented ? _latenessSum / (double)_presented : 0.0;
+	s.MaxLateness = _maxLateness;
+	s.AverageJitter = _jitterCount ? _jitterSum / (double)_jitterCount : 0.0;
+	s.MaxJitter = _maxJitter;
+	return s;
+}
+
+void VideoFrameQueue::ResetStats()
+{
+	_committed.store(0, std::memory_order_relaxed);
+	_overruns.store(0, std::memory_order_relaxed);
+	_zeroCopy.store(0, std::memory_order_relaxed);
+	_allocations.store(0, std::memory_order_relaxed);
+	_presented = 0;
+	_dropped = 0;
+	_flushed = 0;
+	_latenessSum = 0.0;
+	_maxLateness = 0.0;
+	_jitterSum = 0.0;
+	_jitterCount = 0;
+	_maxJitter = 0.0;
+	_hasLast = false;
+}
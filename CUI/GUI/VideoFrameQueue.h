@@ -0,0 +1,174 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file VideoFrameQueue.h
+ * @brief VideoFrameQueue：固定大小的视频帧池 + 无锁单生产者/单消费者队列（带呈现时间戳）。
+ *
+ * 不依赖 Win32/Media Foundation，可单独编译测试。MediaPlayer 的解码线程（或 SampleGrabber 回调）
+ * 是唯一生产者，UI 线程的 Update 是唯一消费者：
+ * - 生产者：BeginWrite 取空闲帧 → 写入像素（Allocate）或直接挂接解码缓冲（Attach，零拷贝）→ CommitWrite(pts)
+ * - 消费者：AcquireDue(now) 取出“到期”的最新一帧，更早的到期帧按迟到丢弃；上传后 Release 归还
+ *
+ * 空闲帧与就绪帧各用一个 SPSC 环形索引队列传递，两端都不加锁。帧缓冲只在尺寸变大时重新分配，
+ * 稳态播放每帧零堆分配。池满时生产者丢弃新帧（不阻塞解码线程，音频照常）。
+ *
+ * 时间戳与 now 由调用方给出（秒，同一单调时钟）；统计中的时间单位为毫秒。
+ */
+
+/** @brief 池中的一帧（BGRA32）。 */
+struct VideoFrame
+{
+	/** @brief 挂接的外部缓冲在帧回收时通过它释放（例如解锁并释放 IMFMediaBuffer）。 */
+	typedef void (*ReleaseProc)(void* owner);
+
+	/** @brief 像素起点（指向 Pixels 或挂接的外部缓冲）。 */
+	const uint8_t* Data = nullptr;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	/** @brief 行步长（字节），可大于 Width*4。 */
+	uint32_t Stride = 0;
+	/** @brief 呈现时间（秒）。 */
+	double Pts = 0.0;
+	/** @brief 提交序号（从 1 开始递增）。 */
+	uint64_t Sequence = 0;
+
+	/**
+	 * @brief 使用池内缓冲：返回可写入 height*stride 字节的指针。
+	 *
+	 * 缓冲只增不减；只有需要变大时才分配。
+	 */
+	uint8_t* Allocate(uint32_t width, uint32_t height, uint32_t stride);
+	/** @brief 零拷贝挂接外部缓冲；owner 在帧回收（或被覆盖）时交给 release。 */
+	void Attach(const uint8_t* data, uint32_t width, uint32_t height, uint32_t stride, void* owner, ReleaseProc release);
+	bool IsExternal() const { return _owner != nullptr; }
+
+private:
+	friend class VideoFrameQueue;
+	void ReleaseExternal();
+
+	std::vector<uint8_t> _pixels;
+	void* _owner = nullptr;
+	ReleaseProc _release = nullptr;
+	uint32_t _epoch = 0;
+	/** @brief Allocate 导致的缓冲增长次数（由生产者累加到统计）。 */
+	size_t _grows = 0;
+};
+
+class VideoFrameQueue
+{
+public:
+	struct Stats
+	{
+		/** @brief 提交的帧数。 */
+		size_t Committed = 0;
+		/** @brief 交给渲染的帧数。 */
+		size_t Presented = 0;
+		/** @brief 被更新的到期帧取代而丢弃（迟到）的帧数。 */
+		size_t Dropped = 0;
+		/** @brief 池满、生产者丢弃的帧数。 */
+		size_t Overruns = 0;
+		/** @brief Flush 之后丢弃的旧帧数。 */
+		size_t Flushed = 0;
+		/** @brief 零拷贝挂接的帧数。 */
+		size_t ZeroCopy = 0;
+		/** @brief 帧缓冲分配次数（稳态应不再增长）。 */
+		size_t Allocations = 0;
+		/** @brief 取出时相对呈现时间的偏差（取出时刻 - Pts，毫秒；负数表示提前）。 */
+		double AverageLateness = 0.0;
+		double MaxLateness = 0.0;
+		/** @brief 抖动：相邻两次呈现的间隔与其时间戳间隔之差的绝对值（毫秒）。 */
+		double AverageJitter = 0.0;
+		double MaxJitter = 0.0;
+	};
+
+	static const size_t DefaultCapacity = 4;
+
+	explicit VideoFrameQueue(size_t capacity = DefaultCapacity);
+	~VideoFrameQueue();
+	VideoFrameQueue(const VideoFrameQueue&) = delete;
+	VideoFrameQueue& operator=(const VideoFrameQueue&) = delete;
+
+	size_t Capacity() const { return _capacity; }
+
+	// ===== 生产者 =====
+	/** @brief 取一个空闲帧；池满时返回 nullptr（计入 Overruns）。 */
+	VideoFrame* BeginWrite();
+	/** @brief 提交已写好的帧。 */
+	void CommitWrite(VideoFrame* frame, double pts);
+	/** @brief 放弃已取出的帧（例如转换失败），留给下一次 BeginWrite。 */
+	void CancelWrite(VideoFrame* frame);
+	/**
+	 * @brief 作废此前提交的帧（Seek/换片/停止）。
+	 *
+	 * 任意线程可调用；旧帧由消费者在下一次 AcquireDue 时回收。
+	 */
+	void Flush();
+
+	// ===== 消费者 =====
+	/**
+	 * @brief 取出 Pts <= now + tolerance 的最新一帧；更早的到期帧计为迟到丢弃。
+	 * @return 没有到期帧时返回 nullptr；否则使用完后必须 Release。
+	 */
+	const VideoFrame* AcquireDue(double now, double tolerance = 0.0);
+	void Release(const VideoFrame* frame);
+	/** @brief 队列中还有未取出的帧（调用方可据此在下一刷新周期再检查）。 */
+	bool HasPending() const;
+	/**
+	 * @brief 回收全部帧并释放挂接的外部缓冲。
+	 *
+	 * 只能在没有生产者在写、消费者未持有帧时调用（例如播放线程已停止）。
+	 */
+	void Reset();
+
+	/** @brief 统计（在消费者线程读取）。 */
+	Stats GetStats() const;
+	void ResetStats();
+
+private:
+	// 容量固定的 SPSC 索引环：head 只由消费端写，tail 只由生产端写
+	struct IndexRing
+	{
+		std::vector<uint32_t> Items;
+		std::atomic<size_t> Head{ 0 };
+		std::atomic<size_t> Tail{ 0 };
+		bool Push(uint32_t index);
+		bool Pop(uint32_t& index);
+		bool Peek(uint32_t& index) const;
+		bool Empty() const { return Head.load(std::memory_order_acquire) == Tail.load(std::memory_order_acquire); }
+	};
+
+	void Recycle(VideoFrame* frame);
+
+	size_t _capacity;
+	std::vector<VideoFrame> _frames;
+	/** @brief 空闲帧：消费者归还，生产者取用。 */
+	IndexRing _free;
+	/** @brief 就绪帧：生产者提交，消费者取用。 */
+	IndexRing _ready;
+	/** @brief 生产者取出又放弃的帧（只由生产者访问）。 */
+	VideoFrame* _spare = nullptr;
+	std::atomic<uint32_t> _epoch{ 0 };
+	uint64_t _sequence = 0;
+
+	// 生产者侧统计
+	std::atomic<size_t> _committed{ 0 };
+	std::atomic<size_t> _overruns{ 0 };
+	std::atomic<size_t> _zeroCopy{ 0 };
+	std::atomic<size_t> _allocations{ 0 };
+	// 消费者侧统计
+	size_t _presented = 0;
+	size_t _dropped = 0;
+	size_t _flushed = 0;
+	double _latenessSum = 0.0;
+	double _maxLateness = 0.0;
+	double _jitterSum = 0.0;
+	size_t _jitterCount = 0;
+	double _maxJitter = 0.0;
+	bool _hasLast = false;
+	double _lastNow = 0.0;
+	double _lastPts = 0.0;
+};
@@ -0,0 +1,904 @@
+#include "WsolaTimeStretch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define WSOLA_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define WSOLA_X86 0
+#endif
+
+#if WSOLA_X86 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define WSOLA_SSE2 1
+#else
+#define WSOLA_SSE2 0
+#endif
+
+// MSVC 不需要 /arch:AVX2 即可使用 AVX2 内建函数；GCC/Clang 需要按函数开启
+#if WSOLA_X86 && (defined(__GNUC__) || defined(__clang__))
+#define WSOLA_AVX2 1
+#define WSOLA_TARGET_AVX2 __attribute__((target("avx2")))
+#elif WSOLA_X86 && defined(_MSC_VER)
+#define WSOLA_AVX2 1
+#define WSOLA_TARGET_AVX2
+#else
+#define WSOLA_AVX2 0
+#define WSOLA_TARGET_AVX2
+#endif
+
+namespace {
+
+// FFT 搜索的相对开销系数：Direct 的乘加次数（按 SIMD 宽度折算）超过 系数 * M*log2(M) 时改用 FFT。
+// 按 AVX2 在 44.1k 单声道到 192k 8 声道上的实测标定：44.1k 单声道两者持平，声道/采样率越高 FFT 越占优。
+constexpr double FFT_COST_FACTOR = 2.0;
+
+float DotScalar(const float* a, const float* b, size_t n)
+{
+	float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		s0 += a[i] * b[i];
+		s1 += a[i + 1] * b[i + 1];
+		s2 += a[i + 2] * b[i + 2];
+		s3 += a[i + 3] * b[i + 3];
+	}
+	for (; i < n; i++)
+		s0 += a[i] * b[i];
+	return (s0 + s1) + (s2 + s3);
+}
+
+#if WSOLA_X86
+inline float HorizontalSum(__m128 v)
+{
+	const __m128 hi = _mm_movehl_ps(v, v);
+	const __m128 s = _mm_add_ps(v, hi);
+	return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+}
+#endif
+
+#if WSOLA_SSE2
+float DotSse2(const float* a, const float* b, size_t n)
+{
+	// 4 组累加器，隐藏加法延迟
+	__m128 acc0 = _mm_setzero_ps();
+	__m128 acc1 = _mm_setzero_ps();
+	__m128 acc2 = _mm_setzero_ps();
+	__m128 acc3 = _mm_setzero_ps();
+	size_t i = 0;
+	for (; i + 16 <= n; i += 16)
+	{
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+		acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(a + i + 8), _mm_loadu_ps(b + i + 8)));
+		acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(a + i + 12), _mm_loadu_ps(b + i + 12)));
+	}
+	for (; i + 4 <= n; i += 4)
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+	float s = HorizontalSum(_mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+	for (; i < n; i++)
+		s += a[i] * b[i];
+	return s;
+}
+#endif
+
+#if WSOLA_AVX2
+// 不用 FMA：部分 AVX2 目标（以及 MSVC 未开 /arch 时）不保证可用，乘加分开的吞吐已足够
+WSOLA_TARGET_AVX2 float DotAvx2(const float* a, const float* b, size_t n)
+{
+	__m256 acc0 = _mm256_setzero_ps();
+	__m256 acc1 = _mm256_setzero_ps();
+	__m256 acc2 = _mm256_setzero_ps();
+	__m256 acc3 = _mm256_setzero_ps();
+	size_t i = 0;
+	for (; i + 32 <= n; i += 32)
+	{
+		acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+		acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+		acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16)));
+		acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24)));
+	}
+	for (; i + 8 <= n; i += 8)
+		acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+	const __m256 acc = _mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3));
+	float s = HorizontalSum(_mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1)));
+	for (; i < n; i++)
+		s += a[i] * b[i];
+	return s;
+}
+#endif
+
+bool DetectAvx2()
+{
+#if !WSOLA_AVX2
+	return false;
+#elif defined(_MSC_VER)
+	int info[4] = {};
+	__cpuid(info, 0);
+	if (info[0] < 7) return false;
+	__cpuid(info, 1);
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	// 操作系统需要保存 YMM 状态（XCR0 的 bit 1、2）
+	if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+inline float ClampTempo(float tempo)
+{
+	if (!(tempo > 0.0f)) return 1.0f;
+	return std::clamp(tempo, 0.25f, 4.0f);
+}
+
+inline size_t Lanes(WsolaKernel kernel)
+{
+	switch (kernel)
+	{
+	case WsolaKernel::Sse2: return 4;
+	case WsolaKernel::Avx2: return 8;
+	default: return 1;
+	}
+}
+
+// 基 2 FFT，re/im 分离存储，不做 1/n 缩放，不做位反转重排：
+// - 正变换 FftDif（频域抽取）：自然顺序输入 → 位反转顺序输出
+// - FftDit（时域抽取）：位反转顺序输入 → 自然顺序输出；逆变换用 IFFT(x) = swap(FFT(swap(x)))，交换 re/im 调用即可
+// 频域的逐点运算与顺序无关，两次变换之间不需要重排（重排在 32K 点时占一半耗时）。
+// twiddle 按级连续存放：半长 h 的一级从下标 h-1 开始，共 h 个 exp(-iπk/h)；每级内层是连续访问，
+// 按 kernel 用 SSE2/AVX2 一次做 4/8 个蝶形。
+
+// DIT 蝶形：(a, b) → (a + w*b, a - w*b)
+void DitPassScalar(float* re, float* im, size_t n, size_t half, const float* wr, const float* wi)
+{
+	for (size_t block = 0; block < n; block += half * 2)
+	{
+		float* r0 = re + block;
+		float* i0 = im + block;
+		float* r1 = r0 + half;
+		float* i1 = i0 + half;
+		for (size_t k = 0; k < half; k++)
+		{
+			const float vr = r1[k] * wr[k] - i1[k] * wi[k];
+			const float vi = r1[k] * wi[k] + i1[k] * wr[k];
+			r1[k] = r0[k] - vr;
+			i1[k] = i0[k] - vi;
+			r0[k] += vr;
+			i0[k] += vi;
+		}
+	}
+}
+
+// DIF 蝶形：(a, b) → (a + b, (a - b) * w)
+void DifPassScalar(float* re, float* im, size_t n, size_t half, const float* wr, const float* wi)
+{
+	for (size_t block = 0; block < n; block += half * 2)
+	{
+		float* r0 = re + block;
+		float* i0 = im + block;
+		float* r1 = r0 + half;
+		float* i1 = i0 + half;
+		for (size_t k = 0; k < half; k++)
+		{
+			const float dr = r0[k] - r1[k];
+			const float di = i0[k] - i1[k];
+			r0[k] += r1[k];
+			i0[k] += i1[k];
+			r1[k] = dr * wr[k] - di * wi[k];
+			i1[k] = dr * wi[k] + di * wr[k];
+		}
+	}
+}
+
+#if WSOLA_SSE2
+// half 为 4 的倍数
+void DitPassSse2(float* re, float* im, size_t n, size_t half, const float* wr, const float* wi)
+{
+	for (size_t block = 0; block < n; block += half * 2)
+	{
+		float* r0 = re + block;
+		float* i0 = im + block;
+		float* r1 = r0 + half;
+		float* i1 = i0 + half;
+		for (size_t k = 0; k < half; k += 4)
+		{
+			const __m128 xr = _mm_loadu_ps(r1 + k), xi = _mm_loadu_ps(i1 + k);
+			const __m128 cr = _mm_loadu_ps(wr + k), ci = _mm_loadu_ps(wi + k);
+			const __m128 vr = _mm_sub_ps(_mm_mul_ps(xr, cr), _mm_mul_ps(xi, ci));
+			const __m128 vi = _mm_add_ps(_mm_mul_ps(xr, ci), _mm_mul_ps(xi, cr));
+			const __m128 ur = _mm_loadu_ps(r0 + k), ui = _mm_loadu_ps(i0 + k);
+			_mm_storeu_ps(r1 + k, _mm_sub_ps(ur, vr));
+			_mm_storeu_ps(i1 + k, _mm_sub_ps(ui, vi));
+			_mm_storeu_ps(r0 + k, _mm_add_ps(ur, vr));
+			_mm_storeu_ps(i0 + k, _mm_add_ps(ui, vi));
+		}
+	}
+}
+
+void DifPassSse2(float* re, float* im, size_t n, size_t half, const float* wr, const float* wi)
+{
+	for (size_t block = 0; block < n; block += half * 2)
+	{
+		float* r0 = re + block;
+		float* i0 = im + block;
+		float* r1 = r0 + half;
+		float* i1 = i0 + half;
+		for (size_t k = 0; k < half; k += 4)
+		{
+			const __m128 ar = _mm_loadu_ps(r0 + k), ai = _mm_loadu_ps(i0 + k);
+			const __m128 br = _mm_loadu_ps(r1 + k), bi = _mm_loadu_ps(i1 + k);
+			const __m128 cr = _mm_loadu_ps(wr + k), ci = _mm_loadu_ps(wi + k);
+			const __m128 dr = _mm_sub_ps(ar, br), di = _mm_sub_ps(ai, bi);
+			_mm_storeu_ps(r0 + k, _mm_add_ps(ar, br));
+			_mm_storeu_ps(i0 + k, _mm_add_ps(ai, bi));
+			_mm_storeu_ps(r1 + k, _mm_sub_ps(_mm_mul_ps(dr, cr), _mm_mul_ps(di, ci)));
+			_mm_storeu_ps(i1 + k, _mm_add_ps(_mm_mul_ps(dr, ci), _mm_mul_ps(di, cr)));
+		}
+	}
+}
+#endif
+
+#if WSOLA_AVX2
+// half 为 8 的倍数
+WSOLA_TARGET_AVX2 void DitPassAvx2(float* re, float* im, size_t n, size_t half, const float* wr, const float* wi)
+{
+	for (size_t block = 0; block < n; block += half * 2)
+	{
+		float* r0 = re + block;
+		float* i0 = im + block;
+		float* r1 = r0 + half;
+		float* i1 = i0 + half;
+		for (size_t k = 0; k < half; k += 8)
+		{
+			const __m256 xr = _mm256_loadu_ps(r1 + k), xi = _mm256_loadu_ps(i1 + k);
+			const __m256 cr = _mm256_loadu_ps(wr + k), ci = _mm256_loadu_ps(wi + k);
+			const __m256 vr = _mm256_sub_ps(_mm256_mul_ps(xr, cr), _mm256_mul_ps(xi, ci));
+			const __m256 vi = _mm256_add_ps(_mm256_mul_ps(xr, ci), _mm256_mul_ps(xi, cr));
+			const __m256 ur = _mm256_loadu_ps(r0 + k), ui = _mm256_loadu_ps(i0 + k);
+			_mm256_storeu_ps(r1 + k, _mm256_sub_ps(ur, vr));
+			_mm256_storeu_ps(i1 + k, _mm256_sub_ps(ui, vi));
+			_mm256_storeu_ps(r0 + k, _mm256_add_ps(ur, vr));
+			_mm256_storeu_ps(i0 + k, _mm256_add_ps(ui, vi));
+		}
+	}
+}
+
+WSOLA_TARGET_AVX2 void DifPassAvx2(float* re, float* im, size_t n, size_t half, const float* wr, const float* wi)
+{
+	for (size_t block = 0; block < n; block += half * 2)
+	{
+		float* r0 = re + block;
+		float* i0 = im + block;
+		float* r1 = r0 + half;
+		float* i1 = i0 + half;
+		for (size_t k = 0; k < half; k += 8)
+		{
+			const __m256 ar = _mm256_loadu_ps(r0 + k), ai = _mm256_loadu_ps(i0 + k);
+			const __m256 br = _mm256_loadu_ps(r1 + k), bi = _mm256_loadu_ps(i1 + k);
+			const __m256 cr = _mm256_loadu_ps(wr + k), ci = _mm256_loadu_ps(wi + k);
+			const __m256 dr = _mm256_sub_ps(ar, br), di = _mm256_sub_ps(ai, bi);
+			_mm256_storeu_ps(r0 + k, _mm256_add_ps(ar, br));
+			_mm256_storeu_ps(i0 + k, _mm256_add_ps(ai, bi));
+			_mm256_storeu_ps(r1 + k, _mm256_sub_ps(_mm256_mul_ps(dr, cr), _mm256_mul_ps(di, ci)));
+			_mm256_storeu_ps(i1 + k, _mm256_add_ps(_mm256_mul_ps(dr, ci), _mm256_mul_ps(di, cr)));
+		}
+	}
+}
+#endif
+
+void FftDif(float* re, float* im, size_t n, const float* twRe, const float* twIm, WsolaKernel kernel)
+{
+	for (size_t half = n >> 1; half >= 1; half >>= 1)
+	{
+		const float* wr = twRe + half - 1;
+		const float* wi = twIm + half - 1;
+#if WSOLA_AVX2
+		if (kernel == WsolaKernel::Avx2 && half >= 8)
+		{
+			DifPassAvx2(re, im, n, half, wr, wi);
+			continue;
+		}
+#endif
+#if WSOLA_SSE2
+		if (kernel != WsolaKernel::Scalar && half >= 4)
+		{
+			DifPassSse2(re, im, n, half, wr, wi);
+			continue;
+		}
+#endif
+		DifPassScalar(re, im, n, half, wr, wi);
+	}
+	(void)kernel;
+}
+
+void FftDit(float* re, float* im, size_t n, const float* twRe, const float* twIm, WsolaKernel kernel)
+{
+	for (size_t half = 1; half < n; half <<= 1)
+	{
+		const float* wr = twRe + half - 1;
+		const float* wi = twIm + half - 1;
+#if WSOLA_AVX2
+		if (kernel == WsolaKernel::Avx2 && half >= 8)
+		{
+			DitPassAvx2(re, im, n, half, wr, wi);
+			continue;
+		}
+#endif
+#if WSOLA_SSE2
+		if (kernel != WsolaKernel::Scalar && half >= 4)
+		{
+			DitPassSse2(re, im, n, half, wr, wi);
+			continue;
+		}
+#endif
+		DitPassScalar(re, im, n, half, wr, wi);
+	}
+	(void)kernel;
+}
+
+} // namespace
+
+WsolaKernel WsolaTimeStretch::BestKernel()
+{
+	static const WsolaKernel best = DetectAvx2() ? WsolaKernel::Avx2 : (WSOLA_SSE2 ? WsolaKernel::Sse2 : WsolaKernel::Scalar);
+	return best;
+}
+
+bool WsolaTimeStretch::IsKernelSupported(WsolaKernel kernel)
+{
+	switch (kernel)
+	{
+	case WsolaKernel::Scalar:
+		return true;
+	case WsolaKernel::Sse2:
+		return WSOLA_SSE2 != 0;
+	case WsolaKernel::Avx2:
+		return BestKernel() == WsolaKernel::Avx2;
+	}
+	return false;
+}
+
+const wchar_t* WsolaTimeStretch::KernelName(WsolaKernel kernel)
+{
+	switch (kernel)
+	{
+	case WsolaKernel::Scalar: return L"Scalar";
+	case WsolaKernel::Sse2: return L"SSE2";
+	case WsolaKernel::Avx2: return L"AVX2";
+	}
+	return L"?";
+}
+
+const wchar_t* WsolaTimeStretch::SearchName(WsolaSearch search)
+{
+	switch (search)
+	{
+	case WsolaSearch::Reference: return L"Reference";
+	case WsolaSearch::Direct: return L"Direct";
+	case WsolaSearch::Fft: return L"FFT";
+	case WsolaSearch::Auto: return L"Auto";
+	}
+	return L"?";
+}
+
+double WsolaTimeStretch::Ncc(const float* a, const float* b, size_t samples)
+{
+	double dot = 0.0, ea = 0.0, eb = 0.0;
+	for (size_t i = 0; i < samples; i++)
+	{
+		dot += (double)a[i] * (double)b[i];
+		ea += (double)a[i] * (double)a[i];
+		eb += (double)b[i] * (double)b[i];
+	}
+	return dot / (std::sqrt(ea * eb) + 1e-12);
+}
+
+WsolaTimeStretch::WsolaTimeStretch(uint32_t sampleRate, uint32_t channels, bool isFloat, uint32_t bitsPerSample,
+	WsolaSearch search, WsolaKernel kernel)
+	: _sampleRate(sampleRate), _channels(channels), _isFloat(isFloat), _bitsPerSample(bitsPerSample),
+	_search(search), _kernel(kernel)
+{
+	if (!IsKernelSupported(_kernel)) _kernel = BestKernel();
+	_dot = &DotScalar;
+#if WSOLA_SSE2
+	if (_kernel == WsolaKernel::Sse2) _dot = &DotSse2;
+#endif
+#if WSOLA_AVX2
+	if (_kernel == WsolaKernel::Avx2) _dot = &DotAvx2;
+#endif
+	Configure(sampleRate, channels);
+}
+
+void WsolaTimeStretch::Configure(uint32_t sampleRate, uint32_t channels)
+{
+	_sampleRate = sampleRate;
+	_channels = channels;
+	// 典型 WSOLA 参数：20ms 窗，10ms overlap，10ms search
+	_windowFrames = (uint32_t)std::clamp((int)std::lround((double)sampleRate * 0.020), 256, 4096);
+	_overlapFrames = (uint32_t)std::clamp((int)std::lround((double)sampleRate * 0.010), 128, (int)_windowFrames / 2);
+	_searchFrames = (uint32_t)std::clamp((int)std::lround((double)sampleRate * 0.010), 64, (int)_windowFrames);
+	_hopOutFrames = _windowFrames - _overlapFrames;
+	_hopIn = (double)_hopOutFrames * (double)_tempo;
+
+	// Raised-cosine crossfade（比线性更不容易产生撕裂/毛刺）
+	_fade.resize(_overlapFrames);
+	for (uint32_t i = 0; i < _overlapFrames; i++)
+	{
+		float w = 1.0f;
+		if (_overlapFrames > 1)
+		{
+			const float x = (float)i / (float)(_overlapFrames - 1);
+			w = 0.5f - 0.5f * std::cos(3.14159265358979323846f * x);
+		}
+		_fade[i] = w;
+	}
+	Reset();
+}
+
+void WsolaTimeStretch::Reset()
+{
+	_in.clear();
+	_baseFrame = 0;
+	_nextPos = 0.0;
+	_nextPredFrame = 0;
+	_hasTail = false;
+	_tail.clear();
+	_out.clear();
+}
+
+void WsolaTimeStretch::SetTempo(float tempo)
+{
+	_tempo = ClampTempo(tempo);
+	_hopIn = (double)_hopOutFrames * (double)_tempo;
+}
+
+bool WsolaTimeStretch::ProcessChunk(const void* inData, size_t inBytes, float tempo, float volume, std::vector<uint8_t>& outBytes)
+{
+	outBytes.clear();
+	if (!inData || inBytes == 0 || _channels == 0) return true;
+	SetTempo(tempo);
+
+	// bytes -> float frames
+	_tmpInFloat.clear();
+	if (!BytesToFloat(inData, inBytes, _channels, _bitsPerSample, _isFloat, _tmpInFloat))
+		return false;
+	const size_t inFrames = _tmpInFloat.size() / _channels;
+	if (inFrames == 0) return true;
+	AppendInput(_tmpInFloat.data(), inFrames);
+
+	// 生成输出（float）
+	Generate();
+	if (_out.empty()) return true;
+
+	// 音量（float域）
+	if (volume < 0.999f)
+	{
+		volume = std::clamp(volume, 0.0f, 1.0f);
+		for (float& v : _out)
+			v *= volume;
+	}
+
+	// float -> bytes：直接写入调用方的缓冲（调用方复用时容量保留，稳态不分配）
+	FloatToBytes(_out.data(), _out.size() / _channels, _channels, _bitsPerSample, _isFloat, outBytes);
+	_out.clear();
+	return true;
+}
+
+void WsolaTimeStretch::ProcessFloat(const float* frames, size_t frameCount, float tempo, std::vector<float>& out)
+{
+	if (!frames || frameCount == 0 || _channels == 0) return;
+	SetTempo(tempo);
+	AppendInput(frames, frameCount);
+	Generate();
+	out.insert(out.end(), _out.begin(), _out.end());
+	_out.clear();
+}
+
+bool WsolaTimeStretch::BytesToFloat(const void* data, size_t bytes, uint32_t channels, uint32_t bits, bool isFloat, std::vector<float>& out)
+{
+	const size_t bps = bits / 8;
+	if (bps == 0) return false;
+	const size_t frameBytes = bps * (size_t)channels;
+	if (frameBytes == 0) return false;
+	const size_t frames = bytes / frameBytes;
+	if (frames == 0) return true;
+	out.resize(frames * (size_t)channels);
+
+	const uint8_t* p = (const uint8_t*)data;
+	if (bits == 32 && isFloat)
+	{
+		memcpy(out.data(), p, frames * (size_t)channels * sizeof(float));
+		return true;
+	}
+	if (bits == 16)
+	{
+		const int16_t* s = (const int16_t*)p;
+		for (size_t i = 0; i < frames * (size_t)channels; i++)
+			out[i] = (float)s[i] / 32768.0f;
+		return true;
+	}
+	if (bits == 32 && !isFloat)
+	{
+		const int32_t* s = (const int32_t*)p;
+		for (size_t i = 0; i < frames * (size_t)channels; i++)
+			out[i] = (float)((double)s[i] / 2147483648.0);
+		return true;
+	}
+	return false;
+}
+
+void WsolaTimeStretch::FloatToBytes(const float* in, size_t frames, uint32_t channels, uint32_t bits, bool isFloat, std::vector<uint8_t>& out)
+{
+	const size_t total = frames * (size_t)channels;
+	if (bits == 32 && isFloat)
+	{
+		out.resize(total * sizeof(float));
+		memcpy(out.data(), in, out.size());
+		return;
+	}
+	if (bits == 16)
+	{
+		out.resize(total * sizeof(int16_t));
+		auto* d = (int16_t*)out.data();
+		for (size_t i = 0; i < total; i++)
+		{
+			float v = std::clamp(in[i], -1.0f, 1.0f);
+			int iv = (int)std::lround(v * 32767.0f);
+			d[i] = (int16_t)std::clamp(iv, -32768, 32767);
+		}
+		return;
+	}
+	if (bits == 32)
+	{
+		// 与 BytesToFloat 对称（以前这里会输出静音）
+		out.resize(total * sizeof(int32_t));
+		auto* d = (int32_t*)out.data();
+		for (size_t i = 0; i < total; i++)
+		{
+			const double v = (double)std::clamp(in[i], -1.0f, 1.0f) * 2147483648.0;
+			d[i] = (int32_t)std::clamp(v, -2147483648.0, 2147483647.0);
+		}
+		return;
+	}
+	// fallback：直接静音输出
+	out.assign(total * (bits / 8), 0);
+}
+
+void WsolaTimeStretch::AppendInput(const float* frames, size_t frameCount)
+{
+	const size_t old = _in.size();
+	_in.resize(old + frameCount * (size_t)_channels);
+	memcpy(_in.data() + old, frames, frameCount * (size_t)_channels * sizeof(float));
+}
+
+// 搜索与 tail 最匹配的候选起点
+size_t WsolaTimeStretch::FindBestStart(size_t predStartAbs)
+{
+	if (!_hasTail || _overlapFrames == 0) return predStartAbs;
+	const size_t availAbsEnd = _baseFrame + AvailableFrames();
+	if (availAbsEnd <= _baseFrame + _windowFrames) return predStartAbs;
+	const size_t maxStart = availAbsEnd - _windowFrames;
+
+	size_t startMin = (predStartAbs > _searchFrames) ? (predStartAbs - _searchFrames) : _baseFrame;
+	if (startMin < _baseFrame) startMin = _baseFrame;
+	size_t startMax = predStartAbs + _searchFrames;
+	if (startMax > maxStart) startMax = maxStart;
+	if (startMin > startMax) startMin = startMax;
+
+	const size_t best = startMin + FindBestOffset(_tail.data(), FramePtrAbs(startMin), startMax - startMin + 1);
+	_stats.Joins++;
+	_stats.JoinScoreSum += Ncc(_tail.data(), FramePtrAbs(best), (size_t)_overlapFrames * _channels);
+	return best;
+}
+
+size_t WsolaTimeStretch::FindBestOffset(const float* tail, const float* region, size_t candidates)
+{
+	if (!tail || !region || candidates <= 1 || _overlapFrames == 0 || _channels == 0) return 0;
+	_stats.Candidates += candidates;
+	switch (_search)
+	{
+	case WsolaSearch::Reference:
+		return SearchReference(tail, region, candidates);
+	case WsolaSearch::Direct:
+		return SearchDirect(tail, region, candidates);
+	case WsolaSearch::Fft:
+		return SearchFft(tail, region, candidates);
+	case WsolaSearch::Auto:
+		break;
+	}
+	return PreferFft(candidates) ? SearchFft(tail, region, candidates) : SearchDirect(tail, region, candidates);
+}
+
+size_t WsolaTimeStretch::SearchReference(const float* tail, const float* region, size_t candidates) const
+{
+	// 归一化相关（NCC）比简单点积更稳，能显著降低撕裂感；并用 coarse-to-fine 降低 CPU。
+	const uint32_t overlap = _overlapFrames;
+	const uint32_t chs = _channels;
+	const size_t strideSamples = (size_t)chs;
+	const size_t last = candidates - 1;
+
+	// 采样步长：overlap 越大越稀疏（降低运算量），但保留足够判别力。
+	const uint32_t iStep = (overlap >= 1024) ? 4u : (overlap >= 512 ? 2u : 1u);
+	const size_t sCoarseStep = (overlap >= 512) ? 2u : 1u;
+
+	auto nccScore = [&](size_t offset, uint32_t localIStep) -> double
+	{
+		double dot = 0.0;
+		double ea = 0.0;
+		double eb = 0.0;
+		for (uint32_t i = 0; i < overlap; i += localIStep)
+		{
+			const float* a = tail + (size_t)i * strideSamples;
+			const float* b = region + (offset + i) * strideSamples;
+			for (uint32_t c = 0; c < chs; c++)
+			{
+				double av = (double)a[c];
+				double bv = (double)b[c];
+				dot += av * bv;
+				ea += av * av;
+				eb += bv * bv;
+			}
+		}
+		const double denom = std::sqrt(ea * eb) + 1e-12;
+		return dot / denom;
+	};
+
+	double bestScore = -1e300;
+	size_t best = 0;
+	for (size_t s = 0; s <= last; s += sCoarseStep)
+	{
+		double score = nccScore(s, iStep);
+		if (score > bestScore)
+		{
+			bestScore = score;
+			best = s;
+		}
+		if (s + sCoarseStep >= last) break;
+	}
+
+	// 精细搜索：在 coarse 最优点附近用更密集采样再对齐一次。
+	const size_t refineRadius = (size_t)(std::min)(8u, overlap / 8u + 1u);
+	const size_t r0 = (best > refineRadius) ? (best - refineRadius) : 0;
+	const size_t r1 = (std::min)(best + refineRadius, last);
+	bestScore = -1e300;
+	for (size_t s = r0; s <= r1; s++)
+	{
+		double score = nccScore(s, 1u);
+		if (score > bestScore)
+		{
+			bestScore = score;
+			best = s;
+		}
+	}
+	return best;
+}
+
+void WsolaTimeStretch::BuildEnergyPrefix(const float* region, size_t frames)
+{
+	_energy.resize(frames + 1);
+	double sum = 0.0;
+	_energy[0] = 0.0;
+	for (size_t f = 0; f < frames; f++)
+	{
+		const float* p = region + f * (size_t)_channels;
+		double e = 0.0;
+		for (uint32_t c = 0; c < _channels; c++)
+			e += (double)p[c] * (double)p[c];
+		sum += e;
+		_energy[f + 1] = sum;
+	}
+}
+
+size_t WsolaTimeStretch::SearchDirect(const float* tail, const float* region, size_t candidates)
+{
+	const size_t samples = (size_t)_overlapFrames * _channels;
+	BuildEnergyPrefix(region, candidates - 1 + _overlapFrames);
+	const double ea = (double)_dot(tail, tail, samples);
+
+	double bestScore = -1e300;
+	size_t best = 0;
+	for (size_t s = 0; s < candidates; s++)
+	{
+		const double dot = (double)_dot(tail, region + s * (size_t)_channels, samples);
+		const double eb = (std::max)(_energy[s + _overlapFrames] - _energy[s], 0.0);
+		const double score = dot / (std::sqrt(ea * eb) + 1e-12);
+		if (score > bestScore)
+		{
+			bestScore = score;
+			best = s;
+		}
+	}
+	return best;
+}
+
+bool WsolaTimeStretch::PreferFft(size_t candidates) const
+{
+	const size_t samples = (size_t)_overlapFrames * _channels;
+	const size_t length = (candidates - 1 + _overlapFrames) * (size_t)_channels;
+	size_t size = 1;
+	while (size < length) size <<= 1;
+	const double direct = (double)candidates * (double)samples / (double)Lanes(_kernel);
+	const double fft = FFT_COST_FACTOR * (double)size * std::log2((double)size);
+	return direct > fft;
+}
+
+void WsolaTimeStretch::PrepareFft(size_t size)
+{
+	if (_fftSize == size) return;
+	_fftSize = size;
+	_twiddleRe.resize(size > 1 ? size - 1 : 1);
+	_twiddleIm.resize(size > 1 ? size - 1 : 1);
+	for (size_t half = 1; half < size; half <<= 1)
+	{
+		for (size_t k = 0; k < half; k++)
+		{
+			const double angle = -3.14159265358979323846 * (double)k / (double)half;
+			_twiddleRe[half - 1 + k] = (float)std::cos(angle);
+			_twiddleIm[half - 1 + k] = (float)std::sin(angle);
+		}
+	}
+	_fftRe.resize(size);
+	_fftIm.resize(size);
+	_corrRe.resize(size);
+	_corrIm.resize(size);
+}
+
+size_t WsolaTimeStretch::SearchFft(const float* tail, const float* region, size_t candidates)
+{
+	const size_t chs = _channels;
+	const size_t samples = (size_t)_overlapFrames * chs;
+	const size_t regionFrames = candidates - 1 + _overlapFrames;
+	const size_t length = regionFrames * chs;
+	size_t size = 1;
+	while (size < length) size <<= 1;
+	PrepareFft(size);
+	BuildEnergyPrefix(region, regionFrames);
+	_stats.FftSearches++;
+
+	// 两路实信号打包：z = tail + i*region，一次正变换得到两者的频谱。
+	// 交错样本按一维序列相关：帧偏移 s 对应样本滞后 s*chs，各声道的乘积自然累加在一起。
+	// size >= length，循环相关在所需滞后范围内不会回绕。
+	std::fill(_fftRe.begin() + samples, _fftRe.end(), 0.0f);
+	std::copy(tail, tail + samples, _fftRe.begin());
+	std::copy(region, region + length, _fftIm.begin());
+	std::fill(_fftIm.begin() + length, _fftIm.end(), 0.0f);
+	FftDif(_fftRe.data(), _fftIm.data(), size, _twiddleRe.data(), _twiddleIm.data(), _kernel);
+
+	// A = (Z[k] + conj(Z[-k])) / 2，B = (Z[k] - conj(Z[-k])) / 2i，互相关频谱 R = conj(A) * B。
+	// 频谱是位反转顺序：位置 p ∈ [j, 2j)（j 为 2 的幂）对应 -k 的位置是 3j - 1 - p，位置 0 对应自身
+	auto cross = [&](size_t p, size_t q)
+	{
+		const float zr = _fftRe[p], zi = _fftIm[p];
+		const float mr = _fftRe[q], mi = _fftIm[q];
+		const float ar = 0.5f * (zr + mr), ai = 0.5f * (zi - mi);
+		const float br = 0.5f * (zi + mi), bi = 0.5f * (mr - zr);
+		_corrRe[p] = ar * br + ai * bi;
+		_corrIm[p] = ar * bi - ai * br;
+	};
+	cross(0, 0);
+	for (size_t j = 1; j < size; j <<= 1)
+		for (size_t p = j; p < 2 * j; p++)
+			cross(p, 3 * j - 1 - p);
+	FftDit(_corrIm.data(), _corrRe.data(), size, _twiddleRe.data(), _twiddleIm.data(), _kernel);
+
+	const double scale = 1.0 / (double)size;
+	const double ea = (double)_dot(tail, tail, samples);
+	double bestScore = -1e300;
+	size_t best = 0;
+	for (size_t s = 0; s < candidates; s++)
+	{
+		const double dot = (double)_corrRe[s * chs] * scale;
+		const double eb = (std::max)(_energy[s + _overlapFrames] - _energy[s], 0.0);
+		const double score = dot / (std::sqrt(ea * eb) + 1e-12);
+		if (score > bestScore)
+		{
+			bestScore = score;
+			best = s;
+		}
+	}
+	return best;
+}
+
+void WsolaTimeStretch::EmitFirst(const float* seg)
+{
+	// 输出 window-overlap，尾部 overlap 先缓存，等待下次与新段融合后再输出
+	const size_t emitFrames = _windowFrames - _overlapFrames;
+	_out.insert(_out.end(), seg, seg + emitFrames * (size_t)_channels);
+	_tail.assign(seg + emitFrames * (size_t)_channels, seg + (size_t)_windowFrames * (size_t)_channels);
+	_hasTail = true;
+}
+
+void WsolaTimeStretch::EmitNext(const float* seg)
+{
+	// 先输出融合后的 overlap
+	if (_overlapFrames > 0)
+	{
+		const size_t old = _out.size();
+		_out.resize(old + (size_t)_overlapFrames * (size_t)_channels);
+		float* dst = _out.data() + old;
+		for (uint32_t i = 0; i < _overlapFrames; i++)
+		{
+			const float w = _fade[i];
+			for (uint32_t ch = 0; ch < _channels; ch++)
+			{
+				const size_t k = (size_t)i * (size_t)_channels + ch;
+				dst[k] = _tail[k] * (1.0f - w) + seg[k] * w;
+			}
+		}
+	}
+
+	// 输出中间部分（window - 2*overlap），尾部 overlap 缓存
+	const uint32_t midStart = _overlapFrames;
+	const uint32_t midEnd = (_windowFrames > _overlapFrames) ? (_windowFrames - _overlapFrames) : _overlapFrames;
+	if (midEnd > midStart)
+	{
+		const float* p0 = seg + (size_t)midStart * (size_t)_channels;
+		const float* p1 = seg + (size_t)midEnd * (size_t)_channels;
+		_out.insert(_out.end(), p0, p1);
+	}
+	_tail.assign(seg + (size_t)(_windowFrames - _overlapFrames) * (size_t)_channels, seg + (size_t)_windowFrames * (size_t)_channels);
+	_hasTail = true;
+}
+
+void WsolaTimeStretch::MaybeDropOldInput()
+{
+	// 保留 search 窗口之前的一点余量即可
+	if (_nextPredFrame <= _baseFrame) return;
+	size_t keepFrom = (_nextPredFrame > _searchFrames) ? (_nextPredFrame - _searchFrames) : _baseFrame;
+	if (keepFrom <= _baseFrame) return;
+	size_t dropFrames = keepFrom - _baseFrame;
+	// 不要频繁 erase；累计到一定规模再 compact
+	if (dropFrames < 4096) return;
+	const size_t dropSamples = dropFrames * (size_t)_channels;
+	if (dropSamples >= _in.size())
+	{
+		_in.clear();
+		_baseFrame = keepFrom;
+		return;
+	}
+	_in.erase(_in.begin(), _in.begin() + (ptrdiff_t)dropSamples);
+	_baseFrame = keepFrom;
+}
+
+void WsolaTimeStretch::Generate()
+{
+	if (_windowFrames == 0 || _hopOutFrames == 0) return;
+	const size_t availAbsEnd = _baseFrame + AvailableFrames();
+
+	if (!_hasTail)
+	{
+		if (availAbsEnd < _baseFrame + _windowFrames) return;
+		const float* seg = FramePtrAbs(_baseFrame);
+		EmitFirst(seg);
+		_stats.Segments++;
+		_nextPos = (double)_baseFrame + _hopIn;
+		_nextPredFrame = (size_t)std::llround(_nextPos);
+		MaybeDropOldInput();
+	}
+
+	for (;;)
+	{
+		// 关键：预测起点按名义位置累加，不能用上一段实际选中的起点 + hopIn。
+		// 上一段尾部的自然延续总在搜索范围内（NCC = 1），从实际起点累加会每次都选中它，
+		// 0.5x/2x 等倍速会退化成原速输出；按名义位置累加时选中点只在其 ±search 内摆动，平均速度准确，
+		// 名义位置单调前进，也不会在慢速时卡在同一段输入上。
+		// 等整个搜索范围都到齐再合成：候选集合不受输入分块影响。
+		if (availAbsEnd < _nextPredFrame + _searchFrames + _windowFrames) break;
+		const size_t bestStart = FindBestStart(_nextPredFrame);
+		const float* seg = FramePtrAbs(bestStart);
+		EmitNext(seg);
+		_stats.Segments++;
+		_nextPos += _hopIn;
+		_nextPredFrame = (size_t)std::llround(_nextPos);
+		MaybeDropOldInput();
+	}
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file WsolaTimeStretch.h
+ * @brief WsolaTimeStretch：WSOLA 变速不变调（MediaPlayer 倍速播放的音频处理）。
+ *
+ * 不依赖 Win32/Media Foundation，可单独编译测试。输入输出为交错 PCM（16 位整数、32 位整数或 32 位浮点），
+ * 内部按 float 处理：
+ * - 窗长 20ms、重叠 10ms、搜索 ±10ms；相邻段用升余弦交叉淡化拼接
+ * - 第 k 段围绕名义位置 k * hopOut * tempo 搜索与上一段尾部归一化互相关（NCC）最大的起点；
+ *   搜索范围完整可用（多缓冲 10ms 输入）后才合成，结果与输入分块方式无关
+ *
+ * 搜索方式（WsolaSearch）：
+ * - Reference：旧实现（double 逐点计算，重叠较长时先隔点粗搜再细搜），作为质量基准
+ * - Direct：逐候选 float 点积（标量 / SSE2 / AVX2，运行时按 CPU 选择），候选段能量由前缀和得到，全精度穷举
+ * - Fft：一次 FFT 互相关得到全部候选的点积（两路实信号打包进一次复数 FFT）
+ * - Auto：按运算量估计在 Direct 与 Fft 之间选择（长窗、多声道时 FFT 更快）
+ */
+
+enum class WsolaSearch
+{
+	Reference,
+	Direct,
+	Fft,
+	Auto,
+};
+
+enum class WsolaKernel
+{
+	Scalar,
+	Sse2,
+	Avx2,
+};
+
+class WsolaTimeStretch
+{
+public:
+	struct Stats
+	{
+		/** @brief 合成的段数。 */
+		size_t Segments = 0;
+		/** @brief 用 FFT 完成的搜索次数。 */
+		size_t FftSearches = 0;
+		/** @brief 评估过的候选起点总数。 */
+		size_t Candidates = 0;
+		/** @brief 拼接次数与拼接处 NCC 之和（平均值越接近 1，拼接越平滑）。 */
+		size_t Joins = 0;
+		double JoinScoreSum = 0.0;
+	};
+
+	/**
+	 * @param kernel Direct 搜索的点积内核；不受当前 CPU 支持时退回 BestKernel()。
+	 */
+	WsolaTimeStretch(uint32_t sampleRate, uint32_t channels, bool isFloat, uint32_t bitsPerSample,
+		WsolaSearch search = WsolaSearch::Auto, WsolaKernel kernel = BestKernel());
+
+	/** @brief 按采样率重新计算窗长等参数并清空状态。 */
+	void Configure(uint32_t sampleRate, uint32_t channels);
+	void Reset();
+	/** @brief 速度倍率（0.25 - 4）。 */
+	void SetTempo(float tempo);
+
+	/**
+	 * @brief 输入一段 PCM（构造时的格式），输出尽可能多的已合成 PCM（同格式）。
+	 *
+	 * outBytes 被覆盖（不追加）；调用方在各块之间复用同一个 vector 即可避免逐块分配。
+	 */
+	bool ProcessChunk(const void* inData, size_t inBytes, float tempo, float volume, std::vector<uint8_t>& outBytes);
+	/** @brief float 接口：输入交错帧，合成结果追加到 out。 */
+	void ProcessFloat(const float* frames, size_t frameCount, float tempo, std::vector<float>& out);
+
+	/**
+	 * @brief 在 region 的 candidates 个起点中找与 tail 最匹配的一个。
+	 * @param tail OverlapFrames() 帧（交错 float）。
+	 * @param region 至少 candidates - 1 + OverlapFrames() 帧。
+	 * @return 相对 region 起点的帧偏移。
+	 */
+	size_t FindBestOffset(const float* tail, const float* region, size_t candidates);
+
+	uint32_t SampleRate() const { return _sampleRate; }
+	uint32_t Channels() const { return _channels; }
+	uint32_t WindowFrames() const { return _windowFrames; }
+	uint32_t OverlapFrames() const { return _overlapFrames; }
+	uint32_t SearchFrames() const { return _searchFrames; }
+	WsolaSearch Search() const { return _search; }
+	WsolaKernel Kernel() const { return _kernel; }
+	const Stats& GetStats() const { return _stats; }
+	void ResetStats() { _stats = Stats(); }
+
+	/** @brief 当前 CPU 上最快的点积内核（首次调用时检测）。 */
+	static WsolaKernel BestKernel();
+	static bool IsKernelSupported(WsolaKernel kernel);
+	static const wchar_t* KernelName(WsolaKernel kernel);
+	static const wchar_t* SearchName(WsolaSearch search);
+	/** @brief 归一化互相关（double，测试与参考用）。 */
+	static double Ncc(const float* a, const float* b, size_t samples);
+
+private:
+	typedef float (*DotFunc)(const float* a, const float* b, size_t n);
+
+	size_t FindBestStart(size_t predStartAbs);
+	size_t SearchReference(const float* tail, const float* region, size_t candidates) const;
+	size_t SearchDirect(const float* tail, const float* region, size_t candidates);
+	size_t SearchFft(const float* tail, const float* region, size_t candidates);
+	bool PreferFft(size_t candidates) const;
+	void PrepareFft(size_t size);
+	/** @brief 候选段能量前缀和（region 的每帧平方和累加，double）。 */
+	void BuildEnergyPrefix(const float* region, size_t frames);
+
+	void AppendInput(const float* frames, size_t frameCount);
+	size_t AvailableFrames() const { return _in.size() / (size_t)_channels; }
+	const float* FramePtrAbs(size_t absFrame) const { return _in.data() + (absFrame - _baseFrame) * (size_t)_channels; }
+	void EmitFirst(const float* seg);
+	void EmitNext(const float* seg);
+	void MaybeDropOldInput();
+	void Generate();
+
+	static bool BytesToFloat(const void* data, size_t bytes, uint32_t channels, uint32_t bits, bool isFloat, std::vector<float>& out);
+	static void FloatToBytes(const float* in, size_t frames, uint32_t channels, uint32_t bits, bool isFloat, std::vector<uint8_t>& out);
+
+	uint32_t _sampleRate = 0;
+	uint32_t _channels = 0;
+	bool _isFloat = false;
+	uint32_t _bitsPerSample = 0;
+	WsolaSearch _search;
+	WsolaKernel _kernel;
+	DotFunc _dot = nullptr;
+
+	float _tempo = 1.0f;
+	uint32_t _windowFrames = 0;
+	uint32_t _overlapFrames = 0;
+	uint32_t _searchFrames = 0;
+	uint32_t _hopOutFrames = 0;
+	/** @brief 每段在输入上的名义步长（帧，hopOut * tempo，不取整以免累计误差）。 */
+	double _hopIn = 0.0;
+
+	std::vector<float> _in;            // interleaved
+	size_t _baseFrame = 0;             // absolute frame index for _in[0]
+	double _nextPos = 0.0;             // nominal (unrounded) input position of next segment
+	size_t _nextPredFrame = 0;         // absolute predicted start for next segment
+
+	bool _hasTail = false;
+	std::vector<float> _tail;          // overlapFrames * channels (tail of last segment)
+	std::vector<float> _out;           // synthesized output frames, interleaved
+	/** @brief 交叉淡化权重（overlapFrames 个，Configure 时计算）。 */
+	std::vector<float> _fade;
+
+	std::vector<float> _tmpInFloat;
+
+	// 搜索工作区（只增不减，稳态不分配）
+	std::vector<double> _energy;
+	size_t _fftSize = 0;
+	std::vector<float> _twiddleRe;
+	std::vector<float> _twiddleIm;
+	std::vector<float> _fftRe;
+	std::vector<float> _fftIm;
+	std::vector<float> _corrRe;
+	std::vector<float> _corrIm;
+
+	Stats _stats;
+};
@@ -0,0 +1,350 @@
+#include "YuvConvert.h"
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define YUV_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define YUV_X86 0
+#endif
+
+#if YUV_X86 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define YUV_SSE2 1
+#else
+#define YUV_SSE2 0
+#endif
+
+// MSVC 不需要 /arch:AVX2 即可使用 AVX2 内建函数；GCC/Clang 需要按函数开启
+#if YUV_X86 && (defined(__GNUC__) || defined(__clang__))
+#define YUV_AVX2 1
+#define YUV_TARGET_AVX2 __attribute__((target("avx2")))
+#elif YUV_X86 && defined(_MSC_VER)
+#define YUV_AVX2 1
+#define YUV_TARGET_AVX2
+#else
+#define YUV_AVX2 0
+#define YUV_TARGET_AVX2
+#endif
+
+typedef YuvToBgraConverter::Coefficients Coefficients;
+
+namespace {
+
+inline uint8_t Clip8(int v)
+{
+	return (uint8_t)((v < 0) ? 0 : (v > 255 ? 255 : v));
+}
+
+template <bool TenBit>
+inline int Sample(const uint8_t* p, uint32_t i)
+{
+	if (!TenBit) return p[i];
+	uint16_t v;
+	std::memcpy(&v, p + (size_t)i * 2, sizeof(v));
+	return v >> 6;
+}
+
+// 参考实现（从 start 列开始，SIMD 内核用它处理行尾）
+template <bool TenBit>
+void RowScalar(const uint8_t* y, const uint8_t* uv, uint8_t* dst, uint32_t width, const Coefficients& c, uint32_t start)
+{
+	const int shift = TenBit ? 10 : 8;
+	const int round = 1 << (shift - 1);
+	const int yOffset = TenBit ? c.YOffset << 2 : c.YOffset;
+	const int mid = TenBit ? 512 : 128;
+	for (uint32_t col = start; col < width; col++)
+	{
+		const uint32_t pair = col & ~1u;
+		const int U = Sample<TenBit>(uv, pair) - mid;
+		const int V = Sample<TenBit>(uv, pair + 1) - mid;
+		int C = Sample<TenBit>(y, col) - yOffset;
+		if (C < 0) C = 0;
+		const int yc = c.Y * C + round;
+		uint8_t* px = dst + (size_t)col * 4;
+		px[0] = Clip8((yc + c.UB * U) >> shift);
+		px[1] = Clip8((yc + c.UG * U + c.VG * V) >> shift);
+		px[2] = Clip8((yc + c.VR * V) >> shift);
+		px[3] = 0xFF;
+	}
+}
+
+template <bool TenBit>
+void RowScalarFull(const uint8_t* y, const uint8_t* uv, uint8_t* dst, uint32_t width, const Coefficients& c)
+{
+	RowScalar<TenBit>(y, uv, dst, width, c, 0);
+}
+
+// 32 位通道里低 16 位乘 U、高 16 位乘 V（_mm_madd_epi16 用）
+inline int PackPair(int u, int v)
+{
+	return (int)((uint32_t)(uint16_t)(int16_t)u | ((uint32_t)(uint16_t)(int16_t)v << 16));
+}
+
+#if YUV_SSE2
+struct Sse2Consts
+{
+	__m128i Zero, Y, R, G, B, Round, Alpha;
+	Sse2Consts(const Coefficients& c, int round)
+	{
+		Zero = _mm_setzero_si128();
+		Y = _mm_set1_epi32(c.Y);
+		R = _mm_set1_epi32(PackPair(0, c.VR));
+		G = _mm_set1_epi32(PackPair(c.UG, c.VG));
+		B = _mm_set1_epi32(PackPair(c.UB, 0));
+		Round = _mm_set1_epi32(round);
+		Alpha = _mm_set1_epi8((char)0xFF);
+	}
+};
+
+// 8 个像素：c16 为去黑电平后的亮度，uv16 为 4 对去中点后的 U/V（16 位）
+template <int Shift>
+inline void Store8(uint8_t* dst, __m128i c16, __m128i uv16, const Sse2Consts& k)
+{
+	const __m128i uvLo = _mm_unpacklo_epi32(uv16, uv16);
+	const __m128i uvHi = _mm_unpackhi_epi32(uv16, uv16);
+	const __m128i yLo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(c16, k.Zero), k.Y), k.Round);
+	const __m128i yHi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(c16, k.Zero), k.Y), k.Round);
+	const __m128i r = _mm_packs_epi32(
+		_mm_srai_epi32(_mm_add_epi32(yLo, _mm_madd_epi16(uvLo, k.R)), Shift),
+		_mm_srai_epi32(_mm_add_epi32(yHi, _mm_madd_epi16(uvHi, k.R)), Shift));
+	const __m128i g = _mm_packs_epi32(
+		_mm_srai_epi32(_mm_add_epi32(yLo, _mm_madd_epi16(uvLo, k.G)), Shift),
+		_mm_srai_epi32(_mm_add_epi32(yHi, _mm_madd_epi16(uvHi, k.G)), Shift));
+	const __m128i b = _mm_packs_epi32(
+		_mm_srai_epi32(_mm_add_epi32(yLo, _mm_madd_epi16(uvLo, k.B)), Shift),
+		_mm_srai_epi32(_mm_add_epi32(yHi, _mm_madd_epi16(uvHi, k.B)), Shift));
+	const __m128i bg = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), _mm_packus_epi16(g, g));
+	const __m128i ra = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), k.Alpha);
+	_mm_storeu_si128((__m128i*)dst, _mm_unpacklo_epi16(bg, ra));
+	_mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi16(bg, ra));
+}
+
+void RowSse2Nv12(const uint8_t* y, const uint8_t* uv, uint8_t* dst, uint32_t width, const Coefficients& c)
+{
+	const Sse2Consts k(c, 128);
+	const __m128i yOffset = _mm_set1_epi8((char)c.YOffset);
+	const __m128i mid = _mm_set1_epi16(128);
+	uint32_t col = 0;
+	for (; col + 8 <= width; col += 8)
+	{
+		const __m128i c16 = _mm_unpacklo_epi8(_mm_subs_epu8(_mm_loadl_epi64((const __m128i*)(y + col)), yOffset), k.Zero);
+		const __m128i uv16 = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(uv + col)), k.Zero), mid);
+		Store8<8>(dst + (size_t)col * 4, c16, uv16, k);
+	}
+	RowScalar<false>(y, uv, dst, width, c, col);
+}
+
+void RowSse2P010(const uint8_t* y, const uint8_t* uv, uint8_t* dst, uint32_t width, const Coefficients& c)
+{
+	const Sse2Consts k(c, 512);
+	const __m128i yOffset = _mm_set1_epi16((short)(c.YOffset << 2));
+	const __m128i mid = _mm_set1_epi16(512);
+	uint32_t col = 0;
+	for (; col + 8 <= width; col += 8)
+	{
+		const __m128i y16 = _mm_srli_epi16(_mm_loadu_si128((const __m128i*)(y + (size_t)col * 2)), 6);
+		const __m128i c16 = _mm_subs_epu16(y16, yOffset);
+		const __m128i uv16 = _mm_sub_epi16(_mm_srli_epi16(_mm_loadu_si128((const __m128i*)(uv + (size_t)col * 2)), 6), mid);
+		Store8<10>(dst + (size_t)col * 4, c16, uv16, k);
+	}
+	RowScalar<true>(y, uv, dst, width, c, col);
+}
+#endif
+
+#if YUV_AVX2
+struct Avx2Consts
+{
+	__m256i Zero, Y, R, G, B, Round, Alpha;
+	YUV_TARGET_AVX2 Avx2Consts(const Coefficients& c, int round)
+	{
+		Zero = _mm256_setzero_si256();
+		Y = _mm256_set1_epi32(c.Y);
+		R = _mm256_set1_epi32(PackPair(0, c.VR));
+		G = _mm256_set1_epi32(PackPair(c.UG, c.VG));
+		B = _mm256_set1_epi32(PackPair(c.UB, 0));
+		Round = _mm256_set1_epi32(round);
+		Alpha = _mm256_set1_epi8((char)0xFF);
+	}
+};
+
+// 16 个像素。AVX2 的 unpack/pack 在 128 位通道内进行：
+// “lo”组为像素 0-3 与 8-11，“hi”组为 4-7 与 12-15，pack 后恢复自然顺序，最后跨通道重排写出
+template <int Shift>
+YUV_TARGET_AVX2 inline void Store16(uint8_t* dst, __m256i c16, __m256i uv16, const Avx2Consts& k)
+{
+	const __m256i uvLo = _mm256_unpacklo_epi32(uv16, uv16);
+	const __m256i uvHi = _mm256_unpackhi_epi32(uv16, uv16);
+	const __m256i yLo = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(c16, k.Zero), k.Y), k.Round);
+	const __m256i yHi = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(c16, k.Zero), k.Y), k.Round);
+	const __m256i r = _mm256_packs_epi32(
+		_mm256_srai_epi32(_mm256_add_epi32(yLo, _mm256_madd_epi16(uvLo, k.R)), Shift),
+		_mm256_srai_epi32(_mm256_add_epi32(yHi, _mm256_madd_epi16(uvHi, k.R)), Shift));
+	const __m256i g = _mm256_packs_epi32(
+		_mm256_srai_epi32(_mm256_add_epi32(yLo, _mm256_madd_epi16(uvLo, k.G)), Shift),
+		_mm256_srai_epi32(_mm256_add_epi32(yHi, _mm256_madd_epi16(uvHi, k.G)), Shift));
+	const __m256i b = _mm256_packs_epi32(
+		_mm256_srai_epi32(_mm256_add_epi32(yLo, _mm256_madd_epi16(uvLo, k.B)), Shift),
+		_mm256_srai_epi32(_mm256_add_epi32(yHi, _mm256_madd_epi16(uvHi, k.B)), Shift));
+	const __m256i bg = _mm256_unpacklo_epi8(_mm256_packus_epi16(b, b), _mm256_packus_epi16(g, g));
+	const __m256i ra = _mm256_unpacklo_epi8(_mm256_packus_epi16(r, r), k.Alpha);
+	const __m256i lo = _mm256_unpacklo_epi16(bg, ra);
+	const __m256i hi = _mm256_unpackhi_epi16(bg, ra);
+	_mm256_storeu_si256((__m256i*)dst, _mm256_permute2x128_si256(lo, hi, 0x20));
+	_mm256_storeu_si256((__m256i*)(dst + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+YUV_TARGET_AVX2 void RowAvx2Nv12(const uint8_t* y, const uint8_t* uv, uint8_t* dst, uint32_t width, const Coefficients& c)
+{
+	const Avx2Consts k(c, 128);
+	const __m128i yOffset = _mm_set1_epi8((char)c.YOffset);
+	const __m256i mid = _mm256_set1_epi16(128);
+	uint32_t col = 0;
+	for (; col + 16 <= width; col += 16)
+	{
+		const __m256i c16 = _mm256_cvtepu8_epi16(_mm_subs_epu8(_mm_loadu_si128((const __m128i*)(y + col)), yOffset));
+		const __m256i uv16 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(uv + col))), mid);
+		Store16<8>(dst + (size_t)col * 4, c16, uv16, k);
+	}
+#if YUV_SSE2
+	RowSse2Nv12(y + col, uv + col, dst + (size_t)col * 4, width - col, c);
+#else
+	RowScalar<false>(y, uv, dst, width, c, col);
+#endif
+}
+
+YUV_TARGET_AVX2 void RowAvx2P010(const uint8_t* y, const uint8_t* uv, uint8_t* dst, uint32_t width, const Coefficients& c)
+{
+	const Avx2Consts k(c, 512);
+	const __m256i yOffset = _mm256_set1_epi16((short)(c.YOffset << 2));
+	const __m256i mid = _mm256_set1_epi16(512);
+	uint32_t col = 0;
+	for (; col + 16 <= width; col += 16)
+	{
+		const __m256i y16 = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)(y + (size_t)col * 2)), 6);
+		const __m256i c16 = _mm256_subs_epu16(y16, yOffset);
+		const __m256i uv16 = _mm256_sub_epi16(_mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)(uv + (size_t)col * 2)), 6), mid);
+		Store16<10>(dst + (size_t)col * 4, c16, uv16, k);
+	}
+#if YUV_SSE2
+	RowSse2P010(y + (size_t)col * 2, uv + (size_t)col * 2, dst + (size_t)col * 4, width - col, c);
+#else
+	RowScalar<true>(y, uv, dst, width, c, col);
+#endif
+}
+#endif
+
+bool DetectAvx2()
+{
+#if !YUV_AVX2
+	return false;
+#elif defined(_MSC_VER)
+	int info[4] = {};
+	__cpuid(info, 0);
+	if (info[0] < 7) return false;
+	__cpuid(info, 1);
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	// 操作系统需要保存 YMM 状态（XCR0 的 bit 1、2）
+	if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+} // namespace
+
+YuvKernel YuvToBgraConverter::BestKernel()
+{
+	static const YuvKernel best = DetectAvx2() ? YuvKernel::Avx2 : (YUV_SSE2 ? YuvKernel::Sse2 : YuvKernel::Scalar);
+	return best;
+}
+
+bool YuvToBgraConverter::IsKernelSupported(YuvKernel kernel)
+{
+	switch (kernel)
+	{
+	case YuvKernel::Scalar:
+		return true;
+	case YuvKernel::Sse2:
+		return YUV_SSE2 != 0;
+	case YuvKernel::Avx2:
+		return BestKernel() == YuvKernel::Avx2;
+	}
+	return false;
+}
+
+const wchar_t* YuvToBgraConverter::KernelName(YuvKernel kernel)
+{
+	switch (kernel)
+	{
+	case YuvKernel::Scalar: return L"Scalar";
+	case YuvKernel::Sse2: return L"SSE2";
+	case YuvKernel::Avx2: return L"AVX2";
+	}
+	return L"?";
+}
+
+YuvToBgraConverter::Coefficients YuvToBgraConverter::MakeCoefficients(YuvMatrix matrix, bool fullRange)
+{
+	double kr = 0.299, kb = 0.114;
+	if (matrix == YuvMatrix::Bt709)
+	{
+		kr = 0.2126;
+		kb = 0.0722;
+	}
+	else if (matrix == YuvMatrix::Bt2020)
+	{
+		kr = 0.2627;
+		kb = 0.0593;
+	}
+	const double kg = 1.0 - kr - kb;
+	// 有限范围：亮度 219 级、色度 224 级展开到 255
+	const double ys = fullRange ? 1.0 : 255.0 / 219.0;
+	const double cs = fullRange ? 1.0 : 255.0 / 224.0;
+	auto fixed = [](double v) { return (int)std::lround(v * 256.0); };
+	Coefficients c;
+	c.Y = fixed(ys);
+	c.VR = fixed(2.0 * (1.0 - kr) * cs);
+	c.UG = fixed(-2.0 * (1.0 - kb) * kb / kg * cs);
+	c.VG = fixed(-2.0 * (1.0 - kr) * kr / kg * cs);
+	c.UB = fixed(2.0 * (1.0 - kb) * cs);
+	c.YOffset = fullRange ? 0 : 16;
+	return c;
+}
+
+YuvToBgraConverter::YuvToBgraConverter(YuvFormat format, YuvMatrix matrix, bool fullRange, YuvKernel kernel)
+	: _format(format), _matrix(matrix), _fullRange(fullRange), _kernel(kernel), _coeffs(MakeCoefficients(matrix, fullRange))
+{
+	if (!IsKernelSupported(_kernel)) _kernel = BestKernel();
+	const bool tenBit = (format == YuvFormat::P010);
+	_row = tenBit ? &RowScalarFull<true> : &RowScalarFull<false>;
+#if YUV_SSE2
+	if (_kernel == YuvKernel::Sse2) _row = tenBit ? &RowSse2P010 : &RowSse2Nv12;
+#endif
+#if YUV_AVX2
+	if (_kernel == YuvKernel::Avx2) _row = tenBit ? &RowAvx2P010 : &RowAvx2Nv12;
+#endif
+}
+
+void YuvToBgraConverter::ConvertRow(const uint8_t* y, const uint8_t* uv, uint8_t* bgra, uint32_t width) const
+{
+	if (!y || !uv || !bgra || width == 0) return;
+	_row(y, uv, bgra, width, _coeffs);
+}
+
+void YuvToBgraConverter::Convert(const uint8_t* y, size_t yStride, const uint8_t* uv, size_t uvStride,
+	uint32_t width, uint32_t height, uint8_t* bgra, size_t bgraStride) const
+{
+	if (!y || !uv || !bgra || width == 0) return;
+	for (uint32_t row = 0; row < height; row++)
+	{
+		_row(y + (size_t)row * yStride, uv + (size_t)(row / 2) * uvStride, bgra + (size_t)row * bgraStride, width, _coeffs);
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file YuvConvert.h
+ * @brief YuvToBgraConverter：NV12 / P010 转 BGRA32（视频帧 CPU 颜色转换）。
+ *
+ * 不依赖 Win32/Media Foundation，可单独编译测试。MediaPlayer 在 SourceReader 输出 NV12/P010 时使用。
+ *
+ * - 矩阵：BT.601 / BT.709 / BT.2020；范围：有限（16-235）或全范围（0-255）
+ * - 定点公式（8 位小数）：C = max(Y - 黑电平, 0)，R = (yc*C + vr*V + round) >> shift，G/B 同理；
+ *   BT.601 有限范围的系数与旧的 ConvertNV12ToBGRA 完全相同（298/409/-100/-208/516）
+ * - P010 取高 10 位按 10 位精度计算（shift 多 2 位），结果同样截断到 8 位
+ * - 内核：标量（参考实现）、SSE2（每次 8 像素）、AVX2（每次 16 像素），运行时按 CPU 选择；
+ *   三者逐字节一致（整数运算，不含浮点）
+ */
+
+enum class YuvFormat
+{
+	/** @brief 8 位 4:2:0：Y 平面 + 交错 UV 平面。 */
+	Nv12,
+	/** @brief 10 位 4:2:0：同 NV12 布局，每个样本 16 位小端，有效位在高 10 位。 */
+	P010,
+};
+
+enum class YuvMatrix
+{
+	Bt601,
+	Bt709,
+	Bt2020,
+};
+
+enum class YuvKernel
+{
+	Scalar,
+	Sse2,
+	Avx2,
+};
+
+class YuvToBgraConverter
+{
+public:
+	/** @brief 定点系数（8 位小数）。 */
+	struct Coefficients
+	{
+		int Y = 0;
+		int VR = 0;
+		int UG = 0;
+		int VG = 0;
+		int UB = 0;
+		/** @brief 亮度黑电平（8 位刻度）：有限范围 16，全范围 0。 */
+		int YOffset = 0;
+	};
+
+	/**
+	 * @param kernel 指定内核；不受当前 CPU 支持时退回 BestKernel()。
+	 */
+	YuvToBgraConverter(YuvFormat format = YuvFormat::Nv12, YuvMatrix matrix = YuvMatrix::Bt601,
+		bool fullRange = false, YuvKernel kernel = BestKernel());
+
+	YuvFormat Format() const { return _format; }
+	YuvMatrix Matrix() const { return _matrix; }
+	bool FullRange() const { return _fullRange; }
+	YuvKernel Kernel() const { return _kernel; }
+	const Coefficients& Coeffs() const { return _coeffs; }
+
+	/**
+	 * @brief 转换一行。
+	 * @param y 本行 Y 样本（NV12 为字节，P010 为 16 位样本）。
+	 * @param uv 对应色度行（交错 U/V，与 y 同一样本宽度），第 0 个样本与 y 的第 0 个像素对齐。
+	 * @param width 像素数；奇数宽度时最后一个像素使用前一对的色度。
+	 */
+	void ConvertRow(const uint8_t* y, const uint8_t* uv, uint8_t* bgra, uint32_t width) const;
+	/**
+	 * @brief 转换整幅图像（色度行按 row / 2 取）。
+	 * @param yStride / uvStride / bgraStride 均以字节计。
+	 */
+	void Convert(const uint8_t* y, size_t yStride, const uint8_t* uv, size_t uvStride,
+		uint32_t width, uint32_t height, uint8_t* bgra, size_t bgraStride) const;
+
+	/** @brief 当前 CPU 上最快的内核（首次调用时检测）。 */
+	static YuvKernel BestKernel();
+	static bool IsKernelSupported(YuvKernel kernel);
+	static const wchar_t* KernelName(YuvKernel kernel);
+	static Coefficients MakeCoefficients(YuvMatrix matrix, bool fullRange);
+
+private:
+	typedef void (*RowFunc)(const uint8_t* y, const uint8_t* uv, uint8_t* bgra, uint32_t width, const Coefficients& c);
+
+	YuvFormat _format;
+	YuvMatrix _matrix;
+	bool _fullRange;
+	YuvKernel _kernel;
+	Coefficients _coeffs;
+	RowFunc _row = nullptr;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+/**
+ * @file AudioRingBenchmark.h
+ * @brief 音频 PCM 环与渲染节拍的校验与基准（CUICheck 套件 audio-ring）。
+ *
+ * 只使用 AudioRingBuffer/AudioRenderPacer（以及 WsolaTimeStretch 的输出缓冲复用），不依赖 Win32/WASAPI：
+ * - RunChecks：环绕读写、环满部分写入、Flush 只作废此前的帧、双线程压力（顺序与内容）、
+ *   设备目标（延迟目标/两个周期/设备缓冲）、欠载统计与模拟设备实际缺帧一致、变速输出缓冲稳态不分配
+ * - RunBenchmarks：模拟设备时钟（48kHz、10ms 周期）下解码线程周期性卡顿时，旧路径（同一线程解码并直接写设备）
+ *   与环 + 渲染线程在不同延迟目标下的欠载与排队时长；双线程经环传输的吞吐
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct AudioRingBenchmarkResult
+{
+	std::wstring Name;
+	/** @brief 模拟播放场景（模拟时钟）；否则为实测吞吐。 */
+	bool Simulated = false;
+	/** @brief 延迟目标（毫秒；旧路径为 0）。 */
+	double LatencyMs = 0.0;
+	/** @brief 欠载次数（设备从有声变为缺帧）与缺帧总时长（毫秒）。 */
+	int Underruns = 0;
+	double StarvedMs = 0.0;
+	/** @brief 平均排队时长（设备 + 环，毫秒）。 */
+	double AverageQueuedMs = 0.0;
+	/** @brief 实测：经环传输每秒音频（48kHz 立体声 float）的耗时（毫秒）。 */
+	double MillisPerSecond = 0.0;
+};
+
+class AudioRingBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param seconds 每个模拟场景与吞吐测试的音频时长（秒）。 */
+	static std::vector<AudioRingBenchmarkResult> RunBenchmarks(int seconds = 60);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<AudioRingBenchmarkResult>& benchmarks);
+};
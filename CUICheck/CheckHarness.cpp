@@ -0,0 +1,142 @@
+#include "CheckHarness.h"
+#include <cmath>
+#include <cstdarg>
+#include <cwchar>
+
+std::wstring CheckFormat(const wchar_t* format, ...)
+{
+	// vswprintf 在缓冲不足时返回负数（不返回所需长度）：逐次加倍
+	std::wstring result(256, L'\0');
+	for (;;)
+	{
+		va_list va;
+		va_start(va, format);
+		const int n = std::vswprintf(&result[0], result.size(), format, va);
+		va_end(va);
+		if (n >= 0 && (size_t)n < result.size())
+		{
+			result.resize((size_t)n);
+			return result;
+		}
+		if (result.size() >= (1u << 20)) return L"";
+		result.resize(result.size() * 2);
+	}
+}
+
+void ExpectTrue(CheckResult& r, const wchar_t* what, bool value)
+{
+	if (!r.Passed || value) return;
+	r.Passed = false;
+	r.Detail = CheckFormat(L"%ls 不成立", what);
+}
+
+void ExpectCount(CheckResult& r, const wchar_t* what, long long value, long long expected)
+{
+	if (!r.Passed || value == expected) return;
+	r.Passed = false;
+	r.Detail = CheckFormat(L"%ls 为 %lld，期望 %lld", what, value, expected);
+}
+
+void ExpectNear(CheckResult& r, const wchar_t* what, double value, double expected, double tolerance)
+{
+	if (!r.Passed || std::fabs(value - expected) <= tolerance) return;
+	r.Passed = false;
+	r.Detail = CheckFormat(L"%ls 为 %.4f，期望 %.4f（容差 %.4f）", what, value, expected, tolerance);
+}
+
+std::wstring CheckSummary(const wchar_t* title, const std::vector<CheckResult>& checks)
+{
+	int passed = 0;
+	for (const auto& c : checks)
+		if (c.Passed) passed++;
+	std::wstring text = CheckFormat(L"%ls校验：%d/%d 通过\r\n", title, passed, (int)checks.size());
+	for (const auto& c : checks)
+	{
+		if (!c.Passed)
+			text += CheckFormat(L"  [失败] %ls：%ls\r\n", c.Name.c_str(), c.Detail.c_str());
+	}
+	return text;
+}
+
+CheckRunSummary RunCheckSuites(const CheckRunOptions& options)
+{
+	CheckRunSummary summary;
+	for (const auto& suite : AllCheckSuites())
+	{
+		if (!options.Suites.empty())
+		{
+			bool selected = false;
+			for (const auto& id : options.Suites)
+				if (id == suite.Id) selected = true;
+			if (!selected) continue;
+		}
+
+		const auto checks = suite.RunChecks();
+		int failed = 0;
+		for (const auto& c : checks)
+			if (!c.Passed) failed++;
+		summary.Suites++;
+		summary.Checks += (int)checks.size();
+		summary.Failed += failed;
+
+		const std::wstring id(suite.Id, suite.Id + std::char_traits<char>::length(suite.Id));
+		if (options.Benchmarks && suite.RunBenchmarks)
+		{
+			summary.Text += CheckFormat(L"== %ls（%ls）\r\n", suite.Title, id.c_str());
+			summary.Text += suite.RunBenchmarks(checks);
+			continue;
+		}
+		summary.Text += CheckFormat(L"[%ls] %ls（%ls）：%d/%d\r\n",
+			failed ? L"失败" : L"通过", suite.Title, id.c_str(), (int)checks.size() - failed, (int)checks.size());
+		for (const auto& c : checks)
+		{
+			if (!c.Passed)
+				summary.Text += CheckFormat(L"  [失败] %ls：%ls\r\n", c.Name.c_str(), c.Detail.c_str());
+		}
+	}
+	summary.Text += CheckFormat(L"共 %d 个套件，%d 项校验，%d 项失败\r\n", summary.Suites, summary.Checks, summary.Failed);
+	return summary;
+}
+
+std::string CheckToUtf8(const std::wstring& text)
+{
+	std::string out;
+	out.reserve(text.size());
+	for (size_t i = 0; i < text.size(); i++)
+	{
+		uint32_t c = (uint32_t)text[i];
+		// UTF-16 代理对（wchar_t 为 16 位时）
+		if (c >= 0xD800 && c <= 0xDBFF && i + 1 < text.size())
+		{
+			const uint32_t low = (uint32_t)text[i + 1];
+			if (low >= 0xDC00 && low <= 0xDFFF)
+			{
+				c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+				i++;
+			}
+		}
+		if (c < 0x80)
+		{
+			out += (char)c;
+		}
+		else if (c < 0x800)
+		{
+			out += (char)(0xC0 | (c >> 6));
+			out += (char)(0x80 | (c & 0x3F));
+		}
+		else if (c < 0x10000)
+		{
+			out += (char)(0xE0 | (c >> 12));
+			out += (char)(0x80 | ((c >> 6) & 0x3F));
+			out += (char)(0x80 | (c & 0x3F));
+		}
+		else
+		{
+			out += (char)(0xF0 | (c >> 18));
+			out += (char)(0x80 | ((c >> 12) & 0x3F));
+			out += (char)(0x80 | ((c >> 6) & 0x3F));
+			out += (char)(0x80 | (c & 0x3F));
+		}
+	}
+	return out;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+/**
+ * @file CheckHarness.h
+ * @brief 无界面校验程序 CUICheck 的公共部分：校验结果、断言辅助、跨平台格式化与套件表。
+ *
+ * 各套件（*Benchmark.cpp）只依赖被测单元与本文件，不依赖 StringHelper/Win32，
+ * 不依赖 Win32 的套件在 Linux 上由 CMakeLists.txt 编译运行；依赖控件或 DirectWrite 的套件只在 Windows 版本中注册。
+ */
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** @brief 一项校验的结果。 */
+struct CheckResult
+{
+	std::wstring Name;
+	bool Passed = false;
+	/** @brief 失败时的首个差异。 */
+	std::wstring Detail;
+};
+
+/**
+ * @brief 宽字符格式化（vswprintf）。
+ *
+ * 宽字符串参数一律写 %ls：MSVC 与 glibc 对 %ls 的解释一致，对 %s 则不同。
+ */
+std::wstring CheckFormat(const wchar_t* format, ...);
+
+/** @brief 以下断言只记录首个失败：r 已失败时直接返回。 */
+void ExpectTrue(CheckResult& r, const wchar_t* what, bool value);
+void ExpectCount(CheckResult& r, const wchar_t* what, long long value, long long expected);
+void ExpectNear(CheckResult& r, const wchar_t* what, double value, double expected, double tolerance = 1e-6);
+
+/** @brief 报告的首段：“<title>校验：通过数/总数 通过”，随后逐行列出失败项。 */
+std::wstring CheckSummary(const wchar_t* title, const std::vector<CheckResult>& checks);
+
+/** @brief 一个校验套件。 */
+struct CheckSuite
+{
+	/** @brief 命令行筛选用的 ASCII 名称（如 "layout"）。 */
+	const char* Id;
+	const wchar_t* Title;
+	std::vector<CheckResult>(*RunChecks)();
+	/** @brief 运行基准，返回完整报告（含 CheckSummary）。 */
+	std::wstring(*RunBenchmarks)(const std::vector<CheckResult>& checks);
+};
+
+/** @brief 本平台可运行的全部套件（CheckSuites.cpp）。 */
+const std::vector<CheckSuite>& AllCheckSuites();
+
+struct CheckRunOptions
+{
+	/** @brief 同时运行基准并输出报告（默认只运行校验）。 */
+	bool Benchmarks = false;
+	/** @brief 只运行 Id 在列表中的套件；为空时运行全部。 */
+	std::vector<std::string> Suites;
+};
+
+struct CheckRunSummary
+{
+	int Suites = 0;
+	int Checks = 0;
+	int Failed = 0;
+	std::wstring Text;
+};
+
+CheckRunSummary RunCheckSuites(const CheckRunOptions& options);
+
+/** @brief 宽字符串转 UTF-8（控制台输出用；wchar_t 为 UTF-16 或 UTF-32 均可）。 */
+std::string CheckToUtf8(const std::wstring& text);
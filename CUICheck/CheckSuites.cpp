@@ -0,0 +1,168 @@
+#include "CheckHarness.h"
+#include "DirtyRegionBenchmark.h"
+#include "DisplayListBenchmark.h"
+#include "SoftwareRasterizerBenchmark.h"
+#include "ResourceCacheBenchmark.h"
+#include "FrameSchedulerBenchmark.h"
+#include "YuvConvertBenchmark.h"
+#include "VideoFrameQueueBenchmark.h"
+#include "WsolaBenchmark.h"
+#include "AudioRingBenchmark.h"
+#include "PlaybackTelemetryBenchmark.h"
+#include "TextBufferBenchmark.h"
+#include "LogLineBufferBenchmark.h"
+#include "GridSortBenchmark.h"
+#include "GridTextIndexBenchmark.h"
+#include "TextWidthCacheBenchmark.h"
+#include "TreeRowIndexBenchmark.h"
+#include "LayoutBenchmark.h"
+#include "SpatialIndexBenchmark.h"
+#include "GridRowCacheBenchmark.h"
+
+// 依赖控件或 DirectWrite 的套件只在 Windows 版本（CUICheck.vcxproj）中编译；CMake 构建只含可移植的套件
+#if defined(_WIN32) && !defined(CUICHECK_PORTABLE_ONLY)
+#define CUICHECK_WINDOWS_SUITES 1
+#include "TextLayoutCacheBenchmark.h"
+#include "GridViewColumnStoreBenchmark.h"
+#endif
+
+namespace {
+
+std::wstring DirtyRegionReport(const std::vector<CheckResult>& checks)
+{
+	return DirtyRegionBenchmark::Report(checks, DirtyRegionBenchmark::RunBenchmarks());
+}
+
+std::wstring DisplayListReport(const std::vector<CheckResult>& checks)
+{
+	return DisplayListBenchmark::Report(checks, DisplayListBenchmark::RunBenchmarks());
+}
+
+std::wstring SoftwareRasterizerReport(const std::vector<CheckResult>& checks)
+{
+	return SoftwareRasterizerBenchmark::Report(checks, SoftwareRasterizerBenchmark::RunBenchmarks());
+}
+
+std::wstring ResourceCacheReport(const std::vector<CheckResult>& checks)
+{
+	return ResourceCacheBenchmark::Report(checks, ResourceCacheBenchmark::RunBenchmarks());
+}
+
+std::wstring FrameSchedulerReport(const std::vector<CheckResult>& checks)
+{
+	return FrameSchedulerBenchmark::Report(checks, FrameSchedulerBenchmark::RunBenchmarks());
+}
+
+std::wstring YuvConvertReport(const std::vector<CheckResult>& checks)
+{
+	return YuvConvertBenchmark::Report(checks, YuvConvertBenchmark::RunBenchmarks());
+}
+
+std::wstring VideoFrameQueueReport(const std::vector<CheckResult>& checks)
+{
+	return VideoFrameQueueBenchmark::Report(checks, VideoFrameQueueBenchmark::RunBenchmarks());
+}
+
+std::wstring WsolaReport(const std::vector<CheckResult>& checks)
+{
+	return WsolaBenchmark::Report(checks, WsolaBenchmark::RunBenchmarks());
+}
+
+std::wstring AudioRingReport(const std::vector<CheckResult>& checks)
+{
+	return AudioRingBenchmark::Report(checks, AudioRingBenchmark::RunBenchmarks());
+}
+
+std::wstring PlaybackTelemetryReport(const std::vector<CheckResult>& checks)
+{
+	return PlaybackTelemetryBenchmark::Report(checks, PlaybackTelemetryBenchmark::RunBenchmarks());
+}
+
+std::wstring TextBufferReport(const std::vector<CheckResult>& checks)
+{
+	return TextBufferBenchmark::Report(checks, TextBufferBenchmark::RunBenchmarks());
+}
+
+std::wstring LogLineBufferReport(const std::vector<CheckResult>& checks)
+{
+	return LogLineBufferBenchmark::Report(checks, LogLineBufferBenchmark::RunBenchmarks());
+}
+
+std::wstring GridSortReport(const std::vector<CheckResult>& checks)
+{
+	return GridSortBenchmark::Report(checks, GridSortBenchmark::RunBenchmarks());
+}
+
+std::wstring GridTextIndexReport(const std::vector<CheckResult>& checks)
+{
+	return GridTextIndexBenchmark::Report(checks, GridTextIndexBenchmark::RunBenchmarks());
+}
+
+std::wstring TextWidthCacheReport(const std::vector<CheckResult>& checks)
+{
+	return TextWidthCacheBenchmark::Report(checks, TextWidthCacheBenchmark::RunBenchmarks());
+}
+
+std::wstring TreeRowIndexReport(const std::vector<CheckResult>& checks)
+{
+	return TreeRowIndexBenchmark::Report(checks, TreeRowIndexBenchmark::RunBenchmarks());
+}
+
+std::wstring LayoutReport(const std::vector<CheckResult>& checks)
+{
+	return LayoutBenchmark::Report(checks, LayoutBenchmark::RunBenchmarks());
+}
+
+std::wstring SpatialIndexReport(const std::vector<CheckResult>& checks)
+{
+	return SpatialIndexBenchmark::Report(checks, SpatialIndexBenchmark::RunBenchmarks());
+}
+
+std::wstring GridRowCacheReport(const std::vector<CheckResult>& checks)
+{
+	return GridRowCacheBenchmark::Report(checks, GridRowCacheBenchmark::RunBenchmarks());
+}
+
+#ifdef CUICHECK_WINDOWS_SUITES
+std::wstring TextLayoutCacheReport(const std::vector<CheckResult>& checks)
+{
+	return TextLayoutCacheBenchmark::Report(checks, TextLayoutCacheBenchmark::RunBenchmarks());
+}
+
+std::wstring GridViewColumnStoreReport(const std::vector<CheckResult>& checks)
+{
+	return GridViewColumnStoreBenchmark::Report(checks, GridViewColumnStoreBenchmark::RunBenchmarks());
+}
+#endif
+
+} // namespace
+
+const std::vector<CheckSuite>& AllCheckSuites()
+{
+	static const std::vector<CheckSuite> suites = {
+		{ "dirty-region", L"脏区域", &DirtyRegionBenchmark::RunChecks, &DirtyRegionReport },
+		{ "display-list", L"显示列表", &DisplayListBenchmark::RunChecks, &DisplayListReport },
+		{ "raster", L"软件光栅", &SoftwareRasterizerBenchmark::RunChecks, &SoftwareRasterizerReport },
+		{ "resource-cache", L"资源缓存", &ResourceCacheBenchmark::RunChecks, &ResourceCacheReport },
+		{ "frame-scheduler", L"帧节拍", &FrameSchedulerBenchmark::RunChecks, &FrameSchedulerReport },
+		{ "yuv", L"颜色转换", &YuvConvertBenchmark::RunChecks, &YuvConvertReport },
+		{ "video-frame-queue", L"视频帧队列", &VideoFrameQueueBenchmark::RunChecks, &VideoFrameQueueReport },
+		{ "wsola", L"WSOLA 变速", &WsolaBenchmark::RunChecks, &WsolaReport },
+		{ "audio-ring", L"音频环", &AudioRingBenchmark::RunChecks, &AudioRingReport },
+		{ "playback-telemetry", L"播放遥测", &PlaybackTelemetryBenchmark::RunChecks, &PlaybackTelemetryReport },
+		{ "text-buffer", L"文本缓冲", &TextBufferBenchmark::RunChecks, &TextBufferReport },
+		{ "log-lines", L"日志行缓冲", &LogLineBufferBenchmark::RunChecks, &LogLineBufferReport },
+		{ "grid-sort", L"表格排序", &GridSortBenchmark::RunChecks, &GridSortReport },
+		{ "grid-text-index", L"表格文本索引", &GridTextIndexBenchmark::RunChecks, &GridTextIndexReport },
+		{ "text-width", L"文本宽度缓存", &TextWidthCacheBenchmark::RunChecks, &TextWidthCacheReport },
+		{ "tree-rows", L"树形行索引", &TreeRowIndexBenchmark::RunChecks, &TreeRowIndexReport },
+		{ "layout", L"布局", &LayoutBenchmark::RunChecks, &LayoutReport },
+		{ "spatial-index", L"空间索引", &SpatialIndexBenchmark::RunChecks, &SpatialIndexReport },
+		{ "grid-rows", L"表格行缓存", &GridRowCacheBenchmark::RunChecks, &GridRowCacheReport },
+#ifdef CUICHECK_WINDOWS_SUITES
+		{ "text-layout", L"文本布局缓存", &TextLayoutCacheBenchmark::RunChecks, &TextLayoutCacheReport },
+		{ "grid-store", L"GridView 按列存储", &GridViewColumnStoreBenchmark::RunChecks, &GridViewColumnStoreReport },
+#endif
+	};
+	return suites;
+}
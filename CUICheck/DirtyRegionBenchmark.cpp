@@ -0,0 +1,265 @@
+#include "DirtyRegionBenchmark.h"
+#include "../CUI/GUI/DirtyRegion.h"
+#include <chrono>
+#include <functional>
+
+namespace {
+
+const int WindowWidth = 1280;
+const int WindowHeight = 800;
+
+// 固定种子的线性同余发生器：每次运行的输入一致
+struct Lcg
+{
+	unsigned int State;
+	explicit Lcg(unsigned int seed) : State(seed) {}
+	int Next(int bound)
+	{
+		State = State * 1664525u + 1013904223u;
+		return (int)((State >> 8) % (unsigned int)bound);
+	}
+};
+
+// 与 Form::Invalidate(D2D1_RECT_F) 一致：向外扩 2 像素
+DirtyRect Inflated(int x, int y, int w, int h)
+{
+	return DirtyRect(x - 2, y - 2, x + w + 2, y + h + 2);
+}
+
+void ExpectRect(CheckResult& r, const wchar_t* what, const DirtyRect& v, int left, int top, int right, int bottom)
+{
+	if (!r.Passed) return;
+	if (v.Left == left && v.Top == top && v.Right == right && v.Bottom == bottom) return;
+	r.Passed = false;
+	r.Detail = CheckFormat(L"%ls 为 (%d,%d,%d,%d)，期望 (%d,%d,%d,%d)",
+		what, v.Left, v.Top, v.Right, v.Bottom, left, top, right, bottom);
+}
+
+CheckResult CheckContainment()
+{
+	CheckResult r{ L"包含关系", true, L"" };
+	DirtyRegion region;
+	region.Add(DirtyRect(0, 0, 100, 100));
+	region.Add(DirtyRect(10, 10, 20, 20));
+	ExpectCount(r, L"被包含后矩形数", region.Count(), 1);
+	region.Add(DirtyRect(500, 500, 510, 510));
+	region.Add(DirtyRect(400, 400, 700, 700));
+	ExpectCount(r, L"吸收后矩形数", region.Count(), 2);
+	region.Add(DirtyRect(5, 5, 5, 50));
+	ExpectCount(r, L"空矩形后矩形数", region.Count(), 2);
+	return r;
+}
+
+CheckResult CheckAdjacentMerge()
+{
+	CheckResult r{ L"相邻合并", true, L"" };
+	DirtyRegion region;
+	region.Add(DirtyRect(0, 0, 50, 20));
+	region.Add(DirtyRect(50, 0, 100, 20));
+	ExpectCount(r, L"矩形数", region.Count(), 1);
+	if (region.Count() == 1)
+		ExpectRect(r, L"合并结果", region.Rects()[0], 0, 0, 100, 20);
+	return r;
+}
+
+CheckResult CheckFarApart()
+{
+	CheckResult r{ L"远距离分离", true, L"" };
+	DirtyRegion region;
+	region.Add(Inflated(20, 40, 2, 18));
+	region.Add(Inflated(1250, 770, 2, 18));
+	ExpectCount(r, L"矩形数", region.Count(), 2);
+	ExpectCount(r, L"重绘像素", region.PaintedPixels(), 2 * 6 * 22);
+	return r;
+}
+
+CheckResult CheckOverflowAndCoverage()
+{
+	CheckResult r{ L"数量上限与覆盖", true, L"" };
+	Lcg rng(12345u);
+	for (int round = 0; round < 200 && r.Passed; round++)
+	{
+		DirtyRegion region(4 + round % 6);
+		std::vector<DirtyRect> inputs;
+		for (int i = 0; i < 40; i++)
+		{
+			int x = rng.Next(WindowWidth);
+			int y = rng.Next(WindowHeight);
+			DirtyRect in(x, y, x + 1 + rng.Next(80), y + 1 + rng.Next(80));
+			inputs.push_back(in);
+			region.Add(in);
+		}
+		if (region.Count() > region.MaxRects())
+		{
+			r.Passed = false;
+			r.Detail = CheckFormat(L"第 %d 轮矩形数 %d 超过上限 %d", round, region.Count(), region.MaxRects());
+			break;
+		}
+		// 区域中的每个矩形都是若干输入的并集，因此每个输入必须完整落在某一个矩形内
+		for (const auto& in : inputs)
+		{
+			bool covered = false;
+			for (const auto& out : region.Rects())
+			{
+				if (out.Contains(in)) { covered = true; break; }
+			}
+			if (!covered)
+			{
+				r.Passed = false;
+				r.Detail = CheckFormat(L"第 %d 轮输入 (%d,%d,%d,%d) 未被覆盖", round, in.Left, in.Top, in.Right, in.Bottom);
+				break;
+			}
+		}
+		// 矩形之间不应存在包含关系
+		for (int i = 0; i < region.Count() && r.Passed; i++)
+		{
+			for (int j = 0; j < region.Count(); j++)
+			{
+				if (i != j && region.Rects()[i].Contains(region.Rects()[j]))
+				{
+					r.Passed = false;
+					r.Detail = CheckFormat(L"第 %d 轮矩形 %d 包含矩形 %d", round, i, j);
+					break;
+				}
+			}
+		}
+	}
+	return r;
+}
+
+CheckResult CheckClip()
+{
+	CheckResult r{ L"裁剪", true, L"" };
+	DirtyRegion region;
+	region.Add(DirtyRect(-10, -10, 20, 20));
+	region.Add(DirtyRect(2000, 2000, 2010, 2010));
+	region.ClipTo(DirtyRect(0, 0, WindowWidth, WindowHeight));
+	ExpectCount(r, L"矩形数", region.Count(), 1);
+	if (region.Count() == 1)
+		ExpectRect(r, L"裁剪结果", region.Rects()[0], 0, 0, 20, 20);
+	return r;
+}
+
+// 每帧调用 produce 生成本帧的 Invalidate；按双缓冲补画上一帧的脏区域
+DirtyRegionBenchmarkResult RunCase(const wchar_t* name, int frames,
+	const std::function<void(int frame, std::vector<DirtyRect>& out)>& produce)
+{
+	DirtyRegionBenchmarkResult result;
+	result.Name = name;
+	result.Frames = frames;
+	result.WindowPixels = (long long)WindowWidth * WindowHeight;
+	const DirtyRect client(0, 0, WindowWidth, WindowHeight);
+
+	std::vector<DirtyRect> invalidations;
+	DirtyRegion previous;
+	DirtyRect previousBounds;
+	long long boundsPixels = 0;
+	long long regionPixels = 0;
+	long long rects = 0;
+	double mergeSeconds = 0.0;
+	for (int f = 0; f < frames; f++)
+	{
+		invalidations.clear();
+		produce(f, invalidations);
+
+		// 旧路径：GetUpdateRect 的外接矩形（同样需要补画上一帧）
+		DirtyRect bounds;
+		for (const auto& r : invalidations)
+			bounds = bounds.Union(r);
+		bounds = bounds.Intersect(client);
+		boundsPixels += bounds.Union(previousBounds).Intersect(client).Area();
+		previousBounds = bounds;
+
+		auto t0 = std::chrono::steady_clock::now();
+		DirtyRegion frame;
+		for (const auto& r : invalidations)
+			frame.Add(r);
+		frame.ClipTo(client);
+		DirtyRegion paint;
+		paint.Add(frame);
+		paint.Add(previous);
+		auto t1 = std::chrono::steady_clock::now();
+		mergeSeconds += std::chrono::duration<double>(t1 - t0).count();
+
+		regionPixels += paint.PaintedPixels();
+		rects += paint.Count();
+		previous = frame;
+	}
+	result.BoundsPixelsPerFrame = (double)boundsPixels / frames;
+	result.RegionPixelsPerFrame = (double)regionPixels / frames;
+	result.RectsPerFrame = (double)rects / frames;
+	result.MergeMicrosPerFrame = mergeSeconds * 1e6 / frames;
+	return result;
+}
+
+} // namespace
+
+std::vector<CheckResult> DirtyRegionBenchmark::RunChecks()
+{
+	std::vector<CheckResult> results;
+	results.push_back(CheckContainment());
+	results.push_back(CheckAdjacentMerge());
+	results.push_back(CheckFarApart());
+	results.push_back(CheckOverflowAndCoverage());
+	results.push_back(CheckClip());
+	return results;
+}
+
+std::vector<DirtyRegionBenchmarkResult> DirtyRegionBenchmark::RunBenchmarks(int framesPerCase)
+{
+	if (framesPerCase < 1) framesPerCase = 1;
+	std::vector<DirtyRegionBenchmarkResult> results;
+
+	results.push_back(RunCase(L"对角两个光标闪烁", framesPerCase,
+		[](int, std::vector<DirtyRect>& out)
+		{
+			out.push_back(Inflated(20, 40, 2, 18));
+			out.push_back(Inflated(WindowWidth - 30, WindowHeight - 30, 2, 18));
+		}));
+
+	Lcg rng(2024u);
+	results.push_back(RunCase(L"随机小块失效", framesPerCase,
+		[&rng](int, std::vector<DirtyRect>& out)
+		{
+			int n = 1 + rng.Next(6);
+			for (int i = 0; i < n; i++)
+			{
+				int w = 8 + rng.Next(40);
+				int h = 8 + rng.Next(40);
+				out.push_back(Inflated(rng.Next(WindowWidth - w), rng.Next(WindowHeight - h), w, h));
+			}
+		}));
+
+	results.push_back(RunCase(L"列表滚动 + 光标", framesPerCase,
+		[](int, std::vector<DirtyRect>& out)
+		{
+			out.push_back(Inflated(10, 100, 360, 600));
+			out.push_back(Inflated(900, 400, 2, 18));
+		}));
+
+	results.push_back(RunCase(L"相邻按钮悬停切换", framesPerCase,
+		[](int f, std::vector<DirtyRect>& out)
+		{
+			int a = f % 8;
+			int b = (f + 1) % 8;
+			out.push_back(Inflated(400 + a * 90, 300, 84, 26));
+			out.push_back(Inflated(400 + b * 90, 300, 84, 26));
+		}));
+
+	return results;
+}
+
+std::wstring DirtyRegionBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<DirtyRegionBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"脏区域", checks);
+	text += CheckFormat(L"每帧重绘像素（%dx%d，双缓冲补画上一帧；外接矩形 → 多矩形区域）：\r\n", WindowWidth, WindowHeight);
+	for (const auto& b : benchmarks)
+	{
+		double boundsPct = b.WindowPixels > 0 ? b.BoundsPixelsPerFrame * 100.0 / b.WindowPixels : 0.0;
+		double regionPct = b.WindowPixels > 0 ? b.RegionPixelsPerFrame * 100.0 / b.WindowPixels : 0.0;
+		text += CheckFormat(L"  %ls：%.0f (%.2f%%) → %.0f (%.2f%%)；%.1f 个矩形；合并 %.2f 微秒/帧\r\n",
+			b.Name.c_str(), b.BoundsPixelsPerFrame, boundsPct, b.RegionPixelsPerFrame, regionPct,
+			b.RectsPerFrame, b.MergeMicrosPerFrame);
+	}
+	return text;
+}
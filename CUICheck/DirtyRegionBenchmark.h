@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * @file DirtyRegionBenchmark.h
+ * @brief 脏区域合并的离线校验与重绘像素基准（CUICheck 套件 dirty-region）。
+ *
+ * 只使用 DirtyRegion，不创建窗口、不渲染：
+ * - RunChecks：包含/相邻合并/远距离分离/矩形数上限/覆盖完整性/裁剪
+ * - RunBenchmarks：按帧模拟 Invalidate，比较“外接矩形”与“多矩形区域”每帧重绘的像素，
+ *   并按 FLIP_SEQUENTIAL 双缓冲（缓冲区年龄 2）补画上一帧脏区域
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct DirtyRegionBenchmarkResult
+{
+	std::wstring Name;
+	int Frames = 0;
+	/** @brief 窗口像素数，用于换算百分比。 */
+	long long WindowPixels = 0;
+	/** @brief 每帧平均重绘像素：单个外接矩形 / 多矩形区域。 */
+	double BoundsPixelsPerFrame = 0.0;
+	double RegionPixelsPerFrame = 0.0;
+	/** @brief 每帧平均矩形数与合并耗时（微秒）。 */
+	double RectsPerFrame = 0.0;
+	double MergeMicrosPerFrame = 0.0;
+};
+
+class DirtyRegionBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param framesPerCase 每个场景模拟的帧数。 */
+	static std::vector<DirtyRegionBenchmarkResult> RunBenchmarks(int framesPerCase = 20000);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<DirtyRegionBenchmarkResult>& benchmarks);
+};
@@ -0,0 +1,239 @@
+#include "DisplayListBenchmark.h"
+#include "../CppUtils/Graphics/DisplayList.h"
+#include <chrono>
+#include <functional>
+
+namespace {
+
+const DisplayColor Red{ 1.0f, 0.0f, 0.0f, 1.0f };
+const DisplayColor Blue{ 0.0f, 0.0f, 1.0f, 1.0f };
+const DisplayColor Gray{ 0.5f, 0.5f, 0.5f, 1.0f };
+const DisplayColor White{ 1.0f, 1.0f, 1.0f, 1.0f };
+
+DisplayRect Rect(float x, float y, float w, float h)
+{
+	return DisplayRect{ x, y, x + w, y + h };
+}
+
+// 按钮：背景、边框、居中文字
+void RecordButton(DisplayList& list, float x, float y, const std::wstring& text, bool hover)
+{
+	list.PushClip(Rect(x, y, 120, 26));
+	list.FillRect(Rect(x, y, 120, 26), hover ? Blue : Gray);
+	list.DrawString(text, x + 8, y + 4, White);
+	list.DrawRect(Rect(x, y, 120, 26), White, 1.0f);
+	list.PopClip();
+}
+
+CheckResult CheckEquality()
+{
+	CheckResult r{ L"录制与比较", true, L"" };
+	DisplayList a;
+	DisplayList b;
+	RecordButton(a, 10, 10, L"确定", false);
+	RecordButton(b, 10, 10, L"确定", false);
+	ExpectTrue(r, L"相同绘制应相等", a == b);
+	ExpectCount(r, L"命令数", (long long)a.Count(), 5);
+	ExpectCount(r, L"调色板大小", (long long)a.PaletteSize(), 2);
+	DisplayList c;
+	RecordButton(c, 10, 10, L"确定", true);
+	ExpectTrue(r, L"悬停颜色不同应不相等", a != c);
+	DisplayList d;
+	RecordButton(d, 10, 10, L"取消", false);
+	ExpectTrue(r, L"文字不同应不相等", a != d);
+	return r;
+}
+
+CheckResult CheckBatching()
+{
+	CheckResult r{ L"合批", true, L"" };
+	DisplayList same;
+	for (int i = 0; i < 10; i++)
+		same.FillRect(Rect(0, i * 20.0f, 100, 18), Gray);
+	ExpectCount(r, L"同色矩形批次数", (long long)same.BatchCount(), 1);
+
+	DisplayList alternating;
+	for (int i = 0; i < 10; i++)
+		alternating.FillRect(Rect(0, i * 20.0f, 100, 18), (i % 2) ? Gray : White);
+	ExpectCount(r, L"交替颜色批次数", (long long)alternating.BatchCount(), 10);
+
+	DisplayList mixed;
+	for (int i = 0; i < 4; i++)
+		mixed.FillRect(Rect(0, i * 20.0f, 100, 18), Gray);
+	for (int i = 0; i < 4; i++)
+		mixed.DrawRect(Rect(0, i * 20.0f, 100, 18), Gray);
+	ExpectCount(r, L"填充 + 描边批次数", (long long)mixed.BatchCount(), 2);
+	return r;
+}
+
+CheckResult CheckStateBreaksBatch()
+{
+	CheckResult r{ L"状态命令", true, L"" };
+	DisplayList list;
+	list.FillRect(Rect(0, 0, 10, 10), Gray);
+	list.FillRect(Rect(0, 10, 10, 10), Gray);
+	list.PushClip(Rect(0, 0, 5, 5));
+	list.FillRect(Rect(0, 20, 10, 10), Gray);
+	list.PopClip();
+	ExpectCount(r, L"命令数", (long long)list.Count(), 5);
+	ExpectCount(r, L"绘制命令数", (long long)list.DrawCallCount(), 3);
+	ExpectCount(r, L"批次数", (long long)list.BatchCount(), 2);
+	ExpectCount(r, L"裁剪命令数", (long long)list.CountOf(DisplayOp::PushClip), 1);
+	return r;
+}
+
+CheckResult CheckAppend()
+{
+	CheckResult r{ L"追加重映射", true, L"" };
+	DisplayList parent;
+	parent.FillRect(Rect(0, 0, 300, 200), Red);
+	DisplayList child;
+	RecordButton(child, 20, 20, L"子按钮", false);
+	parent.Append(child);
+
+	DisplayList expected;
+	expected.FillRect(Rect(0, 0, 300, 200), Red);
+	RecordButton(expected, 20, 20, L"子按钮", false);
+	ExpectTrue(r, L"追加结果应与直接录制相等", parent == expected);
+	ExpectCount(r, L"调色板大小", (long long)parent.PaletteSize(), 3);
+
+	// 自身追加：命令翻倍，调色板不增长
+	size_t before = parent.Count();
+	parent.Append(parent);
+	ExpectCount(r, L"自身追加后命令数", (long long)parent.Count(), (long long)before * 2);
+	ExpectCount(r, L"自身追加后调色板大小", (long long)parent.PaletteSize(), 3);
+	return r;
+}
+
+CheckResult CheckResources()
+{
+	CheckResult r{ L"资源去重与释放", true, L"" };
+	int released = 0;
+	int payload = 0;
+	{
+		DisplayList list;
+		std::shared_ptr<void> handle(&payload, [&released](void*) { released++; });
+		uint32_t first = list.AddResource(handle);
+		uint32_t second = list.AddResource(handle);
+		ExpectTrue(r, L"同一句柄应返回相同下标", first == second && first != DisplayList::NoResource);
+		ExpectTrue(r, L"空句柄应返回 NoResource", list.AddResource(nullptr) == DisplayList::NoResource);
+		ExpectCount(r, L"资源数", (long long)list.ResourceCount(), 1);
+		ExpectTrue(r, L"资源指针", list.Resource(first) == &payload);
+		handle.reset();
+		ExpectCount(r, L"列表持有期间释放次数", released, 0);
+
+		DisplayList copy;
+		copy.Append(list);
+		list.Reset();
+		ExpectCount(r, L"副本持有期间释放次数", released, 0);
+	}
+	ExpectCount(r, L"列表销毁后释放次数", released, 1);
+	return r;
+}
+
+// 每帧调用 record 录制一遍，统计录制与逐条遍历耗时
+DisplayListBenchmarkResult RunCase(const wchar_t* name, int frames, const std::function<void(DisplayList&)>& record)
+{
+	DisplayListBenchmarkResult result;
+	result.Name = name;
+	result.Frames = frames;
+
+	DisplayList list;
+	double recordSeconds = 0.0;
+	double walkSeconds = 0.0;
+	volatile float sink = 0.0f;
+	for (int f = 0; f < frames; f++)
+	{
+		auto t0 = std::chrono::steady_clock::now();
+		list.Reset();
+		record(list);
+		auto t1 = std::chrono::steady_clock::now();
+		// 回放的后端无关部分：解码命令、查调色板、按批次切换画刷
+		float acc = 0.0f;
+		const DisplayCommand* prev = nullptr;
+		for (const auto& c : list.Commands())
+		{
+			if (!prev || !DisplayList::SameBatch(*prev, c))
+				acc += list.Color(c.Paint).a;
+			acc += c.X + c.Y + c.Z + c.W;
+			prev = &c;
+		}
+		sink = sink + acc;
+		auto t2 = std::chrono::steady_clock::now();
+		recordSeconds += std::chrono::duration<double>(t1 - t0).count();
+		walkSeconds += std::chrono::duration<double>(t2 - t1).count();
+	}
+	(void)sink;
+	result.Commands = list.Count();
+	result.DrawCalls = list.DrawCallCount();
+	result.Batches = list.BatchCount();
+	result.Bytes = list.MemoryBytes();
+	result.RecordMicrosPerFrame = recordSeconds * 1e6 / frames;
+	result.WalkMicrosPerFrame = walkSeconds * 1e6 / frames;
+	return result;
+}
+
+} // namespace
+
+std::vector<CheckResult> DisplayListBenchmark::RunChecks()
+{
+	std::vector<CheckResult> results;
+	results.push_back(CheckEquality());
+	results.push_back(CheckBatching());
+	results.push_back(CheckStateBreaksBatch());
+	results.push_back(CheckAppend());
+	results.push_back(CheckResources());
+	return results;
+}
+
+std::vector<DisplayListBenchmarkResult> DisplayListBenchmark::RunBenchmarks(int framesPerCase)
+{
+	if (framesPerCase < 1) framesPerCase = 1;
+	std::vector<DisplayListBenchmarkResult> results;
+
+	results.push_back(RunCase(L"工具栏 24 个按钮", framesPerCase,
+		[](DisplayList& list)
+		{
+			for (int i = 0; i < 24; i++)
+				RecordButton(list, 10.0f + (i % 8) * 130.0f, 10.0f + (i / 8) * 32.0f, L"按钮", i == 5);
+		}));
+
+	// 表格：隔行底色、单元格网格线、文字；网格线同色连续，可合为一批
+	results.push_back(RunCase(L"表格 40 行 x 6 列", framesPerCase,
+		[](DisplayList& list)
+		{
+			list.FillRect(Rect(0, 0, 720, 800), White);
+			for (int row = 0; row < 40; row++)
+				list.FillRect(Rect(0, row * 20.0f, 720, 20), (row % 2) ? White : Gray);
+			for (int row = 0; row < 40; row++)
+				for (int col = 0; col < 6; col++)
+					list.DrawRect(Rect(col * 120.0f, row * 20.0f, 120, 20), Gray, 1.0f);
+			for (int row = 0; row < 40; row++)
+				for (int col = 0; col < 6; col++)
+					list.DrawString(L"单元格", col * 120.0f + 4, row * 20.0f + 2, Blue);
+		}));
+
+	results.push_back(RunCase(L"列表 200 项（同色）", framesPerCase,
+		[](DisplayList& list)
+		{
+			for (int i = 0; i < 200; i++)
+				list.FillRect(Rect(0, i * 22.0f, 300, 21), Gray);
+			for (int i = 0; i < 200; i++)
+				list.DrawString(L"列表项", 6, i * 22.0f + 3, White);
+		}));
+
+	return results;
+}
+
+std::wstring DisplayListBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<DisplayListBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"显示列表", checks);
+	text += L"每帧录制（命令数 / 绘制命令 → 回放批次；内存；录制与遍历耗时）：\r\n";
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"  %ls：%d / %d → %d 批；%d 字节；录制 %.2f 微秒，遍历 %.2f 微秒\r\n",
+			b.Name.c_str(), (int)b.Commands, (int)b.DrawCalls, (int)b.Batches, (int)b.Bytes,
+			b.RecordMicrosPerFrame, b.WalkMicrosPerFrame);
+	}
+	return text;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * @file DisplayListBenchmark.h
+ * @brief 显示列表的离线校验与录制/合批基准（CUICheck 套件 display-list）。
+ *
+ * 只使用 DisplayList，不创建设备、不渲染：
+ * - RunChecks：相等比较/合批计数/状态命令打断合批/追加时的下标重映射/资源去重与释放
+ * - RunBenchmarks：按帧录制典型控件的绘制命令，统计命令数、回放批次数、内存与录制耗时
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct DisplayListBenchmarkResult
+{
+	std::wstring Name;
+	int Frames = 0;
+	/** @brief 每帧命令数 / 其中的绘制命令数 / 回放批次数。 */
+	size_t Commands = 0;
+	size_t DrawCalls = 0;
+	size_t Batches = 0;
+	/** @brief 列表占用字节数（不含资源）。 */
+	size_t Bytes = 0;
+	/** @brief 每帧录制耗时与逐条遍历（回放的命令解码部分）耗时，微秒。 */
+	double RecordMicrosPerFrame = 0.0;
+	double WalkMicrosPerFrame = 0.0;
+};
+
+class DisplayListBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param framesPerCase 每个场景录制的帧数。 */
+	static std::vector<DisplayListBenchmarkResult> RunBenchmarks(int framesPerCase = 2000);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<DisplayListBenchmarkResult>& benchmarks);
+};
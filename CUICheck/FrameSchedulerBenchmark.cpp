@@ -0,0 +1,437 @@
+#include "FrameSchedulerBenchmark.h"
+#include "../CUI/GUI/FrameScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+const double Refresh = 1000.0 / 60.0;
+typedef FrameScheduler::Action Action;
+
+struct FakeClock
+{
+	double Now = 0.0;
+	FrameScheduler::Clock Get() { return [this]() { return Now; }; }
+};
+
+const wchar_t* ActionName(Action a)
+{
+	switch (a)
+	{
+	case Action::Idle: return L"Idle";
+	case Action::RenderNow: return L"RenderNow";
+	case Action::WaitForPaint: return L"WaitForPaint";
+	case Action::ArmTimer: return L"ArmTimer";
+	}
+	return L"?";
+}
+
+void ExpectAction(CheckResult& r, const wchar_t* what, Action value, Action expected)
+{
+	if (!r.Passed || value == expected) return;
+	r.Passed = false;
+	r.Detail = CheckFormat(L"%ls 为 %ls，期望 %ls", what, ActionName(value), ActionName(expected));
+}
+
+// 在 t 时刻完成一帧（耗时 renderMs）
+void RenderAt(FakeClock& clock, FrameScheduler& s, double t, double renderMs = 0.0)
+{
+	clock.Now = t;
+	s.BeginFrame();
+	clock.Now = t + renderMs;
+	s.EndFrame();
+}
+
+CheckResult CheckFirstFrame()
+{
+	CheckResult r{ L"首帧", true, L"" };
+	FakeClock clock;
+	FrameScheduler s(clock.Get(), Refresh);
+	clock.Now = 100.0;
+	ExpectAction(r, L"首个请求", s.Request(), Action::WaitForPaint);
+	ExpectAction(r, L"随后的 WM_PAINT", s.OnPaint(), Action::RenderNow);
+	ExpectCount(r, L"待绘帧", s.HasPendingFrame() ? 1 : 0, 1);
+	RenderAt(clock, s, 100.0, 2.0);
+	ExpectCount(r, L"绘制后待绘帧", s.HasPendingFrame() ? 1 : 0, 0);
+	ExpectCount(r, L"帧数", (long long)s.GetStats().Frames, 1);
+	return r;
+}
+
+CheckResult CheckCoalesce()
+{
+	CheckResult r{ L"同周期合并", true, L"" };
+	FakeClock clock;
+	FrameScheduler s(clock.Get(), Refresh);
+	RenderAt(clock, s, 0.0, 1.0);
+	clock.Now = 1.0;
+	double delay = 0.0;
+	ExpectAction(r, L"周期内首个请求", s.Request(&delay), Action::ArmTimer);
+	ExpectNear(r, L"定时器延迟", delay, Refresh - 1.0);
+	for (int i = 2; i <= 10; i++)
+	{
+		clock.Now = (double)i;
+		ExpectAction(r, L"后续请求", s.Request(), Action::Idle);
+	}
+	ExpectCount(r, L"合并请求数", (long long)s.GetStats().Coalesced, 9);
+	clock.Now = Refresh;
+	ExpectAction(r, L"定时器到期", s.OnTimer(), Action::RenderNow);
+	RenderAt(clock, s, Refresh);
+	ExpectNear(r, L"延迟", s.GetStats().AverageLatency, Refresh - 1.0);
+	return r;
+}
+
+CheckResult CheckDeferredPaint()
+{
+	CheckResult r{ L"推迟系统绘制", true, L"" };
+	FakeClock clock;
+	FrameScheduler s(clock.Get(), Refresh);
+	RenderAt(clock, s, 0.0);
+	clock.Now = 5.0;
+	double delay = 0.0;
+	ExpectAction(r, L"周期内 WM_PAINT", s.OnPaint(&delay), Action::ArmTimer);
+	ExpectNear(r, L"定时器延迟", delay, Refresh - 5.0);
+	clock.Now = 6.0;
+	ExpectAction(r, L"再次 WM_PAINT", s.OnPaint(), Action::Idle);
+	ExpectCount(r, L"推迟次数", (long long)s.GetStats().Deferred, 2);
+	clock.Now = 40.0;
+	ExpectAction(r, L"下一周期 WM_PAINT", s.OnPaint(), Action::RenderNow);
+	return r;
+}
+
+CheckResult CheckLowLatency()
+{
+	CheckResult r{ L"低延迟模式", true, L"" };
+	FakeClock clock;
+	FrameScheduler s(clock.Get(), Refresh);
+	s.SetLowLatency(true);
+	RenderAt(clock, s, 0.0);
+	clock.Now = 20.0;
+	ExpectAction(r, L"周期外请求", s.Request(), Action::RenderNow);
+	RenderAt(clock, s, 20.0, 1.0);
+	clock.Now = 25.0;
+	double delay = 0.0;
+	ExpectAction(r, L"周期内请求", s.Request(&delay), Action::ArmTimer);
+	ExpectNear(r, L"定时器延迟", delay, 20.0 + Refresh - 25.0);
+	return r;
+}
+
+CheckResult CheckRequestDuringFrame()
+{
+	CheckResult r{ L"绘制中请求", true, L"" };
+	FakeClock clock;
+	FrameScheduler s(clock.Get(), Refresh);
+	clock.Now = 0.0;
+	s.BeginFrame();
+	clock.Now = 2.0;
+	ExpectAction(r, L"绘制中请求", s.Request(), Action::Idle);
+	clock.Now = 4.0;
+	double delay = 0.0;
+	ExpectAction(r, L"EndFrame", s.EndFrame(&delay), Action::ArmTimer);
+	ExpectNear(r, L"定时器延迟", delay, Refresh - 4.0);
+	ExpectCount(r, L"待绘帧", s.HasPendingFrame() ? 1 : 0, 1);
+	return r;
+}
+
+CheckResult CheckEarlyTimer()
+{
+	CheckResult r{ L"定时器早到", true, L"" };
+	FakeClock clock;
+	FrameScheduler s(clock.Get(), Refresh);
+	RenderAt(clock, s, 0.0);
+	clock.Now = 3.0;
+	s.Request();
+	// 早到 5ms：重新安排；早到 0.5ms：在容差内直接绘制
+	clock.Now = Refresh - 5.0;
+	double delay = 0.0;
+	ExpectAction(r, L"早 5ms", s.OnTimer(&delay), Action::ArmTimer);
+	ExpectNear(r, L"重新安排的延迟", delay, 5.0);
+	clock.Now = Refresh - 0.5;
+	ExpectAction(r, L"早 0.5ms", s.OnTimer(), Action::RenderNow);
+	RenderAt(clock, s, clock.Now);
+	ExpectAction(r, L"无待绘帧时到期", s.OnTimer(), Action::Idle);
+	return r;
+}
+
+CheckResult CheckStats()
+{
+	CheckResult r{ L"统计", true, L"" };
+	FakeClock clock;
+	FrameScheduler s(clock.Get(), Refresh);
+	// 耗时 1..100ms 的 100 帧，每帧开始前 2ms 请求
+	double t = 0.0;
+	for (int i = 1; i <= 100; i++)
+	{
+		clock.Now = t;
+		s.Request();
+		clock.Now = t + 2.0;
+		s.BeginFrame();
+		clock.Now = t + 2.0 + i;
+		s.EndFrame();
+		t += 2.0 + i;
+	}
+	auto stats = s.GetStats();
+	ExpectCount(r, L"帧数", (long long)stats.Frames, 100);
+	ExpectNear(r, L"平均耗时", stats.AverageFrameTime, 50.5);
+	ExpectNear(r, L"P95 耗时", stats.P95FrameTime, 95.0);
+	ExpectNear(r, L"最大耗时", stats.MaxFrameTime, 100.0);
+	ExpectNear(r, L"最近耗时", stats.LastFrameTime, 100.0);
+	ExpectNear(r, L"平均延迟", stats.AverageLatency, 2.0);
+	s.ResetStats();
+	ExpectCount(r, L"重置后帧数", (long long)s.GetStats().Frames, 0);
+	// 超过 HistorySize 帧后只统计最近的窗口
+	for (size_t i = 0; i < FrameScheduler::HistorySize + 10; i++)
+		RenderAt(clock, s, 1000.0 + i * Refresh, i < 10 ? 50.0 : 1.0);
+	ExpectNear(r, L"滑动窗口平均耗时", s.GetStats().AverageFrameTime, 1.0);
+	ExpectNear(r, L"最大耗时（自重置以来）", s.GetStats().MaxFrameTime, 50.0);
+	return r;
+}
+
+enum class Mode
+{
+	Immediate,
+	Paced,
+	LowLatency,
+};
+
+// 模拟一个窗口的消息循环：鼠标消息按固定间隔到达，每条都 Invalidate(true)；
+// 队列空闲时（下一条消息到达前）投递 WM_PAINT；定时器按系统粒度向上取整后触发。
+struct DragSim
+{
+	Mode SimMode;
+	double RenderMs;
+	double TimerGranularity;
+	FakeClock Clock;
+	FrameScheduler Scheduler;
+	bool Invalid = false;
+	double TimerAt = -1.0;
+	int Requests = 0;
+	std::vector<double> Begins;
+
+	DragSim(Mode mode, double renderMs, double timerGranularity)
+		: SimMode(mode), RenderMs(renderMs), TimerGranularity(timerGranularity), Scheduler(Clock.Get(), Refresh)
+	{
+		Scheduler.SetLowLatency(mode == Mode::LowLatency);
+	}
+
+	void Arm(double delay)
+	{
+		double at = Clock.Now + delay;
+		if (TimerGranularity > 0.0)
+			at = std::ceil(at / TimerGranularity) * TimerGranularity;
+		TimerAt = at;
+	}
+
+	void Handle(Action action, double delay)
+	{
+		if (action == Action::RenderNow)
+			Render();
+		else if (action == Action::ArmTimer)
+			Arm(delay);
+	}
+
+	void Render()
+	{
+		Invalid = false;
+		Begins.push_back(Clock.Now);
+		Scheduler.BeginFrame();
+		Clock.Now += RenderMs;
+		double delay = 0.0;
+		Action next = Scheduler.EndFrame(&delay);
+		if (SimMode != Mode::Immediate && next == Action::ArmTimer)
+			Arm(delay);
+	}
+
+	void Input()
+	{
+		Invalid = true;
+		Requests++;
+		double delay = 0.0;
+		Action action = Scheduler.Request(&delay);
+		if (SimMode == Mode::Immediate)
+		{
+			// 旧路径：每次 Invalidate(true) 都 UpdateWindow 同步绘制
+			Render();
+			return;
+		}
+		Handle(action, delay);
+	}
+
+	void Paint()
+	{
+		// BeginPaint 验证更新区域；被推迟时脏区域留在 Form 的 _pendingDirty
+		Invalid = false;
+		double delay = 0.0;
+		Action action = Scheduler.OnPaint(&delay);
+		if (action == Action::RenderNow)
+			Render();
+		else
+			Handle(action, delay);
+	}
+
+	void Timer()
+	{
+		Clock.Now = (std::max)(Clock.Now, TimerAt);
+		TimerAt = -1.0;
+		double delay = 0.0;
+		Action action = Scheduler.OnTimer(&delay);
+		Handle(action, delay);
+	}
+
+	void Run(double durationMs, double inputPeriodMs, double handlerMs)
+	{
+		double nextInput = 0.0;
+		for (int guard = 0; guard < 10000000; guard++)
+		{
+			const bool moreInput = nextInput < durationMs;
+			if (!moreInput && TimerAt < 0.0 && !Invalid) break;
+			// 消息优先级：输入 > WM_PAINT > WM_TIMER（后两者只在队列空闲时生成）
+			if (moreInput && nextInput <= Clock.Now)
+			{
+				// WM_MOUSEMOVE 由系统合并：积压时只处理最新的一条
+				while (nextInput + inputPeriodMs <= Clock.Now && nextInput + inputPeriodMs < durationMs)
+					nextInput += inputPeriodMs;
+				Input();
+				Clock.Now += handlerMs;
+				nextInput += inputPeriodMs;
+			}
+			else if (Invalid)
+			{
+				Paint();
+			}
+			else if (TimerAt >= 0.0 && TimerAt <= Clock.Now)
+			{
+				Timer();
+			}
+			else
+			{
+				double next = moreInput ? nextInput : TimerAt;
+				if (TimerAt >= 0.0 && TimerAt < next) next = TimerAt;
+				Clock.Now = (std::max)(Clock.Now, next);
+			}
+		}
+	}
+};
+
+CheckResult CheckAtMostOnePerRefresh()
+{
+	CheckResult r{ L"每周期至多一帧", true, L"" };
+	const Mode modes[] = { Mode::Paced, Mode::LowLatency };
+	const double granularities[] = { 0.0, 15.625 };
+	for (Mode mode : modes)
+	{
+		for (double g : granularities)
+		{
+			DragSim sim(mode, 3.0, g);
+			sim.Run(2000.0, 1.0, 0.05);
+			const double slack = (std::min)(1.0, Refresh * 0.1);
+			for (size_t i = 1; i < sim.Begins.size() && r.Passed; i++)
+			{
+				double gap = sim.Begins[i] - sim.Begins[i - 1];
+				if (gap < Refresh - slack - 1e-9)
+				{
+					r.Passed = false;
+					r.Detail = CheckFormat(L"%ls 模式（定时器粒度 %.3fms）第 %d 帧间隔 %.3fms",
+						mode == Mode::Paced ? L"节拍" : L"低延迟", g, (int)i, gap);
+				}
+			}
+			// 拖动结束后最后一个请求必须被画出来
+			if (r.Passed && sim.Scheduler.HasPendingFrame())
+			{
+				r.Passed = false;
+				r.Detail = L"拖动结束后仍有待绘帧";
+			}
+			if (r.Passed && (sim.Begins.empty() || sim.Begins.back() < 2000.0 - 1.0 - Refresh))
+			{
+				r.Passed = false;
+				r.Detail = L"最后一帧早于最后一次输入";
+			}
+		}
+	}
+	return r;
+}
+
+FrameSchedulerBenchmarkResult RunCase(const wchar_t* name, Mode mode, double inputPeriodMs, double timerGranularity, int seconds)
+{
+	FrameSchedulerBenchmarkResult result;
+	result.Name = name;
+	const double duration = seconds * 1000.0;
+	DragSim sim(mode, 3.0, timerGranularity);
+	sim.Run(duration, inputPeriodMs, 0.05);
+	auto stats = sim.Scheduler.GetStats();
+	result.Requests = sim.Requests;
+	result.Frames = (int)stats.Frames;
+	result.FramesPerSecond = stats.Frames * 1000.0 / duration;
+	result.AverageLatency = stats.AverageLatency;
+	result.MaxLatency = stats.MaxLatency;
+	double minGap = 0.0;
+	for (size_t i = 1; i < sim.Begins.size(); i++)
+	{
+		double gap = sim.Begins[i] - sim.Begins[i - 1];
+		if (i == 1 || gap < minGap) minGap = gap;
+	}
+	result.MinInterval = minGap;
+
+	// 调度器自身开销：真实时钟下的请求/帧循环
+	FrameScheduler real;
+	real.SetLowLatency(mode == Mode::LowLatency);
+	const int n = 200000;
+	auto t0 = std::chrono::steady_clock::now();
+	for (int i = 0; i < n; i++)
+	{
+		double delay = 0.0;
+		if (real.Request(&delay) == Action::RenderNow || (i % 64) == 0)
+		{
+			real.BeginFrame();
+			real.EndFrame(&delay);
+		}
+		if (real.TimerArmed() && (i % 16) == 0)
+			real.OnTimer(&delay);
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	result.OverheadNanosPerRequest = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+	return result;
+}
+
+} // namespace
+
+std::vector<CheckResult> FrameSchedulerBenchmark::RunChecks()
+{
+	std::vector<CheckResult> results;
+	results.push_back(CheckFirstFrame());
+	results.push_back(CheckCoalesce());
+	results.push_back(CheckDeferredPaint());
+	results.push_back(CheckLowLatency());
+	results.push_back(CheckRequestDuringFrame());
+	results.push_back(CheckEarlyTimer());
+	results.push_back(CheckStats());
+	results.push_back(CheckAtMostOnePerRefresh());
+	return results;
+}
+
+std::vector<FrameSchedulerBenchmarkResult> FrameSchedulerBenchmark::RunBenchmarks(int seconds)
+{
+	if (seconds < 1) seconds = 1;
+	std::vector<FrameSchedulerBenchmarkResult> results;
+	results.push_back(RunCase(L"拖动 / 旧路径（同步 UpdateWindow）", Mode::Immediate, 1.0, 15.625, seconds));
+	results.push_back(RunCase(L"拖动 / 节拍模式", Mode::Paced, 1.0, 15.625, seconds));
+	results.push_back(RunCase(L"拖动 / 低延迟模式", Mode::LowLatency, 1.0, 15.625, seconds));
+	results.push_back(RunCase(L"拖动 / 节拍模式（1ms 定时器）", Mode::Paced, 1.0, 1.0, seconds));
+	results.push_back(RunCase(L"键入 / 旧路径（同步 UpdateWindow）", Mode::Immediate, 50.0, 15.625, seconds));
+	results.push_back(RunCase(L"键入 / 节拍模式", Mode::Paced, 50.0, 15.625, seconds));
+	results.push_back(RunCase(L"键入 / 低延迟模式", Mode::LowLatency, 50.0, 15.625, seconds));
+	return results;
+}
+
+std::wstring FrameSchedulerBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<FrameSchedulerBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"帧节拍", checks);
+	text += CheckFormat(L"拖动 = 1000Hz 鼠标移动，键入 = 每 50ms 一次按键；每帧绘制 3ms，刷新 %.1fHz，定时器粒度 15.625ms（模拟时钟）：\r\n", 1000.0 / Refresh);
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"  %ls：%d 请求 → %d 帧（%.1f 帧/秒）；延迟 平均 %.2fms 最大 %.2fms；最小帧间隔 %.2fms；调度 %.0f 纳秒/请求\r\n",
+			b.Name.c_str(), b.Requests, b.Frames, b.FramesPerSecond, b.AverageLatency, b.MaxLatency,
+			b.MinInterval, b.OverheadNanosPerRequest);
+	}
+	return text;
+}
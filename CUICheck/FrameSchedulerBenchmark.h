@@ -0,0 +1,39 @@
+#pragma once
+
+/**
+ * @file FrameSchedulerBenchmark.h
+ * @brief 帧节拍调度的离线校验与模拟基准（CUICheck 套件 frame-scheduler）。
+ *
+ * 只使用 FrameScheduler 与假时钟，不创建窗口：
+ * - RunChecks：首帧、同周期合并、推迟系统绘制、低延迟模式、绘制中请求、定时器早到、统计、每周期至多一帧
+ * - RunBenchmarks：模拟 1000Hz 鼠标拖动与间隔 50ms 的键入（每条消息都 Invalidate(true)），
+ *   比较旧的同步 UpdateWindow、节拍模式与低延迟模式的帧率和输入到绘制的延迟
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct FrameSchedulerBenchmarkResult
+{
+	std::wstring Name;
+	int Requests = 0;
+	int Frames = 0;
+	/** @brief 模拟时长（毫秒）内的平均帧率。 */
+	double FramesPerSecond = 0.0;
+	/** @brief 从请求到开始绘制的平均/最大延迟（毫秒）。 */
+	double AverageLatency = 0.0;
+	double MaxLatency = 0.0;
+	/** @brief 相邻两帧的最小间隔（毫秒）。 */
+	double MinInterval = 0.0;
+	/** @brief 调度器本身的开销（纳秒/请求，实测）。 */
+	double OverheadNanosPerRequest = 0.0;
+};
+
+class FrameSchedulerBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param seconds 每个场景模拟的时长（秒）。 */
+	static std::vector<FrameSchedulerBenchmarkResult> RunBenchmarks(int seconds = 20);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<FrameSchedulerBenchmarkResult>& benchmarks);
+};
@@ -0,0 +1,313 @@
+#include "GridRowCacheBenchmark.h"
+#include "../CUI/GUI/Grid/GridRowCache.h"
+#include <chrono>
+#include <functional>
+
+namespace {
+
+const int ScreenRows = 40;
+
+struct FakeRow
+{
+	int Source = -1;
+	/** @brief 拉取时数据源的版本，用于确认 Invalidate 后重新拉取。 */
+	int Version = 0;
+	std::vector<std::wstring> Cells;
+};
+
+/** @brief 与 GridViewDataSource 形式相同的假数据源，记录每次 GetRows。 */
+struct FakeDataSource
+{
+	int Rows = 0;
+	int Columns = 4;
+	int Version = 0;
+	int CountCalls = 0;
+	int Calls = 0;
+	long long FetchedRows = 0;
+	int LastFirst = -1;
+
+	int GetRowCount()
+	{
+		CountCalls++;
+		return Rows;
+	}
+	void GetRows(int firstRow, int count, FakeRow* rows)
+	{
+		Calls++;
+		FetchedRows += count;
+		LastFirst = firstRow;
+		for (int i = 0; i < count; i++)
+		{
+			rows[i].Source = firstRow + i;
+			rows[i].Version = Version;
+			rows[i].Cells.clear();
+			for (int c = 0; c < Columns; c++)
+				rows[i].Cells.push_back(std::to_wstring(firstRow + i) + L"," + std::to_wstring(c));
+		}
+	}
+	void ResetCounters()
+	{
+		Calls = 0;
+		FetchedRows = 0;
+		LastFirst = -1;
+	}
+};
+
+typedef GridRowCache<FakeRow, FakeDataSource> TestCache;
+
+/** @brief 断言自上次 ResetCounters 以来的拉取次数与行数，然后清零。 */
+void ExpectFetch(CheckResult& r, const wchar_t* what, FakeDataSource& source, int calls, long long rows)
+{
+	if (r.Passed && (source.Calls != calls || source.FetchedRows != rows))
+	{
+		r.Passed = false;
+		r.Detail = CheckFormat(L"%ls：拉取 %d 次共 %lld 行，期望 %d 次共 %lld 行",
+			what, source.Calls, source.FetchedRows, calls, rows);
+	}
+	source.ResetCounters();
+}
+
+CheckResult CheckFetchCounts()
+{
+	CheckResult r{ L"拉取次数", true, L"" };
+	FakeDataSource source;
+	source.Rows = 10000;
+	TestCache cache;
+	cache.SetSource(&source, 256);
+	cache.Invalidate();
+	ExpectCount(r, L"读取行数", source.CountCalls, 1);
+	ExpectCount(r, L"行数", cache.RowCount(), 10000);
+	ExpectFetch(r, L"Invalidate 不拉取行", source, 0, 0);
+
+	cache.PrefetchScreen(0, ScreenRows);
+	ExpectFetch(r, L"首屏合并为一次", source, 1, ScreenRows);
+	cache.PrefetchScreen(0, ScreenRows);
+	ExpectFetch(r, L"同一屏再次取得", source, 0, 0);
+	FakeRow* row = cache.Get(10);
+	ExpectTrue(r, L"命中的行", row && row->Source == 10 && row->Cells.size() == 4);
+	ExpectFetch(r, L"命中", source, 0, 0);
+	row = cache.Get(5000);
+	ExpectTrue(r, L"缺失的行", row && row->Source == 5000);
+	ExpectFetch(r, L"单行缺失", source, 1, 1);
+
+	// 部分重叠：只拉取缺失的部分；中间的空洞各自一次
+	cache.Prefetch(30, ScreenRows);
+	ExpectCount(r, L"部分重叠的起始行", source.LastFirst, 40);
+	ExpectFetch(r, L"部分重叠", source, 1, 30);
+	cache.InvalidateRow(45);
+	cache.InvalidateRow(50);
+	ExpectTrue(r, L"InvalidateRow 不在缓存时返回 false", !cache.InvalidateRow(45));
+	cache.Prefetch(40, 20);
+	ExpectFetch(r, L"两个空洞", source, 2, 2);
+
+	// 越界
+	ExpectTrue(r, L"越界返回 NULL", cache.Get(10000) == nullptr && cache.Get(-1) == nullptr);
+	ExpectFetch(r, L"越界不拉取", source, 0, 0);
+	cache.Prefetch(9990, ScreenRows);
+	ExpectFetch(r, L"末屏截断", source, 1, 10);
+
+	// 没有数据源
+	TestCache empty;
+	empty.SetSource(nullptr, 16);
+	empty.Invalidate();
+	ExpectTrue(r, L"无数据源", empty.RowCount() == 0 && empty.Get(0) == nullptr);
+	return r;
+}
+
+CheckResult CheckLruEviction()
+{
+	CheckResult r{ L"LRU 淘汰", true, L"" };
+	FakeDataSource source;
+	source.Rows = 1000;
+	TestCache cache;
+	cache.SetSource(&source, 8);
+	cache.Invalidate();
+	for (int i = 0; i < 8; i++)
+		cache.Get(i);
+	ExpectCount(r, L"填满后的行数", (long long)cache.Count(), 8);
+	source.ResetCounters();
+
+	// 0 最近使用过，淘汰的是 1
+	cache.Get(0);
+	cache.Get(8);
+	ExpectTrue(r, L"最近使用的行保留", cache.Contains(0));
+	ExpectTrue(r, L"最久未使用的行被淘汰", !cache.Contains(1));
+	ExpectCount(r, L"容量不变", (long long)cache.Count(), 8);
+	ExpectFetch(r, L"淘汰前", source, 1, 1);
+	cache.Get(1);
+	ExpectFetch(r, L"被淘汰的行重新拉取", source, 1, 1);
+	ExpectTrue(r, L"接着淘汰 2", !cache.Contains(2) && cache.Contains(3));
+
+	// Peek 不改变顺序：3 仍是最久未使用的
+	ExpectTrue(r, L"Peek 命中", cache.Peek(3) && cache.Peek(3)->Source == 3);
+	ExpectTrue(r, L"Peek 不拉取", cache.Peek(2) == nullptr);
+	cache.Get(9);
+	ExpectTrue(r, L"Peek 过的行照常淘汰", !cache.Contains(3));
+	ExpectFetch(r, L"Peek", source, 1, 1);
+
+	// 固定的行（正在编辑）不淘汰
+	int editing = 4;
+	cache.Pinned = [&editing](int row) { return row == editing; };
+	for (int i = 100; i < 120; i++)
+		cache.Get(i);
+	ExpectTrue(r, L"固定的行保留", cache.Contains(4));
+	ExpectCount(r, L"固定行不超出容量", (long long)cache.Count(), 8);
+	editing = -1;
+	for (int i = 200; i < 208; i++)
+		cache.Get(i);
+	ExpectTrue(r, L"取消固定后淘汰", !cache.Contains(4));
+	return r;
+}
+
+CheckResult CheckScroll()
+{
+	CheckResult r{ L"滚动拉取", true, L"" };
+	FakeDataSource source;
+	source.Rows = 100000;
+	TestCache cache;
+	// 容量小于一屏：由 PrefetchScreen 保证至少两屏
+	cache.SetSource(&source, 16);
+	cache.Invalidate();
+	cache.PrefetchScreen(0, ScreenRows);
+	ExpectFetch(r, L"首屏", source, 1, ScreenRows);
+	ExpectCount(r, L"容量下限为两屏", (long long)cache.Capacity(), ScreenRows * 2);
+
+	// 逐行向下：每帧只拉取新露出的一行
+	for (int first = 1; first <= 500 && r.Passed; first++)
+	{
+		cache.PrefetchScreen(first, ScreenRows);
+		if (source.Calls != 1 || source.FetchedRows != 1 || source.LastFirst != first + ScreenRows - 1)
+		{
+			r.Passed = false;
+			r.Detail = CheckFormat(L"滚动到第 %d 行时拉取 %d 次共 %lld 行（起始 %d）",
+				first, source.Calls, source.FetchedRows, source.LastFirst);
+		}
+		source.ResetCounters();
+		for (int row = first; row < first + ScreenRows && r.Passed; row++)
+			ExpectTrue(r, L"当前屏全部在缓存中", cache.Contains(row));
+	}
+	ExpectTrue(r, L"缓存不超过两屏", cache.Count() <= (size_t)ScreenRows * 2);
+
+	// 向下滚 10 行：一次拉取 10 行
+	cache.PrefetchScreen(510, ScreenRows);
+	ExpectFetch(r, L"滚动 10 行", source, 1, 10);
+	// 两屏以内回滚：不拉取
+	cache.PrefetchScreen(490, ScreenRows);
+	ExpectFetch(r, L"回滚 20 行", source, 0, 0);
+	// 跳转：整屏一次拉取
+	cache.PrefetchScreen(50000, ScreenRows);
+	ExpectFetch(r, L"跳转", source, 1, ScreenRows);
+	// 跳回很远的位置：早已淘汰
+	cache.PrefetchScreen(0, ScreenRows);
+	ExpectFetch(r, L"跳回顶部", source, 1, ScreenRows);
+	return r;
+}
+
+CheckResult CheckInvalidate()
+{
+	CheckResult r{ L"失效与重新拉取", true, L"" };
+	FakeDataSource source;
+	source.Rows = 100;
+	TestCache cache;
+	cache.SetSource(&source, 64);
+	cache.Invalidate();
+	cache.PrefetchScreen(0, ScreenRows);
+	source.ResetCounters();
+
+	// 数据源内容与行数变化
+	source.Version = 1;
+	source.Rows = 30;
+	cache.Invalidate();
+	ExpectCount(r, L"新行数", cache.RowCount(), 30);
+	ExpectCount(r, L"缓存清空", (long long)cache.Count(), 0);
+	FakeRow* row = cache.Get(5);
+	ExpectTrue(r, L"重新拉取的行", row && row->Version == 1);
+	ExpectTrue(r, L"超出新行数", cache.Get(35) == nullptr);
+	ExpectFetch(r, L"Invalidate 后", source, 1, 1);
+
+	// 单行失效
+	source.Version = 2;
+	cache.InvalidateRow(5);
+	row = cache.Get(5);
+	ExpectTrue(r, L"单行重新拉取", row && row->Version == 2);
+	ExpectFetch(r, L"InvalidateRow 后", source, 1, 1);
+
+	// Clear 不重新读取行数
+	const int countCalls = source.CountCalls;
+	cache.Clear();
+	ExpectCount(r, L"Clear 不读取行数", source.CountCalls, countCalls);
+	ExpectCount(r, L"Clear 后行数不变", cache.RowCount(), 30);
+	return r;
+}
+
+struct ScrollCase
+{
+	const wchar_t* Name;
+	/** @brief 第 frame 帧的首个可见行。 */
+	std::function<int(int frame)> First;
+};
+
+double MillisSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+std::vector<CheckResult> GridRowCacheBenchmark::RunChecks()
+{
+	return {
+		CheckFetchCounts(),
+		CheckLruEviction(),
+		CheckScroll(),
+		CheckInvalidate(),
+	};
+}
+
+std::vector<GridRowCacheBenchmarkResult> GridRowCacheBenchmark::RunBenchmarks(int frames)
+{
+	std::vector<GridRowCacheBenchmarkResult> results;
+	if (frames < 1) frames = 1;
+	const int rows = 1000000;
+	const ScrollCase cases[] = {
+		{ L"逐行滚动", [](int frame) { return frame % (rows - ScreenRows); } },
+		{ L"翻页", [](int frame) { return (frame * ScreenRows) % (rows - ScreenRows); } },
+		{ L"上下往返 30 行", [](int frame) { int t = frame % 60; return 1000 + (t < 30 ? t : 60 - t); } },
+	};
+	for (const auto& c : cases)
+	{
+		FakeDataSource source;
+		source.Rows = rows;
+		TestCache cache;
+		cache.SetSource(&source, 256);
+		cache.Invalidate();
+		const auto start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < frames; frame++)
+		{
+			const int first = c.First(frame);
+			cache.PrefetchScreen(first, ScreenRows);
+			for (int row = first; row < first + ScreenRows; row++)
+				cache.Get(row);
+		}
+		GridRowCacheBenchmarkResult b;
+		b.Name = c.Name;
+		b.Frames = frames;
+		b.CallsPerFrame = (double)source.Calls / frames;
+		b.RowsPerFrame = (double)source.FetchedRows / frames;
+		b.MicrosPerFrame = MillisSince(start) * 1000.0 / frames;
+		results.push_back(b);
+	}
+	return results;
+}
+
+std::wstring GridRowCacheBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<GridRowCacheBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"表格行缓存", checks);
+	text += CheckFormat(L"100 万行虚拟表格，每帧取得一屏（%d 行），缓存容量 256：\r\n", ScreenRows);
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"  %ls：%d 帧，每帧拉取 %.2f 次 / %.2f 行，%.2f us\r\n",
+			b.Name.c_str(), b.Frames, b.CallsPerFrame, b.RowsPerFrame, b.MicrosPerFrame);
+	}
+	return text;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @file GridRowCacheBenchmark.h
+ * @brief 虚拟模式表格行缓存的校验与基准（CUICheck 套件 grid-rows）。
+ *
+ * 只使用 GridRowCache（以计数的假数据源代替 GridViewDataSource），不依赖 Win32 与 GridView：
+ * - RunChecks：连续缺失行合并为一次拉取、命中不拉取、越界截断；LRU 淘汰最久未使用的行、
+ *   Peek 不改变顺序、固定行不淘汰；滚动时只拉取新露出的行、两屏内回滚不拉取；
+ *   Invalidate 后重新读取行数并重新拉取
+ * - RunBenchmarks：逐行滚动与翻页时每帧的数据源调用次数、拉取行数与耗时
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct GridRowCacheBenchmarkResult
+{
+	std::wstring Name;
+	int Frames = 0;
+	/** @brief 每帧平均数据源调用次数与拉取的行数。 */
+	double CallsPerFrame = 0.0;
+	double RowsPerFrame = 0.0;
+	/** @brief 每帧平均耗时（微秒，含假数据源生成行）。 */
+	double MicrosPerFrame = 0.0;
+};
+
+class GridRowCacheBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param frames 每个场景模拟的帧数。 */
+	static std::vector<GridRowCacheBenchmarkResult> RunBenchmarks(int frames = 20000);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<GridRowCacheBenchmarkResult>& benchmarks);
+};
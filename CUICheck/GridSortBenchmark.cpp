@@ -0,0 +1,374 @@
+#include "GridSortBenchmark.h"
+#include "../CUI/GUI/Grid/GridRowList.h"
+#include "../CUI/GUI/Grid/GridSort.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+struct Lcg
+{
+	uint32_t State;
+	explicit Lcg(uint32_t seed) : State(seed) {}
+	uint32_t Next()
+	{
+		State = State * 1664525u + 1013904223u;
+		return State >> 8;
+	}
+};
+
+bool Number(const wchar_t* s, double& v)
+{
+	return GridSort::ParseNumber(s, std::wcslen(s), v);
+}
+
+bool Date(const wchar_t* s, double& v)
+{
+	return GridSort::ParseDate(s, std::wcslen(s), v);
+}
+
+GridSortKey Key(const std::wstring& s)
+{
+	return GridSort::MakeKey(s.c_str(), s.size());
+}
+
+CheckResult CheckParseNumber()
+{
+	CheckResult r{ L"数值解析", true, L"" };
+	struct Case { const wchar_t* Text; double Value; };
+	const Case ok[] = {
+		{ L"0", 0.0 },
+		{ L"1,234.5", 1234.5 },
+		{ L"1,234,567", 1234567.0 },
+		{ L" -3 ", -3.0 },
+		{ L"+5", 5.0 },
+		{ L"12%", 12.0 },
+		{ L"1e3", 1000.0 },
+		{ L"-2.5E-2", -0.025 },
+		{ L".5", 0.5 },
+	};
+	for (const auto& c : ok)
+	{
+		double v = 0.0;
+		ExpectTrue(r, c.Text, Number(c.Text, v));
+		ExpectNear(r, c.Text, v, c.Value);
+	}
+	const wchar_t* bad[] = { L"", L"  ", L"abc", L"1,23", L",1", L"1,2345", L"1.2.3", L"1e", L"12a", L"%", L"-", L"2024-01-01" };
+	for (const wchar_t* text : bad)
+	{
+		double v = 0.0;
+		ExpectTrue(r, CheckFormat(L"\"%ls\" 不是数值", text).c_str(), !Number(text, v));
+	}
+	return r;
+}
+
+CheckResult CheckParseDate()
+{
+	CheckResult r{ L"日期解析", true, L"" };
+	double v = -1.0;
+	ExpectTrue(r, L"1970-01-01", Date(L"1970-01-01", v));
+	ExpectNear(r, L"纪元", v, 0.0);
+	ExpectTrue(r, L"2000/03/01 12:30", Date(L"2000/03/01 12:30", v));
+	// 1970→2000 共 10957 天，再加 1 月 31 天与闰年 2 月 29 天
+	ExpectNear(r, L"2000/03/01 12:30", v, 11017.0 * 86400.0 + 12 * 3600.0 + 30 * 60.0);
+	ExpectTrue(r, L"带秒与小数", Date(L"2024-01-05T08:09:10.25", v));
+	double day = 0.0;
+	Date(L"2024-1-5", day);
+	ExpectNear(r, L"一位数月日", v - day, 8 * 3600.0 + 9 * 60.0 + 10.25);
+	ExpectTrue(r, L"1969-12-31 为负", Date(L"1969-12-31", v) && v == -86400.0);
+	const wchar_t* bad[] = { L"24-01-01", L"2024-01/05", L"2024-13-01", L"2024-01-00", L"2024-01-01 25:00", L"2024-01-01 10", L"2024-01-01x" };
+	for (const wchar_t* text : bad)
+		ExpectTrue(r, CheckFormat(L"\"%ls\" 不是日期", text).c_str(), !Date(text, v));
+	return r;
+}
+
+CheckResult CheckCompare()
+{
+	CheckResult r{ L"比较次序", true, L"" };
+	const std::wstring empty, nine = L"9", ten = L"10", pct = L"9.5%", date = L"2024-01-01", a = L"a", ab = L"ab", b = L"b";
+	ExpectTrue(r, L"空 < 数值", GridSort::Compare(Key(empty), Key(nine)) < 0);
+	ExpectTrue(r, L"数值 < 文本", GridSort::Compare(Key(ten), Key(a)) < 0);
+	ExpectTrue(r, L"9 < 10（按数值）", GridSort::Compare(Key(nine), Key(ten)) < 0);
+	ExpectTrue(r, L"9 < 9.5%", GridSort::Compare(Key(nine), Key(pct)) < 0);
+	ExpectTrue(r, L"日期按数值", GridSort::Compare(Key(ten), Key(date)) < 0);
+	ExpectTrue(r, L"前缀在前", GridSort::Compare(Key(a), Key(ab)) < 0);
+	ExpectTrue(r, L"ab < b", GridSort::Compare(Key(ab), Key(b)) < 0);
+	ExpectCount(r, L"相等", GridSort::Compare(Key(ab), Key(std::wstring(L"ab"))), 0);
+	ExpectCount(r, L"空与空相等", GridSort::Compare(Key(empty), GridSortKey()), 0);
+	ExpectTrue(r, L"无文本单元格按 Tag", GridSort::Compare(GridSort::MakeNumberKey(1), GridSort::MakeNumberKey(0)) > 0);
+	return r;
+}
+
+CheckResult CheckStableSort()
+{
+	CheckResult r{ L"并行稳定排序与 std::stable_sort 一致", true, L"" };
+	Lcg rng(42);
+	struct Item { int Key; int Seq; };
+	const size_t sizes[] = { 0, 1, 7, 1000, 50000 };
+	const unsigned workerCounts[] = { 1, 2, 3, 4, 7, 16 };
+	for (size_t n : sizes)
+	{
+		std::vector<Item> items(n);
+		for (size_t i = 0; i < n; i++)
+			items[i] = { (int)(rng.Next() % 64), (int)i };
+		auto less = [](const Item& a, const Item& b) { return a.Key < b.Key; };
+		std::vector<Item> expected = items;
+		std::stable_sort(expected.begin(), expected.end(), less);
+		for (unsigned workers : workerCounts)
+		{
+			std::vector<Item> sorted = items;
+			GridSort::ParallelStableSort(sorted, less, workers);
+			bool same = sorted.size() == expected.size();
+			for (size_t i = 0; same && i < n; i++)
+				same = sorted[i].Key == expected[i].Key && sorted[i].Seq == expected[i].Seq;
+			ExpectTrue(r, CheckFormat(L"%zu 项、%u 个线程", n, workers).c_str(), same);
+		}
+	}
+	return r;
+}
+
+CheckResult CheckParallelFor()
+{
+	CheckResult r{ L"ParallelFor 覆盖", true, L"" };
+	const size_t counts[] = { 0, 1, 5, 1000, 100003 };
+	for (size_t count : counts)
+	{
+		for (unsigned workers = 1; workers <= 8; workers++)
+		{
+			std::vector<std::atomic<int>> hits(count);
+			for (auto& h : hits) h.store(0);
+			GridSort::ParallelFor(count, [&](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++) hits[i].fetch_add(1);
+				}, workers);
+			bool once = true;
+			for (auto& h : hits) once &= h.load() == 1;
+			ExpectTrue(r, CheckFormat(L"%zu 项、%u 个线程每项一次", count, workers).c_str(), once);
+		}
+	}
+	ExpectCount(r, L"少量行不开线程", GridSort::WorkerCount(GridSort::ParallelThreshold - 1), 1);
+	return r;
+}
+
+/** @brief 测试表格：第 0 列数值（大量重复），第 1 列文本，第 2 列日期。 */
+std::vector<std::vector<std::wstring>> MakeTable(int rows, uint32_t seed)
+{
+	Lcg rng(seed);
+	std::vector<std::vector<std::wstring>> table((size_t)rows);
+	for (auto& row : table)
+	{
+		const uint32_t v = rng.Next();
+		row.push_back(v % 17 == 0 ? L"" : std::to_wstring((int)(v % 500) - 250) + (v % 3 == 0 ? L".5" : L""));
+		row.push_back(L"name-" + std::to_wstring(rng.Next() % 1000));
+		row.push_back(L"2024-" + std::to_wstring(1 + rng.Next() % 12) + L"-" + std::to_wstring(1 + rng.Next() % 28));
+	}
+	return table;
+}
+
+/** @brief 按 GridView 的方式排序：每列提取一次排序键，对行索引稳定排序。 */
+std::vector<int> SortByKeys(const std::vector<std::vector<std::wstring>>& table, int primary, bool primaryAscending,
+	int secondary, unsigned workers)
+{
+	const size_t n = table.size();
+	std::vector<GridSortKey> k1(n), k2(n);
+	GridSort::ParallelFor(n, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				k1[i] = Key(table[i][(size_t)primary]);
+				k2[i] = Key(table[i][(size_t)secondary]);
+			}
+		}, workers);
+	std::vector<int> order(n);
+	for (size_t i = 0; i < n; i++) order[i] = (int)i;
+	GridSort::ParallelStableSort(order, [&](int a, int b)
+		{
+			int cmp = GridSort::Compare(k1[(size_t)a], k1[(size_t)b]);
+			if (cmp != 0) return primaryAscending ? cmp < 0 : cmp > 0;
+			return GridSort::Compare(k2[(size_t)a], k2[(size_t)b]) < 0;
+		}, workers);
+	return order;
+}
+
+CheckResult CheckMultiColumn()
+{
+	CheckResult r{ L"多列排序与逐次解析的参考一致", true, L"" };
+	const auto table = MakeTable(20000, 7);
+	// 参考：每次比较都重新解析文本
+	std::vector<int> expected(table.size());
+	for (size_t i = 0; i < table.size(); i++) expected[i] = (int)i;
+	std::stable_sort(expected.begin(), expected.end(), [&](int a, int b)
+		{
+			int cmp = GridSort::Compare(Key(table[(size_t)a][0]), Key(table[(size_t)b][0]));
+			if (cmp != 0) return cmp > 0;
+			return GridSort::Compare(Key(table[(size_t)a][2]), Key(table[(size_t)b][2])) < 0;
+		});
+	for (unsigned workers : { 1u, 4u })
+	{
+		const auto order = SortByKeys(table, 0, false, 2, workers);
+		ExpectTrue(r, CheckFormat(L"%u 个线程", workers).c_str(), order == expected);
+	}
+	// 降序时空值排在最后
+	ExpectTrue(r, L"降序末尾为空值", !expected.empty() && table[(size_t)expected.back()][0].empty());
+	return r;
+}
+
+CheckResult CheckApplyOrder()
+{
+	CheckResult r{ L"按排列移动行后与排序结果一致", true, L"" };
+	const auto table = MakeTable(5000, 11);
+	const auto order = SortByKeys(table, 2, true, 1, 4);
+	auto rows = table;
+	GridSort::ApplyOrder(rows, order);
+	bool same = rows.size() == table.size();
+	for (size_t i = 0; same && i < rows.size(); i++)
+		same = rows[i] == table[(size_t)order[i]];
+	ExpectTrue(r, L"移动后 rows[i] 为原 rows[order[i]]", same);
+
+	// 只能移动的元素
+	std::vector<std::unique_ptr<int>> items;
+	for (int i = 0; i < 100; i++) items.push_back(std::make_unique<int>(i));
+	std::vector<int> reversed(100);
+	for (int i = 0; i < 100; i++) reversed[(size_t)i] = 99 - i;
+	GridSort::ApplyOrder(items, reversed);
+	bool moved = true;
+	for (int i = 0; i < 100; i++)
+		moved = moved && items[(size_t)i] && *items[(size_t)i] == 99 - i;
+	ExpectTrue(r, L"只能移动的元素按排列重排", moved);
+	return r;
+}
+
+/** @brief 与 List 方法同名的测试基类。 */
+struct TestRowsBase : std::vector<int>
+{
+	void Add(int v) { push_back(v); }
+	void AddRange(const std::vector<int>& v) { insert(end(), v.begin(), v.end()); }
+	void Insert(int index, int v) { insert(begin() + index, v); }
+	void RemoveAt(int index) { erase(begin() + index); }
+	int Remove(int v)
+	{
+		size_t n = size();
+		erase(std::remove(begin(), end(), v), end());
+		return (int)(n - size());
+	}
+	void Swap(int from, int to) { std::swap((*this)[(size_t)from], (*this)[(size_t)to]); }
+	void Reverse() { std::reverse(begin(), end()); }
+	void Clear() { clear(); }
+	void set(int i, int v) { (*this)[(size_t)i] = v; }
+};
+
+CheckResult CheckRowListVersion()
+{
+	CheckResult r{ L"行集合的结构修改都递增版本号", true, L"" };
+	GridRowList<TestRowsBase> rows;
+	uint64_t version = rows.Version();
+	uint64_t reorder = rows.ReorderVersion();
+	// 追加只递增 Version；其余修改两者都递增
+	auto expect = [&](const wchar_t* what, bool reorders)
+		{
+			ExpectTrue(r, CheckFormat(L"%ls 递增 Version", what).c_str(), rows.Version() > version);
+			ExpectTrue(r, CheckFormat(L"%ls %ls ReorderVersion", what, reorders ? L"递增" : L"不改变").c_str(),
+				reorders ? rows.ReorderVersion() > reorder : rows.ReorderVersion() == reorder);
+			version = rows.Version();
+			reorder = rows.ReorderVersion();
+		};
+	rows.Add(1);
+	expect(L"Add", false);
+	rows.AddRange(std::vector<int>{ 2, 3, 4, 5 });
+	expect(L"AddRange", false);
+	rows.Insert(0, 9);
+	expect(L"Insert", true);
+	rows.RemoveAt(1);
+	expect(L"RemoveAt", true);
+	rows.Remove(3);
+	expect(L"Remove", true);
+	rows.Swap(0, 1);
+	expect(L"Swap", true);
+	rows.Reverse();
+	expect(L"Reverse", true);
+	rows.set(0, 7);
+	expect(L"set", true);
+	rows.MarkChanged();
+	expect(L"MarkChanged", true);
+
+	// 排序按排列直接移动，不计为结构修改
+	GridSort::ApplyOrder(rows, std::vector<int>{ 3, 2, 1, 0 });
+	ExpectTrue(r, L"ApplyOrder 不改变版本号", rows.Version() == version && rows.ReorderVersion() == reorder);
+	ExpectTrue(r, L"ApplyOrder 结果", rows == std::vector<int>{ 2, 9, 4, 7 });
+	rows.Clear();
+	expect(L"Clear", true);
+	return r;
+}
+
+double MillisSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+std::vector<CheckResult> GridSortBenchmark::RunChecks()
+{
+	return {
+		CheckParseNumber(),
+		CheckParseDate(),
+		CheckCompare(),
+		CheckStableSort(),
+		CheckParallelFor(),
+		CheckMultiColumn(),
+		CheckApplyOrder(),
+		CheckRowListVersion(),
+	};
+}
+
+std::vector<GridSortBenchmarkResult> GridSortBenchmark::RunBenchmarks(int rows)
+{
+	if (rows < 1000) rows = 1000;
+	std::vector<GridSortBenchmarkResult> results;
+	const auto table = MakeTable(rows, 11);
+
+	{
+		// 旧路径：直接重排行对象，每次比较拷贝单元格文本并按文本比较
+		auto copy = table;
+		const auto start = std::chrono::steady_clock::now();
+		std::stable_sort(copy.begin(), copy.end(), [](const std::vector<std::wstring>& a, const std::vector<std::wstring>& b)
+			{
+				const std::wstring sa = a[0], sb = b[0];
+				return sa < sb;
+			});
+		GridSortBenchmarkResult b;
+		b.Name = L"旧路径（重排行、按文本比较）";
+		b.Rows = rows;
+		b.Milliseconds = MillisSince(start);
+		results.push_back(b);
+	}
+
+	const unsigned autoWorkers = GridSort::WorkerCount((size_t)rows);
+	std::vector<unsigned> workerCounts = { 1u };
+	if (autoWorkers > 1) workerCounts.push_back(autoWorkers);
+	for (unsigned workers : workerCounts)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		const auto order = SortByKeys(table, 0, true, 2, workers);
+		GridSortBenchmarkResult b;
+		b.Name = L"提取排序键 + 排序行索引（数值主键、日期次键）";
+		b.Rows = rows;
+		b.Workers = workers;
+		b.Milliseconds = MillisSince(start);
+		results.push_back(b);
+	}
+	return results;
+}
+
+std::wstring GridSortBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<GridSortBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"表格排序", checks);
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"%ls：%d 行，%u 个线程，%.2f ms\r\n", b.Name.c_str(), b.Rows, b.Workers, b.Milliseconds);
+	}
+	return text;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @file GridSortBenchmark.h
+ * @brief 表格排序键与并行稳定排序的校验与基准（CUICheck 套件 grid-sort）。
+ *
+ * 只使用 GridSort 与 GridRowList，不依赖 Win32 与 GridView：
+ * - RunChecks：数值（千分位/百分号/指数）与日期解析、空值 < 数值 < 文本的比较次序、
+ *   指定 1~16 个线程时 ParallelStableSort 与 std::stable_sort 逐项一致（大量相等键，检验稳定性）、
+ *   ParallelFor 每个下标恰好执行一次、多列排序键（主键降序 + 次键升序）与逐次解析文本的参考排序一致、
+ *   ApplyOrder 按排列移动行（含只能移动的元素）、行集合的追加只递增 Version 而移动/删除/替换同时递增 ReorderVersion
+ * - RunBenchmarks：旧路径（重排行对象、每次比较拷贝文本）与提取排序键后单线程/多线程排序行索引的耗时
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct GridSortBenchmarkResult
+{
+	std::wstring Name;
+	int Rows = 0;
+	/** @brief 线程数（旧路径为 1）。 */
+	unsigned Workers = 1;
+	/** @brief 排序一次的耗时（毫秒，含提取排序键）。 */
+	double Milliseconds = 0.0;
+};
+
+class GridSortBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param rows 表格行数。 */
+	static std::vector<GridSortBenchmarkResult> RunBenchmarks(int rows = 300000);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<GridSortBenchmarkResult>& benchmarks);
+};
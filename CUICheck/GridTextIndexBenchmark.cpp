@@ -0,0 +1,243 @@
+#include "GridTextIndexBenchmark.h"
+#include "../CUI/GUI/Grid/GridTextIndex.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+struct Lcg
+{
+	uint32_t State;
+	explicit Lcg(uint32_t seed) : State(seed) {}
+	uint32_t Next()
+	{
+		State = State * 1664525u + 1013904223u;
+		return State >> 8;
+	}
+};
+
+/** @brief 模拟文本列：产品名 + 编号，字母大小写混合。 */
+std::vector<std::wstring> MakeColumn(int rows, uint32_t seed)
+{
+	static const wchar_t* words[] = { L"Alpha", L"beta", L"GAMMA", L"Delta", L"Échelle", L"Σigma", L"Дельта", L"ＡＢＣ", L"widget", L"Gadget" };
+	const size_t wordCount = sizeof(words) / sizeof(words[0]);
+	Lcg rng(seed);
+	std::vector<std::wstring> column((size_t)rows);
+	for (auto& text : column)
+	{
+		text = words[rng.Next() % wordCount];
+		text += L' ';
+		text += words[rng.Next() % wordCount];
+		text += L"-" + std::to_wstring(rng.Next() % 100000);
+	}
+	return column;
+}
+
+GridTextIndex::TextReader Reader(const std::vector<std::wstring>& column)
+{
+	return [&column](int row, const wchar_t*& text, size_t& len)
+		{
+			text = column[(size_t)row].c_str();
+			len = column[(size_t)row].size();
+		};
+}
+
+std::vector<int> Scan(const std::vector<std::wstring>& column, const std::wstring& folded)
+{
+	std::vector<int> rows;
+	for (size_t i = 0; i < column.size(); i++)
+	{
+		if (GridTextIndex::ContainsFolded(column[i].c_str(), column[i].size(), folded))
+			rows.push_back((int)i);
+	}
+	return rows;
+}
+
+CheckResult CheckFold()
+{
+	CheckResult r{ L"大小写折叠", true, L"" };
+	struct Case { wchar_t In, Out; };
+	const Case cases[] = {
+		{ L'A', L'a' }, { L'z', L'z' }, { L'1', L'1' },
+		{ (wchar_t)0xC9, (wchar_t)0xE9 },   // É
+		{ (wchar_t)0xD7, (wchar_t)0xD7 },   // ×
+		{ (wchar_t)0x3A3, (wchar_t)0x3C3 }, // Σ
+		{ (wchar_t)0x3A2, (wchar_t)0x3A2 }, // 未分配码位
+		{ (wchar_t)0x414, (wchar_t)0x434 }, // Д
+		{ (wchar_t)0x401, (wchar_t)0x451 }, // Ё
+		{ (wchar_t)0xFF21, (wchar_t)0xFF41 }, // 全角 Ａ
+		{ L'中', L'中' },
+	};
+	for (const auto& c : cases)
+		ExpectCount(r, CheckFormat(L"U+%04X", (unsigned)c.In).c_str(), (long long)GridTextIndex::Fold(c.In), (long long)c.Out);
+	ExpectTrue(r, L"字符串折叠", GridTextIndex::Fold(std::wstring(L"HeLLo ДЕЛЬТА")) == L"hello дельта");
+	return r;
+}
+
+CheckResult CheckContains()
+{
+	CheckResult r{ L"折叠子串匹配", true, L"" };
+	const std::wstring text = L"Widget ÉCHELLE-42";
+	ExpectTrue(r, L"空串总匹配", GridTextIndex::ContainsFolded(text.c_str(), text.size(), L""));
+	ExpectTrue(r, L"忽略大小写", GridTextIndex::ContainsFolded(text.c_str(), text.size(), L"échelle"));
+	ExpectTrue(r, L"末尾", GridTextIndex::ContainsFolded(text.c_str(), text.size(), L"-42"));
+	ExpectTrue(r, L"不匹配", !GridTextIndex::ContainsFolded(text.c_str(), text.size(), L"gadget"));
+	ExpectTrue(r, L"比文本长", !GridTextIndex::ContainsFolded(L"ab", 2, L"abc"));
+	ExpectTrue(r, L"空文本", !GridTextIndex::ContainsFolded(nullptr, 0, L"a"));
+	return r;
+}
+
+CheckResult CheckCandidates()
+{
+	CheckResult r{ L"候选行是扫描结果的超集", true, L"" };
+	const auto column = MakeColumn(5000, 3);
+	GridTextIndex index;
+	index.Build((int)column.size(), Reader(column));
+	ExpectTrue(r, L"已建立", index.IsBuilt() && index.RowCount() == (int)column.size());
+
+	Lcg rng(17);
+	std::vector<int> candidates;
+	for (int q = 0; q < 300 && r.Passed; q++)
+	{
+		// 一半取自某行的子串，一半为随机数字串
+		std::wstring query;
+		if (q % 2 == 0)
+		{
+			const std::wstring& src = column[rng.Next() % column.size()];
+			const size_t len = 3 + rng.Next() % 6;
+			const size_t at = rng.Next() % (src.size() - (std::min)(len, src.size()) + 1);
+			query = src.substr(at, len);
+		}
+		else
+		{
+			query = std::to_wstring(100 + rng.Next() % 900);
+		}
+		const std::wstring folded = GridTextIndex::Fold(query);
+		ExpectTrue(r, L"查询可用索引", index.Candidates(folded, candidates));
+		ExpectTrue(r, L"候选行升序", std::is_sorted(candidates.begin(), candidates.end()));
+		const auto expected = Scan(column, folded);
+		ExpectTrue(r, CheckFormat(L"\"%ls\" 的候选包含全部命中行", query.c_str()).c_str(),
+			std::includes(candidates.begin(), candidates.end(), expected.begin(), expected.end()));
+	}
+	ExpectTrue(r, L"过短查询不使用索引", !index.Candidates(L"ab", candidates));
+	ExpectTrue(r, L"不存在的片段", index.Candidates(L"zzz", candidates) && candidates.empty());
+	return r;
+}
+
+CheckResult CheckTouch()
+{
+	CheckResult r{ L"Touch 标记修改的行", true, L"" };
+	auto column = MakeColumn(1000, 5);
+	GridTextIndex index;
+	index.Build((int)column.size(), Reader(column));
+	column[10] = L"brand new text";
+	column[500] = L"another brand";
+	index.Touch(500);
+	index.Touch(10);
+	index.Touch(10);
+	std::vector<int> candidates;
+	index.Candidates(GridTextIndex::Fold(std::wstring(L"BRAND")), candidates);
+	ExpectTrue(r, L"修改后的行作为候选", candidates == std::vector<int>({ 10, 500 }));
+	index.Candidates(L"alp", candidates);
+	ExpectTrue(r, L"原有片段的结果仍含修改的行",
+		std::binary_search(candidates.begin(), candidates.end(), 10) && std::binary_search(candidates.begin(), candidates.end(), 500));
+	const auto expected = Scan(column, L"alp");
+	ExpectTrue(r, L"仍是超集", std::includes(candidates.begin(), candidates.end(), expected.begin(), expected.end()));
+	index.Clear();
+	ExpectTrue(r, L"Clear", !index.IsBuilt() && index.GramCount() == 0 && !index.Candidates(L"alp", candidates));
+	return r;
+}
+
+double MillisSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+std::vector<CheckResult> GridTextIndexBenchmark::RunChecks()
+{
+	return {
+		CheckFold(),
+		CheckContains(),
+		CheckCandidates(),
+		CheckTouch(),
+	};
+}
+
+std::vector<GridTextIndexBenchmarkResult> GridTextIndexBenchmark::RunBenchmarks(int rows)
+{
+	if (rows < 1000) rows = 1000;
+	std::vector<GridTextIndexBenchmarkResult> results;
+	const auto column = MakeColumn(rows, 9);
+
+	GridTextIndex index;
+	{
+		const auto start = std::chrono::steady_clock::now();
+		index.Build(rows, Reader(column));
+		GridTextIndexBenchmarkResult b;
+		b.Name = L"建立索引";
+		b.Rows = rows;
+		b.Milliseconds = MillisSince(start);
+		b.Matches = index.GramCount();
+		b.MemoryBytes = index.MemoryUsage();
+		results.push_back(b);
+	}
+
+	const wchar_t* queries[] = { L"gadget", L"дельта-12", L"-4242", L"ａｂｃ widget-9" };
+	for (const wchar_t* query : queries)
+	{
+		const std::wstring folded = GridTextIndex::Fold(std::wstring(query));
+		const int repeats = 5;
+		{
+			std::vector<int> hits;
+			const auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < repeats; i++)
+				hits = Scan(column, folded);
+			GridTextIndexBenchmarkResult b;
+			b.Name = CheckFormat(L"逐行扫描 \"%ls\"", query);
+			b.Rows = rows;
+			b.Milliseconds = MillisSince(start) / repeats;
+			b.Matches = hits.size();
+			results.push_back(b);
+		}
+		{
+			std::vector<int> candidates, hits;
+			const auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < repeats; i++)
+			{
+				hits.clear();
+				index.Candidates(folded, candidates);
+				for (int row : candidates)
+				{
+					const auto& text = column[(size_t)row];
+					if (GridTextIndex::ContainsFolded(text.c_str(), text.size(), folded))
+						hits.push_back(row);
+				}
+			}
+			GridTextIndexBenchmarkResult b;
+			b.Name = CheckFormat(L"索引候选 + 确认 \"%ls\"（候选 %zu）", query, candidates.size());
+			b.Rows = rows;
+			b.Milliseconds = MillisSince(start) / repeats;
+			b.Matches = hits.size();
+			results.push_back(b);
+		}
+	}
+	return results;
+}
+
+std::wstring GridTextIndexBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<GridTextIndexBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"表格文本索引", checks);
+	for (const auto& b : benchmarks)
+	{
+		if (b.MemoryBytes)
+		{
+			text += CheckFormat(L"%ls：%d 行，%.2f ms，%zu 个片段，%.1f MB\r\n",
+				b.Name.c_str(), b.Rows, b.Milliseconds, b.Matches, (double)b.MemoryBytes / (1024.0 * 1024.0));
+			continue;
+		}
+		text += CheckFormat(L"  %ls：%.3f ms，命中 %zu 行\r\n", b.Name.c_str(), b.Milliseconds, b.Matches);
+	}
+	return text;
+}
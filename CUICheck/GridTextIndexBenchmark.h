@@ -0,0 +1,36 @@
+#pragma once
+
+/**
+ * @file GridTextIndexBenchmark.h
+ * @brief 表格文本列 n-gram 索引的校验与基准（CUICheck 套件 grid-text-index）。
+ *
+ * 只使用 GridTextIndex，不依赖 Win32 与 GridView：
+ * - RunChecks：大小写折叠（ASCII/Latin-1/希腊/西里尔/全角）、折叠子串匹配、
+ *   随机查询的候选行是逐行扫描结果的升序超集、过短查询交由调用方扫描、
+ *   Touch 标记的行总作为候选、不存在的片段只返回被修改的行
+ * - RunBenchmarks：逐行折叠扫描与“索引候选 + 逐行确认”的查询耗时，以及建索引耗时与内存
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct GridTextIndexBenchmarkResult
+{
+	std::wstring Name;
+	int Rows = 0;
+	/** @brief 每次查询（或一次建索引）的耗时（毫秒）。 */
+	double Milliseconds = 0.0;
+	/** @brief 命中行数（建索引时为片段数）。 */
+	size_t Matches = 0;
+	/** @brief 索引占用（字节；仅建索引一项）。 */
+	size_t MemoryBytes = 0;
+};
+
+class GridTextIndexBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param rows 文本列行数。 */
+	static std::vector<GridTextIndexBenchmarkResult> RunBenchmarks(int rows = 500000);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<GridTextIndexBenchmarkResult>& benchmarks);
+};
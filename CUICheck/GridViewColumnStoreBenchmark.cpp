@@ -0,0 +1,328 @@
+#include "GridViewColumnStoreBenchmark.h"
+#include "../CUI/GUI/GridViewColumnStore.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace {
+
+// 测试表格的列：文本、勾选、下拉、图片、按钮
+const int TextCol = 0;
+const int CheckCol = 1;
+const int ComboCol = 2;
+const int ImageCol = 3;
+const int ButtonCol = 4;
+
+void AddTestColumns(GridViewColumnStore& store)
+{
+	store.AddColumn(ColumnType::Text);
+	store.AddColumn(ColumnType::Check);
+	store.AddColumn(ColumnType::ComboBox);
+	store.AddColumn(ColumnType::Image);
+	store.AddColumn(ColumnType::Button);
+}
+
+// 每行可区分的文本，长度由调用方指定
+std::wstring RowText(int row, int length)
+{
+	std::wstring s = L"r" + std::to_wstring(row) + L":";
+	while ((int)s.size() < length)
+		s.push_back((wchar_t)(L'a' + (s.size() + row) % 26));
+	s.resize((size_t)length);
+	return s;
+}
+
+/** @brief 逐行比较全部列与期望值（期望值由 row 的原始编号决定）。 */
+void ExpectRow(CheckResult& r, const wchar_t* what, const GridViewColumnStore& store, int row, int source,
+	int textLength, const std::shared_ptr<BitmapSource>& image)
+{
+	if (!r.Passed) return;
+	const std::wstring text = store.GetText(row, TextCol);
+	const std::wstring expected = RowText(source, textLength);
+	if (text != expected)
+	{
+		r.Passed = false;
+		r.Detail = CheckFormat(L"%ls：第 %d 行文本为 \"%ls\"，期望 \"%ls\"", what, row, text.c_str(), expected.c_str());
+		return;
+	}
+	if (store.GetChecked(row, CheckCol) != (source % 3 == 0)
+		|| store.GetComboIndex(row, ComboCol) != source % 5
+		|| (store.GetImage(row, ImageCol) != nullptr) != (source % 50 == 0)
+		|| (source % 50 == 0 && store.GetImage(row, ImageCol) != image)
+		|| store.GetTag(row, ButtonCol) != (source % 7 == 0 ? (__int64)source * 1000 : 0))
+	{
+		r.Passed = false;
+		r.Detail = CheckFormat(L"%ls：第 %d 行（原第 %d 行）的勾选/下拉/图片/Tag 与写入不一致", what, row, source);
+	}
+}
+
+void FillRow(GridViewColumnStore& store, int row, int textLength, const std::shared_ptr<BitmapSource>& image)
+{
+	store.SetText(row, TextCol, RowText(row, textLength));
+	store.SetChecked(row, CheckCol, row % 3 == 0);
+	store.SetComboIndex(row, ComboCol, row % 5);
+	store.SetImage(row, ImageCol, row % 50 == 0 ? image : nullptr);
+	store.SetTag(row, ButtonCol, row % 7 == 0 ? (__int64)row * 1000 : 0);
+}
+
+void ExpectEmptyRow(CheckResult& r, const wchar_t* what, const GridViewColumnStore& store, int row)
+{
+	if (!r.Passed) return;
+	for (int col = 0; col < store.ColumnCount(); col++)
+	{
+		if (!store.GetText(row, col).empty() || store.GetChecked(row, col) || store.GetComboIndex(row, col) != 0
+			|| store.GetImage(row, col) != nullptr || store.GetTag(row, col) != 0)
+		{
+			r.Passed = false;
+			r.Detail = CheckFormat(L"%ls：新行 %d 的第 %d 列残留旧值", what, row, col);
+			return;
+		}
+	}
+}
+
+CheckResult CheckRoundTrip()
+{
+	CheckResult r{ L"Set/Get 往返", true, L"" };
+	auto image = BitmapSource::CreateEmpty(1, 1);
+	ExpectTrue(r, L"创建测试图片", image != nullptr);
+	GridViewColumnStore store;
+	AddTestColumns(store);
+	store.Resize(200);
+	ExpectCount(r, L"行数", store.RowCount(), 200);
+	// 勾选位图跨 64 位字边界，文本长度含 0
+	for (int row = 0; row < 200; row++)
+		FillRow(store, row, row % 17, image);
+	for (int row = 0; row < 200; row++)
+		ExpectRow(r, L"写入后", store, row, row, row % 17, image);
+
+	// 类型不符与越界的写入被忽略，读取返回空值
+	store.SetText(5, CheckCol, L"忽略");
+	ExpectTrue(r, L"勾选列不保存文本", store.GetText(5, CheckCol).empty());
+	ExpectTrue(r, L"勾选列不受文本写入影响", store.GetChecked(5, CheckCol) == (5 % 3 == 0));
+	store.SetText(200, TextCol, L"越界");
+	ExpectTrue(r, L"越界读取", store.GetText(200, TextCol).empty() && store.GetText(-1, TextCol).empty());
+
+	// CellValue：文本列带 Tag，勾选/下拉取 Tag，按钮列只保存 Tag
+	CellValue text(L"单元格");
+	text.Tag = 42;
+	store.SetCell(3, TextCol, text);
+	CellValue got = store.GetCell(3, TextCol);
+	ExpectTrue(r, L"文本单元格", got.Text == L"单元格" && got.Tag == 42);
+	CellValue check;
+	check.Tag = 1;
+	store.SetCell(4, CheckCol, check);
+	ExpectCount(r, L"勾选单元格", store.GetCell(4, CheckCol).Tag, 1);
+	CellValue combo;
+	combo.Tag = 3;
+	store.SetCell(4, ComboCol, combo);
+	ExpectCount(r, L"下拉单元格", store.GetComboIndex(4, ComboCol), 3);
+	CellValue button(L"按钮");
+	button.Tag = 9;
+	store.SetCell(4, ButtonCol, button);
+	got = store.GetCell(4, ButtonCol);
+	ExpectTrue(r, L"按钮单元格只保存 Tag", got.Text.empty() && got.Tag == 9);
+	CellValue noImage;
+	store.SetCell(0, ImageCol, noImage);
+	ExpectTrue(r, L"清除图片", store.GetImage(0, ImageCol) == nullptr);
+	return r;
+}
+
+CheckResult CheckInPlaceText()
+{
+	CheckResult r{ L"文本原位缩短与变长", true, L"" };
+	GridViewColumnStore store;
+	store.AddColumn(ColumnType::Text);
+	store.Resize(100);
+	for (int row = 0; row < 100; row++)
+		store.SetText(row, 0, RowText(row, 40));
+	const size_t before = store.MemoryUsage();
+
+	// 缩短：原位覆盖，字符池不增长
+	for (int row = 0; row < 100; row++)
+		store.SetText(row, 0, RowText(row, 10));
+	ExpectCount(r, L"缩短后内存", (long long)store.MemoryUsage(), (long long)before);
+	for (int row = 0; row < 100; row++)
+		ExpectTrue(r, L"缩短后内容", store.GetText(row, 0) == RowText(row, 10));
+
+	// 缩短后再变长（未超过原长度也追加，因为原位只保留新长度），相邻行不受影响
+	store.SetText(50, 0, RowText(50, 30));
+	ExpectTrue(r, L"变长后内容", store.GetText(50, 0) == RowText(50, 30));
+	ExpectTrue(r, L"前一行不变", store.GetText(49, 0) == RowText(49, 10));
+	ExpectTrue(r, L"后一行不变", store.GetText(51, 0) == RowText(51, 10));
+	store.SetText(50, 0, L"");
+	ExpectTrue(r, L"清空文本", store.GetText(50, 0).empty());
+	store.SetText(50, 0, RowText(50, 200));
+	ExpectTrue(r, L"清空后重写", store.GetText(50, 0) == RowText(50, 200));
+	return r;
+}
+
+CheckResult CheckCompaction()
+{
+	CheckResult r{ L"字符池整理", true, L"" };
+	GridViewColumnStore store;
+	store.AddColumn(ColumnType::Text);
+	const int rows = 100;
+	store.Resize(rows);
+	// 长短交替改写：每次变长都追加到池尾，累计写入约 3000 万字符
+	const int rounds = 1000;
+	for (int round = 0; round < rounds; round++)
+	{
+		const int length = (round & 1) ? 300 : 100;
+		for (int row = 0; row < rows; row++)
+			store.SetText(row, 0, RowText(row + round, length));
+	}
+	for (int row = 0; row < rows; row++)
+	{
+		if (store.GetText(row, 0) != RowText(row + rounds - 1, 300))
+		{
+			r.Passed = false;
+			r.Detail = CheckFormat(L"整理后第 %d 行文本不一致", row);
+			break;
+		}
+	}
+	// 有效字符约 3 万；废弃字符达到 64K 且超过有效字符时整理，池容量不会随改写次数增长
+	const size_t bound = 1024 * 1024;
+	ExpectTrue(r, CheckFormat(L"内存 %zu 字节不超过 1MB", store.MemoryUsage()).c_str(), store.MemoryUsage() <= bound);
+	return r;
+}
+
+CheckResult CheckShrinkGrow()
+{
+	CheckResult r{ L"排序后缩减与扩展", true, L"" };
+	auto image = BitmapSource::CreateEmpty(1, 1);
+	GridViewColumnStore store;
+	AddTestColumns(store);
+	store.Resize(300);
+	for (int row = 0; row < 300; row++)
+		FillRow(store, row, 8 + row % 9, image);
+
+	// 按文本降序：显示行与物理行不再一致
+	ExpectTrue(r, L"排序", store.Sort(TextCol, false));
+	std::vector<int> source;
+	for (int row = 0; row < 300; row++)
+	{
+		const std::wstring text = store.GetText(row, TextCol);
+		source.push_back(std::stoi(text.substr(1)));
+	}
+	ExpectTrue(r, L"排序改变了顺序", source[0] != 0);
+
+	// 缩减保留显示顺序的前 120 行
+	store.Resize(120);
+	ExpectCount(r, L"缩减后行数", store.RowCount(), 120);
+	for (int row = 0; row < 120; row++)
+		ExpectRow(r, L"缩减后", store, row, source[(size_t)row], 8 + source[(size_t)row] % 9, image);
+
+	// 扩展：新行为空，原有行不变
+	store.Resize(400);
+	for (int row = 0; row < 120; row++)
+		ExpectRow(r, L"扩展后", store, row, source[(size_t)row], 8 + source[(size_t)row] % 9, image);
+	for (int row = 120; row < 400; row++)
+		ExpectEmptyRow(r, L"扩展", store, row);
+	return r;
+}
+
+CheckResult CheckDeleteInsert()
+{
+	CheckResult r{ L"删除后插入", true, L"" };
+	auto image = BitmapSource::CreateEmpty(1, 1);
+	GridViewColumnStore store;
+	AddTestColumns(store);
+	store.Resize(130);
+	for (int row = 0; row < 130; row++)
+		FillRow(store, row, 12, image);
+
+	// 删除末尾 70 行后逐行追加：复用的槽位不带出被删行的勾选位、Tag、图片或文本
+	store.Resize(60);
+	for (int i = 0; i < 70; i++)
+	{
+		const int row = store.AddRow();
+		ExpectCount(r, L"追加的行号", row, 60 + i);
+		ExpectEmptyRow(r, L"AddRow", store, row);
+	}
+	for (int row = 0; row < 60; row++)
+		ExpectRow(r, L"保留的行", store, row, row, 12, image);
+
+	// 追加的行可独立写入
+	store.SetText(100, TextCol, L"新行");
+	store.SetChecked(100, CheckCol, true);
+	ExpectTrue(r, L"写入新行", store.GetText(100, TextCol) == L"新行" && store.GetChecked(100, CheckCol));
+	ExpectTrue(r, L"相邻新行仍为空", !store.GetChecked(99, CheckCol) && !store.GetChecked(101, CheckCol));
+
+	// Clear 保留列定义，之后的行同样为空
+	store.Clear();
+	ExpectCount(r, L"清空后行数", store.RowCount(), 0);
+	ExpectCount(r, L"清空后列数", store.ColumnCount(), 5);
+	store.Resize(10);
+	for (int row = 0; row < 10; row++)
+		ExpectEmptyRow(r, L"Clear 后", store, row);
+	return r;
+}
+
+double MillisSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+std::vector<CheckResult> GridViewColumnStoreBenchmark::RunChecks()
+{
+	return {
+		CheckRoundTrip(),
+		CheckInPlaceText(),
+		CheckCompaction(),
+		CheckShrinkGrow(),
+		CheckDeleteInsert(),
+	};
+}
+
+std::vector<GridViewColumnStoreBenchmarkResult> GridViewColumnStoreBenchmark::RunBenchmarks(int rows)
+{
+	std::vector<GridViewColumnStoreBenchmarkResult> results;
+	if (rows < 1) rows = 1;
+	auto image = BitmapSource::CreateEmpty(1, 1);
+	GridViewColumnStore store;
+	AddTestColumns(store);
+	store.Resize(rows);
+	size_t textChars = 0;
+	for (int row = 0; row < rows; row++)
+	{
+		const int length = 6 + row % 20;
+		FillRow(store, row, length, image);
+		// 超出短字符串缓冲（MSVC 为 7 个字符）的文本在每个 CellValue 中另占一块堆内存
+		if (length > 7) textChars += (size_t)length + 1;
+	}
+
+	GridViewColumnStoreBenchmarkResult b;
+	b.Name = L"文本/勾选/下拉/图片/按钮";
+	b.Rows = rows;
+	b.Columns = store.ColumnCount();
+	b.StoreBytesPerRow = (double)store.MemoryUsage() / rows;
+	b.RowBytesPerRow = (double)(sizeof(GridViewRow) + sizeof(CellValue) * (size_t)b.Columns)
+		+ (double)(textChars * sizeof(wchar_t)) / rows;
+
+	const int screen = 40;
+	const int screens = 2000;
+	std::vector<GridViewRow> buffer((size_t)screen);
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < screens; i++)
+	{
+		const int first = (int)(((long long)i * 7919) % (long long)(std::max)(1, rows - screen));
+		store.GetRows(first, (std::min)(screen, rows - first), buffer.data());
+	}
+	b.MicrosPerScreen = MillisSince(start) * 1000.0 / screens;
+	results.push_back(b);
+	return results;
+}
+
+std::wstring GridViewColumnStoreBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<GridViewColumnStoreBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"GridView 按列存储", checks);
+	text += L"每行内存（按列存储 → 等价的 GridViewRow）与每屏 40 行 GetRows 耗时：\r\n";
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"  %ls：%d 行 x %d 列，%.1f → %.1f 字节/行，%.2f us/屏\r\n",
+			b.Name.c_str(), b.Rows, b.Columns, b.StoreBytesPerRow, b.RowBytesPerRow, b.MicrosPerScreen);
+	}
+	return text;
+}
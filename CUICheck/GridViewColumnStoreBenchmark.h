@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @file GridViewColumnStoreBenchmark.h
+ * @brief GridView 按列存储的校验与基准（CUICheck 套件 grid-store，仅 Windows）。
+ *
+ * 只使用 GridViewColumnStore，不创建 GridView 与窗口：
+ * - RunChecks：各列类型的 Set/Get 往返（含位图跨字边界、稀疏 Tag/Image）、文本原位缩短与变长追加、
+ *   字符池整理后内容不变且内存有界、排序后缩减/扩展行数、删除末尾行后追加的行不残留旧值
+ * - RunBenchmarks：大表格的每行内存与按屏生成 CellValue 的耗时
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct GridViewColumnStoreBenchmarkResult
+{
+	std::wstring Name;
+	int Rows = 0;
+	int Columns = 0;
+	/** @brief 每行占用字节：按列存储 / 等价的 GridViewRow。 */
+	double StoreBytesPerRow = 0.0;
+	double RowBytesPerRow = 0.0;
+	/** @brief 平均每屏（40 行）GetRows 的耗时（微秒）。 */
+	double MicrosPerScreen = 0.0;
+};
+
+class GridViewColumnStoreBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param rows 基准表格的行数。 */
+	static std::vector<GridViewColumnStoreBenchmarkResult> RunBenchmarks(int rows = 200000);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<GridViewColumnStoreBenchmarkResult>& benchmarks);
+};
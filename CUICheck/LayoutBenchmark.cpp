@@ -0,0 +1,800 @@
+#include "LayoutBenchmark.h"
+#include <chrono>
+#include <map>
+
+namespace {
+
+// 不创建窗口的布局元素：与 Control/Panel 参与布局的部分一致
+// （MeasureCore 以当前尺寸加 Padding 为期望尺寸，尺寸变化通知父容器，设置了引擎时按 Panel::PerformLayout 布局子项）
+class LayoutStub : public LayoutElement
+{
+public:
+	LayoutStub* Parent = nullptr;
+	std::vector<LayoutStub*> Children;
+	bool Visible = true;
+	Thickness Margin;
+	Thickness Padding;
+	HorizontalAlignment HAlign = HorizontalAlignment::Left;
+	VerticalAlignment VAlign = VerticalAlignment::Top;
+	Dock DockPosition = Dock::Fill;
+	int GridRow = 0;
+	int GridColumn = 0;
+	int GridRowSpan = 1;
+	int GridColumnSpan = 1;
+	LayoutPoint Location = { 0, 0 };
+	LayoutSize Size;
+	long long Tag = 0;
+
+	LayoutStub(int width, int height) : Size{ width, height } {}
+	virtual ~LayoutStub()
+	{
+		for (auto c : Children)
+			delete c;
+		delete _engine;
+	}
+
+	/** 接管布局引擎（Panel::SetLayoutEngine）。 */
+	template<typename Engine>
+	Engine* SetLayoutEngine(Engine* engine)
+	{
+		delete _engine;
+		_engine = engine;
+		InvalidateLayout();
+		return engine;
+	}
+	template<typename T>
+	T* Add(T* child)
+	{
+		AddChild(child);
+		InvalidateLayout();
+		return child;
+	}
+	void AddChild(LayoutStub* child)
+	{
+		child->Parent = this;
+		child->InvalidateMeasure();
+		Children.push_back(child);
+	}
+	void RemoveChild(LayoutStub* child)
+	{
+		for (size_t i = 0; i < Children.size(); i++)
+		{
+			if (Children[i] != child) continue;
+			Children.erase(Children.begin() + (ptrdiff_t)i);
+			child->Parent = nullptr;
+			return;
+		}
+	}
+	// 模拟 Control::Size 的 setter：内容变化后期望尺寸改变并通知父容器
+	void SetSize(int width, int height)
+	{
+		if (_engine) InvalidateLayout();
+		Size = LayoutSize{ width, height };
+		RequestLayout();
+	}
+	void SetVisible(bool value)
+	{
+		if (Visible == value) return;
+		Visible = value;
+		RequestLayout();
+	}
+	void InvalidateLayout()
+	{
+		_needsLayout = true;
+		if (_engine) _engine->Invalidate();
+	}
+	void PerformLayout()
+	{
+		if (_engine && (_needsLayout || _engine->NeedsLayout()))
+			_engine->Layout(this, Size, Padding);
+		_needsLayout = false;
+	}
+
+	LayoutElement* GetLayoutParent() override { return Parent; }
+	int GetLayoutChildCount() override { return (int)Children.size(); }
+	LayoutElement* GetLayoutChild(int index) override { return Children[(size_t)index]; }
+	bool IsLayoutVisible() override { return Visible; }
+	Thickness GetLayoutMargin() override { return Margin; }
+	Thickness GetLayoutPadding() override { return Padding; }
+	HorizontalAlignment GetLayoutHAlign() override { return HAlign; }
+	VerticalAlignment GetLayoutVAlign() override { return VAlign; }
+	Dock GetLayoutDock() override { return DockPosition; }
+	int GetLayoutGridRow() override { return GridRow; }
+	int GetLayoutGridColumn() override { return GridColumn; }
+	int GetLayoutGridRowSpan() override { return GridRowSpan; }
+	int GetLayoutGridColumnSpan() override { return GridColumnSpan; }
+	LayoutSize GetLayoutSize() override { return Size; }
+	bool TryGetActualLayoutSize(LayoutSize& actual) override
+	{
+		actual = Size;
+		return false;
+	}
+	void ApplyLayout(LayoutPoint location, LayoutSize size) override
+	{
+		Location = location;
+		if (size.cx == Size.cx && size.cy == Size.cy) return;
+		Size = size;
+		_measureValid = false;
+		if (_engine) InvalidateLayout();
+	}
+	LayoutSize MeasureCore(LayoutSize availableSize) override
+	{
+		LayoutSize desired;
+		TryGetActualLayoutSize(desired);
+		desired.cx += (int)(Padding.Left + Padding.Right);
+		desired.cy += (int)(Padding.Top + Padding.Bottom);
+		if (desired.cx > availableSize.cx) desired.cx = availableSize.cx;
+		if (desired.cy > availableSize.cy) desired.cy = availableSize.cy;
+		return desired;
+	}
+
+protected:
+	// Control::RequestLayout：即使自身缓存已失效也要沿父链失效并通知父容器
+	void RequestLayout()
+	{
+		InvalidateMeasure();
+		if (Parent) Parent->InvalidateLayout();
+	}
+
+private:
+	LayoutEngine* _engine = nullptr;
+	bool _needsLayout = false;
+};
+
+// 实际尺寸由内容决定的桩元素（类似自动尺寸的 Label 的 ActualSize）：每个字符 8 像素宽，高 20 像素
+class TextStub : public LayoutStub
+{
+public:
+	explicit TextStub(const wchar_t* text) : LayoutStub(0, 0), _text(text) {}
+	// 与 Control::Text 的 setter 一致：内容变化总是通知布局
+	void SetText(const wchar_t* text)
+	{
+		_text = text;
+		RequestLayout();
+	}
+	bool TryGetActualLayoutSize(LayoutSize& actual) override
+	{
+		actual = LayoutSize{ (int)_text.size() * 8, 20 };
+		return actual.cx != Size.cx || actual.cy != Size.cy;
+	}
+private:
+	std::wstring _text;
+};
+
+// VirtualizingStackPanel 的桩：容器由 VirtualContainerPool 实例化/回收，Tag 记录绑定的索引
+class VirtualStub : public LayoutStub, public VirtualizingLayoutHost
+{
+public:
+	VirtualizingLayoutEngine* Layout;
+	VirtualContainerPool<LayoutStub> Containers;
+	int Created = 0;
+
+	VirtualStub(int width, int height, int itemWidth, int itemHeight)
+		: LayoutStub(width, height)
+	{
+		Layout = SetLayoutEngine(new VirtualizingLayoutEngine());
+		Containers.Create = [this, itemWidth, itemHeight]()
+			{
+				Created++;
+				return new LayoutStub(itemWidth, itemHeight);
+			};
+		Containers.Bind = [](LayoutStub* c, int index) { c->Tag = index; };
+		Containers.Attach = [this](LayoutStub* c) { AddChild(c); };
+		Containers.Detach = [this](LayoutStub* c) { RemoveChild(c); };
+	}
+	~VirtualStub() override
+	{
+		Containers.ReleasePooled([](LayoutStub* c) { delete c; });
+	}
+
+	void SetItemCount(int count)
+	{
+		_itemCount = count;
+		Containers.Rebind(count);
+		InvalidateLayout();
+	}
+	// 与 VirtualizingStackPanel::SetScrollOffset / ScrollIntoView 一致
+	void SetScrollOffset(float value)
+	{
+		const auto& extent = Layout->GetExtent();
+		if (value < 0.0f) value = 0.0f;
+		if (extent.IsValid() && value > extent.MaxScrollOffset())
+			value = extent.MaxScrollOffset();
+		if (value == _scrollOffset) return;
+		_scrollOffset = value;
+		InvalidateLayout();
+	}
+	void ScrollIntoView(int index)
+	{
+		if (index < 0 || index >= _itemCount) return;
+		if (!Layout->GetExtent().IsValid())
+		{
+			InvalidateLayout();
+			PerformLayout();
+		}
+		SetScrollOffset(Layout->GetExtent().ScrollIntoView(index, _scrollOffset));
+	}
+
+	int GetItemCount() const override { return _itemCount; }
+	float GetScrollOffset() const override { return _scrollOffset; }
+	void CoerceScrollOffset(float value) override { _scrollOffset = value; }
+	const std::map<int, LayoutElement*>& GetRealized() const override { return Containers.Realized(); }
+	void RealizeRange(int first, int last) override { Containers.RealizeRange(first, last); }
+
+private:
+	int _itemCount = 0;
+	float _scrollOffset = 0.0f;
+};
+
+// 自顶向下执行布局（与 Panel::Update 的顺序一致）
+void LayoutTree(LayoutStub* c)
+{
+	c->PerformLayout();
+	for (auto child : c->Children)
+		LayoutTree(child);
+}
+
+void ExpectRect(CheckResult& r, LayoutStub* c, const wchar_t* what, int x, int y, int w, int h)
+{
+	if (!r.Passed) return;
+	LayoutPoint loc = c->Location;
+	LayoutSize size = c->Size;
+	if (loc.x == x && loc.y == y && size.cx == w && size.cy == h) return;
+	r.Passed = false;
+	r.Detail = CheckFormat(L"%ls 为 (%d,%d %dx%d)，期望 (%d,%d %dx%d)",
+		what, loc.x, loc.y, size.cx, size.cy, x, y, w, h);
+}
+
+CheckResult CheckStackVertical()
+{
+	CheckResult r{ L"StackPanel 垂直 + 间距 + Stretch", true };
+	LayoutStub stack(200, 400);
+	stack.SetLayoutEngine(new StackLayoutEngine())->SetSpacing(4);
+	auto a = stack.Add(new LayoutStub(50, 10));
+	auto b = stack.Add(new LayoutStub(60, 20));
+	auto c = stack.Add(new LayoutStub(70, 30));
+	c->HAlign = HorizontalAlignment::Stretch;
+	LayoutTree(&stack);
+	ExpectRect(r, a, L"A", 0, 0, 50, 10);
+	ExpectRect(r, b, L"B", 0, 14, 60, 20);
+	ExpectRect(r, c, L"C", 0, 38, 200, 30);
+	return r;
+}
+
+CheckResult CheckStackHorizontal()
+{
+	CheckResult r{ L"StackPanel 水平 + Margin + 居中", true };
+	LayoutStub stack(300, 100);
+	stack.SetLayoutEngine(new StackLayoutEngine())->SetOrientation(Orientation::Horizontal);
+	auto a = stack.Add(new LayoutStub(40, 20));
+	a->Margin = Thickness(5);
+	auto b = stack.Add(new LayoutStub(30, 30));
+	b->VAlign = VerticalAlignment::Center;
+	LayoutTree(&stack);
+	ExpectRect(r, a, L"A", 5, 5, 40, 20);
+	ExpectRect(r, b, L"B", 50, 35, 30, 30);
+	return r;
+}
+
+CheckResult CheckGrid()
+{
+	CheckResult r{ L"GridPanel Star/Pixel/Auto", true };
+	LayoutStub grid(400, 300);
+	auto layout = grid.SetLayoutEngine(new GridLayoutEngine());
+	layout->AddColumn(GridLength::Star(1.0f));
+	layout->AddColumn(GridLength::Star(3.0f));
+	layout->AddRow(GridLength::Pixels(40));
+	layout->AddRow(GridLength::Star(1.0f));
+	auto body = grid.Add(new LayoutStub(10, 10));
+	body->GridRow = 1;
+	body->GridColumn = 1;
+	body->HAlign = HorizontalAlignment::Stretch;
+	body->VAlign = VerticalAlignment::Stretch;
+	auto badge = grid.Add(new LayoutStub(30, 20));
+	badge->HAlign = HorizontalAlignment::Center;
+	badge->VAlign = VerticalAlignment::Bottom;
+	LayoutTree(&grid);
+	ExpectRect(r, body, L"Body", 100, 40, 300, 260);
+	ExpectRect(r, badge, L"Badge", 35, 20, 30, 20);
+
+	LayoutStub autoGrid(400, 300);
+	auto autoLayout = autoGrid.SetLayoutEngine(new GridLayoutEngine());
+	autoLayout->AddColumn(GridLength::Auto());
+	autoLayout->AddColumn(GridLength::Star(1.0f));
+	auto label = autoGrid.Add(new LayoutStub(80, 10));
+	auto fill = autoGrid.Add(new LayoutStub(10, 10));
+	fill->GridColumn = 1;
+	fill->HAlign = HorizontalAlignment::Stretch;
+	fill->VAlign = VerticalAlignment::Stretch;
+	LayoutTree(&autoGrid);
+	ExpectRect(r, label, L"Auto 列", 0, 0, 80, 10);
+	ExpectRect(r, fill, L"Star 列", 80, 0, 320, 300);
+	return r;
+}
+
+CheckResult CheckDock()
+{
+	CheckResult r{ L"DockPanel Top/Left/Fill", true };
+	LayoutStub dock(300, 200);
+	dock.SetLayoutEngine(new DockLayoutEngine());
+	auto top = dock.Add(new LayoutStub(10, 20));
+	top->DockPosition = Dock::Top;
+	auto left = dock.Add(new LayoutStub(50, 10));
+	left->DockPosition = Dock::Left;
+	auto fill = dock.Add(new LayoutStub(10, 10));
+	LayoutTree(&dock);
+	ExpectRect(r, top, L"Top", 0, 0, 300, 20);
+	ExpectRect(r, left, L"Left", 0, 20, 50, 180);
+	ExpectRect(r, fill, L"Fill", 50, 20, 250, 180);
+	return r;
+}
+
+CheckResult CheckWrap()
+{
+	CheckResult r{ L"WrapPanel 水平换行", true };
+	LayoutStub wrap(300, 200);
+	wrap.SetLayoutEngine(new WrapLayoutEngine());
+	std::vector<LayoutStub*> items;
+	for (int i = 0; i < 10; i++)
+		items.push_back(wrap.Add(new LayoutStub(70, 26)));
+	LayoutTree(&wrap);
+	for (int i = 0; i < 10; i++)
+		ExpectRect(r, items[i], CheckFormat(L"第 %d 项", i).c_str(), (i % 4) * 70, (i / 4) * 26, 70, 26);
+	return r;
+}
+
+CheckResult CheckRelative()
+{
+	CheckResult r{ L"RelativePanel 约束链", true };
+	LayoutStub panel(400, 300);
+	auto layout = panel.SetLayoutEngine(new RelativeLayoutEngine());
+	auto a = panel.Add(new LayoutStub(40, 20));
+	auto b = panel.Add(new LayoutStub(40, 20));
+	auto c = panel.Add(new LayoutStub(40, 20));
+	auto d = panel.Add(new LayoutStub(60, 20));
+	RelativeConstraints ca;
+	ca.AlignLeftWithPanel = true;
+	layout->SetConstraints(a, ca);
+	RelativeConstraints cb;
+	cb.RightOf = a;
+	layout->SetConstraints(b, cb);
+	RelativeConstraints cc;
+	cc.Below = b;
+	layout->SetConstraints(c, cc);
+	RelativeConstraints cd;
+	cd.AlignRightWithPanel = true;
+	cd.AlignBottomWithPanel = true;
+	layout->SetConstraints(d, cd);
+	LayoutTree(&panel);
+	ExpectRect(r, a, L"A", 0, 0, 40, 20);
+	ExpectRect(r, b, L"B", 40, 0, 40, 20);
+	ExpectRect(r, c, L"C", 0, 20, 40, 20);
+	ExpectRect(r, d, L"D", 340, 280, 60, 20);
+	return r;
+}
+
+CheckResult CheckMeasureCache()
+{
+	CheckResult r{ L"测量缓存：只重新测量变化的子项", true };
+	LayoutStub stack(200, 4000);
+	stack.SetLayoutEngine(new StackLayoutEngine());
+	std::vector<LayoutStub*> items;
+	for (int i = 0; i < 100; i++)
+		items.push_back(stack.Add(new LayoutStub(50, 20)));
+	LayoutTree(&stack);
+
+	auto& stats = LayoutStats::Current();
+	stats.Reset();
+	LayoutTree(&stack);
+	ExpectCount(r, L"未修改时的布局次数", (long long)stats.EngineLayouts, 0);
+
+	stats.Reset();
+	items[50]->SetSize(50, 30);
+	LayoutTree(&stack);
+	ExpectCount(r, L"布局次数", (long long)stats.EngineLayouts, 1);
+	ExpectCount(r, L"Measure 调用", (long long)stats.MeasureCalls, 100);
+	ExpectCount(r, L"MeasureCore 调用", (long long)stats.MeasureCoreCalls, 1);
+	ExpectRect(r, items[51], L"第 51 项", 0, 51 * 20 + 10, 50, 20);
+	return r;
+}
+
+CheckResult CheckContentChange()
+{
+	CheckResult r{ L"排列后内容变化：父容器按相同可用尺寸重新测量", true };
+	LayoutStub root(200, 400);
+	root.SetLayoutEngine(new StackLayoutEngine());
+	auto inner = root.Add(new LayoutStub(200, 100));
+	inner->SetLayoutEngine(new StackLayoutEngine());
+	auto label = inner->Add(new TextStub(L"abc"));
+	auto below = inner->Add(new LayoutStub(50, 20));
+	LayoutTree(&root);
+	ExpectRect(r, label, L"标签", 0, 0, 24, 20);
+	// Arrange 改变了标签尺寸，标签自身的缓存已失效；此时内容变化仍须使祖先的缓存失效并通知父容器
+	ExpectTrue(r, L"排列后标签的测量缓存已失效", !label->IsMeasureValid());
+	ExpectTrue(r, L"排列后父容器的测量缓存有效", inner->IsMeasureValid());
+
+	auto& stats = LayoutStats::Current();
+	stats.Reset();
+	label->SetText(L"abcdef");
+	ExpectTrue(r, L"内容变化后父容器的测量缓存失效", !inner->IsMeasureValid());
+	LayoutTree(&root);
+	ExpectCount(r, L"布局次数", (long long)stats.EngineLayouts, 1);
+	ExpectCount(r, L"MeasureCore 调用", (long long)stats.MeasureCoreCalls, 1);
+	ExpectRect(r, label, L"修改后的标签", 0, 0, 48, 20);
+	ExpectRect(r, below, L"下方子项", 0, 20, 50, 20);
+	return r;
+}
+
+CheckResult CheckVisibilityChange()
+{
+	CheckResult r{ L"可见性变化：隐藏的子项不占空间，父容器重新布局", true };
+	LayoutStub stack(200, 400);
+	stack.SetLayoutEngine(new StackLayoutEngine());
+	auto a = stack.Add(new LayoutStub(50, 20));
+	auto b = stack.Add(new LayoutStub(50, 30));
+	auto c = stack.Add(new LayoutStub(50, 40));
+	LayoutTree(&stack);
+	ExpectRect(r, c, L"C", 0, 50, 50, 40);
+
+	auto& stats = LayoutStats::Current();
+	stats.Reset();
+	b->SetVisible(false);
+	LayoutTree(&stack);
+	ExpectCount(r, L"隐藏后的布局次数", (long long)stats.EngineLayouts, 1);
+	ExpectRect(r, a, L"A", 0, 0, 50, 20);
+	ExpectRect(r, c, L"隐藏 B 后的 C", 0, 20, 50, 40);
+
+	b->SetVisible(true);
+	LayoutTree(&stack);
+	ExpectRect(r, c, L"重新显示 B 后的 C", 0, 50, 50, 40);
+	return r;
+}
+
+CheckResult CheckVirtualizing()
+{
+	CheckResult r{ L"VirtualizingStackPanel：只实例化可见项并复用容器", true };
+	VirtualStub list(200, 100, 10, 10);
+	list.Layout->SetItemSize(0, 20);
+	list.Layout->SetOverscan(1);
+	list.SetItemCount(1000000);
+	LayoutTree(&list);
+	// 视口 5 行 + 末尾 1 行 Overscan（首行之前没有可用的行）
+	ExpectCount(r, L"实例化数量", (long long)list.Containers.RealizedCount(), 7);
+
+	list.SetScrollOffset(1000.0f);
+	LayoutTree(&list);
+	ExpectCount(r, L"滚动后实例化数量", (long long)list.Containers.RealizedCount(), 8);
+	ExpectCount(r, L"创建的容器总数", (long long)list.Created, 8);
+	LayoutStub* top = list.Containers.Find(50);
+	if (r.Passed && !top)
+	{
+		r.Passed = false;
+		r.Detail = L"第 50 项未实例化";
+	}
+	if (top)
+	{
+		ExpectCount(r, L"第 50 项的 Tag", top->Tag, 50);
+		ExpectRect(r, top, L"第 50 项", 0, 0, 200, 20);
+	}
+	LayoutStub* next = list.Containers.Find(51);
+	if (next)
+		ExpectRect(r, next, L"第 51 项", 0, 20, 200, 20);
+	return r;
+}
+
+CheckResult CheckVirtualExtent()
+{
+	CheckResult r{ L"VirtualizingExtent：总长度、实例化区间与 ScrollIntoView", true };
+	VirtualizingExtent list;
+	list.Update(100, 20.0f, 200.0f, 0.0f, false, 100.0f, 200.0f);
+	ExpectNear(r, L"列表总长度", list.TotalExtent, 2000.0);
+	ExpectNear(r, L"列表最大滚动偏移", list.MaxScrollOffset(), 1900.0);
+	ExpectNear(r, L"超出范围的偏移", list.ClampScrollOffset(5000.0f), 1900.0);
+	ExpectNear(r, L"负偏移", list.ClampScrollOffset(-5.0f), 0.0);
+	int first = 0;
+	int last = 0;
+	list.RealizedRange(0.0f, 1, first, last);
+	ExpectCount(r, L"顶部区间起点", first, 0);
+	ExpectCount(r, L"顶部区间终点", last, 7);
+	list.RealizedRange(1000.0f, 1, first, last);
+	ExpectCount(r, L"滚动后区间起点", first, 49);
+	ExpectCount(r, L"滚动后区间终点", last, 57);
+	ExpectNear(r, L"向下滚到第 60 项", list.ScrollIntoView(60, 1000.0f), 1120.0);
+	ExpectNear(r, L"向上滚到第 10 项", list.ScrollIntoView(10, 1000.0f), 200.0);
+	ExpectNear(r, L"第 52 项已可见", list.ScrollIntoView(52, 1000.0f), 1000.0);
+
+	// 换行：交叉轴 210 放得下 3 项（每项 50 + 间距 4），334 行
+	VirtualizingExtent wrap;
+	wrap.Update(1000, 20.0f, 50.0f, 4.0f, true, 100.0f, 210.0f);
+	ExpectCount(r, L"换行每行项数", wrap.ItemsPerLine, 3);
+	ExpectCount(r, L"换行行数", wrap.LineCount(), 334);
+	ExpectNear(r, L"换行总长度", wrap.TotalExtent, 334 * 24 - 4);
+	wrap.RealizedRange(240.0f, 0, first, last);
+	ExpectCount(r, L"换行区间起点", first, 30);
+	ExpectCount(r, L"换行区间终点", last, 45);
+	ExpectNear(r, L"第 31 项的主轴位置", wrap.MainOffsetOf(31), 240.0);
+	ExpectNear(r, L"第 31 项的交叉轴位置", wrap.CrossOffsetOf(31), 54.0);
+	ExpectNear(r, L"滚到最后一项", wrap.ScrollIntoView(999, 0.0f), wrap.MaxScrollOffset());
+	wrap.RealizedRange(wrap.MaxScrollOffset(), 0, first, last);
+	ExpectCount(r, L"末尾区间终点", last, 1000);
+
+	VirtualizingExtent empty;
+	empty.Update(0, 20.0f, 200.0f, 0.0f, false, 100.0f, 200.0f);
+	ExpectNear(r, L"无数据项的总长度", empty.TotalExtent, 0.0);
+	ExpectNear(r, L"无数据项的最大滚动偏移", empty.MaxScrollOffset(), 0.0);
+	ExpectNear(r, L"无数据项时限制偏移", empty.ClampScrollOffset(50.0f), 0.0);
+	empty.RealizedRange(0.0f, 2, first, last);
+	ExpectCount(r, L"无数据项的区间长度", last - first, 0);
+	ExpectNear(r, L"无数据项时 ScrollIntoView", empty.ScrollIntoView(0, 0.0f), 0.0);
+	return r;
+}
+
+CheckResult CheckContainerPool()
+{
+	CheckResult r{ L"VirtualContainerPool：回收与复用容器", true };
+	int created = 0;
+	int attached = 0;
+	int detached = 0;
+	int destroyed = 0;
+	VirtualContainerPool<LayoutStub> pool;
+	pool.Create = [&]() { created++; return new LayoutStub(10, 10); };
+	pool.Bind = [](LayoutStub* c, int index) { c->Tag = index; };
+	pool.Attach = [&](LayoutStub*) { attached++; };
+	pool.Detach = [&](LayoutStub*) { detached++; };
+
+	pool.RealizeRange(0, 5);
+	ExpectCount(r, L"首次创建", created, 5);
+	ExpectCount(r, L"首次加入", attached, 5);
+
+	pool.RealizeRange(3, 8);
+	ExpectCount(r, L"滑动后创建总数", created, 5);
+	ExpectCount(r, L"滑动后移出", detached, 3);
+	ExpectCount(r, L"滑动后实例化数量", pool.RealizedCount(), 5);
+	ExpectCount(r, L"滑动后池中数量", pool.PooledCount(), 0);
+	ExpectTrue(r, L"滑出的索引不再有容器", pool.Find(0) == nullptr);
+	LayoutStub* seven = pool.Find(7);
+	ExpectTrue(r, L"复用的容器重新绑定", seven && seven->Tag == 7);
+	ExpectCount(r, L"IndexOf", pool.IndexOf(seven), 7);
+
+	pool.RealizeRange(0, 0);
+	ExpectCount(r, L"清空区间后池中数量", pool.PooledCount(), 5);
+	ExpectCount(r, L"清空区间后移出", detached, 8);
+
+	pool.RealizeRange(0, 3);
+	pool.Bind = [](LayoutStub* c, int index) { c->Tag = index + 100; };
+	pool.Rebind(2);
+	ExpectCount(r, L"Rebind 范围内", pool.Find(1)->Tag, 101);
+	ExpectCount(r, L"Rebind 范围外", pool.Find(2)->Tag, 2);
+
+	pool.Clear([&](LayoutStub* c) { destroyed++; delete c; });
+	ExpectCount(r, L"Clear 释放数量", destroyed, 5);
+	ExpectCount(r, L"Clear 后实例化数量", pool.RealizedCount(), 0);
+	ExpectCount(r, L"Clear 后池中数量", pool.PooledCount(), 0);
+	return r;
+}
+
+CheckResult CheckVirtualizingWrap()
+{
+	CheckResult r{ L"VirtualizingStackPanel 换行模式与零数据项", true };
+	VirtualStub list(210, 100, 50, 20);
+	list.Layout->SetWrap(true);
+	list.Layout->SetItemSize(50, 20);
+	list.Layout->SetSpacing(4);
+	list.Layout->SetOverscan(0);
+	list.SetItemCount(1000);
+	LayoutTree(&list);
+	// 视口 100 覆盖第 0..4 行，每行 3 项
+	ExpectCount(r, L"实例化数量", list.Containers.RealizedCount(), 15);
+	LayoutStub* item = list.Containers.Find(4);
+	if (item) ExpectRect(r, item, L"第 4 项", 54, 24, 50, 20);
+
+	list.ScrollIntoView(999);
+	LayoutTree(&list);
+	ExpectNear(r, L"滚到最后一项后的偏移", list.GetScrollOffset(), 334 * 24 - 4 - 100);
+	ExpectCount(r, L"末尾实例化数量", list.Containers.RealizedCount(), 13);
+	item = list.Containers.Find(999);
+	if (r.Passed && !item)
+	{
+		r.Passed = false;
+		r.Detail = L"第 999 项未实例化";
+	}
+	if (item) ExpectRect(r, item, L"第 999 项", 0, 80, 50, 20);
+
+	list.SetItemCount(0);
+	LayoutTree(&list);
+	ExpectCount(r, L"零数据项的实例化数量", list.Containers.RealizedCount(), 0);
+	ExpectNear(r, L"零数据项的滚动偏移", list.GetScrollOffset(), 0.0);
+	ExpectNear(r, L"零数据项的总长度", list.Layout->GetExtent().TotalExtent, 0.0);
+	return r;
+}
+
+template<typename Step>
+LayoutBenchmarkResult Run(const wchar_t* name, double seconds, Step step)
+{
+	LayoutBenchmarkResult r;
+	r.Name = name;
+	auto& stats = LayoutStats::Current();
+	stats.Reset();
+	const auto start = std::chrono::steady_clock::now();
+	do
+	{
+		step(r.Layouts);
+		r.Layouts++;
+		r.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	} while (r.Seconds < seconds);
+	r.LayoutsPerSecond = r.Layouts / r.Seconds;
+	r.MeasureCalls = (double)stats.MeasureCalls / r.Layouts;
+	r.MeasureCoreCalls = (double)stats.MeasureCoreCalls / r.Layouts;
+	return r;
+}
+
+LayoutBenchmarkResult BenchDeepNesting(double seconds)
+{
+	// 64 层 StackPanel，每层 8 个子项；根宽度变化会沿 Stretch 传到最深层
+	LayoutStub root(400, 600);
+	root.SetLayoutEngine(new StackLayoutEngine());
+	LayoutStub* level = &root;
+	for (int depth = 0; depth < 64; depth++)
+	{
+		for (int i = 0; i < 8; i++)
+			level->Add(new LayoutStub(40 + i * 10, 20));
+		auto child = level->Add(new LayoutStub(400, 600));
+		child->SetLayoutEngine(new StackLayoutEngine());
+		child->HAlign = HorizontalAlignment::Stretch;
+		level = child;
+	}
+	LayoutTree(&root);
+	return Run(L"深层嵌套（64 层 StackPanel）", seconds, [&](int i)
+		{
+			root.SetSize(400 + (i & 1), 600);
+			LayoutTree(&root);
+		});
+}
+
+LayoutBenchmarkResult BenchWrap(double seconds)
+{
+	LayoutStub wrap(1200, 800);
+	wrap.SetLayoutEngine(new WrapLayoutEngine());
+	for (int i = 0; i < 10000; i++)
+		wrap.Add(new LayoutStub(40 + (i * 37) % 60, 20));
+	LayoutTree(&wrap);
+	return Run(L"WrapPanel 10000 子项", seconds, [&](int i)
+		{
+			wrap.SetSize(1200 + (i & 1) * 7, 800);
+			LayoutTree(&wrap);
+		});
+}
+
+LayoutBenchmarkResult BenchStarGrid(double seconds)
+{
+	LayoutStub grid(2000, 2000);
+	auto layout = grid.SetLayoutEngine(new GridLayoutEngine());
+	for (int i = 0; i < 100; i++)
+	{
+		layout->AddRow(GridLength::Star(1.0f));
+		layout->AddColumn(GridLength::Star((float)(1 + i % 3)));
+	}
+	for (int row = 0; row < 100; row++)
+	{
+		for (int col = 0; col < 100; col++)
+		{
+			auto cell = grid.Add(new LayoutStub(10, 10));
+			cell->GridRow = row;
+			cell->GridColumn = col;
+			cell->HAlign = HorizontalAlignment::Stretch;
+			cell->VAlign = VerticalAlignment::Stretch;
+		}
+	}
+	LayoutTree(&grid);
+	return Run(L"Star Grid 100x100", seconds, [&](int i)
+		{
+			grid.SetSize(2000 + (i & 1) * 13, 2000);
+			LayoutTree(&grid);
+		});
+}
+
+LayoutBenchmarkResult BenchRelativeChain(double seconds)
+{
+	// 每 50 个换一行：行首位于上一行行首下方，其余位于前一个的右侧
+	LayoutStub panel(2000, 2000);
+	auto layout = panel.SetLayoutEngine(new RelativeLayoutEngine());
+	LayoutStub* prev = nullptr;
+	LayoutStub* rowHead = nullptr;
+	for (int i = 0; i < 1000; i++)
+	{
+		auto item = panel.Add(new LayoutStub(30, 16));
+		RelativeConstraints c;
+		if (i % 50 == 0)
+		{
+			c.Below = rowHead;
+			rowHead = item;
+		}
+		else
+		{
+			c.RightOf = prev;
+			c.AlignTopWith = prev;
+		}
+		layout->SetConstraints(item, c);
+		prev = item;
+	}
+	LayoutTree(&panel);
+	return Run(L"RelativePanel 约束链（1000 子项）", seconds, [&](int i)
+		{
+			panel.SetSize(2000 + (i & 1), 2000);
+			LayoutTree(&panel);
+		});
+}
+
+LayoutBenchmarkResult BenchSingleChange(double seconds)
+{
+	LayoutStub stack(400, 600);
+	stack.SetLayoutEngine(new StackLayoutEngine());
+	std::vector<LayoutStub*> items;
+	for (int i = 0; i < 5000; i++)
+		items.push_back(stack.Add(new LayoutStub(100 + i % 50, 20)));
+	LayoutTree(&stack);
+	return Run(L"StackPanel 5000 子项中的一项变化", seconds, [&](int i)
+		{
+			items[(size_t)(i * 7919) % items.size()]->SetSize(100, 20 + (i & 1));
+			LayoutTree(&stack);
+		});
+}
+
+LayoutBenchmarkResult BenchVirtualScroll(double seconds)
+{
+	// 一百万项的虚拟化列表：每次滚动只处理视口附近的几十项
+	VirtualStub list(400, 600, 100, 20);
+	list.Layout->SetItemSize(0, 20);
+	list.SetItemCount(1000000);
+	LayoutTree(&list);
+	return Run(L"VirtualizingStackPanel 1000000 项滚动", seconds, [&](int i)
+		{
+			list.SetScrollOffset((float)(((long long)i * 7919) % 20000000));
+			LayoutTree(&list);
+		});
+}
+
+}
+
+std::vector<CheckResult> LayoutBenchmark::RunChecks()
+{
+	return {
+		CheckStackVertical(),
+		CheckStackHorizontal(),
+		CheckGrid(),
+		CheckDock(),
+		CheckWrap(),
+		CheckRelative(),
+		CheckMeasureCache(),
+		CheckContentChange(),
+		CheckVisibilityChange(),
+		CheckVirtualizing(),
+		CheckVirtualExtent(),
+		CheckContainerPool(),
+		CheckVirtualizingWrap(),
+	};
+}
+
+std::vector<LayoutBenchmarkResult> LayoutBenchmark::RunBenchmarks(double secondsPerCase)
+{
+	return {
+		BenchDeepNesting(secondsPerCase),
+		BenchWrap(secondsPerCase),
+		BenchStarGrid(secondsPerCase),
+		BenchRelativeChain(secondsPerCase),
+		BenchSingleChange(secondsPerCase),
+		BenchVirtualScroll(secondsPerCase),
+	};
+}
+
+std::wstring LayoutBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<LayoutBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"布局", checks);
+	text += L"布局基准（每秒布局次数；每次布局的 Measure 调用 / 缓存未命中）：\r\n";
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"  %ls：%.1f 次/秒；%.0f / %.0f\r\n",
+			b.Name.c_str(), b.LayoutsPerSecond, b.MeasureCalls, b.MeasureCoreCalls);
+	}
+	return text;
+}
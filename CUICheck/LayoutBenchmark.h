@@ -0,0 +1,41 @@
+#pragma once
+
+/**
+ * @file LayoutBenchmark.h
+ * @brief 布局引擎的离线校验与基准测试（CUICheck 套件 layout）。
+ *
+ * 容器与子项都是实现 LayoutElement 的桩元素（与 Control/Panel 的布局行为一致），直接驱动布局引擎：
+ * 不创建窗口、不经过 DirectWrite，只测量布局逻辑本身。
+ * - RunChecks：用手算的期望位置校验五种布局引擎与虚拟化列表（区间计算、容器复用、换行与零数据项），以及排列后内容/可见性变化时的重新测量
+ * - RunBenchmarks：深层嵌套、上万子项 WrapPanel、大型 Star Grid、相对约束链、百万项虚拟化滚动等场景的每秒布局次数
+ */
+#include "../CUI/GUI/Layout/StackLayoutEngine.h"
+#include "../CUI/GUI/Layout/GridLayoutEngine.h"
+#include "../CUI/GUI/Layout/DockLayoutEngine.h"
+#include "../CUI/GUI/Layout/WrapLayoutEngine.h"
+#include "../CUI/GUI/Layout/RelativeLayoutEngine.h"
+#include "../CUI/GUI/Layout/VirtualizingLayoutEngine.h"
+#include "../CUI/GUI/Layout/VirtualContainerPool.h"
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct LayoutBenchmarkResult
+{
+	std::wstring Name;
+	int Layouts = 0;
+	double Seconds = 0.0;
+	double LayoutsPerSecond = 0.0;
+	/** @brief 平均每次布局的 Measure 调用与缓存未命中次数。 */
+	double MeasureCalls = 0.0;
+	double MeasureCoreCalls = 0.0;
+};
+
+class LayoutBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param secondsPerCase 每个场景的运行时间。 */
+	static std::vector<LayoutBenchmarkResult> RunBenchmarks(double secondsPerCase = 0.5);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<LayoutBenchmarkResult>& benchmarks);
+};
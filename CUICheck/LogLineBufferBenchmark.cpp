@@ -0,0 +1,345 @@
+#include "LogLineBufferBenchmark.h"
+#include "../CUI/GUI/Text/LogLineBuffer.h"
+#include "../CUI/GUI/Text/PieceTable.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <thread>
+
+namespace {
+
+struct Lcg
+{
+	uint32_t State;
+	explicit Lcg(uint32_t seed) : State(seed) {}
+	uint32_t Next()
+	{
+		State = State * 1664525u + 1013904223u;
+		return State >> 8;
+	}
+};
+
+/** @brief 按 RichTextBox::ApplyLogBatch 的方式把一批写入文档：先删头部，再追加。 */
+bool ApplyBatch(LogLineBuffer& log, std::wstring& doc)
+{
+	LogLineBuffer::Batch batch;
+	if (!log.TakeBatch(batch)) return false;
+	doc.erase(0, (std::min)(batch.EvictChars, doc.size()));
+	doc += batch.Text;
+	return true;
+}
+
+/** @brief 模型：全部行逐行提交，再按与 LogLineBuffer 相同的规则从头部淘汰。 */
+void TrimModel(std::deque<std::wstring>& lines, size_t maxLines, size_t maxChars)
+{
+	size_t chars = 0;
+	for (const auto& l : lines) chars += l.size() + 1;
+	for (;;)
+	{
+		const bool over = (maxLines > 0 && lines.size() > maxLines) || (maxChars > 0 && chars > maxChars && lines.size() > 1);
+		if (!over) break;
+		chars -= lines.front().size() + 1;
+		lines.pop_front();
+	}
+}
+
+std::wstring Join(const std::deque<std::wstring>& lines)
+{
+	std::wstring s;
+	for (const auto& l : lines)
+	{
+		s += l;
+		s += LogLineBuffer::LineSeparator;
+	}
+	return s;
+}
+
+CheckResult CheckBatching()
+{
+	CheckResult r{ L"批内合并与刷新通知", true, L"" };
+	LogLineBuffer log;
+	ExpectTrue(r, L"空缓冲无待处理", !log.HasPending());
+	ExpectTrue(r, L"第一行通知刷新", log.Post(L"a"));
+	ExpectTrue(r, L"第二行不再通知", !log.Post(L"bb"));
+	ExpectTrue(r, L"第三行不再通知", !log.Post(L""));
+	ExpectTrue(r, L"有待处理", log.HasPending());
+	LogLineBuffer::Batch b;
+	ExpectTrue(r, L"取批", log.TakeBatch(b));
+	ExpectTrue(r, L"合并文本", b.Text == L"a\rbb\r\r");
+	ExpectCount(r, L"批内行数", (long long)b.Lines, 3);
+	ExpectCount(r, L"无上限时不淘汰", (long long)b.EvictChars, 0);
+	ExpectTrue(r, L"取批后无待处理", !log.HasPending());
+	ExpectTrue(r, L"空批", !log.TakeBatch(b));
+	ExpectTrue(r, L"取批后下一行重新通知", log.Post(L"c"));
+	ExpectCount(r, L"已提交行数", (long long)log.LineCount(), 3);
+	ExpectCount(r, L"已提交字符数", (long long)log.CharCount(), 6);
+	ExpectCount(r, L"批次数", (long long)log.GetStats().Batches, 1);
+	return r;
+}
+
+CheckResult CheckLineLimit()
+{
+	CheckResult r{ L"行数上限淘汰", true, L"" };
+	LogLineBuffer log;
+	log.SetLimits(3, 0);
+	std::wstring doc;
+	log.Post(L"1");
+	log.Post(L"22");
+	ApplyBatch(log, doc);
+	log.Post(L"333");
+	log.Post(L"4444");
+	ApplyBatch(log, doc);
+	ExpectTrue(r, L"保留最新 3 行", doc == L"22\r333\r4444\r");
+	ExpectCount(r, L"淘汰行数", (long long)log.GetStats().EvictedLines, 1);
+	// 一批的行数超过上限：批内先被淘汰的新行不写入，只删除原有内容
+	for (int i = 0; i < 5; i++) log.Post(std::wstring(1, (wchar_t)(L'a' + i)));
+	LogLineBuffer::Batch b;
+	log.TakeBatch(b);
+	ExpectCount(r, L"删除原有内容", (long long)b.EvictChars, (long long)doc.size());
+	ExpectTrue(r, L"只写入最后 3 行", b.Text == L"c\rd\re\r");
+	ExpectCount(r, L"行数记账", (long long)log.LineCount(), 3);
+	return r;
+}
+
+CheckResult CheckCharLimit()
+{
+	CheckResult r{ L"字符数上限（至少保留一行）", true, L"" };
+	LogLineBuffer log;
+	log.SetLimits(0, 10);
+	std::wstring doc;
+	log.Post(L"abcd");
+	log.Post(L"efgh");
+	ApplyBatch(log, doc);
+	ExpectTrue(r, L"未超上限", doc == L"abcd\refgh\r");
+	log.Post(L"ij");
+	ApplyBatch(log, doc);
+	ExpectTrue(r, L"超上限淘汰最旧行", doc == L"efgh\rij\r");
+	log.Post(std::wstring(50, L'x'));
+	ApplyBatch(log, doc);
+	ExpectTrue(r, L"超长单行仍保留", doc == std::wstring(50, L'x') + L"\r");
+	ExpectCount(r, L"字符记账", (long long)log.CharCount(), 51);
+	return r;
+}
+
+CheckResult CheckPendingTrim()
+{
+	CheckResult r{ L"积压超过上限时丢弃", true, L"" };
+	LogLineBuffer log;
+	log.SetLimits(100, 0);
+	for (int i = 0; i < 10000; i++)
+		log.Post(std::to_wstring(i));
+	const auto s = log.GetStats();
+	ExpectCount(r, L"投递行数", (long long)s.PostedLines, 10000);
+	ExpectCount(r, L"未显示即丢弃", (long long)s.DroppedLines, 9900);
+	std::wstring doc;
+	ApplyBatch(log, doc);
+	std::deque<std::wstring> expected;
+	for (int i = 9900; i < 10000; i++) expected.push_back(std::to_wstring(i));
+	ExpectTrue(r, L"只显示最后 100 行", doc == Join(expected));
+	return r;
+}
+
+CheckResult CheckReset()
+{
+	CheckResult r{ L"Reset 既有文本", true, L"" };
+	LogLineBuffer log;
+	log.SetLimits(2, 0);
+	std::wstring doc = L"existing text without separators";
+	log.Reset(doc.size());
+	ExpectCount(r, L"既有文本算一行", (long long)log.LineCount(), 1);
+	log.Post(L"a");
+	ApplyBatch(log, doc);
+	ExpectTrue(r, L"未超上限时保留", doc == L"existing text without separators" L"a\r");
+	log.Post(L"b");
+	ApplyBatch(log, doc);
+	ExpectTrue(r, L"既有文本整体淘汰", doc == L"a\rb\r");
+	log.Reset();
+	ExpectCount(r, L"清空记账", (long long)log.CharCount(), 0);
+	return r;
+}
+
+CheckResult CheckRandomModel()
+{
+	CheckResult r{ L"随机投递与模型一致", true, L"" };
+	Lcg rng(2024);
+	struct Limits { size_t Lines, Chars; };
+	const Limits limits[] = { { 0, 0 }, { 50, 0 }, { 0, 400 }, { 30, 200 }, { 1, 0 } };
+	for (const auto& lim : limits)
+	{
+		LogLineBuffer log;
+		log.SetLimits(lim.Lines, lim.Chars);
+		std::wstring doc;
+		std::deque<std::wstring> model;
+		for (int step = 0; step < 3000 && r.Passed; step++)
+		{
+			const int posts = (int)(rng.Next() % 40);
+			for (int i = 0; i < posts; i++)
+			{
+				std::wstring line((size_t)(rng.Next() % 30), (wchar_t)(L'a' + step % 26));
+				model.push_back(line);
+				log.Post(std::move(line));
+			}
+			ApplyBatch(log, doc);
+			TrimModel(model, lim.Lines, lim.Chars);
+			ExpectCount(r, L"行数记账", (long long)log.LineCount(), (long long)model.size());
+			ExpectCount(r, L"字符记账", (long long)log.CharCount(), (long long)doc.size());
+			if (step % 50 == 0)
+				ExpectTrue(r, L"文档与模型一致", doc == Join(model));
+		}
+		ExpectTrue(r, L"结束时文档与模型一致", doc == Join(model));
+	}
+	return r;
+}
+
+CheckResult CheckThreaded()
+{
+	CheckResult r{ L"多生产者并发投递", true, L"" };
+	LogLineBuffer log;
+	const int producers = 4;
+	const int perProducer = 20000;
+	std::atomic<int> running{ producers };
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; p++)
+	{
+		threads.emplace_back([&, p]()
+		{
+			for (int i = 0; i < perProducer; i++)
+				log.Post(std::to_wstring(p) + L":" + std::to_wstring(i));
+			running.fetch_sub(1, std::memory_order_release);
+		});
+	}
+	std::wstring doc;
+	while (running.load(std::memory_order_acquire) > 0 || log.HasPending())
+	{
+		if (!ApplyBatch(log, doc))
+			std::this_thread::yield();
+	}
+	for (auto& t : threads) t.join();
+	ApplyBatch(log, doc);
+
+	int next[producers] = {};
+	size_t start = 0;
+	while (r.Passed && start < doc.size())
+	{
+		const size_t end = doc.find(LogLineBuffer::LineSeparator, start);
+		if (end == std::wstring::npos)
+		{
+			ExpectTrue(r, L"行以分隔符结尾", false);
+			break;
+		}
+		const std::wstring line = doc.substr(start, end - start);
+		const size_t colon = line.find(L':');
+		const int p = colon == std::wstring::npos ? -1 : std::stoi(line.substr(0, colon));
+		ExpectTrue(r, L"行内容完整", p >= 0 && p < producers);
+		if (!r.Passed) break;
+		ExpectCount(r, L"同一生产者的行有序", std::stoi(line.substr(colon + 1)), next[p]);
+		next[p]++;
+		start = end + 1;
+	}
+	for (int p = 0; p < producers; p++)
+		ExpectCount(r, L"每个生产者的行数", next[p], perProducer);
+	ExpectCount(r, L"投递统计", (long long)log.GetStats().PostedLines, (long long)producers * perProducer);
+	return r;
+}
+
+double NanosPerLine(std::chrono::steady_clock::time_point start, int lines)
+{
+	const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	return lines > 0 ? (double)ns / lines : 0.0;
+}
+
+std::wstring MakeLine(int i)
+{
+	return L"[12:00:00.000] INFO worker-" + std::to_wstring(i % 8) + L" processed request #" + std::to_wstring(i);
+}
+
+} // namespace
+
+std::vector<CheckResult> LogLineBufferBenchmark::RunChecks()
+{
+	return {
+		CheckBatching(),
+		CheckLineLimit(),
+		CheckCharLimit(),
+		CheckPendingTrim(),
+		CheckReset(),
+		CheckRandomModel(),
+		CheckThreaded(),
+	};
+}
+
+std::vector<LogLineBufferBenchmarkResult> LogLineBufferBenchmark::RunBenchmarks(int lines)
+{
+	if (lines < 1000) lines = 1000;
+	std::vector<LogLineBufferBenchmarkResult> results;
+	const size_t maxLines = 10000;
+
+	{
+		// 旧路径：每行立即写入存储，超过上限时逐行从头部删除
+		PieceTable doc;
+		std::deque<size_t> lens;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < lines; i++)
+		{
+			std::wstring line = MakeLine(i);
+			line.push_back(LogLineBuffer::LineSeparator);
+			doc.Append(line);
+			lens.push_back(line.size());
+			if (lens.size() > maxLines)
+			{
+				doc.Erase(0, lens.front());
+				lens.pop_front();
+			}
+		}
+		LogLineBufferBenchmarkResult b;
+		b.Name = L"逐行追加并淘汰";
+		b.Lines = lines;
+		b.NanosPerLine = NanosPerLine(start, lines);
+		b.LinesPerBatch = 1.0;
+		results.push_back(b);
+	}
+
+	const int burstSizes[] = { 1, 64, 1024 };
+	for (int burst : burstSizes)
+	{
+		// 每投递 burst 行取一批（相当于一帧期间到达 burst 行）
+		LogLineBuffer log;
+		log.SetLimits(maxLines, 0);
+		PieceTable doc;
+		LogLineBuffer::Batch batch;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < lines; i++)
+		{
+			log.Post(MakeLine(i));
+			if ((i + 1) % burst == 0 || i + 1 == lines)
+			{
+				if (log.TakeBatch(batch))
+				{
+					doc.Erase(0, batch.EvictChars);
+					doc.Append(batch.Text);
+				}
+			}
+		}
+		const auto s = log.GetStats();
+		LogLineBufferBenchmarkResult b;
+		b.Name = CheckFormat(L"LogLineBuffer，每帧 %d 行", burst);
+		b.Lines = lines;
+		b.NanosPerLine = NanosPerLine(start, lines);
+		b.LinesPerBatch = s.Batches ? (double)s.PostedLines / s.Batches : 0.0;
+		results.push_back(b);
+	}
+	return results;
+}
+
+std::wstring LogLineBufferBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<LogLineBufferBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"日志行缓冲", checks);
+	text += L"上限 10000 行，写入 PieceTable：\r\n";
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"  %ls：%d 行，%.1f ns/行，平均 %.1f 行/次写入\r\n",
+			b.Name.c_str(), b.Lines, b.NanosPerLine, b.LinesPerBatch);
+	}
+	return text;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * @file LogLineBufferBenchmark.h
+ * @brief 日志尾随行缓冲的校验与基准（CUICheck 套件 log-lines）。
+ *
+ * 只使用 LogLineBuffer/PieceTable，不依赖 Win32 与 RichTextBox：
+ * - RunChecks：一批只通知一次刷新、批内合并与分隔符、行数/字符数上限淘汰（至少保留一行）、
+ *   积压超过上限时直接丢弃、Reset 把既有文本作为一个整体、随机投递/取批后文档与按上限裁剪的模型一致、
+ *   多个生产者线程并发投递时各自的行完整且有序
+ * - RunBenchmarks：按行追加并立即淘汰（旧路径）与按帧合并为一次追加的每行耗时与每批行数
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct LogLineBufferBenchmarkResult
+{
+	std::wstring Name;
+	int Lines = 0;
+	/** @brief 平均每行耗时（纳秒，含写入文档与淘汰）。 */
+	double NanosPerLine = 0.0;
+	/** @brief 平均每次写入文档的行数（旧路径为 1）。 */
+	double LinesPerBatch = 0.0;
+};
+
+class LogLineBufferBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param lines 每个场景投递的行数。 */
+	static std::vector<LogLineBufferBenchmarkResult> RunBenchmarks(int lines = 300000);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<LogLineBufferBenchmarkResult>& benchmarks);
+};
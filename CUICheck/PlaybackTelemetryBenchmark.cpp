@@ -0,0 +1,364 @@
+#include "PlaybackTelemetryBenchmark.h"
+#include "../CUI/GUI/PlaybackTelemetry.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+struct Lcg
+{
+	uint32_t State;
+	explicit Lcg(uint32_t seed) : State(seed) {}
+	uint32_t Next()
+	{
+		State = State * 1664525u + 1013904223u;
+		return State >> 8;
+	}
+	double NextUnit() { return (double)Next() / (double)(1u << 24); }
+};
+
+// 近似对数正态的耗时（微秒）：中位数约 2ms，长尾到几百毫秒
+std::vector<uint64_t> MakeLatencies(size_t count, uint32_t seed)
+{
+	Lcg rng(seed);
+	std::vector<uint64_t> values(count);
+	for (auto& v : values)
+	{
+		// 4 个均匀分布之和近似正态（方差 1/3）
+		const double z = (rng.NextUnit() + rng.NextUnit() + rng.NextUnit() + rng.NextUnit() - 2.0) * std::sqrt(3.0);
+		v = (uint64_t)std::exp(std::log(2000.0) + 1.2 * z);
+	}
+	return values;
+}
+
+CheckResult CheckBucketBounds()
+{
+	CheckResult r{ L"桶边界", true, L"" };
+	const size_t n = LatencyHistogram::BucketCount;
+	for (size_t i = 0; i < n && r.Passed; i++)
+	{
+		const uint64_t lower = LatencyHistogram::BucketLower(i);
+		const uint64_t upper = LatencyHistogram::BucketUpper(i);
+		ExpectTrue(r, L"Lower < Upper", lower < upper);
+		if (i + 1 < n)
+			ExpectCount(r, L"相邻桶首尾相接", (long long)upper, (long long)LatencyHistogram::BucketLower(i + 1));
+		ExpectCount(r, L"下界所在桶", (long long)LatencyHistogram::BucketIndex(lower), (long long)i);
+		ExpectCount(r, L"上界前一值所在桶", (long long)LatencyHistogram::BucketIndex(upper - 1), (long long)i);
+		// 线性区之后相对宽度不超过 1/8
+		if (i >= LatencyHistogram::LinearBuckets)
+			ExpectTrue(r, L"桶宽 <= 下界 / 8", (upper - lower) * 8 <= lower);
+	}
+	ExpectCount(r, L"超出上限的值", (long long)LatencyHistogram::BucketIndex(~0ull), (long long)(n - 1));
+	// 上限应覆盖一分钟以上的卡顿
+	ExpectTrue(r, L"上限 > 60 秒", LatencyHistogram::BucketLower(n - 1) > 60000000ull);
+	return r;
+}
+
+CheckResult CheckLinearExact()
+{
+	CheckResult r{ L"线性区精确", true, L"" };
+	LatencyHistogram h;
+	for (uint64_t v = 0; v < LatencyHistogram::LinearBuckets; v++)
+		h.Record(v);
+	const auto s = h.GetSnapshot();
+	ExpectCount(r, L"Count", (long long)s.Count, 16);
+	ExpectCount(r, L"SumMicros", (long long)s.SumMicros, 120);
+	ExpectCount(r, L"MaxMicros", (long long)s.MaxMicros, 15);
+	ExpectNear(r, L"MeanMs", s.MeanMs(), 0.0075, 1e-12);
+	// 第 k 个（1 起）样本就是 k - 1 微秒
+	for (int k = 1; k <= 16 && r.Passed; k++)
+		ExpectNear(r, L"百分位", s.PercentileMs(100.0 * k / 16.0), (k - 1) / 1000.0, 1e-12);
+	ExpectNear(r, L"P0", s.PercentileMs(0.0), 0.0, 1e-12);
+
+	LatencyHistogram empty;
+	ExpectNear(r, L"空直方图 P99", empty.GetSnapshot().PercentileMs(99.0), 0.0, 0.0);
+	ExpectNear(r, L"空直方图 MeanMs", empty.GetSnapshot().MeanMs(), 0.0, 0.0);
+
+	LatencyHistogram seconds;
+	seconds.RecordSeconds(-0.5);
+	seconds.RecordSeconds(0.0025);
+	const auto ss = seconds.GetSnapshot();
+	ExpectCount(r, L"负数记为 0 的桶", (long long)ss.Buckets[0], 1);
+	ExpectCount(r, L"RecordSeconds 最大值", (long long)ss.MaxMicros, 2500);
+	return r;
+}
+
+CheckResult CheckPercentileAccuracy()
+{
+	CheckResult r{ L"百分位误差", true, L"" };
+	auto values = MakeLatencies(200000, 12345);
+	LatencyHistogram h;
+	uint64_t sum = 0;
+	for (uint64_t v : values)
+	{
+		h.Record(v);
+		sum += v;
+	}
+	const auto s = h.GetSnapshot();
+	ExpectCount(r, L"SumMicros", (long long)s.SumMicros, (long long)sum);
+
+	std::sort(values.begin(), values.end());
+	ExpectCount(r, L"MaxMicros", (long long)s.MaxMicros, (long long)values.back());
+	const double ps[] = { 1.0, 10.0, 50.0, 90.0, 99.0, 99.9, 100.0 };
+	for (double p : ps)
+	{
+		const size_t rank = (std::max)((size_t)1, (size_t)std::ceil(p / 100.0 * (double)values.size()));
+		const double exact = (double)values[rank - 1];
+		// 桶中点与桶内任一值之差不超过半个桶宽（<= 下界 / 16）
+		ExpectNear(r, CheckFormat(L"P%.1f（微秒）", p).c_str(), s.PercentileMs(p) * 1000.0, exact, exact / 16.0 + 0.5);
+	}
+	return r;
+}
+
+CheckResult CheckConcurrentRecord()
+{
+	CheckResult r{ L"多线程并发记录", true, L"" };
+	const int threadCount = 4;
+	const uint64_t perThread = 200000;
+	LatencyHistogram h;
+	uint64_t expectedSum = 0;
+	uint64_t expectedMax = 0;
+	for (int t = 0; t < threadCount; t++)
+	{
+		for (uint64_t i = 0; i < perThread; i++)
+		{
+			const uint64_t v = (i * 7919 + (uint64_t)t * 104729) % 300000;
+			expectedSum += v;
+			expectedMax = (std::max)(expectedMax, v);
+		}
+	}
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; t++)
+	{
+		threads.emplace_back([&h, t, perThread]()
+		{
+			for (uint64_t i = 0; i < perThread; i++)
+				h.Record((i * 7919 + (uint64_t)t * 104729) % 300000);
+		});
+	}
+	// 记录的同时读取快照：不阻塞，计数只增不减
+	uint64_t lastCount = 0;
+	for (int i = 0; i < 200 && r.Passed; i++)
+	{
+		const auto s = h.GetSnapshot();
+		ExpectTrue(r, L"并发读取时计数单调", s.Count >= lastCount);
+		lastCount = s.Count;
+		std::this_thread::yield();
+	}
+	for (auto& th : threads)
+		th.join();
+
+	const auto s = h.GetSnapshot();
+	ExpectCount(r, L"Count", (long long)s.Count, (long long)(perThread * threadCount));
+	ExpectCount(r, L"SumMicros", (long long)s.SumMicros, (long long)expectedSum);
+	ExpectCount(r, L"MaxMicros", (long long)s.MaxMicros, (long long)expectedMax);
+	uint64_t bucketTotal = 0;
+	for (uint64_t b : s.Buckets) bucketTotal += b;
+	ExpectCount(r, L"各桶之和", (long long)bucketTotal, (long long)s.Count);
+	return r;
+}
+
+CheckResult CheckLatenessAndDrift()
+{
+	CheckResult r{ L"延后与音画偏差", true, L"" };
+	PlaybackTelemetry t;
+	// 还没有音频：视频延后照常记录，不记音画偏差
+	t.RecordVideoLateness(0.004);
+	ExpectCount(r, L"无音频时的偏差样本", (long long)t.AvDrift.GetSnapshot().Count, 0);
+	ExpectNear(r, L"无音频时 AvDriftMs", t.AvDriftMs(), 0.0, 0.0);
+	ExpectNear(r, L"首个视频样本直接采用", t.VideoLatenessMs(), 4.0, 1e-9);
+
+	t.RecordAudioLateness(0.040);
+	ExpectNear(r, L"首个音频样本直接采用", t.AudioLatenessMs(), 40.0, 1e-9);
+	t.RecordAudioLateness(0.140);
+	// 40 + (140 - 40) * 0.1
+	ExpectNear(r, L"音频指数平均", t.AudioLatenessMs(), 50.0, 1e-9);
+
+	t.RecordVideoLateness(0.014);
+	// 4 + (14 - 4) * 0.1
+	ExpectNear(r, L"视频指数平均", t.VideoLatenessMs(), 5.0, 1e-9);
+	ExpectNear(r, L"AvDriftMs（声音落后为正）", t.AvDriftMs(), 45.0, 1e-9);
+	auto drift = t.AvDrift.GetSnapshot();
+	ExpectCount(r, L"偏差样本数", (long long)drift.Count, 1);
+	// 本帧延后 14ms，音频平均 50ms
+	ExpectCount(r, L"偏差样本（微秒）", (long long)drift.MaxMicros, 36000);
+
+	// 画面落后于声音：偏差样本取绝对值
+	t.RecordVideoLateness(0.150);
+	drift = t.AvDrift.GetSnapshot();
+	ExpectCount(r, L"反向偏差样本（微秒）", (long long)drift.MaxMicros, 100000);
+	ExpectTrue(r, L"画面落后时 AvDriftMs 变小", t.AvDriftMs() < 45.0);
+
+	PlaybackStats stats;
+	t.Read.Record(1500);
+	t.Present.Record(300);
+	t.Fill(stats);
+	ExpectCount(r, L"快照 Read.Count", (long long)stats.Read.Count, 1);
+	ExpectCount(r, L"快照 Present.MaxMicros", (long long)stats.Present.MaxMicros, 300);
+	ExpectCount(r, L"快照 AvDrift.Count", (long long)stats.AvDrift.Count, 2);
+	ExpectNear(r, L"快照 AvDriftMs", stats.AvDriftMs, t.AvDriftMs(), 1e-12);
+	ExpectNear(r, L"快照 AudioLatenessMs", stats.AudioLatenessMs, 50.0, 1e-9);
+	return r;
+}
+
+CheckResult CheckReset()
+{
+	CheckResult r{ L"清零", true, L"" };
+	PlaybackTelemetry t;
+	t.Read.Record(100);
+	t.Convert.Record(200);
+	t.Upload.Record(300);
+	t.Present.Record(400);
+	t.RecordAudioLateness(0.020);
+	t.RecordVideoLateness(0.010);
+	t.Reset();
+
+	PlaybackStats stats;
+	t.Fill(stats);
+	ExpectCount(r, L"Read.Count", (long long)stats.Read.Count, 0);
+	ExpectCount(r, L"Convert.SumMicros", (long long)stats.Convert.SumMicros, 0);
+	ExpectCount(r, L"Upload.MaxMicros", (long long)stats.Upload.MaxMicros, 0);
+	ExpectCount(r, L"Present.Buckets", (long long)stats.Present.Buckets[LatencyHistogram::BucketIndex(400)], 0);
+	ExpectCount(r, L"AvDrift.Count", (long long)stats.AvDrift.Count, 0);
+	ExpectNear(r, L"AvDriftMs", stats.AvDriftMs, 0.0, 0.0);
+	ExpectNear(r, L"AudioLatenessMs", stats.AudioLatenessMs, 0.0, 0.0);
+
+	// 清零后重新开始：首个样本直接采用，音频到来前不记偏差
+	t.RecordVideoLateness(0.008);
+	ExpectCount(r, L"清零后无音频时的偏差样本", (long long)t.AvDrift.GetSnapshot().Count, 0);
+	ExpectNear(r, L"清零后首个视频样本", t.VideoLatenessMs(), 8.0, 1e-9);
+	return r;
+}
+
+// 对照：互斥锁保护的同样分桶的直方图
+class LockedHistogram
+{
+public:
+	void Record(uint64_t micros)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_buckets[LatencyHistogram::BucketIndex(micros)]++;
+		_count++;
+		_sum += micros;
+		_max = (std::max)(_max, micros);
+	}
+	uint64_t Count()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _count;
+	}
+
+private:
+	std::mutex _mutex;
+	std::array<uint64_t, LatencyHistogram::BucketCount> _buckets{};
+	uint64_t _count = 0;
+	uint64_t _sum = 0;
+	uint64_t _max = 0;
+};
+
+template<typename THistogram>
+double MeasureRecord(THistogram& h, const std::vector<uint64_t>& values, int threadCount, int iterations)
+{
+	const size_t mask = values.size() - 1;
+	auto t0 = std::chrono::steady_clock::now();
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; t++)
+	{
+		threads.emplace_back([&h, &values, mask, t, iterations]()
+		{
+			size_t k = (size_t)t * 977;
+			for (int i = 0; i < iterations; i++)
+				h.Record(values[(k + (size_t)i) & mask]);
+		});
+	}
+	for (auto& th : threads)
+		th.join();
+	const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+	// 每个线程的单次耗时（线程并行执行）
+	return ns / (double)iterations;
+}
+
+} // namespace
+
+std::vector<CheckResult> PlaybackTelemetryBenchmark::RunChecks()
+{
+	std::vector<CheckResult> results;
+	results.push_back(CheckBucketBounds());
+	results.push_back(CheckLinearExact());
+	results.push_back(CheckPercentileAccuracy());
+	results.push_back(CheckConcurrentRecord());
+	results.push_back(CheckLatenessAndDrift());
+	results.push_back(CheckReset());
+	return results;
+}
+
+std::vector<PlaybackTelemetryBenchmarkResult> PlaybackTelemetryBenchmark::RunBenchmarks(int iterations)
+{
+	iterations = (std::max)(iterations, 1000);
+	// 2 的幂，便于取模
+	const auto values = MakeLatencies(4096, 777);
+	std::vector<PlaybackTelemetryBenchmarkResult> results;
+
+	for (int threads : { 1, 4 })
+	{
+		LatencyHistogram h;
+		PlaybackTelemetryBenchmarkResult b;
+		b.Name = L"无锁直方图 Record";
+		b.Threads = threads;
+		b.NanosPerOp = MeasureRecord(h, values, threads, iterations);
+		results.push_back(b);
+
+		LockedHistogram locked;
+		PlaybackTelemetryBenchmarkResult lb;
+		lb.Name = L"互斥锁直方图 Record（对照）";
+		lb.Threads = threads;
+		lb.NanosPerOp = MeasureRecord(locked, values, threads, iterations);
+		results.push_back(lb);
+	}
+
+	// UI 线程读取一次完整快照（5 个直方图）
+	{
+		PlaybackTelemetry t;
+		for (uint64_t v : values)
+		{
+			t.Read.Record(v);
+			t.Present.Record(v / 8);
+		}
+		const int reps = (std::max)(iterations / 200, 100);
+		uint64_t checksum = 0;
+		auto t0 = std::chrono::steady_clock::now();
+		for (int i = 0; i < reps; i++)
+		{
+			PlaybackStats stats;
+			t.Fill(stats);
+			checksum += stats.Read.Count + stats.Present.Buckets[i % LatencyHistogram::BucketCount];
+		}
+		const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+		// 防止循环被优化掉
+		volatile uint64_t sink = checksum;
+		(void)sink;
+		PlaybackTelemetryBenchmarkResult b;
+		b.Name = L"读取快照（5 个直方图）";
+		b.NanosPerOp = ns / (double)reps;
+		results.push_back(b);
+	}
+	return results;
+}
+
+std::wstring PlaybackTelemetryBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<PlaybackTelemetryBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"播放遥测", checks);
+	for (const auto& b : benchmarks)
+	{
+		if (b.Threads > 0)
+			text += CheckFormat(L"%ls，%d 线程：%.1f ns/次\r\n", b.Name.c_str(), b.Threads, b.NanosPerOp);
+		else
+			text += CheckFormat(L"%ls：%.2f us/次\r\n", b.Name.c_str(), b.NanosPerOp / 1000.0);
+	}
+	return text;
+}
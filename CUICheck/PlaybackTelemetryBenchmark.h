@@ -0,0 +1,32 @@
+#pragma once
+
+/**
+ * @file PlaybackTelemetryBenchmark.h
+ * @brief 播放遥测（LatencyHistogram/PlaybackTelemetry）的校验与基准（CUICheck 套件 playback-telemetry）。
+ *
+ * 只使用 PlaybackTelemetry.h，不依赖 Media Foundation：
+ * - RunChecks：桶边界连续且单调、线性区精确、百分位与精确排序结果的误差在桶宽之内、
+ *   多线程并发记录的计数/总和/最大值精确、延后指数平均与音画偏差、清零
+ * - RunBenchmarks：单线程与 4 线程下每次 Record 的耗时（对照：互斥锁保护的直方图），以及读取一次完整快照的耗时
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct PlaybackTelemetryBenchmarkResult
+{
+	std::wstring Name;
+	/** @brief 同时记录的线程数（读取快照为 0）。 */
+	int Threads = 0;
+	/** @brief 每次操作的耗时（纳秒）。 */
+	double NanosPerOp = 0.0;
+};
+
+class PlaybackTelemetryBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param iterations 每个线程的记录次数。 */
+	static std::vector<PlaybackTelemetryBenchmarkResult> RunBenchmarks(int iterations = 2000000);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<PlaybackTelemetryBenchmarkResult>& benchmarks);
+};
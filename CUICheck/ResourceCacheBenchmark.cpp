@@ -0,0 +1,216 @@
+#include "ResourceCacheBenchmark.h"
+#include "../CppUtils/Graphics/ResourceCache.h"
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+namespace {
+
+// 桩资源：只记录编号，创建次数由调用方统计
+struct StubResource
+{
+	int Id = 0;
+};
+
+typedef ResourceCache<StubResource> StubCache;
+
+// 与 D2DGraphics::GetColorBrush / PieGeometry 相同的“查找，未命中则创建”
+int Acquire(StubCache& cache, uint32_t kind, const float* key, size_t count, int& creates)
+{
+	if (auto* hit = cache.Find(kind, key, count)) return hit->Id;
+	StubResource res;
+	res.Id = ++creates;
+	return cache.Insert(kind, key, count, res).Id;
+}
+
+CheckResult CheckHitMiss()
+{
+	CheckResult r{ L"命中与未命中", true, L"" };
+	StubCache cache(8);
+	int creates = 0;
+	const float red[4] = { 1, 0, 0, 1 };
+	const float blue[4] = { 0, 0, 1, 1 };
+	int a = Acquire(cache, 0, red, 4, creates);
+	int b = Acquire(cache, 0, blue, 4, creates);
+	int c = Acquire(cache, 0, red, 4, creates);
+	ExpectCount(r, L"同色返回同一资源", c, a);
+	ExpectCount(r, L"异色资源不同", a != b, 1);
+	ExpectCount(r, L"创建次数", creates, 2);
+	ExpectCount(r, L"命中", (long long)cache.Stats().Hits, 1);
+	ExpectCount(r, L"未命中", (long long)cache.Stats().Misses, 2);
+	return r;
+}
+
+CheckResult CheckLruOrder()
+{
+	CheckResult r{ L"LRU 淘汰顺序", true, L"" };
+	StubCache cache(3);
+	int creates = 0;
+	const float k1 = 1, k2 = 2, k3 = 3, k4 = 4;
+	Acquire(cache, 0, &k1, 1, creates);
+	Acquire(cache, 0, &k2, 1, creates);
+	Acquire(cache, 0, &k3, 1, creates);
+	// 访问 k1 后插入 k4：应淘汰最久未用的 k2
+	Acquire(cache, 0, &k1, 1, creates);
+	Acquire(cache, 0, &k4, 1, creates);
+	ExpectCount(r, L"数量", (long long)cache.Count(), 3);
+	ExpectCount(r, L"淘汰数", (long long)cache.Stats().Evictions, 1);
+	ExpectCount(r, L"k1 仍在", cache.Find(0, &k1, 1) != nullptr, 1);
+	ExpectCount(r, L"k3 仍在", cache.Find(0, &k3, 1) != nullptr, 1);
+	ExpectCount(r, L"k2 已淘汰", cache.Find(0, &k2, 1) == nullptr, 1);
+	return r;
+}
+
+CheckResult CheckKeys()
+{
+	CheckResult r{ L"键按位比较", true, L"" };
+	StubCache cache(16);
+	int creates = 0;
+	const float zero = 0.0f, negZero = -0.0f;
+	Acquire(cache, 0, &zero, 1, creates);
+	Acquire(cache, 0, &negZero, 1, creates);
+	ExpectCount(r, L"0 与 -0 视为不同", creates, 2);
+	// 同样的 float，不同种类（饼图 vs 圆弧）或不同长度都不能混用
+	const float pie[6] = { 10, 10, 20, 20, 0, 90 };
+	Acquire(cache, 1, pie, 6, creates);
+	Acquire(cache, 2, pie, 6, creates);
+	Acquire(cache, 1, pie, 5, creates);
+	ExpectCount(r, L"种类/长度区分后创建次数", creates, 5);
+	const float pieAgain[6] = { 10, 10, 20, 20, 0, 90 };
+	Acquire(cache, 1, pieAgain, 6, creates);
+	ExpectCount(r, L"等值副本命中后创建次数", creates, 5);
+	return r;
+}
+
+CheckResult CheckReplaceAndShrink()
+{
+	CheckResult r{ L"替换与缩容", true, L"" };
+	StubCache cache(10);
+	const float key = 7.0f;
+	cache.Insert(0, &key, 1, StubResource{ 1 });
+	cache.Insert(0, &key, 1, StubResource{ 2 });
+	ExpectCount(r, L"同键插入后数量", (long long)cache.Count(), 1);
+	auto* hit = cache.Find(0, &key, 1);
+	ExpectCount(r, L"替换后的值", hit ? hit->Id : -1, 2);
+	for (int i = 0; i < 10; i++)
+	{
+		float k = 100.0f + i;
+		cache.Insert(0, &k, 1, StubResource{ i });
+	}
+	ExpectCount(r, L"满容量数量", (long long)cache.Count(), 10);
+	cache.SetCapacity(4);
+	ExpectCount(r, L"缩容后数量", (long long)cache.Count(), 4);
+	float newest = 109.0f;
+	ExpectCount(r, L"最近项保留", cache.Find(0, &newest, 1) != nullptr, 1);
+	cache.Clear();
+	ExpectCount(r, L"清空后数量", (long long)cache.Count(), 0);
+	return r;
+}
+
+// 每帧按 produce 生成的键依次“取资源”
+ResourceCacheBenchmarkResult RunCase(const wchar_t* name, int frames, size_t capacity,
+	const std::function<void(int frame, std::vector<std::vector<float>>& keys)>& produce)
+{
+	ResourceCacheBenchmarkResult result;
+	result.Name = name;
+	result.Frames = frames;
+	StubCache cache(capacity);
+	std::vector<std::vector<float>> keys;
+	int creates = 0;
+	long long lookups = 0;
+	double seconds = 0.0;
+	for (int f = 0; f < frames; f++)
+	{
+		keys.clear();
+		produce(f, keys);
+		int before = creates;
+		auto t0 = std::chrono::steady_clock::now();
+		for (const auto& k : keys)
+			Acquire(cache, (uint32_t)k.size(), k.data(), k.size(), creates);
+		auto t1 = std::chrono::steady_clock::now();
+		seconds += std::chrono::duration<double>(t1 - t0).count();
+		lookups += (long long)keys.size();
+		if (f == 0) result.FirstFrameCreates = creates - before;
+	}
+	result.LookupsPerFrame = frames > 0 ? (int)(lookups / frames) : 0;
+	result.SteadyCreatesPerFrame = frames > 1 ? (double)(creates - result.FirstFrameCreates) / (frames - 1) : 0.0;
+	auto s = cache.Stats();
+	result.HitRate = (s.Hits + s.Misses) > 0 ? (double)s.Hits / (double)(s.Hits + s.Misses) : 0.0;
+	result.NanosPerLookup = lookups > 0 ? seconds * 1e9 / lookups : 0.0;
+	return result;
+}
+
+} // namespace
+
+std::vector<CheckResult> ResourceCacheBenchmark::RunChecks()
+{
+	std::vector<CheckResult> results;
+	results.push_back(CheckHitMiss());
+	results.push_back(CheckLruOrder());
+	results.push_back(CheckKeys());
+	results.push_back(CheckReplaceAndShrink());
+	return results;
+}
+
+std::vector<ResourceCacheBenchmarkResult> ResourceCacheBenchmark::RunBenchmarks(int framesPerCase)
+{
+	if (framesPerCase < 2) framesPerCase = 2;
+	std::vector<ResourceCacheBenchmarkResult> results;
+
+	// GridView：3000 个单元格，背景/文字/边框共 12 种颜色（D2DGraphics 默认画刷容量 64）
+	results.push_back(RunCase(L"表格画刷（12 色 x 3000 次）", framesPerCase, 64,
+		[](int, std::vector<std::vector<float>>& keys)
+		{
+			for (int i = 0; i < 3000; i++)
+			{
+				float shade = (float)(i % 12) / 12.0f;
+				keys.push_back({ shade, shade, 1.0f - shade, 1.0f });
+			}
+		}));
+
+	// 菜单：每项一个展开箭头三角形（坐标随行号变化）+ 复选标记圆弧，共 400 个形状；
+	// 工作集超过容量时 LRU 每帧全部未命中，因此 D2DGraphics 默认几何容量取 1024
+	results.push_back(RunCase(L"菜单箭头/勾选（400 个形状，容量 256）", framesPerCase, 256,
+		[](int, std::vector<std::vector<float>>& keys)
+		{
+			for (int i = 0; i < 200; i++)
+			{
+				float y = 30.0f + i * 24.0f;
+				keys.push_back({ 280, y, 286, y + 6, 280, y + 12 });
+				keys.push_back({ 12, y + 6, 5, 0, 270 });
+			}
+		}));
+	results.push_back(RunCase(L"同上，默认容量 1024", framesPerCase, 1024,
+		[](int, std::vector<std::vector<float>>& keys)
+		{
+			for (int i = 0; i < 200; i++)
+			{
+				float y = 30.0f + i * 24.0f;
+				keys.push_back({ 280, y, 286, y + 6, 280, y + 12 });
+				keys.push_back({ 12, y + 6, 5, 0, 270 });
+			}
+		}));
+
+	// 加载动画：圆弧角度每帧变化，只有当前帧的形状可复用
+	results.push_back(RunCase(L"旋转加载圆弧（每帧新形状）", framesPerCase, 1024,
+		[](int f, std::vector<std::vector<float>>& keys)
+		{
+			float start = (float)((f * 6) % 360);
+			for (int i = 0; i < 4; i++)
+				keys.push_back({ 640, 400, 20, start, start + 270 });
+		}));
+	return results;
+}
+
+std::wstring ResourceCacheBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<ResourceCacheBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"资源缓存", checks);
+	text += L"每帧资源创建（首帧 → 稳定帧）：\r\n";
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"  %ls：%d 次查找/帧；创建 %d → %.1f/帧；命中率 %.1f%%；%.1f 纳秒/次\r\n",
+			b.Name.c_str(), b.LookupsPerFrame, b.FirstFrameCreates, b.SteadyCreatesPerFrame,
+			b.HitRate * 100.0, b.NanosPerLookup);
+	}
+	return text;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @file ResourceCacheBenchmark.h
+ * @brief 画刷/几何缓存（ResourceCache）的离线校验与基准（CUICheck 套件 resource-cache）。
+ *
+ * 只使用 ResourceCache 模板，值为计数用的桩对象，不创建设备：
+ * - RunChecks：命中/未命中计数、LRU 淘汰顺序、按位比较的键、同键替换、缩容
+ * - RunBenchmarks：模拟表格/菜单每帧重绘大量相同形状，统计稳定帧的创建次数与查找耗时
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct ResourceCacheBenchmarkResult
+{
+	std::wstring Name;
+	int Frames = 0;
+	int LookupsPerFrame = 0;
+	/** @brief 第一帧（冷缓存）创建的资源数。 */
+	int FirstFrameCreates = 0;
+	/** @brief 之后每帧平均创建的资源数（稳定帧应为 0）。 */
+	double SteadyCreatesPerFrame = 0.0;
+	double HitRate = 0.0;
+	double NanosPerLookup = 0.0;
+};
+
+class ResourceCacheBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param framesPerCase 每个场景模拟的帧数。 */
+	static std::vector<ResourceCacheBenchmarkResult> RunBenchmarks(int framesPerCase = 120);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<ResourceCacheBenchmarkResult>& benchmarks);
+};
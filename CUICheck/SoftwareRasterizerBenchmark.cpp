@@ -0,0 +1,298 @@
+#include "SoftwareRasterizerBenchmark.h"
+#include "../CppUtils/Graphics/SoftwareRasterizer.h"
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+namespace {
+
+const int WindowWidth = 1280;
+const int WindowHeight = 800;
+
+const DisplayColor White{ 1.0f, 1.0f, 1.0f, 1.0f };
+const DisplayColor Black{ 0.0f, 0.0f, 0.0f, 1.0f };
+const DisplayColor Red{ 1.0f, 0.0f, 0.0f, 1.0f };
+const DisplayColor Accent{ 0.0f, 0.47f, 0.84f, 1.0f };
+const DisplayColor Panel{ 0.93f, 0.93f, 0.93f, 1.0f };
+const DisplayColor Shade{ 0.0f, 0.0f, 0.0f, 0.25f };
+
+DisplayRect Rect(float x, float y, float w, float h)
+{
+	return DisplayRect{ x, y, x + w, y + h };
+}
+
+int Channel(uint32_t pixel, int shift)
+{
+	return (int)((pixel >> shift) & 0xFF);
+}
+
+// 透明背景上的覆盖面积（按 alpha 累加）
+double CoveredArea(const PixelBuffer& buffer)
+{
+	double area = 0.0;
+	for (uint32_t p : buffer.Pixels())
+		area += (p >> 24) / 255.0;
+	return area;
+}
+
+size_t TouchedPixels(const PixelBuffer& buffer)
+{
+	size_t n = 0;
+	for (uint32_t p : buffer.Pixels())
+		if (p != 0) n++;
+	return n;
+}
+
+CheckResult CheckSolidRect()
+{
+	CheckResult r{ L"整像素矩形", true, L"" };
+	PixelBuffer buffer(64, 64);
+	SoftwareRasterizer raster(&buffer);
+	raster.Clear(White);
+	raster.FillRect(Rect(10, 12, 20, 8), Red);
+	size_t red = 0;
+	for (uint32_t p : buffer.Pixels())
+		if (p == 0xFFFF0000u) red++;
+	ExpectCount(r, L"红色像素", (long long)red, 20 * 8);
+	ExpectCount(r, L"矩形外像素", buffer.Get(9, 12), 0xFFFFFFFFu);
+	return r;
+}
+
+CheckResult CheckHalfPixelEdge()
+{
+	CheckResult r{ L"半像素边缘", true, L"" };
+	PixelBuffer buffer(16, 16);
+	SoftwareRasterizer raster(&buffer);
+	raster.FillRect(DisplayRect{ 2.5f, 2.0f, 6.5f, 4.0f }, Black);
+	ExpectNear(r, L"左边缘 alpha", Channel(buffer.Get(2, 2), 24), 128, 1);
+	ExpectNear(r, L"内部 alpha", Channel(buffer.Get(4, 2), 24), 255, 0);
+	ExpectNear(r, L"右边缘 alpha", Channel(buffer.Get(6, 3), 24), 128, 1);
+	ExpectNear(r, L"总面积", CoveredArea(buffer), 8.0, 0.05);
+	return r;
+}
+
+CheckResult CheckEllipseArea()
+{
+	CheckResult r{ L"椭圆面积", true, L"" };
+	PixelBuffer buffer(128, 128);
+	SoftwareRasterizer raster(&buffer);
+	raster.FillEllipse(64.3f, 63.7f, 50.0f, 30.0f, Black);
+	const double expected = 3.14159265358979 * 50.0 * 30.0;
+	ExpectNear(r, L"面积", CoveredArea(buffer), expected, expected * 0.005);
+	// 圆心满覆盖、外接矩形角落为空
+	ExpectCount(r, L"圆心 alpha", Channel(buffer.Get(64, 64), 24), 255);
+	ExpectCount(r, L"角落像素", buffer.Get(16, 36), 0);
+	return r;
+}
+
+CheckResult CheckStroke()
+{
+	CheckResult r{ L"描边", true, L"" };
+	PixelBuffer buffer(64, 64);
+	SoftwareRasterizer raster(&buffer);
+	// 1 像素线宽落在半像素坐标上：恰好覆盖整像素
+	raster.DrawRect(DisplayRect{ 10.5f, 10.5f, 30.5f, 20.5f }, Black, 1.0f);
+	ExpectCount(r, L"边框像素", (long long)TouchedPixels(buffer), 2 * 21 + 2 * 9);
+	ExpectCount(r, L"内部像素", buffer.Get(20, 15), 0);
+	ExpectCount(r, L"角像素", buffer.Get(10, 10), 0xFF000000u);
+
+	PixelBuffer ring(128, 128);
+	SoftwareRasterizer ringRaster(&ring);
+	ringRaster.DrawEllipse(64.0f, 64.0f, 40.0f, 40.0f, Black, 4.0f);
+	const double expected = 3.14159265358979 * (42.0 * 42.0 - 38.0 * 38.0);
+	ExpectNear(r, L"圆环面积", CoveredArea(ring), expected, expected * 0.01);
+	ExpectCount(r, L"圆环中心", ring.Get(64, 64), 0);
+	return r;
+}
+
+CheckResult CheckClip()
+{
+	CheckResult r{ L"裁剪栈", true, L"" };
+	PixelBuffer buffer(64, 64);
+	SoftwareRasterizer raster(&buffer);
+	raster.PushClip(Rect(8, 8, 32, 32));
+	raster.PushClip(Rect(16, 0, 64, 20));
+	raster.FillEllipse(32, 32, 40, 40, Black);
+	raster.PopClip();
+	ExpectCount(r, L"内层裁剪后像素", (long long)TouchedPixels(buffer), 24 * 12);
+	raster.FillRect(Rect(0, 0, 64, 64), Black);
+	raster.PopClip();
+	ExpectCount(r, L"外层裁剪后像素", (long long)TouchedPixels(buffer), 32 * 32);
+	return r;
+}
+
+CheckResult CheckBitmapOpacity()
+{
+	CheckResult r{ L"位图不透明度", true, L"" };
+	PixelBuffer image(4, 4, PixelBuffer::Pack(Red));
+	PixelBuffer buffer(32, 32);
+	SoftwareRasterizer raster(&buffer);
+	raster.Clear(White);
+	raster.DrawBitmap(image, Rect(8, 8, 16, 16), nullptr, 0.5f);
+	uint32_t p = buffer.Get(12, 12);
+	ExpectNear(r, L"R", Channel(p, 16), 255, 1);
+	ExpectNear(r, L"G", Channel(p, 8), 128, 1);
+	ExpectNear(r, L"B", Channel(p, 0), 128, 1);
+	ExpectCount(r, L"目标外像素", buffer.Get(7, 12), 0xFFFFFFFFu);
+
+	// 经列表回放：资源通过 ResolveImage 解析
+	DisplayList list;
+	int token = 0;
+	DisplayCommand c;
+	c.Op = DisplayOp::DrawBitmap;
+	c.Resource = list.AddResource(std::shared_ptr<void>(&token, [](void*) {}));
+	c.X = 0; c.Y = 0; c.Z = 4; c.W = 4;
+	c.A = 1.0f;
+	list.Push(c);
+	PixelBuffer target(8, 8);
+	SoftwareRasterizer replay(&target);
+	replay.ResolveImage = [&](void* resource) { return resource == &token ? &image : nullptr; };
+	replay.Render(list);
+	ExpectCount(r, L"回放后红色像素", (long long)TouchedPixels(target), 16);
+	return r;
+}
+
+CheckResult CheckTransform()
+{
+	CheckResult r{ L"旋转变换", true, L"" };
+	PixelBuffer buffer(128, 128);
+	SoftwareRasterizer raster(&buffer);
+	const float c = std::cos(0.5f), s = std::sin(0.5f);
+	const float m[6] = { c, s, -s, c, 64.0f, 64.0f };
+	raster.SetTransform(m);
+	raster.FillRect(DisplayRect{ -20.0f, -10.0f, 20.0f, 10.0f }, Black);
+	ExpectNear(r, L"旋转后面积", CoveredArea(buffer), 800.0, 2.0);
+	ExpectCount(r, L"中心 alpha", Channel(buffer.Get(64, 64), 24), 255);
+	return r;
+}
+
+void RecordDashboard(DisplayList& list)
+{
+	list.Clear(Panel);
+	// 标题栏与侧边栏
+	list.FillRect(Rect(0, 0, WindowWidth, 32), Accent);
+	list.DrawString(L"CUI 软件光栅", 12, 6, White);
+	list.FillRect(Rect(0, 32, 200, WindowHeight - 32), White);
+	for (int i = 0; i < 16; i++)
+	{
+		list.FillRect(Rect(0, 40.0f + i * 28, 200, 26), (i == 3) ? Accent : White);
+		list.DrawString(L"导航项", 16, 44.0f + i * 28, (i == 3) ? White : Black);
+	}
+	// 卡片：圆角背景、标题、圆形头像
+	for (int row = 0; row < 3; row++)
+	{
+		for (int col = 0; col < 4; col++)
+		{
+			float x = 220.0f + col * 260.0f;
+			float y = 50.0f + row * 240.0f;
+			list.FillRoundRect(Rect(x + 3, y + 3, 240, 220), Shade, 8.0f);
+			list.FillRoundRect(Rect(x, y, 240, 220), White, 8.0f);
+			list.DrawRoundRect(Rect(x, y, 240, 220), Panel, 1.0f, 8.0f);
+			list.FillEllipse(x + 32, y + 32, 20, 20, Accent);
+			list.DrawString(L"卡片标题", x + 60, y + 22, Black);
+			for (int line = 0; line < 6; line++)
+				list.DrawLine(x + 16, y + 80.0f + line * 20, x + 224, y + 80.0f + line * 20, Panel, 1.0f);
+		}
+	}
+}
+
+void RecordGrid(DisplayList& list)
+{
+	list.Clear(White);
+	for (int row = 0; row < 40; row++)
+		list.FillRect(Rect(0, row * 20.0f, WindowWidth, 20), (row % 2) ? White : Panel);
+	for (int row = 0; row < 40; row++)
+		for (int col = 0; col < 8; col++)
+			list.DrawRect(Rect(col * 160.0f + 0.5f, row * 20.0f + 0.5f, 160, 20), Shade, 1.0f);
+	for (int row = 0; row < 40; row++)
+		for (int col = 0; col < 8; col++)
+			list.DrawString(L"单元格 123", col * 160.0f + 6, row * 20.0f + 2, Black);
+}
+
+CheckResult CheckDeterminism()
+{
+	CheckResult r{ L"确定性与跳过", true, L"" };
+	DisplayList list;
+	RecordDashboard(list);
+	DisplayCommand layout;
+	layout.Op = DisplayOp::DrawStringLayout;
+	layout.Paint = list.AddColor(Black);
+	list.Push(layout);
+
+	PixelBuffer a(WindowWidth, WindowHeight);
+	PixelBuffer b(WindowWidth, WindowHeight);
+	SoftwareRasterizer ra(&a);
+	SoftwareRasterizer rb(&b);
+	ra.Render(list);
+	rb.Render(list);
+	ExpectCount(r, L"两次渲染差异像素", (long long)a.DiffCount(b), 0);
+	ExpectCount(r, L"跳过的命令", (long long)ra.GetStats().Skipped, 1);
+	auto bmp = a.EncodeBmp();
+	ExpectCount(r, L"BMP 字节数", (long long)bmp.size(), 54 + 4LL * WindowWidth * WindowHeight);
+	return r;
+}
+
+RasterBenchmarkResult RunCase(const wchar_t* name, int frames, const std::function<void(DisplayList&)>& record)
+{
+	RasterBenchmarkResult result;
+	result.Name = name;
+	result.Frames = frames;
+	DisplayList list;
+	record(list);
+	result.Commands = list.Count();
+
+	PixelBuffer buffer(WindowWidth, WindowHeight);
+	SoftwareRasterizer raster(&buffer);
+	auto t0 = std::chrono::steady_clock::now();
+	for (int f = 0; f < frames; f++)
+		raster.Render(list);
+	auto t1 = std::chrono::steady_clock::now();
+	result.PixelsPerFrame = raster.GetStats().PixelsTouched / (size_t)frames;
+	result.MillisPerFrame = std::chrono::duration<double, std::milli>(t1 - t0).count() / frames;
+	return result;
+}
+
+} // namespace
+
+std::vector<CheckResult> SoftwareRasterizerBenchmark::RunChecks()
+{
+	std::vector<CheckResult> results;
+	results.push_back(CheckSolidRect());
+	results.push_back(CheckHalfPixelEdge());
+	results.push_back(CheckEllipseArea());
+	results.push_back(CheckStroke());
+	results.push_back(CheckClip());
+	results.push_back(CheckBitmapOpacity());
+	results.push_back(CheckTransform());
+	results.push_back(CheckDeterminism());
+	return results;
+}
+
+std::vector<RasterBenchmarkResult> SoftwareRasterizerBenchmark::RunBenchmarks(int framesPerCase)
+{
+	if (framesPerCase < 1) framesPerCase = 1;
+	std::vector<RasterBenchmarkResult> results;
+	results.push_back(RunCase(L"仪表盘（圆角卡片 + 文字）", framesPerCase, RecordDashboard));
+	results.push_back(RunCase(L"表格 40 行 x 8 列", framesPerCase, RecordGrid));
+	results.push_back(RunCase(L"整窗半透明矩形 x 10", framesPerCase,
+		[](DisplayList& list)
+		{
+			list.Clear(White);
+			for (int i = 0; i < 10; i++)
+				list.FillRect(Rect(0, 0, WindowWidth, WindowHeight), Shade);
+		}));
+	return results;
+}
+
+std::wstring SoftwareRasterizerBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<RasterBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"软件光栅", checks);
+	text += CheckFormat(L"每帧渲染（%dx%d，CPU）：\r\n", WindowWidth, WindowHeight);
+	for (const auto& b : benchmarks)
+	{
+		double mpix = b.MillisPerFrame > 0.0 ? (double)b.PixelsPerFrame / (b.MillisPerFrame * 1000.0) : 0.0;
+		text += CheckFormat(L"  %ls：%d 条命令；%.2f 毫秒/帧；写入 %d 像素（%.0f 百万像素/秒）\r\n",
+			b.Name.c_str(), (int)b.Commands, b.MillisPerFrame, (int)b.PixelsPerFrame, mpix);
+	}
+	return text;
+}
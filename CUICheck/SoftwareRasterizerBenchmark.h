@@ -0,0 +1,32 @@
+#pragma once
+
+/**
+ * @file SoftwareRasterizerBenchmark.h
+ * @brief CPU 光栅化的离线校验与渲染基准（CUICheck 套件 raster）。
+ *
+ * 只使用 DisplayList 与 SoftwareRasterizer，不创建设备：
+ * - RunChecks：矩形覆盖/半像素边缘/椭圆面积/描边/裁剪/位图不透明度/旋转变换/确定性与跳过的命令
+ * - RunBenchmarks：在 1280x800 缓冲区上按帧渲染典型界面的显示列表，统计每帧耗时与写入像素
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct RasterBenchmarkResult
+{
+	std::wstring Name;
+	int Frames = 0;
+	size_t Commands = 0;
+	/** @brief 每帧写入的像素数（含部分覆盖）。 */
+	size_t PixelsPerFrame = 0;
+	double MillisPerFrame = 0.0;
+};
+
+class SoftwareRasterizerBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param framesPerCase 每个场景渲染的帧数。 */
+	static std::vector<RasterBenchmarkResult> RunBenchmarks(int framesPerCase = 60);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<RasterBenchmarkResult>& benchmarks);
+};
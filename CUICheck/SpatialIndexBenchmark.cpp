@@ -0,0 +1,303 @@
+#include "SpatialIndexBenchmark.h"
+#include "../CUI/GUI/SpatialIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+namespace {
+
+const int AreaWidth = 1600;
+const int AreaHeight = 1000;
+
+struct Lcg
+{
+	uint32_t State;
+	explicit Lcg(uint32_t seed) : State(seed) {}
+	int Next(int bound)
+	{
+		State = State * 1664525u + 1013904223u;
+		return (int)((State >> 8) % (uint32_t)bound);
+	}
+};
+
+struct TestItem
+{
+	SpatialRect Rect;
+};
+
+struct TestBounds
+{
+	static SpatialRect Bounds(TestItem* item) { return item->Rect; }
+};
+
+/** @brief 与 List 同名的修改函数（SpatialList 覆盖的就是这些）。 */
+struct TestListBase : std::vector<TestItem*>
+{
+	void Add(TestItem* v) { push_back(v); }
+	void Insert(int index, TestItem* v) { insert(begin() + index, v); }
+	void RemoveAt(int index) { erase(begin() + index); }
+	int Remove(TestItem* v)
+	{
+		size_t n = size();
+		erase(std::remove(begin(), end(), v), end());
+		return (int)(n - size());
+	}
+	void Swap(int from, int to) { std::swap((*this)[(size_t)from], (*this)[(size_t)to]); }
+	void Reverse() { std::reverse(begin(), end()); }
+	void Clear() { clear(); }
+	void set(int i, TestItem* v) { (*this)[(size_t)i] = v; }
+};
+typedef SpatialList<TestItem, TestBounds, TestListBase> TestList;
+
+/** @brief 测试用容器：子项由 Pool 持有，随机生成小控件与少量跨越大片网格的大控件。 */
+struct TestScene
+{
+	std::vector<std::unique_ptr<TestItem>> Pool;
+	TestList Items;
+
+	TestItem* NewItem(Lcg& rng)
+	{
+		auto item = std::make_unique<TestItem>();
+		bool big = rng.Next(40) == 0;
+		int w = big ? 600 + rng.Next(800) : 10 + rng.Next(120);
+		int h = big ? 400 + rng.Next(500) : 10 + rng.Next(60);
+		// 允许负坐标与超出容器（滚动/部分可见的子控件）
+		int x = rng.Next(AreaWidth + 200) - 100;
+		int y = rng.Next(AreaHeight + 200) - 100;
+		item->Rect = SpatialRect{ x, y, x + w, y + h };
+		Pool.push_back(std::move(item));
+		return Pool.back().get();
+	}
+	void Fill(int count, Lcg& rng)
+	{
+		for (int i = 0; i < count; i++)
+			Items.Add(NewItem(rng));
+	}
+};
+
+void ScanPoint(const std::vector<TestItem*>& items, SpatialPoint p, std::vector<TestItem*>& out)
+{
+	out.clear();
+	for (auto item : items)
+		if (item->Rect.Contains(p.X, p.Y)) out.push_back(item);
+}
+
+void ScanRect(const std::vector<TestItem*>& items, const SpatialRect& r, int inflatePx, std::vector<TestItem*>& out)
+{
+	out.clear();
+	for (auto item : items)
+		if (item->Rect.Intersects(r, inflatePx)) out.push_back(item);
+}
+
+/** @brief 随机点与随机矩形查询，结果（含顺序）与逐个扫描比较。 */
+void ExpectMatchesScan(CheckResult& r, const wchar_t* what, TestScene& scene, Lcg& rng, int queries)
+{
+	if (!r.Passed) return;
+	std::vector<TestItem*> got, expected;
+	for (int i = 0; i < queries; i++)
+	{
+		SpatialPoint p{ rng.Next(AreaWidth + 400) - 200, rng.Next(AreaHeight + 400) - 200 };
+		scene.Items.QueryPoint(p, got);
+		ScanPoint(scene.Items, p, expected);
+		if (got != expected)
+		{
+			r.Passed = false;
+			r.Detail = CheckFormat(L"%ls：点 (%d,%d) 命中 %d 个，扫描 %d 个（或顺序不同）",
+				what, p.X, p.Y, (int)got.size(), (int)expected.size());
+			return;
+		}
+
+		int x = rng.Next(AreaWidth) - 50, y = rng.Next(AreaHeight) - 50;
+		SpatialRect q{ x, y, x + 1 + rng.Next(300), y + 1 + rng.Next(200) };
+		int inflate = rng.Next(3);
+		scene.Items.QueryRect(q, inflate, got);
+		ScanRect(scene.Items, q, inflate, expected);
+		if (got != expected)
+		{
+			r.Passed = false;
+			r.Detail = CheckFormat(L"%ls：矩形 (%d,%d,%d,%d) 相交 %d 个，扫描 %d 个（或顺序不同）",
+				what, q.Left, q.Top, q.Right, q.Bottom, (int)got.size(), (int)expected.size());
+			return;
+		}
+	}
+}
+
+CheckResult CheckHitTest()
+{
+	CheckResult r{ L"命中与相交", true, L"" };
+	Lcg rng(17);
+	TestScene scene;
+	scene.Fill(400, rng);
+	ExpectMatchesScan(r, L"建立索引", scene, rng, 2000);
+	ExpectTrue(r, L"索引已建立", scene.Items.IsIndexBuilt());
+
+	// 边界：右/下边界包含在点命中中，矩形相交不含贴边
+	TestList& items = scene.Items;
+	TestItem* probe = items[0];
+	std::vector<TestItem*> got;
+	items.QueryPoint(SpatialPoint{ probe->Rect.Right, probe->Rect.Bottom }, got);
+	ExpectTrue(r, L"右下角命中", std::find(got.begin(), got.end(), probe) != got.end());
+	items.QueryRect(SpatialRect{ probe->Rect.Right, probe->Rect.Top, probe->Rect.Right + 10, probe->Rect.Bottom }, 0, got);
+	ExpectTrue(r, L"贴边矩形不相交", std::find(got.begin(), got.end(), probe) == got.end());
+	items.QueryRect(SpatialRect{ probe->Rect.Right, probe->Rect.Top, probe->Rect.Right + 10, probe->Rect.Bottom }, 1, got);
+	ExpectTrue(r, L"扩展 1 像素后相交", std::find(got.begin(), got.end(), probe) != got.end());
+	return r;
+}
+
+CheckResult CheckReorder()
+{
+	CheckResult r{ L"重排后的绘制顺序", true, L"" };
+	Lcg rng(29);
+	TestScene scene;
+	scene.Fill(300, rng);
+	ExpectMatchesScan(r, L"初始", scene, rng, 200);
+
+	// 数量不变的重排：旧实现只比较数量，会按建立时的顺序返回
+	scene.Items.Swap(3, 250);
+	ExpectTrue(r, L"Swap 后索引失效", !scene.Items.IsIndexBuilt());
+	ExpectMatchesScan(r, L"Swap", scene, rng, 500);
+	for (int i = 0; i < 50; i++)
+		scene.Items.Swap(rng.Next(300), rng.Next(300));
+	ExpectMatchesScan(r, L"多次 Swap", scene, rng, 500);
+	scene.Items.Reverse();
+	ExpectMatchesScan(r, L"Reverse", scene, rng, 500);
+	scene.Items.set(10, scene.NewItem(rng));
+	ExpectMatchesScan(r, L"set 替换", scene, rng, 500);
+
+	// 数量变化
+	scene.Items.Insert(0, scene.NewItem(rng));
+	ExpectMatchesScan(r, L"Insert", scene, rng, 500);
+	scene.Items.RemoveAt(100);
+	ExpectMatchesScan(r, L"RemoveAt", scene, rng, 500);
+	// 移除一个、加入一个：数量与移除前相同
+	TestItem* removed = scene.Items[50];
+	scene.Items.Remove(removed);
+	ExpectMatchesScan(r, L"Remove", scene, rng, 200);
+	scene.Items.Add(removed);
+	ExpectMatchesScan(r, L"移到末尾", scene, rng, 500);
+
+	// 直接改写元素需要显式失效
+	std::swap(scene.Items[0], scene.Items[1]);
+	scene.Items.InvalidateIndex();
+	ExpectMatchesScan(r, L"下标改写 + InvalidateIndex", scene, rng, 500);
+	return r;
+}
+
+CheckResult CheckMove()
+{
+	CheckResult r{ L"移动子项", true, L"" };
+	Lcg rng(41);
+	TestScene scene;
+	scene.Fill(300, rng);
+	ExpectMatchesScan(r, L"初始", scene, rng, 100);
+	for (int round = 0; round < 20; round++)
+	{
+		for (int i = 0; i < 20; i++)
+		{
+			TestItem* item = scene.Items[(size_t)rng.Next(300)];
+			int dx = rng.Next(400) - 200, dy = rng.Next(300) - 150;
+			// 偶尔变大到越过 MaxCellsPerEntry，或缩小回普通尺寸
+			int grow = rng.Next(20) == 0 ? 900 : 0;
+			item->Rect = SpatialRect{ item->Rect.Left + dx, item->Rect.Top + dy,
+				item->Rect.Left + dx + (std::max)(4, (item->Rect.Right - item->Rect.Left) % 150 + grow),
+				item->Rect.Top + dy + (std::max)(4, (item->Rect.Bottom - item->Rect.Top) % 80 + grow) };
+			scene.Items.UpdateBounds(item);
+		}
+		ExpectTrue(r, L"增量更新不重建", scene.Items.IsIndexBuilt());
+		ExpectMatchesScan(r, L"UpdateBounds", scene, rng, 100);
+	}
+	return r;
+}
+
+CheckResult CheckSmall()
+{
+	CheckResult r{ L"少量子项", true, L"" };
+	Lcg rng(53);
+	TestScene scene;
+	const int below = SpatialIndex<TestItem, TestBounds>::MinItems - 1;
+	scene.Fill(below, rng);
+	ExpectMatchesScan(r, L"线性扫描", scene, rng, 500);
+	ExpectTrue(r, L"未建立索引", !scene.Items.IsIndexBuilt());
+	scene.Items.Add(scene.NewItem(rng));
+	ExpectMatchesScan(r, L"达到 MinItems", scene, rng, 500);
+	ExpectTrue(r, L"已建立索引", scene.Items.IsIndexBuilt());
+	scene.Items.RemoveAt(0);
+	ExpectMatchesScan(r, L"回到线性扫描", scene, rng, 500);
+	scene.Items.Clear();
+	std::vector<TestItem*> got;
+	scene.Items.QueryPoint(SpatialPoint{ 10, 10 }, got);
+	ExpectCount(r, L"清空后命中数", (long long)got.size(), 0);
+	return r;
+}
+
+double MicrosSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+std::vector<CheckResult> SpatialIndexBenchmark::RunChecks()
+{
+	return {
+		CheckHitTest(),
+		CheckReorder(),
+		CheckMove(),
+		CheckSmall(),
+	};
+}
+
+std::vector<SpatialIndexBenchmarkResult> SpatialIndexBenchmark::RunBenchmarks(int items)
+{
+	std::vector<SpatialIndexBenchmarkResult> results;
+	if (items < 1) items = 1;
+	Lcg rng(7);
+	TestScene scene;
+	scene.Fill(items, rng);
+	const int queries = 20000;
+	std::vector<SpatialPoint> points;
+	std::vector<SpatialRect> rects;
+	for (int i = 0; i < queries; i++)
+	{
+		points.push_back(SpatialPoint{ rng.Next(AreaWidth), rng.Next(AreaHeight) });
+		int x = rng.Next(AreaWidth), y = rng.Next(AreaHeight);
+		rects.push_back(SpatialRect{ x, y, x + 40, y + 20 });
+	}
+
+	std::vector<TestItem*> out;
+	size_t hits = 0;
+	{
+		scene.Items.QueryPoint(points[0], out);
+		auto start = std::chrono::steady_clock::now();
+		for (auto& p : points) { scene.Items.QueryPoint(p, out); hits += out.size(); }
+		double point = MicrosSince(start) / queries;
+		start = std::chrono::steady_clock::now();
+		for (auto& q : rects) { scene.Items.QueryRect(q, 2, out); hits += out.size(); }
+		double rect = MicrosSince(start) / queries;
+		results.push_back({ L"空间索引", items, point, rect });
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (auto& p : points) { ScanPoint(scene.Items, p, out); hits += out.size(); }
+		double point = MicrosSince(start) / queries;
+		start = std::chrono::steady_clock::now();
+		for (auto& q : rects) { ScanRect(scene.Items, q, 2, out); hits += out.size(); }
+		double rect = MicrosSince(start) / queries;
+		results.push_back({ L"逐个扫描", items, point, rect });
+	}
+	// 防止查询被优化掉
+	if (hits == (size_t)-1) results.clear();
+	return results;
+}
+
+std::wstring SpatialIndexBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<SpatialIndexBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"空间索引", checks);
+	text += CheckFormat(L"%dx%d 区域内随机子项，每次点命中 / 40x20 矩形查询：\r\n", AreaWidth, AreaHeight);
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"  %ls：%d 个子项，点 %.2f us，矩形 %.2f us\r\n",
+			b.Name.c_str(), b.Items, b.PointMicros, b.RectMicros);
+	}
+	return text;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * @file SpatialIndexBenchmark.h
+ * @brief 子控件空间索引的校验与基准（CUICheck 套件 spatial-index）。
+ *
+ * 只使用 SpatialIndex/SpatialList（以测试用矩形代替控件），不依赖 Win32：
+ * - RunChecks：随机布局下点命中与矩形相交的结果（含顺序，即绘制顺序）与逐个扫描一致；
+ *   Swap/Reverse/Insert/RemoveAt/set 等不改变或改变数量的修改后立即与扫描一致；
+ *   UpdateBounds 增量移动后一致；子项少于 MinItems 时走线性扫描
+ * - RunBenchmarks：大量子项时索引查询与逐个扫描的每次耗时
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct SpatialIndexBenchmarkResult
+{
+	std::wstring Name;
+	/** @brief 子项数量。 */
+	int Items = 0;
+	/** @brief 平均每次点命中 / 矩形查询的耗时（微秒）。 */
+	double PointMicros = 0.0;
+	double RectMicros = 0.0;
+};
+
+class SpatialIndexBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param items 子项数量。 */
+	static std::vector<SpatialIndexBenchmarkResult> RunBenchmarks(int items = 5000);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<SpatialIndexBenchmarkResult>& benchmarks);
+};
@@ -0,0 +1,420 @@
+#include "TextBufferBenchmark.h"
+#include "../CUI/GUI/Text/PieceTable.h"
+#include "../CUI/GUI/Text/UndoEngine.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// 固定种子的线性同余发生器：每次运行的编辑序列一致
+struct Lcg
+{
+	uint32_t State;
+	explicit Lcg(uint32_t seed) : State(seed) {}
+	uint32_t Next()
+	{
+		State = State * 1664525u + 1013904223u;
+		return State >> 8;
+	}
+	size_t Below(size_t n) { return n ? (size_t)Next() % n : 0; }
+};
+
+std::wstring RandomText(Lcg& rng, size_t len)
+{
+	static const wchar_t alphabet[] = L"abcdefghij klmnop\r\n中文字符";
+	std::wstring s(len, L'\0');
+	for (auto& ch : s)
+		ch = alphabet[rng.Below(sizeof(alphabet) / sizeof(alphabet[0]) - 1)];
+	return s;
+}
+
+std::wstring InitialText(size_t len)
+{
+	Lcg rng(7);
+	return RandomText(rng, len);
+}
+
+/** @brief 按 RichTextBox 的方式编辑文档并记入撤销历史（选区前后都是插入点）。 */
+struct Document
+{
+	PieceTable Text;
+	UndoEngine History;
+
+	void Edit(size_t pos, size_t removeLen, const std::wstring& inserted, int selStartBefore, int selEndBefore)
+	{
+		const std::wstring removed = Text.Substr(pos, removeLen);
+		Text.Erase(pos, removed.size());
+		Text.Insert(pos, inserted);
+		const int caret = (int)(pos + inserted.size());
+		History.Record(pos, removed, inserted, selStartBefore, selEndBefore, caret, caret);
+	}
+	void Type(size_t caret, const std::wstring& s) { Edit(caret, 0, s, (int)caret, (int)caret); }
+	void Backspace(size_t caret) { Edit(caret - 1, 1, L"", (int)caret, (int)caret); }
+	void DeleteForward(size_t caret) { Edit(caret, 1, L"", (int)caret, (int)caret); }
+
+	UndoEngine::TextReader Reader() const
+	{
+		return [this](size_t pos, size_t len) { return Text.Substr(pos, len); };
+	}
+	bool Apply(bool undo, UndoEngine::Change& c)
+	{
+		if (!(undo ? History.Undo(Reader(), c) : History.Redo(Reader(), c))) return false;
+		Text.Erase(c.Pos, c.RemoveLen);
+		Text.Insert(c.Pos, c.InsertText);
+		return true;
+	}
+};
+
+CheckResult CheckRandomEdits()
+{
+	CheckResult r{ L"随机编辑与 std::wstring 一致", true, L"" };
+	std::wstring expected = InitialText(2000);
+	PieceTable pt(expected);
+	Lcg rng(12345);
+	size_t compactions = 0;
+	for (int i = 0; i < 40000 && r.Passed; i++)
+	{
+		const size_t before = pt.StorageLength();
+		const size_t pos = rng.Below(expected.size() + 8);
+		if (rng.Next() % 3 == 0)
+		{
+			// 越界的起点/长度按约定裁剪
+			const size_t len = 1 + rng.Below(24);
+			pt.Erase(pos, len);
+			if (pos < expected.size())
+				expected.erase(pos, len);
+		}
+		else
+		{
+			const std::wstring s = RandomText(rng, 1 + rng.Below(12));
+			pt.Insert(pos, s);
+			expected.insert((std::min)(pos, expected.size()), s);
+		}
+		if (pt.StorageLength() < before) compactions++;
+		ExpectCount(r, L"长度", (long long)pt.Length(), (long long)expected.size());
+		// 整理后废弃内容不超过有效文本（小于阈值时不整理）
+		ExpectTrue(r, L"存储与文本长度成正比", pt.StorageLength() < 64 * 1024 || pt.StorageLength() <= 2 * pt.Length());
+		if (i % 997 == 0)
+			ExpectTrue(r, L"全文一致", pt.ToString() == expected);
+		if (i % 13 == 0 && !expected.empty())
+		{
+			const size_t at = rng.Below(expected.size());
+			ExpectCount(r, L"CharAt", (long long)pt.CharAt(at), (long long)expected[at]);
+			const size_t len = rng.Below(64);
+			ExpectTrue(r, L"Substr", pt.Substr(at, len) == expected.substr(at, len));
+		}
+	}
+	ExpectTrue(r, L"结束时全文一致", pt.ToString() == expected);
+	ExpectTrue(r, L"发生过自动整理", compactions > 0);
+	return r;
+}
+
+CheckResult CheckBounds()
+{
+	CheckResult r{ L"越界访问", true, L"" };
+	PieceTable pt(L"hello");
+	pt.Insert(100, L"!");
+	ExpectTrue(r, L"超出末尾的插入追加到末尾", pt.ToString() == L"hello!");
+	ExpectCount(r, L"越界 CharAt", (long long)pt.CharAt(6), 0);
+	ExpectTrue(r, L"越界 Substr 裁剪", pt.Substr(4, 100) == L"o!");
+	ExpectTrue(r, L"起点越界的 Substr 为空", pt.Substr(6, 3).empty());
+	pt.Erase(3, 100);
+	ExpectTrue(r, L"越界 Erase 裁剪", pt.ToString() == L"hel");
+	pt.Erase(10, 1);
+	ExpectTrue(r, L"起点越界的 Erase 无效果", pt.ToString() == L"hel");
+	std::wstring out = L">";
+	pt.CopyTo(1, 5, out);
+	ExpectTrue(r, L"CopyTo 追加且裁剪", out == L">el");
+	pt.Clear();
+	ExpectTrue(r, L"Clear", pt.Empty() && pt.PieceCount() == 0);
+	return r;
+}
+
+CheckResult CheckSurrogates()
+{
+	CheckResult r{ L"代理对原样保存", true, L"" };
+	// U+1F600 的 UTF-16 形式；以 wchar_t 为单位存储，位置与 RichTextBox 选区一致
+	const std::wstring emoji = { (wchar_t)0xD83D, (wchar_t)0xDE00 };
+	PieceTable pt(L"ab");
+	pt.Insert(1, emoji);
+	pt.Insert(3, emoji);
+	ExpectCount(r, L"长度", (long long)pt.Length(), 6);
+	ExpectCount(r, L"高位代理", (long long)pt.CharAt(1), 0xD83D);
+	ExpectCount(r, L"低位代理", (long long)pt.CharAt(2), 0xDE00);
+	ExpectTrue(r, L"Substr 取出完整代理对", pt.Substr(3, 2) == emoji);
+	pt.Erase(1, 2);
+	ExpectTrue(r, L"删除一个代理对", pt.ToString() == L"a" + emoji + L"b");
+	return r;
+}
+
+CheckResult CheckTypingExtends()
+{
+	CheckResult r{ L"连续键入扩展片段", true, L"" };
+	PieceTable pt(InitialText(1000));
+	for (size_t i = 0; i < 500; i++)
+		pt.Insert(400 + i, L"x", 1);
+	// 原文被切成两段 + 一个不断延长的键入片段
+	ExpectCount(r, L"片段数", (long long)pt.PieceCount(), 3);
+	ExpectTrue(r, L"键入内容", pt.Substr(400, 500) == std::wstring(500, L'x'));
+	return r;
+}
+
+CheckResult CheckUndoMerge()
+{
+	CheckResult r{ L"撤销合并", true, L"" };
+	Document doc;
+	doc.Type(0, L"a");
+	doc.Type(1, L"b");
+	doc.Type(2, L"c");
+	ExpectCount(r, L"连续键入合并为一步", (long long)doc.History.UndoCount(), 1);
+	doc.Type(3, L" ");
+	ExpectCount(r, L"单词后的空白并入", (long long)doc.History.UndoCount(), 1);
+	doc.Type(4, L"d");
+	ExpectCount(r, L"空白后开始新单词", (long long)doc.History.UndoCount(), 2);
+	doc.Type(5, L"e");
+	doc.Backspace(6);
+	doc.Backspace(5);
+	doc.Backspace(4);
+	ExpectCount(r, L"连续退格合并为一步", (long long)doc.History.UndoCount(), 3);
+	ExpectTrue(r, L"退格后的文本", doc.Text.ToString() == L"abc");
+	doc.DeleteForward(1);
+	doc.DeleteForward(1);
+	ExpectCount(r, L"连续向前删除合并为一步", (long long)doc.History.UndoCount(), 4);
+	ExpectTrue(r, L"删除后的文本", doc.Text.ToString() == L"a");
+	doc.Type(1, L"x");
+	doc.Type(0, L"y");
+	ExpectCount(r, L"光标移动后断开", (long long)doc.History.UndoCount(), 6);
+	doc.History.Seal();
+	doc.Type(1, L"z");
+	ExpectCount(r, L"Seal 后断开", (long long)doc.History.UndoCount(), 7);
+
+	UndoEngine::Change c;
+	doc.Apply(true, c);
+	doc.Apply(true, c);
+	doc.Apply(true, c);
+	ExpectTrue(r, L"撤销三步", doc.Text.ToString() == L"a");
+	doc.Apply(true, c);
+	ExpectTrue(r, L"撤销向前删除", doc.Text.ToString() == L"abc");
+	ExpectCount(r, L"选区恢复", c.SelStart, 1);
+	doc.Apply(true, c);
+	// 退格按输入顺序倒序保存，撤销时须按原顺序插回
+	ExpectTrue(r, L"撤销退格", doc.Text.ToString() == L"abc de");
+	ExpectCount(r, L"退格前的光标", c.SelEnd, 6);
+	return r;
+}
+
+CheckResult CheckUndoRoundTrip()
+{
+	CheckResult r{ L"撤销/重做往返", true, L"" };
+	Document doc;
+	const std::wstring initial = InitialText(500);
+	doc.Text.Assign(initial);
+	Lcg rng(99);
+	std::vector<std::wstring> snapshots;
+	snapshots.push_back(initial);
+	for (int i = 0; i < 300; i++)
+	{
+		// 每步都 Seal，快照与撤销步一一对应
+		doc.History.Seal();
+		const size_t len = doc.Text.Length();
+		const size_t pos = rng.Below(len + 1);
+		const size_t removeLen = rng.Next() % 2 ? rng.Below((std::min)((size_t)20, len - pos) + 1) : 0;
+		const std::wstring inserted = rng.Next() % 2 ? RandomText(rng, 1 + rng.Below(30)) : L"";
+		if (removeLen == 0 && inserted.empty()) continue;
+		doc.Edit(pos, removeLen, inserted, (int)pos, (int)(pos + removeLen));
+		snapshots.push_back(doc.Text.ToString());
+	}
+	ExpectCount(r, L"撤销步数", (long long)doc.History.UndoCount(), (long long)snapshots.size() - 1);
+
+	UndoEngine::Change c;
+	for (size_t i = snapshots.size() - 1; i > 0 && r.Passed; i--)
+	{
+		ExpectTrue(r, L"撤销", doc.Apply(true, c));
+		ExpectTrue(r, L"撤销后的文本", doc.Text.ToString() == snapshots[i - 1]);
+	}
+	ExpectTrue(r, L"撤销栈已空", !doc.History.CanUndo());
+	for (size_t i = 1; i < snapshots.size() && r.Passed; i++)
+	{
+		ExpectTrue(r, L"重做", doc.Apply(false, c));
+		ExpectTrue(r, L"重做后的文本", doc.Text.ToString() == snapshots[i]);
+	}
+	ExpectTrue(r, L"重做栈已空", !doc.History.CanRedo());
+
+	// 撤销后的新编辑清空重做栈
+	doc.Apply(true, c);
+	doc.Type(0, L"q");
+	ExpectTrue(r, L"新编辑清空重做", !doc.History.CanRedo());
+	return r;
+}
+
+CheckResult CheckUndoBudget()
+{
+	CheckResult r{ L"撤销字节预算", true, L"" };
+	Document doc;
+	doc.History.SetBudget(64 * 1024);
+	const std::wstring block(1000, L'x');
+	for (int i = 0; i < 200; i++)
+	{
+		// 整段替换：被删除的文本进入历史
+		doc.Text.Assign(block);
+		doc.Edit(0, block.size(), L"y", 0, (int)block.size());
+		ExpectTrue(r, L"占用不超过预算", doc.History.MemoryUsage() <= doc.History.Budget());
+	}
+	ExpectTrue(r, L"淘汰了旧记录", doc.History.UndoCount() < 200);
+	ExpectTrue(r, L"保留了最近的记录", doc.History.UndoCount() >= 10);
+	ExpectTrue(r, L"字符池被整理", doc.History.StorageLength() <= 2 * 64 * 1024);
+	doc.History.SetBudget(1);
+	ExpectCount(r, L"预算极小时至少保留一步", (long long)doc.History.UndoCount(), 1);
+	doc.History.Clear();
+	ExpectTrue(r, L"Clear", !doc.History.CanUndo() && doc.History.MemoryUsage() == 0);
+	return r;
+}
+
+double NanosPerEdit(std::chrono::steady_clock::time_point start, int edits)
+{
+	const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	return edits > 0 ? (double)ns / edits : 0.0;
+}
+
+/**
+ * @brief 编辑序列：大部分为连续键入/退格（光标偶尔跳到随机位置），其余为随机位置的粘贴与删除。
+ * Buffer 需提供 size()/insert(pos, wstring)/erase(pos, len)。
+ */
+template <typename Buffer>
+void RunEditScript(Buffer& buffer, int edits, uint32_t seed)
+{
+	Lcg rng(seed);
+	const std::wstring pasted = L"粘贴的一段文本 pasted text\r\n";
+	size_t caret = buffer.size() / 2;
+	for (int i = 0; i < edits; i++)
+	{
+		const uint32_t op = rng.Next() % 100;
+		if (op < 2)
+			caret = rng.Below(buffer.size() + 1);
+		if (op < 80)
+		{
+			const wchar_t ch = (wchar_t)(L'a' + i % 26);
+			buffer.insert(caret, std::wstring(1, ch));
+			caret++;
+		}
+		else if (op < 92)
+		{
+			if (caret > 0)
+			{
+				buffer.erase(caret - 1, 1);
+				caret--;
+			}
+		}
+		else if (op < 96)
+		{
+			const size_t pos = rng.Below(buffer.size() + 1);
+			buffer.insert(pos, pasted);
+			if (pos <= caret) caret += pasted.size();
+		}
+		else
+		{
+			const size_t pos = rng.Below(buffer.size() + 1);
+			const size_t len = (std::min)((size_t)1 + rng.Below(64), buffer.size() - pos);
+			buffer.erase(pos, len);
+			if (caret > pos) caret -= (std::min)(len, caret - pos);
+		}
+	}
+}
+
+struct PieceTableBuffer
+{
+	PieceTable Table;
+	size_t size() const { return Table.Length(); }
+	void insert(size_t pos, const std::wstring& s) { Table.Insert(pos, s); }
+	void erase(size_t pos, size_t len) { Table.Erase(pos, len); }
+};
+
+} // namespace
+
+std::vector<CheckResult> TextBufferBenchmark::RunChecks()
+{
+	return {
+		CheckRandomEdits(),
+		CheckBounds(),
+		CheckSurrogates(),
+		CheckTypingExtends(),
+		CheckUndoMerge(),
+		CheckUndoRoundTrip(),
+		CheckUndoBudget(),
+	};
+}
+
+std::vector<TextBufferBenchmarkResult> TextBufferBenchmark::RunBenchmarks(int edits)
+{
+	if (edits < 1000) edits = 1000;
+	std::vector<TextBufferBenchmarkResult> results;
+
+	const size_t sizes[] = { 64 * 1024, 4 * 1024 * 1024 };
+	for (size_t size : sizes)
+	{
+		const std::wstring initial = InitialText(size);
+		{
+			PieceTableBuffer buffer;
+			buffer.Table.Assign(initial);
+			const auto start = std::chrono::steady_clock::now();
+			RunEditScript(buffer, edits, 1);
+			TextBufferBenchmarkResult b;
+			b.Name = CheckFormat(L"PieceTable，初始 %zu 字符", size);
+			b.Edits = edits;
+			b.NanosPerEdit = NanosPerEdit(start, edits);
+			b.FinalLength = buffer.size();
+			b.Pieces = buffer.Table.PieceCount();
+			results.push_back(b);
+		}
+		{
+			// 连续字符串每次编辑都要搬移插入点之后的全部内容：只跑一部分编辑，按每次耗时比较
+			const int stringEdits = size > 1024 * 1024 ? (std::min)(edits, 20000) : edits;
+			std::wstring buffer = initial;
+			const auto start = std::chrono::steady_clock::now();
+			RunEditScript(buffer, stringEdits, 1);
+			TextBufferBenchmarkResult b;
+			b.Name = CheckFormat(L"std::wstring，初始 %zu 字符", size);
+			b.Edits = stringEdits;
+			b.NanosPerEdit = NanosPerEdit(start, stringEdits);
+			b.FinalLength = buffer.size();
+			results.push_back(b);
+		}
+	}
+
+	{
+		// 逐字键入并记录撤销（每 50 个字符移动一次光标，产生新记录）
+		Document doc;
+		doc.Text.Assign(InitialText(64 * 1024));
+		size_t caret = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < edits; i++)
+		{
+			if (i % 50 == 0)
+				caret = ((size_t)i * 7919) % doc.Text.Length();
+			doc.Type(caret, std::wstring(1, (wchar_t)(L'a' + i % 26)));
+			caret++;
+		}
+		TextBufferBenchmarkResult b;
+		b.Name = CheckFormat(L"PieceTable + UndoEngine 键入（撤销 %zu 步）", doc.History.UndoCount());
+		b.Edits = edits;
+		b.NanosPerEdit = NanosPerEdit(start, edits);
+		b.FinalLength = doc.Text.Length();
+		b.Pieces = doc.Text.PieceCount();
+		results.push_back(b);
+	}
+	return results;
+}
+
+std::wstring TextBufferBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<TextBufferBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"文本缓冲", checks);
+	text += L"编辑序列：80% 键入、12% 退格、4% 随机粘贴、4% 随机删除，2% 的编辑前光标跳到随机位置：\r\n";
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"  %ls：%d 次编辑，%.1f ns/次，结束长度 %zu", b.Name.c_str(), b.Edits, b.NanosPerEdit, b.FinalLength);
+		if (b.Pieces)
+			text += CheckFormat(L"，片段 %zu", b.Pieces);
+		text += L"\r\n";
+	}
+	return text;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+/**
+ * @file TextBufferBenchmark.h
+ * @brief 文本存储与撤销历史的校验与基准（CUICheck 套件 text-buffer）。
+ *
+ * 只使用 PieceTable/UndoEngine，不依赖 Win32：
+ * - RunChecks：随机插入/删除与 std::wstring 逐字一致（含自动整理）、Substr/CharAt 越界裁剪、
+ *   代理对原样保存、连续键入扩展片段；撤销合并（键入/退格/向前删除/新单词断开）、
+ *   撤销/重做往返恢复文本与选区、字节预算淘汰且至少保留一步
+ * - RunBenchmarks：100 万次编辑（连续键入与随机位置插入/删除）下 PieceTable 的每次编辑耗时，
+ *   与 std::wstring 在同样文本规模下的对比；100 万次键入记录进撤销历史的耗时
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct TextBufferBenchmarkResult
+{
+	std::wstring Name;
+	/** @brief 编辑次数。 */
+	int Edits = 0;
+	/** @brief 结束时的文本长度（wchar_t）。 */
+	size_t FinalLength = 0;
+	/** @brief 平均每次编辑的耗时（纳秒）。 */
+	double NanosPerEdit = 0.0;
+	/** @brief 结束时的片段数（非 PieceTable 为 0）。 */
+	size_t Pieces = 0;
+};
+
+class TextBufferBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param edits 每个场景的编辑次数。 */
+	static std::vector<TextBufferBenchmarkResult> RunBenchmarks(int edits = 1000000);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<TextBufferBenchmarkResult>& benchmarks);
+};
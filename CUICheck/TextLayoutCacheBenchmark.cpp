@@ -0,0 +1,199 @@
+#include "TextLayoutCacheBenchmark.h"
+#include "../CppUtils/Graphics/Factory.h"
+#include "../CppUtils/Graphics/Font.h"
+#include "../CppUtils/Graphics/TextLayoutCache.h"
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+using Microsoft::WRL::ComPtr;
+
+namespace {
+
+// 不经缓存的测量（与改动前的 Font::GetTextSize 相同）
+D2D1_SIZE_F MeasureDirect(const std::wstring& text, IDWriteTextFormat* format, float w, float h)
+{
+	ComPtr<IDWriteTextLayout> layout;
+	if (FAILED(_DWriteFactory->CreateTextLayout(text.c_str(), (UINT32)text.size(), format, w, h, &layout)))
+		return D2D1_SIZE_F{ 0, 0 };
+	DWRITE_TEXT_METRICS metrics;
+	if (FAILED(layout->GetMetrics(&metrics)))
+		return D2D1_SIZE_F{ 0, 0 };
+	return D2D1::SizeF((float)ceil(metrics.widthIncludingTrailingWhitespace), (float)ceil(metrics.height));
+}
+
+CheckResult CheckReuse(Font& font)
+{
+	CheckResult r{ L"同键复用", true, L"" };
+	TextLayoutCache cache;
+	auto a = cache.Get(L"确定", font.FontObject, FLT_MAX, FLT_MAX);
+	auto b = cache.Get(L"确定", font.FontObject, FLT_MAX, FLT_MAX);
+	ExpectTrue(r, L"布局创建成功", a != nullptr);
+	ExpectTrue(r, L"同键返回同一布局", a.Get() == b.Get());
+	ExpectCount(r, L"命中", (long long)cache.GetStats().Hits, 1);
+	ExpectCount(r, L"未命中", (long long)cache.GetStats().Misses, 1);
+	return r;
+}
+
+CheckResult CheckKeyParts(Font& font, Font& other)
+{
+	CheckResult r{ L"宽高与字体区分", true, L"" };
+	TextLayoutCache cache;
+	auto wide = cache.Get(L"一段会换行的较长文本 wrapped text", font.FontObject, FLT_MAX, FLT_MAX);
+	auto narrow = cache.Get(L"一段会换行的较长文本 wrapped text", font.FontObject, 60.0f, FLT_MAX);
+	auto otherFont = cache.Get(L"一段会换行的较长文本 wrapped text", other.FontObject, FLT_MAX, FLT_MAX);
+	ExpectTrue(r, L"不同宽度得到不同布局", wide.Get() != narrow.Get());
+	ExpectTrue(r, L"不同字体得到不同布局", wide.Get() != otherFont.Get());
+	ExpectCount(r, L"条目数", (long long)cache.GetStats().Count, 3);
+	D2D1_SIZE_F wideSize{}, narrowSize{};
+	cache.Get(L"一段会换行的较长文本 wrapped text", font.FontObject, FLT_MAX, FLT_MAX, &wideSize);
+	cache.Get(L"一段会换行的较长文本 wrapped text", font.FontObject, 60.0f, FLT_MAX, &narrowSize);
+	ExpectTrue(r, L"窄布局换行后更高", narrowSize.height > wideSize.height);
+	return r;
+}
+
+CheckResult CheckSizes(Font& font)
+{
+	CheckResult r{ L"尺寸与直接排版一致", true, L"" };
+	const wchar_t* samples[] = { L"", L"I", L"文件(F)", L"Tab\tand  spaces  ", L"第一行\r\n第二行", L"Äpfel Öl" };
+	for (auto text : samples)
+	{
+		D2D1_SIZE_F direct = MeasureDirect(text, font.FontObject, FLT_MAX, FLT_MAX);
+		D2D1_SIZE_F cached = font.GetTextSize(text);
+		D2D1_SIZE_F again = font.GetTextSize(text);
+		if (direct.width != cached.width || direct.height != cached.height || cached.width != again.width)
+		{
+			r.Passed = false;
+			r.Detail = CheckFormat(L"\"%ls\"：直接 %.0fx%.0f，缓存 %.0fx%.0f",
+				text, direct.width, direct.height, cached.width, cached.height);
+			break;
+		}
+	}
+	return r;
+}
+
+CheckResult CheckFontChange()
+{
+	CheckResult r{ L"改字号后重新排版", true, L"" };
+	auto& shared = TextLayoutCache::Shared();
+	Font font(L"Arial", 14.0f);
+	D2D1_SIZE_F small = font.GetTextSize(L"Resize me");
+	IDWriteTextFormat* oldFormat = font.FontObject;
+	size_t before = shared.GetStats().Count;
+	font.FontSize = 28.0f;
+	ExpectTrue(r, L"文本格式已重建", font.FontObject != oldFormat);
+	ExpectTrue(r, L"旧格式条目已清除", shared.GetStats().Count < before);
+	D2D1_SIZE_F large = font.GetTextSize(L"Resize me");
+	ExpectTrue(r, L"新字号尺寸更大", large.width > small.width && large.height > small.height);
+	return r;
+}
+
+CheckResult CheckCapacity(Font& font)
+{
+	CheckResult r{ L"内存上限与长文本", true, L"" };
+	TextLayoutCache cache(64 * 1024);
+	for (int i = 0; i < 200; i++)
+		cache.Get(CheckFormat(L"单元格 %d", i), font.FontObject, FLT_MAX, FLT_MAX);
+	auto s = cache.GetStats();
+	ExpectTrue(r, L"占用不超过上限", s.Bytes <= s.CapacityBytes);
+	ExpectTrue(r, L"发生淘汰", s.Evictions > 0);
+	ExpectCount(r, L"条目数 + 淘汰数", (long long)(s.Count + s.Evictions), 200);
+
+	std::wstring longText(TextLayoutCache::MaxCachedLength + 1, L'x');
+	size_t count = cache.GetStats().Count;
+	auto layout = cache.Get(longText, font.FontObject, 400.0f, FLT_MAX);
+	ExpectTrue(r, L"长文本仍能排版", layout != nullptr);
+	ExpectCount(r, L"长文本旁路", (long long)cache.GetStats().Bypassed, 1);
+	ExpectCount(r, L"长文本未进入缓存", (long long)cache.GetStats().Count, (long long)count);
+	return r;
+}
+
+TextLayoutBenchmarkResult RunCase(const wchar_t* name, int frames, Font& font, const std::vector<std::wstring>& texts, float width)
+{
+	TextLayoutBenchmarkResult result;
+	result.Name = name;
+	result.Frames = frames;
+	result.MeasuresPerFrame = (int)texts.size();
+	float sink = 0.0f;
+
+	auto t0 = std::chrono::steady_clock::now();
+	for (int f = 0; f < frames; f++)
+		for (const auto& t : texts)
+			sink += MeasureDirect(t, font.FontObject, width, FLT_MAX).width;
+	auto t1 = std::chrono::steady_clock::now();
+
+	TextLayoutCache cache;
+	size_t firstFrameMisses = 0;
+	auto t2 = std::chrono::steady_clock::now();
+	for (int f = 0; f < frames; f++)
+	{
+		for (const auto& t : texts)
+			sink += cache.Measure(t.c_str(), t.size(), font.FontObject, width, FLT_MAX).width;
+		if (f == 0) firstFrameMisses = cache.GetStats().Misses;
+	}
+	auto t3 = std::chrono::steady_clock::now();
+
+	double measures = (double)frames * texts.size();
+	if (measures > 0)
+	{
+		result.DirectMicrosPerMeasure = std::chrono::duration<double, std::micro>(t1 - t0).count() / measures;
+		result.CachedMicrosPerMeasure = std::chrono::duration<double, std::micro>(t3 - t2).count() / measures;
+	}
+	result.SteadyShapes = cache.GetStats().Misses - firstFrameMisses;
+	(void)sink;
+	return result;
+}
+
+} // namespace
+
+std::vector<CheckResult> TextLayoutCacheBenchmark::RunChecks()
+{
+	Font font(L"Microsoft YaHei", 16.0f);
+	Font other(L"Arial", 16.0f);
+	std::vector<CheckResult> results;
+	results.push_back(CheckReuse(font));
+	results.push_back(CheckKeyParts(font, other));
+	results.push_back(CheckSizes(font));
+	results.push_back(CheckFontChange());
+	results.push_back(CheckCapacity(font));
+	return results;
+}
+
+std::vector<TextLayoutBenchmarkResult> TextLayoutCacheBenchmark::RunBenchmarks(int framesPerCase)
+{
+	if (framesPerCase < 2) framesPerCase = 2;
+	Font font(L"Microsoft YaHei", 16.0f);
+	std::vector<TextLayoutBenchmarkResult> results;
+
+	std::vector<std::wstring> cells;
+	for (int row = 0; row < 40; row++)
+		for (int col = 0; col < 8; col++)
+			cells.push_back(CheckFormat(L"R%d 列%d 值 %d", row, col, row * 37 + col * 11));
+	results.push_back(RunCase(L"表格 40 行 x 8 列", framesPerCase, font, cells, FLT_MAX));
+
+	std::vector<std::wstring> menu = { L"新建(N)", L"打开(O)...", L"保存(S)", L"另存为(A)...", L"最近打开的文件",
+		L"页面设置(U)...", L"打印(P)...", L"退出(X)", L"撤销(U)", L"剪切(T)", L"复制(C)", L"粘贴(P)" };
+	results.push_back(RunCase(L"菜单 12 项", framesPerCase, font, menu, FLT_MAX));
+
+	std::vector<std::wstring> wrapped;
+	for (int i = 0; i < 20; i++)
+		wrapped.push_back(CheckFormat(L"第 %d 条说明：自动换行的标签文本会在固定宽度内排成多行，CUI 的 Label 与提示框都是这种用法。", i));
+	results.push_back(RunCase(L"换行标签 20 个（宽 240）", framesPerCase, font, wrapped, 240.0f));
+	return results;
+}
+
+std::wstring TextLayoutCacheBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<TextLayoutBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"文本布局缓存", checks);
+	text += L"每次测量耗时（直接排版 → 缓存）：\r\n";
+	for (const auto& b : benchmarks)
+	{
+		double speedup = b.CachedMicrosPerMeasure > 0.0 ? b.DirectMicrosPerMeasure / b.CachedMicrosPerMeasure : 0.0;
+		text += CheckFormat(L"  %ls：%d 次/帧；%.2f → %.2f 微秒（%.1fx）；稳定帧排版 %d 次\r\n",
+			b.Name.c_str(), b.MeasuresPerFrame, b.DirectMicrosPerMeasure, b.CachedMicrosPerMeasure, speedup, (int)b.SteadyShapes);
+	}
+	auto s = TextLayoutCache::Shared().GetStats();
+	text += CheckFormat(L"进程共享缓存：%d 项，%d KB / %d KB，命中 %d，未命中 %d，淘汰 %d\r\n",
+		(int)s.Count, (int)(s.Bytes / 1024), (int)(s.CapacityBytes / 1024), (int)s.Hits, (int)s.Misses, (int)s.Evictions);
+	return text;
+}
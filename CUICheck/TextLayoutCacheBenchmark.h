@@ -0,0 +1,33 @@
+#pragma once
+
+/**
+ * @file TextLayoutCacheBenchmark.h
+ * @brief 文本布局缓存（TextLayoutCache）的校验与基准（CUICheck 套件 text-layout，仅 Windows）。
+ *
+ * 直接使用 DirectWrite，不需要窗口或渲染目标：
+ * - RunChecks：同键复用、宽高/字体区分、尺寸与直接排版一致、Font 改字号时清除、内存上限、长文本旁路
+ * - RunBenchmarks：模拟表格/菜单每帧测量相同文本，比较直接排版与缓存的每次耗时
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct TextLayoutBenchmarkResult
+{
+	std::wstring Name;
+	int Frames = 0;
+	int MeasuresPerFrame = 0;
+	double DirectMicrosPerMeasure = 0.0;
+	double CachedMicrosPerMeasure = 0.0;
+	/** @brief 稳定帧（首帧之后）的排版次数。 */
+	size_t SteadyShapes = 0;
+};
+
+class TextLayoutCacheBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param framesPerCase 每个场景模拟的帧数。 */
+	static std::vector<TextLayoutBenchmarkResult> RunBenchmarks(int framesPerCase = 30);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<TextLayoutBenchmarkResult>& benchmarks);
+};
@@ -0,0 +1,314 @@
+#include "TextWidthCacheBenchmark.h"
+#include "../CUI/GUI/Grid/ColumnAutoSize.h"
+#include "../CUI/GUI/Grid/TextWidthCache.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <unordered_set>
+
+namespace {
+
+struct Lcg
+{
+	uint32_t State;
+	explicit Lcg(uint32_t seed) : State(seed) {}
+	uint32_t Next()
+	{
+		State = State * 1664525u + 1013904223u;
+		return State >> 8;
+	}
+};
+
+/** @brief 模拟测量：半角 7 DIP、全角 14 DIP；spin 模拟创建文本布局的开销。 */
+float SimulatedWidth(const wchar_t* text, size_t len, int spin = 0)
+{
+	float w = 0.0f;
+	for (size_t i = 0; i < len; i++)
+		w += text[i] < 0x2E80 ? 7.0f : 14.0f;
+	volatile float sink = 0.0f;
+	for (int i = 0; i < spin; i++)
+		sink = sink + std::sqrt((float)i);
+	return w;
+}
+
+/** @brief 模拟列：少量不同的值重复出现，偶尔夹杂较长的全角文本。 */
+std::vector<std::wstring> MakeColumn(int rows, int distinct, uint32_t seed)
+{
+	Lcg rng(seed);
+	std::vector<std::wstring> values((size_t)distinct);
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		values[i] = L"item-" + std::to_wstring(i);
+		if (i % 97 == 0) values[i] += L"（备注文字较长的一项）";
+	}
+	std::vector<std::wstring> column((size_t)rows);
+	for (auto& text : column)
+		text = values[rng.Next() % values.size()];
+	return column;
+}
+
+CheckResult CheckHash()
+{
+	CheckResult r{ L"哈希", true, L"" };
+	const std::wstring a = L"hello";
+	ExpectTrue(r, L"相同内容相同哈希", TextWidthCache::Hash(a.c_str(), a.size()) == TextWidthCache::Hash(L"hello", 5));
+	ExpectTrue(r, L"前缀不同", TextWidthCache::Hash(a.c_str(), 4) != TextWidthCache::Hash(a.c_str(), 5));
+	const wchar_t zeros[2] = { 0, 0 };
+	ExpectTrue(r, L"长度参与哈希", TextWidthCache::Hash(zeros, 1) != TextWidthCache::Hash(zeros, 2));
+	std::unordered_set<uint64_t> seen;
+	for (int i = 0; i < 200000; i++)
+	{
+		const std::wstring s = L"row " + std::to_wstring(i);
+		seen.insert(TextWidthCache::Hash(s.c_str(), s.size()));
+	}
+	ExpectCount(r, L"20 万个不同字符串无碰撞", (long long)seen.size(), 200000);
+	return r;
+}
+
+CheckResult CheckMeasureOnce()
+{
+	CheckResult r{ L"每个字符串只测量一次", true, L"" };
+	TextWidthCache cache;
+	int calls = 0;
+	auto measure = [&](const wchar_t* text, size_t len) { calls++; return SimulatedWidth(text, len); };
+	const auto column = MakeColumn(5000, 100, 1);
+	for (const auto& text : column)
+	{
+		const float w = cache.Get(text.c_str(), text.size(), measure);
+		ExpectNear(r, L"宽度", w, SimulatedWidth(text.c_str(), text.size()));
+	}
+	ExpectCount(r, L"测量次数", calls, 100);
+	ExpectCount(r, L"未命中", (long long)cache.Misses(), 100);
+	ExpectCount(r, L"命中", (long long)cache.Hits(), 4900);
+	ExpectCount(r, L"条目数", (long long)cache.Count(), 100);
+	cache.Clear();
+	ExpectTrue(r, L"Clear", cache.Count() == 0 && cache.Hits() == 0 && cache.Misses() == 0);
+	return r;
+}
+
+CheckResult CheckGenerations()
+{
+	CheckResult r{ L"整代淘汰", true, L"" };
+	TextWidthCache cache(8);
+	for (uint64_t h = 1; h <= 4; h++) cache.Put(h, (float)h);
+	ExpectCount(r, L"当前代写满", (long long)cache.Count(), 4);
+	cache.Put(5, 5.0f);
+	ExpectCount(r, L"写满后成为旧代", (long long)cache.Count(), 5);
+	float w = 0.0f;
+	ExpectTrue(r, L"旧代命中", cache.TryGet(2, w) && w == 2.0f);
+	for (uint64_t h = 6; h <= 20; h++) cache.Put(h, (float)h);
+	ExpectTrue(r, L"条目数不超过容量", cache.Count() <= 8);
+	ExpectTrue(r, L"最旧的条目被淘汰", !cache.TryGet(1, w));
+	ExpectTrue(r, L"最新的条目保留", cache.TryGet(20, w) && w == 20.0f);
+
+	// 被命中的条目提升回当前代，之后一次换代不会淘汰它
+	TextWidthCache hot(8);
+	for (uint64_t h = 1; h <= 5; h++) hot.Put(h, (float)h);
+	ExpectTrue(r, L"提升", hot.TryGet(1, w));
+	for (uint64_t h = 100; h < 102; h++) hot.Put(h, (float)h);
+	ExpectTrue(r, L"提升后的条目在换代后仍在", hot.TryGet(1, w) && w == 1.0f);
+	return r;
+}
+
+CheckResult CheckThreaded()
+{
+	CheckResult r{ L"多线程并发取宽度", true, L"" };
+	TextWidthCache cache(1024);
+	const auto column = MakeColumn(40000, 3000, 2);
+	std::atomic<int> calls{ 0 };
+	std::atomic<int> wrong{ 0 };
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++)
+	{
+		threads.emplace_back([&, t]()
+			{
+				for (size_t i = (size_t)t; i < column.size(); i += 4)
+				{
+					const auto& s = column[i];
+					const float w = cache.Get(s.c_str(), s.size(), [&](const wchar_t* text, size_t len)
+						{
+							calls.fetch_add(1);
+							return SimulatedWidth(text, len);
+						});
+					if (w != SimulatedWidth(s.c_str(), s.size())) wrong.fetch_add(1);
+				}
+			});
+	}
+	for (auto& th : threads) th.join();
+	ExpectCount(r, L"错误宽度", wrong.load(), 0);
+	ExpectCount(r, L"统计一致", (long long)(cache.Hits() + cache.Misses()), (long long)column.size());
+	ExpectTrue(r, L"条目数不超过容量", cache.Count() <= 1024);
+	ExpectTrue(r, L"至少测量每个不同值一次", calls.load() >= 3000);
+	return r;
+}
+
+CheckResult CheckForFont()
+{
+	CheckResult r{ L"按字体共享缓存", true, L"" };
+	auto a = TextWidthCache::ForFont(L"Segoe UI", 12.0f);
+	auto b = TextWidthCache::ForFont(L"Segoe UI", 12.0f);
+	auto c = TextWidthCache::ForFont(L"Segoe UI", 14.0f);
+	auto d = TextWidthCache::ForFont(L"Consolas", 12.0f);
+	ExpectTrue(r, L"同一字体同一实例", a && a == b);
+	ExpectTrue(r, L"字号不同", a != c);
+	ExpectTrue(r, L"字体名不同", a != d);
+	return r;
+}
+
+CheckResult CheckPickRows()
+{
+	CheckResult r{ L"抽样行", true, L"" };
+	Lcg rng(9);
+	std::vector<uint32_t> lengths(10000);
+	for (auto& len : lengths) len = 5 + rng.Next() % 20;
+	// 少数超长行散布在各处
+	const int longRows[] = { 17, 4242, 9999 };
+	for (int row : longRows) lengths[(size_t)row] = 200;
+
+	GridAutoSizeOptions all;
+	std::vector<int> rows;
+	ColumnAutoSize::PickRows(lengths, all, rows);
+	ExpectCount(r, L"不限制时全部行", (long long)rows.size(), 10000);
+
+	GridAutoSizeOptions sampled;
+	sampled.SampleRows = 200;
+	ColumnAutoSize::PickRows(lengths, sampled, rows);
+	ExpectTrue(r, L"不超过预算", rows.size() <= 200 && !rows.empty());
+	ExpectTrue(r, L"升序无重复", std::adjacent_find(rows.begin(), rows.end(), [](int a, int b) { return a >= b; }) == rows.end());
+	for (int row : longRows)
+		ExpectTrue(r, CheckFormat(L"包含超长行 %d", row).c_str(), std::binary_search(rows.begin(), rows.end(), row));
+
+	// 宽度随字符数单调时抽样最大值等于全量最大值
+	std::vector<float> widths;
+	for (int row : rows) widths.push_back(lengths[(size_t)row] * 7.0f);
+	ExpectNear(r, L"抽样最大宽度", ColumnAutoSize::Reduce(widths, sampled), 200 * 7.0f);
+
+	GridAutoSizeOptions pct;
+	pct.SampleRows = 500;
+	pct.Percentile = 0.9f;
+	ColumnAutoSize::PickRows(lengths, pct, rows);
+	ExpectTrue(r, L"分位数只均匀抽样", rows.size() == 500 && rows.front() == 0);
+	return r;
+}
+
+CheckResult CheckReduce()
+{
+	CheckResult r{ L"汇总宽度", true, L"" };
+	std::vector<float> widths;
+	for (int i = 1; i <= 101; i++) widths.push_back((float)i);
+	GridAutoSizeOptions o;
+	ExpectNear(r, L"最大值", ColumnAutoSize::Reduce(widths, o), 101.0);
+	o.Percentile = 0.5f;
+	ExpectNear(r, L"中位数", ColumnAutoSize::Reduce(widths, o), 51.0);
+	o.Percentile = 0.0f;
+	ExpectNear(r, L"最小值", ColumnAutoSize::Reduce(widths, o), 10.0);
+	o.Percentile = 1.0f;
+	o.MaxWidth = 80.0f;
+	ExpectNear(r, L"最大宽度限制", ColumnAutoSize::Reduce(widths, o), 80.0);
+	std::vector<float> none;
+	ExpectNear(r, L"空列取最小宽度", ColumnAutoSize::Reduce(none, o), 10.0);
+	return r;
+}
+
+double MillisSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+std::vector<CheckResult> TextWidthCacheBenchmark::RunChecks()
+{
+	return {
+		CheckHash(),
+		CheckMeasureOnce(),
+		CheckGenerations(),
+		CheckThreaded(),
+		CheckForFont(),
+		CheckPickRows(),
+		CheckReduce(),
+	};
+}
+
+std::vector<TextWidthCacheBenchmarkResult> TextWidthCacheBenchmark::RunBenchmarks(int rows)
+{
+	if (rows < 1000) rows = 1000;
+	std::vector<TextWidthCacheBenchmarkResult> results;
+	const auto column = MakeColumn(rows, 5000, 3);
+	const int spin = 400;
+	long long measured = 0;
+	auto measure = [&](const wchar_t* text, size_t len)
+		{
+			measured++;
+			return SimulatedWidth(text, len, spin);
+		};
+
+	{
+		measured = 0;
+		const auto start = std::chrono::steady_clock::now();
+		std::vector<float> widths;
+		widths.reserve(column.size());
+		for (const auto& s : column) widths.push_back(measure(s.c_str(), s.size()));
+		TextWidthCacheBenchmarkResult b;
+		b.Name = L"逐行测量";
+		b.Rows = rows;
+		b.Width = ColumnAutoSize::Reduce(widths, GridAutoSizeOptions());
+		b.Milliseconds = MillisSince(start);
+		b.Measured = measured;
+		results.push_back(b);
+	}
+	{
+		measured = 0;
+		TextWidthCache cache;
+		const auto start = std::chrono::steady_clock::now();
+		std::vector<float> widths;
+		widths.reserve(column.size());
+		for (const auto& s : column) widths.push_back(cache.Get(s.c_str(), s.size(), measure));
+		TextWidthCacheBenchmarkResult b;
+		b.Name = L"宽度缓存";
+		b.Rows = rows;
+		b.Width = ColumnAutoSize::Reduce(widths, GridAutoSizeOptions());
+		b.Milliseconds = MillisSince(start);
+		b.Measured = measured;
+		results.push_back(b);
+	}
+	{
+		measured = 0;
+		TextWidthCache cache;
+		GridAutoSizeOptions options;
+		options.SampleRows = 2000;
+		const auto start = std::chrono::steady_clock::now();
+		std::vector<uint32_t> lengths(column.size());
+		for (size_t i = 0; i < column.size(); i++) lengths[i] = (uint32_t)column[i].size();
+		std::vector<int> picked;
+		ColumnAutoSize::PickRows(lengths, options, picked);
+		std::vector<float> widths;
+		for (int row : picked)
+		{
+			const auto& s = column[(size_t)row];
+			widths.push_back(cache.Get(s.c_str(), s.size(), measure));
+		}
+		TextWidthCacheBenchmarkResult b;
+		b.Name = L"宽度缓存 + 抽样 2000 行";
+		b.Rows = rows;
+		b.Width = ColumnAutoSize::Reduce(widths, options);
+		b.Milliseconds = MillisSince(start);
+		b.Measured = measured;
+		results.push_back(b);
+	}
+	return results;
+}
+
+std::wstring TextWidthCacheBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<TextWidthCacheBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"文本宽度缓存", checks);
+	text += L"模拟测量（每次约数百次浮点运算，代替创建文本布局），5000 个不同值：\r\n";
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"  %ls：%d 行，%.2f ms，测量 %lld 次，列宽 %.0f\r\n",
+			b.Name.c_str(), b.Rows, b.Milliseconds, b.Measured, (double)b.Width);
+	}
+	return text;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+/**
+ * @file TextWidthCacheBenchmark.h
+ * @brief 文本宽度缓存与列自适应抽样的校验与基准（CUICheck 套件 text-width）。
+ *
+ * 只使用 TextWidthCache/ColumnAutoSize，不依赖 Win32 与 DirectWrite（测量由模拟函数代替）：
+ * - RunChecks：哈希区分内容与长度、每个字符串只测量一次、命中/未命中统计、整代淘汰与旧代命中提升、
+ *   多线程并发取宽度、按字体共享缓存；抽样包含字符数最多的行、抽样最大值与全量一致、分位数与上下限
+ * - RunBenchmarks：逐行测量、带缓存、带缓存 + 抽样三种方式求一列宽度的耗时与实际测量次数
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct TextWidthCacheBenchmarkResult
+{
+	std::wstring Name;
+	int Rows = 0;
+	double Milliseconds = 0.0;
+	/** @brief 实际调用测量函数的次数。 */
+	long long Measured = 0;
+	float Width = 0.0f;
+};
+
+class TextWidthCacheBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param rows 列的行数。 */
+	static std::vector<TextWidthCacheBenchmarkResult> RunBenchmarks(int rows = 200000);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<TextWidthCacheBenchmarkResult>& benchmarks);
+};
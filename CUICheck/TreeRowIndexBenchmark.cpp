@@ -0,0 +1,567 @@
+#include "TreeRowIndexBenchmark.h"
+#include "../CUI/GUI/Tree/TreeRowIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+
+namespace {
+
+struct Lcg
+{
+	uint32_t State;
+	explicit Lcg(uint32_t seed) : State(seed) {}
+	uint32_t Next()
+	{
+		State = State * 1664525u + 1013904223u;
+		return State >> 8;
+	}
+};
+
+struct TestNode
+{
+	int Id = 0;
+	TestNode* Parent = NULL;
+	std::vector<TestNode*> Children;
+	bool Expand = false;
+	/** @brief 首次展开时加载的子节点数（模拟 HasChildren + ChildrenLoader）。 */
+	int Lazy = 0;
+	/** @brief 正在后台加载。 */
+	bool Loading = false;
+	TreeRowState<TestNode> Rows;
+};
+
+struct TestTree;
+struct TestRows
+{
+	TestTree* Tree;
+	TestNode* Root;
+	/** @brief 展开时在后台加载（显示占位行），否则同步加载。 */
+	bool Background;
+	static TreeRowState<TestNode>& State(TestNode* node) { return node->Rows; }
+	bool Expanded(TestNode* node) const { return node == Root || node->Expand; }
+	bool Loading(TestNode* node) const { return node->Loading && node->Children.empty(); }
+	void Prepare(TestNode* node) const;
+};
+typedef TreeRowIndex<TestNode, TestRows> TestIndex;
+
+/** @brief 测试用树：节点由 Pool 持有，移除的节点保留（Parent 不清除，与 TreeNodeList 相同）。 */
+struct TestTree
+{
+	std::vector<std::unique_ptr<TestNode>> Pool;
+	TestNode* Root;
+
+	bool Background = false;
+	int Loads = 0;
+
+	TestTree() { Root = NewNode(); }
+	TestNode* NewNode()
+	{
+		Pool.push_back(std::make_unique<TestNode>());
+		Pool.back()->Id = (int)Pool.size() - 1;
+		return Pool.back().get();
+	}
+	TestIndex Index() { return TestIndex(TestRows{ this, Root, Background }); }
+	// 以下与 TreeNodeList::Insert/RemoveAt、TreeNode::SetExpand 相同：修改后登记
+	void Insert(TestNode* parent, int index, TestNode* child)
+	{
+		parent->Children.insert(parent->Children.begin() + index, child);
+		child->Parent = parent;
+		child->Rows.ChildIndex = index;
+		child->Rows.Queued = false;
+		TestIndex::MarkDirty(parent);
+	}
+	void RemoveAt(TestNode* parent, int index)
+	{
+		parent->Children.erase(parent->Children.begin() + index);
+		TestIndex::MarkDirty(parent);
+	}
+	void SetExpand(TestNode* node, bool expand)
+	{
+		if (node->Expand == expand) return;
+		node->Expand = expand;
+		TestIndex::MarkDirty(node);
+	}
+};
+
+void TestRows::Prepare(TestNode* node) const
+{
+	if (node->Lazy <= 0 || !node->Children.empty() || node->Loading) return;
+	Tree->Loads++;
+	if (Background)
+	{
+		node->Loading = true;
+		return;
+	}
+	for (int i = 0; i < node->Lazy; i++)
+		Tree->Insert(node, i, Tree->NewNode());
+	node->Lazy = 0;
+}
+
+/** @brief 后台加载完成：挂上子节点并登记（与 TreeView::ApplyLoadedChildren 相同）。 */
+void FinishLoad(TestTree& tree, TestNode* node)
+{
+	for (int i = 0; i < node->Lazy; i++)
+		tree.Insert(node, i, tree.NewNode());
+	node->Lazy = 0;
+	node->Loading = false;
+	TestIndex::MarkDirty(node);
+}
+
+/** @brief 释放收起节点的子节点，再次展开时重新加载（与 TreeView::UnloadChildren 相同）。 */
+void Unload(TestTree& tree, TestNode* node)
+{
+	node->Lazy = (int)node->Children.size();
+	while (!node->Children.empty())
+		tree.RemoveAt(node, (int)node->Children.size() - 1);
+}
+
+/** @brief 建立 fanout^depth 规模的树，前 expandDepth 层展开。 */
+void BuildTree(TestTree& tree, TestNode* node, int depth, int fanout, int expandDepth)
+{
+	if (depth == 0) return;
+	for (int i = 0; i < fanout; i++)
+	{
+		TestNode* c = tree.NewNode();
+		c->Expand = expandDepth > 0;
+		tree.Insert(node, (int)node->Children.size(), c);
+		BuildTree(tree, c, depth - 1, fanout, expandDepth - 1);
+	}
+}
+
+struct WalkRow
+{
+	TestNode* Node;
+	int Level;
+	bool Placeholder = false;
+};
+
+/** @brief 递归遍历展平（旧实现的 AppendSubtree）。 */
+void Walk(TestNode* node, int level, std::vector<WalkRow>& out)
+{
+	if (node->Loading && node->Children.empty())
+	{
+		out.push_back({ node, level, true });
+		return;
+	}
+	for (auto c : node->Children)
+	{
+		out.push_back({ c, level });
+		if (c->Expand) Walk(c, level + 1, out);
+	}
+}
+
+/** @brief 同步索引后逐行、逐节点与递归遍历比较。 */
+void ExpectSameAsWalk(CheckResult& r, const wchar_t* what, TestTree& tree)
+{
+	if (!r.Passed) return;
+	auto index = tree.Index();
+	index.Sync(tree.Root);
+	std::vector<WalkRow> expected;
+	Walk(tree.Root, 0, expected);
+	ExpectCount(r, CheckFormat(L"%ls：行数", what).c_str(), index.RowCount(tree.Root), (long long)expected.size());
+	std::unordered_map<TestNode*, int> rowOf;
+	for (size_t i = 0; i < expected.size() && r.Passed; i++)
+	{
+		int level = 0;
+		bool placeholder = false;
+		TestNode* node = index.NodeAtRow(tree.Root, (int)i, level, placeholder);
+		ExpectTrue(r, CheckFormat(L"%ls：第 %zu 行", what, i).c_str(),
+			node == expected[i].Node && level == expected[i].Level && placeholder == expected[i].Placeholder);
+		if (!expected[i].Placeholder) rowOf[expected[i].Node] = (int)i;
+	}
+	for (const auto& node : tree.Pool)
+	{
+		if (!r.Passed) break;
+		auto it = rowOf.find(node.get());
+		ExpectCount(r, CheckFormat(L"%ls：节点 %d 的行", what, node->Id).c_str(),
+			index.RowOfNode(tree.Root, node.get()), it == rowOf.end() ? -1 : it->second);
+	}
+}
+
+/** @brief 随机选一个仍在树中的节点（含根节点）。 */
+TestNode* PickAttached(TestTree& tree, Lcg& rng)
+{
+	for (;;)
+	{
+		TestNode* node = tree.Pool[rng.Next() % tree.Pool.size()].get();
+		TestNode* p = node;
+		while (p != tree.Root && p->Parent)
+		{
+			const auto& siblings = p->Parent->Children;
+			if (std::find(siblings.begin(), siblings.end(), p) == siblings.end()) break;
+			p = p->Parent;
+		}
+		if (p == tree.Root) return node;
+	}
+}
+
+CheckResult CheckChildRows()
+{
+	CheckResult r{ L"子节点行数树状数组", true, L"" };
+	Lcg rng(1);
+	for (int n : { 0, 1, 2, 7, 64, 1000 })
+	{
+		std::vector<int> spans((size_t)n);
+		for (auto& s : spans) s = 1 + rng.Next() % 50;
+		TreeChildRows rows;
+		rows.Assign(spans);
+		for (int op = 0; op < 200 && n > 0; op++)
+		{
+			const int i = (int)(rng.Next() % (uint32_t)n);
+			spans[(size_t)i] = 1 + rng.Next() % 50;
+			rows.Set(i, spans[(size_t)i]);
+		}
+		ExpectCount(r, L"子节点数", rows.Count(), n);
+		int sum = 0;
+		for (int i = 0; i <= n && r.Passed; i++)
+		{
+			ExpectCount(r, CheckFormat(L"%d 项的前缀 %d", n, i).c_str(), rows.Prefix(i), sum);
+			if (i < n)
+			{
+				ExpectCount(r, L"单项", rows.Span(i), spans[(size_t)i]);
+				int offset = -1;
+				ExpectCount(r, L"首行所在", rows.Find(sum, offset), i);
+				ExpectCount(r, L"首行偏移", offset, 0);
+				ExpectCount(r, L"末行所在", rows.Find(sum + spans[(size_t)i] - 1, offset), i);
+				ExpectCount(r, L"末行偏移", offset, spans[(size_t)i] - 1);
+				sum += spans[(size_t)i];
+			}
+		}
+		ExpectCount(r, L"总行数", rows.Total(), sum);
+		int offset = 0;
+		ExpectCount(r, L"越界", rows.Find(sum, offset), -1);
+		ExpectCount(r, L"负行", rows.Find(-1, offset), -1);
+	}
+	return r;
+}
+
+CheckResult CheckRandomEdits()
+{
+	CheckResult r{ L"随机修改后与递归遍历一致", true, L"" };
+	Lcg rng(7);
+	TestTree tree;
+	BuildTree(tree, tree.Root, 3, 6, 2);
+	ExpectSameAsWalk(r, L"初始", tree);
+	for (int op = 0; op < 3000 && r.Passed; op++)
+	{
+		TestNode* node = PickAttached(tree, rng);
+		switch (rng.Next() % 4)
+		{
+		case 0:
+		case 1:
+			if (node != tree.Root) tree.SetExpand(node, !node->Expand);
+			break;
+		case 2:
+		{
+			TestNode* c = tree.NewNode();
+			c->Expand = rng.Next() % 2 == 0;
+			tree.Insert(node, (int)(rng.Next() % (node->Children.size() + 1)), c);
+			break;
+		}
+		default:
+			if (!node->Children.empty())
+				tree.RemoveAt(node, (int)(rng.Next() % node->Children.size()));
+			break;
+		}
+		// 每步都同步或攒几步一起同步，两条路径都要覆盖
+		if (op % 3 != 0)
+			ExpectSameAsWalk(r, CheckFormat(L"第 %d 步", op).c_str(), tree);
+	}
+	ExpectSameAsWalk(r, L"结束", tree);
+	return r;
+}
+
+CheckResult CheckOffscreenEdits()
+{
+	CheckResult r{ L"屏幕外深层子树的修改", true, L"" };
+	TestTree tree;
+	BuildTree(tree, tree.Root, 4, 5, 4);
+	auto index = tree.Index();
+	index.Sync(tree.Root);
+	const int before = index.RowCount(tree.Root);
+	// 首屏显示最后几行时，修改最前面子树中最深的节点
+	TestNode* deep = tree.Root->Children[0]->Children[1]->Children[2];
+	TestNode* leaf = deep->Children[3];
+	TestNode* extra = tree.NewNode();
+	tree.Insert(leaf, 0, extra);
+	tree.SetExpand(tree.Root->Children[0]->Children[1]->Children[0], false);
+	index.Sync(tree.Root);
+	ExpectCount(r, L"行数", index.RowCount(tree.Root), before + 1 - 5);
+	int level = 0;
+	bool placeholder = false;
+	ExpectTrue(r, L"末行", index.NodeAtRow(tree.Root, index.RowCount(tree.Root) - 1, level, placeholder) == tree.Root->Children[4]->Children[4]->Children[4]->Children[4]);
+	ExpectSameAsWalk(r, L"修改后", tree);
+	return r;
+}
+
+CheckResult CheckPerTree()
+{
+	CheckResult r{ L"修改只登记在所属的树上", true, L"" };
+	TestTree a, b;
+	BuildTree(a, a.Root, 3, 4, 3);
+	BuildTree(b, b.Root, 3, 4, 3);
+	auto ia = a.Index();
+	auto ib = b.Index();
+	ia.Sync(a.Root);
+	ib.Sync(b.Root);
+	a.SetExpand(a.Root->Children[2]->Children[1], false);
+	a.RemoveAt(a.Root->Children[3], 0);
+	ExpectTrue(r, L"树 A 有待处理的修改", !a.Root->Rows.Pending.empty());
+	ExpectTrue(r, L"树 B 无待处理的修改", !b.Root->Rows.Dirty && b.Root->Rows.Pending.empty());
+	ExpectTrue(r, L"树 B 的节点未被标记", !b.Root->Children[2]->Rows.Dirty && !b.Root->Children[2]->Rows.Queued);
+	// 只沿登记的路径更新：未修改的子树的状态保持不变
+	ExpectTrue(r, L"未修改的子树未登记", !a.Root->Children[0]->Rows.Queued && a.Root->Children[0]->Rows.Pending.empty());
+	ExpectSameAsWalk(r, L"树 A", a);
+	ExpectSameAsWalk(r, L"树 B", b);
+	return r;
+}
+
+CheckResult CheckUnnotified()
+{
+	CheckResult r{ L"未经通知的修改", true, L"" };
+	TestTree tree;
+	BuildTree(tree, tree.Root, 3, 4, 3);
+	auto index = tree.Index();
+	index.Sync(tree.Root);
+	// 直接修改 Children（如通过 List 基类接口），不登记
+	TestNode* node = tree.Root->Children[1];
+	TestNode* c = tree.NewNode();
+	node->Children.push_back(c);
+	ExpectTrue(r, L"Changed 发现子节点数变化", index.Changed(node));
+	ExpectTrue(r, L"未修改的节点", !index.Changed(tree.Root->Children[0]));
+	TestIndex::MarkDirty(node);
+	ExpectSameAsWalk(r, L"登记后", tree);
+	ExpectTrue(r, L"修补后一致", !index.Changed(node));
+
+	// 根节点的子节点数每次同步都会核对
+	tree.Root->Children.push_back(tree.NewNode());
+	ExpectSameAsWalk(r, L"根节点直接追加", tree);
+
+	// 大范围直接修改后 Reset
+	Lcg rng(3);
+	for (int i = 0; i < 50; i++)
+	{
+		TestNode* n = PickAttached(tree, rng);
+		if (n != tree.Root) n->Expand = !n->Expand;
+		n->Children.push_back(tree.NewNode());
+		n->Children.back()->Parent = n;
+	}
+	index.Reset(tree.Root);
+	ExpectSameAsWalk(r, L"Reset 后", tree);
+	return r;
+}
+
+CheckResult CheckLazyLoad()
+{
+	CheckResult r{ L"懒加载、占位行与释放", true, L"" };
+	for (int background = 0; background < 2 && r.Passed; background++)
+	{
+		Lcg rng(11 + (uint32_t)background);
+		TestTree tree;
+		tree.Background = background != 0;
+		BuildTree(tree, tree.Root, 2, 5, 1);
+		for (auto& node : tree.Pool)
+			if (node.get() != tree.Root && node->Children.empty()) node->Lazy = 3;
+		ExpectSameAsWalk(r, L"初始", tree);
+		std::vector<TestNode*> loading;
+		for (int op = 0; op < 2000 && r.Passed; op++)
+		{
+			TestNode* node = PickAttached(tree, rng);
+			switch (rng.Next() % 5)
+			{
+			case 0:
+			case 1:
+				if (node != tree.Root) tree.SetExpand(node, !node->Expand);
+				break;
+			case 2:
+				if (!loading.empty())
+				{
+					const size_t k = rng.Next() % loading.size();
+					FinishLoad(tree, loading[k]);
+					loading.erase(loading.begin() + k);
+				}
+				break;
+			case 3:
+				if (node != tree.Root && !node->Expand && !node->Loading && !node->Children.empty())
+					Unload(tree, node);
+				break;
+			default:
+			{
+				TestNode* c = tree.NewNode();
+				c->Lazy = 1 + rng.Next() % 4;
+				tree.Insert(node, (int)(rng.Next() % (node->Children.size() + 1)), c);
+				break;
+			}
+			}
+			ExpectSameAsWalk(r, CheckFormat(L"%ls第 %d 步", background ? L"后台加载：" : L"", op).c_str(), tree);
+			for (auto& n : tree.Pool)
+			{
+				if (n->Loading && std::find(loading.begin(), loading.end(), n.get()) == loading.end())
+					loading.push_back(n.get());
+			}
+		}
+		ExpectTrue(r, L"发生过加载", tree.Loads > 10);
+	}
+	return r;
+}
+
+CheckResult CheckDetached()
+{
+	CheckResult r{ L"释放与丢弃的节点不影响任何树", true, L"" };
+	TestTree a, b;
+	BuildTree(a, a.Root, 3, 4, 3);
+	BuildTree(b, b.Root, 3, 4, 3);
+	auto ia = a.Index();
+	auto ib = b.Index();
+	ia.Sync(a.Root);
+	ib.Sync(b.Root);
+
+	// 后台加载的结果在挂到树上之前（或被丢弃时）只标记自身
+	TestNode* detached = a.NewNode();
+	for (int i = 0; i < 5; i++) a.Insert(detached, i, a.NewNode());
+	a.SetExpand(detached->Children[2], true);
+	ExpectTrue(r, L"树 A 无待处理的修改", !a.Root->Rows.Dirty && a.Root->Rows.Pending.empty());
+	ExpectTrue(r, L"树 B 无待处理的修改", !b.Root->Rows.Dirty && b.Root->Rows.Pending.empty());
+
+	// 释放收起节点的子节点只登记该节点及其祖先
+	TestNode* node = a.Root->Children[1]->Children[2];
+	a.SetExpand(node, false);
+	ia.Sync(a.Root);
+	Unload(a, node);
+	ExpectTrue(r, L"登记的是该节点的父链", a.Root->Children[1]->Rows.Queued && node->Rows.Dirty);
+	ExpectTrue(r, L"兄弟子树未登记", !a.Root->Children[0]->Rows.Queued && !a.Root->Children[1]->Children[1]->Rows.Queued);
+	ExpectTrue(r, L"树 B 无待处理的修改", !b.Root->Rows.Dirty && b.Root->Rows.Pending.empty());
+	ExpectSameAsWalk(r, L"树 A", a);
+	ExpectSameAsWalk(r, L"树 B", b);
+	return r;
+}
+
+double MillisSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+std::vector<CheckResult> TreeRowIndexBenchmark::RunChecks()
+{
+	return {
+		CheckChildRows(),
+		CheckRandomEdits(),
+		CheckOffscreenEdits(),
+		CheckPerTree(),
+		CheckUnnotified(),
+		CheckLazyLoad(),
+		CheckDetached(),
+	};
+}
+
+std::vector<TreeRowIndexBenchmarkResult> TreeRowIndexBenchmark::RunBenchmarks(int nodes)
+{
+	std::vector<TreeRowIndexBenchmarkResult> results;
+	int fanout = 10;
+	while ((long long)fanout * fanout * fanout < nodes) fanout++;
+
+	TestTree tree;
+	BuildTree(tree, tree.Root, 3, fanout, 2);
+	const int nodeCount = (int)tree.Pool.size();
+	std::vector<TestNode*> middle;
+	for (auto top : tree.Root->Children)
+		for (auto m : top->Children)
+			middle.push_back(m);
+	for (auto m : middle) m->Expand = true;
+	const int screenRows = 40;
+
+	{
+		auto index = tree.Index();
+		index.Sync(tree.Root);
+		Lcg rng(5);
+		const int toggles = 20000;
+		int level = 0;
+		bool placeholder = false;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < toggles; i++)
+		{
+			TestNode* m = middle[rng.Next() % middle.size()];
+			tree.SetExpand(m, !m->Expand);
+			index.Sync(tree.Root);
+			const int first = index.RowCount(tree.Root) / 2;
+			for (int row = first; row < first + screenRows; row++)
+				index.NodeAtRow(tree.Root, row, level, placeholder);
+		}
+		TreeRowIndexBenchmarkResult b;
+		b.Name = L"行索引（按登记路径更新）";
+		b.Nodes = nodeCount;
+		b.Rows = index.RowCount(tree.Root);
+		b.MicrosPerToggle = MillisSince(start) * 1000.0 / toggles;
+		results.push_back(b);
+	}
+	{
+		// 旧实现的修补路径：展平数组中插入/删除后代行，再从该行起重新编号
+		std::vector<WalkRow> flat;
+		Walk(tree.Root, 0, flat);
+		std::vector<int> rowOf(tree.Pool.size(), -1);
+		for (size_t i = 0; i < flat.size(); i++) rowOf[(size_t)flat[i].Node->Id] = (int)i;
+		Lcg rng(5);
+		const int toggles = 200;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < toggles; i++)
+		{
+			TestNode* m = middle[rng.Next() % middle.size()];
+			m->Expand = !m->Expand;
+			const int row = rowOf[(size_t)m->Id];
+			if (m->Expand)
+			{
+				std::vector<WalkRow> rows;
+				Walk(m, flat[(size_t)row].Level + 1, rows);
+				flat.insert(flat.begin() + row + 1, rows.begin(), rows.end());
+			}
+			else
+			{
+				flat.erase(flat.begin() + row + 1, flat.begin() + row + 1 + (int)m->Children.size());
+			}
+			for (size_t k = (size_t)row + 1; k < flat.size(); k++)
+				rowOf[(size_t)flat[k].Node->Id] = (int)k;
+		}
+		TreeRowIndexBenchmarkResult b;
+		b.Name = L"展平数组就地修补并重新编号";
+		b.Nodes = nodeCount;
+		b.Rows = (int)flat.size();
+		b.MicrosPerToggle = MillisSince(start) * 1000.0 / toggles;
+		results.push_back(b);
+	}
+	{
+		// 旧实现在任意节点析构后的路径：整体重新展平
+		Lcg rng(5);
+		const int toggles = 20;
+		std::vector<WalkRow> flat;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < toggles; i++)
+		{
+			TestNode* m = middle[rng.Next() % middle.size()];
+			m->Expand = !m->Expand;
+			flat.clear();
+			Walk(tree.Root, 0, flat);
+		}
+		TreeRowIndexBenchmarkResult b;
+		b.Name = L"整体重新展平";
+		b.Nodes = nodeCount;
+		b.Rows = (int)flat.size();
+		b.MicrosPerToggle = MillisSince(start) * 1000.0 / toggles;
+		results.push_back(b);
+	}
+	return results;
+}
+
+std::wstring TreeRowIndexBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<TreeRowIndexBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"树形行索引", checks);
+	text += L"随机展开/收起第二层节点，每次取得中部一屏（40 行）：\r\n";
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"  %ls：%d 个节点，%d 行，每次 %.2f us\r\n",
+			b.Name.c_str(), b.Nodes, b.Rows, b.MicrosPerToggle);
+	}
+	return text;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+/**
+ * @file TreeRowIndexBenchmark.h
+ * @brief 树形控件可见行索引的校验与基准（CUICheck 套件 tree-rows）。
+ *
+ * 只使用 TreeRowIndex（以测试用节点代替 TreeNode），不依赖 Win32 与 TreeView：
+ * - RunChecks：子节点行数树状数组与逐项求和一致、随机展开/收起/增删节点（含屏幕外的深层子树）后
+ *   每一行与递归遍历展平的结果一致且节点行号互逆、修改只登记在所属的树上、未经通知的修改可被发现、
+ *   Reset 后与递归遍历一致；同步/后台懒加载（占位行）、加载完成与释放子节点后与递归遍历一致，
+ *   未挂到树上的加载结果与释放子节点只登记各自的节点与父链
+ * - RunBenchmarks：大树中随机展开/收起后，按登记的路径更新索引与整体重新展平的每次耗时
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct TreeRowIndexBenchmarkResult
+{
+	std::wstring Name;
+	/** @brief 树中节点总数。 */
+	int Nodes = 0;
+	/** @brief 操作后的可见行数（最后一次）。 */
+	int Rows = 0;
+	/** @brief 平均每次展开/收起并取得首屏行的耗时（微秒）。 */
+	double MicrosPerToggle = 0.0;
+};
+
+class TreeRowIndexBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param nodes 树中节点数（约数）。 */
+	static std::vector<TreeRowIndexBenchmarkResult> RunBenchmarks(int nodes = 1000000);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<TreeRowIndexBenchmarkResult>& benchmarks);
+};
@@ -0,0 +1,427 @@
+#include "VideoFrameQueueBenchmark.h"
+#include "../CUI/GUI/VideoFrameQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+const double Refresh = 1.0 / 60.0;
+const double Never = 1e300;
+
+// 提交一帧 4x1 的池内帧
+bool Push(VideoFrameQueue& q, double pts)
+{
+	VideoFrame* f = q.BeginWrite();
+	if (!f) return false;
+	std::memset(f->Allocate(4, 1, 16), 0, 16);
+	q.CommitWrite(f, pts);
+	return true;
+}
+
+// 外部缓冲的所有者：记录释放次数
+struct CountingOwner
+{
+	int Releases = 0;
+	static void Release(void* owner) { ((CountingOwner*)owner)->Releases++; }
+};
+
+CheckResult CheckDueSelection()
+{
+	CheckResult r{ L"按时选帧与迟到丢弃", true, L"" };
+	VideoFrameQueue q;
+	Push(q, 0.00);
+	Push(q, 0.04);
+	Push(q, 0.08);
+	ExpectTrue(r, L"t=-0.01 时无到期帧", q.AcquireDue(-0.01) == nullptr);
+	const VideoFrame* f = q.AcquireDue(0.05);
+	ExpectTrue(r, L"t=0.05 取到帧", f != nullptr);
+	if (!f) return r;
+	ExpectNear(r, L"取到的 Pts", f->Pts, 0.04);
+	ExpectCount(r, L"取到的序号", (long long)f->Sequence, 2);
+	q.Release(f);
+	ExpectCount(r, L"迟到丢弃", (long long)q.GetStats().Dropped, 1);
+	ExpectTrue(r, L"0.08 的帧仍在队列", q.HasPending());
+	ExpectTrue(r, L"t=0.05 再取为空", q.AcquireDue(0.05) == nullptr);
+	f = q.AcquireDue(0.09);
+	ExpectTrue(r, L"t=0.09 取到最后一帧", f && f->Sequence == 3);
+	q.Release(f);
+	ExpectTrue(r, L"队列已空", !q.HasPending());
+	ExpectCount(r, L"呈现帧数", (long long)q.GetStats().Presented, 2);
+	return r;
+}
+
+CheckResult CheckTolerance()
+{
+	CheckResult r{ L"容差（提前半个刷新周期取帧）", true, L"" };
+	VideoFrameQueue q;
+	Push(q, 0.100);
+	ExpectTrue(r, L"无容差时未到期", q.AcquireDue(0.095) == nullptr);
+	const VideoFrame* f = q.AcquireDue(0.095, Refresh * 0.5);
+	ExpectTrue(r, L"容差内取到", f != nullptr);
+	q.Release(f);
+	ExpectNear(r, L"平均偏差（毫秒）", q.GetStats().AverageLateness, -5.0, 1e-6);
+	return r;
+}
+
+CheckResult CheckOverrun()
+{
+	CheckResult r{ L"池满时丢弃新帧", true, L"" };
+	VideoFrameQueue q(4);
+	int pushed = 0;
+	for (int i = 0; i < 6; i++)
+		if (Push(q, i * 0.01)) pushed++;
+	ExpectCount(r, L"提交数", pushed, 4);
+	ExpectCount(r, L"Overruns", (long long)q.GetStats().Overruns, 2);
+	const VideoFrame* f = q.AcquireDue(Never);
+	ExpectTrue(r, L"取到最新一帧", f && f->Sequence == 4);
+	// 渲染端仍持有一帧时，池里只剩 3 个空闲帧
+	int again = 0;
+	for (int i = 0; i < 4; i++)
+		if (Push(q, 1.0 + i * 0.01)) again++;
+	ExpectCount(r, L"持有一帧时可再提交", again, 3);
+	q.Release(f);
+	ExpectTrue(r, L"归还后可再提交", Push(q, 2.0));
+	return r;
+}
+
+CheckResult CheckCancel()
+{
+	CheckResult r{ L"放弃后重用同一帧", true, L"" };
+	VideoFrameQueue q(2);
+	CountingOwner owner;
+	uint8_t pixels[16] = {};
+	VideoFrame* a = q.BeginWrite();
+	a->Attach(pixels, 4, 1, 16, &owner, &CountingOwner::Release);
+	q.CancelWrite(a);
+	ExpectCount(r, L"放弃时释放外部缓冲", owner.Releases, 1);
+	VideoFrame* b = q.BeginWrite();
+	ExpectTrue(r, L"重用同一帧", a == b);
+	q.CommitWrite(b, 0.0);
+	VideoFrame* c = q.BeginWrite();
+	ExpectTrue(r, L"另一帧可用", c != nullptr && c != b);
+	q.CommitWrite(c, 0.0);
+	ExpectTrue(r, L"池已空", q.BeginWrite() == nullptr);
+	return r;
+}
+
+CheckResult CheckFlush()
+{
+	CheckResult r{ L"Flush 作废旧帧", true, L"" };
+	VideoFrameQueue q;
+	Push(q, 5.0);
+	Push(q, 5.1);
+	// Flush 前取出、Flush 后才提交的帧同样是旧帧
+	VideoFrame* inFlight = q.BeginWrite();
+	inFlight->Allocate(4, 1, 16);
+	q.Flush();
+	q.CommitWrite(inFlight, 5.2);
+	Push(q, 0.0);
+	const VideoFrame* f = q.AcquireDue(0.0);
+	ExpectTrue(r, L"取到新帧", f && f->Pts == 0.0);
+	q.Release(f);
+	ExpectCount(r, L"Flushed", (long long)q.GetStats().Flushed, 3);
+	ExpectCount(r, L"Dropped", (long long)q.GetStats().Dropped, 0);
+	return r;
+}
+
+CheckResult CheckExternalRelease()
+{
+	CheckResult r{ L"外部缓冲恰好释放一次", true, L"" };
+	CountingOwner owner;
+	uint8_t pixels[64] = {};
+	{
+		VideoFrameQueue q;
+		for (int i = 0; i < 3; i++)
+		{
+			VideoFrame* f = q.BeginWrite();
+			f->Attach(pixels, 4, 2, 32, &owner, &CountingOwner::Release);
+			q.CommitWrite(f, i * 0.01);
+		}
+		ExpectCount(r, L"ZeroCopy", (long long)q.GetStats().ZeroCopy, 3);
+		const VideoFrame* f = q.AcquireDue(0.015);
+		ExpectTrue(r, L"Data 指向外部缓冲", f && f->Data == pixels && f->Stride == 32);
+		ExpectCount(r, L"迟到帧回收时释放", owner.Releases, 1);
+		q.Release(f);
+		ExpectCount(r, L"呈现后释放", owner.Releases, 2);
+		// 剩余一帧在队列中：Reset 释放
+		q.Reset();
+		ExpectCount(r, L"Reset 释放", owner.Releases, 3);
+		VideoFrame* last = q.BeginWrite();
+		last->Attach(pixels, 4, 2, 32, &owner, &CountingOwner::Release);
+		q.CommitWrite(last, 1.0);
+		// 池内缓冲覆盖挂接时也要释放
+		VideoFrame* reuse = q.BeginWrite();
+		reuse->Attach(pixels, 4, 2, 32, &owner, &CountingOwner::Release);
+		reuse->Allocate(4, 2, 16);
+		ExpectCount(r, L"Allocate 覆盖挂接时释放", owner.Releases, 4);
+		q.CancelWrite(reuse);
+	}
+	ExpectCount(r, L"析构时释放", owner.Releases, 5);
+	return r;
+}
+
+CheckResult CheckSteadyStateAllocations()
+{
+	CheckResult r{ L"稳态零分配", true, L"" };
+	VideoFrameQueue q;
+	const uint32_t w = 1920, h = 1080;
+	double t = 0.0;
+	for (int i = 0; i < 600; i++)
+	{
+		VideoFrame* f = q.BeginWrite();
+		if (f)
+		{
+			f->Allocate(w, h, w * 4)[0] = (uint8_t)i;
+			q.CommitWrite(f, t);
+		}
+		t += 1.0 / 60.0;
+		q.Release(q.AcquireDue(t));
+	}
+	auto s = q.GetStats();
+	ExpectTrue(r, CheckFormat(L"分配 %d 次 ≤ 池容量 %d", (int)s.Allocations, (int)q.Capacity()).c_str(),
+		s.Allocations <= q.Capacity());
+	// 分辨率变小不重新分配
+	VideoFrame* f = q.BeginWrite();
+	f->Allocate(1280, 720, 1280 * 4);
+	q.CommitWrite(f, t);
+	ExpectCount(r, L"缩小后的分配次数", (long long)q.GetStats().Allocations, (long long)s.Allocations);
+	return r;
+}
+
+CheckResult CheckThreaded()
+{
+	CheckResult r{ L"双线程压力（顺序、内容）", true, L"" };
+	VideoFrameQueue q;
+	const int total = 200000;
+	std::atomic<bool> done{ false };
+	std::thread producer([&]()
+	{
+		uint64_t next = 1;
+		for (int i = 0; i < total; i++)
+		{
+			VideoFrame* f = q.BeginWrite();
+			if (!f)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			// 首尾写入即将得到的序号，消费端据此检查是否读到写了一半的帧
+			uint8_t* p = f->Allocate(8, 2, 64);
+			std::memcpy(p, &next, sizeof(next));
+			std::memcpy(p + 120, &next, sizeof(next));
+			q.CommitWrite(f, (double)i);
+			next++;
+		}
+		done.store(true, std::memory_order_release);
+	});
+
+	uint64_t last = 0;
+	long long seen = 0;
+	for (;;)
+	{
+		const bool finished = done.load(std::memory_order_acquire);
+		const VideoFrame* f = q.AcquireDue(Never);
+		if (f)
+		{
+			uint64_t head = 0, tail = 0;
+			std::memcpy(&head, f->Data, sizeof(head));
+			std::memcpy(&tail, f->Data + 120, sizeof(tail));
+			if (r.Passed && (f->Sequence <= last || head != f->Sequence || tail != f->Sequence))
+			{
+				r.Passed = false;
+				r.Detail = CheckFormat(L"序号 %lld 之后读到 %lld（内容 %lld/%lld）",
+					(long long)last, (long long)f->Sequence, (long long)head, (long long)tail);
+			}
+			last = f->Sequence;
+			seen++;
+			q.Release(f);
+		}
+		else if (finished && !q.HasPending())
+		{
+			break;
+		}
+	}
+	producer.join();
+	auto s = q.GetStats();
+	ExpectCount(r, L"提交 + 池满丢弃", (long long)(s.Committed + s.Overruns), total);
+	ExpectCount(r, L"呈现 + 迟到丢弃", (long long)(s.Presented + s.Dropped), (long long)s.Committed);
+	ExpectCount(r, L"消费端取到", seen, (long long)s.Presented);
+	return r;
+}
+
+CheckResult CheckJitter()
+{
+	CheckResult r{ L"抖动统计", true, L"" };
+	// 60fps 内容、60Hz 取帧：无抖动
+	VideoFrameQueue q;
+	for (int i = 0; i < 10; i++)
+	{
+		Push(q, i * Refresh);
+		q.Release(q.AcquireDue(i * Refresh + 0.002));
+	}
+	ExpectNear(r, L"60/60 平均抖动", q.GetStats().AverageJitter, 0.0, 1e-6);
+	ExpectNear(r, L"60/60 平均偏差", q.GetStats().AverageLateness, 2.0, 1e-6);
+	// 渲染端晚了一个周期：间隔 33.3ms 对应时间戳间隔 16.7ms
+	Push(q, 10 * Refresh);
+	Push(q, 11 * Refresh);
+	q.Release(q.AcquireDue(11 * Refresh + 0.002));
+	ExpectNear(r, L"最大抖动", q.GetStats().MaxJitter, 0.0, 1e-6);
+	ExpectCount(r, L"迟到丢弃", (long long)q.GetStats().Dropped, 1);
+	q.ResetStats();
+	Push(q, 12 * Refresh);
+	q.Release(q.AcquireDue(14 * Refresh + 0.002));
+	Push(q, 13 * Refresh);
+	q.Release(q.AcquireDue(15 * Refresh + 0.002));
+	ExpectNear(r, L"ResetStats 后的抖动", q.GetStats().AverageJitter, 0.0, 1e-6);
+	Push(q, 14 * Refresh);
+	q.Release(q.AcquireDue(17 * Refresh + 0.002));
+	ExpectNear(r, L"晚一个周期的抖动", q.GetStats().MaxJitter, Refresh * 1000.0, 1e-6);
+	return r;
+}
+
+// 模拟播放：解码端提前 lead 秒提交，渲染端每个刷新周期取一次；stallEvery > 0 时每隔若干周期卡顿一次
+VideoFrameQueueBenchmarkResult Simulate(const wchar_t* name, double fps, double seconds, double lead, int stallEvery)
+{
+	VideoFrameQueueBenchmarkResult result;
+	result.Name = name;
+	result.Simulated = true;
+	VideoFrameQueue q;
+	const int frames = (int)(fps * seconds);
+	int next = 0;
+	for (int v = 0; v * Refresh <= seconds + lead; v++)
+	{
+		const double vsync = v * Refresh;
+		// 截至本周期开始，解码端已经提交的帧
+		while (next < frames && next / fps - lead <= vsync)
+		{
+			VideoFrame* f = q.BeginWrite();
+			if (f)
+			{
+				f->Allocate(64, 36, 256);
+				q.CommitWrite(f, next / fps);
+			}
+			next++;
+		}
+		if (stallEvery > 0 && v % stallEvery == stallEvery - 1) continue;
+		q.Release(q.AcquireDue(vsync, Refresh * 0.5));
+	}
+	auto s = q.GetStats();
+	result.Frames = frames;
+	result.Allocations = (int)s.Allocations;
+	result.Presented = (int)s.Presented;
+	result.Dropped = (int)(s.Dropped + s.Overruns);
+	result.AverageJitter = s.AverageJitter;
+	result.MaxJitter = s.MaxJitter;
+	return result;
+}
+
+} // namespace
+
+std::vector<CheckResult> VideoFrameQueueBenchmark::RunChecks()
+{
+	std::vector<CheckResult> results;
+	results.push_back(CheckDueSelection());
+	results.push_back(CheckTolerance());
+	results.push_back(CheckOverrun());
+	results.push_back(CheckCancel());
+	results.push_back(CheckFlush());
+	results.push_back(CheckExternalRelease());
+	results.push_back(CheckSteadyStateAllocations());
+	results.push_back(CheckThreaded());
+	results.push_back(CheckJitter());
+	return results;
+}
+
+std::vector<VideoFrameQueueBenchmarkResult> VideoFrameQueueBenchmark::RunBenchmarks(int frames)
+{
+	if (frames < 1) frames = 1;
+	std::vector<VideoFrameQueueBenchmarkResult> results;
+	const uint32_t w = 3840, h = 2160, stride = w * 4;
+	std::vector<uint8_t> decoded((size_t)stride * h, 0x40);
+	typedef std::chrono::steady_clock Clock;
+
+	// 旧路径：每帧新建 vector、拷贝，在互斥锁下交换给渲染端，渲染端换出后释放
+	{
+		VideoFrameQueueBenchmarkResult b;
+		b.Name = L"旧路径（每帧 new vector + 互斥交换）";
+		b.Frames = frames;
+		std::mutex mutex;
+		std::vector<uint8_t> shared;
+		auto t0 = Clock::now();
+		for (int i = 0; i < frames; i++)
+		{
+			std::vector<uint8_t> normalized;
+			normalized.resize(decoded.size());
+			std::memcpy(normalized.data(), decoded.data(), decoded.size());
+			{
+				std::scoped_lock lock(mutex);
+				shared = std::move(normalized);
+			}
+			std::vector<uint8_t> frame;
+			{
+				std::scoped_lock lock(mutex);
+				frame.swap(shared);
+			}
+			b.Presented++;
+		}
+		b.MillisPerFrame = std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / frames;
+		b.Allocations = frames;
+		results.push_back(b);
+	}
+
+	// 帧池：拷贝进池内缓冲 / 直接挂接解码缓冲
+	for (int zeroCopy = 0; zeroCopy < 2; zeroCopy++)
+	{
+		VideoFrameQueueBenchmarkResult b;
+		b.Name = zeroCopy ? L"帧池（零拷贝挂接）" : L"帧池（池内缓冲拷贝）";
+		b.Frames = frames;
+		VideoFrameQueue q;
+		auto t0 = Clock::now();
+		for (int i = 0; i < frames; i++)
+		{
+			VideoFrame* f = q.BeginWrite();
+			if (zeroCopy)
+				f->Attach(decoded.data(), w, h, stride, nullptr, nullptr);
+			else
+				std::memcpy(f->Allocate(w, h, stride), decoded.data(), decoded.size());
+			q.CommitWrite(f, i / 60.0);
+			q.Release(q.AcquireDue(i / 60.0));
+		}
+		b.MillisPerFrame = std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / frames;
+		auto s = q.GetStats();
+		b.Allocations = (int)s.Allocations;
+		b.Presented = (int)s.Presented;
+		b.Dropped = (int)(s.Dropped + s.Overruns);
+		results.push_back(b);
+	}
+
+	results.push_back(Simulate(L"24fps 内容 @60Hz", 24.0, 20.0, 0.03, 0));
+	results.push_back(Simulate(L"60fps 内容 @60Hz", 60.0, 20.0, 0.03, 0));
+	results.push_back(Simulate(L"60fps 内容 @60Hz，UI 每 10 周期卡一次", 60.0, 20.0, 0.03, 10));
+	return results;
+}
+
+std::wstring VideoFrameQueueBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<VideoFrameQueueBenchmarkResult>& benchmarks)
+{
+	std::wstring text = CheckSummary(L"视频帧队列", checks);
+	text += L"3840x2160 BGRA 帧交接（单线程，含拷贝）：\r\n";
+	for (const auto& b : benchmarks)
+	{
+		if (b.Simulated) continue;
+		text += CheckFormat(L"  %ls：%.3f ms/帧，%d 帧分配 %d 次\r\n",
+			b.Name.c_str(), b.MillisPerFrame, b.Frames, b.Allocations);
+	}
+	text += L"模拟播放（解码提前 30ms，容差半个刷新周期）：\r\n";
+	for (const auto& b : benchmarks)
+	{
+		if (!b.Simulated) continue;
+		text += CheckFormat(L"  %ls：%d 帧 → 呈现 %d，丢弃 %d；抖动 平均 %.2fms 最大 %.2fms；分配 %d 次\r\n",
+			b.Name.c_str(), b.Frames, b.Presented, b.Dropped, b.AverageJitter, b.MaxJitter, b.Allocations);
+	}
+	return text;
+}
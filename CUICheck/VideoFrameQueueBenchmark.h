@@ -0,0 +1,41 @@
+#pragma once
+
+/**
+ * @file VideoFrameQueueBenchmark.h
+ * @brief 视频帧池/队列的校验与基准（CUICheck 套件 video-frame-queue）。
+ *
+ * 只使用 VideoFrameQueue，不依赖 Win32/Media Foundation：
+ * - RunChecks：按时选帧与迟到丢弃、容差、池满、放弃重用、Flush、外部缓冲释放、稳态零分配、
+ *   双线程压力（顺序与内容不撕裂）、抖动统计
+ * - RunBenchmarks：4K 帧旧路径（每帧新 vector + 互斥交换）与帧池 / 零拷贝挂接的耗时与分配次数；
+ *   24/60fps 内容在 60Hz 刷新下的呈现、丢帧与抖动（模拟时钟）
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct VideoFrameQueueBenchmarkResult
+{
+	std::wstring Name;
+	/** @brief 模拟播放场景（模拟时钟，无耗时数据）。 */
+	bool Simulated = false;
+	int Frames = 0;
+	/** @brief 生产 + 消费一帧的耗时（毫秒，实测）。 */
+	double MillisPerFrame = 0.0;
+	/** @brief 帧缓冲分配次数。 */
+	int Allocations = 0;
+	int Presented = 0;
+	int Dropped = 0;
+	/** @brief 平均/最大抖动（毫秒）。 */
+	double AverageJitter = 0.0;
+	double MaxJitter = 0.0;
+};
+
+class VideoFrameQueueBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param frames 4K 拷贝基准的帧数。 */
+	static std::vector<VideoFrameQueueBenchmarkResult> RunBenchmarks(int frames = 120);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<VideoFrameQueueBenchmarkResult>& benchmarks);
+};
@@ -0,0 +1,461 @@
+#include "WsolaBenchmark.h"
+#include "../CUI/GUI/WsolaTimeStretch.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+const double Pi = 3.14159265358979323846;
+
+// 固定种子的线性同余发生器：每次运行的输入一致
+struct Lcg
+{
+	unsigned int State;
+	explicit Lcg(unsigned int seed) : State(seed) {}
+	/** @brief [-1, 1) 均匀分布。 */
+	float Next()
+	{
+		State = State * 1664525u + 1013904223u;
+		return (float)((double)(State >> 8) / 8388608.0 - 1.0);
+	}
+};
+
+struct Config
+{
+	uint32_t SampleRate;
+	uint32_t Channels;
+};
+
+const Config SearchConfigs[] = { { 44100, 2 }, { 48000, 2 }, { 96000, 6 } };
+const float Tempos[] = { 0.5f, 0.75f, 1.5f, 2.0f };
+
+// 被测的搜索方式：Direct 按内核展开（当前 CPU 不支持的内核跳过）
+struct Variant
+{
+	WsolaSearch Search;
+	WsolaKernel Kernel;
+};
+
+std::vector<Variant> FastVariants()
+{
+	std::vector<Variant> v;
+	const WsolaKernel kernels[] = { WsolaKernel::Scalar, WsolaKernel::Sse2, WsolaKernel::Avx2 };
+	for (WsolaKernel k : kernels)
+		if (WsolaTimeStretch::IsKernelSupported(k))
+			v.push_back({ WsolaSearch::Direct, k });
+	v.push_back({ WsolaSearch::Fft, WsolaTimeStretch::BestKernel() });
+	v.push_back({ WsolaSearch::Auto, WsolaTimeStretch::BestKernel() });
+	return v;
+}
+
+std::wstring VariantName(const Variant& v)
+{
+	if (v.Search == WsolaSearch::Direct)
+		return CheckFormat(L"Direct %ls", WsolaTimeStretch::KernelName(v.Kernel));
+	return WsolaTimeStretch::SearchName(v.Search);
+}
+
+// 类音乐信号：几组带颤音的谐波 + 少量噪声，各声道相位不同
+std::vector<float> MakeMusic(uint32_t sampleRate, uint32_t channels, size_t frames, unsigned int seed)
+{
+	std::vector<float> out(frames * channels);
+	Lcg rng(seed);
+	const double bases[] = { 220.0, 277.18, 329.63 };
+	for (size_t f = 0; f < frames; f++)
+	{
+		const double t = (double)f / sampleRate;
+		for (uint32_t c = 0; c < channels; c++)
+		{
+			double v = 0.0;
+			for (int n = 0; n < 3; n++)
+			{
+				const double vibrato = 1.0 + 0.004 * std::sin(2.0 * Pi * (5.0 + n) * t);
+				for (int h = 1; h <= 4; h++)
+					v += 0.08 / h * std::sin(2.0 * Pi * bases[n] * h * vibrato * t + 0.7 * c + n);
+			}
+			out[f * channels + c] = (float)(v + 0.02 * rng.Next());
+		}
+	}
+	return out;
+}
+
+std::vector<float> MakeTone(uint32_t sampleRate, uint32_t channels, size_t frames, double hz)
+{
+	std::vector<float> out(frames * channels);
+	for (size_t f = 0; f < frames; f++)
+		for (uint32_t c = 0; c < channels; c++)
+			out[f * channels + c] = (float)(0.5 * std::sin(2.0 * Pi * hz * (double)f / sampleRate + 0.3 * c));
+	return out;
+}
+
+// 按 1024 帧一块喂入（与播放线程的块大小同量级）
+std::vector<float> Stretch(WsolaTimeStretch& ts, const std::vector<float>& in, float tempo)
+{
+	const size_t chs = ts.Channels();
+	const size_t frames = in.size() / chs;
+	std::vector<float> out;
+	for (size_t f = 0; f < frames; f += 1024)
+	{
+		const size_t n = (std::min)((size_t)1024, frames - f);
+		ts.ProcessFloat(in.data() + f * chs, n, tempo, out);
+	}
+	return out;
+}
+
+double SnrDb(const std::vector<float>& value, const std::vector<float>& expected, size_t begin, size_t end)
+{
+	double signal = 0.0, noise = 0.0;
+	for (size_t i = begin; i < end; i++)
+	{
+		signal += (double)expected[i] * expected[i];
+		const double d = (double)value[i] - expected[i];
+		noise += d * d;
+	}
+	if (noise <= 0.0) return 200.0;
+	return 10.0 * std::log10(signal / noise);
+}
+
+// 对每个声道按最小二乘拟合给定频率的正弦（幅度/相位自由），返回 拟合信号 / 残差 的 SNR
+double ToneSnrDb(const std::vector<float>& x, uint32_t channels, uint32_t sampleRate, double hz, size_t beginFrame, size_t endFrame)
+{
+	double signal = 0.0, noise = 0.0;
+	for (uint32_t c = 0; c < channels; c++)
+	{
+		double ss = 0.0, cc = 0.0, sc = 0.0, xs = 0.0, xc = 0.0;
+		for (size_t f = beginFrame; f < endFrame; f++)
+		{
+			const double w = 2.0 * Pi * hz * (double)f / sampleRate;
+			const double s = std::sin(w), co = std::cos(w), v = x[f * channels + c];
+			ss += s * s; cc += co * co; sc += s * co; xs += v * s; xc += v * co;
+		}
+		const double det = ss * cc - sc * sc;
+		const double a = (xs * cc - xc * sc) / det;
+		const double b = (xc * ss - xs * sc) / det;
+		for (size_t f = beginFrame; f < endFrame; f++)
+		{
+			const double w = 2.0 * Pi * hz * (double)f / sampleRate;
+			const double fit = a * std::sin(w) + b * std::cos(w);
+			const double d = x[f * channels + c] - fit;
+			signal += fit * fit;
+			noise += d * d;
+		}
+	}
+	if (noise <= 0.0) return 200.0;
+	return 10.0 * std::log10(signal / noise);
+}
+
+CheckResult CheckPlantedOffset()
+{
+	CheckResult r{ L"找回已知偏移（噪声中嵌入尾部）", true, L"" };
+	auto variants = FastVariants();
+	variants.push_back({ WsolaSearch::Reference, WsolaKernel::Scalar });
+	Lcg rng(77u);
+	for (const auto& cfg : SearchConfigs)
+	{
+		for (const auto& v : variants)
+		{
+			WsolaTimeStretch ts(cfg.SampleRate, cfg.Channels, true, 32, v.Search, v.Kernel);
+			const size_t overlap = ts.OverlapFrames();
+			// Reference 在重叠 ≥ 512 帧时隔点粗搜，白噪声没有相关性，粗搜找不回，只比较它穷举的配置
+			if (v.Search == WsolaSearch::Reference && overlap >= 512) continue;
+			const size_t candidates = (size_t)ts.SearchFrames() * 2 + 1;
+			std::vector<float> region((candidates - 1 + overlap) * cfg.Channels);
+			for (auto& s : region) s = rng.Next();
+			for (int trial = 0; trial < 8 && r.Passed; trial++)
+			{
+				const size_t planted = (size_t)(trial * 131 + 17) % candidates;
+				std::vector<float> tail(region.begin() + planted * cfg.Channels, region.begin() + (planted + overlap) * cfg.Channels);
+				const size_t found = ts.FindBestOffset(tail.data(), region.data(), candidates);
+				if (found != planted)
+				{
+					r.Passed = false;
+					r.Detail = CheckFormat(L"%d Hz %d 声道 %ls：找到 %d，期望 %d",
+						(int)cfg.SampleRate, (int)cfg.Channels, VariantName(v).c_str(), (int)found, (int)planted);
+				}
+			}
+		}
+	}
+	return r;
+}
+
+CheckResult CheckMatchesExhaustive()
+{
+	CheckResult r{ L"与 double 穷举 NCC 最优值一致", true, L"" };
+	double worst = 0.0;
+	for (const auto& cfg : SearchConfigs)
+	{
+		auto music = MakeMusic(cfg.SampleRate, cfg.Channels, cfg.SampleRate, 5u);
+		for (const auto& v : FastVariants())
+		{
+			WsolaTimeStretch ts(cfg.SampleRate, cfg.Channels, true, 32, v.Search, v.Kernel);
+			const size_t overlap = ts.OverlapFrames();
+			const size_t samples = overlap * cfg.Channels;
+			const size_t candidates = (size_t)ts.SearchFrames() * 2 + 1;
+			for (size_t pos = 0; pos + 3 * (candidates + overlap) < cfg.SampleRate && r.Passed; pos += cfg.SampleRate / 10)
+			{
+				const float* tail = music.data() + pos * cfg.Channels;
+				const float* region = tail + (candidates + overlap) * cfg.Channels;
+				double best = -2.0;
+				for (size_t s = 0; s < candidates; s++)
+					best = (std::max)(best, WsolaTimeStretch::Ncc(tail, region + s * cfg.Channels, samples));
+				const size_t found = ts.FindBestOffset(tail, region, candidates);
+				const double got = WsolaTimeStretch::Ncc(tail, region + found * cfg.Channels, samples);
+				worst = (std::max)(worst, best - got);
+				if (best - got > 1e-4)
+				{
+					r.Passed = false;
+					r.Detail = CheckFormat(L"%d Hz %d 声道 %ls：NCC %.6f，穷举最优 %.6f",
+						(int)cfg.SampleRate, (int)cfg.Channels, VariantName(v).c_str(), got, best);
+				}
+			}
+		}
+	}
+	if (r.Passed)
+		r.Detail = CheckFormat(L"最大 NCC 差 %.2e", worst);
+	return r;
+}
+
+CheckResult CheckOutputMatchesReference()
+{
+	// 搜索遇到近似并列的峰时，float 与 double 可能选中不同起点，此后是另一条同样有效的拼接路径，
+	// 逐样本 SNR 不再有意义，平均拼接 NCC 也会有路径带来的小幅差异（每一处选择本身的最优性由穷举校验保证）。
+	// 因此要求：时长相同；平均拼接 NCC 不低于 Reference 0.01 以上；并报告逐样本一致（SNR ≥ 60 dB）的组数
+	CheckResult r{ L"输出质量不低于 Reference（48k 立体声）", true, L"" };
+	const uint32_t rate = 48000, chs = 2;
+	auto music = MakeMusic(rate, chs, rate * 3, 9u);
+	int identical = 0, total = 0;
+	double worstDelta = 1.0;
+	for (float tempo : Tempos)
+	{
+		WsolaTimeStretch reference(rate, chs, true, 32, WsolaSearch::Reference);
+		auto expected = Stretch(reference, music, tempo);
+		const auto& refStats = reference.GetStats();
+		const double refScore = refStats.Joins ? refStats.JoinScoreSum / (double)refStats.Joins : 0.0;
+		for (const auto& v : FastVariants())
+		{
+			WsolaTimeStretch ts(rate, chs, true, 32, v.Search, v.Kernel);
+			auto actual = Stretch(ts, music, tempo);
+			if (actual.size() != expected.size())
+			{
+				r.Passed = false;
+				r.Detail = CheckFormat(L"%.2fx %ls：输出 %d 帧，Reference %d 帧",
+					tempo, VariantName(v).c_str(), (int)(actual.size() / chs), (int)(expected.size() / chs));
+				return r;
+			}
+			const auto& stats = ts.GetStats();
+			const double score = stats.Joins ? stats.JoinScoreSum / (double)stats.Joins : 0.0;
+			worstDelta = (std::min)(worstDelta, score - refScore);
+			if (score < refScore - 0.01)
+			{
+				r.Passed = false;
+				r.Detail = CheckFormat(L"%.2fx %ls：平均拼接 NCC %.5f，Reference %.5f",
+					tempo, VariantName(v).c_str(), score, refScore);
+				return r;
+			}
+			total++;
+			if (SnrDb(actual, expected, 0, expected.size()) >= 60.0) identical++;
+		}
+	}
+	r.Detail = CheckFormat(L"%d/%d 组与 Reference 逐样本一致，平均拼接 NCC 差最小 %+.4f", identical, total, worstDelta);
+	return r;
+}
+
+CheckResult CheckToneQuality()
+{
+	CheckResult r{ L"纯音变速后 SNR ≥ 25 dB（相对理想正弦）", true, L"" };
+	const uint32_t rate = 48000, chs = 2;
+	const double hz = 440.0;
+	auto tone = MakeTone(rate, chs, rate * 2, hz);
+	double worst = 200.0;
+	for (float tempo : Tempos)
+	{
+		WsolaTimeStretch ts(rate, chs, true, 32);
+		auto out = Stretch(ts, tone, tempo);
+		const size_t frames = out.size() / chs;
+		// 只看稳态的一段（跳过首段），拟合窗口 0.1 秒
+		const size_t window = rate / 10;
+		for (size_t begin = ts.WindowFrames(); begin + window <= frames; begin += window)
+		{
+			const double snr = ToneSnrDb(out, chs, rate, hz, begin, begin + window);
+			worst = (std::min)(worst, snr);
+			if (snr < 25.0)
+			{
+				r.Passed = false;
+				r.Detail = CheckFormat(L"%.2fx 第 %d 帧起：SNR %.1f dB", tempo, (int)begin, snr);
+				return r;
+			}
+		}
+	}
+	r.Detail = CheckFormat(L"最低 %.1f dB", worst);
+	return r;
+}
+
+CheckResult CheckDuration()
+{
+	CheckResult r{ L"输出时长 ≈ 输入 / 倍速", true, L"" };
+	const uint32_t rate = 44100, chs = 2;
+	auto music = MakeMusic(rate, chs, rate * 4, 3u);
+	for (float tempo : Tempos)
+	{
+		WsolaTimeStretch ts(rate, chs, true, 32);
+		auto out = Stretch(ts, music, tempo);
+		const double expected = (double)(music.size() / chs) / tempo;
+		const double actual = (double)(out.size() / chs);
+		// 末尾最多滞留一个窗长加一次搜索范围的输入
+		const double slack = (double)(ts.WindowFrames() + ts.SearchFrames() * 2) / tempo + ts.WindowFrames();
+		if (std::fabs(actual - expected) > slack)
+		{
+			r.Passed = false;
+			r.Detail = CheckFormat(L"%.2fx：输出 %.0f 帧，期望约 %.0f 帧", tempo, actual, expected);
+			return r;
+		}
+	}
+	return r;
+}
+
+CheckResult CheckIntegerPcm()
+{
+	CheckResult r{ L"16/32 位整数 PCM 原速往返", true, L"" };
+	const uint32_t rate = 48000, chs = 2;
+	auto music = MakeMusic(rate, chs, rate, 21u);
+	for (int bits = 16; bits <= 32 && r.Passed; bits += 16)
+	{
+		const size_t bytesPerSample = (size_t)bits / 8;
+		std::vector<uint8_t> pcm(music.size() * bytesPerSample);
+		for (size_t i = 0; i < music.size(); i++)
+		{
+			if (bits == 16)
+			{
+				const int16_t v = (int16_t)std::lround(music[i] * 32767.0f);
+				std::memcpy(&pcm[i * 2], &v, 2);
+			}
+			else
+			{
+				const int32_t v = (int32_t)std::llround((double)music[i] * 2147483647.0);
+				std::memcpy(&pcm[i * 4], &v, 4);
+			}
+		}
+		WsolaTimeStretch ts(rate, chs, false, (uint32_t)bits);
+		std::vector<uint8_t> out, chunk;
+		const size_t chunkBytes = 1024 * chs * bytesPerSample;
+		for (size_t off = 0; off < pcm.size(); off += chunkBytes)
+		{
+			if (!ts.ProcessChunk(pcm.data() + off, (std::min)(chunkBytes, pcm.size() - off), 1.0f, 1.0f, chunk))
+			{
+				r.Passed = false;
+				r.Detail = CheckFormat(L"%d 位：ProcessChunk 失败", bits);
+				break;
+			}
+			out.insert(out.end(), chunk.begin(), chunk.end());
+		}
+		if (!r.Passed) break;
+		// 原速时每段正好接在预测位置，输出应与输入逐样本一致（允许量化误差）
+		const size_t samples = out.size() / bytesPerSample;
+		if (samples < music.size() / 2)
+		{
+			r.Passed = false;
+			r.Detail = CheckFormat(L"%d 位：只输出 %d 个样本", bits, (int)samples);
+			break;
+		}
+		std::vector<float> decoded(samples), expected(music.begin(), music.begin() + samples);
+		for (size_t i = 0; i < samples; i++)
+		{
+			if (bits == 16)
+			{
+				int16_t v;
+				std::memcpy(&v, &out[i * 2], 2);
+				decoded[i] = (float)v / 32767.0f;
+			}
+			else
+			{
+				int32_t v;
+				std::memcpy(&v, &out[i * 4], 4);
+				decoded[i] = (float)((double)v / 2147483647.0);
+			}
+		}
+		const double snr = SnrDb(decoded, expected, 0, samples);
+		const double required = bits == 16 ? 70.0 : 120.0;
+		if (snr < required)
+		{
+			r.Passed = false;
+			r.Detail = CheckFormat(L"%d 位：SNR %.1f dB（要求 ≥ %.0f dB）", bits, snr, required);
+		}
+	}
+	return r;
+}
+
+WsolaBenchmarkResult RunCase(const Config& cfg, const Variant& v, const std::vector<float>& input, int seconds)
+{
+	WsolaBenchmarkResult result;
+	result.Name = CheckFormat(L"%d Hz %d 声道 %ls", (int)cfg.SampleRate, (int)cfg.Channels, VariantName(v).c_str());
+	WsolaTimeStretch ts(cfg.SampleRate, cfg.Channels, true, 32, v.Search, v.Kernel);
+	auto t0 = std::chrono::steady_clock::now();
+	auto out = Stretch(ts, input, 2.0f);
+	auto t1 = std::chrono::steady_clock::now();
+	const double seconds2 = std::chrono::duration<double>(t1 - t0).count();
+	result.MillisPerSecond = seconds2 * 1000.0 / seconds;
+	const auto& stats = ts.GetStats();
+	result.FftShare = stats.Segments > 1 ? (double)stats.FftSearches / (double)(stats.Segments - 1) : 0.0;
+	(void)out;
+	return result;
+}
+
+} // namespace
+
+std::vector<CheckResult> WsolaBenchmark::RunChecks()
+{
+	std::vector<CheckResult> results;
+	results.push_back(CheckPlantedOffset());
+	results.push_back(CheckMatchesExhaustive());
+	results.push_back(CheckOutputMatchesReference());
+	results.push_back(CheckToneQuality());
+	results.push_back(CheckDuration());
+	results.push_back(CheckIntegerPcm());
+	return results;
+}
+
+std::vector<WsolaBenchmarkResult> WsolaBenchmark::RunBenchmarks(int seconds)
+{
+	if (seconds < 1) seconds = 1;
+	std::vector<WsolaBenchmarkResult> results;
+	const Config configs[] = { { 48000, 2 }, { 96000, 6 } };
+	for (const auto& cfg : configs)
+	{
+		auto input = MakeMusic(cfg.SampleRate, cfg.Channels, (size_t)cfg.SampleRate * seconds, 1u);
+		auto reference = RunCase(cfg, { WsolaSearch::Reference, WsolaKernel::Scalar }, input, seconds);
+		results.push_back(reference);
+		for (const auto& v : FastVariants())
+		{
+			auto result = RunCase(cfg, v, input, seconds);
+			result.Speedup = result.MillisPerSecond > 0.0 ? reference.MillisPerSecond / result.MillisPerSecond : 1.0;
+			results.push_back(result);
+		}
+	}
+	return results;
+}
+
+std::wstring WsolaBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<WsolaBenchmarkResult>& benchmarks)
+{
+	int passed = 0;
+	for (const auto& c : checks)
+		if (c.Passed) passed++;
+	std::wstring text = CheckFormat(L"WSOLA 校验：%d/%d 通过（当前 CPU 最快内核：%ls）\r\n",
+		passed, (int)checks.size(), WsolaTimeStretch::KernelName(WsolaTimeStretch::BestKernel()));
+	for (const auto& c : checks)
+	{
+		if (!c.Passed)
+			text += CheckFormat(L"  [失败] %ls：%ls\r\n", c.Name.c_str(), c.Detail.c_str());
+		else if (!c.Detail.empty())
+			text += CheckFormat(L"  [提示] %ls：%ls\r\n", c.Name.c_str(), c.Detail.c_str());
+	}
+	text += L"2 倍速处理 1 秒输入的耗时（单线程）：\r\n";
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"  %ls：%.2f ms，%.1fx，FFT 搜索 %.0f%%\r\n",
+			b.Name.c_str(), b.MillisPerSecond, b.Speedup, b.FftShare * 100.0);
+	}
+	return text;
+}
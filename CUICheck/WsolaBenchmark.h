@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * @file WsolaBenchmark.h
+ * @brief WSOLA 变速的质量校验与吞吐基准（CUICheck 套件 wsola）。
+ *
+ * 只使用 WsolaTimeStretch，不依赖 Win32/Media Foundation，CUICheck 的 CMake 构建在 Linux 上编译运行：
+ * - RunChecks：各搜索方式找回已知偏移、与 double 穷举 NCC 的最优值一致、输出与 Reference 比较（时长、拼接质量、SNR）、
+ *   纯音变速后的 SNR（相对理想正弦）、输出时长、16/32 位整数 PCM 往返
+ * - RunBenchmarks：48k 立体声与 96k 5.1 声道 2 倍速下各搜索方式/内核处理 1 秒音频的耗时
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct WsolaBenchmarkResult
+{
+	std::wstring Name;
+	/** @brief 处理 1 秒输入音频的耗时（毫秒）。 */
+	double MillisPerSecond = 0.0;
+	/** @brief 相对同配置 Reference 的加速比。 */
+	double Speedup = 1.0;
+	/** @brief 用 FFT 完成的搜索占比。 */
+	double FftShare = 0.0;
+};
+
+class WsolaBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param seconds 每种配置处理的输入时长（秒）。 */
+	static std::vector<WsolaBenchmarkResult> RunBenchmarks(int seconds = 5);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<WsolaBenchmarkResult>& benchmarks);
+};
@@ -0,0 +1,368 @@
+#include "YuvConvertBenchmark.h"
+#include "../CUI/GUI/YuvConvert.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+const uint32_t FrameWidth = 3840;
+const uint32_t FrameHeight = 2160;
+
+// 固定种子的线性同余发生器：每次运行的输入一致
+struct Lcg
+{
+	unsigned int State;
+	explicit Lcg(unsigned int seed) : State(seed) {}
+	int Next(int bound)
+	{
+		State = State * 1664525u + 1013904223u;
+		return (int)((State >> 8) % (unsigned int)bound);
+	}
+};
+
+const YuvKernel AllKernels[] = { YuvKernel::Scalar, YuvKernel::Sse2, YuvKernel::Avx2 };
+const YuvMatrix AllMatrices[] = { YuvMatrix::Bt601, YuvMatrix::Bt709, YuvMatrix::Bt2020 };
+
+const wchar_t* MatrixName(YuvMatrix m)
+{
+	switch (m)
+	{
+	case YuvMatrix::Bt601: return L"BT.601";
+	case YuvMatrix::Bt709: return L"BT.709";
+	case YuvMatrix::Bt2020: return L"BT.2020";
+	}
+	return L"?";
+}
+
+inline uint8_t Clip8(int v)
+{
+	return (uint8_t)((v < 0) ? 0 : (v > 255 ? 255 : v));
+}
+
+// 旧 MediaPlayer::ConvertNV12ToBGRA 的逐像素对公式（BT.601 有限范围），作为回归基准
+void LegacyRow(const uint8_t* yRow, const uint8_t* uvRow, uint8_t* dst, uint32_t w)
+{
+	for (uint32_t col = 0; col < w; col += 2)
+	{
+		const int U = (int)uvRow[col + 0] - 128;
+		const int V = (int)uvRow[col + 1] - 128;
+		const int c0 = (int)yRow[col + 0] - 16;
+		const int c1 = (int)yRow[col + 1] - 16;
+		const int C0 = (c0 < 0) ? 0 : c0;
+		const int C1 = (c1 < 0) ? 0 : c1;
+		const int rAdd = 409 * V;
+		const int gAdd = -100 * U - 208 * V;
+		const int bAdd = 516 * U;
+		int r = (298 * C0 + rAdd + 128) >> 8;
+		int g = (298 * C0 + gAdd + 128) >> 8;
+		int b = (298 * C0 + bAdd + 128) >> 8;
+		dst[(size_t)col * 4 + 0] = Clip8(b);
+		dst[(size_t)col * 4 + 1] = Clip8(g);
+		dst[(size_t)col * 4 + 2] = Clip8(r);
+		dst[(size_t)col * 4 + 3] = 0xFF;
+		r = (298 * C1 + rAdd + 128) >> 8;
+		g = (298 * C1 + gAdd + 128) >> 8;
+		b = (298 * C1 + bAdd + 128) >> 8;
+		dst[(size_t)(col + 1) * 4 + 0] = Clip8(b);
+		dst[(size_t)(col + 1) * 4 + 1] = Clip8(g);
+		dst[(size_t)(col + 1) * 4 + 2] = Clip8(r);
+		dst[(size_t)(col + 1) * 4 + 3] = 0xFF;
+	}
+}
+
+// 随机样本，约 1/8 取极值（0 / 最大值），覆盖截断与饱和
+void FillRandom(std::vector<uint8_t>& buf, Lcg& rng, bool tenBit)
+{
+	if (!tenBit)
+	{
+		for (auto& b : buf)
+		{
+			int k = rng.Next(16);
+			b = (uint8_t)(k == 0 ? 0 : (k == 1 ? 255 : rng.Next(256)));
+		}
+		return;
+	}
+	for (size_t i = 0; i + 1 < buf.size(); i += 2)
+	{
+		int k = rng.Next(16);
+		// 低 6 位放随机噪声：转换必须忽略它们
+		uint16_t v = (uint16_t)(k == 0 ? 0 : (k == 1 ? 0xFFFF : rng.Next(65536)));
+		std::memcpy(&buf[i], &v, sizeof(v));
+	}
+}
+
+void ExpectBytes(CheckResult& r, const std::wstring& what, const std::vector<uint8_t>& value, const std::vector<uint8_t>& expected)
+{
+	if (!r.Passed) return;
+	for (size_t i = 0; i < expected.size(); i++)
+	{
+		if (value[i] != expected[i])
+		{
+			r.Passed = false;
+			r.Detail = CheckFormat(L"%ls：像素 %d 通道 %d 为 %d，期望 %d",
+				what.c_str(), (int)(i / 4), (int)(i % 4), (int)value[i], (int)expected[i]);
+			return;
+		}
+	}
+}
+
+CheckResult CheckLegacy()
+{
+	CheckResult r{ L"与旧实现一致（BT.601 有限范围）", true, L"" };
+	Lcg rng(601u);
+	YuvToBgraConverter conv(YuvFormat::Nv12, YuvMatrix::Bt601, false, YuvKernel::Scalar);
+	for (uint32_t w = 2; w <= 130 && r.Passed; w += 2)
+	{
+		std::vector<uint8_t> y(w), uv(w), expected(w * 4), actual(w * 4);
+		FillRandom(y, rng, false);
+		FillRandom(uv, rng, false);
+		LegacyRow(y.data(), uv.data(), expected.data(), w);
+		conv.ConvertRow(y.data(), uv.data(), actual.data(), w);
+		ExpectBytes(r, CheckFormat(L"宽度 %d", (int)w), actual, expected);
+	}
+	return r;
+}
+
+CheckResult CheckKernels()
+{
+	CheckResult r{ L"SIMD 内核与标量逐字节一致", true, L"" };
+	Lcg rng(2160u);
+	int tested = 0;
+	for (int f = 0; f < 2 && r.Passed; f++)
+	{
+		const YuvFormat format = f == 0 ? YuvFormat::Nv12 : YuvFormat::P010;
+		const size_t bytesPerSample = f == 0 ? 1 : 2;
+		for (YuvMatrix m : AllMatrices)
+		{
+			for (int full = 0; full < 2 && r.Passed; full++)
+			{
+				YuvToBgraConverter reference(format, m, full != 0, YuvKernel::Scalar);
+				for (YuvKernel k : AllKernels)
+				{
+					if (k == YuvKernel::Scalar || !YuvToBgraConverter::IsKernelSupported(k)) continue;
+					YuvToBgraConverter conv(format, m, full != 0, k);
+					tested++;
+					// 1..80 覆盖所有行尾长度（含奇数宽度），外加一整行 4K
+					for (uint32_t w = 1; w <= 81 && r.Passed; w++)
+					{
+						const uint32_t width = w == 81 ? FrameWidth : w;
+						std::vector<uint8_t> y(width * bytesPerSample), uv(((width + 1) & ~1u) * bytesPerSample);
+						std::vector<uint8_t> expected(width * 4), actual(width * 4);
+						FillRandom(y, rng, f == 1);
+						FillRandom(uv, rng, f == 1);
+						reference.ConvertRow(y.data(), uv.data(), expected.data(), width);
+						conv.ConvertRow(y.data(), uv.data(), actual.data(), width);
+						ExpectBytes(r, CheckFormat(L"%ls %ls %ls %ls 宽度 %d", f == 0 ? L"NV12" : L"P010",
+							MatrixName(m), full ? L"全范围" : L"有限范围", YuvToBgraConverter::KernelName(k), (int)width),
+							actual, expected);
+					}
+				}
+			}
+		}
+	}
+	if (r.Passed && tested == 0)
+		r.Detail = L"当前 CPU 只支持标量内核，未比较";
+	return r;
+}
+
+CheckResult CheckCoefficients()
+{
+	CheckResult r{ L"系数", true, L"" };
+	auto c = YuvToBgraConverter::MakeCoefficients(YuvMatrix::Bt601, false);
+	if (c.Y != 298 || c.VR != 409 || c.UG != -100 || c.VG != -208 || c.UB != 516 || c.YOffset != 16)
+	{
+		r.Passed = false;
+		r.Detail = CheckFormat(L"BT.601 有限范围为 %d/%d/%d/%d/%d/%d，期望 298/409/-100/-208/516/16",
+			c.Y, c.VR, c.UG, c.VG, c.UB, c.YOffset);
+		return r;
+	}
+	c = YuvToBgraConverter::MakeCoefficients(YuvMatrix::Bt709, true);
+	if (c.Y != 256 || c.VR != 403 || c.UG != -48 || c.VG != -120 || c.UB != 475 || c.YOffset != 0)
+	{
+		r.Passed = false;
+		r.Detail = CheckFormat(L"BT.709 全范围为 %d/%d/%d/%d/%d/%d，期望 256/403/-48/-120/475/0",
+			c.Y, c.VR, c.UG, c.VG, c.UB, c.YOffset);
+	}
+	return r;
+}
+
+CheckResult CheckAgainstFloat()
+{
+	CheckResult r{ L"与浮点公式误差 ≤ 2", true, L"" };
+	for (YuvMatrix m : AllMatrices)
+	{
+		for (int full = 0; full < 2 && r.Passed; full++)
+		{
+			double kr = 0.299, kb = 0.114;
+			if (m == YuvMatrix::Bt709) { kr = 0.2126; kb = 0.0722; }
+			if (m == YuvMatrix::Bt2020) { kr = 0.2627; kb = 0.0593; }
+			const double kg = 1.0 - kr - kb;
+			const double ys = full ? 1.0 : 255.0 / 219.0;
+			const double cs = full ? 1.0 : 255.0 / 224.0;
+			const int yOff = full ? 0 : 16;
+			YuvToBgraConverter conv(YuvFormat::Nv12, m, full != 0, YuvKernel::Scalar);
+			// 遍历 Y 与 U/V 的 8 步长网格
+			for (int Y = 0; Y < 256 && r.Passed; Y += 3)
+			{
+				for (int U = 0; U < 256 && r.Passed; U += 8)
+				{
+					for (int V = 0; V < 256 && r.Passed; V += 8)
+					{
+						uint8_t y[2] = { (uint8_t)Y, (uint8_t)Y };
+						uint8_t uv[2] = { (uint8_t)U, (uint8_t)V };
+						uint8_t px[8];
+						conv.ConvertRow(y, uv, px, 2);
+						const double l = (std::max)(0, Y - yOff) * ys;
+						const double u = (U - 128) * cs, v = (V - 128) * cs;
+						const double rgb[3] = {
+							l + 2.0 * (1.0 - kb) * u,
+							l - 2.0 * (1.0 - kb) * kb / kg * u - 2.0 * (1.0 - kr) * kr / kg * v,
+							l + 2.0 * (1.0 - kr) * v };
+						for (int ch = 0; ch < 3; ch++)
+						{
+							int expected = (int)std::lround(rgb[ch]);
+							expected = expected < 0 ? 0 : (expected > 255 ? 255 : expected);
+							if (std::abs((int)px[ch] - expected) > 2)
+							{
+								r.Passed = false;
+								r.Detail = CheckFormat(L"%ls %ls YUV(%d,%d,%d) 通道 %d 为 %d，浮点 %d",
+									MatrixName(m), full ? L"全范围" : L"有限范围", Y, U, V, ch, (int)px[ch], expected);
+								break;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+	return r;
+}
+
+CheckResult CheckP010MatchesNv12()
+{
+	CheckResult r{ L"P010（8 位样本左移）与 NV12 一致", true, L"" };
+	Lcg rng(10u);
+	const uint32_t w = 258;
+	std::vector<uint8_t> y8(w), uv8(w), y16(w * 2), uv16(w * 2);
+	FillRandom(y8, rng, false);
+	FillRandom(uv8, rng, false);
+	for (uint32_t i = 0; i < w; i++)
+	{
+		uint16_t a = (uint16_t)(y8[i] << 8), b = (uint16_t)(uv8[i] << 8);
+		std::memcpy(&y16[i * 2], &a, 2);
+		std::memcpy(&uv16[i * 2], &b, 2);
+	}
+	for (YuvMatrix m : AllMatrices)
+	{
+		for (int full = 0; full < 2; full++)
+		{
+			std::vector<uint8_t> expected(w * 4), actual(w * 4);
+			YuvToBgraConverter(YuvFormat::Nv12, m, full != 0).ConvertRow(y8.data(), uv8.data(), expected.data(), w);
+			YuvToBgraConverter(YuvFormat::P010, m, full != 0).ConvertRow(y16.data(), uv16.data(), actual.data(), w);
+			ExpectBytes(r, MatrixName(m), actual, expected);
+		}
+	}
+	return r;
+}
+
+CheckResult CheckFullRangeGray()
+{
+	CheckResult r{ L"全范围灰阶无损", true, L"" };
+	std::vector<uint8_t> y(256), uv(256, 128), expected(256 * 4), actual(256 * 4);
+	for (int i = 0; i < 256; i++)
+	{
+		y[i] = (uint8_t)i;
+		expected[i * 4 + 0] = expected[i * 4 + 1] = expected[i * 4 + 2] = (uint8_t)i;
+		expected[i * 4 + 3] = 0xFF;
+	}
+	for (YuvMatrix m : AllMatrices)
+	{
+		YuvToBgraConverter(YuvFormat::Nv12, m, true).ConvertRow(y.data(), uv.data(), actual.data(), 256);
+		ExpectBytes(r, MatrixName(m), actual, expected);
+	}
+	return r;
+}
+
+YuvConvertBenchmarkResult RunCase(YuvFormat format, YuvKernel kernel, int frames,
+	const std::vector<uint8_t>& y, const std::vector<uint8_t>& uv, size_t stride, std::vector<uint8_t>& out)
+{
+	YuvConvertBenchmarkResult result;
+	result.Name = CheckFormat(L"%ls %ls", format == YuvFormat::Nv12 ? L"NV12" : L"P010", YuvToBgraConverter::KernelName(kernel));
+	result.Frames = frames;
+	YuvToBgraConverter conv(format, YuvMatrix::Bt709, false, kernel);
+	auto t0 = std::chrono::steady_clock::now();
+	for (int f = 0; f < frames; f++)
+		conv.Convert(y.data(), stride, uv.data(), stride, FrameWidth, FrameHeight, out.data(), (size_t)FrameWidth * 4);
+	auto t1 = std::chrono::steady_clock::now();
+	const double seconds = std::chrono::duration<double>(t1 - t0).count();
+	result.MillisPerFrame = seconds * 1000.0 / frames;
+	result.MegapixelsPerSecond = seconds > 0.0 ? (double)FrameWidth * FrameHeight * frames / seconds / 1e6 : 0.0;
+	return result;
+}
+
+} // namespace
+
+std::vector<CheckResult> YuvConvertBenchmark::RunChecks()
+{
+	std::vector<CheckResult> results;
+	results.push_back(CheckLegacy());
+	results.push_back(CheckKernels());
+	results.push_back(CheckCoefficients());
+	results.push_back(CheckAgainstFloat());
+	results.push_back(CheckP010MatchesNv12());
+	results.push_back(CheckFullRangeGray());
+	return results;
+}
+
+std::vector<YuvConvertBenchmarkResult> YuvConvertBenchmark::RunBenchmarks(int frames)
+{
+	if (frames < 1) frames = 1;
+	std::vector<YuvConvertBenchmarkResult> results;
+	std::vector<uint8_t> out((size_t)FrameWidth * FrameHeight * 4);
+	for (int f = 0; f < 2; f++)
+	{
+		const YuvFormat format = f == 0 ? YuvFormat::Nv12 : YuvFormat::P010;
+		const size_t stride = (size_t)FrameWidth * (f == 0 ? 1 : 2);
+		std::vector<uint8_t> y(stride * FrameHeight), uv(stride * FrameHeight / 2);
+		Lcg rng(4096u);
+		FillRandom(y, rng, f == 1);
+		FillRandom(uv, rng, f == 1);
+		double scalarMs = 0.0;
+		for (YuvKernel k : AllKernels)
+		{
+			if (!YuvToBgraConverter::IsKernelSupported(k)) continue;
+			auto result = RunCase(format, k, frames, y, uv, stride, out);
+			if (k == YuvKernel::Scalar) scalarMs = result.MillisPerFrame;
+			result.Speedup = result.MillisPerFrame > 0.0 ? scalarMs / result.MillisPerFrame : 1.0;
+			results.push_back(result);
+		}
+	}
+	return results;
+}
+
+std::wstring YuvConvertBenchmark::Report(const std::vector<CheckResult>& checks, const std::vector<YuvConvertBenchmarkResult>& benchmarks)
+{
+	int passed = 0;
+	for (const auto& c : checks)
+		if (c.Passed) passed++;
+	std::wstring text = CheckFormat(L"颜色转换校验：%d/%d 通过（当前 CPU 最快内核：%ls）\r\n",
+		passed, (int)checks.size(), YuvToBgraConverter::KernelName(YuvToBgraConverter::BestKernel()));
+	for (const auto& c : checks)
+	{
+		if (!c.Passed)
+			text += CheckFormat(L"  [失败] %ls：%ls\r\n", c.Name.c_str(), c.Detail.c_str());
+		else if (!c.Detail.empty())
+			text += CheckFormat(L"  [提示] %ls：%ls\r\n", c.Name.c_str(), c.Detail.c_str());
+	}
+	text += CheckFormat(L"%dx%d BT.709 单线程（4K60 需 ≤ 16.7ms/帧）：\r\n", (int)FrameWidth, (int)FrameHeight);
+	for (const auto& b : benchmarks)
+	{
+		text += CheckFormat(L"  %ls：%.2f ms/帧，%.0f 百万像素/秒，%.1fx\r\n",
+			b.Name.c_str(), b.MillisPerFrame, b.MegapixelsPerSecond, b.Speedup);
+	}
+	return text;
+}
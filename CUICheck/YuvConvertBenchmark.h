@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * @file YuvConvertBenchmark.h
+ * @brief NV12/P010 → BGRA 颜色转换的逐字节校验与吞吐基准（CUICheck 套件 yuv）。
+ *
+ * 只使用 YuvToBgraConverter，不依赖 Win32/Media Foundation，CUICheck 的 CMake 构建在 Linux 上编译运行：
+ * - RunChecks：与旧 ConvertNV12ToBGRA 公式逐字节一致、SIMD 内核与标量逐字节一致（含奇数宽度/行尾）、
+ *   系数、与浮点公式的误差、P010 与 NV12 一致性、全范围灰阶
+ * - RunBenchmarks：3840x2160 帧在各内核下的单线程耗时
+ */
+#include "CheckHarness.h"
+#include <string>
+#include <vector>
+
+struct YuvConvertBenchmarkResult
+{
+	std::wstring Name;
+	int Frames = 0;
+	/** @brief 每帧耗时（毫秒，单线程）与吞吐（百万像素/秒）。 */
+	double MillisPerFrame = 0.0;
+	double MegapixelsPerSecond = 0.0;
+	/** @brief 相对同格式标量内核的加速比。 */
+	double Speedup = 1.0;
+};
+
+class YuvConvertBenchmark
+{
+public:
+	static std::vector<CheckResult> RunChecks();
+	/** @param frames 每个内核转换的 4K 帧数。 */
+	static std::vector<YuvConvertBenchmarkResult> RunBenchmarks(int frames = 30);
+	static std::wstring Report(const std::vector<CheckResult>& checks, const std::vector<YuvConvertBenchmarkResult>& benchmarks);
+};
@@ -0,0 +1,62 @@
+#include "CheckHarness.h"
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/**
+ * CUICheck [--bench] [--list] [套件 Id ...]
+ *
+ * 默认只运行校验；任一校验失败时退出码为 1（CI 据此判定）。
+ * --bench 同时运行基准并输出各套件的完整报告；--list 列出本平台可用的套件。
+ */
+int main(int argc, char** argv)
+{
+#ifdef _WIN32
+	SetConsoleOutputCP(CP_UTF8);
+#endif
+	CheckRunOptions options;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--bench") == 0)
+		{
+			options.Benchmarks = true;
+		}
+		else if (std::strcmp(argv[i], "--list") == 0)
+		{
+			for (const auto& suite : AllCheckSuites())
+				std::printf("%s\t%s\n", suite.Id, CheckToUtf8(suite.Title).c_str());
+			return 0;
+		}
+		else if (argv[i][0] == '-')
+		{
+			std::fprintf(stderr, "usage: CUICheck [--bench] [--list] [suite ...]\n");
+			return 2;
+		}
+		else
+		{
+			bool known = false;
+			for (const auto& suite : AllCheckSuites())
+				if (std::strcmp(suite.Id, argv[i]) == 0) known = true;
+			if (!known)
+			{
+				std::fprintf(stderr, "unknown suite: %s (see --list)\n", argv[i]);
+				return 2;
+			}
+			options.Suites.push_back(argv[i]);
+		}
+	}
+
+	const auto summary = RunCheckSuites(options);
+	std::string text = CheckToUtf8(summary.Text);
+#ifndef _WIN32
+	std::string lf;
+	lf.reserve(text.size());
+	for (char c : text)
+		if (c != '\r') lf += c;
+	text.swap(lf);
+#endif
+	std::fwrite(text.data(), 1, text.size(), stdout);
+	return summary.Failed == 0 ? 0 : 1;
+}
@@ -289,6 +289,42 @@ void DemoWindow::Data_OnToggleVisible(class Control* sender, MouseEventArgs e)
 	this->Invalidate();
 }
 
+void DemoWindow::Layout_OnShowWindowStats(class Control* sender, MouseEventArgs e)
+{
+	(void)sender;
+	(void)e;
+	if (!_layoutReport) return;
+	auto& stats = this->LastPaintStats();
+	std::wstring text = StringHelper::Format(L"本窗口上一帧：%d 个矩形，%lld 像素（外接矩形 %lld），缓冲区年龄 %u%s\r\n",
+		stats.Rects, stats.PaintedPixels, stats.BoundsPixels, stats.BufferAge, stats.Full ? L"，整窗重绘" : L"");
+	if (this->Render)
+	{
+		// 本窗口渲染目标的实际命中情况（自启动以来）
+		auto cache = this->Render->GetResourceCacheStats();
+		text += StringHelper::Format(L"资源缓存：画刷 %d/%d 项，命中 %d，未命中 %d；几何 %d/%d 项，命中 %d，未命中 %d\r\n",
+			(int)cache.Brushes.Count, (int)cache.Brushes.Capacity, (int)cache.Brushes.Hits, (int)cache.Brushes.Misses,
+			(int)cache.Geometries.Count, (int)cache.Geometries.Capacity, (int)cache.Geometries.Hits, (int)cache.Geometries.Misses);
+	}
+	// 本窗口的实际帧统计（自启动或上次切换模式以来）
+	auto frames = this->FrameStats();
+	text += StringHelper::Format(L"帧节拍（%s，刷新周期 %.2fms）：%d 请求，合并 %d，推迟 %d，%d 帧；绘制 平均 %.2fms P95 %.2fms 最大 %.2fms；延迟 平均 %.2fms 最大 %.2fms\r\n",
+		this->LowLatencyRendering() ? L"低延迟模式" : L"节拍模式", frames.RefreshInterval,
+		(int)frames.Requests, (int)frames.Coalesced, (int)frames.Deferred, (int)frames.Frames,
+		frames.AverageFrameTime, frames.P95FrameTime, frames.MaxFrameTime, frames.AverageLatency, frames.MaxLatency);
+	_layoutReport->Text = text;
+	_layoutReport->PostRender();
+}
+
+void DemoWindow::Layout_OnToggleLowLatency(class Control* sender, MouseEventArgs e)
+{
+	(void)e;
+	this->SetLowLatencyRendering(!this->LowLatencyRendering());
+	this->ResetFrameStats();
+	sender->Text = this->LowLatencyRendering() ? L"低延迟：开" : L"低延迟：关";
+	sender->PostRender();
+	Ui_UpdateStatus(this->LowLatencyRendering() ? L"已切换到低延迟绘制" : L"已切换到节拍绘制");
+}
+
 void DemoWindow::System_OnNotifyToggle(class Control* sender, MouseEventArgs e)
 {
 	(void)sender;
@@ -668,6 +704,14 @@ void DemoWindow::BuildTab_Layout(TabPage* page)
 	cd.CenterHorizontal = true;
 	cd.CenterVertical = true;
 	rp->SetConstraints(b, cd);
+
+	// 各单元的校验与基准由控制台程序 CUICheck 运行（CUICheck --bench），这里只显示本窗口的实时统计
+	page->AddControl(new Label(L"本窗口统计（校验与基准：CUICheck --bench）", 530, 260));
+	auto windowStats = page->AddControl(new Button(L"窗口统计", 530, 280, 120, 26));
+	windowStats->OnMouseClick += [this](class Control* sender, MouseEventArgs e) { this->Layout_OnShowWindowStats(sender, e); };
+	auto lowLatency = page->AddControl(new Button(L"低延迟：关", 660, 280, 120, 26));
+	lowLatency->OnMouseClick += [this](class Control* sender, MouseEventArgs e) { this->Layout_OnToggleLowLatency(sender, e); };
+	_layoutReport = page->AddControl(new RichTextBox(L"", 530, 312, 800, 250));
 }
 
 void DemoWindow::BuildTab_System(TabPage* page)
@@ -854,6 +898,29 @@ void DemoWindow::BuildTab_Media(TabPage* page)
 	CheckBox* loop = controlPanel->AddControl(new CheckBox(L"循环", 740, 16));
 	loop->OnChecked += [mp](class Control* sender) { mp->Loop = ((CheckBox*)sender)->Checked; };
 
+	// 播放统计快照：各阶段耗时 P50/P99、迟到/丢弃帧、音画偏差与音频欠载
+	Button* btnStats = controlPanel->AddControl(new Button(L"统计", 820, 10, 70, 30));
+	btnStats->OnMouseClick += [this, mp](class Control* sender, MouseEventArgs e)
+		{
+			(void)sender;
+			(void)e;
+			const PlaybackStats stats = mp->GetPlaybackStats();
+			Ui_UpdateStatus(StringHelper::Format(
+				L"读取 %.2f/%.2fms 转换 %.2f/%.2fms 上传 %.2f/%.2fms 呈现 %.2f/%.2fms | 帧 %llu 迟到 %llu 丢弃 %llu | 音画偏差 %.1fms (P99 %.1fms) | 欠载 %llu (%.1fms)",
+				stats.Read.PercentileMs(50), stats.Read.PercentileMs(99),
+				stats.Convert.PercentileMs(50), stats.Convert.PercentileMs(99),
+				stats.Upload.PercentileMs(50), stats.Upload.PercentileMs(99),
+				stats.Present.PercentileMs(50), stats.Present.PercentileMs(99),
+				(unsigned long long)stats.FramesPresented,
+				(unsigned long long)stats.FramesLate,
+				(unsigned long long)stats.FramesDropped,
+				stats.AvDriftMs,
+				stats.AvDrift.PercentileMs(99),
+				(unsigned long long)stats.AudioUnderruns,
+				stats.AudioStarvedMs));
+			mp->ResetPlaybackStats();
+		};
+
 	Label* progressLabel = controlPanel->AddControl(new Label(L"进度", 10, 84));
 	progressLabel->ForeColor = Colors::LightGray;
 
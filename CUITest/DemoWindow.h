@@ -30,6 +30,9 @@ private:
     void Data_OnToggleEnable(class Control* sender, MouseEventArgs e);
     void Data_OnToggleVisible(class Control* sender, MouseEventArgs e);
 
+    void Layout_OnShowWindowStats(class Control* sender, MouseEventArgs e);
+    void Layout_OnToggleLowLatency(class Control* sender, MouseEventArgs e);
+
     void System_OnNotifyToggle(class Control* sender, MouseEventArgs e);
     void System_OnBalloonTip(class Control* sender, MouseEventArgs e);
 
@@ -72,6 +75,9 @@ private:
     Switch* _gridEnableSwitch = nullptr;
     Switch* _gridVisibleSwitch = nullptr;
 
+    // Layout tab
+    RichTextBox* _layoutReport = nullptr;
+
     // Web/Media
     WebBrowser* _web = nullptr;
     MediaPlayer* _media = nullptr;
@@ -0,0 +1,326 @@
+#include "DisplayList.h"
+#include <cstring>
+
+namespace {
+	uint32_t FloatBits(float f) {
+		uint32_t u = 0;
+		std::memcpy(&u, &f, sizeof(u));
+		return u;
+	}
+
+	uint64_t ColorKey(const DisplayColor& c) {
+		uint64_t h = 1469598103934665603ull;
+		const uint32_t parts[4] = { FloatBits(c.r), FloatBits(c.g), FloatBits(c.b), FloatBits(c.a) };
+		for (uint32_t p : parts) {
+			h ^= p;
+			h *= 1099511628211ull;
+		}
+		return h;
+	}
+
+	bool SameColor(const DisplayColor& a, const DisplayColor& b) {
+		return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+	}
+
+	bool UsesColorPaint(const DisplayCommand& c) {
+		switch (c.Op) {
+		case DisplayOp::PushClip:
+		case DisplayOp::PopClip:
+		case DisplayOp::SetTransform:
+		case DisplayOp::SetAntialias:
+		case DisplayOp::SetTextAntialias:
+		case DisplayOp::DrawBitmap:
+		case DisplayOp::DrawSurface:
+			return false;
+		default:
+			return (c.Flags & DisplayFlagBrushResource) == 0;
+		}
+	}
+
+	bool UsesPaint2(const DisplayCommand& c) {
+		return (c.Flags & (DisplayFlagOutlined | DisplayFlagTextEffect)) != 0;
+	}
+}
+
+const uint32_t DisplayList::NoResource;
+
+DisplayList::DisplayList() {
+	_resources.push_back(nullptr);
+}
+
+void DisplayList::Reset() {
+	_commands.clear();
+	_palette.clear();
+	_strings.clear();
+	_floats.clear();
+	_resources.clear();
+	_resources.push_back(nullptr);
+	_paletteLookup.clear();
+	_resourceLookup.clear();
+}
+
+uint32_t DisplayList::AddColor(const DisplayColor& c) {
+	auto& bucket = _paletteLookup[ColorKey(c)];
+	for (uint32_t index : bucket) {
+		if (SameColor(_palette[index], c)) return index;
+	}
+	uint32_t index = (uint32_t)_palette.size();
+	_palette.push_back(c);
+	bucket.push_back(index);
+	return index;
+}
+
+uint32_t DisplayList::AddString(const std::wstring& s) {
+	// 相邻命令经常重复同一字符串（描边文字、重复标签），只与最后一个比较
+	if (!_strings.empty() && _strings.back() == s)
+		return (uint32_t)_strings.size() - 1;
+	_strings.push_back(s);
+	return (uint32_t)_strings.size() - 1;
+}
+
+uint32_t DisplayList::AddFloats(const float* values, size_t count) {
+	uint32_t index = (uint32_t)_floats.size();
+	_floats.insert(_floats.end(), values, values + count);
+	return index;
+}
+
+uint32_t DisplayList::AddResource(const std::shared_ptr<void>& handle) {
+	if (!handle) return NoResource;
+	auto it = _resourceLookup.find(handle.get());
+	if (it != _resourceLookup.end()) return it->second;
+	uint32_t index = (uint32_t)_resources.size();
+	_resources.push_back(handle);
+	_resourceLookup[handle.get()] = index;
+	return index;
+}
+
+size_t DisplayList::FloatCount(const DisplayList& list, const DisplayCommand& c) {
+	(void)list;
+	switch (c.Op) {
+	case DisplayOp::SetTransform:
+		return 6;
+	case DisplayOp::FillPolygon:
+	case DisplayOp::DrawPolygon:
+		return (size_t)c.Count * 2;
+	case DisplayOp::DrawBitmap:
+	case DisplayOp::FillOpacityMask:
+		return (c.Flags & DisplayFlagSource) ? 4 : 0;
+	default:
+		return 0;
+	}
+}
+
+void DisplayList::Append(const DisplayList& other) {
+	if (&other == this) {
+		DisplayList copy = other;
+		Append(copy);
+		return;
+	}
+	std::vector<uint32_t> resourceMap(other._resources.size(), NoResource);
+	for (size_t i = 1; i < other._resources.size(); i++)
+		resourceMap[i] = AddResource(other._resources[i]);
+
+	_commands.reserve(_commands.size() + other._commands.size());
+	for (const auto& src : other._commands) {
+		DisplayCommand c = src;
+		if (c.Flags & DisplayFlagBrushResource)
+			c.Paint = resourceMap[src.Paint];
+		else if (UsesColorPaint(src))
+			c.Paint = AddColor(other._palette[src.Paint]);
+		if (UsesPaint2(src))
+			c.Paint2 = AddColor(other._palette[src.Paint2]);
+		c.Resource = resourceMap[src.Resource];
+		if (src.Op == DisplayOp::DrawString)
+			c.Data = AddString(other._strings[src.Data]);
+		size_t floats = FloatCount(other, src);
+		if (floats > 0)
+			c.Data = AddFloats(other._floats.data() + src.Data, floats);
+		_commands.push_back(c);
+	}
+}
+
+void DisplayList::Clear(const DisplayColor& color) {
+	DisplayCommand c;
+	c.Op = DisplayOp::Clear;
+	c.Paint = AddColor(color);
+	Push(c);
+}
+
+void DisplayList::PushClip(const DisplayRect& rect) {
+	DisplayCommand c;
+	c.Op = DisplayOp::PushClip;
+	c.X = rect.left; c.Y = rect.top; c.Z = rect.right; c.W = rect.bottom;
+	Push(c);
+}
+
+void DisplayList::PopClip() {
+	DisplayCommand c;
+	c.Op = DisplayOp::PopClip;
+	Push(c);
+}
+
+void DisplayList::SetTransform(const float matrix[6]) {
+	DisplayCommand c;
+	c.Op = DisplayOp::SetTransform;
+	c.Data = AddFloats(matrix, 6);
+	Push(c);
+}
+
+void DisplayList::FillRect(const DisplayRect& rect, const DisplayColor& color) {
+	DisplayCommand c;
+	c.Op = DisplayOp::FillRect;
+	c.Paint = AddColor(color);
+	c.X = rect.left; c.Y = rect.top; c.Z = rect.right; c.W = rect.bottom;
+	Push(c);
+}
+
+void DisplayList::DrawRect(const DisplayRect& rect, const DisplayColor& color, float lineWidth) {
+	DisplayCommand c;
+	c.Op = DisplayOp::DrawRect;
+	c.Paint = AddColor(color);
+	c.X = rect.left; c.Y = rect.top; c.Z = rect.right; c.W = rect.bottom;
+	c.A = lineWidth;
+	Push(c);
+}
+
+void DisplayList::FillRoundRect(const DisplayRect& rect, const DisplayColor& color, float radius) {
+	DisplayCommand c;
+	c.Op = DisplayOp::FillRoundRect;
+	c.Paint = AddColor(color);
+	c.X = rect.left; c.Y = rect.top; c.Z = rect.right; c.W = rect.bottom;
+	c.B = radius;
+	Push(c);
+}
+
+void DisplayList::DrawRoundRect(const DisplayRect& rect, const DisplayColor& color, float lineWidth, float radius) {
+	DisplayCommand c;
+	c.Op = DisplayOp::DrawRoundRect;
+	c.Paint = AddColor(color);
+	c.X = rect.left; c.Y = rect.top; c.Z = rect.right; c.W = rect.bottom;
+	c.A = lineWidth;
+	c.B = radius;
+	Push(c);
+}
+
+void DisplayList::FillEllipse(float cx, float cy, float rx, float ry, const DisplayColor& color) {
+	DisplayCommand c;
+	c.Op = DisplayOp::FillEllipse;
+	c.Paint = AddColor(color);
+	c.X = cx; c.Y = cy; c.Z = rx; c.W = ry;
+	Push(c);
+}
+
+void DisplayList::DrawEllipse(float cx, float cy, float rx, float ry, const DisplayColor& color, float lineWidth) {
+	DisplayCommand c;
+	c.Op = DisplayOp::DrawEllipse;
+	c.Paint = AddColor(color);
+	c.X = cx; c.Y = cy; c.Z = rx; c.W = ry;
+	c.A = lineWidth;
+	Push(c);
+}
+
+void DisplayList::DrawLine(float x1, float y1, float x2, float y2, const DisplayColor& color, float lineWidth) {
+	DisplayCommand c;
+	c.Op = DisplayOp::DrawLine;
+	c.Paint = AddColor(color);
+	c.X = x1; c.Y = y1; c.Z = x2; c.W = y2;
+	c.A = lineWidth;
+	Push(c);
+}
+
+void DisplayList::DrawString(const std::wstring& text, float x, float y, const DisplayColor& color, uint32_t font) {
+	DisplayCommand c;
+	c.Op = DisplayOp::DrawString;
+	c.Paint = AddColor(color);
+	c.Data = AddString(text);
+	c.Resource = font;
+	c.X = x; c.Y = y;
+	Push(c);
+}
+
+bool DisplayList::IsDrawOp(DisplayOp op) {
+	switch (op) {
+	case DisplayOp::PushClip:
+	case DisplayOp::PopClip:
+	case DisplayOp::SetTransform:
+	case DisplayOp::SetAntialias:
+	case DisplayOp::SetTextAntialias:
+		return false;
+	default:
+		return true;
+	}
+}
+
+size_t DisplayList::CountOf(DisplayOp op) const {
+	size_t n = 0;
+	for (const auto& c : _commands)
+		if (c.Op == op) n++;
+	return n;
+}
+
+size_t DisplayList::DrawCallCount() const {
+	size_t n = 0;
+	for (const auto& c : _commands)
+		if (IsDrawOp(c.Op)) n++;
+	return n;
+}
+
+bool DisplayList::SameBatch(const DisplayCommand& a, const DisplayCommand& b) {
+	if (a.Op != b.Op) return false;
+	if (a.Op != DisplayOp::FillRect && a.Op != DisplayOp::DrawRect) return false;
+	return a.Flags == b.Flags && a.Paint == b.Paint;
+}
+
+size_t DisplayList::BatchCount() const {
+	size_t batches = 0;
+	const DisplayCommand* prev = nullptr;
+	for (const auto& c : _commands) {
+		if (!IsDrawOp(c.Op)) {
+			// 裁剪/变换会改变后续命令的状态，不跨越它们合批
+			prev = nullptr;
+			continue;
+		}
+		if (!prev || !SameBatch(*prev, c))
+			batches++;
+		prev = &c;
+	}
+	return batches;
+}
+
+size_t DisplayList::MemoryBytes() const {
+	size_t bytes = _commands.size() * sizeof(DisplayCommand)
+		+ _palette.size() * sizeof(DisplayColor)
+		+ _floats.size() * sizeof(float)
+		+ _resources.size() * sizeof(std::shared_ptr<void>);
+	for (const auto& s : _strings)
+		bytes += sizeof(std::wstring) + s.size() * sizeof(wchar_t);
+	return bytes;
+}
+
+bool DisplayList::SameCommand(const DisplayList& la, const DisplayCommand& a, const DisplayList& lb, const DisplayCommand& b) {
+	if (a.Op != b.Op || a.Flags != b.Flags || a.Mode != b.Mode || a.Count != b.Count) return false;
+	if (a.X != b.X || a.Y != b.Y || a.Z != b.Z || a.W != b.W || a.A != b.A || a.B != b.B) return false;
+	if (la.Resource(a.Resource) != lb.Resource(b.Resource)) return false;
+	if (a.Flags & DisplayFlagBrushResource) {
+		if (la.Resource(a.Paint) != lb.Resource(b.Paint)) return false;
+	}
+	else if (UsesColorPaint(a)) {
+		if (!SameColor(la._palette[a.Paint], lb._palette[b.Paint])) return false;
+	}
+	if (UsesPaint2(a) && !SameColor(la._palette[a.Paint2], lb._palette[b.Paint2])) return false;
+	if (a.Op == DisplayOp::DrawString)
+		return la._strings[a.Data] == lb._strings[b.Data];
+	size_t floats = FloatCount(la, a);
+	if (floats > 0)
+		return std::memcmp(la._floats.data() + a.Data, lb._floats.data() + b.Data, floats * sizeof(float)) == 0;
+	// 文本效果范围直接存于 Data/Count
+	return a.Data == b.Data;
+}
+
+bool DisplayList::Equals(const DisplayList& other) const {
+	if (_commands.size() != other._commands.size()) return false;
+	for (size_t i = 0; i < _commands.size(); i++) {
+		if (!SameCommand(*this, _commands[i], other, other._commands[i])) return false;
+	}
+	return true;
+}
@@ -0,0 +1,202 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file DisplayList.h
+ * @brief DisplayList：与后端无关的绘制命令列表。
+ *
+ * D2DGraphics 处于录制状态时，每个绘制调用除了照常绘制外，还会追加一条命令到这里；
+ * D2DGraphics::Replay 可以在之后原样回放（未变化的控件不必重新执行 Update）。
+ *
+ * 本文件不依赖 Win32/D2D，可在任意平台构造与检查（断言绘制结果与绘制调用次数）：
+ * - 颜色进入调色板、字符串/浮点数组进入各自的池，命令只保存下标（每条命令 48 字节）
+ * - 位图、画刷、几何、文本布局、字体等后端对象以不透明句柄保存在资源表中，
+ *   由录制方通过 shared_ptr 的删除器持有引用（D2D 对象 AddRef/Release）
+ */
+
+/** @brief 颜色（与 D2D1_COLOR_F 布局一致）。 */
+struct DisplayColor
+{
+	float r = 0.0f;
+	float g = 0.0f;
+	float b = 0.0f;
+	float a = 0.0f;
+};
+
+/** @brief 矩形（与 D2D1_RECT_F 布局一致）。 */
+struct DisplayRect
+{
+	float left = 0.0f;
+	float top = 0.0f;
+	float right = 0.0f;
+	float bottom = 0.0f;
+};
+
+enum class DisplayOp : uint8_t
+{
+	// 状态
+	Clear,
+	PushClip,
+	PopClip,
+	SetTransform,
+	SetAntialias,
+	SetTextAntialias,
+	// 基本图形
+	FillRect,
+	DrawRect,
+	FillRoundRect,
+	DrawRoundRect,
+	FillEllipse,
+	DrawEllipse,
+	DrawLine,
+	FillPolygon,
+	DrawPolygon,
+	FillPie,
+	DrawArc,
+	// 资源
+	FillGeometry,
+	DrawGeometry,
+	FillMesh,
+	FillOpacityMask,
+	DrawBitmap,
+	DrawSurface,
+	// 文本（不用 DrawText 命名：Win32 头文件把它定义为宏）
+	DrawString,
+	DrawStringLayout,
+};
+
+/** @brief 命令标志位。 */
+enum DisplayFlags : uint8_t
+{
+	DisplayFlagNone = 0,
+	/** @brief Paint 是资源下标（外部画刷），否则是调色板下标。 */
+	DisplayFlagBrushResource = 1 << 0,
+	/** @brief 文本以 (X, Y) 为中心绘制。 */
+	DisplayFlagCentered = 1 << 1,
+	/** @brief 文本带轮廓，Paint2 为轮廓颜色。 */
+	DisplayFlagOutlined = 1 << 2,
+	/** @brief 圆弧逆时针。 */
+	DisplayFlagCounter = 1 << 3,
+	/** @brief 文本在宽 Z、高 W 的矩形内排版（否则不限宽高）。 */
+	DisplayFlagBounded = 1 << 4,
+	/** @brief 带源矩形（位图/遮罩），Data 为浮点池下标。 */
+	DisplayFlagSource = 1 << 5,
+	/** @brief 文本布局带背景效果，Data/Count 为文字范围，Paint2 为背景颜色。 */
+	DisplayFlagTextEffect = 1 << 6,
+};
+
+/**
+ * @brief 单条绘制命令。
+ *
+ * 几何字段按命令解释：
+ * - 矩形类：X/Y/Z/W = left/top/right/bottom，A = 线宽，B = 圆角
+ * - 椭圆：X/Y = 圆心，Z/W = 半径，A = 线宽
+ * - 直线：X/Y → Z/W，A = 线宽
+ * - 饼图：X/Y = 圆心，Z/W = 宽高，A/B = 起始角/扫过角
+ * - 圆弧：X/Y = 圆心，Z = 半径，A/B = 起止角，W = 线宽
+ * - 位图：X/Y/Z/W = 目标矩形，A = 不透明度
+ * - 文本：X/Y（Bounded 时 Z/W 为排版宽高），Data = 字符串下标，Resource = 字体
+ */
+struct DisplayCommand
+{
+	DisplayOp Op = DisplayOp::Clear;
+	uint8_t Flags = DisplayFlagNone;
+	uint16_t Mode = 0;
+	uint32_t Paint = 0;
+	uint32_t Paint2 = 0;
+	uint32_t Data = 0;
+	uint32_t Count = 0;
+	uint32_t Resource = 0;
+	float X = 0.0f, Y = 0.0f, Z = 0.0f, W = 0.0f;
+	float A = 0.0f, B = 0.0f;
+};
+
+class DisplayList
+{
+public:
+	/** @brief 资源下标 0 保留为“无”。 */
+	static const uint32_t NoResource = 0;
+
+	DisplayList();
+
+	void Reset();
+	bool IsEmpty() const { return _commands.empty(); }
+	size_t Count() const { return _commands.size(); }
+	const std::vector<DisplayCommand>& Commands() const { return _commands; }
+	const DisplayCommand& operator[](size_t i) const { return _commands[i]; }
+
+	// ---- 池 ----
+	uint32_t AddColor(const DisplayColor& c);
+	uint32_t AddString(const std::wstring& s);
+	uint32_t AddFloats(const float* values, size_t count);
+	/**
+	 * @brief 登记后端资源；同一句柄只登记一次。
+	 * @param handle 持有资源引用的 shared_ptr（删除器负责释放）；空指针返回 NoResource。
+	 */
+	uint32_t AddResource(const std::shared_ptr<void>& handle);
+
+	const DisplayColor& Color(uint32_t index) const { return _palette[index]; }
+	const std::wstring& String(uint32_t index) const { return _strings[index]; }
+	const float* Floats(uint32_t index) const { return _floats.data() + index; }
+	void* Resource(uint32_t index) const { return index < _resources.size() ? _resources[index].get() : nullptr; }
+	size_t PaletteSize() const { return _palette.size(); }
+	size_t ResourceCount() const { return _resources.size() - 1; }
+
+	// ---- 录制 ----
+	void Push(const DisplayCommand& cmd) { _commands.push_back(cmd); }
+	/** @brief 追加另一个列表（重新映射调色板/字符串/资源下标）。 */
+	void Append(const DisplayList& other);
+
+	void Clear(const DisplayColor& color);
+	void PushClip(const DisplayRect& rect);
+	void PopClip();
+	/** @brief 3x2 仿射矩阵（m11, m12, m21, m22, dx, dy）。 */
+	void SetTransform(const float matrix[6]);
+	void FillRect(const DisplayRect& rect, const DisplayColor& color);
+	void DrawRect(const DisplayRect& rect, const DisplayColor& color, float lineWidth = 1.0f);
+	void FillRoundRect(const DisplayRect& rect, const DisplayColor& color, float radius);
+	void DrawRoundRect(const DisplayRect& rect, const DisplayColor& color, float lineWidth, float radius);
+	void FillEllipse(float cx, float cy, float rx, float ry, const DisplayColor& color);
+	void DrawEllipse(float cx, float cy, float rx, float ry, const DisplayColor& color, float lineWidth = 1.0f);
+	void DrawLine(float x1, float y1, float x2, float y2, const DisplayColor& color, float lineWidth = 1.0f);
+	/** @param font 字体句柄（NoResource 表示默认字体）。 */
+	void DrawString(const std::wstring& text, float x, float y, const DisplayColor& color, uint32_t font = NoResource);
+
+	// ---- 检查 ----
+	/** @brief 指定类型的命令数量。 */
+	size_t CountOf(DisplayOp op) const;
+	/** @brief 实际绘制的命令数量（不含裁剪/变换等状态命令）。 */
+	size_t DrawCallCount() const;
+	/**
+	 * @brief 回放时的批次数：连续、同类型、同颜色的 FillRect/DrawRect 合为一批，
+	 * 回放时共用一次画刷设置。其余绘制命令各算一批。
+	 */
+	size_t BatchCount() const;
+	/** @brief 两条 FillRect/DrawRect 命令能否在同一批中回放。 */
+	static bool SameBatch(const DisplayCommand& a, const DisplayCommand& b);
+	/** @brief 命令与池占用的字节数（不含资源本身）。 */
+	size_t MemoryBytes() const;
+
+	/** @brief 逐命令比较（颜色/字符串/点按值比较，资源按句柄比较）。 */
+	bool Equals(const DisplayList& other) const;
+	bool operator==(const DisplayList& other) const { return Equals(other); }
+	bool operator!=(const DisplayList& other) const { return !Equals(other); }
+
+private:
+	std::vector<DisplayCommand> _commands;
+	std::vector<DisplayColor> _palette;
+	std::vector<std::wstring> _strings;
+	std::vector<float> _floats;
+	std::vector<std::shared_ptr<void>> _resources;
+	std::map<uint64_t, std::vector<uint32_t>> _paletteLookup;
+	std::unordered_map<const void*, uint32_t> _resourceLookup;
+
+	static bool IsDrawOp(DisplayOp op);
+	static bool SameCommand(const DisplayList& la, const DisplayCommand& a, const DisplayList& lb, const DisplayCommand& b);
+	static size_t FloatCount(const DisplayList& list, const DisplayCommand& c);
+};
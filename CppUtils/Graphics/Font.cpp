@@ -1,5 +1,6 @@
 ﻿#include "Font.h"
 #include "Factory.h"
+#include "TextLayoutCache.h"
 #include <dwrite_3.h>
 
 #pragma warning(disable: 4267)
@@ -24,6 +25,7 @@ Font::Font(std::wstring fontFamilyName, float _fontsize) {
 	this->FontHeight = this->GetTextSize(L"I", FLT_MAX, FLT_MAX).height;
 }
 Font::~Font() {
+	TextLayoutCache::Shared().Purge(this->_fontObject);
 	if (this->_fontObject) this->_fontObject->Release();
 }
 GET_CPP(Font, IDWriteTextFormat*, FontObject) {
@@ -34,6 +36,7 @@ GET_CPP(Font, float, FontSize) {
 }
 SET_CPP(Font, float, FontSize) {
 	if (value != this->_fontSize && this->_fontObject) {
+		TextLayoutCache::Shared().Purge(this->_fontObject);
 		this->_fontObject->Release();
 		this->_fontObject = NULL;
 		_DWriteFactory->CreateTextFormat(
@@ -54,6 +57,7 @@ GET_CPP(Font, std::wstring, FontName) {
 }
 SET_CPP(Font, std::wstring, FontName) {
 	if (value != this->_fontName && this->_fontObject) {
+		TextLayoutCache::Shared().Purge(this->_fontObject);
 		this->_fontObject->Release();
 		this->_fontObject = NULL;
 		_DWriteFactory->CreateTextFormat(
@@ -70,19 +74,8 @@ SET_CPP(Font, std::wstring, FontName) {
 	this->FontHeight = this->GetTextSize(L"I", FLT_MAX, FLT_MAX).height;
 }
 D2D1_SIZE_F Font::GetTextSize(std::wstring str, float w, float h) {
-	D2D1_SIZE_F minSize = { 0,0 };
-	IDWriteTextLayout* textLayout = 0;
-	HRESULT hr = _DWriteFactory->CreateTextLayout(str.c_str(), str.size(), this->_fontObject, w, h, &textLayout);
-	if SUCCEEDED(hr) {
-		DWRITE_TEXT_METRICS metrics;
-		hr = textLayout->GetMetrics(&metrics);
-		textLayout->Release();
-		if SUCCEEDED(hr) {
-			minSize = D2D1::Size((float)ceil(metrics.widthIncludingTrailingWhitespace), (float)ceil(metrics.height));
-			return minSize;
-		}
-	}
-	return { 0,0 };
+	// 同一文本/宽高只排版一次（TextLayoutCache 保存布局与尺寸）
+	return TextLayoutCache::Shared().Measure(str.c_str(), str.size(), this->_fontObject, w, h);
 }
 D2D1_SIZE_F Font::GetTextSize(IDWriteTextLayout* textLayout) {
 	D2D1_SIZE_F minSize = { 0,0 };
@@ -97,44 +90,28 @@ D2D1_SIZE_F Font::GetTextSize(IDWriteTextLayout* textLayout) {
 	return { 0,0 };
 }
 D2D1_SIZE_F Font::GetTextSize(wchar_t c) {
-	D2D1_SIZE_F minSize = { 0,0 };
-	IDWriteTextLayout* textLayout = 0;
-	HRESULT hr = _DWriteFactory->CreateTextLayout(&c, 1, this->_fontObject, FLT_MAX, FLT_MAX, &textLayout);
-	if SUCCEEDED(hr) {
-		DWRITE_TEXT_METRICS metrics;
-		hr = textLayout->GetMetrics(&metrics);
-		textLayout->Release();
-		if SUCCEEDED(hr) {
-			minSize = D2D1::Size((float)ceil(metrics.widthIncludingTrailingWhitespace), (float)ceil(metrics.height));
-			return minSize;
-		}
-	}
-	return { 0,0 };
+	return TextLayoutCache::Shared().Measure(&c, 1, this->_fontObject, FLT_MAX, FLT_MAX);
 }
 int Font::HitTestTextPosition(std::wstring str, float x, float y) {
 	if (str.size() == 0) return -1;
-	IDWriteTextLayout* textLayout = NULL;
-	HRESULT hr = _DWriteFactory->CreateTextLayout(str.c_str(),str.size(),this->_fontObject,FLT_MAX,FLT_MAX,&textLayout);
-	if FAILED(hr)
+	auto textLayout = TextLayoutCache::Shared().Get(str, this->_fontObject, FLT_MAX, FLT_MAX);
+	if (!textLayout)
 		return -1;
 	BOOL isTrailingHit;
 	BOOL isInside;
 	DWRITE_HIT_TEST_METRICS caretMetrics;
 	textLayout->HitTestPoint(x, y,&isTrailingHit,&isInside,&caretMetrics);
-	textLayout->Release();
 	return isTrailingHit ? caretMetrics.textPosition + 1 : caretMetrics.textPosition;
 }
 int Font::HitTestTextPosition(std::wstring str, float width, float height, float x, float y) {
 	if (str.size() == 0) return -1;
-	IDWriteTextLayout* textLayout = NULL;
-	HRESULT hr = _DWriteFactory->CreateTextLayout(str.c_str(), str.size(),this->_fontObject,width, height,&textLayout);
-	if FAILED(hr)
+	auto textLayout = TextLayoutCache::Shared().Get(str, this->_fontObject, width, height);
+	if (!textLayout)
 		return -1;
 	BOOL isTrailingHit;
 	BOOL isInside;
 	DWRITE_HIT_TEST_METRICS caretMetrics;
 	textLayout->HitTestPoint(x, y,&isTrailingHit,&isInside,&caretMetrics);
-	textLayout->Release();
 	if (caretMetrics.width > 0.0f && x - caretMetrics.left >= caretMetrics.width * 0.5f)
 		caretMetrics.textPosition += 1;
 	return caretMetrics.textPosition;
@@ -160,15 +137,12 @@ int Font::HitTestTextPosition(IDWriteTextLayout* textLayout, float width, float
 }
 std::vector<DWRITE_HIT_TEST_METRICS> Font::HitTestTextRange(std::wstring str, UINT32 start, UINT32 len) {
 	std::vector<DWRITE_HIT_TEST_METRICS> hitTestMetrics;
-	IDWriteTextLayout* textLayout = NULL;
-	HRESULT hr = _DWriteFactory->CreateTextLayout(str.c_str(),str.size(),this->_fontObject,FLT_MAX,FLT_MAX,&textLayout);
-	if SUCCEEDED(hr) {
+	auto textLayout = TextLayoutCache::Shared().Get(str, this->_fontObject, FLT_MAX, FLT_MAX);
+	if (textLayout) {
 		UINT32 actualHitTestCount = 0;
-		hr = textLayout->HitTestTextRange(start, len,0.0f, 0.0f,NULL, 0,&actualHitTestCount);
+		HRESULT hr = textLayout->HitTestTextRange(start, len,0.0f, 0.0f,NULL, 0,&actualHitTestCount);
 		hitTestMetrics.resize(actualHitTestCount);
-		UINT32 textLen = len;
 		hr = textLayout->HitTestTextRange(start, len,0.0f, 0.0f,hitTestMetrics.data(),hitTestMetrics.size(),&actualHitTestCount);
-		textLayout->Release();
 	}
 	return hitTestMetrics;
 }
@@ -1,4 +1,5 @@
 #include "Graphics.h"
+#include "TextLayoutCache.h"
 
 #include <algorithm>
 #include <cfloat>
@@ -209,6 +210,130 @@ namespace {
 		static Font* defaultFont = new Font(L"Arial", 18.0f);
 		return defaultFont;
 	}
+
+	// DrawString 系列使用的共享布局：内容不变的文本不再每帧排版（布局只读，不做任何修改）
+	ComPtr<IDWriteTextLayout> CachedStringLayout(const std::wstring& str, float width, float height, Font* font,
+		D2D1_SIZE_F* size = nullptr) {
+		Font* resolvedFont = font ? font : DefaultFontObject1();
+		if (!resolvedFont) return nullptr;
+		return TextLayoutCache::Shared().Get(str, resolvedFont->FontObject, width, height, size);
+	}
+
+	// ---- DisplayList 录制辅助 ----
+
+	// 资源句柄：录制期间持有一次引用，列表释放时 Release
+	template <class T>
+	std::shared_ptr<void> ComHandle(T* p) {
+		if (!p) return nullptr;
+		p->AddRef();
+		return std::shared_ptr<void>(p, [](void* q) { static_cast<T*>(q)->Release(); });
+	}
+
+	// 字体由控件/全局持有，列表只引用
+	std::shared_ptr<void> FontHandle(Font* font) {
+		if (!font) return nullptr;
+		return std::shared_ptr<void>(font, [](void*) {});
+	}
+
+	DisplayColor ToDisplayColor(D2D1_COLOR_F c) {
+		return DisplayColor{ c.r, c.g, c.b, c.a };
+	}
+
+	D2D1_COLOR_F ToD2DColor(const DisplayColor& c) {
+		return D2D1_COLOR_F{ c.r, c.g, c.b, c.a };
+	}
+
+	// 颜色或外部画刷
+	struct RecordedPaint {
+		RecordedPaint(D2D1_COLOR_F c) : color(c) {}
+		RecordedPaint(ID2D1Brush* b) : brush(b) {}
+		D2D1_COLOR_F color{};
+		ID2D1Brush* brush = nullptr;
+	};
+
+	void ApplyPaint(DisplayList* rec, DisplayCommand& c, const RecordedPaint& paint) {
+		if (!paint.brush) {
+			c.Paint = rec->AddColor(ToDisplayColor(paint.color));
+			return;
+		}
+		// 纯色画刷（包括 GetColorBrush 返回的共享画刷）按当前颜色录制：画刷之后可能被改色
+		ComPtr<ID2D1SolidColorBrush> solid;
+		if (SUCCEEDED(paint.brush->QueryInterface(IID_PPV_ARGS(&solid))) && solid && paint.brush->GetOpacity() == 1.0f) {
+			c.Paint = rec->AddColor(ToDisplayColor(solid->GetColor()));
+			return;
+		}
+		c.Flags |= DisplayFlagBrushResource;
+		c.Paint = rec->AddResource(ComHandle(paint.brush));
+	}
+
+	void RecordShape(DisplayList* rec, DisplayOp op, const RecordedPaint& paint,
+		float x, float y, float z, float w, float a = 0.0f, float b = 0.0f, uint8_t flags = DisplayFlagNone) {
+		DisplayCommand c;
+		c.Op = op;
+		c.Flags = flags;
+		ApplyPaint(rec, c, paint);
+		c.X = x; c.Y = y; c.Z = z; c.W = w;
+		c.A = a; c.B = b;
+		rec->Push(c);
+	}
+
+	void RecordPoints(DisplayList* rec, DisplayOp op, const D2D1_POINT_2F* points, size_t count, D2D1_COLOR_F color, float width) {
+		DisplayCommand c;
+		c.Op = op;
+		c.Paint = rec->AddColor(ToDisplayColor(color));
+		c.Data = rec->AddFloats(reinterpret_cast<const float*>(points), count * 2);
+		c.Count = (uint32_t)count;
+		c.A = width;
+		rec->Push(c);
+	}
+
+	void RecordResource(DisplayList* rec, DisplayOp op, std::shared_ptr<void> handle, const RecordedPaint* paint,
+		D2D1_RECT_F dest, float a = 0.0f, const D2D1_RECT_F* src = nullptr, uint16_t mode = 0) {
+		DisplayCommand c;
+		c.Op = op;
+		c.Mode = mode;
+		c.Resource = rec->AddResource(handle);
+		if (paint) ApplyPaint(rec, c, *paint);
+		c.X = dest.left; c.Y = dest.top; c.Z = dest.right; c.W = dest.bottom;
+		c.A = a;
+		if (src) {
+			const float f[4] = { src->left, src->top, src->right, src->bottom };
+			c.Flags |= DisplayFlagSource;
+			c.Data = rec->AddFloats(f, 4);
+		}
+		rec->Push(c);
+	}
+
+	void RecordString(DisplayList* rec, const std::wstring& str, float x, float y, float w, float h,
+		const RecordedPaint& paint, Font* font, uint8_t flags, D2D1_COLOR_F outline = D2D1_COLOR_F{}) {
+		DisplayCommand c;
+		c.Op = DisplayOp::DrawString;
+		c.Flags = flags;
+		ApplyPaint(rec, c, paint);
+		if (flags & DisplayFlagOutlined)
+			c.Paint2 = rec->AddColor(ToDisplayColor(outline));
+		c.Data = rec->AddString(str);
+		c.Resource = rec->AddResource(FontHandle(font));
+		c.X = x; c.Y = y; c.Z = w; c.W = h;
+		rec->Push(c);
+	}
+
+	void RecordLayout(DisplayList* rec, IDWriteTextLayout* layout, float x, float y, const RecordedPaint& paint,
+		uint8_t flags, D2D1_COLOR_F color2 = D2D1_COLOR_F{}, DWRITE_TEXT_RANGE range = DWRITE_TEXT_RANGE{ 0, 0 }) {
+		DisplayCommand c;
+		c.Op = DisplayOp::DrawStringLayout;
+		c.Flags = flags;
+		ApplyPaint(rec, c, paint);
+		if (flags & (DisplayFlagOutlined | DisplayFlagTextEffect))
+			c.Paint2 = rec->AddColor(ToDisplayColor(color2));
+		if (flags & DisplayFlagTextEffect) {
+			c.Data = range.startPosition;
+			c.Count = range.length;
+		}
+		c.Resource = rec->AddResource(ComHandle(layout));
+		c.X = x; c.Y = y;
+		rec->Push(c);
+	}
 }
 
 D2DGraphics::D2DGraphics() = default;
@@ -286,9 +411,11 @@ void D2DGraphics::ResetTarget() {
 	pWicTargetBitmap.Reset();
 	Default_Brush.Reset();
 	Default_Brush_Back.Reset();
+	_brushCache.Clear();
 
 	surfaceKind = SurfaceKind::None;
 	wicDirty = false;
+	_presentsSinceTargetReset = 0;
 }
 
 HRESULT D2DGraphics::ConfigDefaultObjects() {
@@ -361,9 +488,30 @@ HRESULT D2DGraphics::CreateTargetBitmapForSize(UINT width, UINT height, FLOAT dp
 
 	pTargetBitmap = bmp;
 	pDeviceContext->SetTarget(pTargetBitmap.Get());
+	_presentsSinceTargetReset = 0;
 	return S_OK;
 }
 
+UINT D2DGraphics::GetBackBufferAge() const {
+	switch (surfaceKind) {
+	case SurfaceKind::None:
+		return 0;
+	case SurfaceKind::Hwnd:
+	case SurfaceKind::DxgiSwapChain:
+	{
+		if (!pSwapChain) return 0;
+		DXGI_SWAP_CHAIN_DESC desc{};
+		if (FAILED(pSwapChain->GetDesc(&desc))) return 0;
+		// DISCARD/FLIP_DISCARD（含 Win7 回退路径）Present 后内容未定义
+		if (desc.SwapEffect != DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL) return 0;
+		if (desc.BufferCount == 0 || _presentsSinceTargetReset < desc.BufferCount) return 0;
+		return desc.BufferCount;
+	}
+	default:
+		return 1;
+	}
+}
+
 HRESULT D2DGraphics::InitializeWithSize(UINT width, UINT height, FLOAT dpiX, FLOAT dpiY, DXGI_FORMAT format, D2D1_ALPHA_MODE alphaMode) {
 	if (width == 0 || height == 0) {
 		return E_INVALIDARG;
@@ -579,7 +727,7 @@ void D2DGraphics::EndRender() {
 
 	if (surfaceKind == SurfaceKind::DxgiSwapChain && pSwapChain) {
 		// 忽略 present 的返回值（调用方可自行处理）
-		pSwapChain->Present(1, 0);
+		NotePresent(pSwapChain->Present(1, 0));
 	}
 
 	// 如果目标丢失，尝试重建（对 swapchain 特别常见）
@@ -618,6 +766,7 @@ void D2DGraphics::ReSize(UINT width, UINT height) {
 }
 
 void D2DGraphics::Clear(D2D1_COLOR_F color) {
+	if (auto* rec = Recorder()) RecordShape(rec, DisplayOp::Clear, color, 0, 0, 0, 0);
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	ctx->Clear(color);
@@ -625,14 +774,25 @@ void D2DGraphics::Clear(D2D1_COLOR_F color) {
 }
 
 ID2D1SolidColorBrush* D2DGraphics::GetColorBrush(D2D1_COLOR_F newcolor) {
-	if (!Default_Brush && pDeviceContext) {
-		if (FAILED(pDeviceContext->CreateSolidColorBrush(newcolor, Default_Brush.ReleaseAndGetAddressOf()))) {
-			return nullptr;
-		}
+	auto* ctx = pDeviceContext.Get();
+	if (!ctx) return nullptr;
+	// 每种颜色一支画刷：不再对同一画刷反复 SetColor，先取的画刷也不会被后一次调用改色
+	const float key[4] = { newcolor.r, newcolor.g, newcolor.b, newcolor.a };
+	if (auto* cached = _brushCache.Find(0, key, 4)) {
+		auto* brush = cached->Get();
+		// 调用方可能改过返回画刷的颜色/不透明度
+		D2D1_COLOR_F current = brush->GetColor();
+		if (current.r != newcolor.r || current.g != newcolor.g || current.b != newcolor.b || current.a != newcolor.a)
+			brush->SetColor(newcolor);
+		if (brush->GetOpacity() != 1.0f)
+			brush->SetOpacity(1.0f);
+		return brush;
+	}
+	ComPtr<ID2D1SolidColorBrush> brush;
+	if (FAILED(ctx->CreateSolidColorBrush(newcolor, &brush))) {
+		return nullptr;
 	}
-	if (!Default_Brush) return nullptr;
-	Default_Brush->SetColor(newcolor);
-	return Default_Brush.Get();
+	return _brushCache.Insert(0, key, 4, std::move(brush)).Get();
 }
 ID2D1SolidColorBrush* D2DGraphics::GetColorBrush(COLORREF newcolor) {
 	return GetColorBrush(D2D1_COLOR_F{ GetRValue(newcolor) * INV_255_1,GetGValue(newcolor) * INV_255_1,GetBValue(newcolor) * INV_255_1,1.0f });
@@ -664,9 +824,29 @@ ID2D1SolidColorBrush* D2DGraphics::GetBackColorBrush(float r, float g, float b,
 	return GetBackColorBrush(D2D1_COLOR_F{ r,g,b,a });
 }
 
+D2DGraphics::ResourceCacheInfo D2DGraphics::GetResourceCacheStats() const {
+	ResourceCacheInfo info;
+	info.Brushes = _brushCache.Stats();
+	info.Geometries = _geometryCache.Stats();
+	return info;
+}
+void D2DGraphics::ResetResourceCacheStats() {
+	_brushCache.ResetStats();
+	_geometryCache.ResetStats();
+}
+void D2DGraphics::SetResourceCacheCapacity(size_t brushes, size_t geometries) {
+	_brushCache.SetCapacity(brushes);
+	_geometryCache.SetCapacity(geometries);
+}
+void D2DGraphics::ClearResourceCaches() {
+	_brushCache.Clear();
+	_geometryCache.Clear();
+}
+
 // ---- 绘制/文本 API：基本沿用 Graphics.cpp（DeviceContext 继承 RenderTarget）----
 
 void D2DGraphics::DrawLine(D2D1_POINT_2F p1, D2D1_POINT_2F p2, D2D1_COLOR_F color, float linewidth) {
+	if (auto* rec = Recorder()) RecordShape(rec, DisplayOp::DrawLine, color, p1.x, p1.y, p2.x, p2.y, linewidth);
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
@@ -674,6 +854,7 @@ void D2DGraphics::DrawLine(D2D1_POINT_2F p1, D2D1_POINT_2F p2, D2D1_COLOR_F colo
 	ctx->DrawLine(p1, p2, brush, linewidth);
 }
 void D2DGraphics::DrawLine(D2D1_POINT_2F p1, D2D1_POINT_2F p2, ID2D1Brush* brush, float linewidth) {
+	if (auto* rec = Recorder()) { if (brush) RecordShape(rec, DisplayOp::DrawLine, brush, p1.x, p1.y, p2.x, p2.y, linewidth); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !brush) return;
 	ctx->DrawLine(p1, p2, brush, linewidth);
@@ -685,6 +866,7 @@ void D2DGraphics::DrawLine(float p1_x, float p1_y, float p2_x, float p2_y, ID2D1
 	DrawLine(D2D1::Point2F(p1_x, p1_y), D2D1::Point2F(p2_x, p2_y), brush, linewidth);
 }
 void D2DGraphics::DrawRect(D2D1_RECT_F rect, D2D1_COLOR_F color, float linewidth) {
+	if (auto* rec = Recorder()) RecordShape(rec, DisplayOp::DrawRect, color, rect.left, rect.top, rect.right, rect.bottom, linewidth);
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
@@ -695,6 +877,7 @@ void D2DGraphics::DrawRect(float left, float top, float width, float height, D2D
 	DrawRect(D2D1::RectF(left, top, left + width, top + height), color, linewidth);
 }
 void D2DGraphics::DrawRoundRect(D2D1_RECT_F rect, D2D1_COLOR_F color, float linewidth, float r) {
+	if (auto* rec = Recorder()) RecordShape(rec, DisplayOp::DrawRoundRect, color, rect.left, rect.top, rect.right, rect.bottom, linewidth, r);
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
@@ -705,6 +888,7 @@ void D2DGraphics::DrawRoundRect(float left, float top, float width, float height
 	DrawRoundRect(D2D1::RectF(left, top, left + width, top + height), color, linewidth, r);
 }
 void D2DGraphics::FillRect(D2D1_RECT_F rect, D2D1_COLOR_F color) {
+	if (auto* rec = Recorder()) RecordShape(rec, DisplayOp::FillRect, color, rect.left, rect.top, rect.right, rect.bottom);
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
@@ -713,6 +897,7 @@ void D2DGraphics::FillRect(D2D1_RECT_F rect, D2D1_COLOR_F color) {
 	wicDirty = true;
 }
 void D2DGraphics::FillRect(D2D1_RECT_F rect, ID2D1Brush* brush) {
+	if (auto* rec = Recorder()) { if (brush) RecordShape(rec, DisplayOp::FillRect, brush, rect.left, rect.top, rect.right, rect.bottom); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !brush) return;
 	ctx->FillRectangle(rect, brush);
@@ -725,6 +910,7 @@ void D2DGraphics::FillRect(float left, float top, float width, float height, ID2
 	FillRect(D2D1::RectF(left, top, left + width, top + height), brush);
 }
 void D2DGraphics::FillRoundRect(D2D1_RECT_F rect, D2D1_COLOR_F color, float r) {
+	if (auto* rec = Recorder()) RecordShape(rec, DisplayOp::FillRoundRect, color, rect.left, rect.top, rect.right, rect.bottom, 0.0f, r);
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
@@ -736,6 +922,7 @@ void D2DGraphics::FillRoundRect(float left, float top, float width, float height
 	FillRoundRect(D2D1::RectF(left, top, left + width, top + height), color, r);
 }
 void D2DGraphics::DrawEllipse(D2D1_POINT_2F cent, float xr, float yr, D2D1_COLOR_F color, float linewidth) {
+	if (auto* rec = Recorder()) RecordShape(rec, DisplayOp::DrawEllipse, color, cent.x, cent.y, xr, yr, linewidth);
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
@@ -746,6 +933,7 @@ void D2DGraphics::DrawEllipse(float x, float y, float xr, float yr, D2D1_COLOR_F
 	DrawEllipse(D2D1::Point2F(x, y), xr, yr, color, linewidth);
 }
 void D2DGraphics::FillEllipse(D2D1_POINT_2F cent, float xr, float yr, D2D1_COLOR_F color) {
+	if (auto* rec = Recorder()) RecordShape(rec, DisplayOp::FillEllipse, color, cent.x, cent.y, xr, yr);
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
@@ -757,6 +945,7 @@ void D2DGraphics::FillEllipse(float cx, float cy, float xr, float yr, D2D1_COLOR
 	FillEllipse(D2D1::Point2F(cx, cy), xr, yr, color);
 }
 void D2DGraphics::DrawGeometry(ID2D1Geometry* geo, D2D1_COLOR_F color, float linewidth) {
+	if (auto* rec = Recorder()) { RecordedPaint p(color); if (geo) RecordResource(rec, DisplayOp::DrawGeometry, ComHandle(geo), &p, D2D1_RECT_F{}, linewidth); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !geo) return;
 	auto brush = GetColorBrush(color);
@@ -764,11 +953,13 @@ void D2DGraphics::DrawGeometry(ID2D1Geometry* geo, D2D1_COLOR_F color, float lin
 	ctx->DrawGeometry(geo, brush, linewidth);
 }
 void D2DGraphics::DrawGeometry(ID2D1Geometry* geo, ID2D1Brush* brush, float linewidth) {
+	if (auto* rec = Recorder()) { RecordedPaint p(brush); if (geo && brush) RecordResource(rec, DisplayOp::DrawGeometry, ComHandle(geo), &p, D2D1_RECT_F{}, linewidth); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !geo || !brush) return;
 	ctx->DrawGeometry(geo, brush, linewidth);
 }
 void D2DGraphics::FillGeometry(ID2D1Geometry* geo, D2D1_COLOR_F color) {
+	if (auto* rec = Recorder()) { RecordedPaint p(color); if (geo) RecordResource(rec, DisplayOp::FillGeometry, ComHandle(geo), &p, D2D1_RECT_F{}); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !geo) return;
 	auto brush = GetColorBrush(color);
@@ -777,6 +968,7 @@ void D2DGraphics::FillGeometry(ID2D1Geometry* geo, D2D1_COLOR_F color) {
 	wicDirty = true;
 }
 void D2DGraphics::FillGeometry(ID2D1Geometry* geo, ID2D1Brush* brush) {
+	if (auto* rec = Recorder()) { RecordedPaint p(brush); if (geo && brush) RecordResource(rec, DisplayOp::FillGeometry, ComHandle(geo), &p, D2D1_RECT_F{}); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !geo || !brush) return;
 	ctx->FillGeometry(geo, brush);
@@ -784,6 +976,18 @@ void D2DGraphics::FillGeometry(ID2D1Geometry* geo, ID2D1Brush* brush) {
 }
 
 namespace {
+	// 几何缓存键的种类
+	enum GeometryKind : uint32_t {
+		GeometryPie = 1,
+		GeometryFilledPolygon,
+		GeometryOpenPolygon,
+		GeometryArc,
+		GeometryArcCounter,
+	};
+
+	// 顶点更多的多边形（曲线、波形）通常每帧都在变，不进入缓存
+	constexpr size_t MaxCachedPolygonPoints = 256;
+
 	// 辅助函数：创建饼图几何形状
 	ComPtr<ID2D1PathGeometry> CreatePieGeometry(D2D1_POINT_2F center, float width, float height,
 		float startAngle, float sweepAngle) {
@@ -808,56 +1012,131 @@ namespace {
 		sink->Close();
 		return geo;
 	}
+
+	// 填充时闭合，描边时为开放折线
+	ComPtr<ID2D1PathGeometry> CreatePolygonGeometry(const D2D1_POINT_2F* points, size_t count, bool filled) {
+		ComPtr<ID2D1PathGeometry> geo;
+		geo.Attach(Factory::CreateGeomtry());
+		if (!geo) return nullptr;
+		ComPtr<ID2D1GeometrySink> sink;
+		if (FAILED(geo->Open(&sink))) return nullptr;
+		sink->BeginFigure(points[0], filled ? D2D1_FIGURE_BEGIN_FILLED : D2D1_FIGURE_BEGIN_HOLLOW);
+		sink->AddLines(points + 1, static_cast<UINT32>(count - 1));
+		sink->EndFigure(filled ? D2D1_FIGURE_END_CLOSED : D2D1_FIGURE_END_OPEN);
+		sink->Close();
+		return geo;
+	}
+
+	// 角度从 12 点方向顺时针计
+	ComPtr<ID2D1PathGeometry> CreateArcGeometry(D2D1_POINT_2F center, float size, float sa, float ea, bool counter) {
+		const auto angleToPoint = [](D2D1_POINT_2F cent, float angle, float len) {
+			return len > 0 ? D2D1::Point2F(
+				cent.x + sinf(angle * DEG_TO_RAD) * len,
+				cent.y - cosf(angle * DEG_TO_RAD) * len) : cent;
+			};
+		ComPtr<ID2D1PathGeometry> geo;
+		geo.Attach(Factory::CreateGeomtry());
+		if (!geo) return nullptr;
+		float ts = sa, te = ea;
+		if (te < ts) te += 360.0f;
+		D2D1_ARC_SIZE sweep = (te - ts < 180.0f) ? D2D1_ARC_SIZE_SMALL : D2D1_ARC_SIZE_LARGE;
+		ComPtr<ID2D1GeometrySink> sink;
+		if (FAILED(geo->Open(&sink))) return nullptr;
+		auto start = angleToPoint(center, sa, size);
+		auto end = angleToPoint(center, ea, size);
+		sink->BeginFigure(start, D2D1_FIGURE_BEGIN_HOLLOW);
+		sink->AddArc(D2D1::ArcSegment(end, D2D1::SizeF(size, size), 0.0f,
+			counter ? D2D1_SWEEP_DIRECTION_COUNTER_CLOCKWISE : D2D1_SWEEP_DIRECTION_CLOCKWISE, sweep));
+		sink->EndFigure(D2D1_FIGURE_END_OPEN);
+		sink->Close();
+		return geo;
+	}
+}
+
+ComPtr<ID2D1PathGeometry> D2DGraphics::PieGeometry(D2D1_POINT_2F center, float width, float height, float startAngle, float sweepAngle) {
+	const float key[6] = { center.x, center.y, width, height, startAngle, sweepAngle };
+	if (auto* cached = _geometryCache.Find(GeometryPie, key, 6)) return *cached;
+	auto geo = CreatePieGeometry(center, width, height, startAngle, sweepAngle);
+	if (!geo) return nullptr;
+	return _geometryCache.Insert(GeometryPie, key, 6, geo);
+}
+
+ComPtr<ID2D1PathGeometry> D2DGraphics::PolygonGeometry(const D2D1_POINT_2F* points, size_t count, bool filled) {
+	if (count > MaxCachedPolygonPoints)
+		return CreatePolygonGeometry(points, count, filled);
+	const uint32_t kind = filled ? GeometryFilledPolygon : GeometryOpenPolygon;
+	const float* key = reinterpret_cast<const float*>(points);
+	if (auto* cached = _geometryCache.Find(kind, key, count * 2)) return *cached;
+	auto geo = CreatePolygonGeometry(points, count, filled);
+	if (!geo) return nullptr;
+	return _geometryCache.Insert(kind, key, count * 2, geo);
+}
+
+ComPtr<ID2D1PathGeometry> D2DGraphics::ArcGeometry(D2D1_POINT_2F center, float size, float sa, float ea, bool counter) {
+	const uint32_t kind = counter ? GeometryArcCounter : GeometryArc;
+	const float key[5] = { center.x, center.y, size, sa, ea };
+	if (auto* cached = _geometryCache.Find(kind, key, 5)) return *cached;
+	auto geo = CreateArcGeometry(center, size, sa, ea, counter);
+	if (!geo) return nullptr;
+	return _geometryCache.Insert(kind, key, 5, geo);
 }
 
 void D2DGraphics::FillPie(D2D1_POINT_2F center, float width, float height, float startAngle, float sweepAngle, D2D1_COLOR_F color) {
+	if (auto* rec = Recorder()) RecordShape(rec, DisplayOp::FillPie, color, center.x, center.y, width, height, startAngle, sweepAngle);
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
 	if (!brush) return;
-	auto geo = CreatePieGeometry(center, width, height, startAngle, sweepAngle);
+	auto geo = PieGeometry(center, width, height, startAngle, sweepAngle);
 	if (!geo) return;
 	ctx->FillGeometry(geo.Get(), brush);
 	wicDirty = true;
 }
 
 void D2DGraphics::FillPie(D2D1_POINT_2F center, float width, float height, float startAngle, float sweepAngle, ID2D1Brush* brush) {
+	if (auto* rec = Recorder()) { if (brush) RecordShape(rec, DisplayOp::FillPie, brush, center.x, center.y, width, height, startAngle, sweepAngle); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !brush) return;
-	auto geo = CreatePieGeometry(center, width, height, startAngle, sweepAngle);
+	auto geo = PieGeometry(center, width, height, startAngle, sweepAngle);
 	if (!geo) return;
 	ctx->FillGeometry(geo.Get(), brush);
 	wicDirty = true;
 }
 
 void D2DGraphics::DrawBitmap(ID2D1Bitmap* bmp, float x, float y, float opacity) {
+	if (auto* rec = Recorder()) { if (bmp) { auto sz = bmp->GetSize(); RecordResource(rec, DisplayOp::DrawBitmap, ComHandle(bmp), nullptr, D2D1::RectF(x, y, sz.width + x, sz.height + y), opacity); } }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !bmp) return;
 	D2D1_SIZE_F siz = bmp->GetSize();
 	ctx->DrawBitmap(bmp, D2D1::RectF(x, y, siz.width + x, siz.height + y), opacity);
 }
 void D2DGraphics::DrawBitmap(ID2D1Bitmap* bmp, D2D1_RECT_F rect, float opacity) {
+	if (auto* rec = Recorder()) { if (bmp) RecordResource(rec, DisplayOp::DrawBitmap, ComHandle(bmp), nullptr, rect, opacity); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !bmp) return;
 	ctx->DrawBitmap(bmp, rect, opacity);
 }
 void D2DGraphics::DrawBitmap(ID2D1Bitmap* bmp, D2D1_RECT_F destRect, D2D1_RECT_F srcRect, float opacity) {
+	if (auto* rec = Recorder()) { if (bmp) RecordResource(rec, DisplayOp::DrawBitmap, ComHandle(bmp), nullptr, destRect, opacity, &srcRect); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !bmp) return;
 	ctx->DrawBitmap(bmp, destRect, opacity, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR, srcRect);
 }
 void D2DGraphics::DrawBitmap(ID2D1Bitmap* bmp, float x, float y, float w, float h, float opacity) {
+	if (auto* rec = Recorder()) { if (bmp) RecordResource(rec, DisplayOp::DrawBitmap, ComHandle(bmp), nullptr, D2D1::RectF(x, y, w + x, h + y), opacity); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !bmp) return;
 	ctx->DrawBitmap(bmp, D2D1::RectF(x, y, w + x, h + y), opacity);
 }
 void D2DGraphics::DrawBitmap(ID2D1Bitmap* bmp, float dest_x, float dest_y, float dest_w, float dest_h, float src_x, float src_y, float src_w, float src_h, float opacity) {
+	if (auto* rec = Recorder()) { if (bmp) { D2D1_RECT_F src = D2D1::RectF(src_x, src_y, src_w + src_x, src_h + src_y); RecordResource(rec, DisplayOp::DrawBitmap, ComHandle(bmp), nullptr, D2D1::RectF(dest_x, dest_y, dest_w + dest_x, dest_h + dest_y), opacity, &src); } }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !bmp) return;
 	ctx->DrawBitmap(bmp, D2D1::RectF(dest_x, dest_y, dest_w + dest_x, dest_h + dest_y), opacity, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR, D2D1::RectF(src_x, src_y, src_w + src_x, src_h + src_y));
 }
 
 void D2DGraphics::FillOpacityMask(ID2D1Bitmap* mask, D2D1_POINT_2F destPoint, D2D1_COLOR_F color, D2D1_OPACITY_MASK_CONTENT content) {
+	if (auto* rec = Recorder()) { if (mask) { RecordedPaint p(color); auto sz = mask->GetSize(); RecordResource(rec, DisplayOp::FillOpacityMask, ComHandle(mask), &p, D2D1::RectF(destPoint.x, destPoint.y, destPoint.x + sz.width, destPoint.y + sz.height), 0.0f, nullptr, (uint16_t)content); } }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !mask) return;
 	auto brush = GetColorBrush(color);
@@ -869,6 +1148,7 @@ void D2DGraphics::FillOpacityMask(ID2D1Bitmap* mask, D2D1_POINT_2F destPoint, D2
 	wicDirty = true;
 }
 void D2DGraphics::FillOpacityMask(ID2D1Bitmap* mask, D2D1_RECT_F destRect, D2D1_COLOR_F color, D2D1_OPACITY_MASK_CONTENT content) {
+	if (auto* rec = Recorder()) { if (mask) { RecordedPaint p(color); RecordResource(rec, DisplayOp::FillOpacityMask, ComHandle(mask), &p, destRect, 0.0f, nullptr, (uint16_t)content); } }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !mask) return;
 	auto brush = GetColorBrush(color);
@@ -879,6 +1159,7 @@ void D2DGraphics::FillOpacityMask(ID2D1Bitmap* mask, D2D1_RECT_F destRect, D2D1_
 	wicDirty = true;
 }
 void D2DGraphics::FillOpacityMask(ID2D1Bitmap* mask, D2D1_RECT_F destRect, D2D1_RECT_F srcRect, D2D1_COLOR_F color, D2D1_OPACITY_MASK_CONTENT content) {
+	if (auto* rec = Recorder()) { if (mask) { RecordedPaint p(color); RecordResource(rec, DisplayOp::FillOpacityMask, ComHandle(mask), &p, destRect, 0.0f, &srcRect, (uint16_t)content); } }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !mask) return;
 	auto brush = GetColorBrush(color);
@@ -888,6 +1169,7 @@ void D2DGraphics::FillOpacityMask(ID2D1Bitmap* mask, D2D1_RECT_F destRect, D2D1_
 }
 
 void D2DGraphics::FillMesh(ID2D1Mesh* mesh, D2D1_COLOR_F color) {
+	if (auto* rec = Recorder()) { RecordedPaint p(color); if (mesh) RecordResource(rec, DisplayOp::FillMesh, ComHandle(mesh), &p, D2D1_RECT_F{}); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !mesh) return;
 	auto brush = GetColorBrush(color);
@@ -906,6 +1188,7 @@ IDWriteTextLayout* D2DGraphics::CreateStringLayout(const std::wstring& str, floa
 }
 
 void D2DGraphics::DrawStringLayout(IDWriteTextLayout* layout, float x, float y, D2D1_COLOR_F color) {
+	if (auto* rec = Recorder()) { if (layout) RecordLayout(rec, layout, x, y, color, DisplayFlagNone); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !layout) return;
 	auto brush = GetColorBrush(color);
@@ -914,6 +1197,7 @@ void D2DGraphics::DrawStringLayout(IDWriteTextLayout* layout, float x, float y,
 	wicDirty = true;
 }
 void D2DGraphics::DrawStringLayout(IDWriteTextLayout* layout, float x, float y, ID2D1Brush* brush) {
+	if (auto* rec = Recorder()) { if (layout && brush) RecordLayout(rec, layout, x, y, brush, DisplayFlagNone); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !layout || !brush) return;
 	ctx->DrawTextLayout(D2D1::Point2F(x, y), layout, brush);
@@ -921,6 +1205,7 @@ void D2DGraphics::DrawStringLayout(IDWriteTextLayout* layout, float x, float y,
 }
 
 void D2DGraphics::DrawStringLayoutCentered(IDWriteTextLayout* layout, float centerX, float centerY, D2D1_COLOR_F color) {
+	if (auto* rec = Recorder()) { if (layout) RecordLayout(rec, layout, centerX, centerY, color, DisplayFlagCentered); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !layout) return;
 	auto brush = GetColorBrush(color);
@@ -932,6 +1217,7 @@ void D2DGraphics::DrawStringLayoutCentered(IDWriteTextLayout* layout, float cent
 	wicDirty = true;
 }
 void D2DGraphics::DrawStringLayoutCentered(IDWriteTextLayout* layout, float centerX, float centerY, ID2D1Brush* brush) {
+	if (auto* rec = Recorder()) { if (layout && brush) RecordLayout(rec, layout, centerX, centerY, brush, DisplayFlagCentered); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !layout || !brush) return;
 	D2D1_SIZE_F textSize = GetTextLayoutSize(layout);
@@ -952,6 +1238,7 @@ namespace {
 }
 
 void D2DGraphics::DrawStringLayoutOutlined(IDWriteTextLayout* layout, float x, float y, D2D1_COLOR_F textColor, D2D1_COLOR_F outlineColor) {
+	if (auto* rec = Recorder()) { if (layout) RecordLayout(rec, layout, x, y, textColor, DisplayFlagOutlined, outlineColor); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !layout) return;
 	auto textBrush = GetColorBrush(textColor);
@@ -963,6 +1250,7 @@ void D2DGraphics::DrawStringLayoutOutlined(IDWriteTextLayout* layout, float x, f
 }
 
 void D2DGraphics::DrawStringLayoutOutlined(IDWriteTextLayout* layout, float x, float y, ID2D1Brush* textBrush, D2D1_COLOR_F outlineColor) {
+	if (auto* rec = Recorder()) { if (layout && textBrush) RecordLayout(rec, layout, x, y, textBrush, DisplayFlagOutlined, outlineColor); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !layout || !textBrush) return;
 	auto outlineBrush = GetBackColorBrush(outlineColor);
@@ -973,6 +1261,7 @@ void D2DGraphics::DrawStringLayoutOutlined(IDWriteTextLayout* layout, float x, f
 }
 
 void D2DGraphics::DrawStringLayoutCenteredOutlined(IDWriteTextLayout* layout, float centerX, float centerY, D2D1_COLOR_F textColor, D2D1_COLOR_F outlineColor) {
+	if (auto* rec = Recorder()) { if (layout) RecordLayout(rec, layout, centerX, centerY, textColor, DisplayFlagCentered | DisplayFlagOutlined, outlineColor); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !layout) return;
 	auto textBrush = GetColorBrush(textColor);
@@ -987,6 +1276,7 @@ void D2DGraphics::DrawStringLayoutCenteredOutlined(IDWriteTextLayout* layout, fl
 }
 
 void D2DGraphics::DrawStringLayoutCenteredOutlined(IDWriteTextLayout* layout, float centerX, float centerY, ID2D1Brush* textBrush, D2D1_COLOR_F outlineColor) {
+	if (auto* rec = Recorder()) { if (layout && textBrush) RecordLayout(rec, layout, centerX, centerY, textBrush, DisplayFlagCentered | DisplayFlagOutlined, outlineColor); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !layout || !textBrush) return;
 	auto outlineBrush = GetBackColorBrush(outlineColor);
@@ -1000,6 +1290,7 @@ void D2DGraphics::DrawStringLayoutCenteredOutlined(IDWriteTextLayout* layout, fl
 }
 
 void D2DGraphics::DrawStringLayoutEffect(IDWriteTextLayout* layout, float x, float y, D2D1_COLOR_F color, DWRITE_TEXT_RANGE subRange, D2D1_COLOR_F fontBack, Font* font) {
+	if (auto* rec = Recorder()) { if (layout) RecordLayout(rec, layout, x, y, color, DisplayFlagTextEffect, fontBack, subRange); }
 	if (!layout) return;
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
@@ -1012,6 +1303,7 @@ void D2DGraphics::DrawStringLayoutEffect(IDWriteTextLayout* layout, float x, flo
 	wicDirty = true;
 }
 void D2DGraphics::DrawStringLayoutEffect(IDWriteTextLayout* layout, float x, float y, ID2D1Brush* brush, DWRITE_TEXT_RANGE subRange, D2D1_COLOR_F fontBack, Font* font) {
+	if (auto* rec = Recorder()) { if (layout && brush) RecordLayout(rec, layout, x, y, brush, DisplayFlagTextEffect, fontBack, subRange); }
 	if (!layout || !brush) return;
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
@@ -1024,141 +1316,130 @@ void D2DGraphics::DrawStringLayoutEffect(IDWriteTextLayout* layout, float x, flo
 }
 
 void D2DGraphics::DrawString(const std::wstring& str, float x, float y, D2D1_COLOR_F color, Font* font) {
-	D2D1_RECT_F rect = D2D1::RectF(x, y, FLT_MAX, FLT_MAX);
-	Font* resolvedFont = font ? font : DefaultFontObject1();
-	if (!resolvedFont) return;
+	if (auto* rec = Recorder()) RecordString(rec, str, x, y, 0.0f, 0.0f, color, font, DisplayFlagNone);
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
+	auto textLayout = CachedStringLayout(str, FLT_MAX, FLT_MAX, font);
+	if (!textLayout) return;
 	auto brush = GetColorBrush(color);
 	if (!brush) return;
-	ctx->DrawText(str.c_str(), static_cast<UINT32>(str.size()), resolvedFont->FontObject, &rect, brush);
+	ctx->DrawTextLayout({ x, y }, textLayout.Get(), brush);
 	wicDirty = true;
 }
 void D2DGraphics::DrawString(const std::wstring& str, float x, float y, ID2D1Brush* brush, Font* font) {
-	D2D1_RECT_F rect = D2D1::RectF(x, y, FLT_MAX, FLT_MAX);
-	Font* resolvedFont = font ? font : DefaultFontObject1();
-	if (!resolvedFont) return;
+	if (auto* rec = Recorder()) { if (brush) RecordString(rec, str, x, y, 0.0f, 0.0f, brush, font, DisplayFlagNone); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !brush) return;
-	ctx->DrawText(str.c_str(), static_cast<UINT32>(str.size()), resolvedFont->FontObject, &rect, brush);
+	auto textLayout = CachedStringLayout(str, FLT_MAX, FLT_MAX, font);
+	if (!textLayout) return;
+	ctx->DrawTextLayout({ x, y }, textLayout.Get(), brush);
 	wicDirty = true;
 }
 void D2DGraphics::DrawString(const std::wstring& str, float x, float y, float w, float h, D2D1_COLOR_F color, Font* font) {
-	IDWriteTextLayout* textLayout = CreateStringLayout(str, w, h, font ? font : DefaultFontObject1());
+	if (auto* rec = Recorder()) RecordString(rec, str, x, y, w, h, color, font, DisplayFlagBounded);
+	auto textLayout = CachedStringLayout(str, w, h, font);
 	if (!textLayout) return;
 	auto* ctx = pDeviceContext.Get();
-	if (!ctx) { textLayout->Release(); return; }
+	if (!ctx) return;
 	auto brush = GetColorBrush(color);
-	if (!brush) { textLayout->Release(); return; }
-	ctx->DrawTextLayout({ x,y }, textLayout, brush);
-	textLayout->Release();
+	if (!brush) return;
+	ctx->DrawTextLayout({ x,y }, textLayout.Get(), brush);
 	wicDirty = true;
 }
 void D2DGraphics::DrawString(const std::wstring& str, float x, float y, float w, float h, ID2D1Brush* brush, Font* font) {
-	IDWriteTextLayout* textLayout = CreateStringLayout(str, w, h, font ? font : DefaultFontObject1());
+	if (auto* rec = Recorder()) { if (brush) RecordString(rec, str, x, y, w, h, brush, font, DisplayFlagBounded); }
+	auto textLayout = CachedStringLayout(str, w, h, font);
 	if (!textLayout) return;
 	auto* ctx = pDeviceContext.Get();
-	if (!ctx || !brush) { textLayout->Release(); return; }
-	ctx->DrawTextLayout({ x,y }, textLayout, brush);
-	textLayout->Release();
+	if (!ctx || !brush) return;
+	ctx->DrawTextLayout({ x,y }, textLayout.Get(), brush);
 	wicDirty = true;
 }
 void D2DGraphics::DrawStringCentered(const std::wstring& str, float centerX, float centerY, D2D1_COLOR_F color, Font* font) {
-	Font* resolvedFont = font ? font : DefaultFontObject1();
-	if (!resolvedFont) return;
-	IDWriteTextLayout* textLayout = CreateStringLayout(str, FLT_MAX, FLT_MAX, resolvedFont);
+	if (auto* rec = Recorder()) RecordString(rec, str, centerX, centerY, 0.0f, 0.0f, color, font, DisplayFlagCentered);
+	D2D1_SIZE_F textSize{};
+	auto textLayout = CachedStringLayout(str, FLT_MAX, FLT_MAX, font, &textSize);
 	if (!textLayout) return;
 	auto* ctx = pDeviceContext.Get();
-	if (!ctx) { textLayout->Release(); return; }
+	if (!ctx) return;
 	auto brush = GetColorBrush(color);
-	if (!brush) { textLayout->Release(); return; }
-	D2D1_SIZE_F textSize = GetTextLayoutSize(textLayout);
+	if (!brush) return;
 	float x = centerX - textSize.width * 0.5f;
 	float y = centerY - textSize.height * 0.5f;
-	ctx->DrawTextLayout({ x, y }, textLayout, brush);
-	textLayout->Release();
+	ctx->DrawTextLayout({ x, y }, textLayout.Get(), brush);
 	wicDirty = true;
 }
 void D2DGraphics::DrawStringCentered(const std::wstring& str, float centerX, float centerY, ID2D1Brush* brush, Font* font) {
-	Font* resolvedFont = font ? font : DefaultFontObject1();
-	if (!resolvedFont) return;
-	IDWriteTextLayout* textLayout = CreateStringLayout(str, FLT_MAX, FLT_MAX, resolvedFont);
+	if (auto* rec = Recorder()) { if (brush) RecordString(rec, str, centerX, centerY, 0.0f, 0.0f, brush, font, DisplayFlagCentered); }
+	D2D1_SIZE_F textSize{};
+	auto textLayout = CachedStringLayout(str, FLT_MAX, FLT_MAX, font, &textSize);
 	if (!textLayout) return;
 	auto* ctx = pDeviceContext.Get();
-	if (!ctx || !brush) { textLayout->Release(); return; }
-	D2D1_SIZE_F textSize = GetTextLayoutSize(textLayout);
+	if (!ctx || !brush) return;
 	float x = centerX - textSize.width * 0.5f;
 	float y = centerY - textSize.height * 0.5f;
-	ctx->DrawTextLayout({ x, y }, textLayout, brush);
-	textLayout->Release();
+	ctx->DrawTextLayout({ x, y }, textLayout.Get(), brush);
 	wicDirty = true;
 }
 void D2DGraphics::DrawStringOutlined(const std::wstring& str, float x, float y, D2D1_COLOR_F textColor, D2D1_COLOR_F outlineColor, Font* font) {
-	Font* resolvedFont = font ? font : DefaultFontObject1();
-	if (!resolvedFont) return;
-	IDWriteTextLayout* textLayout = CreateStringLayout(str, FLT_MAX, FLT_MAX, resolvedFont);
+	if (auto* rec = Recorder()) RecordString(rec, str, x, y, 0.0f, 0.0f, textColor, font, DisplayFlagOutlined, outlineColor);
+	auto textLayout = CachedStringLayout(str, FLT_MAX, FLT_MAX, font);
 	if (!textLayout) return;
 	auto* ctx = pDeviceContext.Get();
-	if (!ctx) { textLayout->Release(); return; }
+	if (!ctx) return;
 	auto textBrush = GetColorBrush(textColor);
 	auto outlineBrush = GetBackColorBrush(outlineColor);
-	if (!textBrush || !outlineBrush) { textLayout->Release(); return; }
-	DrawTextOutline(ctx, textLayout, x, y, outlineBrush);
-	ctx->DrawTextLayout({ x, y }, textLayout, textBrush);
-	textLayout->Release();
+	if (!textBrush || !outlineBrush) return;
+	DrawTextOutline(ctx, textLayout.Get(), x, y, outlineBrush);
+	ctx->DrawTextLayout({ x, y }, textLayout.Get(), textBrush);
 	wicDirty = true;
 }
 void D2DGraphics::DrawStringOutlined(const std::wstring& str, float x, float y, ID2D1Brush* textBrush, D2D1_COLOR_F outlineColor, Font* font) {
-	Font* resolvedFont = font ? font : DefaultFontObject1();
-	if (!resolvedFont) return;
-	IDWriteTextLayout* textLayout = CreateStringLayout(str, FLT_MAX, FLT_MAX, resolvedFont);
+	if (auto* rec = Recorder()) { if (textBrush) RecordString(rec, str, x, y, 0.0f, 0.0f, textBrush, font, DisplayFlagOutlined, outlineColor); }
+	auto textLayout = CachedStringLayout(str, FLT_MAX, FLT_MAX, font);
 	if (!textLayout) return;
 	auto* ctx = pDeviceContext.Get();
-	if (!ctx || !textBrush) { textLayout->Release(); return; }
+	if (!ctx || !textBrush) return;
 	auto outlineBrush = GetBackColorBrush(outlineColor);
-	if (!outlineBrush) { textLayout->Release(); return; }
-	DrawTextOutline(ctx, textLayout, x, y, outlineBrush);
-	ctx->DrawTextLayout({ x, y }, textLayout, textBrush);
-	textLayout->Release();
+	if (!outlineBrush) return;
+	DrawTextOutline(ctx, textLayout.Get(), x, y, outlineBrush);
+	ctx->DrawTextLayout({ x, y }, textLayout.Get(), textBrush);
 	wicDirty = true;
 }
 void D2DGraphics::DrawStringCenteredOutlined(const std::wstring& str, float centerX, float centerY, D2D1_COLOR_F textColor, D2D1_COLOR_F outlineColor, Font* font) {
-	Font* resolvedFont = font ? font : DefaultFontObject1();
-	if (!resolvedFont) return;
-	IDWriteTextLayout* textLayout = CreateStringLayout(str, FLT_MAX, FLT_MAX, resolvedFont);
+	if (auto* rec = Recorder()) RecordString(rec, str, centerX, centerY, 0.0f, 0.0f, textColor, font, DisplayFlagCentered | DisplayFlagOutlined, outlineColor);
+	D2D1_SIZE_F textSize{};
+	auto textLayout = CachedStringLayout(str, FLT_MAX, FLT_MAX, font, &textSize);
 	if (!textLayout) return;
 	auto* ctx = pDeviceContext.Get();
-	if (!ctx) { textLayout->Release(); return; }
+	if (!ctx) return;
 	auto textBrush = GetColorBrush(textColor);
 	auto outlineBrush = GetBackColorBrush(outlineColor);
-	if (!textBrush || !outlineBrush) { textLayout->Release(); return; }
-	D2D1_SIZE_F textSize = GetTextLayoutSize(textLayout);
+	if (!textBrush || !outlineBrush) return;
 	float x = centerX - textSize.width * 0.5f;
 	float y = centerY - textSize.height * 0.5f;
-	DrawTextOutline(ctx, textLayout, x, y, outlineBrush);
-	ctx->DrawTextLayout({ x, y }, textLayout, textBrush);
-	textLayout->Release();
+	DrawTextOutline(ctx, textLayout.Get(), x, y, outlineBrush);
+	ctx->DrawTextLayout({ x, y }, textLayout.Get(), textBrush);
 	wicDirty = true;
 }
 void D2DGraphics::DrawStringCenteredOutlined(const std::wstring& str, float centerX, float centerY, ID2D1Brush* textBrush, D2D1_COLOR_F outlineColor, Font* font) {
-	Font* resolvedFont = font ? font : DefaultFontObject1();
-	if (!resolvedFont) return;
-	IDWriteTextLayout* textLayout = CreateStringLayout(str, FLT_MAX, FLT_MAX, resolvedFont);
+	if (auto* rec = Recorder()) { if (textBrush) RecordString(rec, str, centerX, centerY, 0.0f, 0.0f, textBrush, font, DisplayFlagCentered | DisplayFlagOutlined, outlineColor); }
+	D2D1_SIZE_F textSize{};
+	auto textLayout = CachedStringLayout(str, FLT_MAX, FLT_MAX, font, &textSize);
 	if (!textLayout) return;
 	auto* ctx = pDeviceContext.Get();
-	if (!ctx || !textBrush) { textLayout->Release(); return; }
+	if (!ctx || !textBrush) return;
 	auto outlineBrush = GetBackColorBrush(outlineColor);
-	if (!outlineBrush) { textLayout->Release(); return; }
-	D2D1_SIZE_F textSize = GetTextLayoutSize(textLayout);
+	if (!outlineBrush) return;
 	float x = centerX - textSize.width * 0.5f;
 	float y = centerY - textSize.height * 0.5f;
-	DrawTextOutline(ctx, textLayout, x, y, outlineBrush);
-	ctx->DrawTextLayout({ x, y }, textLayout, textBrush);
-	textLayout->Release();
+	DrawTextOutline(ctx, textLayout.Get(), x, y, outlineBrush);
+	ctx->DrawTextLayout({ x, y }, textLayout.Get(), textBrush);
 	wicDirty = true;
 }
 
 void D2DGraphics::FillTriangle(D2D1_TRIANGLE triangle, D2D1_COLOR_F color) {
+	if (auto* rec = Recorder()) { const D2D1_POINT_2F pts[3] = { triangle.point1, triangle.point2, triangle.point3 }; RecordPoints(rec, DisplayOp::FillPolygon, pts, 3, color, 0.0f); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) {
 		return;
@@ -1167,25 +1448,20 @@ void D2DGraphics::FillTriangle(D2D1_TRIANGLE triangle, D2D1_COLOR_F color) {
 	if (!brush) {
 		return;
 	}
-	ComPtr<ID2D1PathGeometry> geo;
-	geo.Attach(Factory::CreateGeomtry());
+	const D2D1_POINT_2F pts[3] = { triangle.point1, triangle.point2, triangle.point3 };
+	auto geo = PolygonGeometry(pts, 3, true);
 	if (!geo) {
 		return;
 	}
-	ComPtr<ID2D1GeometrySink> sink;
-	if (FAILED(geo->Open(&sink))) {
-		return;
-	}
-
-	sink->BeginFigure(triangle.point1, D2D1_FIGURE_BEGIN_FILLED);
-	sink->AddLine(triangle.point2);
-	sink->AddLine(triangle.point3);
-	sink->EndFigure(D2D1_FIGURE_END_CLOSED);
-	sink->Close();
 	ctx->FillGeometry(geo.Get(), brush);
 	wicDirty = true;
 }
 void D2DGraphics::DrawTriangle(D2D1_TRIANGLE triangle, D2D1_COLOR_F color, float width) {
+	if (auto* rec = Recorder()) {
+		RecordShape(rec, DisplayOp::DrawLine, color, triangle.point1.x, triangle.point1.y, triangle.point2.x, triangle.point2.y, width);
+		RecordShape(rec, DisplayOp::DrawLine, color, triangle.point2.x, triangle.point2.y, triangle.point3.x, triangle.point3.y, width);
+		RecordShape(rec, DisplayOp::DrawLine, color, triangle.point3.x, triangle.point3.y, triangle.point1.x, triangle.point1.y, width);
+	}
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
@@ -1197,149 +1473,97 @@ void D2DGraphics::DrawTriangle(D2D1_TRIANGLE triangle, D2D1_COLOR_F color, float
 }
 
 void D2DGraphics::FillPolygon(std::vector<D2D1_POINT_2F> points, D2D1_COLOR_F color) {
+	if (auto* rec = Recorder()) { if (points.size() > 2) RecordPoints(rec, DisplayOp::FillPolygon, points.data(), points.size(), color, 0.0f); }
 	if (points.size() <= 2) return;
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
 	if (!brush) return;
-	ComPtr<ID2D1PathGeometry> geo;
-	geo.Attach(Factory::CreateGeomtry());
+	auto geo = PolygonGeometry(points.data(), points.size(), true);
 	if (!geo) return;
-	ComPtr<ID2D1GeometrySink> sink;
-	if (FAILED(geo->Open(&sink))) return;
-	sink->BeginFigure(points.front(), D2D1_FIGURE_BEGIN_FILLED);
-	sink->AddLines(points.data() + 1, static_cast<UINT32>(points.size() - 1));
-	sink->EndFigure(D2D1_FIGURE_END_CLOSED);
-	sink->Close();
 	ctx->FillGeometry(geo.Get(), brush);
 	wicDirty = true;
 }
 void D2DGraphics::FillPolygon(std::initializer_list<D2D1_POINT_2F> points, D2D1_COLOR_F color) {
+	if (auto* rec = Recorder()) { if (points.size() > 2) RecordPoints(rec, DisplayOp::FillPolygon, points.begin(), points.size(), color, 0.0f); }
 	if (points.size() <= 2) return;
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
 	if (!brush) return;
-	ComPtr<ID2D1PathGeometry> geo;
-	geo.Attach(Factory::CreateGeomtry());
+	auto geo = PolygonGeometry(points.begin(), points.size(), true);
 	if (!geo) return;
-	ComPtr<ID2D1GeometrySink> sink;
-	if (FAILED(geo->Open(&sink))) return;
-	sink->BeginFigure(*points.begin(), D2D1_FIGURE_BEGIN_FILLED);
-	sink->AddLines(points.begin() + 1, static_cast<UINT32>(points.size() - 1));
-	sink->EndFigure(D2D1_FIGURE_END_CLOSED);
-	sink->Close();
 	ctx->FillGeometry(geo.Get(), brush);
 	wicDirty = true;
 }
 void D2DGraphics::DrawPolygon(std::initializer_list<D2D1_POINT_2F> points, D2D1_COLOR_F color, float width) {
+	if (auto* rec = Recorder()) { if (points.size() > 1) RecordPoints(rec, DisplayOp::DrawPolygon, points.begin(), points.size(), color, width); }
 	if (points.size() <= 1) return;
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
 	if (!brush) return;
-	ComPtr<ID2D1PathGeometry> geo;
-	geo.Attach(Factory::CreateGeomtry());
+	auto geo = PolygonGeometry(points.begin(), points.size(), false);
 	if (!geo) return;
-	ComPtr<ID2D1GeometrySink> sink;
-	if (FAILED(geo->Open(&sink))) return;
-	sink->BeginFigure(*points.begin(), D2D1_FIGURE_BEGIN_HOLLOW);
-	sink->AddLines(points.begin() + 1, static_cast<UINT32>(points.size() - 1));
-	sink->EndFigure(D2D1_FIGURE_END_OPEN);
-	sink->Close();
 	ctx->DrawGeometry(geo.Get(), brush, width);
 	wicDirty = true;
 }
 void D2DGraphics::DrawPolygon(std::vector<D2D1_POINT_2F> points, D2D1_COLOR_F color, float width) {
+	if (auto* rec = Recorder()) { if (points.size() > 1) RecordPoints(rec, DisplayOp::DrawPolygon, points.data(), points.size(), color, width); }
 	if (points.size() <= 1) return;
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
 	if (!brush) return;
-	ComPtr<ID2D1PathGeometry> geo;
-	geo.Attach(Factory::CreateGeomtry());
+	auto geo = PolygonGeometry(points.data(), points.size(), false);
 	if (!geo) return;
-	ComPtr<ID2D1GeometrySink> sink;
-	if (FAILED(geo->Open(&sink))) return;
-	sink->BeginFigure(points.front(), D2D1_FIGURE_BEGIN_HOLLOW);
-	sink->AddLines(points.data() + 1, static_cast<UINT32>(points.size() - 1));
-	sink->EndFigure(D2D1_FIGURE_END_OPEN);
-	sink->Close();
 	ctx->DrawGeometry(geo.Get(), brush, width);
 	wicDirty = true;
 }
 
 void D2DGraphics::DrawArc(D2D1_POINT_2F center, float size, float sa, float ea, D2D1_COLOR_F color, float width) {
-	const auto angleToPoint = [](D2D1_POINT_2F cent, float angle, float len) {
-		return len > 0 ? D2D1::Point2F(
-			cent.x + sinf(angle * DEG_TO_RAD) * len,
-			cent.y - cosf(angle * DEG_TO_RAD) * len) : cent;
-		};
+	if (auto* rec = Recorder()) RecordShape(rec, DisplayOp::DrawArc, color, center.x, center.y, size, width, sa, ea);
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
 	if (!brush) return;
-	ComPtr<ID2D1PathGeometry> geo;
-	geo.Attach(Factory::CreateGeomtry());
+	auto geo = ArcGeometry(center, size, sa, ea, false);
 	if (!geo) return;
-	float ts = sa, te = ea;
-	if (te < ts) te += 360.0f;
-	D2D1_ARC_SIZE sweep = (te - ts < 180.0f) ? D2D1_ARC_SIZE_SMALL : D2D1_ARC_SIZE_LARGE;
-	ComPtr<ID2D1GeometrySink> sink;
-	if (FAILED(geo->Open(&sink))) return;
-	auto start = angleToPoint(center, sa, size);
-	auto end = angleToPoint(center, ea, size);
-	sink->BeginFigure(start, D2D1_FIGURE_BEGIN_HOLLOW);
-	sink->AddArc(D2D1::ArcSegment(end, D2D1::SizeF(size, size), 0.0f, D2D1_SWEEP_DIRECTION_CLOCKWISE, sweep));
-	sink->EndFigure(D2D1_FIGURE_END_OPEN);
-	sink->Close();
 	ctx->DrawGeometry(geo.Get(), brush, width);
 	wicDirty = true;
 }
 void D2DGraphics::DrawArcCounter(D2D1_POINT_2F center, float size, float sa, float ea, D2D1_COLOR_F color, float width) {
-	const auto angleToPoint = [](D2D1_POINT_2F cent, float angle, float len) {
-		return len > 0 ? D2D1::Point2F(
-			cent.x + sinf(angle * DEG_TO_RAD) * len,
-			cent.y - cosf(angle * DEG_TO_RAD) * len) : cent;
-		};
+	if (auto* rec = Recorder()) RecordShape(rec, DisplayOp::DrawArc, color, center.x, center.y, size, width, sa, ea, DisplayFlagCounter);
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	auto brush = GetColorBrush(color);
 	if (!brush) return;
-	ComPtr<ID2D1PathGeometry> geo;
-	geo.Attach(Factory::CreateGeomtry());
+	auto geo = ArcGeometry(center, size, sa, ea, true);
 	if (!geo) return;
-	float ts = sa, te = ea;
-	if (te < ts) te += 360.0f;
-	D2D1_ARC_SIZE sweep = (te - ts < 180.0f) ? D2D1_ARC_SIZE_SMALL : D2D1_ARC_SIZE_LARGE;
-	ComPtr<ID2D1GeometrySink> sink;
-	if (FAILED(geo->Open(&sink))) return;
-	auto start = angleToPoint(center, sa, size);
-	auto end = angleToPoint(center, ea, size);
-	sink->BeginFigure(start, D2D1_FIGURE_BEGIN_HOLLOW);
-	sink->AddArc(D2D1::ArcSegment(end, D2D1::SizeF(size, size), 0.0f, D2D1_SWEEP_DIRECTION_COUNTER_CLOCKWISE, sweep));
-	sink->EndFigure(D2D1_FIGURE_END_OPEN);
-	sink->Close();
 	ctx->DrawGeometry(geo.Get(), brush, width);
 	wicDirty = true;
 }
 
 void D2DGraphics::PushDrawRect(float left, float top, float width, float height) {
+	if (auto* rec = Recorder()) rec->PushClip(DisplayRect{ left, top, left + width, top + height });
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	ctx->PushAxisAlignedClip(D2D1::RectF(left, top, left + width, top + height), D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
 }
 void D2DGraphics::PopDrawRect() {
+	if (auto* rec = Recorder()) rec->PopClip();
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	ctx->PopAxisAlignedClip();
 }
 void D2DGraphics::SetAntialiasMode(D2D1_ANTIALIAS_MODE antialiasMode) {
+	if (auto* rec = Recorder()) { DisplayCommand c; c.Op = DisplayOp::SetAntialias; c.Mode = (uint16_t)antialiasMode; rec->Push(c); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	ctx->SetAntialiasMode(antialiasMode);
 }
 void D2DGraphics::SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE antialiasMode) {
+	if (auto* rec = Recorder()) { DisplayCommand c; c.Op = DisplayOp::SetTextAntialias; c.Mode = (uint16_t)antialiasMode; rec->Push(c); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx) return;
 	ctx->SetTextAntialiasMode(antialiasMode);
@@ -1412,6 +1636,7 @@ ID2D1Bitmap1* D2DGraphics::CreateBitmapFromDxgiSurface(IDXGISurface* surface) {
 }
 
 void D2DGraphics::DrawDxgiSurface(IDXGISurface* surface, float x, float y, float width, float height, float opacity) {
+	if (auto* rec = Recorder()) { if (surface) RecordResource(rec, DisplayOp::DrawSurface, ComHandle(surface), nullptr, D2D1::RectF(x, y, x + width, y + height), opacity); }
 	auto* ctx = pDeviceContext.Get();
 	if (!ctx || !surface) return;
 
@@ -1469,12 +1694,232 @@ D2D1_SIZE_F D2DGraphics::Size() {
 }
 
 void D2DGraphics::SetTransform(D2D1_MATRIX_3X2_F matrix) {
+	if (auto* rec = Recorder()) { const float m[6] = { matrix._11, matrix._12, matrix._21, matrix._22, matrix._31, matrix._32 }; rec->SetTransform(m); }
 	if (pDeviceContext) pDeviceContext->SetTransform(matrix);
 }
 void D2DGraphics::ClearTransform() {
+	if (auto* rec = Recorder()) { const float m[6] = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f }; rec->SetTransform(m); }
 	if (pDeviceContext) pDeviceContext->SetTransform(D2D1::Matrix3x2F::Identity());
 }
 
+void D2DGraphics::BeginRecording(DisplayList* list) {
+	if (!list) return;
+	_recorders.push_back(list);
+}
+
+void D2DGraphics::EndRecording() {
+	if (_recorders.empty()) return;
+	DisplayList* inner = _recorders.back();
+	_recorders.pop_back();
+	if (auto* outer = Recorder())
+		outer->Append(*inner);
+}
+
+void D2DGraphics::Replay(const DisplayList& list) {
+	// 回放期间暂停录制，避免每条命令被逐条重新录制；结束后整体追加
+	std::vector<DisplayList*> recorders;
+	recorders.swap(_recorders);
+	ReplayCommands(list);
+	_recorders.swap(recorders);
+	if (auto* rec = Recorder())
+		rec->Append(list);
+}
+
+void D2DGraphics::ReplayCommands(const DisplayList& list) {
+	auto color = [&list](uint32_t index) { return ToD2DColor(list.Color(index)); };
+	auto rectOf = [](const DisplayCommand& c) { return D2D1::RectF(c.X, c.Y, c.Z, c.W); };
+	auto brushOf = [&list](const DisplayCommand& c) { return static_cast<ID2D1Brush*>(list.Resource(c.Paint)); };
+	auto fontOf = [&list](const DisplayCommand& c) { return static_cast<Font*>(list.Resource(c.Resource)); };
+
+	const auto& commands = list.Commands();
+	const size_t n = commands.size();
+	for (size_t i = 0; i < n; i++) {
+		const DisplayCommand& c = commands[i];
+		const bool brushPaint = (c.Flags & DisplayFlagBrushResource) != 0;
+		switch (c.Op) {
+		case DisplayOp::Clear:
+			Clear(color(c.Paint));
+			break;
+		case DisplayOp::PushClip:
+			PushDrawRect(c.X, c.Y, c.Z - c.X, c.W - c.Y);
+			break;
+		case DisplayOp::PopClip:
+			PopDrawRect();
+			break;
+		case DisplayOp::SetTransform: {
+			const float* m = list.Floats(c.Data);
+			SetTransform(D2D1::Matrix3x2F(m[0], m[1], m[2], m[3], m[4], m[5]));
+			break;
+		}
+		case DisplayOp::SetAntialias:
+			SetAntialiasMode((D2D1_ANTIALIAS_MODE)c.Mode);
+			break;
+		case DisplayOp::SetTextAntialias:
+			SetTextAntialiasMode((D2D1_TEXT_ANTIALIAS_MODE)c.Mode);
+			break;
+		case DisplayOp::FillRect:
+		case DisplayOp::DrawRect: {
+			// 合批：同色的连续矩形只取一次画刷，直接提交到设备上下文
+			size_t end = i + 1;
+			while (end < n && DisplayList::SameBatch(c, commands[end])) end++;
+			auto* ctx = pDeviceContext.Get();
+			ID2D1Brush* brush = brushPaint ? brushOf(c) : GetColorBrush(color(c.Paint));
+			if (ctx && brush) {
+				for (size_t k = i; k < end; k++) {
+					const DisplayCommand& r = commands[k];
+					if (r.Op == DisplayOp::FillRect)
+						ctx->FillRectangle(rectOf(r), brush);
+					else
+						ctx->DrawRectangle(rectOf(r), brush, r.A);
+				}
+				wicDirty = true;
+			}
+			i = end - 1;
+			break;
+		}
+		case DisplayOp::FillRoundRect:
+			FillRoundRect(rectOf(c), color(c.Paint), c.B);
+			break;
+		case DisplayOp::DrawRoundRect:
+			DrawRoundRect(rectOf(c), color(c.Paint), c.A, c.B);
+			break;
+		case DisplayOp::FillEllipse:
+			FillEllipse(D2D1::Point2F(c.X, c.Y), c.Z, c.W, color(c.Paint));
+			break;
+		case DisplayOp::DrawEllipse:
+			DrawEllipse(D2D1::Point2F(c.X, c.Y), c.Z, c.W, color(c.Paint), c.A);
+			break;
+		case DisplayOp::DrawLine:
+			if (brushPaint)
+				DrawLine(D2D1::Point2F(c.X, c.Y), D2D1::Point2F(c.Z, c.W), brushOf(c), c.A);
+			else
+				DrawLine(D2D1::Point2F(c.X, c.Y), D2D1::Point2F(c.Z, c.W), color(c.Paint), c.A);
+			break;
+		case DisplayOp::FillPolygon:
+		case DisplayOp::DrawPolygon: {
+			const auto* pts = reinterpret_cast<const D2D1_POINT_2F*>(list.Floats(c.Data));
+			std::vector<D2D1_POINT_2F> points(pts, pts + c.Count);
+			if (c.Op == DisplayOp::FillPolygon)
+				FillPolygon(points, color(c.Paint));
+			else
+				DrawPolygon(points, color(c.Paint), c.A);
+			break;
+		}
+		case DisplayOp::FillPie:
+			if (brushPaint)
+				FillPie(D2D1::Point2F(c.X, c.Y), c.Z, c.W, c.A, c.B, brushOf(c));
+			else
+				FillPie(D2D1::Point2F(c.X, c.Y), c.Z, c.W, c.A, c.B, color(c.Paint));
+			break;
+		case DisplayOp::DrawArc:
+			if (c.Flags & DisplayFlagCounter)
+				DrawArcCounter(D2D1::Point2F(c.X, c.Y), c.Z, c.A, c.B, color(c.Paint), c.W);
+			else
+				DrawArc(D2D1::Point2F(c.X, c.Y), c.Z, c.A, c.B, color(c.Paint), c.W);
+			break;
+		case DisplayOp::FillGeometry:
+		case DisplayOp::DrawGeometry: {
+			auto* geo = static_cast<ID2D1Geometry*>(list.Resource(c.Resource));
+			if (c.Op == DisplayOp::FillGeometry) {
+				if (brushPaint) FillGeometry(geo, brushOf(c));
+				else FillGeometry(geo, color(c.Paint));
+			}
+			else {
+				if (brushPaint) DrawGeometry(geo, brushOf(c), c.A);
+				else DrawGeometry(geo, color(c.Paint), c.A);
+			}
+			break;
+		}
+		case DisplayOp::FillMesh:
+			FillMesh(static_cast<ID2D1Mesh*>(list.Resource(c.Resource)), color(c.Paint));
+			break;
+		case DisplayOp::FillOpacityMask: {
+			auto* mask = static_cast<ID2D1Bitmap*>(list.Resource(c.Resource));
+			auto content = (D2D1_OPACITY_MASK_CONTENT)c.Mode;
+			if (c.Flags & DisplayFlagSource) {
+				const float* s = list.Floats(c.Data);
+				FillOpacityMask(mask, rectOf(c), D2D1::RectF(s[0], s[1], s[2], s[3]), color(c.Paint), content);
+			}
+			else {
+				FillOpacityMask(mask, rectOf(c), color(c.Paint), content);
+			}
+			break;
+		}
+		case DisplayOp::DrawBitmap: {
+			auto* bmp = static_cast<ID2D1Bitmap*>(list.Resource(c.Resource));
+			if (c.Flags & DisplayFlagSource) {
+				const float* s = list.Floats(c.Data);
+				DrawBitmap(bmp, rectOf(c), D2D1::RectF(s[0], s[1], s[2], s[3]), c.A);
+			}
+			else {
+				DrawBitmap(bmp, rectOf(c), c.A);
+			}
+			break;
+		}
+		case DisplayOp::DrawSurface:
+			DrawDxgiSurface(static_cast<IDXGISurface*>(list.Resource(c.Resource)), c.X, c.Y, c.Z - c.X, c.W - c.Y, c.A);
+			break;
+		case DisplayOp::DrawString: {
+			const std::wstring& str = list.String(c.Data);
+			Font* font = fontOf(c);
+			const uint8_t kind = c.Flags & (DisplayFlagCentered | DisplayFlagOutlined | DisplayFlagBounded);
+			switch (kind) {
+			case DisplayFlagCentered:
+				if (brushPaint) DrawStringCentered(str, c.X, c.Y, brushOf(c), font);
+				else DrawStringCentered(str, c.X, c.Y, color(c.Paint), font);
+				break;
+			case DisplayFlagOutlined:
+				if (brushPaint) DrawStringOutlined(str, c.X, c.Y, brushOf(c), color(c.Paint2), font);
+				else DrawStringOutlined(str, c.X, c.Y, color(c.Paint), color(c.Paint2), font);
+				break;
+			case DisplayFlagCentered | DisplayFlagOutlined:
+				if (brushPaint) DrawStringCenteredOutlined(str, c.X, c.Y, brushOf(c), color(c.Paint2), font);
+				else DrawStringCenteredOutlined(str, c.X, c.Y, color(c.Paint), color(c.Paint2), font);
+				break;
+			case DisplayFlagBounded:
+				if (brushPaint) DrawString(str, c.X, c.Y, c.Z, c.W, brushOf(c), font);
+				else DrawString(str, c.X, c.Y, c.Z, c.W, color(c.Paint), font);
+				break;
+			default:
+				if (brushPaint) DrawString(str, c.X, c.Y, brushOf(c), font);
+				else DrawString(str, c.X, c.Y, color(c.Paint), font);
+				break;
+			}
+			break;
+		}
+		case DisplayOp::DrawStringLayout: {
+			auto* layout = static_cast<IDWriteTextLayout*>(list.Resource(c.Resource));
+			if (c.Flags & DisplayFlagTextEffect) {
+				DWRITE_TEXT_RANGE range{ c.Data, c.Count };
+				if (brushPaint) DrawStringLayoutEffect(layout, c.X, c.Y, brushOf(c), range, color(c.Paint2));
+				else DrawStringLayoutEffect(layout, c.X, c.Y, color(c.Paint), range, color(c.Paint2));
+				break;
+			}
+			const uint8_t kind = c.Flags & (DisplayFlagCentered | DisplayFlagOutlined);
+			switch (kind) {
+			case DisplayFlagCentered:
+				if (brushPaint) DrawStringLayoutCentered(layout, c.X, c.Y, brushOf(c));
+				else DrawStringLayoutCentered(layout, c.X, c.Y, color(c.Paint));
+				break;
+			case DisplayFlagOutlined:
+				if (brushPaint) DrawStringLayoutOutlined(layout, c.X, c.Y, brushOf(c), color(c.Paint2));
+				else DrawStringLayoutOutlined(layout, c.X, c.Y, color(c.Paint), color(c.Paint2));
+				break;
+			case DisplayFlagCentered | DisplayFlagOutlined:
+				if (brushPaint) DrawStringLayoutCenteredOutlined(layout, c.X, c.Y, brushOf(c), color(c.Paint2));
+				else DrawStringLayoutCenteredOutlined(layout, c.X, c.Y, color(c.Paint), color(c.Paint2));
+				break;
+			default:
+				if (brushPaint) DrawStringLayout(layout, c.X, c.Y, brushOf(c));
+				else DrawStringLayout(layout, c.X, c.Y, color(c.Paint));
+				break;
+			}
+			break;
+		}
+		}
+	}
+}
+
 D2D1_SIZE_F D2DGraphics::GetTextLayoutSize(IDWriteTextLayout* textLayout) {
 	D2D1_SIZE_F minSize = { 0,0 };
 	if (!textLayout) return minSize;
@@ -1644,6 +2089,7 @@ void HwndGraphics::EndRender() {
 	_lastPresentHr = S_OK;
 	if (pSwapChain) {
 		_lastPresentHr = pSwapChain->Present(1, 0);
+		NotePresent(_lastPresentHr);
 	}
 	if (_lastEndDrawHr == D2DERR_RECREATE_TARGET && pSwapChain) {
 		CreateTargetBitmapForSwapChain(pSwapChain.Get());
@@ -1697,6 +2143,7 @@ void CompositionSwapChainGraphics::EndRender() {
 	_lastPresentHr = S_OK;
 	if (pSwapChain) {
 		_lastPresentHr = pSwapChain->Present(1, 0);
+		NotePresent(_lastPresentHr);
 	}
 	if (_lastEndDrawHr == D2DERR_RECREATE_TARGET && pSwapChain) {
 		CreateTargetBitmapForSwapChain(pSwapChain.Get());
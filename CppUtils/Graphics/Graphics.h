@@ -20,6 +20,8 @@
 #include "Colors.h"
 #include "Factory.h"
 #include "BitmapSource.h"
+#include "DisplayList.h"
+#include "ResourceCache.h"
 
 #ifndef _LIB
 #if defined(_MT)
@@ -96,6 +98,15 @@ public:
 	bool IsDeviceLost() const { return _deviceLost; }
 	HRESULT GetLastEndDrawHr() const { return _lastEndDrawHr; }
 	HRESULT GetLastPresentHr() const { return _lastPresentHr; }
+	/**
+	 * @brief 当前后台缓冲区的“年龄”：它保存的是几帧之前的画面。
+	 *
+	 * FLIP_SEQUENTIAL 交换链的后台缓冲区在 Present 后保留内容，年龄等于缓冲区数量；
+	 * 目标重建/ResizeBuffers 后，所有缓冲区各 Present 一次之前返回 0。
+	 * 0 表示内容未定义（DISCARD 交换链、其它表面类型），调用方需要整窗重绘。
+	 * 离屏/兼容/外部位图目标始终保留上一帧，返回 1。
+	 */
+	UINT GetBackBufferAge() const;
 
 	HRESULT EnsureDeviceContext();
 
@@ -160,6 +171,10 @@ public:
 
 	void FillMesh(ID2D1Mesh* mesh, D2D1_COLOR_F color);
 
+	/**
+	 * @brief 创建调用方独占的布局（可修改，用完 Release）。
+	 * 只需绘制/测量时，DrawString 系列与 Font::GetTextSize 使用 TextLayoutCache 中的共享布局。
+	 */
 	IDWriteTextLayout* CreateStringLayout(const std::wstring& str, float width, float height, Font* font = nullptr);
 
 	void DrawStringLayout(IDWriteTextLayout* layout, float x, float y, D2D1_COLOR_F color);
@@ -233,6 +248,38 @@ public:
 
 	static D2D1_SIZE_F GetTextLayoutSize(IDWriteTextLayout* textLayout);
 
+	// ---- 录制/回放 ----
+	/**
+	 * @brief 开始录制：之后的绘制调用照常绘制，同时追加命令到 list。
+	 *
+	 * 可嵌套：内层 EndRecording 时，内层列表整体追加到外层列表。
+	 * 通过 GetRenderTargetRaw/GetDeviceContextRaw 直接绘制的内容不会被录制。
+	 */
+	void BeginRecording(DisplayList* list);
+	void EndRecording();
+	bool IsRecording() const { return !_recorders.empty(); }
+	/**
+	 * @brief 回放命令列表；连续同色的 FillRect/DrawRect 共用一次画刷设置。
+	 * 录制中回放时，list 同时追加到当前录制列表。
+	 */
+	void Replay(const DisplayList& list);
+
+	// ---- 资源缓存 ----
+	/**
+	 * @brief GetColorBrush 按颜色缓存纯色画刷（LRU），饼图/多边形/三角形/圆弧按形状缓存路径几何。
+	 *
+	 * 稳定帧（颜色与形状与上一帧相同）不再创建画刷和几何。画刷依赖设备上下文，目标重建时清空；
+	 * 几何是工厂资源，跨目标重建保留。
+	 */
+	struct ResourceCacheInfo {
+		ResourceCacheStats Brushes;
+		ResourceCacheStats Geometries;
+	};
+	ResourceCacheInfo GetResourceCacheStats() const;
+	void ResetResourceCacheStats();
+	void SetResourceCacheCapacity(size_t brushes, size_t geometries);
+	void ClearResourceCaches();
+
 protected:
 	HRESULT Initialize(const InitOptions& options);
 	HRESULT InitializeWithSize(UINT width, UINT height, FLOAT dpiX, FLOAT dpiY, DXGI_FORMAT format, D2D1_ALPHA_MODE alphaMode);
@@ -262,6 +309,36 @@ protected:
 	HRESULT _lastEndDrawHr = S_OK;
 	HRESULT _lastPresentHr = S_OK;
 	bool _deviceLost = false;
+	// 目标（重新）绑定后成功 Present 的次数，GetBackBufferAge 使用
+	UINT _presentsSinceTargetReset = 0;
+	void NotePresent(HRESULT presentHr) { if (SUCCEEDED(presentHr)) _presentsSinceTargetReset++; }
+
+	// 录制栈（最内层在后）
+	std::vector<DisplayList*> _recorders;
+	DisplayList* Recorder() const { return _recorders.empty() ? nullptr : _recorders.back(); }
+	void ReplayCommands(const DisplayList& list);
+
+	ResourceCache<Microsoft::WRL::ComPtr<ID2D1SolidColorBrush>> _brushCache{ 64 };
+	ResourceCache<Microsoft::WRL::ComPtr<ID2D1PathGeometry>> _geometryCache{ 1024 };
+	// 按形状查找/创建路径几何；顶点过多的多边形不缓存
+	Microsoft::WRL::ComPtr<ID2D1PathGeometry> PieGeometry(D2D1_POINT_2F center, float width, float height, float startAngle, float sweepAngle);
+	Microsoft::WRL::ComPtr<ID2D1PathGeometry> PolygonGeometry(const D2D1_POINT_2F* points, size_t count, bool filled);
+	Microsoft::WRL::ComPtr<ID2D1PathGeometry> ArcGeometry(D2D1_POINT_2F center, float size, float sa, float ea, bool counter);
+};
+
+/**
+ * @brief 只录制、不绘制的渲染目标：不创建设备，所有绘制调用只生成 DisplayList。
+ *
+ * 用于离屏生成显示列表，或在测试中检查控件的绘制命令。
+ */
+class RecordingGraphics : public D2DGraphics {
+public:
+	RecordingGraphics() { BeginRecording(&_list); }
+	DisplayList& List() { return _list; }
+	const DisplayList& List() const { return _list; }
+
+private:
+	DisplayList _list;
 };
 
 class CompatibleGraphics : public D2DGraphics {
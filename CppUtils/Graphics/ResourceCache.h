@@ -0,0 +1,125 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @file ResourceCache.h
+ * @brief ResourceCache：按形状键缓存已创建资源的 LRU 表。
+ *
+ * 键由“种类 + 一组 float”组成（颜色、饼图参数、多边形顶点等），按位比较：
+ * 先比较 64 位散列，命中后再逐个比较 float，散列冲突不会返回错误的资源。
+ * 查找不分配内存；只有未命中后 Insert 才分配一个节点。超过容量时淘汰最久未使用的项。
+ *
+ * 本文件不依赖 Win32/D2D（Value 可以是 ComPtr 或任意可移动类型）。
+ */
+
+struct ResourceCacheStats
+{
+	size_t Hits = 0;
+	size_t Misses = 0;
+	size_t Evictions = 0;
+	size_t Count = 0;
+	size_t Capacity = 0;
+};
+
+template <class Value>
+class ResourceCache
+{
+public:
+	explicit ResourceCache(size_t capacity) : _capacity(capacity ? capacity : 1) {}
+
+	static uint64_t Hash(uint32_t kind, const float* values, size_t count) {
+		uint64_t h = 1469598103934665603ull ^ kind;
+		h *= 1099511628211ull;
+		for (size_t i = 0; i < count; i++) {
+			uint32_t bits = 0;
+			std::memcpy(&bits, values + i, sizeof(bits));
+			h ^= bits;
+			h *= 1099511628211ull;
+		}
+		return h ^ (uint64_t)count;
+	}
+
+	/** @brief 查找；命中时移到最近使用端。未命中返回 nullptr（计入 Misses）。 */
+	Value* Find(uint32_t kind, const float* values, size_t count) {
+		auto it = _index.find(Hash(kind, values, count));
+		if (it != _index.end() && Matches(*it->second, kind, values, count)) {
+			_entries.splice(_entries.begin(), _entries, it->second);
+			_stats.Hits++;
+			return &it->second->value;
+		}
+		_stats.Misses++;
+		return nullptr;
+	}
+
+	/** @brief 插入（同键已存在时替换）；返回缓存中的值。 */
+	Value& Insert(uint32_t kind, const float* values, size_t count, Value value) {
+		uint64_t h = Hash(kind, values, count);
+		auto it = _index.find(h);
+		if (it != _index.end()) {
+			// 同键或散列冲突：替换旧项
+			_entries.erase(it->second);
+			_index.erase(it);
+		}
+		while (_entries.size() >= _capacity) {
+			_index.erase(_entries.back().hash);
+			_entries.pop_back();
+			_stats.Evictions++;
+		}
+		Entry e;
+		e.hash = h;
+		e.kind = kind;
+		e.values.assign(values, values + count);
+		e.value = std::move(value);
+		_entries.push_front(std::move(e));
+		_index[h] = _entries.begin();
+		return _entries.front().value;
+	}
+
+	void Clear() {
+		_entries.clear();
+		_index.clear();
+	}
+	size_t Count() const { return _entries.size(); }
+	size_t Capacity() const { return _capacity; }
+	/** @brief 修改容量；缩小时立即淘汰多余项。 */
+	void SetCapacity(size_t capacity) {
+		_capacity = capacity ? capacity : 1;
+		while (_entries.size() > _capacity) {
+			_index.erase(_entries.back().hash);
+			_entries.pop_back();
+			_stats.Evictions++;
+		}
+	}
+
+	ResourceCacheStats Stats() const {
+		ResourceCacheStats s = _stats;
+		s.Count = _entries.size();
+		s.Capacity = _capacity;
+		return s;
+	}
+	void ResetStats() { _stats = ResourceCacheStats(); }
+
+private:
+	struct Entry
+	{
+		uint64_t hash = 0;
+		uint32_t kind = 0;
+		std::vector<float> values;
+		Value value{};
+	};
+
+	static bool Matches(const Entry& e, uint32_t kind, const float* values, size_t count) {
+		return e.kind == kind && e.values.size() == count &&
+			(count == 0 || std::memcmp(e.values.data(), values, count * sizeof(float)) == 0);
+	}
+
+	size_t _capacity;
+	std::list<Entry> _entries;
+	std::unordered_map<uint64_t, typename std::list<Entry>::iterator> _index;
+	ResourceCacheStats _stats;
+};
@@ -0,0 +1,922 @@
+#include "SoftwareRasterizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RASTER_SSE2 1
+#else
+#define RASTER_SSE2 0
+#endif
+
+namespace {
+	const float Pi = 3.14159265358979323846f;
+	const float DegToRad = Pi / 180.0f;
+
+	// x * k / 255（k 为 0~255），对 4 个通道同时计算
+	inline uint32_t ScalePixel(uint32_t p, uint32_t k) {
+		uint32_t rb = (p & 0x00FF00FFu) * k;
+		uint32_t ag = ((p >> 8) & 0x00FF00FFu) * k;
+		rb = ((rb + 0x00800080u + ((rb >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+		ag = (ag + 0x00800080u + ((ag >> 8) & 0x00FF00FFu)) & 0xFF00FF00u;
+		return rb | ag;
+	}
+
+	// 预乘 src-over
+	inline uint32_t BlendPixel(uint32_t dst, uint32_t src) {
+		uint32_t sa = src >> 24;
+		if (sa == 255) return src;
+		if (sa == 0 && src == 0) return dst;
+		return src + ScalePixel(dst, 255 - sa);
+	}
+
+	void FillSpan(uint32_t* dst, int n, uint32_t value) {
+		int i = 0;
+#if RASTER_SSE2
+		const __m128i v = _mm_set1_epi32((int)value);
+		for (; i + 4 <= n; i += 4)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+#endif
+		for (; i < n; i++) dst[i] = value;
+	}
+
+	// 同一预乘颜色混合到一段像素上
+	void BlendSpan(uint32_t* dst, int n, uint32_t src) {
+		const uint32_t sa = src >> 24;
+		if (sa == 255) { FillSpan(dst, n, src); return; }
+		if (src == 0) return;
+		int i = 0;
+#if RASTER_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i inv = _mm_set1_epi16((short)(255 - sa));
+		const __m128i bias = _mm_set1_epi16(128);
+		const __m128i s = _mm_set1_epi32((int)src);
+		for (; i + 4 <= n; i += 4) {
+			__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+			__m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv);
+			__m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv);
+			// x / 255 ≈ (t + (t >> 8)) >> 8，t = x + 128
+			lo = _mm_add_epi16(lo, bias);
+			hi = _mm_add_epi16(hi, bias);
+			lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+			hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+			__m128i out = _mm_adds_epu8(_mm_packus_epi16(lo, hi), s);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+		}
+#endif
+		const uint32_t inv32 = 255 - sa;
+		for (; i < n; i++) dst[i] = src + ScalePixel(dst[i], inv32);
+	}
+
+	// 按逐像素覆盖率混合；连续的满覆盖段走 BlendSpan
+	size_t BlendMask(uint32_t* dst, const uint8_t* mask, int n, uint32_t src) {
+		size_t touched = 0;
+		int i = 0;
+		while (i < n) {
+			uint8_t m = mask[i];
+			if (m == 0) { i++; continue; }
+			if (m == 255) {
+				int j = i + 1;
+				while (j < n && mask[j] == 255) j++;
+				BlendSpan(dst + i, j - i, src);
+				touched += (size_t)(j - i);
+				i = j;
+				continue;
+			}
+			dst[i] = BlendPixel(dst[i], ScalePixel(src, m));
+			touched++;
+			i++;
+		}
+		return touched;
+	}
+
+	inline uint8_t ToCoverage(float c, bool antialias) {
+		if (c <= 0.0f) return 0;
+		if (c >= 1.0f) return 255;
+		if (!antialias) return c >= 0.5f ? 255 : 0;
+		return (uint8_t)(c * 255.0f + 0.5f);
+	}
+
+	// 一段 [a, b) 与像素 [x, x + 1) 的重叠长度
+	inline float Overlap(float a, float b, int x) {
+		float lo = (std::max)(a, (float)x);
+		float hi = (std::min)(b, (float)(x + 1));
+		return hi > lo ? hi - lo : 0.0f;
+	}
+
+	// 按容差把圆弧分段：弦高不超过 0.1 像素
+	int ArcSegments(float radius, float sweepRadians) {
+		float r = std::fabs(radius);
+		int full = 8;
+		if (r > 0.1f) {
+			float step = 2.0f * std::acos((std::max)(-1.0f, 1.0f - 0.1f / r));
+			if (step > 0.0f) full = (int)std::ceil(2.0f * Pi / step);
+		}
+		full = (std::min)((std::max)(full, 8), 512);
+		int n = (int)std::ceil(full * std::fabs(sweepRadians) / (2.0f * Pi));
+		return (std::max)(n, 1);
+	}
+
+	// 覆盖率累积：把一条边的有向面积分摊到所在行的像素（参考 font-rs 的累积光栅化）
+	void AccumulateLine(float* accum, int stride, int w, int h, float x0, float y0, float x1, float y1) {
+		if (y0 == y1) return;
+		float dir = 1.0f;
+		if (y0 > y1) {
+			std::swap(x0, x1);
+			std::swap(y0, y1);
+			dir = -1.0f;
+		}
+		if (y1 <= 0.0f || y0 >= (float)h) return;
+		const float dxdy = (x1 - x0) / (y1 - y0);
+		if (y0 < 0.0f) { x0 -= y0 * dxdy; y0 = 0.0f; }
+		if (y1 > (float)h) { x1 -= (y1 - (float)h) * dxdy; y1 = (float)h; }
+		const float fw = (float)w;
+		float x = x0;
+		const int yStart = (int)y0;
+		const int yEnd = (int)std::ceil(y1);
+		for (int y = yStart; y < yEnd; y++) {
+			float* row = accum + (size_t)y * stride;
+			float dy = (std::min)((float)(y + 1), y1) - (std::max)((float)y, y0);
+			float xnext = x + dxdy * dy;
+			float d = dy * dir;
+			// 裁剪区域左右之外的部分压到边界列上：左侧仍计入绕数，右侧不可见
+			float xa = (std::min)((std::max)(x, 0.0f), fw);
+			float xb = (std::min)((std::max)(xnext, 0.0f), fw);
+			float lo = (std::min)(xa, xb);
+			float hi = (std::max)(xa, xb);
+			float loFloor = std::floor(lo);
+			int loi = (int)loFloor;
+			float hiCeil = std::ceil(hi);
+			int hii = (int)hiCeil;
+			if (hii <= loi + 1) {
+				float xmf = 0.5f * (xa + xb) - loFloor;
+				row[loi] += d - d * xmf;
+				row[loi + 1] += d * xmf;
+			}
+			else {
+				float s = 1.0f / (hi - lo);
+				float lof = lo - loFloor;
+				float a0 = 0.5f * s * (1.0f - lof) * (1.0f - lof);
+				float hif = hi - hiCeil + 1.0f;
+				float am = 0.5f * s * hif * hif;
+				row[loi] += d * a0;
+				if (hii == loi + 2) {
+					row[loi + 1] += d * (1.0f - a0 - am);
+				}
+				else {
+					float a1 = s * (1.5f - lof);
+					row[loi + 1] += d * (a1 - a0);
+					for (int xi = loi + 2; xi < hii - 1; xi++)
+						row[xi] += d * s;
+					float a2 = a1 + (float)(hii - loi - 3) * s;
+					row[hii - 1] += d * (1.0f - a2 - am);
+				}
+				row[hii] += d * am;
+			}
+			x = xnext;
+		}
+	}
+
+	bool IsWideChar(wchar_t ch) {
+		return ch >= 0x2E80;
+	}
+}
+
+// ---- PixelBuffer ----
+
+PixelBuffer::PixelBuffer(int width, int height, uint32_t fill) {
+	Resize(width, height, fill);
+}
+
+void PixelBuffer::Resize(int width, int height, uint32_t fill) {
+	_width = (std::max)(width, 0);
+	_height = (std::max)(height, 0);
+	_pixels.assign((size_t)_width * _height, fill);
+}
+
+uint32_t PixelBuffer::Pack(const DisplayColor& color) {
+	auto channel = [](float v) {
+		v = (std::min)((std::max)(v, 0.0f), 1.0f);
+		return (uint32_t)(v * 255.0f + 0.5f);
+	};
+	uint32_t a = channel(color.a);
+	uint32_t r = (std::min)(channel(color.r * color.a), a);
+	uint32_t g = (std::min)(channel(color.g * color.a), a);
+	uint32_t b = (std::min)(channel(color.b * color.a), a);
+	return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+DisplayColor PixelBuffer::Unpack(uint32_t pixel) {
+	DisplayColor c;
+	uint32_t a = pixel >> 24;
+	if (a == 0) return c;
+	c.a = a / 255.0f;
+	c.r = (float)((pixel >> 16) & 0xFF) / (float)a;
+	c.g = (float)((pixel >> 8) & 0xFF) / (float)a;
+	c.b = (float)(pixel & 0xFF) / (float)a;
+	return c;
+}
+
+size_t PixelBuffer::DiffCount(const PixelBuffer& other, int tolerance) const {
+	if (_width != other._width || _height != other._height)
+		return (std::max)(_pixels.size(), other._pixels.size());
+	size_t diff = 0;
+	for (size_t i = 0; i < _pixels.size(); i++) {
+		uint32_t a = _pixels[i];
+		uint32_t b = other._pixels[i];
+		if (a == b) continue;
+		for (int shift = 0; shift < 32; shift += 8) {
+			int ca = (int)((a >> shift) & 0xFF);
+			int cb = (int)((b >> shift) & 0xFF);
+			if (std::abs(ca - cb) > tolerance) {
+				diff++;
+				break;
+			}
+		}
+	}
+	return diff;
+}
+
+std::vector<uint8_t> PixelBuffer::EncodeBmp() const {
+	const uint32_t headerSize = 14 + 40;
+	const uint32_t dataSize = (uint32_t)_pixels.size() * 4;
+	std::vector<uint8_t> out(headerSize + dataSize, 0);
+	auto put16 = [&out](size_t at, uint32_t v) {
+		out[at] = (uint8_t)v;
+		out[at + 1] = (uint8_t)(v >> 8);
+	};
+	auto put32 = [&out](size_t at, uint32_t v) {
+		for (int i = 0; i < 4; i++) out[at + i] = (uint8_t)(v >> (i * 8));
+	};
+	out[0] = 'B';
+	out[1] = 'M';
+	put32(2, headerSize + dataSize);
+	put32(10, headerSize);
+	put32(14, 40);
+	put32(18, (uint32_t)_width);
+	put32(22, (uint32_t)(-_height)); // 负高度：自上而下
+	put16(26, 1);
+	put16(28, 32);
+	put32(34, dataSize);
+	put32(38, 2835);
+	put32(42, 2835);
+	for (size_t i = 0; i < _pixels.size(); i++)
+		put32(headerSize + i * 4, _pixels[i]);
+	return out;
+}
+
+// ---- BoxGlyphSource ----
+
+float BoxGlyphSource::LineHeight(float fontSize) const {
+	return std::ceil(fontSize * 1.2f);
+}
+
+bool BoxGlyphSource::GetGlyph(wchar_t ch, float fontSize, GlyphBitmap& out) {
+	out = GlyphBitmap();
+	float advance = IsWideChar(ch) ? fontSize : fontSize * 0.6f;
+	if (ch == L'\t') advance = fontSize * 0.6f * 4.0f;
+	out.Advance = advance;
+	if (ch <= L' ' || ch == 0x3000) return true;
+	out.Left = (int)std::lround(advance * 0.1f);
+	out.Top = (int)std::lround(fontSize * 0.3f);
+	out.Width = (std::max)(1, (int)std::lround(advance * 0.8f));
+	out.Height = (std::max)(1, (int)std::lround(fontSize * 0.7f));
+	out.Coverage.assign((size_t)out.Width * out.Height, 255);
+	return true;
+}
+
+// ---- SoftwareRasterizer ----
+
+SoftwareRasterizer::SoftwareRasterizer(PixelBuffer* target)
+	: _target(target), _glyphs(&_defaultGlyphs) {
+}
+
+void SoftwareRasterizer::SetGlyphSource(GlyphSource* source) {
+	_glyphs = source ? source : &_defaultGlyphs;
+	_glyphCache.clear();
+}
+
+void SoftwareRasterizer::ResetState() {
+	_clips.clear();
+	const float identity[6] = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+	std::memcpy(_m, identity, sizeof(_m));
+	_antialias = true;
+}
+
+SoftwareRasterizer::IntRect SoftwareRasterizer::CurrentClip() const {
+	IntRect full{ 0, 0, _target ? _target->Width() : 0, _target ? _target->Height() : 0 };
+	if (_clips.empty()) return full;
+	return _clips.back();
+}
+
+SoftwareRasterizer::Point SoftwareRasterizer::Map(float x, float y) const {
+	return Point{ _m[0] * x + _m[2] * y + _m[4], _m[1] * x + _m[3] * y + _m[5] };
+}
+
+bool SoftwareRasterizer::IsTranslationOnly() const {
+	return _m[0] == 1.0f && _m[1] == 0.0f && _m[2] == 0.0f && _m[3] == 1.0f;
+}
+
+void SoftwareRasterizer::Render(const DisplayList& list) {
+	ResetState();
+	for (const auto& c : list.Commands())
+		Execute(list, c);
+	ResetState();
+}
+
+void SoftwareRasterizer::Execute(const DisplayList& list, const DisplayCommand& c) {
+	if (!_target || _target->IsEmpty()) return;
+	_stats.Commands++;
+	const bool brushPaint = (c.Flags & DisplayFlagBrushResource) != 0;
+	auto rectOf = [](const DisplayCommand& cmd) { return DisplayRect{ cmd.X, cmd.Y, cmd.Z, cmd.W }; };
+	auto sourceOf = [&list](const DisplayCommand& cmd, DisplayRect& out) {
+		if (!(cmd.Flags & DisplayFlagSource)) return false;
+		const float* s = list.Floats(cmd.Data);
+		out = DisplayRect{ s[0], s[1], s[2], s[3] };
+		return true;
+	};
+	// 外部画刷只有后端能解释
+	if (brushPaint) {
+		_stats.Skipped++;
+		return;
+	}
+	switch (c.Op) {
+	case DisplayOp::Clear:
+		Clear(list.Color(c.Paint));
+		break;
+	case DisplayOp::PushClip:
+		PushClip(rectOf(c));
+		break;
+	case DisplayOp::PopClip:
+		PopClip();
+		break;
+	case DisplayOp::SetTransform:
+		SetTransform(list.Floats(c.Data));
+		break;
+	case DisplayOp::SetAntialias:
+		// D2D1_ANTIALIAS_MODE_ALIASED = 1
+		SetAntialias(c.Mode != 1);
+		break;
+	case DisplayOp::SetTextAntialias:
+		break;
+	case DisplayOp::FillRect:
+		FillRect(rectOf(c), list.Color(c.Paint));
+		break;
+	case DisplayOp::DrawRect:
+		DrawRect(rectOf(c), list.Color(c.Paint), c.A);
+		break;
+	case DisplayOp::FillRoundRect:
+		FillRoundRect(rectOf(c), c.B, list.Color(c.Paint));
+		break;
+	case DisplayOp::DrawRoundRect:
+		DrawRoundRect(rectOf(c), c.B, list.Color(c.Paint), c.A);
+		break;
+	case DisplayOp::FillEllipse:
+		FillEllipse(c.X, c.Y, c.Z, c.W, list.Color(c.Paint));
+		break;
+	case DisplayOp::DrawEllipse:
+		DrawEllipse(c.X, c.Y, c.Z, c.W, list.Color(c.Paint), c.A);
+		break;
+	case DisplayOp::DrawLine:
+		DrawLine(c.X, c.Y, c.Z, c.W, list.Color(c.Paint), c.A);
+		break;
+	case DisplayOp::FillPolygon:
+		FillPolygon(list.Floats(c.Data), c.Count, list.Color(c.Paint));
+		break;
+	case DisplayOp::DrawPolygon:
+		DrawPolygon(list.Floats(c.Data), c.Count, list.Color(c.Paint), c.A);
+		break;
+	case DisplayOp::FillPie:
+		FillPie(c.X, c.Y, c.Z, c.W, c.A, c.B, list.Color(c.Paint));
+		break;
+	case DisplayOp::DrawArc:
+		DrawArc(c.X, c.Y, c.Z, c.A, c.B, (c.Flags & DisplayFlagCounter) != 0, list.Color(c.Paint), c.W);
+		break;
+	case DisplayOp::DrawBitmap:
+	case DisplayOp::FillOpacityMask: {
+		const PixelBuffer* image = ResolveImage ? ResolveImage(list.Resource(c.Resource)) : nullptr;
+		if (!image || image->IsEmpty()) {
+			_stats.Skipped++;
+			break;
+		}
+		DisplayRect src;
+		bool hasSource = sourceOf(c, src);
+		if (c.Op == DisplayOp::DrawBitmap)
+			DrawBitmap(*image, rectOf(c), hasSource ? &src : nullptr, c.A);
+		else
+			FillOpacityMask(*image, rectOf(c), hasSource ? &src : nullptr, list.Color(c.Paint));
+		break;
+	}
+	case DisplayOp::DrawString:
+		DrawStringCommand(list, c);
+		break;
+	default:
+		// 几何、网格、DXGI 表面与文本布局：资源只有后端能解释
+		_stats.Skipped++;
+		break;
+	}
+}
+
+void SoftwareRasterizer::Clear(const DisplayColor& color) {
+	IntRect clip = CurrentClip();
+	uint32_t value = PixelBuffer::Pack(color);
+	for (int y = clip.top; y < clip.bottom; y++)
+		FillSpan(_target->Row(y) + clip.left, clip.right - clip.left, value);
+	if (clip.right > clip.left && clip.bottom > clip.top)
+		_stats.PixelsTouched += (size_t)(clip.right - clip.left) * (clip.bottom - clip.top);
+}
+
+void SoftwareRasterizer::PushClip(const DisplayRect& rect) {
+	// 与 PushAxisAlignedClip 一致：裁剪矩形经当前变换后取外接矩形；边界取整到像素
+	Point p[4] = { Map(rect.left, rect.top), Map(rect.right, rect.top), Map(rect.right, rect.bottom), Map(rect.left, rect.bottom) };
+	float l = p[0].x, t = p[0].y, r = p[0].x, b = p[0].y;
+	for (const auto& q : p) {
+		l = (std::min)(l, q.x); t = (std::min)(t, q.y);
+		r = (std::max)(r, q.x); b = (std::max)(b, q.y);
+	}
+	IntRect cur = CurrentClip();
+	IntRect next{
+		(std::max)(cur.left, (int)std::lround(l)),
+		(std::max)(cur.top, (int)std::lround(t)),
+		(std::min)(cur.right, (int)std::lround(r)),
+		(std::min)(cur.bottom, (int)std::lround(b)) };
+	if (next.right < next.left) next.right = next.left;
+	if (next.bottom < next.top) next.bottom = next.top;
+	_clips.push_back(next);
+}
+
+void SoftwareRasterizer::PopClip() {
+	if (!_clips.empty()) _clips.pop_back();
+}
+
+void SoftwareRasterizer::SetTransform(const float matrix[6]) {
+	std::memcpy(_m, matrix, sizeof(_m));
+}
+
+void SoftwareRasterizer::FillContours(const std::vector<Contour>& contours, const DisplayColor& color) {
+	uint32_t src = PixelBuffer::Pack(color);
+	if (src == 0) return;
+	float minX = 0, minY = 0, maxX = 0, maxY = 0;
+	bool any = false;
+	for (const auto& contour : contours) {
+		for (const auto& p : contour) {
+			if (!any) { minX = maxX = p.x; minY = maxY = p.y; any = true; continue; }
+			minX = (std::min)(minX, p.x); maxX = (std::max)(maxX, p.x);
+			minY = (std::min)(minY, p.y); maxY = (std::max)(maxY, p.y);
+		}
+	}
+	if (!any) return;
+	IntRect clip = CurrentClip();
+	// 轮廓在区域左侧的部分由 AccumulateLine 压到第 0 列，绕数不会丢失
+	int x0 = (std::max)(clip.left, (int)std::floor(minX));
+	int y0 = (std::max)(clip.top, (int)std::floor(minY));
+	int x1 = (std::min)(clip.right, (int)std::ceil(maxX));
+	int y1 = (std::min)(clip.bottom, (int)std::ceil(maxY));
+	if (x1 <= x0 || y1 <= y0) return;
+	const int w = x1 - x0;
+	const int h = y1 - y0;
+	const int stride = w + 2;
+	_accum.assign((size_t)stride * h, 0.0f);
+	_mask.resize((size_t)w);
+	for (const auto& contour : contours) {
+		const size_t n = contour.size();
+		if (n < 2) continue;
+		for (size_t i = 0; i < n; i++) {
+			const Point& a = contour[i];
+			const Point& b = contour[(i + 1) % n];
+			AccumulateLine(_accum.data(), stride, w, h, a.x - x0, a.y - y0, b.x - x0, b.y - y0);
+		}
+	}
+	for (int y = 0; y < h; y++) {
+		float* row = _accum.data() + (size_t)y * stride;
+		float acc = 0.0f;
+		bool touched = false;
+		for (int x = 0; x < w; x++) {
+			acc += row[x];
+			uint8_t m = ToCoverage(std::fabs(acc), _antialias);
+			_mask[x] = m;
+			touched |= (m != 0);
+		}
+		if (touched)
+			_stats.PixelsTouched += BlendMask(_target->Row(y0 + y) + x0, _mask.data(), w, src);
+	}
+}
+
+void SoftwareRasterizer::AddRectContour(std::vector<Contour>& out, float l, float t, float r, float b, bool reverse) const {
+	Contour c{ Map(l, t), Map(r, t), Map(r, b), Map(l, b) };
+	if (reverse) std::reverse(c.begin(), c.end());
+	out.push_back(std::move(c));
+}
+
+void SoftwareRasterizer::AddEllipseContour(std::vector<Contour>& out, float cx, float cy, float rx, float ry, bool reverse) const {
+	if (rx <= 0.0f || ry <= 0.0f) return;
+	float scale = (std::max)(std::fabs(_m[0]) + std::fabs(_m[2]), std::fabs(_m[1]) + std::fabs(_m[3]));
+	int n = ArcSegments((std::max)(rx, ry) * scale, 2.0f * Pi);
+	Contour c;
+	c.reserve((size_t)n);
+	for (int i = 0; i < n; i++) {
+		float a = 2.0f * Pi * (float)i / (float)n;
+		c.push_back(Map(cx + rx * std::cos(a), cy + ry * std::sin(a)));
+	}
+	if (reverse) std::reverse(c.begin(), c.end());
+	out.push_back(std::move(c));
+}
+
+void SoftwareRasterizer::AddRoundRectContour(std::vector<Contour>& out, float l, float t, float r, float b, float radius, bool reverse) const {
+	if (r <= l || b <= t) return;
+	radius = (std::min)(radius, (std::min)(r - l, b - t) * 0.5f);
+	if (radius <= 0.0f) {
+		AddRectContour(out, l, t, r, b, reverse);
+		return;
+	}
+	float scale = (std::max)(std::fabs(_m[0]) + std::fabs(_m[2]), std::fabs(_m[1]) + std::fabs(_m[3]));
+	int n = ArcSegments(radius * scale, 0.5f * Pi);
+	// 左上、右上、右下、左下四段四分之一圆弧（屏幕坐标下顺时针）
+	const float centers[4][2] = { { l + radius, t + radius }, { r - radius, t + radius }, { r - radius, b - radius }, { l + radius, b - radius } };
+	Contour c;
+	c.reserve((size_t)(n + 1) * 4);
+	for (int corner = 0; corner < 4; corner++) {
+		float start = Pi + corner * 0.5f * Pi;
+		for (int i = 0; i <= n; i++) {
+			float a = start + 0.5f * Pi * (float)i / (float)n;
+			c.push_back(Map(centers[corner][0] + radius * std::cos(a), centers[corner][1] + radius * std::sin(a)));
+		}
+	}
+	if (reverse) std::reverse(c.begin(), c.end());
+	out.push_back(std::move(c));
+}
+
+void SoftwareRasterizer::AddStrokeSegments(std::vector<Contour>& out, const std::vector<Point>& points, bool closed, float width) const {
+	if (points.size() < 2 || width <= 0.0f) return;
+	const float half = width * 0.5f;
+	// 每段一个四边形、每个拐点一对斜接三角形；统一为同一绕向，重叠处覆盖率只截断为 1 而不会抵消
+	auto push = [&out](Contour c) {
+		float area = 0.0f;
+		for (size_t i = 0; i < c.size(); i++) {
+			const Point& a = c[i];
+			const Point& b = c[(i + 1) % c.size()];
+			area += a.x * b.y - b.x * a.y;
+		}
+		if (area == 0.0f) return;
+		if (area < 0.0f) std::reverse(c.begin(), c.end());
+		out.push_back(std::move(c));
+	};
+	const size_t n = points.size();
+	const size_t segments = closed ? n : n - 1;
+	std::vector<Point> normals(segments);
+	for (size_t i = 0; i < segments; i++) {
+		const Point& p = points[i];
+		const Point& q = points[(i + 1) % n];
+		float dx = q.x - p.x, dy = q.y - p.y;
+		float len = std::sqrt(dx * dx + dy * dy);
+		if (len <= 0.0f) { normals[i] = Point{ 0.0f, 0.0f }; continue; }
+		Point nrm{ -dy / len * half, dx / len * half };
+		normals[i] = nrm;
+		push(Contour{ Map(p.x + nrm.x, p.y + nrm.y), Map(q.x + nrm.x, q.y + nrm.y), Map(q.x - nrm.x, q.y - nrm.y), Map(p.x - nrm.x, p.y - nrm.y) });
+	}
+	for (size_t i = closed ? 0 : 1; i < (closed ? n : n - 1); i++) {
+		const Point& v = points[i];
+		const Point& n0 = normals[(i + segments - 1) % segments];
+		const Point& n1 = normals[i % segments];
+		push(Contour{ Map(v.x, v.y), Map(v.x + n0.x, v.y + n0.y), Map(v.x + n1.x, v.y + n1.y) });
+		push(Contour{ Map(v.x, v.y), Map(v.x - n0.x, v.y - n0.y), Map(v.x - n1.x, v.y - n1.y) });
+	}
+}
+
+void SoftwareRasterizer::FillRect(const DisplayRect& rect, const DisplayColor& color) {
+	if (rect.right <= rect.left || rect.bottom <= rect.top) return;
+	if (!IsTranslationOnly()) {
+		std::vector<Contour> contours;
+		AddRectContour(contours, rect.left, rect.top, rect.right, rect.bottom, false);
+		FillContours(contours, color);
+		return;
+	}
+	FillAxisRect(rect, nullptr, color);
+}
+
+void SoftwareRasterizer::FillAxisRect(const DisplayRect& outer, const DisplayRect* inner, const DisplayColor& color) {
+	uint32_t src = PixelBuffer::Pack(color);
+	if (src == 0) return;
+	auto place = [this](const DisplayRect& in) {
+		DisplayRect out{ in.left + _m[4], in.top + _m[5], in.right + _m[4], in.bottom + _m[5] };
+		if (!_antialias) {
+			out.left = std::round(out.left); out.top = std::round(out.top);
+			out.right = std::round(out.right); out.bottom = std::round(out.bottom);
+		}
+		return out;
+	};
+	DisplayRect o = place(outer);
+	DisplayRect in = inner ? place(*inner) : DisplayRect{};
+	const bool hasInner = inner && in.right > in.left && in.bottom > in.top;
+	IntRect clip = CurrentClip();
+	o.left = (std::max)(o.left, (float)clip.left);
+	o.top = (std::max)(o.top, (float)clip.top);
+	o.right = (std::min)(o.right, (float)clip.right);
+	o.bottom = (std::min)(o.bottom, (float)clip.bottom);
+	if (o.right <= o.left || o.bottom <= o.top) return;
+	const int x0 = (int)std::floor(o.left), x1 = (int)std::ceil(o.right);
+	const int y0 = (int)std::floor(o.top), y1 = (int)std::ceil(o.bottom);
+	// 外矩形完全覆盖的列
+	const int fullL = (std::min)((int)std::ceil(o.left), x1);
+	const int fullR = (std::max)((int)std::floor(o.right), fullL);
+	for (int y = y0; y < y1; y++) {
+		const float vy = Overlap(o.top, o.bottom, y);
+		const float iy = hasInner ? Overlap(in.top, in.bottom, y) : 0.0f;
+		uint32_t* row = _target->Row(y);
+		// 中段：外矩形与内矩形（若本行有）都整列覆盖，覆盖率为常数，整段走 SIMD
+		int midL = fullL, midR = fullR;
+		if (iy > 0.0f) {
+			midL = (std::max)(midL, (int)std::ceil(in.left));
+			midR = (std::min)(midR, (int)std::floor(in.right));
+			if (midR < midL) midR = midL;
+		}
+		auto edge = [&](int x) {
+			float cov = Overlap(o.left, o.right, x) * vy;
+			if (iy > 0.0f) cov -= Overlap(in.left, in.right, x) * iy;
+			uint8_t m = ToCoverage(cov, true);
+			if (!m) return;
+			row[x] = BlendPixel(row[x], m == 255 ? src : ScalePixel(src, m));
+			_stats.PixelsTouched++;
+		};
+		for (int x = x0; x < midL; x++) edge(x);
+		uint8_t midCov = ToCoverage(vy - iy, true);
+		if (midCov && midR > midL) {
+			BlendSpan(row + midL, midR - midL, midCov == 255 ? src : ScalePixel(src, midCov));
+			_stats.PixelsTouched += (size_t)(midR - midL);
+		}
+		for (int x = (std::max)(midR, midL); x < x1; x++) edge(x);
+	}
+}
+
+void SoftwareRasterizer::DrawRect(const DisplayRect& rect, const DisplayColor& color, float width) {
+	if (width <= 0.0f) return;
+	const float h = width * 0.5f;
+	const DisplayRect outer{ rect.left - h, rect.top - h, rect.right + h, rect.bottom + h };
+	const DisplayRect inner{ rect.left + h, rect.top + h, rect.right - h, rect.bottom - h };
+	if (IsTranslationOnly()) {
+		FillAxisRect(outer, &inner, color);
+		return;
+	}
+	std::vector<Contour> contours;
+	AddRectContour(contours, outer.left, outer.top, outer.right, outer.bottom, false);
+	if (inner.right > inner.left && inner.bottom > inner.top)
+		AddRectContour(contours, inner.left, inner.top, inner.right, inner.bottom, true);
+	FillContours(contours, color);
+}
+
+void SoftwareRasterizer::FillRoundRect(const DisplayRect& rect, float radius, const DisplayColor& color) {
+	if (radius <= 0.0f) {
+		FillRect(rect, color);
+		return;
+	}
+	std::vector<Contour> contours;
+	AddRoundRectContour(contours, rect.left, rect.top, rect.right, rect.bottom, radius, false);
+	FillContours(contours, color);
+}
+
+void SoftwareRasterizer::DrawRoundRect(const DisplayRect& rect, float radius, const DisplayColor& color, float width) {
+	if (width <= 0.0f) return;
+	if (radius <= 0.0f) {
+		DrawRect(rect, color, width);
+		return;
+	}
+	const float h = width * 0.5f;
+	std::vector<Contour> contours;
+	AddRoundRectContour(contours, rect.left - h, rect.top - h, rect.right + h, rect.bottom + h, radius + h, false);
+	AddRoundRectContour(contours, rect.left + h, rect.top + h, rect.right - h, rect.bottom - h, (std::max)(radius - h, 0.0f), true);
+	FillContours(contours, color);
+}
+
+void SoftwareRasterizer::FillEllipse(float cx, float cy, float rx, float ry, const DisplayColor& color) {
+	std::vector<Contour> contours;
+	AddEllipseContour(contours, cx, cy, rx, ry, false);
+	FillContours(contours, color);
+}
+
+void SoftwareRasterizer::DrawEllipse(float cx, float cy, float rx, float ry, const DisplayColor& color, float width) {
+	if (width <= 0.0f) return;
+	const float h = width * 0.5f;
+	std::vector<Contour> contours;
+	AddEllipseContour(contours, cx, cy, rx + h, ry + h, false);
+	AddEllipseContour(contours, cx, cy, rx - h, ry - h, true);
+	FillContours(contours, color);
+}
+
+void SoftwareRasterizer::DrawLine(float x1, float y1, float x2, float y2, const DisplayColor& color, float width) {
+	std::vector<Contour> contours;
+	AddStrokeSegments(contours, std::vector<Point>{ Point{ x1, y1 }, Point{ x2, y2 } }, false, width);
+	FillContours(contours, color);
+}
+
+void SoftwareRasterizer::FillPolygon(const float* points, size_t count, const DisplayColor& color) {
+	if (count < 3) return;
+	std::vector<Contour> contours(1);
+	contours[0].reserve(count);
+	for (size_t i = 0; i < count; i++)
+		contours[0].push_back(Map(points[i * 2], points[i * 2 + 1]));
+	FillContours(contours, color);
+}
+
+void SoftwareRasterizer::DrawPolygon(const float* points, size_t count, const DisplayColor& color, float width) {
+	if (count < 2) return;
+	std::vector<Point> pts;
+	pts.reserve(count);
+	for (size_t i = 0; i < count; i++)
+		pts.push_back(Point{ points[i * 2], points[i * 2 + 1] });
+	// 与 D2DGraphics::DrawPolygon 一致：开放折线
+	std::vector<Contour> contours;
+	AddStrokeSegments(contours, pts, false, width);
+	FillContours(contours, color);
+}
+
+void SoftwareRasterizer::FillPie(float cx, float cy, float width, float height, float startAngle, float sweepAngle, const DisplayColor& color) {
+	if (width <= 0.0f || height <= 0.0f || sweepAngle == 0.0f) return;
+	if (std::fabs(sweepAngle) >= 360.0f) {
+		FillEllipse(cx, cy, width * 0.5f, height * 0.5f, color);
+		return;
+	}
+	const float rx = width * 0.5f, ry = height * 0.5f;
+	const float start = startAngle * DegToRad;
+	const float sweep = sweepAngle * DegToRad;
+	int n = ArcSegments((std::max)(rx, ry), sweep);
+	std::vector<Contour> contours(1);
+	Contour& c = contours[0];
+	c.push_back(Map(cx, cy));
+	for (int i = 0; i <= n; i++) {
+		float a = start + sweep * (float)i / (float)n;
+		c.push_back(Map(cx + rx * std::cos(a), cy - ry * std::sin(a)));
+	}
+	FillContours(contours, color);
+}
+
+void SoftwareRasterizer::DrawArc(float cx, float cy, float radius, float startAngle, float endAngle, bool counter, const DisplayColor& color, float width) {
+	if (radius <= 0.0f) return;
+	float ts = startAngle, te = endAngle;
+	if (!counter && te < ts) te += 360.0f;
+	if (counter && te > ts) te -= 360.0f;
+	const float sweep = (te - ts) * DegToRad;
+	int n = ArcSegments(radius, sweep);
+	std::vector<Point> pts;
+	pts.reserve((size_t)n + 1);
+	for (int i = 0; i <= n; i++) {
+		float a = ts * DegToRad + sweep * (float)i / (float)n;
+		pts.push_back(Point{ cx + std::sin(a) * radius, cy - std::cos(a) * radius });
+	}
+	std::vector<Contour> contours;
+	AddStrokeSegments(contours, pts, false, width);
+	FillContours(contours, color);
+}
+
+template <class Write>
+void SoftwareRasterizer::SampleImage(const PixelBuffer& image, const DisplayRect& dest, const DisplayRect* src, Write write) {
+	DisplayRect s = src ? *src : DisplayRect{ 0.0f, 0.0f, (float)image.Width(), (float)image.Height() };
+	if (s.right <= s.left || s.bottom <= s.top) return;
+	// 目标矩形经变换后取外接矩形（旋转时按外接矩形拉伸）
+	Point a = Map(dest.left, dest.top);
+	Point b = Map(dest.right, dest.bottom);
+	float l = (std::min)(a.x, b.x), r = (std::max)(a.x, b.x);
+	float t = (std::min)(a.y, b.y), bt = (std::max)(a.y, b.y);
+	if (r <= l || bt <= t) return;
+	IntRect clip = CurrentClip();
+	int x0 = (std::max)(clip.left, (int)std::lround(l));
+	int x1 = (std::min)(clip.right, (int)std::lround(r));
+	int y0 = (std::max)(clip.top, (int)std::lround(t));
+	int y1 = (std::min)(clip.bottom, (int)std::lround(bt));
+	if (x1 <= x0 || y1 <= y0) return;
+	const float sx = (s.right - s.left) / (r - l);
+	const float sy = (s.bottom - s.top) / (bt - t);
+	const float maxX = (std::min)(s.right, (float)image.Width()) - 1.0f;
+	const float maxY = (std::min)(s.bottom, (float)image.Height()) - 1.0f;
+	const float minX = (std::max)(s.left, 0.0f);
+	const float minY = (std::max)(s.top, 0.0f);
+	auto lerp = [](uint32_t p, uint32_t q, uint32_t f) {
+		// f 为 0~256 的权重
+		uint32_t rb = ((p & 0x00FF00FFu) * (256 - f) + (q & 0x00FF00FFu) * f) >> 8;
+		uint32_t ag = (((p >> 8) & 0x00FF00FFu) * (256 - f) + ((q >> 8) & 0x00FF00FFu) * f) >> 8;
+		return (rb & 0x00FF00FFu) | ((ag & 0x00FF00FFu) << 8);
+	};
+	for (int y = y0; y < y1; y++) {
+		float v = s.top + ((float)y + 0.5f - t) * sy - 0.5f;
+		v = (std::min)((std::max)(v, minY), maxY);
+		int vy = (int)v;
+		int vy1 = (std::min)(vy + 1, (int)maxY);
+		uint32_t fy = (uint32_t)((v - (float)vy) * 256.0f);
+		const uint32_t* r0 = image.Row(vy);
+		const uint32_t* r1 = image.Row(vy1);
+		uint32_t* dst = _target->Row(y);
+		for (int x = x0; x < x1; x++) {
+			float u = s.left + ((float)x + 0.5f - l) * sx - 0.5f;
+			u = (std::min)((std::max)(u, minX), maxX);
+			int ux = (int)u;
+			int ux1 = (std::min)(ux + 1, (int)maxX);
+			uint32_t fx = (uint32_t)((u - (float)ux) * 256.0f);
+			uint32_t top = lerp(r0[ux], r0[ux1], fx);
+			uint32_t bottom = lerp(r1[ux], r1[ux1], fx);
+			write(dst + x, lerp(top, bottom, fy));
+		}
+		_stats.PixelsTouched += (size_t)(x1 - x0);
+	}
+}
+
+void SoftwareRasterizer::DrawBitmap(const PixelBuffer& image, const DisplayRect& dest, const DisplayRect* src, float opacity) {
+	uint32_t k = (uint32_t)((std::min)((std::max)(opacity, 0.0f), 1.0f) * 255.0f + 0.5f);
+	if (k == 0) return;
+	SampleImage(image, dest, src, [k](uint32_t* dst, uint32_t sample) {
+		*dst = BlendPixel(*dst, k == 255 ? sample : ScalePixel(sample, k));
+		});
+}
+
+void SoftwareRasterizer::FillOpacityMask(const PixelBuffer& mask, const DisplayRect& dest, const DisplayRect* src, const DisplayColor& color) {
+	uint32_t value = PixelBuffer::Pack(color);
+	if (value == 0) return;
+	SampleImage(mask, dest, src, [value](uint32_t* dst, uint32_t sample) {
+		uint32_t m = sample >> 24;
+		if (m) *dst = BlendPixel(*dst, m == 255 ? value : ScalePixel(value, m));
+		});
+}
+
+const GlyphBitmap* SoftwareRasterizer::Glyph(wchar_t ch, float fontSize) {
+	auto key = std::make_pair(ch, (int)std::lround(fontSize * 4.0f));
+	auto it = _glyphCache.find(key);
+	if (it != _glyphCache.end()) return &it->second;
+	GlyphBitmap glyph;
+	if (!_glyphs->GetGlyph(ch, fontSize, glyph)) return nullptr;
+	return &_glyphCache.emplace(key, std::move(glyph)).first->second;
+}
+
+void SoftwareRasterizer::MeasureString(const std::wstring& text, float fontSize, float& width, float& height) {
+	const float lineHeight = _glyphs->LineHeight(fontSize);
+	float line = 0.0f;
+	width = 0.0f;
+	height = text.empty() ? 0.0f : lineHeight;
+	for (wchar_t ch : text) {
+		if (ch == L'\r') continue;
+		if (ch == L'\n') {
+			width = (std::max)(width, line);
+			line = 0.0f;
+			height += lineHeight;
+			continue;
+		}
+		if (const GlyphBitmap* g = Glyph(ch, fontSize)) line += g->Advance;
+	}
+	width = (std::max)(width, line);
+}
+
+void SoftwareRasterizer::DrawString(const std::wstring& text, float x, float y, float fontSize, const DisplayColor& color) {
+	uint32_t src = PixelBuffer::Pack(color);
+	if (src == 0 || text.empty()) return;
+	const float lineHeight = _glyphs->LineHeight(fontSize);
+	IntRect clip = CurrentClip();
+	// 字形不随变换缩放/旋转，只平移笔位置
+	float penX = 0.0f, penY = 0.0f;
+	for (wchar_t ch : text) {
+		if (ch == L'\r') continue;
+		if (ch == L'\n') {
+			penX = 0.0f;
+			penY += lineHeight;
+			continue;
+		}
+		const GlyphBitmap* g = Glyph(ch, fontSize);
+		if (!g) continue;
+		if (g->Width > 0 && g->Height > 0) {
+			Point origin = Map(x + penX, y + penY);
+			int gx = (int)std::lround(origin.x) + g->Left;
+			int gy = (int)std::lround(origin.y) + g->Top;
+			int cx0 = (std::max)(gx, clip.left);
+			int cx1 = (std::min)(gx + g->Width, clip.right);
+			int cy0 = (std::max)(gy, clip.top);
+			int cy1 = (std::min)(gy + g->Height, clip.bottom);
+			for (int row = cy0; row < cy1 && cx1 > cx0; row++) {
+				const uint8_t* cov = g->Coverage.data() + (size_t)(row - gy) * g->Width + (cx0 - gx);
+				_stats.PixelsTouched += BlendMask(_target->Row(row) + cx0, cov, cx1 - cx0, src);
+			}
+		}
+		penX += g->Advance;
+	}
+}
+
+void SoftwareRasterizer::DrawStringCommand(const DisplayList& list, const DisplayCommand& c) {
+	const std::wstring& text = list.String(c.Data);
+	void* font = list.Resource(c.Resource);
+	float size = (ResolveFontSize && font) ? ResolveFontSize(font) : DefaultFontSize;
+	if (size <= 0.0f) size = DefaultFontSize;
+	float x = c.X, y = c.Y;
+	if (c.Flags & DisplayFlagCentered) {
+		float w = 0.0f, h = 0.0f;
+		MeasureString(text, size, w, h);
+		x -= w * 0.5f;
+		y -= h * 0.5f;
+	}
+	const bool bounded = (c.Flags & DisplayFlagBounded) != 0;
+	if (bounded) PushClip(DisplayRect{ c.X, c.Y, c.X + c.Z, c.Y + c.W });
+	if (c.Flags & DisplayFlagOutlined) {
+		// 轮廓近似：四向偏移 1 像素绘制轮廓色，再绘制正文
+		const DisplayColor& outline = list.Color(c.Paint2);
+		const float offsets[4][2] = { { -1.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, -1.0f }, { 0.0f, 1.0f } };
+		for (const auto& o : offsets)
+			DrawString(text, x + o[0], y + o[1], size, outline);
+	}
+	DrawString(text, x, y, size, list.Color(c.Paint));
+	if (bounded) PopClip();
+}
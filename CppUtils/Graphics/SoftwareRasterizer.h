@@ -0,0 +1,198 @@
+#pragma once
+#include "DisplayList.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @file SoftwareRasterizer.h
+ * @brief SoftwareRasterizer：在 CPU 上把 DisplayList 光栅化到像素缓冲区。
+ *
+ * 与 D2DGraphics 共用 DisplayList 作为绘制接口：窗口里录制（D2DGraphics::BeginRecording /
+ * RecordingGraphics）或直接构造的命令列表，可以在没有 Direct2D 的环境（Linux CI、服务器）
+ * 中渲染成像素，用于截图与逐像素比较。本文件不依赖 Win32/D2D。
+ *
+ * 支持：
+ * - 矩形/圆角矩形/椭圆/多边形/饼图/圆弧的填充与描边（覆盖率累积抗锯齿，SetAntialias 可切换为无抗锯齿）
+ * - 轴对齐裁剪栈（PushClip/PopClip）与仿射变换
+ * - 位图与不透明遮罩（双线性采样、整体不透明度），像素由 ResolveImage 提供
+ * - 文本（DrawString）：字形由可替换的 GlyphSource 提供，默认用方块字形保证输出确定
+ *
+ * 不支持、计入 Stats::Skipped 的命令：外部画刷、几何/网格、DXGI 表面、文本布局
+ * （这些资源只有后端能解释）。
+ */
+
+/**
+ * @brief 32 位预乘 BGRA 像素缓冲区（与 WIC 32bppPBGRA / DXGI_FORMAT_B8G8R8A8_UNORM 一致）。
+ *
+ * 每个像素按 0xAARRGGBB 存为 uint32_t，小端内存顺序即 B、G、R、A。
+ */
+class PixelBuffer
+{
+public:
+	PixelBuffer() = default;
+	PixelBuffer(int width, int height, uint32_t fill = 0);
+
+	void Resize(int width, int height, uint32_t fill = 0);
+	int Width() const { return _width; }
+	int Height() const { return _height; }
+	bool IsEmpty() const { return _width <= 0 || _height <= 0; }
+	uint32_t* Row(int y) { return _pixels.data() + (size_t)y * _width; }
+	const uint32_t* Row(int y) const { return _pixels.data() + (size_t)y * _width; }
+	uint32_t Get(int x, int y) const { return _pixels[(size_t)y * _width + x]; }
+	void Set(int x, int y, uint32_t value) { _pixels[(size_t)y * _width + x] = value; }
+	std::vector<uint32_t>& Pixels() { return _pixels; }
+	const std::vector<uint32_t>& Pixels() const { return _pixels; }
+
+	/** @brief 颜色转为预乘像素。 */
+	static uint32_t Pack(const DisplayColor& color);
+	/** @brief 像素转回颜色（去预乘）。 */
+	static DisplayColor Unpack(uint32_t pixel);
+
+	/**
+	 * @brief 逐像素比较：任一通道差值超过 tolerance 的像素数。
+	 * @return 尺寸不同时返回两者像素数的较大值。
+	 */
+	size_t DiffCount(const PixelBuffer& other, int tolerance = 0) const;
+	/** @brief 编码为 32 位 BMP（自上而下，像素原样写入）。 */
+	std::vector<uint8_t> EncodeBmp() const;
+
+private:
+	int _width = 0;
+	int _height = 0;
+	std::vector<uint32_t> _pixels;
+};
+
+/** @brief 单个字形的覆盖率位图。 */
+struct GlyphBitmap
+{
+	int Width = 0;
+	int Height = 0;
+	/** @brief 位图左上角相对笔位置（行顶）的偏移。 */
+	int Left = 0;
+	int Top = 0;
+	/** @brief 笔位置前进量（像素）。 */
+	float Advance = 0.0f;
+	/** @brief Width * Height 个 0~255 覆盖率。 */
+	std::vector<uint8_t> Coverage;
+};
+
+/** @brief 字形来源：按字符与字号（像素）生成覆盖率位图。 */
+class GlyphSource
+{
+public:
+	virtual ~GlyphSource() = default;
+	virtual float LineHeight(float fontSize) const = 0;
+	virtual bool GetGlyph(wchar_t ch, float fontSize, GlyphBitmap& out) = 0;
+};
+
+/**
+ * @brief 默认字形：每个可见字符画一个实心方块（CJK 全宽，其余半宽）。
+ *
+ * 不追求可读，只保证文本的位置、行数与宽度在任何平台上完全一致，适合像素比较。
+ */
+class BoxGlyphSource : public GlyphSource
+{
+public:
+	float LineHeight(float fontSize) const override;
+	bool GetGlyph(wchar_t ch, float fontSize, GlyphBitmap& out) override;
+};
+
+class SoftwareRasterizer
+{
+public:
+	struct Stats
+	{
+		size_t Commands = 0;
+		/** @brief 无法在 CPU 上解释而跳过的命令。 */
+		size_t Skipped = 0;
+		/** @brief 写入的像素数（含部分覆盖）。 */
+		size_t PixelsTouched = 0;
+	};
+
+	explicit SoftwareRasterizer(PixelBuffer* target);
+
+	/** @brief 位图/遮罩资源 → 像素；返回 nullptr 时跳过该命令。 */
+	std::function<const PixelBuffer*(void* resource)> ResolveImage;
+	/** @brief 字体资源 → 字号（像素）；未设置或资源为空时使用 DefaultFontSize。 */
+	std::function<float(void* font)> ResolveFontSize;
+	float DefaultFontSize = 18.0f;
+
+	/** @brief 设置字形来源（不接管所有权）；nullptr 恢复默认方块字形。 */
+	void SetGlyphSource(GlyphSource* source);
+
+	/** @brief 渲染整个列表（裁剪栈与变换在开始前重置）。 */
+	void Render(const DisplayList& list);
+	/** @brief 渲染单条命令。 */
+	void Execute(const DisplayList& list, const DisplayCommand& command);
+	/** @brief 重置裁剪栈、变换与抗锯齿模式。 */
+	void ResetState();
+	const Stats& GetStats() const { return _stats; }
+	void ResetStats() { _stats = Stats(); }
+
+	// ---- 直接绘制（坐标经当前变换）----
+	void Clear(const DisplayColor& color);
+	void PushClip(const DisplayRect& rect);
+	void PopClip();
+	/** @brief 3x2 仿射矩阵（m11, m12, m21, m22, dx, dy）。 */
+	void SetTransform(const float matrix[6]);
+	void SetAntialias(bool enabled) { _antialias = enabled; }
+	void FillRect(const DisplayRect& rect, const DisplayColor& color);
+	void DrawRect(const DisplayRect& rect, const DisplayColor& color, float width);
+	void FillRoundRect(const DisplayRect& rect, float radius, const DisplayColor& color);
+	void DrawRoundRect(const DisplayRect& rect, float radius, const DisplayColor& color, float width);
+	void FillEllipse(float cx, float cy, float rx, float ry, const DisplayColor& color);
+	void DrawEllipse(float cx, float cy, float rx, float ry, const DisplayColor& color, float width);
+	void DrawLine(float x1, float y1, float x2, float y2, const DisplayColor& color, float width);
+	/** @param points x0, y0, x1, y1, ... */
+	void FillPolygon(const float* points, size_t count, const DisplayColor& color);
+	/** @brief 开放折线（与 D2DGraphics::DrawPolygon 一致）。 */
+	void DrawPolygon(const float* points, size_t count, const DisplayColor& color, float width);
+	/** @brief 饼图：角度为数学方向（0° 向右，逆时针为正），单位度。 */
+	void FillPie(float cx, float cy, float width, float height, float startAngle, float sweepAngle, const DisplayColor& color);
+	/** @brief 圆弧：角度从 12 点方向顺时针计（与 D2DGraphics::DrawArc 一致）。 */
+	void DrawArc(float cx, float cy, float radius, float startAngle, float endAngle, bool counter, const DisplayColor& color, float width);
+	/** @param src 源矩形（像素）；nullptr 表示整张位图。 */
+	void DrawBitmap(const PixelBuffer& image, const DisplayRect& dest, const DisplayRect* src, float opacity);
+	void FillOpacityMask(const PixelBuffer& mask, const DisplayRect& dest, const DisplayRect* src, const DisplayColor& color);
+	void DrawString(const std::wstring& text, float x, float y, float fontSize, const DisplayColor& color);
+	/** @brief 文本排版尺寸（多行按 '\n' 分行）。 */
+	void MeasureString(const std::wstring& text, float fontSize, float& width, float& height);
+
+private:
+	struct Point { float x, y; };
+	typedef std::vector<Point> Contour;
+	struct IntRect { int left, top, right, bottom; };
+
+	PixelBuffer* _target;
+	std::vector<IntRect> _clips;
+	float _m[6] = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+	bool _antialias = true;
+	Stats _stats;
+
+	BoxGlyphSource _defaultGlyphs;
+	GlyphSource* _glyphs = nullptr;
+	std::map<std::pair<wchar_t, int>, GlyphBitmap> _glyphCache;
+
+	// 覆盖率累积缓冲（按需增长，重复使用）
+	std::vector<float> _accum;
+	std::vector<uint8_t> _mask;
+
+	IntRect CurrentClip() const;
+	Point Map(float x, float y) const;
+	bool IsTranslationOnly() const;
+	void FillContours(const std::vector<Contour>& contours, const DisplayColor& color);
+	void AddRectContour(std::vector<Contour>& out, float l, float t, float r, float b, bool reverse) const;
+	void AddEllipseContour(std::vector<Contour>& out, float cx, float cy, float rx, float ry, bool reverse) const;
+	void AddRoundRectContour(std::vector<Contour>& out, float l, float t, float r, float b, float radius, bool reverse) const;
+	void AddStrokeSegments(std::vector<Contour>& out, const std::vector<Point>& points, bool closed, float width) const;
+	// 轴对齐（仅平移）时的矩形/矩形环：覆盖率 = 外矩形重叠面积 - 内矩形重叠面积
+	void FillAxisRect(const DisplayRect& outer, const DisplayRect* inner, const DisplayColor& color);
+	template <class Write>
+	void SampleImage(const PixelBuffer& image, const DisplayRect& dest, const DisplayRect* src, Write write);
+	const GlyphBitmap* Glyph(wchar_t ch, float fontSize);
+	void DrawStringCommand(const DisplayList& list, const DisplayCommand& c);
+};
@@ -0,0 +1,178 @@
+#include "TextLayoutCache.h"
+#include "Factory.h"
+#include <cmath>
+#include <cstring>
+#include <cwchar>
+#include <iterator>
+
+using Microsoft::WRL::ComPtr;
+
+namespace {
+	D2D1_SIZE_F LayoutSize(IDWriteTextLayout* layout) {
+		DWRITE_TEXT_METRICS metrics;
+		if (!layout || FAILED(layout->GetMetrics(&metrics))) return D2D1_SIZE_F{ 0, 0 };
+		return D2D1::SizeF((float)ceil(metrics.widthIncludingTrailingWhitespace), (float)ceil(metrics.height));
+	}
+
+	uint32_t FloatBits(float f) {
+		uint32_t u = 0;
+		std::memcpy(&u, &f, sizeof(u));
+		return u;
+	}
+}
+
+const size_t TextLayoutCache::MaxCachedLength;
+const size_t TextLayoutCache::DefaultCapacityBytes;
+
+TextLayoutCache& TextLayoutCache::Shared() {
+	static TextLayoutCache* cache = new TextLayoutCache();
+	return *cache;
+}
+
+TextLayoutCache::TextLayoutCache(size_t capacityBytes) : _capacityBytes(capacityBytes) {
+}
+
+uint64_t TextLayoutCache::Hash(const wchar_t* text, size_t length, IDWriteTextFormat* format, float maxWidth, float maxHeight) {
+	uint64_t h = 1469598103934665603ull;
+	auto mix = [&h](uint64_t v) {
+		h ^= v;
+		h *= 1099511628211ull;
+	};
+	for (size_t i = 0; i < length; i++)
+		mix((uint64_t)text[i]);
+	mix((uint64_t)length);
+	mix((uint64_t)(uintptr_t)format);
+	mix(FloatBits(maxWidth));
+	mix(FloatBits(maxHeight));
+	return h;
+}
+
+size_t TextLayoutCache::EstimateBytes(size_t length) {
+	// 布局对象本身约 1 KB；每个字符的字形下标、前进量、偏移与簇信息约 64 字节
+	return sizeof(Entry) + 1024 + length * (sizeof(wchar_t) + 64);
+}
+
+void TextLayoutCache::Remove(EntryIt it) {
+	_bytes -= it->bytes;
+	_index.erase(it->hash);
+	_entries.erase(it);
+}
+
+void TextLayoutCache::TrimLocked() {
+	while (_bytes > _capacityBytes && !_entries.empty()) {
+		Remove(std::prev(_entries.end()));
+		_stats.Evictions++;
+	}
+}
+
+ComPtr<IDWriteTextLayout> TextLayoutCache::Get(const wchar_t* text, size_t length, IDWriteTextFormat* format,
+	float maxWidth, float maxHeight, D2D1_SIZE_F* size) {
+	if (!format) return nullptr;
+	if (!text) {
+		text = L"";
+		length = 0;
+	}
+	if (length > MaxCachedLength) {
+		ComPtr<IDWriteTextLayout> layout;
+		if (FAILED(_DWriteFactory->CreateTextLayout(text, (UINT32)length, format, maxWidth, maxHeight, &layout)))
+			return nullptr;
+		if (size) *size = LayoutSize(layout.Get());
+		std::lock_guard<std::mutex> guard(_lock);
+		_stats.Bypassed++;
+		return layout;
+	}
+
+	const uint64_t h = Hash(text, length, format, maxWidth, maxHeight);
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		auto found = _index.find(h);
+		if (found != _index.end()) {
+			Entry& e = *found->second;
+			if (e.format.Get() == format && FloatBits(e.maxWidth) == FloatBits(maxWidth) &&
+				FloatBits(e.maxHeight) == FloatBits(maxHeight) &&
+				e.text.size() == length && (length == 0 || std::wmemcmp(e.text.data(), text, length) == 0)) {
+				_entries.splice(_entries.begin(), _entries, found->second);
+				_stats.Hits++;
+				if (size) *size = e.size;
+				return e.layout;
+			}
+		}
+		_stats.Misses++;
+	}
+
+	// 排版在锁外进行：其它线程的命中不必等待
+	ComPtr<IDWriteTextLayout> layout;
+	if (FAILED(_DWriteFactory->CreateTextLayout(text, (UINT32)length, format, maxWidth, maxHeight, &layout)))
+		return nullptr;
+	D2D1_SIZE_F measured = LayoutSize(layout.Get());
+	if (size) *size = measured;
+
+	std::lock_guard<std::mutex> guard(_lock);
+	auto found = _index.find(h);
+	if (found != _index.end()) {
+		// 同键（其它线程刚插入）或散列冲突：替换旧项
+		Remove(found->second);
+	}
+	Entry e;
+	e.hash = h;
+	e.text.assign(text, length);
+	e.format = format;
+	e.maxWidth = maxWidth;
+	e.maxHeight = maxHeight;
+	e.layout = layout;
+	e.size = measured;
+	e.bytes = EstimateBytes(length);
+	_bytes += e.bytes;
+	_entries.push_front(std::move(e));
+	_index[h] = _entries.begin();
+	TrimLocked();
+	return layout;
+}
+
+ComPtr<IDWriteTextLayout> TextLayoutCache::Get(const std::wstring& text, IDWriteTextFormat* format,
+	float maxWidth, float maxHeight, D2D1_SIZE_F* size) {
+	return Get(text.c_str(), text.size(), format, maxWidth, maxHeight, size);
+}
+
+D2D1_SIZE_F TextLayoutCache::Measure(const wchar_t* text, size_t length, IDWriteTextFormat* format, float maxWidth, float maxHeight) {
+	D2D1_SIZE_F size{ 0, 0 };
+	if (!Get(text, length, format, maxWidth, maxHeight, &size)) return D2D1_SIZE_F{ 0, 0 };
+	return size;
+}
+
+void TextLayoutCache::Purge(IDWriteTextFormat* format) {
+	if (!format) return;
+	std::lock_guard<std::mutex> guard(_lock);
+	for (auto it = _entries.begin(); it != _entries.end();) {
+		auto next = std::next(it);
+		if (it->format.Get() == format) Remove(it);
+		it = next;
+	}
+}
+
+void TextLayoutCache::Clear() {
+	std::lock_guard<std::mutex> guard(_lock);
+	_entries.clear();
+	_index.clear();
+	_bytes = 0;
+}
+
+void TextLayoutCache::SetCapacity(size_t bytes) {
+	std::lock_guard<std::mutex> guard(_lock);
+	_capacityBytes = bytes;
+	TrimLocked();
+}
+
+TextLayoutCache::Stats TextLayoutCache::GetStats() const {
+	std::lock_guard<std::mutex> guard(_lock);
+	Stats s = _stats;
+	s.Count = _entries.size();
+	s.Bytes = _bytes;
+	s.CapacityBytes = _capacityBytes;
+	return s;
+}
+
+void TextLayoutCache::ResetStats() {
+	std::lock_guard<std::mutex> guard(_lock);
+	_stats = Stats();
+}
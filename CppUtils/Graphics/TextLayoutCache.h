@@ -0,0 +1,99 @@
+#pragma once
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <d2d1.h>
+#include <dwrite.h>
+#include <wrl/client.h>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @file TextLayoutCache.h
+ * @brief TextLayoutCache：进程内共享的 IDWriteTextLayout 缓存。
+ *
+ * 键为（文本、文本格式、最大宽度、最大高度），值为已排版的布局及其尺寸。
+ * Font::GetTextSize / HitTest 与 D2DGraphics::DrawString 系列都经过这里：
+ * 内容不变的标签、表格单元格、菜单项只排版一次。
+ *
+ * - 按估算内存做 LRU 淘汰（DirectWrite 不公开布局实际占用，按字符数估算）
+ * - 条目持有文本格式的引用，格式地址在条目存活期间不会被复用；Font 重建/析构时调用 Purge
+ * - 超过 MaxCachedLength 的文本（大段正文）不缓存，每次新建
+ *
+ * 返回的布局是共享的，只能用于绘制、测量与命中测试；需要 SetDrawingEffect、
+ * SetMaxWidth 等修改时请用 D2DGraphics::CreateStringLayout 创建独占布局。
+ */
+class TextLayoutCache
+{
+public:
+	struct Stats
+	{
+		size_t Hits = 0;
+		size_t Misses = 0;
+		size_t Evictions = 0;
+		/** @brief 过长未缓存的请求。 */
+		size_t Bypassed = 0;
+		size_t Count = 0;
+		size_t Bytes = 0;
+		size_t CapacityBytes = 0;
+	};
+
+	static const size_t MaxCachedLength = 4096;
+	static const size_t DefaultCapacityBytes = 8 * 1024 * 1024;
+
+	static TextLayoutCache& Shared();
+
+	explicit TextLayoutCache(size_t capacityBytes = DefaultCapacityBytes);
+
+	/**
+	 * @brief 取得（必要时创建）布局。
+	 * @param size 可选，返回 ceil(含尾随空白的宽度) x ceil(高度)，与 Font::GetTextSize 一致。
+	 * @return 失败返回空。
+	 */
+	Microsoft::WRL::ComPtr<IDWriteTextLayout> Get(const wchar_t* text, size_t length, IDWriteTextFormat* format,
+		float maxWidth, float maxHeight, D2D1_SIZE_F* size = nullptr);
+	Microsoft::WRL::ComPtr<IDWriteTextLayout> Get(const std::wstring& text, IDWriteTextFormat* format,
+		float maxWidth, float maxHeight, D2D1_SIZE_F* size = nullptr);
+	/** @brief 只取尺寸；失败返回 {0,0}。 */
+	D2D1_SIZE_F Measure(const wchar_t* text, size_t length, IDWriteTextFormat* format, float maxWidth, float maxHeight);
+
+	/** @brief 丢弃使用该文本格式的所有条目（Font 改字号/字体或析构时调用）。 */
+	void Purge(IDWriteTextFormat* format);
+	void Clear();
+	void SetCapacity(size_t bytes);
+	Stats GetStats() const;
+	void ResetStats();
+
+private:
+	struct Entry
+	{
+		uint64_t hash = 0;
+		std::wstring text;
+		Microsoft::WRL::ComPtr<IDWriteTextFormat> format;
+		float maxWidth = 0.0f;
+		float maxHeight = 0.0f;
+		Microsoft::WRL::ComPtr<IDWriteTextLayout> layout;
+		D2D1_SIZE_F size{};
+		size_t bytes = 0;
+	};
+	typedef std::list<Entry>::iterator EntryIt;
+
+	mutable std::mutex _lock;
+	size_t _capacityBytes;
+	size_t _bytes = 0;
+	std::list<Entry> _entries;
+	std::unordered_map<uint64_t, EntryIt> _index;
+	Stats _stats;
+
+	static uint64_t Hash(const wchar_t* text, size_t length, IDWriteTextFormat* format, float maxWidth, float maxHeight);
+	static size_t EstimateBytes(size_t length);
+	void Remove(EntryIt it);
+	void TrimLocked();
+};